@@ -24,6 +24,8 @@ static const char *token_type_name(TokenType type) {
     return "TOKEN_SWITCH";
   case TOKEN_CASE:
     return "TOKEN_CASE";
+  case TOKEN_DEFAULT:
+    return "TOKEN_DEFAULT";
   case TOKEN_BREAK:
     return "TOKEN_BREAK";
   case TOKEN_CONTINUE:
@@ -14,6 +14,7 @@ typedef enum TokenType {
   TOKEN_FOR,
   TOKEN_SWITCH,
   TOKEN_CASE,
+  TOKEN_DEFAULT,
   TOKEN_BREAK,
   TOKEN_CONTINUE,
   TOKEN_RETURN,
@@ -43,7 +44,27 @@ typedef struct Lexer {
   size_t pos;
 } Lexer;
 
+/*
+ * Maps byte offsets into an input to lines and columns. Tokens only point
+ * into the input, so nothing is scanned until the first lookup needs it.
+ */
+typedef struct LineTable {
+  const char *input;
+  /* Offset of the first byte of each line; NULL until built. */
+  size_t *line_starts;
+  size_t line_count;
+} LineTable;
+
 void lexer_init(Lexer *lexer, const char *input);
 Token lexer_next(Lexer *lexer);
 
+void line_table_init(LineTable *table, const char *input);
+void line_table_free(LineTable *table);
+/*
+ * Finds the 1-based line and column of the byte at offset. Returns 0 only
+ * if the table could not be built.
+ */
+int line_table_lookup(LineTable *table, size_t offset, unsigned *line,
+                      unsigned *column);
+
 #endif
@@ -1,6 +1,7 @@
 #include "lexer.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 static int is_ident_start(int ch) {
@@ -103,6 +104,10 @@ static Token lex_identifier(Lexer *lexer) {
     return make_token(TOKEN_CASE, text, length);
   }
 
+  if (length == 7 && strncmp(text, "default", 7) == 0) {
+    return make_token(TOKEN_DEFAULT, text, length);
+  }
+
   if (length == 5 && strncmp(text, "break", 5) == 0) {
     return make_token(TOKEN_BREAK, text, length);
   }
@@ -171,6 +176,17 @@ static Token lex_punctuator(Lexer *lexer) {
     return make_token(TOKEN_PUNCT, lexer->input + start, 2);
   }
 
+  if ((ch == '+' || ch == '-') && lexer->input[lexer->pos + 1] == ch) {
+    lexer->pos += 2;
+    return make_token(TOKEN_PUNCT, lexer->input + start, 2);
+  }
+
+  if ((ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '%') &&
+      lexer->input[lexer->pos + 1] == '=') {
+    lexer->pos += 2;
+    return make_token(TOKEN_PUNCT, lexer->input + start, 2);
+  }
+
   if (ch == '-' && lexer->input[lexer->pos + 1] == '>') {
     lexer->pos += 2;
     return make_token(TOKEN_PUNCT, lexer->input + start, 2);
@@ -201,9 +217,15 @@ static Token lex_punctuator(Lexer *lexer) {
     return make_token(TOKEN_PUNCT, lexer->input + start, 1);
   }
 
+  if ((ch == '<' || ch == '>') && lexer->input[lexer->pos + 1] == '=') {
+    lexer->pos += 2;
+    return make_token(TOKEN_PUNCT, lexer->input + start, 2);
+  }
+
   if (ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '(' ||
       ch == '%' || ch == ')' || ch == '{' || ch == '}' || ch == ';' ||
-      ch == ',' || ch == '=' || ch == '.' || ch == '[' || ch == ']') {
+      ch == ',' || ch == '=' || ch == '.' || ch == '[' || ch == ']' ||
+      ch == '<' || ch == '>' || ch == ':') {
     lexer->pos++;
     return make_token(TOKEN_PUNCT, lexer->input + start, 1);
   }
@@ -234,3 +256,63 @@ Token lexer_next(Lexer *lexer) {
 
   return lex_punctuator(lexer);
 }
+
+void line_table_init(LineTable *table, const char *input) {
+  table->input = input;
+  table->line_starts = NULL;
+  table->line_count = 0;
+}
+
+void line_table_free(LineTable *table) {
+  free(table->line_starts);
+  line_table_init(table, table->input);
+}
+
+static int line_table_build(LineTable *table) {
+  size_t count = 1;
+  size_t pos = 0;
+
+  for (pos = 0; table->input[pos] != '\0'; pos++) {
+    count += table->input[pos] == '\n';
+  }
+
+  table->line_starts = malloc(count * sizeof(*table->line_starts));
+  if (!table->line_starts) {
+    return 0;
+  }
+
+  table->line_starts[0] = 0;
+  table->line_count = 1;
+  for (pos = 0; table->input[pos] != '\0'; pos++) {
+    if (table->input[pos] == '\n') {
+      table->line_starts[table->line_count++] = pos + 1;
+    }
+  }
+  return 1;
+}
+
+int line_table_lookup(LineTable *table, size_t offset, unsigned *line,
+                      unsigned *column) {
+  size_t low = 0;
+  size_t high = 0;
+
+  if (!table->line_starts && !line_table_build(table)) {
+    return 0;
+  }
+
+  /* The last line starting at or before offset. */
+  high = table->line_count;
+  while (high - low > 1) {
+    size_t middle = low + (high - low) / 2;
+
+    if (table->line_starts[middle] <= offset) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  *line = (unsigned)(low + 1);
+  *column = (unsigned)(offset - table->line_starts[low] + 1);
+  return 1;
+}
@@ -10,6 +10,8 @@
 #define TEST_LIST(X)                                                           \
   X(ident_and_number, "identifiers and numbers")                               \
   X(punctuators, "punctuators")                                                \
+  X(relational_punctuators, "relational punctuators")                          \
+  X(assignment_punctuators, "compound assignment and increment punctuators")   \
   X(identifiers_with_underscores, "identifiers with underscores")              \
   X(number_boundaries, "number boundaries")                                    \
   X(negative_numbers, "negative numbers")                                      \
@@ -17,7 +19,8 @@
   X(keyword_snippets, "keyword snippets")                                      \
   X(invalid_character, "invalid character")                                    \
   X(sample_program, "sample program")                                          \
-  X(whitespace_only, "whitespace")
+  X(whitespace_only, "whitespace")                                             \
+  X(line_table, "line table")
 
 #define ASSERT_PUNCT_TOKEN(token_val, text_val)                                \
   do {                                                                         \
@@ -99,6 +102,71 @@ TEST(punctuators, "punctuators") {
   return 1;
 }
 
+TEST(relational_punctuators, "relational punctuators") {
+  Lexer lexer;
+  Token token;
+  lexer_init(&lexer, "< > <= >= a<b c>=-1 <<=");
+
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "<");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), ">");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "<=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), ">=");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_IDENT, "expected TOKEN_IDENT");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "<");
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_IDENT, "expected TOKEN_IDENT");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_IDENT, "expected TOKEN_IDENT");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), ">=");
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_NUMBER && token.value == -1,
+              "expected negative number after '>='");
+
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "<");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "<=");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_EOF, "expected TOKEN_EOF");
+
+  return 1;
+}
+
+TEST(assignment_punctuators,
+     "compound assignment and increment punctuators") {
+  Lexer lexer;
+  Token token;
+  lexer_init(&lexer, "+= -= *= /= %= ++ -- i++ +++ x-=-1");
+
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "+=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "-=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "*=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "/=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "%=");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "++");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "--");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_IDENT, "expected TOKEN_IDENT");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "++");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "++");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "+");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_IDENT, "expected TOKEN_IDENT");
+  ASSERT_PUNCT_TOKEN(lexer_next(&lexer), "-=");
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_NUMBER && token.value == -1,
+              "expected negative number after '-='");
+
+  token = lexer_next(&lexer);
+  ASSERT_TRUE(token.type == TOKEN_EOF, "expected TOKEN_EOF");
+
+  return 1;
+}
+
 TEST(identifiers_with_underscores, "identifiers with underscores") {
   Lexer lexer;
   Token token;
@@ -184,7 +252,7 @@ TEST(keywords, "keywords") {
   Lexer lexer;
   lexer_init(
     &lexer,
-    "if else while for switch case break continue return "
+    "if else while for switch case default break continue return "
     "sizeof typedef extern static void const char short int struct enum");
 
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_IF, "if");
@@ -193,6 +261,7 @@ TEST(keywords, "keywords") {
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_FOR, "for");
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_SWITCH, "switch");
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_CASE, "case");
+  ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_DEFAULT, "default");
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_BREAK, "break");
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_CONTINUE, "continue");
   ASSERT_KEYWORD_TOKEN(lexer_next(&lexer), TOKEN_RETURN, "return");
@@ -532,8 +601,7 @@ TEST(keyword_snippets, "keyword snippets") {
   ASSERT_TOKEN_TEXT(token, "0");
 
   token = lexer_next(&lexer);
-  ASSERT_TRUE(token.type == TOKEN_INVALID, "expected TOKEN_INVALID");
-  ASSERT_TOKEN_TEXT(token, ":");
+  ASSERT_PUNCT_TOKEN(token, ":");
 
   token = lexer_next(&lexer);
   ASSERT_KEYWORD_TOKEN(token, TOKEN_RETURN, "return");
@@ -553,8 +621,7 @@ TEST(keyword_snippets, "keyword snippets") {
   ASSERT_TOKEN_TEXT(token, "1");
 
   token = lexer_next(&lexer);
-  ASSERT_TRUE(token.type == TOKEN_INVALID, "expected TOKEN_INVALID");
-  ASSERT_TOKEN_TEXT(token, ":");
+  ASSERT_PUNCT_TOKEN(token, ":");
 
   token = lexer_next(&lexer);
   ASSERT_KEYWORD_TOKEN(token, TOKEN_RETURN, "return");
@@ -674,6 +741,35 @@ TEST(whitespace_only, "whitespace") {
   return 1;
 }
 
+TEST(line_table, "line table") {
+  const char *input = "int a;\n\n  return a;\n";
+  LineTable table;
+  unsigned line = 0;
+  unsigned column = 0;
+
+  line_table_init(&table, input);
+  ASSERT_TRUE(table.line_starts == NULL, "expected a lazily built table");
+
+  ASSERT_TRUE(line_table_lookup(&table, 4, &line, &column),
+              "expected lookup success");
+  ASSERT_TRUE(line == 1 && column == 5, "expected 1:5");
+
+  ASSERT_TRUE(line_table_lookup(&table, 7, &line, &column),
+              "expected lookup success");
+  ASSERT_TRUE(line == 2 && column == 1, "expected 2:1");
+
+  ASSERT_TRUE(line_table_lookup(&table, 10, &line, &column),
+              "expected lookup success");
+  ASSERT_TRUE(line == 3 && column == 3, "expected 3:3");
+
+  ASSERT_TRUE(line_table_lookup(&table, 20, &line, &column),
+              "expected lookup success");
+  ASSERT_TRUE(line == 4 && column == 1, "expected 4:1");
+
+  line_table_free(&table);
+  return 1;
+}
+
 #define TEST_ENTRY(name, description) {description, test_##name},
 
 static const TestCase tests[] = {TEST_LIST(TEST_ENTRY)};
@@ -14,21 +14,30 @@ typedef enum ParserNodeType {
   PARSER_NODE_RETURN,
   PARSER_NODE_BREAK,
   PARSER_NODE_CONTINUE,
+  PARSER_NODE_SWITCH,
+  PARSER_NODE_CASE,
+  PARSER_NODE_DEFAULT,
   PARSER_NODE_EMPTY,
   PARSER_NODE_STRUCT,
   PARSER_NODE_ENUM,
   PARSER_NODE_ENUMERATOR,
   PARSER_NODE_TYPEDEF,
   PARSER_NODE_ASSIGN,
+  /* target op= value; the token is the operator, "+=" through "%=". */
+  PARSER_NODE_COMPOUND_ASSIGN,
   PARSER_NODE_CALL,
   PARSER_NODE_IDENTIFIER,
   PARSER_NODE_MEMBER,
   PARSER_NODE_INDEX,
   PARSER_NODE_BINARY,
   PARSER_NODE_UNARY,
+  /* target++ or target--; ++target and --target are PARSER_NODE_UNARY. */
+  PARSER_NODE_POSTFIX,
   PARSER_NODE_CAST,
   PARSER_NODE_SIZEOF,
   PARSER_NODE_NUMBER,
+  /* A braced initializer; its children are the element initializers. */
+  PARSER_NODE_INITIALIZER,
   PARSER_NODE_INVALID
 } ParserNodeType;
 
@@ -536,6 +536,22 @@ static ParserNode *parser_parse_postfix(Parser *parser) {
       continue;
     }
 
+    if (token_is_punct(parser->last_token, "++") ||
+        token_is_punct(parser->last_token, "--")) {
+      ParserNode *postfix =
+        parser_alloc_node(parser, PARSER_NODE_POSTFIX, parser->last_token);
+
+      if (!postfix) {
+        parser_free_node(node);
+        return NULL;
+      }
+
+      parser_next(parser);
+      postfix->first_child = node;
+      node = postfix;
+      continue;
+    }
+
     break;
   }
 
@@ -648,7 +664,8 @@ static ParserNode *parser_parse_unary(Parser *parser) {
 
   if (token_is_punct(token, "!") || token_is_punct(token, "+") ||
       token_is_punct(token, "-") || token_is_punct(token, "*") ||
-      token_is_punct(token, "&")) {
+      token_is_punct(token, "&") || token_is_punct(token, "++") ||
+      token_is_punct(token, "--")) {
     ParserNode *node = NULL;
     ParserNode *operand = NULL;
 
@@ -744,14 +761,17 @@ static ParserNode *parser_parse_additive(Parser *parser) {
   return left;
 }
 
-static ParserNode *parser_parse_logical_and(Parser *parser) {
+static ParserNode *parser_parse_relational(Parser *parser) {
   ParserNode *left = parser_parse_additive(parser);
 
   if (!left || left->type == PARSER_NODE_INVALID) {
     return left;
   }
 
-  while (token_is_punct(parser->last_token, "&&")) {
+  while (token_is_punct(parser->last_token, "<") ||
+         token_is_punct(parser->last_token, ">") ||
+         token_is_punct(parser->last_token, "<=") ||
+         token_is_punct(parser->last_token, ">=")) {
     Token op = parser->last_token;
     ParserNode *right = NULL;
     ParserNode *node = NULL;
@@ -779,6 +799,77 @@ static ParserNode *parser_parse_logical_and(Parser *parser) {
   return left;
 }
 
+static ParserNode *parser_parse_equality(Parser *parser) {
+  ParserNode *left = parser_parse_relational(parser);
+
+  if (!left || left->type == PARSER_NODE_INVALID) {
+    return left;
+  }
+
+  while (token_is_punct(parser->last_token, "==") ||
+         token_is_punct(parser->last_token, "!=")) {
+    Token op = parser->last_token;
+    ParserNode *right = NULL;
+    ParserNode *node = NULL;
+
+    parser_next(parser);
+
+    right = parser_parse_relational(parser);
+    if (!right || right->type == PARSER_NODE_INVALID) {
+      parser_free_node(left);
+      return right;
+    }
+
+    node = parser_alloc_node(parser, PARSER_NODE_BINARY, op);
+    if (!node) {
+      parser_free_node(left);
+      parser_free_node(right);
+      return NULL;
+    }
+
+    node->first_child = left;
+    left->next = right;
+    left = node;
+  }
+
+  return left;
+}
+
+static ParserNode *parser_parse_logical_and(Parser *parser) {
+  ParserNode *left = parser_parse_equality(parser);
+
+  if (!left || left->type == PARSER_NODE_INVALID) {
+    return left;
+  }
+
+  while (token_is_punct(parser->last_token, "&&")) {
+    Token op = parser->last_token;
+    ParserNode *right = NULL;
+    ParserNode *node = NULL;
+
+    parser_next(parser);
+
+    right = parser_parse_equality(parser);
+    if (!right || right->type == PARSER_NODE_INVALID) {
+      parser_free_node(left);
+      return right;
+    }
+
+    node = parser_alloc_node(parser, PARSER_NODE_BINARY, op);
+    if (!node) {
+      parser_free_node(left);
+      parser_free_node(right);
+      return NULL;
+    }
+
+    node->first_child = left;
+    left->next = right;
+    left = node;
+  }
+
+  return left;
+}
+
 static ParserNode *parser_parse_logical_or(Parser *parser) {
   ParserNode *left = parser_parse_logical_and(parser);
 
@@ -982,7 +1073,9 @@ static ParserNode *parser_parse_for(Parser *parser) {
   } else if (parser_is_type_start(parser, parser->last_token)) {
     init = parser_parse_local_declaration(parser);
   } else if (parser->last_token.type == TOKEN_IDENT ||
-             token_is_punct(parser->last_token, "*")) {
+             token_is_punct(parser->last_token, "*") ||
+             token_is_punct(parser->last_token, "++") ||
+             token_is_punct(parser->last_token, "--")) {
     init = parser_parse_assignment_statement(parser);
   } else {
     return parser_make_error(parser, parser->last_token,
@@ -1023,7 +1116,9 @@ static ParserNode *parser_parse_for(Parser *parser) {
   if (token_is_punct(parser->last_token, ")")) {
     increment = parser_alloc_node(parser, PARSER_NODE_EMPTY, token);
   } else if (parser->last_token.type == TOKEN_IDENT ||
-             token_is_punct(parser->last_token, "*")) {
+             token_is_punct(parser->last_token, "*") ||
+             token_is_punct(parser->last_token, "++") ||
+             token_is_punct(parser->last_token, "--")) {
     increment = parser_parse_assignment_expression(parser);
   } else {
     ParserNode *error_node = parser_make_error(
@@ -1078,6 +1173,107 @@ static ParserNode *parser_parse_for(Parser *parser) {
   return node;
 }
 
+static ParserNode *parser_parse_switch(Parser *parser) {
+  Token token = parser->last_token;
+
+  parser_next(parser);
+
+  if (!parser_match_punct(parser, "(")) {
+    return parser_make_error(parser, parser->last_token,
+                             "parser: expected '('");
+  }
+
+  ParserNode *condition = parser_parse_expression(parser);
+  if (!condition || condition->type == PARSER_NODE_INVALID) {
+    return condition;
+  }
+
+  if (!parser_match_punct(parser, ")")) {
+    ParserNode *error_node =
+      parser_make_error(parser, parser->last_token, "parser: expected ')'");
+    parser_free_node(condition);
+    return error_node;
+  }
+
+  ParserNode *body = parser_parse_statement(parser);
+  if (!body || body->type == PARSER_NODE_INVALID) {
+    parser_free_node(condition);
+    return body;
+  }
+
+  ParserNode *node = parser_alloc_node(parser, PARSER_NODE_SWITCH, token);
+  if (!node) {
+    parser_free_node(condition);
+    parser_free_node(body);
+    return NULL;
+  }
+
+  node->first_child = condition;
+  condition->next = body;
+  return node;
+}
+
+/* case <constant>: <statement>, with the constant as the first child. */
+static ParserNode *parser_parse_case(Parser *parser) {
+  Token token = parser->last_token;
+
+  parser_next(parser);
+
+  ParserNode *value = parser_parse_expression(parser);
+  if (!value || value->type == PARSER_NODE_INVALID) {
+    return value;
+  }
+
+  if (!parser_match_punct(parser, ":")) {
+    ParserNode *error_node =
+      parser_make_error(parser, parser->last_token, "parser: expected ':'");
+    parser_free_node(value);
+    return error_node;
+  }
+
+  ParserNode *body = parser_parse_statement(parser);
+  if (!body || body->type == PARSER_NODE_INVALID) {
+    parser_free_node(value);
+    return body;
+  }
+
+  ParserNode *node = parser_alloc_node(parser, PARSER_NODE_CASE, token);
+  if (!node) {
+    parser_free_node(value);
+    parser_free_node(body);
+    return NULL;
+  }
+
+  node->first_child = value;
+  value->next = body;
+  return node;
+}
+
+static ParserNode *parser_parse_default(Parser *parser) {
+  Token token = parser->last_token;
+
+  parser_next(parser);
+
+  if (!parser_match_punct(parser, ":")) {
+    return parser_make_error(parser, parser->last_token,
+                             "parser: expected ':'");
+  }
+
+  ParserNode *body = parser_parse_statement(parser);
+  if (!body || body->type == PARSER_NODE_INVALID) {
+    return body;
+  }
+
+  ParserNode *node = parser_alloc_node(parser, PARSER_NODE_DEFAULT, token);
+  if (!node) {
+    parser_free_node(body);
+    return NULL;
+  }
+
+  node->first_child = body;
+  return node;
+}
+
 static ParserNode *parser_parse_return(Parser *parser) {
   Token token = parser->last_token;
 
@@ -1150,6 +1346,18 @@ static ParserNode *parser_parse_statement(Parser *parser) {
     return parser_parse_for(parser);
   }
 
+  if (token.type == TOKEN_SWITCH) {
+    return parser_parse_switch(parser);
+  }
+
+  if (token.type == TOKEN_CASE) {
+    return parser_parse_case(parser);
+  }
+
+  if (token.type == TOKEN_DEFAULT) {
+    return parser_parse_default(parser);
+  }
+
   if (token.type == TOKEN_RETURN) {
     return parser_parse_return(parser);
   }
@@ -1179,15 +1387,62 @@ static ParserNode *parser_parse_statement(Parser *parser) {
     return parser_alloc_node(parser, PARSER_NODE_EMPTY, token);
   }
 
-  if (token.type == TOKEN_IDENT || token_is_punct(token, "*")) {
+  if (token.type == TOKEN_IDENT || token_is_punct(token, "*") ||
+      token_is_punct(token, "++") || token_is_punct(token, "--")) {
     return parser_parse_assignment_statement(parser);
   }
 
   return parser_make_error(parser, token, "parser: expected statement");
 }
 
+/*
+ * An expression, or a braced list of initializers with an optional
+ * trailing comma.
+ */
+static ParserNode *parser_parse_initializer(Parser *parser) {
+  Token token = parser->last_token;
+  ParserNode *node = NULL;
+  ParserNode **tail = NULL;
+
+  if (!parser_match_punct(parser, "{")) {
+    return parser_parse_expression(parser);
+  }
+
+  node = parser_alloc_node(parser, PARSER_NODE_INITIALIZER, token);
+  if (!node) {
+    return NULL;
+  }
+
+  tail = &node->first_child;
+  while (!token_is_punct(parser->last_token, "}")) {
+    ParserNode *element = parser_parse_initializer(parser);
+
+    if (!element || element->type == PARSER_NODE_INVALID) {
+      parser_free_node(node);
+      return element;
+    }
+
+    *tail = element;
+    tail = &element->next;
+
+    if (!parser_match_punct(parser, ",")) {
+      break;
+    }
+  }
+
+  if (!parser_match_punct(parser, "}")) {
+    ParserNode *error_node =
+      parser_make_error(parser, parser->last_token, "parser: expected '}'");
+    parser_free_node(node);
+    return error_node;
+  }
+
+  return node;
+}
+
 static ParserNode *parser_parse_declaration(Parser *parser, Token name_token,
                                             Token type_token) {
+  int unsized = 0;
   ParserNode *node =
     parser_alloc_node(parser, PARSER_NODE_DECLARATION, name_token);
   if (!node) {
@@ -1199,27 +1454,30 @@ static ParserNode *parser_parse_declaration(Parser *parser, Token name_token,
   if (parser_match_punct(parser, "[")) {
     Token length_token = parser->last_token;
 
-    if (length_token.type != TOKEN_NUMBER || length_token.value <= 0) {
+    /* int t[] = {...} takes its length from the initializer. */
+    if (parser_match_punct(parser, "]")) {
+      unsized = 1;
+    } else if (length_token.type != TOKEN_NUMBER || length_token.value <= 0) {
       ParserNode *error_node =
         parser_make_error(parser, length_token, "parser: expected array size");
       parser_free_node(node);
       return error_node;
-    }
+    } else {
+      parser_next(parser);
 
-    parser_next(parser);
+      if (!parser_match_punct(parser, "]")) {
+        ParserNode *error_node = parser_make_error(parser, parser->last_token,
+                                                   "parser: expected ']'");
+        parser_free_node(node);
+        return error_node;
+      }
 
-    if (!parser_match_punct(parser, "]")) {
-      ParserNode *error_node =
-        parser_make_error(parser, parser->last_token, "parser: expected ']'");
-      parser_free_node(node);
-      return error_node;
+      node->array_length = (size_t)length_token.value;
     }
-
-    node->array_length = (size_t)length_token.value;
   }
 
   if (parser_match_punct(parser, "=")) {
-    ParserNode *init = parser_parse_expression(parser);
+    ParserNode *init = parser_parse_initializer(parser);
 
     if (!init || init->type == PARSER_NODE_INVALID) {
       parser_free_node(node);
@@ -1229,6 +1487,24 @@ static ParserNode *parser_parse_declaration(Parser *parser, Token name_token,
     node->first_child = init;
   }
 
+  if (unsized) {
+    const ParserNode *element = NULL;
+
+    if (!node->first_child ||
+        node->first_child->type != PARSER_NODE_INITIALIZER ||
+        !node->first_child->first_child) {
+      ParserNode *error_node = parser_make_error(parser, node->token,
+                                                 "parser: expected array size");
+      parser_free_node(node);
+      return error_node;
+    }
+
+    for (element = node->first_child->first_child; element;
+         element = element->next) {
+      node->array_length++;
+    }
+  }
+
   if (!parser_match_punct(parser, ";")) {
     Token error_token = parser->last_token;
     ParserNode *error_node =
@@ -1308,17 +1584,44 @@ static ParserNode *parser_parse_assignment_statement(Parser *parser) {
   return node;
 }
 
+static int parser_is_increment(const ParserNode *node) {
+  return node->type == PARSER_NODE_POSTFIX ||
+         (node->type == PARSER_NODE_UNARY &&
+          (token_is_punct(node->token, "++") ||
+           token_is_punct(node->token, "--")));
+}
+
+static int token_is_compound_assign(Token token) {
+  return token_is_punct(token, "+=") || token_is_punct(token, "-=") ||
+         token_is_punct(token, "*=") || token_is_punct(token, "/=") ||
+         token_is_punct(token, "%=");
+}
+
+/*
+ * target = value, target op= value, or an increment or decrement on its
+ * own.
+ */
 static ParserNode *parser_parse_assignment_expression(Parser *parser) {
   ParserNode *left = NULL;
   ParserNode *right = NULL;
   ParserNode *node = NULL;
+  Token op_token;
+  ParserNodeType type = PARSER_NODE_ASSIGN;
 
   left = parser_parse_unary(parser);
   if (!left || left->type == PARSER_NODE_INVALID) {
     return left;
   }
 
-  if (!parser_match_punct(parser, "=")) {
+  if (parser_is_increment(left)) {
+    return left;
+  }
+
+  op_token = parser->last_token;
+  if (token_is_compound_assign(op_token)) {
+    parser_next(parser);
+    type = PARSER_NODE_COMPOUND_ASSIGN;
+  } else if (!parser_match_punct(parser, "=")) {
     ParserNode *error_node =
       parser_make_error(parser, parser->last_token, "parser: expected '='");
     parser_free_node(left);
@@ -1331,7 +1634,8 @@ static ParserNode *parser_parse_assignment_expression(Parser *parser) {
     return right;
   }
 
-  node = parser_alloc_node(parser, PARSER_NODE_ASSIGN, left->token);
+  node = parser_alloc_node(
+    parser, type, type == PARSER_NODE_ASSIGN ? left->token : op_token);
   if (!node) {
     parser_free_node(left);
     parser_free_node(right);
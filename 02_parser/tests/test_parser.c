@@ -10,16 +10,19 @@
   X(parse_type_declarations, "parse type declarations")                        \
   X(parse_pointer_declaration, "parse pointer declaration")                    \
   X(parse_array_declaration, "parse array declaration")                        \
+  X(parse_initializer_list, "parse initializer list")                          \
   X(parse_typedefs_and_const, "parse typedefs and const")                      \
   X(parse_static_declarations, "parse static declarations")                    \
   X(parse_struct_definition, "parse struct definition")                        \
   X(parse_function_control_flow, "parse function control flow")                \
   X(parse_for_loop, "parse for loop")                                          \
   X(parse_loop_control, "parse loop control")                                  \
+  X(parse_switch_statement, "parse switch statement")                          \
   X(parse_function_call, "parse function call")                                \
   X(parse_extern_function_declaration, "parse extern function declaration")    \
   X(parse_assignment_statement, "parse assignment statement")                  \
   X(parse_dereference_assignment, "parse dereference assignment")              \
+  X(parse_compound_assignment, "parse compound assignment")                    \
   X(parse_binary_expression, "parse binary expression")                        \
   X(parse_parenthesized_arithmetic, "parse parenthesized arithmetic")          \
   X(parse_nested_parentheses, "parse nested parentheses")                      \
@@ -27,6 +30,7 @@
   X(parse_cast_expression, "parse cast expression")                            \
   X(parse_sizeof, "parse sizeof")                                              \
   X(parse_logical_expression, "parse logical expression")                      \
+  X(parse_relational_expression, "parse relational expression")                \
   X(parse_invalid_token, "parse invalid token")                                \
   X(parse_mismatched_parentheses, "parse mismatched parentheses")              \
   X(parse_unexpected_closing_paren, "parse unexpected closing paren")          \
@@ -188,6 +192,55 @@ TEST(parse_array_declaration, "parse array declaration") {
   return 1;
 }
 
+TEST(parse_initializer_list, "parse initializer list") {
+  Parser parser;
+  ParserNode *node = NULL;
+  ParserNode *declaration = NULL;
+  ParserNode *element = NULL;
+
+  parser_init(&parser, "int table[] = {1, -2, 3,};"
+                       "struct Point { int x; int y; };"
+                       "struct Point points[2] = {{1, 2}, {3}};");
+
+  node = parser_parse(&parser);
+  ASSERT_TRUE(node != NULL, "expected parser node");
+  ASSERT_TRUE(parser_error(&parser) == NULL, "unexpected parser error");
+
+  declaration = node->first_child;
+  ASSERT_TRUE(declaration->type == PARSER_NODE_DECLARATION,
+              "expected declaration node");
+  ASSERT_TRUE(declaration->array_length == 3,
+              "expected length from initializer");
+  ASSERT_TRUE(declaration->first_child != NULL &&
+                declaration->first_child->type == PARSER_NODE_INITIALIZER,
+              "expected initializer list");
+  element = declaration->first_child->first_child;
+  ASSERT_TRUE(element->type == PARSER_NODE_NUMBER && element->token.value == 1,
+              "expected first element 1");
+  element = element->next;
+  ASSERT_TRUE(element->token.value == -2, "expected second element -2");
+  ASSERT_TRUE(element->next->next == NULL, "expected three elements");
+
+  declaration = declaration->next->next;
+  ASSERT_TRUE(declaration->array_length == 2, "expected array length 2");
+  element = declaration->first_child->first_child;
+  ASSERT_TRUE(element->type == PARSER_NODE_INITIALIZER,
+              "expected nested initializer list");
+  ASSERT_TRUE(element->first_child->next != NULL, "expected two fields");
+  ASSERT_TRUE(element->next->first_child->next == NULL,
+              "expected one field");
+
+  parser_free_node(node);
+
+  parser_init(&parser, "int table[];");
+  node = parser_parse(&parser);
+  ASSERT_TRUE(parser_error(&parser) != NULL, "expected parser error");
+  ASSERT_TRUE(test_error_contains(parser_error(&parser), "array size"),
+              "expected array size error");
+  parser_free_node(node);
+  return 1;
+}
+
 TEST(parse_typedefs_and_const, "parse typedefs and const") {
   Parser parser;
 
@@ -465,6 +518,56 @@ TEST(parse_loop_control, "parse loop control") {
   return 1;
 }
 
+TEST(parse_switch_statement, "parse switch statement") {
+  Parser parser;
+
+  parser_init(&parser, "int main(){switch(1){case 1:case -2:return 0;"
+                       "default:break;}return 1;}");
+
+  ParserNode *node = parser_parse(&parser);
+  ASSERT_TRUE(node != NULL, "expected parser node");
+  ASSERT_TRUE(parser_error(&parser) == NULL, "unexpected parser error");
+
+  {
+    ParserNode *switch_stmt = node->first_child->first_child->first_child;
+    ParserNode *condition = switch_stmt ? switch_stmt->first_child : NULL;
+    ParserNode *body = condition ? condition->next : NULL;
+    ParserNode *first_case = body ? body->first_child : NULL;
+    ParserNode *second_case = NULL;
+    ParserNode *default_label = NULL;
+
+    ASSERT_TRUE(switch_stmt && switch_stmt->type == PARSER_NODE_SWITCH,
+                "expected switch statement");
+    ASSERT_TRUE(condition && condition->type == PARSER_NODE_NUMBER,
+                "expected switch condition");
+    ASSERT_TRUE(body && body->type == PARSER_NODE_BLOCK,
+                "expected switch body block");
+    ASSERT_TRUE(first_case && first_case->type == PARSER_NODE_CASE,
+                "expected case label");
+    ASSERT_TRUE(first_case->first_child->type == PARSER_NODE_NUMBER &&
+                  first_case->first_child->token.value == 1,
+                "expected case value 1");
+
+    /* A label's statement may itself be a label. */
+    second_case = first_case->first_child->next;
+    ASSERT_TRUE(second_case && second_case->type == PARSER_NODE_CASE,
+                "expected nested case label");
+    ASSERT_TRUE(second_case->first_child->token.value == -2,
+                "expected case value -2");
+    ASSERT_TRUE(second_case->first_child->next->type == PARSER_NODE_RETURN,
+                "expected labelled return");
+
+    default_label = first_case->next;
+    ASSERT_TRUE(default_label && default_label->type == PARSER_NODE_DEFAULT,
+                "expected default label");
+    ASSERT_TRUE(default_label->first_child->type == PARSER_NODE_BREAK,
+                "expected labelled break");
+  }
+
+  parser_free_node(node);
+  return 1;
+}
+
 TEST(parse_function_call, "parse function call") {
   Parser parser;
 
@@ -634,6 +737,54 @@ TEST(parse_dereference_assignment, "parse dereference assignment") {
   return 1;
 }
 
+TEST(parse_compound_assignment, "parse compound assignment") {
+  Parser parser;
+
+  parser_init(&parser, "int main(){int a=0; a += 2; a++; --a;"
+                       " for (a = 0; a < 3; a++) {} return a--;}");
+
+  ParserNode *node = parser_parse(&parser);
+  ASSERT_TRUE(node != NULL, "expected parser node");
+  ASSERT_TRUE(parser_error(&parser) == NULL, "unexpected parser error");
+
+  ParserNode *stmt = node->first_child->first_child->first_child->next;
+  ASSERT_TRUE(stmt != NULL, "expected compound assignment");
+  ASSERT_TRUE(stmt->type == PARSER_NODE_COMPOUND_ASSIGN,
+              "expected compound assignment node");
+  ASSERT_TRUE(token_equals(stmt->token, "+="),
+              "expected compound assignment operator");
+  ASSERT_TRUE(stmt->first_child->type == PARSER_NODE_IDENTIFIER,
+              "expected compound assignment target");
+  ASSERT_TRUE(stmt->first_child->next != NULL,
+              "expected compound assignment value");
+
+  stmt = stmt->next;
+  ASSERT_TRUE(stmt != NULL, "expected postfix increment");
+  ASSERT_TRUE(stmt->type == PARSER_NODE_POSTFIX,
+              "expected postfix increment node");
+  ASSERT_TRUE(token_equals(stmt->token, "++"), "expected increment");
+  ASSERT_TRUE(stmt->first_child->type == PARSER_NODE_IDENTIFIER,
+              "expected increment operand");
+
+  stmt = stmt->next;
+  ASSERT_TRUE(stmt != NULL, "expected prefix decrement");
+  ASSERT_TRUE(stmt->type == PARSER_NODE_UNARY,
+              "expected prefix decrement node");
+  ASSERT_TRUE(token_equals(stmt->token, "--"), "expected decrement");
+
+  stmt = stmt->next;
+  ASSERT_TRUE(stmt != NULL, "expected for loop");
+  ASSERT_TRUE(stmt->type == PARSER_NODE_FOR, "expected for loop");
+
+  stmt = stmt->next;
+  ASSERT_TRUE(stmt != NULL, "expected return statement");
+  ASSERT_TRUE(stmt->first_child->type == PARSER_NODE_POSTFIX,
+              "expected postfix decrement in return value");
+
+  parser_free_node(node);
+  return 1;
+}
+
 TEST(parse_binary_expression, "parse binary expression") {
   Parser parser;
   ParserNode *node = NULL;
@@ -915,6 +1066,41 @@ TEST(parse_logical_expression, "parse logical expression") {
   return 1;
 }
 
+TEST(parse_relational_expression, "parse relational expression") {
+  Parser parser;
+  ParserNode *expr = NULL;
+  ParserNode *left = NULL;
+  ParserNode *right = NULL;
+
+  parser_init(&parser, "int main(){return 1 < 2 + 3 == 4 >= 5 && 6 != 7;}");
+
+  ParserNode *node = parser_parse(&parser);
+  ASSERT_TRUE(node != NULL, "expected parser node");
+  ASSERT_TRUE(parser_error(&parser) == NULL, "unexpected parser error");
+
+  expr = node->first_child->first_child->first_child->first_child;
+  ASSERT_TRUE(expr != NULL, "expected return expression");
+  ASSERT_TRUE(token_equals(expr->token, "&&"), "expected '&&' operator");
+  ASSERT_TRUE(token_equals(expr->first_child->next->token, "!="),
+              "expected '!=' operator");
+
+  expr = expr->first_child;
+  ASSERT_TRUE(expr->type == PARSER_NODE_BINARY, "expected equality expression");
+  ASSERT_TRUE(token_equals(expr->token, "=="), "expected '==' operator");
+
+  left = expr->first_child;
+  right = left ? left->next : NULL;
+  ASSERT_TRUE(left != NULL, "expected left expression");
+  ASSERT_TRUE(right != NULL, "expected right expression");
+  ASSERT_TRUE(token_equals(left->token, "<"), "expected '<' operator");
+  ASSERT_TRUE(token_equals(left->first_child->next->token, "+"),
+              "expected '+' to bind tighter than '<'");
+  ASSERT_TRUE(token_equals(right->token, ">="), "expected '>=' operator");
+
+  parser_free_node(node);
+  return 1;
+}
+
 TEST(parse_invalid_token, "parse invalid token") {
   Parser parser;
 
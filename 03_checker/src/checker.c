@@ -14,11 +14,14 @@ void checker_init(Checker *checker, const char *input) {
   parser_init(&checker->parser, input);
   checker->error_message = NULL;
   checker->loop_depth = 0;
+  checker->switch_depth = 0;
 }
 
 static int checker_validate_declaration(Checker *checker,
                                         const ParserNode *node);
 static int checker_validate_typedef(Checker *checker, const ParserNode *node);
+static int checker_validate_increment(Checker *checker,
+                                      const ParserNode *node);
 
 static int checker_validate_number(Checker *checker, const ParserNode *node) {
   if (node->type != PARSER_NODE_NUMBER) {
@@ -54,13 +57,20 @@ static int checker_validate_binary_operator(Checker *checker, Token token) {
   if (token_is_punct(token, "+") || token_is_punct(token, "-") ||
       token_is_punct(token, "*") || token_is_punct(token, "/") ||
       token_is_punct(token, "%") || token_is_punct(token, "&&") ||
-      token_is_punct(token, "||")) {
+      token_is_punct(token, "||") || token_is_punct(token, "<") ||
+      token_is_punct(token, ">") || token_is_punct(token, "<=") ||
+      token_is_punct(token, ">=") || token_is_punct(token, "==") ||
+      token_is_punct(token, "!=")) {
     return 1;
   }
 
   return checker_set_error(checker, "checker: expected binary operator");
 }
 
+static int token_is_increment(Token token) {
+  return token_is_punct(token, "++") || token_is_punct(token, "--");
+}
+
 static int checker_validate_unary_operator(Checker *checker, Token token) {
   if (token_is_punct(token, "!") || token_is_punct(token, "+") ||
       token_is_punct(token, "-") || token_is_punct(token, "*") ||
@@ -147,6 +157,11 @@ static int checker_validate_expression(Checker *checker,
     return checker_validate_expression(checker, index);
   }
 
+  if (node->type == PARSER_NODE_POSTFIX ||
+      (node->type == PARSER_NODE_UNARY && token_is_increment(node->token))) {
+    return checker_validate_increment(checker, node);
+  }
+
   if (node->type == PARSER_NODE_UNARY) {
     const ParserNode *operand = node->first_child;
 
@@ -225,49 +240,80 @@ static int checker_validate_expression(Checker *checker,
   return checker_set_error(checker, "checker: expected expression");
 }
 
-static int checker_validate_assignment(Checker *checker,
-                                       const ParserNode *node) {
-  const ParserNode *left = node->first_child;
-  const ParserNode *right = left ? left->next : NULL;
+/* An identifier, dereference, member, or element that can be stored to. */
+static int checker_validate_target(Checker *checker,
+                                   const ParserNode *target) {
+  if (target->type == PARSER_NODE_IDENTIFIER) {
+    return 1;
+  }
 
-  if (!left || !right || right->next) {
-    return checker_set_error(checker,
-                             "checker: expected assignment expression");
+  if (target->type == PARSER_NODE_UNARY &&
+      token_is_punct(target->token, "*")) {
+    if (!target->first_child || target->first_child->next) {
+      return checker_set_error(checker, "checker: expected assignment target");
+    }
+
+    return checker_validate_expression(checker, target->first_child);
   }
 
-  if (left->type == PARSER_NODE_IDENTIFIER) {
-    return checker_validate_expression(checker, right);
+  if (target->type == PARSER_NODE_MEMBER ||
+      target->type == PARSER_NODE_INDEX) {
+    return checker_validate_expression(checker, target);
   }
 
-  if (left->type == PARSER_NODE_UNARY && token_is_punct(left->token, "*")) {
-    if (!left->first_child || left->first_child->next) {
-      return checker_set_error(checker, "checker: expected assignment target");
-    }
+  return checker_set_error(checker, "checker: expected assignment target");
+}
 
-    if (!checker_validate_expression(checker, left->first_child)) {
-      return 0;
-    }
+static int checker_validate_increment(Checker *checker,
+                                      const ParserNode *node) {
+  if (!token_is_increment(node->token)) {
+    return checker_set_error(checker, "checker: expected increment operator");
+  }
 
-    return checker_validate_expression(checker, right);
+  if (!node->first_child || node->first_child->next) {
+    return checker_set_error(checker, "checker: expected increment operand");
   }
 
-  if (left->type == PARSER_NODE_MEMBER) {
-    if (!checker_validate_expression(checker, left)) {
-      return 0;
-    }
+  return checker_validate_target(checker, node->first_child);
+}
 
-    return checker_validate_expression(checker, right);
+/* Whether node is a statement that stores: an assignment or an increment. */
+static int checker_is_assignment(const ParserNode *node) {
+  return node->type == PARSER_NODE_ASSIGN ||
+         node->type == PARSER_NODE_COMPOUND_ASSIGN ||
+         node->type == PARSER_NODE_POSTFIX ||
+         (node->type == PARSER_NODE_UNARY && token_is_increment(node->token));
+}
+
+static int checker_validate_assignment(Checker *checker,
+                                       const ParserNode *node) {
+  const ParserNode *left = node->first_child;
+  const ParserNode *right = left ? left->next : NULL;
+
+  if (node->type == PARSER_NODE_POSTFIX || node->type == PARSER_NODE_UNARY) {
+    return checker_validate_increment(checker, node);
   }
 
-  if (left->type == PARSER_NODE_INDEX) {
-    if (!checker_validate_expression(checker, left)) {
-      return 0;
-    }
+  if (!left || !right || right->next) {
+    return checker_set_error(checker,
+                             "checker: expected assignment expression");
+  }
 
-    return checker_validate_expression(checker, right);
+  if (node->type == PARSER_NODE_COMPOUND_ASSIGN &&
+      !token_is_punct(node->token, "+=") &&
+      !token_is_punct(node->token, "-=") &&
+      !token_is_punct(node->token, "*=") &&
+      !token_is_punct(node->token, "/=") &&
+      !token_is_punct(node->token, "%=")) {
+    return checker_set_error(checker,
+                             "checker: expected compound assignment operator");
   }
 
-  return checker_set_error(checker, "checker: expected assignment target");
+  if (!checker_validate_target(checker, left)) {
+    return 0;
+  }
+
+  return checker_validate_expression(checker, right);
 }
 
 static int checker_validate_statement(Checker *checker,
@@ -313,9 +359,15 @@ static int checker_validate_statement(Checker *checker,
 
     return 1;
   }
-  case PARSER_NODE_ASSIGN: {
+  case PARSER_NODE_ASSIGN:
+  case PARSER_NODE_COMPOUND_ASSIGN:
+  case PARSER_NODE_POSTFIX:
+    return checker_validate_assignment(checker, node);
+  case PARSER_NODE_UNARY:
+    if (!token_is_increment(node->token)) {
+      return checker_set_error(checker, "checker: expected statement");
+    }
     return checker_validate_assignment(checker, node);
-  }
   case PARSER_NODE_WHILE: {
     const ParserNode *condition = node->first_child;
     const ParserNode *body = condition ? condition->next : NULL;
@@ -355,7 +407,7 @@ static int checker_validate_statement(Checker *checker,
 
     if (init->type != PARSER_NODE_EMPTY &&
         init->type != PARSER_NODE_DECLARATION &&
-        init->type != PARSER_NODE_ASSIGN) {
+        !checker_is_assignment(init)) {
       return checker_set_error(checker, "checker: expected for init");
     }
 
@@ -364,7 +416,7 @@ static int checker_validate_statement(Checker *checker,
       return 0;
     }
 
-    if (init->type == PARSER_NODE_ASSIGN &&
+    if (checker_is_assignment(init) &&
         !checker_validate_assignment(checker, init)) {
       return 0;
     }
@@ -375,11 +427,11 @@ static int checker_validate_statement(Checker *checker,
     }
 
     if (increment->type != PARSER_NODE_EMPTY &&
-        increment->type != PARSER_NODE_ASSIGN) {
+        !checker_is_assignment(increment)) {
       return checker_set_error(checker, "checker: expected for increment");
     }
 
-    if (increment->type == PARSER_NODE_ASSIGN &&
+    if (checker_is_assignment(increment) &&
         !checker_validate_assignment(checker, increment)) {
       return 0;
     }
@@ -389,6 +441,58 @@ static int checker_validate_statement(Checker *checker,
     checker->loop_depth -= 1;
     return result;
   }
+  case PARSER_NODE_SWITCH: {
+    const ParserNode *condition = node->first_child;
+    const ParserNode *body = condition ? condition->next : NULL;
+    int result = 0;
+
+    if (!condition || !body) {
+      return checker_set_error(checker, "checker: incomplete switch statement");
+    }
+
+    if (body->next) {
+      return checker_set_error(checker,
+                               "checker: unexpected switch statement");
+    }
+
+    if (!checker_validate_expression(checker, condition)) {
+      return 0;
+    }
+
+    checker->switch_depth += 1;
+    result = checker_validate_statement(checker, body);
+    checker->switch_depth -= 1;
+    return result;
+  }
+  case PARSER_NODE_CASE: {
+    const ParserNode *value = node->first_child;
+    const ParserNode *body = value ? value->next : NULL;
+
+    if (checker->switch_depth <= 0) {
+      return checker_set_error(checker, "checker: case label outside switch");
+    }
+
+    if (!value || !body || body->next) {
+      return checker_set_error(checker, "checker: incomplete case label");
+    }
+
+    if (!checker_validate_expression(checker, value)) {
+      return 0;
+    }
+
+    return checker_validate_statement(checker, body);
+  }
+  case PARSER_NODE_DEFAULT:
+    if (checker->switch_depth <= 0) {
+      return checker_set_error(checker,
+                               "checker: default label outside switch");
+    }
+
+    if (!node->first_child || node->first_child->next) {
+      return checker_set_error(checker, "checker: incomplete default label");
+    }
+
+    return checker_validate_statement(checker, node->first_child);
   case PARSER_NODE_RETURN:
     if (!node->first_child || node->first_child->next) {
       return checker_set_error(checker, "checker: unexpected return statement");
@@ -396,7 +500,8 @@ static int checker_validate_statement(Checker *checker,
 
     return checker_validate_expression(checker, node->first_child);
   case PARSER_NODE_BREAK:
-    if (node->first_child || checker->loop_depth <= 0) {
+    if (node->first_child ||
+        (checker->loop_depth <= 0 && checker->switch_depth <= 0)) {
       return checker_set_error(checker, "checker: unexpected break statement");
     }
     return 1;
@@ -416,8 +521,29 @@ static int checker_validate_statement(Checker *checker,
   }
 }
 
+/* An expression, or a braced list of initializers for its elements. */
+static int checker_validate_initializer(Checker *checker,
+                                        const ParserNode *node) {
+  const ParserNode *element = NULL;
+
+  if (node->type != PARSER_NODE_INITIALIZER) {
+    return checker_validate_expression(checker, node);
+  }
+
+  for (element = node->first_child; element; element = element->next) {
+    if (!checker_validate_initializer(checker, element)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
 static int checker_validate_declaration(Checker *checker,
                                         const ParserNode *node) {
+  const ParserNode *element = NULL;
+  size_t count = 0;
+
   if (node->type != PARSER_NODE_DECLARATION) {
     return checker_set_error(checker, "checker: expected declaration");
   }
@@ -431,7 +557,27 @@ static int checker_validate_declaration(Checker *checker,
       return checker_set_error(checker, "checker: unexpected initializer list");
     }
 
-    if (!checker_validate_expression(checker, node->first_child)) {
+    if (node->array_length > 0 &&
+        node->first_child->type != PARSER_NODE_INITIALIZER) {
+      return checker_set_error(checker, "checker: expected initializer list");
+    }
+
+    if (node->array_length == 0 && node->pointer_depth > 0 &&
+        node->first_child->type == PARSER_NODE_INITIALIZER) {
+      return checker_set_error(checker, "checker: unexpected initializer list");
+    }
+
+    for (element = node->first_child->type == PARSER_NODE_INITIALIZER
+                     ? node->first_child->first_child
+                     : NULL;
+         element; element = element->next) {
+      count++;
+    }
+    if (node->array_length > 0 && count > node->array_length) {
+      return checker_set_error(checker, "checker: too many initializers");
+    }
+
+    if (!checker_validate_initializer(checker, node->first_child)) {
       return 0;
     }
   }
@@ -8,24 +8,29 @@
   X(check_type_declarations, "check type declarations")                        \
   X(check_pointer_support, "check pointer support")                            \
   X(check_array_support, "check array support")                                \
+  X(check_initializer_list, "check initializer list")                          \
   X(check_typedef_const_cast, "check typedef const cast")                      \
   X(check_static_declarations, "check static declarations")                    \
   X(check_struct_definition, "check struct definition")                        \
   X(check_function_control_flow, "check function control flow")                \
   X(check_for_loop, "check for loop")                                          \
   X(check_loop_control, "check loop control")                                  \
+  X(check_switch_statement, "check switch statement")                          \
   X(check_function_call, "check function call")                                \
   X(check_extern_function_declaration, "check extern function declaration")    \
   X(check_assignment_statement, "check assignment statement")                  \
   X(check_dereference_assignment, "check dereference assignment")              \
+  X(check_compound_assignment, "check compound assignment")                    \
   X(check_binary_expression, "check binary expression")                        \
   X(check_parenthesized_arithmetic, "check parenthesized arithmetic")          \
   X(check_nested_parentheses, "check nested parentheses")                      \
   X(check_unary_arithmetic, "check unary arithmetic")                          \
   X(check_sizeof, "check sizeof")                                              \
   X(check_logical_expression, "check logical expression")                      \
+  X(check_relational_expression, "check relational expression")                \
   X(check_break_outside_loop, "check break outside loop")                      \
   X(check_continue_outside_loop, "check continue outside loop")                \
+  X(check_case_outside_switch, "check case outside switch")                    \
   X(check_invalid_token, "check invalid token")                                \
   X(check_mismatched_parentheses, "check mismatched parentheses")              \
   X(check_unexpected_closing_paren, "check unexpected closing paren")          \
@@ -81,6 +86,30 @@ TEST(check_array_support, "check array support") {
   return 1;
 }
 
+TEST(check_initializer_list, "check initializer list") {
+  Checker checker;
+
+  checker_init(&checker, "int table[4] = {1, 2, 3};"
+                         "int main(){int local[] = {table[0], 2};"
+                         "return local[1];}");
+
+  ASSERT_TRUE(checker_check(&checker), "expected check success");
+  ASSERT_TRUE(checker_error(&checker) == NULL, "unexpected error message");
+
+  checker_init(&checker, "int table[2] = {1, 2, 3};");
+  ASSERT_TRUE(!checker_check(&checker), "expected check failure");
+  ASSERT_TRUE(test_error_contains(checker_error(&checker), "too many"),
+              "expected too many initializers error");
+
+  checker_init(&checker, "int table[2] = 1;");
+  ASSERT_TRUE(!checker_check(&checker), "expected check failure");
+  ASSERT_TRUE(
+    test_error_contains(checker_error(&checker), "expected initializer list"),
+    "expected initializer list error");
+
+  return 1;
+}
+
 TEST(check_typedef_const_cast, "check typedef const cast") {
   Checker checker;
 
@@ -158,6 +187,24 @@ TEST(check_loop_control, "check loop control") {
   return 1;
 }
 
+TEST(check_switch_statement, "check switch statement") {
+  Checker checker;
+
+  checker_init(&checker, "int main(int x){while(x){switch(x){case 1:break;"
+                         "case 2:continue;default:return 1;}}return 0;}");
+
+  ASSERT_TRUE(checker_check(&checker), "expected check success");
+  ASSERT_TRUE(checker_error(&checker) == NULL, "unexpected error message");
+
+  checker_init(&checker, "int main(int x){switch(x){case 1:continue;}}");
+
+  ASSERT_TRUE(!checker_check(&checker), "expected check failure");
+  ASSERT_TRUE(test_error_contains(checker_error(&checker), "continue"),
+              "expected continue error");
+
+  return 1;
+}
+
 TEST(check_function_call, "check function call") {
   Checker checker;
 
@@ -208,6 +255,22 @@ TEST(check_dereference_assignment, "check dereference assignment") {
   return 1;
 }
 
+TEST(check_compound_assignment, "check compound assignment") {
+  Checker checker;
+
+  checker_init(&checker, "int main(){int a[3]; int i=0; a[i++] = 1;"
+                         " a[0] *= 2; for (i = 0; i < 3; ++i) {} return i--;}");
+
+  ASSERT_TRUE(checker_check(&checker), "expected check success");
+  ASSERT_TRUE(checker_error(&checker) == NULL, "unexpected error message");
+
+  checker_init(&checker, "int main(){int a=0; a = (a + 1)++; return a;}");
+
+  ASSERT_TRUE(!checker_check(&checker), "expected check failure");
+
+  return 1;
+}
+
 TEST(check_binary_expression, "check binary expression") {
   Checker checker;
 
@@ -277,6 +340,18 @@ TEST(check_logical_expression, "check logical expression") {
   return 1;
 }
 
+TEST(check_relational_expression, "check relational expression") {
+  Checker checker;
+
+  checker_init(&checker, "int main(){int i; for (i = 0; i < 3; i = i + 1) {}"
+                         "return 1 <= 2 == 3 > 4 || 5 >= 6 != 0;}");
+
+  ASSERT_TRUE(checker_check(&checker), "expected check success");
+  ASSERT_TRUE(checker_error(&checker) == NULL, "unexpected error message");
+
+  return 1;
+}
+
 TEST(check_break_outside_loop, "check break outside loop") {
   Checker checker;
 
@@ -301,6 +376,18 @@ TEST(check_continue_outside_loop, "check continue outside loop") {
   return 1;
 }
 
+TEST(check_case_outside_switch, "check case outside switch") {
+  Checker checker;
+
+  checker_init(&checker, "int main(){case 1:return 0;}");
+
+  ASSERT_TRUE(!checker_check(&checker), "expected check failure");
+  ASSERT_TRUE(test_error_contains(checker_error(&checker), "case"),
+              "expected case error");
+
+  return 1;
+}
+
 TEST(check_invalid_token, "check invalid token") {
   Checker checker;
 
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int heap_sort(int *values, int count);
+int sieve_primes(int *buffer, int max);
+int conv1d(int *a, int n, int *b, int m, int *out);
+
+#define HEAP_COUNT 4096
+#define CONV_N 512
+#define CONV_M 64
+
+static double now_ms(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Prints the best of five runs so a noisy neighbour does not skew it. */
+static void report(const char *name, double best, long checksum) {
+  printf("%-14s %9.2f ms  (checksum %ld)\n", name, best, checksum);
+}
+
+static long run_heap_sort(int rounds) {
+  static int values[HEAP_COUNT];
+  long checksum = 0;
+
+  for (int round = 0; round < rounds; round++) {
+    srand(round);
+    for (int i = 0; i < HEAP_COUNT; i++) {
+      values[i] = rand() % 64;
+    }
+    heap_sort(values, HEAP_COUNT);
+    checksum += values[HEAP_COUNT / 2];
+  }
+
+  return checksum;
+}
+
+static long run_sieve(int rounds) {
+  int buffer[128];
+  long checksum = 0;
+
+  for (int round = 0; round < rounds; round++) {
+    checksum += sieve_primes(buffer, 127);
+  }
+
+  return checksum;
+}
+
+static long run_conv1d(int rounds) {
+  static int a[CONV_N];
+  static int b[CONV_M];
+  static int out[CONV_N + CONV_M - 1];
+  long checksum = 0;
+
+  for (int i = 0; i < CONV_N; i++) {
+    a[i] = i % 7 - 3;
+  }
+  for (int i = 0; i < CONV_M; i++) {
+    b[i] = i % 5 - 2;
+  }
+
+  for (int round = 0; round < rounds; round++) {
+    conv1d(a, CONV_N, b, CONV_M, out);
+    checksum += out[round % (CONV_N + CONV_M - 1)];
+  }
+
+  return checksum;
+}
+
+static void measure(const char *name, long (*run)(int), int rounds) {
+  double best = 0.0;
+  long checksum = 0;
+
+  for (int trial = 0; trial < 5; trial++) {
+    double start = now_ms();
+    double elapsed = 0.0;
+
+    checksum = run(rounds);
+    elapsed = now_ms() - start;
+    if (trial == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+
+  report(name, best, checksum);
+}
+
+static const struct {
+  const char *name;
+  long (*run)(int);
+  int rounds;
+} benchmarks[] = {
+  {"heap_sort", run_heap_sort, 10},
+  {"sieve_primes", run_sieve, 20000},
+  {"conv1d", run_conv1d, 500},
+};
+
+/* Given a name, runs one round of that program once, for counting. */
+int main(int argc, char **argv) {
+  size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+  for (size_t index = 0; index < count; index++) {
+    if (argc < 2) {
+      measure(benchmarks[index].name, benchmarks[index].run,
+              benchmarks[index].rounds);
+    } else if (strcmp(argv[1], benchmarks[index].name) == 0) {
+      printf("checksum %ld\n", benchmarks[index].run(1));
+      return 0;
+    }
+  }
+
+  if (argc >= 2) {
+    fprintf(stderr, "unknown benchmark: %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,168 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Node = type { i32, %struct.Node*, %struct.Node* }
+
+@node_a = global %struct.Node zeroinitializer
+@node_b = global %struct.Node zeroinitializer
+@node_c = global %struct.Node zeroinitializer
+@node_d = global %struct.Node zeroinitializer
+@node_e = global %struct.Node zeroinitializer
+@node_f = global %struct.Node zeroinitializer
+@node_g = global %struct.Node zeroinitializer
+define noundef %struct.Node* @bst_find(%struct.Node* noundef %root, i32 noundef %value) {
+entry:
+  %t0 = alloca %struct.Node*
+  store %struct.Node* null, %struct.Node** %t0, !tbaa !3
+  %t1 = icmp ne %struct.Node* %root, null
+  br i1 %t1, label %if.end1, label %if.then0
+if.then0:
+  ret %struct.Node* null
+if.end1:
+  %t2 = getelementptr inbounds %struct.Node, %struct.Node* %root, i32 0, i32 0
+  %t3 = load i32, i32* %t2, !tbaa !6
+  %t4 = sub nsw i32 %t3, %value
+  %t5 = icmp ne i32 %t4, 0
+  br i1 %t5, label %if.end3, label %if.then2
+if.then2:
+  ret %struct.Node* %root
+if.end3:
+  %t6 = getelementptr inbounds %struct.Node, %struct.Node* %root, i32 0, i32 1
+  %t7 = load %struct.Node*, %struct.Node** %t6, !tbaa !7
+  %t8 = call %struct.Node* @bst_find(%struct.Node* %t7, i32 %value)
+  store %struct.Node* %t8, %struct.Node** %t0, !tbaa !3
+  %t9 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t10 = icmp ne %struct.Node* %t9, null
+  br i1 %t10, label %if.then4, label %if.end5
+if.then4:
+  %t11 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  ret %struct.Node* %t11
+if.end5:
+  %t12 = getelementptr inbounds %struct.Node, %struct.Node* %root, i32 0, i32 2
+  %t13 = load %struct.Node*, %struct.Node** %t12, !tbaa !8
+  %t14 = call %struct.Node* @bst_find(%struct.Node* %t13, i32 %value)
+  ret %struct.Node* %t14
+}
+define noundef %struct.Node* @bst_build() {
+entry:
+  %t0 = alloca %struct.Node*
+  store %struct.Node* null, %struct.Node** %t0, !tbaa !3
+  %t1 = getelementptr inbounds %struct.Node, %struct.Node* @node_a, i32 0, i32 0
+  store i32 5, i32* %t1, !tbaa !6
+  %t2 = getelementptr inbounds %struct.Node, %struct.Node* @node_b, i32 0, i32 0
+  store i32 3, i32* %t2, !tbaa !6
+  %t3 = getelementptr inbounds %struct.Node, %struct.Node* @node_c, i32 0, i32 0
+  store i32 8, i32* %t3, !tbaa !6
+  %t4 = getelementptr inbounds %struct.Node, %struct.Node* @node_d, i32 0, i32 0
+  store i32 1, i32* %t4, !tbaa !6
+  %t5 = getelementptr inbounds %struct.Node, %struct.Node* @node_e, i32 0, i32 0
+  store i32 4, i32* %t5, !tbaa !6
+  %t6 = getelementptr inbounds %struct.Node, %struct.Node* @node_f, i32 0, i32 0
+  store i32 7, i32* %t6, !tbaa !6
+  %t7 = getelementptr inbounds %struct.Node, %struct.Node* @node_g, i32 0, i32 0
+  store i32 9, i32* %t7, !tbaa !6
+  %t8 = getelementptr inbounds %struct.Node, %struct.Node* @node_a, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t8, !tbaa !7
+  %t9 = getelementptr inbounds %struct.Node, %struct.Node* @node_a, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t9, !tbaa !8
+  %t10 = getelementptr inbounds %struct.Node, %struct.Node* @node_b, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t10, !tbaa !7
+  %t11 = getelementptr inbounds %struct.Node, %struct.Node* @node_b, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t11, !tbaa !8
+  %t12 = getelementptr inbounds %struct.Node, %struct.Node* @node_c, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t12, !tbaa !7
+  %t13 = getelementptr inbounds %struct.Node, %struct.Node* @node_c, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t13, !tbaa !8
+  %t14 = getelementptr inbounds %struct.Node, %struct.Node* @node_d, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t14, !tbaa !7
+  %t15 = getelementptr inbounds %struct.Node, %struct.Node* @node_d, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t15, !tbaa !8
+  %t16 = getelementptr inbounds %struct.Node, %struct.Node* @node_e, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t16, !tbaa !7
+  %t17 = getelementptr inbounds %struct.Node, %struct.Node* @node_e, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t17, !tbaa !8
+  %t18 = getelementptr inbounds %struct.Node, %struct.Node* @node_f, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t18, !tbaa !7
+  %t19 = getelementptr inbounds %struct.Node, %struct.Node* @node_f, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t19, !tbaa !8
+  %t20 = getelementptr inbounds %struct.Node, %struct.Node* @node_g, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t20, !tbaa !7
+  %t21 = getelementptr inbounds %struct.Node, %struct.Node* @node_g, i32 0, i32 2
+  store %struct.Node* null, %struct.Node** %t21, !tbaa !8
+  store %struct.Node* @node_a, %struct.Node** %t0, !tbaa !3
+  %t22 = getelementptr inbounds %struct.Node, %struct.Node* @node_a, i32 0, i32 1
+  store %struct.Node* @node_b, %struct.Node** %t22, !tbaa !7
+  %t23 = getelementptr inbounds %struct.Node, %struct.Node* @node_a, i32 0, i32 2
+  store %struct.Node* @node_c, %struct.Node** %t23, !tbaa !8
+  %t24 = getelementptr inbounds %struct.Node, %struct.Node* @node_b, i32 0, i32 1
+  store %struct.Node* @node_d, %struct.Node** %t24, !tbaa !7
+  %t25 = getelementptr inbounds %struct.Node, %struct.Node* @node_b, i32 0, i32 2
+  store %struct.Node* @node_e, %struct.Node** %t25, !tbaa !8
+  %t26 = getelementptr inbounds %struct.Node, %struct.Node* @node_c, i32 0, i32 1
+  store %struct.Node* @node_f, %struct.Node** %t26, !tbaa !7
+  %t27 = getelementptr inbounds %struct.Node, %struct.Node* @node_c, i32 0, i32 2
+  store %struct.Node* @node_g, %struct.Node** %t27, !tbaa !8
+  %t28 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  ret %struct.Node* %t28
+}
+define noundef i32 @bst_search_sum() {
+entry:
+  %t0 = alloca %struct.Node*
+  %t1 = call %struct.Node* @bst_build()
+  store %struct.Node* %t1, %struct.Node** %t0, !tbaa !3
+  %t2 = alloca i32
+  store i32 0, i32* %t2, !tbaa !9
+  %t3 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t4 = call %struct.Node* @bst_find(%struct.Node* %t3, i32 4)
+  %t5 = icmp ne %struct.Node* %t4, null
+  br i1 %t5, label %if.then0, label %if.end1
+if.then0:
+  %t6 = load i32, i32* %t2, !tbaa !9
+  %t7 = add nsw i32 %t6, 4
+  store i32 %t7, i32* %t2, !tbaa !9
+  br label %if.end1
+if.end1:
+  %t8 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t9 = call %struct.Node* @bst_find(%struct.Node* %t8, i32 6)
+  %t10 = icmp ne %struct.Node* %t9, null
+  br i1 %t10, label %if.then2, label %if.end3
+if.then2:
+  %t11 = load i32, i32* %t2, !tbaa !9
+  %t12 = add nsw i32 %t11, 100
+  store i32 %t12, i32* %t2, !tbaa !9
+  br label %if.end3
+if.end3:
+  %t13 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t14 = call %struct.Node* @bst_find(%struct.Node* %t13, i32 7)
+  %t15 = icmp ne %struct.Node* %t14, null
+  br i1 %t15, label %if.then4, label %if.end5
+if.then4:
+  %t16 = load i32, i32* %t2, !tbaa !9
+  %t17 = add nsw i32 %t16, 7
+  store i32 %t17, i32* %t2, !tbaa !9
+  br label %if.end5
+if.end5:
+  %t18 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t19 = call %struct.Node* @bst_find(%struct.Node* %t18, i32 9)
+  %t20 = icmp ne %struct.Node* %t19, null
+  br i1 %t20, label %if.then6, label %if.end7
+if.then6:
+  %t21 = load i32, i32* %t2, !tbaa !9
+  %t22 = add nsw i32 %t21, 9
+  store i32 %t22, i32* %t2, !tbaa !9
+  br label %if.end7
+if.end7:
+  %t23 = load i32, i32* %t2, !tbaa !9
+  ret i32 %t23
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"any pointer", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"int", !1, i64 0}
+!5 = !{!"Node", !4, i64 0, !2, i64 8, !2, i64 16}
+!6 = !{!5, !4, i64 0}
+!7 = !{!5, !2, i64 8}
+!8 = !{!5, !2, i64 16}
+!9 = !{!4, !4, i64 0}
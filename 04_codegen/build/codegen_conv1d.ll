@@ -0,0 +1,79 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @conv1d(i32* noundef %a, i32 noundef %n, i32* noundef %b, i32 noundef %m, i32* noundef %out) {
+entry:
+  %t0 = alloca i32
+  %t1 = add nsw i32 %n, %m
+  %t2 = sub nsw i32 %t1, 1
+  store i32 %t2, i32* %t0, !tbaa !3
+  %t3 = alloca i32
+  store i32 0, i32* %t3, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t4 = load i32, i32* %t3, !tbaa !3
+  %t5 = load i32, i32* %t0, !tbaa !3
+  %t6 = icmp slt i32 %t4, %t5
+  br i1 %t6, label %for.body1, label %for.end3
+for.body1:
+  %t7 = load i32, i32* %t3, !tbaa !3
+  %t8 = getelementptr inbounds i32, i32* %out, i32 %t7
+  store i32 0, i32* %t8, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t9 = load i32, i32* %t3, !tbaa !3
+  %t10 = add nsw i32 %t9, 1
+  store i32 %t10, i32* %t3, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t11 = alloca i32
+  store i32 0, i32* %t11, !tbaa !3
+  br label %for.cond4
+for.cond4:
+  %t12 = load i32, i32* %t11, !tbaa !3
+  %t13 = icmp slt i32 %t12, %n
+  br i1 %t13, label %for.body5, label %for.end7
+for.body5:
+  %t14 = alloca i32
+  store i32 0, i32* %t14, !tbaa !3
+  br label %for.cond8
+for.cond8:
+  %t15 = load i32, i32* %t14, !tbaa !3
+  %t16 = icmp slt i32 %t15, %m
+  br i1 %t16, label %for.body9, label %for.end11
+for.body9:
+  %t17 = load i32, i32* %t11, !tbaa !3
+  %t18 = load i32, i32* %t14, !tbaa !3
+  %t19 = add nsw i32 %t17, %t18
+  %t20 = getelementptr inbounds i32, i32* %out, i32 %t19
+  %t21 = load i32, i32* %t11, !tbaa !3
+  %t22 = getelementptr inbounds i32, i32* %a, i32 %t21
+  %t23 = load i32, i32* %t22, !tbaa !3
+  %t24 = load i32, i32* %t14, !tbaa !3
+  %t25 = getelementptr inbounds i32, i32* %b, i32 %t24
+  %t26 = load i32, i32* %t25, !tbaa !3
+  %t27 = mul nsw i32 %t23, %t26
+  %t28 = load i32, i32* %t20, !tbaa !3
+  %t29 = add nsw i32 %t28, %t27
+  store i32 %t29, i32* %t20, !tbaa !3
+  br label %for.inc10
+for.inc10:
+  %t30 = load i32, i32* %t14, !tbaa !3
+  %t31 = add nsw i32 %t30, 1
+  store i32 %t31, i32* %t14, !tbaa !3
+  br label %for.cond8
+for.end11:
+  br label %for.inc6
+for.inc6:
+  %t32 = load i32, i32* %t11, !tbaa !3
+  %t33 = add nsw i32 %t32, 1
+  store i32 %t33, i32* %t11, !tbaa !3
+  br label %for.cond4
+for.end7:
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
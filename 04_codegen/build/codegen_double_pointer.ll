@@ -0,0 +1,29 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @set_value(i32** noundef %target, i32 noundef %value) {
+entry:
+  %t0 = load i32*, i32** %target, !tbaa !3
+  store i32 %value, i32* %t0, !tbaa !5
+  %t1 = load i32*, i32** %target, !tbaa !3
+  %t2 = load i32, i32* %t1, !tbaa !5
+  ret i32 %t2
+}
+define noundef i32 @increment_via_pointer(i32** noundef %target) {
+entry:
+  %t0 = load i32*, i32** %target, !tbaa !3
+  %t1 = load i32*, i32** %target, !tbaa !3
+  %t2 = load i32, i32* %t1, !tbaa !5
+  %t3 = add nsw i32 %t2, 1
+  store i32 %t3, i32* %t0, !tbaa !5
+  %t4 = load i32*, i32** %target, !tbaa !3
+  %t5 = load i32, i32* %t4, !tbaa !5
+  ret i32 %t5
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"any pointer", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"int", !1, i64 0}
+!5 = !{!4, !4, i64 0}
@@ -0,0 +1,30 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+declare noundef i32 @write(i32 noundef, i8* noundef, i32 noundef)
+declare noundef i8* @malloc(i32 noundef)
+declare noundef i32 @free(i8* noundef)
+define noundef i32 @extern_calls() {
+entry:
+  %t0 = alloca [4 x i8]
+  %t1 = alloca i8*
+  %t2 = alloca i32
+  %t3 = alloca i32
+  %t4 = getelementptr inbounds [4 x i8], [4 x i8]* %t0, i32 0, i32 0
+  %t5 = call i32 @write(i32 1, i8* %t4, i32 0)
+  store i32 %t5, i32* %t2, !tbaa !3
+  %t6 = call i8* @malloc(i32 4)
+  store i8* %t6, i8** %t1, !tbaa !5
+  %t7 = load i8*, i8** %t1, !tbaa !5
+  %t8 = call i32 @free(i8* %t7)
+  store i32 %t8, i32* %t3, !tbaa !3
+  %t9 = load i32, i32* %t2, !tbaa !3
+  ret i32 %t9
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"any pointer", !1, i64 0}
+!5 = !{!4, !4, i64 0}
@@ -0,0 +1,60 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @fib_recursive(i32 noundef %n) {
+entry:
+  %t0 = icmp ne i32 %n, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = icmp ne i32 %t1, 0
+  br i1 %t2, label %if.then2, label %if.end3
+if.then2:
+  %t3 = sub nsw i32 %n, 1
+  %t4 = call i32 @fib_recursive(i32 %t3)
+  %t5 = sub nsw i32 %n, 2
+  %t6 = call i32 @fib_recursive(i32 %t5)
+  %t7 = add nsw i32 %t4, %t6
+  ret i32 %t7
+if.end3:
+  br label %if.end1
+if.end1:
+  ret i32 %n
+}
+define noundef i32 @fib_iterative(i32 noundef %n) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 1, i32* %t1, !tbaa !3
+  %t2 = alloca i32
+  store i32 %n, i32* %t2, !tbaa !3
+  %t3 = alloca i32
+  store i32 0, i32* %t3, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t4 = load i32, i32* %t2, !tbaa !3
+  %t5 = icmp ne i32 %t4, 0
+  br i1 %t5, label %while.body1, label %while.end2
+while.body1:
+  %t6 = load i32, i32* %t0, !tbaa !3
+  %t7 = load i32, i32* %t1, !tbaa !3
+  %t8 = add nsw i32 %t6, %t7
+  store i32 %t8, i32* %t3, !tbaa !3
+  %t9 = load i32, i32* %t1, !tbaa !3
+  store i32 %t9, i32* %t0, !tbaa !3
+  %t10 = load i32, i32* %t3, !tbaa !3
+  store i32 %t10, i32* %t1, !tbaa !3
+  %t11 = load i32, i32* %t2, !tbaa !3
+  %t12 = sub nsw i32 %t11, 1
+  store i32 %t12, i32* %t2, !tbaa !3
+  br label %while.cond0
+while.end2:
+  %t13 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t13
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,34 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @sum_down() {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 5, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !3
+  %t3 = icmp ne i32 %t2, 0
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t1, !tbaa !3
+  %t5 = load i32, i32* %t0, !tbaa !3
+  %t6 = add nsw i32 %t5, %t4
+  store i32 %t6, i32* %t0, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t7 = load i32, i32* %t1, !tbaa !3
+  %t8 = sub nsw i32 %t7, 1
+  store i32 %t8, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t9 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t9
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
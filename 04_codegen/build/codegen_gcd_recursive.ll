@@ -0,0 +1,14 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @gcd_recursive(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = icmp ne i32 %b, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  ret i32 %a
+if.end1:
+  %t1 = srem i32 %a, %b
+  %t2 = call i32 @gcd_recursive(i32 %b, i32 %t1)
+  ret i32 %t2
+}
@@ -0,0 +1,195 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @is_leq(i32 noundef %left, i32 noundef %right) {
+entry:
+  %t0 = alloca i32
+  store i32 %left, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 %right, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t2 = load i32, i32* %t0, !tbaa !3
+  %t3 = icmp ne i32 %t2, 0
+  br i1 %t3, label %logic.rhs3, label %while.end2
+logic.rhs3:
+  %t4 = load i32, i32* %t1, !tbaa !3
+  %t5 = icmp ne i32 %t4, 0
+  br i1 %t5, label %while.body1, label %while.end2
+while.body1:
+  %t6 = load i32, i32* %t0, !tbaa !3
+  %t7 = sub nsw i32 %t6, 1
+  store i32 %t7, i32* %t0, !tbaa !3
+  %t8 = load i32, i32* %t1, !tbaa !3
+  %t9 = sub nsw i32 %t8, 1
+  store i32 %t9, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.end2:
+  %t10 = load i32, i32* %t0, !tbaa !3
+  %t11 = icmp ne i32 %t10, 0
+  br i1 %t11, label %if.then4, label %if.end5
+if.then4:
+  ret i32 0
+if.end5:
+  ret i32 1
+}
+define noundef i32 @swap_values(i32* noundef %left, i32* noundef %right) {
+entry:
+  %t0 = alloca i32
+  %t1 = load i32, i32* %left, !tbaa !3
+  store i32 %t1, i32* %t0, !tbaa !3
+  %t2 = load i32, i32* %right, !tbaa !3
+  store i32 %t2, i32* %left, !tbaa !3
+  %t3 = load i32, i32* %t0, !tbaa !3
+  store i32 %t3, i32* %right, !tbaa !3
+  ret i32 0
+}
+define noundef i32 @sift_down(i32* noundef %values, i32 noundef %start, i32 noundef %end) {
+entry:
+  %t0 = alloca i32
+  store i32 %start, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t2 = icmp ne i32 1, 0
+  br i1 %t2, label %while.body1, label %while.end2
+while.body1:
+  %t3 = alloca i32
+  %t4 = load i32, i32* %t0, !tbaa !3
+  %t5 = shl nsw i32 %t4, 1
+  %t6 = add nsw i32 %t5, 1
+  store i32 %t6, i32* %t3, !tbaa !3
+  %t7 = alloca i32
+  %t8 = load i32, i32* %t0, !tbaa !3
+  store i32 %t8, i32* %t7, !tbaa !3
+  %t9 = load i32, i32* %t3, !tbaa !3
+  %t10 = call i32 @is_leq(i32 %t9, i32 %end)
+  %t11 = icmp ne i32 %t10, 0
+  br i1 %t11, label %if.end4, label %if.then3
+if.then3:
+  ret i32 0
+if.end4:
+  %t12 = load i32, i32* %t3, !tbaa !3
+  %t13 = getelementptr inbounds i32, i32* %values, i32 %t12
+  %t14 = load i32, i32* %t13, !tbaa !3
+  %t15 = load i32, i32* %t7, !tbaa !3
+  %t16 = getelementptr inbounds i32, i32* %values, i32 %t15
+  %t17 = load i32, i32* %t16, !tbaa !3
+  %t18 = call i32 @is_leq(i32 %t14, i32 %t17)
+  %t19 = icmp ne i32 %t18, 0
+  br i1 %t19, label %if.end6, label %if.then5
+if.then5:
+  %t20 = load i32, i32* %t3, !tbaa !3
+  store i32 %t20, i32* %t7, !tbaa !3
+  br label %if.end6
+if.end6:
+  %t21 = load i32, i32* %t3, !tbaa !3
+  %t22 = add nsw i32 %t21, 1
+  %t23 = call i32 @is_leq(i32 %t22, i32 %end)
+  %t24 = icmp ne i32 %t23, 0
+  br i1 %t24, label %if.then7, label %if.end8
+if.then7:
+  %t25 = load i32, i32* %t3, !tbaa !3
+  %t26 = getelementptr inbounds i32, i32* %values, i32 %t25
+  %t27 = getelementptr inbounds i32, i32* %t26, i32 1
+  %t28 = load i32, i32* %t27, !tbaa !3
+  %t29 = load i32, i32* %t7, !tbaa !3
+  %t30 = getelementptr inbounds i32, i32* %values, i32 %t29
+  %t31 = load i32, i32* %t30, !tbaa !3
+  %t32 = call i32 @is_leq(i32 %t28, i32 %t31)
+  %t33 = icmp ne i32 %t32, 0
+  br i1 %t33, label %if.end10, label %if.then9
+if.then9:
+  %t34 = load i32, i32* %t3, !tbaa !3
+  %t35 = add nsw i32 %t34, 1
+  store i32 %t35, i32* %t7, !tbaa !3
+  br label %if.end10
+if.end10:
+  br label %if.end8
+if.end8:
+  %t36 = load i32, i32* %t7, !tbaa !3
+  %t37 = load i32, i32* %t0, !tbaa !3
+  %t38 = sub nsw i32 %t36, %t37
+  %t39 = icmp ne i32 %t38, 0
+  br i1 %t39, label %if.end12, label %if.then11
+if.then11:
+  ret i32 0
+if.end12:
+  %t40 = load i32, i32* %t0, !tbaa !3
+  %t41 = getelementptr inbounds i32, i32* %values, i32 %t40
+  %t42 = load i32, i32* %t7, !tbaa !3
+  %t43 = getelementptr inbounds i32, i32* %values, i32 %t42
+  %t44 = call i32 @swap_values(i32* %t41, i32* %t43)
+  store i32 %t44, i32* %t1, !tbaa !3
+  %t45 = load i32, i32* %t7, !tbaa !3
+  store i32 %t45, i32* %t0, !tbaa !3
+  br label %while.cond0
+while.end2:
+  ret i32 0
+}
+define noundef i32 @heap_sort(i32* noundef %values, i32 noundef %count) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = icmp ne i32 %count, 0
+  br i1 %t1, label %if.end1, label %if.then0
+if.then0:
+  ret i32 0
+if.end1:
+  %t2 = alloca i32
+  %t3 = sub nsw i32 %count, 2
+  %t4 = ashr i32 %t3, 31
+  %t5 = lshr i32 %t4, 31
+  %t6 = add i32 %t3, %t5
+  %t7 = ashr i32 %t6, 1
+  store i32 %t7, i32* %t2, !tbaa !3
+  br label %for.cond2
+for.cond2:
+  %t8 = load i32, i32* %t2, !tbaa !3
+  %t9 = add nsw i32 %t8, 1
+  %t10 = icmp ne i32 %t9, 0
+  br i1 %t10, label %for.body3, label %for.end5
+for.body3:
+  %t11 = load i32, i32* %t2, !tbaa !3
+  %t12 = sub nsw i32 %count, 1
+  %t13 = call i32 @sift_down(i32* %values, i32 %t11, i32 %t12)
+  store i32 %t13, i32* %t0, !tbaa !3
+  br label %for.inc4
+for.inc4:
+  %t14 = load i32, i32* %t2, !tbaa !3
+  %t15 = sub nsw i32 %t14, 1
+  store i32 %t15, i32* %t2, !tbaa !3
+  br label %for.cond2
+for.end5:
+  %t16 = alloca i32
+  %t17 = sub nsw i32 %count, 1
+  store i32 %t17, i32* %t16, !tbaa !3
+  br label %for.cond6
+for.cond6:
+  %t18 = load i32, i32* %t16, !tbaa !3
+  %t19 = icmp ne i32 %t18, 0
+  br i1 %t19, label %for.body7, label %for.end9
+for.body7:
+  %t20 = load i32, i32* %t16, !tbaa !3
+  %t21 = getelementptr inbounds i32, i32* %values, i32 %t20
+  %t22 = call i32 @swap_values(i32* %values, i32* %t21)
+  store i32 %t22, i32* %t0, !tbaa !3
+  %t23 = load i32, i32* %t16, !tbaa !3
+  %t24 = sub nsw i32 %t23, 1
+  %t25 = call i32 @sift_down(i32* %values, i32 0, i32 %t24)
+  store i32 %t25, i32* %t0, !tbaa !3
+  br label %for.inc8
+for.inc8:
+  %t26 = load i32, i32* %t16, !tbaa !3
+  %t27 = sub nsw i32 %t26, 1
+  store i32 %t27, i32* %t16, !tbaa !3
+  br label %for.cond6
+for.end9:
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,214 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @is_leq(i32 noundef %left, i32 noundef %right) {
+entry:
+  %t0 = icmp ne i32 %right, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = icmp ne i32 %left, 0
+  br i1 %t1, label %if.then2, label %if.end3
+if.then2:
+  ret i32 0
+if.end3:
+  ret i32 1
+}
+define noundef i32 @merge_into(i32* noundef %values, i32* noundef %temp, i32 noundef %low, i32 noundef %mid, i32 noundef %high) {
+entry:
+  %t0 = alloca i32
+  store i32 %low, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  %t2 = add nsw i32 %mid, 1
+  store i32 %t2, i32* %t1, !tbaa !3
+  %t3 = alloca i32
+  store i32 %low, i32* %t3, !tbaa !3
+  %t4 = alloca i32
+  %t5 = load i32, i32* %t0, !tbaa !3
+  %t6 = sub nsw i32 %mid, %t5
+  %t7 = add nsw i32 %t6, 1
+  store i32 %t7, i32* %t4, !tbaa !3
+  %t8 = alloca i32
+  %t9 = load i32, i32* %t1, !tbaa !3
+  %t10 = sub nsw i32 %high, %t9
+  %t11 = add nsw i32 %t10, 1
+  store i32 %t11, i32* %t8, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t12 = load i32, i32* %t4, !tbaa !3
+  %t13 = icmp ne i32 %t12, 0
+  br i1 %t13, label %logic.rhs3, label %while.end2
+logic.rhs3:
+  %t14 = load i32, i32* %t8, !tbaa !3
+  %t15 = icmp ne i32 %t14, 0
+  br i1 %t15, label %while.body1, label %while.end2
+while.body1:
+  %t16 = load i32, i32* %t0, !tbaa !3
+  %t17 = getelementptr inbounds i32, i32* %values, i32 %t16
+  %t18 = load i32, i32* %t17, !tbaa !3
+  %t19 = load i32, i32* %t1, !tbaa !3
+  %t20 = getelementptr inbounds i32, i32* %values, i32 %t19
+  %t21 = load i32, i32* %t20, !tbaa !3
+  %t22 = call i32 @is_leq(i32 %t18, i32 %t21)
+  %t23 = icmp ne i32 %t22, 0
+  br i1 %t23, label %if.then4, label %if.else5
+if.then4:
+  %t24 = load i32, i32* %t3, !tbaa !3
+  %t25 = getelementptr inbounds i32, i32* %temp, i32 %t24
+  %t26 = load i32, i32* %t0, !tbaa !3
+  %t27 = getelementptr inbounds i32, i32* %values, i32 %t26
+  %t28 = load i32, i32* %t27, !tbaa !3
+  store i32 %t28, i32* %t25, !tbaa !3
+  %t29 = load i32, i32* %t0, !tbaa !3
+  %t30 = add nsw i32 %t29, 1
+  store i32 %t30, i32* %t0, !tbaa !3
+  br label %if.end6
+if.else5:
+  %t31 = load i32, i32* %t3, !tbaa !3
+  %t32 = getelementptr inbounds i32, i32* %temp, i32 %t31
+  %t33 = load i32, i32* %t1, !tbaa !3
+  %t34 = getelementptr inbounds i32, i32* %values, i32 %t33
+  %t35 = load i32, i32* %t34, !tbaa !3
+  store i32 %t35, i32* %t32, !tbaa !3
+  %t36 = load i32, i32* %t1, !tbaa !3
+  %t37 = add nsw i32 %t36, 1
+  store i32 %t37, i32* %t1, !tbaa !3
+  br label %if.end6
+if.end6:
+  %t38 = load i32, i32* %t3, !tbaa !3
+  %t39 = add nsw i32 %t38, 1
+  store i32 %t39, i32* %t3, !tbaa !3
+  %t40 = load i32, i32* %t0, !tbaa !3
+  %t41 = sub nsw i32 %mid, %t40
+  %t42 = add nsw i32 %t41, 1
+  store i32 %t42, i32* %t4, !tbaa !3
+  %t43 = load i32, i32* %t1, !tbaa !3
+  %t44 = sub nsw i32 %high, %t43
+  %t45 = add nsw i32 %t44, 1
+  store i32 %t45, i32* %t8, !tbaa !3
+  br label %while.cond0
+while.end2:
+  %t46 = load i32, i32* %t0, !tbaa !3
+  %t47 = sub nsw i32 %mid, %t46
+  %t48 = add nsw i32 %t47, 1
+  store i32 %t48, i32* %t4, !tbaa !3
+  br label %while.cond7
+while.cond7:
+  %t49 = load i32, i32* %t4, !tbaa !3
+  %t50 = icmp ne i32 %t49, 0
+  br i1 %t50, label %while.body8, label %while.end9
+while.body8:
+  %t51 = load i32, i32* %t3, !tbaa !3
+  %t52 = getelementptr inbounds i32, i32* %temp, i32 %t51
+  %t53 = load i32, i32* %t0, !tbaa !3
+  %t54 = getelementptr inbounds i32, i32* %values, i32 %t53
+  %t55 = load i32, i32* %t54, !tbaa !3
+  store i32 %t55, i32* %t52, !tbaa !3
+  %t56 = load i32, i32* %t0, !tbaa !3
+  %t57 = add nsw i32 %t56, 1
+  store i32 %t57, i32* %t0, !tbaa !3
+  %t58 = load i32, i32* %t3, !tbaa !3
+  %t59 = add nsw i32 %t58, 1
+  store i32 %t59, i32* %t3, !tbaa !3
+  %t60 = load i32, i32* %t0, !tbaa !3
+  %t61 = sub nsw i32 %mid, %t60
+  %t62 = add nsw i32 %t61, 1
+  store i32 %t62, i32* %t4, !tbaa !3
+  br label %while.cond7
+while.end9:
+  %t63 = load i32, i32* %t1, !tbaa !3
+  %t64 = sub nsw i32 %high, %t63
+  %t65 = add nsw i32 %t64, 1
+  store i32 %t65, i32* %t8, !tbaa !3
+  br label %while.cond10
+while.cond10:
+  %t66 = load i32, i32* %t8, !tbaa !3
+  %t67 = icmp ne i32 %t66, 0
+  br i1 %t67, label %while.body11, label %while.end12
+while.body11:
+  %t68 = load i32, i32* %t3, !tbaa !3
+  %t69 = getelementptr inbounds i32, i32* %temp, i32 %t68
+  %t70 = load i32, i32* %t1, !tbaa !3
+  %t71 = getelementptr inbounds i32, i32* %values, i32 %t70
+  %t72 = load i32, i32* %t71, !tbaa !3
+  store i32 %t72, i32* %t69, !tbaa !3
+  %t73 = load i32, i32* %t1, !tbaa !3
+  %t74 = add nsw i32 %t73, 1
+  store i32 %t74, i32* %t1, !tbaa !3
+  %t75 = load i32, i32* %t3, !tbaa !3
+  %t76 = add nsw i32 %t75, 1
+  store i32 %t76, i32* %t3, !tbaa !3
+  %t77 = load i32, i32* %t1, !tbaa !3
+  %t78 = sub nsw i32 %high, %t77
+  %t79 = add nsw i32 %t78, 1
+  store i32 %t79, i32* %t8, !tbaa !3
+  br label %while.cond10
+while.end12:
+  %t80 = alloca i32
+  %t81 = sub nsw i32 %high, %low
+  %t82 = add nsw i32 %t81, 1
+  store i32 %t82, i32* %t80, !tbaa !3
+  %t83 = alloca i32
+  store i32 0, i32* %t83, !tbaa !3
+  br label %for.cond13
+for.cond13:
+  %t84 = load i32, i32* %t80, !tbaa !3
+  %t85 = load i32, i32* %t83, !tbaa !3
+  %t86 = sub nsw i32 %t84, %t85
+  %t87 = icmp ne i32 %t86, 0
+  br i1 %t87, label %for.body14, label %for.end16
+for.body14:
+  %t88 = getelementptr inbounds i32, i32* %values, i32 %low
+  %t89 = load i32, i32* %t83, !tbaa !3
+  %t90 = getelementptr inbounds i32, i32* %t88, i32 %t89
+  %t91 = getelementptr inbounds i32, i32* %temp, i32 %low
+  %t92 = load i32, i32* %t83, !tbaa !3
+  %t93 = getelementptr inbounds i32, i32* %t91, i32 %t92
+  %t94 = load i32, i32* %t93, !tbaa !3
+  store i32 %t94, i32* %t90, !tbaa !3
+  br label %for.inc15
+for.inc15:
+  %t95 = load i32, i32* %t83, !tbaa !3
+  %t96 = add nsw i32 %t95, 1
+  store i32 %t96, i32* %t83, !tbaa !3
+  br label %for.cond13
+for.end16:
+  ret i32 0
+}
+define noundef i32 @merge_sort(i32* noundef %values, i32* noundef %temp, i32 noundef %low, i32 noundef %high) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  %t2 = sub nsw i32 %high, %low
+  %t3 = icmp ne i32 %t2, 0
+  br i1 %t3, label %if.end1, label %if.then0
+if.then0:
+  ret i32 0
+if.end1:
+  %t4 = sub nsw i32 %high, %low
+  %t5 = ashr i32 %t4, 31
+  %t6 = lshr i32 %t5, 31
+  %t7 = add i32 %t4, %t6
+  %t8 = ashr i32 %t7, 1
+  %t9 = add nsw i32 %low, %t8
+  store i32 %t9, i32* %t0, !tbaa !3
+  %t10 = load i32, i32* %t0, !tbaa !3
+  %t11 = call i32 @merge_sort(i32* %values, i32* %temp, i32 %low, i32 %t10)
+  store i32 %t11, i32* %t1, !tbaa !3
+  %t12 = load i32, i32* %t0, !tbaa !3
+  %t13 = add nsw i32 %t12, 1
+  %t14 = call i32 @merge_sort(i32* %values, i32* %temp, i32 %t13, i32 %high)
+  store i32 %t14, i32* %t1, !tbaa !3
+  %t15 = load i32, i32* %t0, !tbaa !3
+  %t16 = call i32 @merge_into(i32* %values, i32* %temp, i32 %low, i32 %t15, i32 %high)
+  store i32 %t16, i32* %t1, !tbaa !3
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,76 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @fill_primes(i32* noundef %buffer, i32 noundef %max) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 2, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t2 = icmp ne i32 1, 0
+  br i1 %t2, label %while.body1, label %while.end2
+while.body1:
+  %t3 = load i32, i32* %t1, !tbaa !3
+  %t4 = sub nsw i32 %max, %t3
+  %t5 = add nsw i32 %t4, 1
+  %t6 = icmp ne i32 %t5, 0
+  br i1 %t6, label %if.end4, label %if.then3
+if.then3:
+  br label %while.end2
+if.end4:
+  %t7 = alloca i32
+  store i32 1, i32* %t7, !tbaa !3
+  %t8 = alloca i32
+  store i32 2, i32* %t8, !tbaa !3
+  br label %for.cond5
+for.cond5:
+  %t9 = load i32, i32* %t1, !tbaa !3
+  %t10 = load i32, i32* %t8, !tbaa !3
+  %t11 = sub nsw i32 %t9, %t10
+  %t12 = icmp ne i32 %t11, 0
+  br i1 %t12, label %for.body6, label %for.end8
+for.body6:
+  %t13 = load i32, i32* %t1, !tbaa !3
+  %t14 = load i32, i32* %t8, !tbaa !3
+  %t15 = srem i32 %t13, %t14
+  %t16 = icmp ne i32 %t15, 0
+  br i1 %t16, label %if.end10, label %if.then9
+if.then9:
+  store i32 0, i32* %t7, !tbaa !3
+  br label %if.end10
+if.end10:
+  br label %for.inc7
+for.inc7:
+  %t17 = load i32, i32* %t8, !tbaa !3
+  %t18 = add nsw i32 %t17, 1
+  store i32 %t18, i32* %t8, !tbaa !3
+  br label %for.cond5
+for.end8:
+  %t19 = load i32, i32* %t7, !tbaa !3
+  %t20 = icmp ne i32 %t19, 0
+  br i1 %t20, label %if.then11, label %if.end12
+if.then11:
+  %t21 = load i32, i32* %t0, !tbaa !3
+  %t22 = getelementptr inbounds i32, i32* %buffer, i32 %t21
+  %t23 = load i32, i32* %t1, !tbaa !3
+  store i32 %t23, i32* %t22, !tbaa !3
+  %t24 = load i32, i32* %t0, !tbaa !3
+  %t25 = add nsw i32 %t24, 1
+  store i32 %t25, i32* %t0, !tbaa !3
+  br label %if.end12
+if.end12:
+  %t26 = load i32, i32* %t1, !tbaa !3
+  %t27 = add nsw i32 %t26, 1
+  store i32 %t27, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.end2:
+  %t28 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t28
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
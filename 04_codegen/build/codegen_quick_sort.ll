@@ -0,0 +1,138 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @is_leq(i32 noundef %value, i32 noundef %pivot) {
+entry:
+  %t0 = icmp ne i32 %pivot, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = icmp ne i32 %value, 0
+  br i1 %t1, label %if.then2, label %if.end3
+if.then2:
+  ret i32 0
+if.end3:
+  ret i32 1
+}
+define noundef i32 @swap_values(i32* noundef %left, i32* noundef %right) {
+entry:
+  %t0 = alloca i32
+  %t1 = load i32, i32* %left, !tbaa !3
+  store i32 %t1, i32* %t0, !tbaa !3
+  %t2 = load i32, i32* %right, !tbaa !3
+  store i32 %t2, i32* %left, !tbaa !3
+  %t3 = load i32, i32* %t0, !tbaa !3
+  store i32 %t3, i32* %right, !tbaa !3
+  ret i32 0
+}
+define noundef i32 @partition(i32* noundef %values, i32 noundef %low, i32 noundef %high) {
+entry:
+  %t0 = alloca i32
+  %t1 = getelementptr inbounds i32, i32* %values, i32 %high
+  %t2 = load i32, i32* %t1, !tbaa !3
+  store i32 %t2, i32* %t0, !tbaa !3
+  %t3 = alloca i32
+  %t4 = sub nsw i32 %low, 1
+  store i32 %t4, i32* %t3, !tbaa !3
+  %t5 = alloca i32
+  store i32 %low, i32* %t5, !tbaa !3
+  %t6 = alloca i32
+  %t7 = sub nsw i32 %high, %low
+  store i32 %t7, i32* %t6, !tbaa !3
+  %t8 = alloca i32
+  store i32 0, i32* %t8, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t9 = load i32, i32* %t6, !tbaa !3
+  %t10 = icmp ne i32 %t9, 0
+  br i1 %t10, label %while.body1, label %while.end2
+while.body1:
+  %t11 = load i32, i32* %t5, !tbaa !3
+  %t12 = getelementptr inbounds i32, i32* %values, i32 %t11
+  %t13 = load i32, i32* %t12, !tbaa !3
+  %t14 = load i32, i32* %t0, !tbaa !3
+  %t15 = call i32 @is_leq(i32 %t13, i32 %t14)
+  %t16 = icmp ne i32 %t15, 0
+  br i1 %t16, label %if.then3, label %if.end4
+if.then3:
+  %t17 = load i32, i32* %t3, !tbaa !3
+  %t18 = add nsw i32 %t17, 1
+  store i32 %t18, i32* %t3, !tbaa !3
+  %t19 = load i32, i32* %t3, !tbaa !3
+  %t20 = getelementptr inbounds i32, i32* %values, i32 %t19
+  %t21 = load i32, i32* %t5, !tbaa !3
+  %t22 = getelementptr inbounds i32, i32* %values, i32 %t21
+  %t23 = call i32 @swap_values(i32* %t20, i32* %t22)
+  store i32 %t23, i32* %t8, !tbaa !3
+  br label %if.end4
+if.end4:
+  %t24 = load i32, i32* %t5, !tbaa !3
+  %t25 = add nsw i32 %t24, 1
+  store i32 %t25, i32* %t5, !tbaa !3
+  %t26 = load i32, i32* %t6, !tbaa !3
+  %t27 = sub nsw i32 %t26, 1
+  store i32 %t27, i32* %t6, !tbaa !3
+  br label %while.cond0
+while.end2:
+  %t28 = load i32, i32* %t3, !tbaa !3
+  %t29 = getelementptr inbounds i32, i32* %values, i32 %t28
+  %t30 = getelementptr inbounds i32, i32* %t29, i32 1
+  %t31 = getelementptr inbounds i32, i32* %values, i32 %high
+  %t32 = call i32 @swap_values(i32* %t30, i32* %t31)
+  store i32 %t32, i32* %t8, !tbaa !3
+  %t33 = load i32, i32* %t3, !tbaa !3
+  %t34 = add nsw i32 %t33, 1
+  ret i32 %t34
+}
+define noundef i32 @quick_sort(i32* noundef %values, i32 noundef %low, i32 noundef %high) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  %t2 = alloca i32
+  store i32 0, i32* %t2, !tbaa !3
+  %t3 = alloca i32
+  store i32 0, i32* %t3, !tbaa !3
+  %t4 = sub nsw i32 %high, %low
+  %t5 = icmp ne i32 %t4, 0
+  br i1 %t5, label %if.end1, label %if.then0
+if.then0:
+  ret i32 0
+if.end1:
+  %t6 = call i32 @partition(i32* %values, i32 %low, i32 %high)
+  store i32 %t6, i32* %t0, !tbaa !3
+  %t7 = load i32, i32* %t0, !tbaa !3
+  %t8 = sub nsw i32 %t7, %low
+  store i32 %t8, i32* %t1, !tbaa !3
+  %t9 = load i32, i32* %t1, !tbaa !3
+  %t10 = icmp ne i32 %t9, 0
+  br i1 %t10, label %if.then2, label %if.end3
+if.then2:
+  %t11 = load i32, i32* %t0, !tbaa !3
+  %t12 = sub nsw i32 %t11, 1
+  %t13 = call i32 @quick_sort(i32* %values, i32 %low, i32 %t12)
+  store i32 %t13, i32* %t3, !tbaa !3
+  br label %if.end3
+if.end3:
+  %t14 = load i32, i32* %t0, !tbaa !3
+  %t15 = sub nsw i32 %high, %t14
+  store i32 %t15, i32* %t2, !tbaa !3
+  %t16 = load i32, i32* %t2, !tbaa !3
+  %t17 = icmp ne i32 %t16, 0
+  br i1 %t17, label %if.then4, label %if.end5
+if.then4:
+  %t18 = load i32, i32* %t0, !tbaa !3
+  %t19 = add nsw i32 %t18, 1
+  %t20 = call i32 @quick_sort(i32* %values, i32 %t19, i32 %high)
+  store i32 %t20, i32* %t3, !tbaa !3
+  br label %if.end5
+if.end5:
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,56 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @reverse_string(i8* noundef %buffer, i32 noundef %length) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  %t2 = sub nsw i32 %length, 1
+  store i32 %t2, i32* %t1, !tbaa !3
+  %t3 = alloca i32
+  %t4 = ashr i32 %length, 31
+  %t5 = lshr i32 %t4, 31
+  %t6 = add i32 %length, %t5
+  %t7 = ashr i32 %t6, 1
+  store i32 %t7, i32* %t3, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t8 = load i32, i32* %t3, !tbaa !3
+  %t9 = icmp ne i32 %t8, 0
+  br i1 %t9, label %while.body1, label %while.end2
+while.body1:
+  %t10 = alloca i8
+  %t11 = load i32, i32* %t0, !tbaa !3
+  %t12 = getelementptr inbounds i8, i8* %buffer, i32 %t11
+  %t13 = load i8, i8* %t12, !tbaa !4
+  store i8 %t13, i8* %t10, !tbaa !4
+  %t14 = load i32, i32* %t0, !tbaa !3
+  %t15 = getelementptr inbounds i8, i8* %buffer, i32 %t14
+  %t16 = load i32, i32* %t1, !tbaa !3
+  %t17 = getelementptr inbounds i8, i8* %buffer, i32 %t16
+  %t18 = load i8, i8* %t17, !tbaa !4
+  store i8 %t18, i8* %t15, !tbaa !4
+  %t19 = load i32, i32* %t1, !tbaa !3
+  %t20 = getelementptr inbounds i8, i8* %buffer, i32 %t19
+  %t21 = load i8, i8* %t10, !tbaa !4
+  store i8 %t21, i8* %t20, !tbaa !4
+  %t22 = load i32, i32* %t0, !tbaa !3
+  %t23 = add nsw i32 %t22, 1
+  store i32 %t23, i32* %t0, !tbaa !3
+  %t24 = load i32, i32* %t1, !tbaa !3
+  %t25 = sub nsw i32 %t24, 1
+  store i32 %t25, i32* %t1, !tbaa !3
+  %t26 = load i32, i32* %t3, !tbaa !3
+  %t27 = sub nsw i32 %t26, 1
+  store i32 %t27, i32* %t3, !tbaa !3
+  br label %while.cond0
+while.end2:
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!1, !1, i64 0}
@@ -0,0 +1,128 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @sieve_primes(i32* noundef %buffer, i32 noundef %max) {
+entry:
+  %t0 = alloca [128 x i32]
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  %t2 = alloca i32
+  store i32 0, i32* %t2, !tbaa !3
+  store i32 0, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t3 = load i32, i32* %t1, !tbaa !3
+  %t4 = icmp sle i32 %t3, %max
+  br i1 %t4, label %for.body1, label %for.end3
+for.body1:
+  %t5 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t6 = load i32, i32* %t1, !tbaa !3
+  %t7 = getelementptr inbounds i32, i32* %t5, i32 %t6
+  store i32 1, i32* %t7, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t8 = load i32, i32* %t1, !tbaa !3
+  %t9 = add nsw i32 %t8, 1
+  store i32 %t9, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t10 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t11 = getelementptr inbounds i32, i32* %t10, i32 0
+  store i32 0, i32* %t11, !tbaa !3
+  %t12 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t13 = getelementptr inbounds i32, i32* %t12, i32 1
+  store i32 0, i32* %t13, !tbaa !3
+  %t14 = alloca i32
+  store i32 2, i32* %t14, !tbaa !3
+  br label %for.cond4
+for.cond4:
+  %t15 = load i32, i32* %t14, !tbaa !3
+  %t16 = load i32, i32* %t14, !tbaa !3
+  %t17 = mul nsw i32 %t15, %t16
+  %t18 = icmp sle i32 %t17, %max
+  br i1 %t18, label %for.body5, label %for.end7
+for.body5:
+  %t19 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t20 = load i32, i32* %t14, !tbaa !3
+  %t21 = getelementptr inbounds i32, i32* %t19, i32 %t20
+  %t22 = load i32, i32* %t21, !tbaa !3
+  %t23 = icmp ne i32 %t22, 0
+  br i1 %t23, label %if.then8, label %if.end9
+if.then8:
+  %t24 = alloca i32
+  %t25 = load i32, i32* %t14, !tbaa !3
+  %t26 = load i32, i32* %t14, !tbaa !3
+  %t27 = mul nsw i32 %t25, %t26
+  store i32 %t27, i32* %t24, !tbaa !3
+  br label %for.cond10
+for.cond10:
+  %t28 = load i32, i32* %t24, !tbaa !3
+  %t29 = icmp sle i32 %t28, %max
+  br i1 %t29, label %for.body11, label %for.end13
+for.body11:
+  %t30 = load i32, i32* %t24, !tbaa !3
+  %t31 = load i32, i32* %t14, !tbaa !3
+  %t32 = srem i32 %t30, %t31
+  %t33 = icmp ne i32 %t32, 0
+  br i1 %t33, label %if.end15, label %if.then14
+if.then14:
+  %t34 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t35 = load i32, i32* %t24, !tbaa !3
+  %t36 = getelementptr inbounds i32, i32* %t34, i32 %t35
+  store i32 0, i32* %t36, !tbaa !3
+  br label %if.end15
+if.end15:
+  br label %for.inc12
+for.inc12:
+  %t37 = load i32, i32* %t24, !tbaa !3
+  %t38 = add nsw i32 %t37, 1
+  store i32 %t38, i32* %t24, !tbaa !3
+  br label %for.cond10
+for.end13:
+  br label %if.end9
+if.end9:
+  br label %for.inc6
+for.inc6:
+  %t39 = load i32, i32* %t14, !tbaa !3
+  %t40 = add nsw i32 %t39, 1
+  store i32 %t40, i32* %t14, !tbaa !3
+  br label %for.cond4
+for.end7:
+  store i32 2, i32* %t1, !tbaa !3
+  br label %for.cond16
+for.cond16:
+  %t41 = load i32, i32* %t1, !tbaa !3
+  %t42 = icmp sle i32 %t41, %max
+  br i1 %t42, label %for.body17, label %for.end19
+for.body17:
+  %t43 = getelementptr inbounds [128 x i32], [128 x i32]* %t0, i32 0, i32 0
+  %t44 = load i32, i32* %t1, !tbaa !3
+  %t45 = getelementptr inbounds i32, i32* %t43, i32 %t44
+  %t46 = load i32, i32* %t45, !tbaa !3
+  %t47 = icmp ne i32 %t46, 0
+  br i1 %t47, label %if.then20, label %if.end21
+if.then20:
+  %t48 = load i32, i32* %t2, !tbaa !3
+  %t49 = getelementptr inbounds i32, i32* %buffer, i32 %t48
+  %t50 = load i32, i32* %t1, !tbaa !3
+  store i32 %t50, i32* %t49, !tbaa !3
+  %t51 = load i32, i32* %t2, !tbaa !3
+  %t52 = add nsw i32 %t51, 1
+  store i32 %t52, i32* %t2, !tbaa !3
+  br label %if.end21
+if.end21:
+  br label %for.inc18
+for.inc18:
+  %t53 = load i32, i32* %t1, !tbaa !3
+  %t54 = add nsw i32 %t53, 1
+  store i32 %t54, i32* %t1, !tbaa !3
+  br label %for.cond16
+for.end19:
+  %t55 = load i32, i32* %t2, !tbaa !3
+  ret i32 %t55
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
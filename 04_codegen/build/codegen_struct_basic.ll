@@ -0,0 +1,40 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Pair = type { i32, i32 }
+
+@g_pair = global %struct.Pair zeroinitializer
+define noundef i32 @struct_smoke() {
+entry:
+  %t0 = getelementptr inbounds %struct.Pair, %struct.Pair* @g_pair, i32 0, i32 0
+  store i32 10, i32* %t0, !tbaa !4
+  %t1 = getelementptr inbounds %struct.Pair, %struct.Pair* @g_pair, i32 0, i32 1
+  store i32 20, i32* %t1, !tbaa !5
+  %t2 = getelementptr inbounds %struct.Pair, %struct.Pair* @g_pair, i32 0, i32 0
+  %t3 = load i32, i32* %t2, !tbaa !4
+  %t4 = getelementptr inbounds %struct.Pair, %struct.Pair* @g_pair, i32 0, i32 1
+  %t5 = load i32, i32* %t4, !tbaa !5
+  %t6 = add nsw i32 %t3, %t5
+  ret i32 %t6
+}
+define noundef i32 @struct_set_and_get(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = alloca %struct.Pair
+  %t1 = getelementptr inbounds %struct.Pair, %struct.Pair* %t0, i32 0, i32 0
+  store i32 %a, i32* %t1, !tbaa !4
+  %t2 = getelementptr inbounds %struct.Pair, %struct.Pair* %t0, i32 0, i32 1
+  store i32 %b, i32* %t2, !tbaa !5
+  %t3 = getelementptr inbounds %struct.Pair, %struct.Pair* %t0, i32 0, i32 0
+  %t4 = load i32, i32* %t3, !tbaa !4
+  %t5 = getelementptr inbounds %struct.Pair, %struct.Pair* %t0, i32 0, i32 1
+  %t6 = load i32, i32* %t5, !tbaa !5
+  %t7 = mul nsw i32 %t4, %t6
+  ret i32 %t7
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!"Pair", !2, i64 0, !2, i64 4}
+!4 = !{!3, !2, i64 0}
+!5 = !{!3, !2, i64 4}
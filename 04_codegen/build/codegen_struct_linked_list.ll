@@ -0,0 +1,191 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Node = type { i32, %struct.Node* }
+
+@node_a = global %struct.Node zeroinitializer
+@node_b = global %struct.Node zeroinitializer
+@node_c = global %struct.Node zeroinitializer
+@node_d = global %struct.Node zeroinitializer
+@node_e = global %struct.Node zeroinitializer
+define noundef %struct.Node* @list_init() {
+entry:
+  %t0 = alloca %struct.Node*
+  store %struct.Node* @node_a, %struct.Node** %t0, !tbaa !3
+  %t1 = alloca %struct.Node*
+  store %struct.Node* @node_a, %struct.Node** %t1, !tbaa !3
+  %t2 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t3 = getelementptr inbounds %struct.Node, %struct.Node* %t2, i32 0, i32 0
+  store i32 1, i32* %t3, !tbaa !6
+  %t4 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t5 = getelementptr inbounds %struct.Node, %struct.Node* %t4, i32 0, i32 1
+  store %struct.Node* @node_b, %struct.Node** %t5, !tbaa !7
+  store %struct.Node* @node_b, %struct.Node** %t1, !tbaa !3
+  %t6 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t7 = getelementptr inbounds %struct.Node, %struct.Node* %t6, i32 0, i32 0
+  store i32 2, i32* %t7, !tbaa !6
+  %t8 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t9 = getelementptr inbounds %struct.Node, %struct.Node* %t8, i32 0, i32 1
+  store %struct.Node* @node_c, %struct.Node** %t9, !tbaa !7
+  store %struct.Node* @node_c, %struct.Node** %t1, !tbaa !3
+  %t10 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t11 = getelementptr inbounds %struct.Node, %struct.Node* %t10, i32 0, i32 0
+  store i32 3, i32* %t11, !tbaa !6
+  %t12 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t13 = getelementptr inbounds %struct.Node, %struct.Node* %t12, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t13, !tbaa !7
+  store %struct.Node* @node_d, %struct.Node** %t1, !tbaa !3
+  %t14 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t15 = getelementptr inbounds %struct.Node, %struct.Node* %t14, i32 0, i32 0
+  store i32 4, i32* %t15, !tbaa !6
+  %t16 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t17 = getelementptr inbounds %struct.Node, %struct.Node* %t16, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t17, !tbaa !7
+  store %struct.Node* @node_e, %struct.Node** %t1, !tbaa !3
+  %t18 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t19 = getelementptr inbounds %struct.Node, %struct.Node* %t18, i32 0, i32 0
+  store i32 5, i32* %t19, !tbaa !6
+  %t20 = load %struct.Node*, %struct.Node** %t1, !tbaa !3
+  %t21 = getelementptr inbounds %struct.Node, %struct.Node* %t20, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t21, !tbaa !7
+  %t22 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  ret %struct.Node* %t22
+}
+define noundef %struct.Node* @list_push_front(%struct.Node* noundef %head, %struct.Node* noundef %node) {
+entry:
+  %t0 = getelementptr inbounds %struct.Node, %struct.Node* %node, i32 0, i32 1
+  store %struct.Node* %head, %struct.Node** %t0, !tbaa !7
+  ret %struct.Node* %node
+}
+define noundef %struct.Node* @list_insert_after(%struct.Node* noundef %pos, %struct.Node* noundef %node) {
+entry:
+  %t0 = getelementptr inbounds %struct.Node, %struct.Node* %node, i32 0, i32 1
+  %t1 = getelementptr inbounds %struct.Node, %struct.Node* %pos, i32 0, i32 1
+  %t2 = load %struct.Node*, %struct.Node** %t1, !tbaa !7
+  store %struct.Node* %t2, %struct.Node** %t0, !tbaa !7
+  %t3 = getelementptr inbounds %struct.Node, %struct.Node* %pos, i32 0, i32 1
+  store %struct.Node* %node, %struct.Node** %t3, !tbaa !7
+  ret %struct.Node* %node
+}
+define noundef %struct.Node* @list_remove_after(%struct.Node* noundef %pos) {
+entry:
+  %t0 = alloca %struct.Node*
+  %t1 = getelementptr inbounds %struct.Node, %struct.Node* %pos, i32 0, i32 1
+  %t2 = load %struct.Node*, %struct.Node** %t1, !tbaa !7
+  store %struct.Node* %t2, %struct.Node** %t0, !tbaa !3
+  %t3 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t4 = icmp ne %struct.Node* %t3, null
+  br i1 %t4, label %if.end1, label %if.then0
+if.then0:
+  ret %struct.Node* null
+if.end1:
+  %t5 = getelementptr inbounds %struct.Node, %struct.Node* %pos, i32 0, i32 1
+  %t6 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t7 = getelementptr inbounds %struct.Node, %struct.Node* %t6, i32 0, i32 1
+  %t8 = load %struct.Node*, %struct.Node** %t7, !tbaa !7
+  store %struct.Node* %t8, %struct.Node** %t5, !tbaa !7
+  %t9 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t10 = getelementptr inbounds %struct.Node, %struct.Node* %t9, i32 0, i32 1
+  store %struct.Node* null, %struct.Node** %t10, !tbaa !7
+  %t11 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  ret %struct.Node* %t11
+}
+define noundef %struct.Node* @list_find(%struct.Node* noundef %head, i32 noundef %value) {
+entry:
+  %t0 = alloca %struct.Node*
+  store %struct.Node* %head, %struct.Node** %t0, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t1 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t2 = icmp ne %struct.Node* %t1, null
+  br i1 %t2, label %while.body1, label %while.end2
+while.body1:
+  %t3 = alloca i32
+  %t4 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t5 = getelementptr inbounds %struct.Node, %struct.Node* %t4, i32 0, i32 0
+  %t6 = load i32, i32* %t5, !tbaa !6
+  %t7 = sub nsw i32 %t6, %value
+  store i32 %t7, i32* %t3, !tbaa !8
+  %t8 = load i32, i32* %t3, !tbaa !8
+  %t9 = icmp ne i32 %t8, 0
+  br i1 %t9, label %if.end4, label %if.then3
+if.then3:
+  %t10 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  ret %struct.Node* %t10
+if.end4:
+  %t11 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t12 = getelementptr inbounds %struct.Node, %struct.Node* %t11, i32 0, i32 1
+  %t13 = load %struct.Node*, %struct.Node** %t12, !tbaa !7
+  store %struct.Node* %t13, %struct.Node** %t0, !tbaa !3
+  br label %while.cond0
+while.end2:
+  ret %struct.Node* null
+}
+define noundef i32 @list_smoke() {
+entry:
+  %t0 = alloca %struct.Node*
+  %t1 = call %struct.Node* @list_init()
+  store %struct.Node* %t1, %struct.Node** %t0, !tbaa !3
+  %t2 = alloca %struct.Node*
+  store %struct.Node* null, %struct.Node** %t2, !tbaa !3
+  %t3 = alloca %struct.Node*
+  store %struct.Node* null, %struct.Node** %t3, !tbaa !3
+  %t4 = alloca %struct.Node*
+  store %struct.Node* null, %struct.Node** %t4, !tbaa !3
+  %t5 = alloca i32
+  store i32 0, i32* %t5, !tbaa !8
+  %t6 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t7 = call %struct.Node* @list_push_front(%struct.Node* %t6, %struct.Node* @node_e)
+  store %struct.Node* %t7, %struct.Node** %t0, !tbaa !3
+  %t8 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t9 = call %struct.Node* @list_insert_after(%struct.Node* %t8, %struct.Node* @node_d)
+  store %struct.Node* %t9, %struct.Node** %t2, !tbaa !3
+  %t10 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t11 = call %struct.Node* @list_remove_after(%struct.Node* %t10)
+  store %struct.Node* %t11, %struct.Node** %t3, !tbaa !3
+  %t12 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t13 = call %struct.Node* @list_find(%struct.Node* %t12, i32 2)
+  store %struct.Node* %t13, %struct.Node** %t4, !tbaa !3
+  %t14 = load i32, i32* %t5, !tbaa !8
+  %t15 = load %struct.Node*, %struct.Node** %t0, !tbaa !3
+  %t16 = getelementptr inbounds %struct.Node, %struct.Node* %t15, i32 0, i32 0
+  %t17 = load i32, i32* %t16, !tbaa !6
+  %t18 = add nsw i32 %t14, %t17
+  store i32 %t18, i32* %t5, !tbaa !8
+  %t19 = load %struct.Node*, %struct.Node** %t3, !tbaa !3
+  %t20 = icmp ne %struct.Node* %t19, null
+  br i1 %t20, label %if.then0, label %if.end1
+if.then0:
+  %t21 = load i32, i32* %t5, !tbaa !8
+  %t22 = load %struct.Node*, %struct.Node** %t3, !tbaa !3
+  %t23 = getelementptr inbounds %struct.Node, %struct.Node* %t22, i32 0, i32 0
+  %t24 = load i32, i32* %t23, !tbaa !6
+  %t25 = add nsw i32 %t21, %t24
+  store i32 %t25, i32* %t5, !tbaa !8
+  br label %if.end1
+if.end1:
+  %t26 = load %struct.Node*, %struct.Node** %t4, !tbaa !3
+  %t27 = icmp ne %struct.Node* %t26, null
+  br i1 %t27, label %if.then2, label %if.end3
+if.then2:
+  %t28 = load i32, i32* %t5, !tbaa !8
+  %t29 = load %struct.Node*, %struct.Node** %t4, !tbaa !3
+  %t30 = getelementptr inbounds %struct.Node, %struct.Node* %t29, i32 0, i32 0
+  %t31 = load i32, i32* %t30, !tbaa !6
+  %t32 = add nsw i32 %t28, %t31
+  store i32 %t32, i32* %t5, !tbaa !8
+  br label %if.end3
+if.end3:
+  %t33 = load i32, i32* %t5, !tbaa !8
+  ret i32 %t33
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"any pointer", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"int", !1, i64 0}
+!5 = !{!"Node", !4, i64 0, !2, i64 8}
+!6 = !{!5, !4, i64 0}
+!7 = !{!5, !2, i64 8}
+!8 = !{!4, !4, i64 0}
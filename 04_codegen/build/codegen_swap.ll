@@ -0,0 +1,19 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @swap(i32* noundef %left, i32* noundef %right) {
+entry:
+  %t0 = alloca i32
+  %t1 = load i32, i32* %left, !tbaa !3
+  store i32 %t1, i32* %t0, !tbaa !3
+  %t2 = load i32, i32* %right, !tbaa !3
+  store i32 %t2, i32* %left, !tbaa !3
+  %t3 = load i32, i32* %t0, !tbaa !3
+  store i32 %t3, i32* %right, !tbaa !3
+  ret i32 0
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -2,16 +2,93 @@
 #define BASECC_CODEGEN_H
 
 #include "checker.h"
+#include "ir_vm.h"
+
+typedef enum CodegenTarget {
+  /* LLVM textual IR for clang/llc. */
+  CODEGEN_TARGET_LLVM,
+  /* The BaseCC IR dump, after any requested passes. */
+  CODEGEN_TARGET_IR,
+  /* x86-64 System V GNU assembler text for `as`. */
+  CODEGEN_TARGET_X86_64_ASM,
+  /* The same code encoded into a relocatable ELF64 object. */
+  CODEGEN_TARGET_X86_64_OBJ,
+  /* A bytecode image for the BaseCC VM (ir_vm.h). */
+  CODEGEN_TARGET_BYTECODE,
+  /* C source embedding the image, with native entry points per function. */
+  CODEGEN_TARGET_BYTECODE_C
+} CodegenTarget;
+
+typedef struct CodegenOptions {
+  /* Attach nsw, inbounds, and noundef where C semantics allow. */
+  int poison_flags;
+  /*
+   * Use fastcc for internal functions and drop unreferenced ones, mark
+   * definitions dso_local/unnamed_addr, and emit const data as constant.
+   */
+  int optimize_linkage;
+  /*
+   * The output may go into a shared object (-fPIC), where another module
+   * can interpose an external definition, so none of them is dso_local.
+   */
+  int pic;
+  /*
+   * Attach TBAA metadata to LLVM loads and stores, relying on C's rule
+   * that an object is only accessed through its own type or char.
+   */
+  int strict_aliasing;
+  CodegenTarget target;
+  /* Comma-separated BaseCC IR passes to run before emitting, or NULL. */
+  const char *passes;
+  /* The inline pass's threshold (IrPassOptions::inline_threshold). */
+  int inline_threshold;
+  /* When set, each pass's name and rewrite count is written here. */
+  FILE *pass_stats;
+  /* The x86-64 targets: allocate registers instead of all-spill. */
+  int allocate_registers;
+  /* The bytecode targets: fuse common sequences into superinstructions. */
+  int superinstructions;
+  /*
+   * Count blocks and branches as the program runs and write them to a
+   * profile at exit (ir_profile.h); link with ir_profile_runtime.c.
+   */
+  int profile_generate;
+  /*
+   * Call the runtime on entry to and return from every function, which
+   * reports calls and inclusive time per function at exit; link with
+   * ir_profile_runtime.c as well.
+   */
+  int instrument_functions;
+  /*
+   * A profile from an instrumented build of the same source, or NULL. It
+   * adds branch weights and entry counts to LLVM output and lays out the
+   * x86-64 targets' blocks along the hot paths.
+   */
+  const char *profile_use;
+  /*
+   * Record each statement's line and column, for DWARF line tables: !dbg
+   * locations in LLVM output, and .loc directives or a .debug_line section
+   * on the x86-64 targets. source_name is the file they refer to.
+   */
+  int debug_info;
+  const char *source_name;
+} CodegenOptions;
 
 typedef struct Codegen {
   const char *input;
+  /* Positions of the input's tokens for debug info; built on first use. */
+  LineTable lines;
+  CodegenOptions options;
   Checker checker;
   Parser parser;
   const char *error_message;
 } Codegen;
 
+void codegen_options_init(CodegenOptions *options);
 void codegen_init(Codegen *codegen, const char *input);
 int codegen_emit(Codegen *codegen, const char *output_path);
+/* Lowers the input straight to bytecode in memory, for running in-process. */
+int codegen_compile_bytecode(Codegen *codegen, IrVmProgram *program);
 const char *codegen_error(const Codegen *codegen);
 
 #endif
@@ -0,0 +1,425 @@
+#ifndef BASECC_IR_H
+#define BASECC_IR_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * BaseCC IR: a typed three-address SSA form that sits between the AST and
+ * the backends. A module owns every type, value, block, and instruction it
+ * creates; nothing is freed individually, ir_module_free releases it all.
+ */
+
+typedef enum IrTypeKind {
+  IR_TYPE_VOID,
+  IR_TYPE_INT,
+  IR_TYPE_POINTER,
+  IR_TYPE_ARRAY,
+  IR_TYPE_STRUCT
+} IrTypeKind;
+
+typedef struct IrType {
+  IrTypeKind kind;
+  /* IR_TYPE_INT: 1, 8, 16, 32, or 64. */
+  int bits;
+  /* IR_TYPE_POINTER and IR_TYPE_ARRAY. */
+  struct IrType *element;
+  /* IR_TYPE_ARRAY. */
+  size_t length;
+  /* IR_TYPE_STRUCT: C tag, fields once the body is set. */
+  char *name;
+  struct IrType **fields;
+  size_t field_count;
+  int has_body;
+  struct IrType *pointer;
+  struct IrType *next;
+} IrType;
+
+typedef enum IrValueKind {
+  IR_VALUE_CONST_INT,
+  IR_VALUE_NULL,
+  IR_VALUE_ZERO,
+  IR_VALUE_AGGREGATE,
+  IR_VALUE_GLOBAL,
+  IR_VALUE_FUNCTION,
+  IR_VALUE_PARAM,
+  IR_VALUE_INSTR
+} IrValueKind;
+
+typedef struct IrValue {
+  IrValueKind kind;
+  IrType *type;
+  /* IR_VALUE_CONST_INT, sign-extended from the type width. */
+  long long constant;
+  /*
+   * IR_VALUE_AGGREGATE: one constant per array element or struct field.
+   * Global initializers only.
+   */
+  struct IrValue **elements;
+  size_t element_count;
+  /* Back pointer to the object embedding this value, by kind. */
+  struct IrGlobal *global;
+  struct IrFunction *function;
+  struct IrParam *param;
+  struct IrInstr *instr;
+  /* Number of instruction operands referring to this value. */
+  size_t use_count;
+} IrValue;
+
+typedef enum IrOpcode {
+  IR_OP_ALLOCA,
+  IR_OP_LOAD,
+  IR_OP_STORE,
+  IR_OP_GEP,
+  IR_OP_ADD,
+  IR_OP_SUB,
+  IR_OP_MUL,
+  IR_OP_SDIV,
+  IR_OP_SREM,
+  IR_OP_SHL,
+  IR_OP_ASHR,
+  IR_OP_LSHR,
+  IR_OP_AND,
+  IR_OP_OR,
+  IR_OP_XOR,
+  IR_OP_ICMP,
+  IR_OP_SEXT,
+  IR_OP_ZEXT,
+  IR_OP_TRUNC,
+  IR_OP_PTRTOINT,
+  IR_OP_INTTOPTR,
+  IR_OP_BITCAST,
+  IR_OP_CALL,
+  IR_OP_MEMSET,
+  IR_OP_MEMCPY,
+  IR_OP_PHI,
+  IR_OP_BR,
+  IR_OP_CONDBR,
+  IR_OP_SWITCH,
+  IR_OP_RET
+} IrOpcode;
+
+typedef enum IrPredicate {
+  IR_PRED_EQ,
+  IR_PRED_NE,
+  IR_PRED_SLT,
+  IR_PRED_SLE,
+  IR_PRED_SGT,
+  IR_PRED_SGE,
+  IR_PRED_ULT,
+  IR_PRED_ULE,
+  IR_PRED_UGT,
+  IR_PRED_UGE
+} IrPredicate;
+
+typedef enum IrLinkage { IR_LINKAGE_EXTERNAL, IR_LINKAGE_INTERNAL } IrLinkage;
+
+typedef enum IrUnnamedAddr {
+  IR_UNNAMED_ADDR_NONE,
+  IR_UNNAMED_ADDR_LOCAL,
+  IR_UNNAMED_ADDR_GLOBAL
+} IrUnnamedAddr;
+
+typedef enum IrCallingConv { IR_CC_C, IR_CC_FAST } IrCallingConv;
+
+/* Signed overflow is poison (add, sub, mul, shl). */
+#define IR_FLAG_NSW 0x1u
+/* The address stays inside the base object (getelementptr). */
+#define IR_FLAG_INBOUNDS 0x2u
+/* The callee does not touch the caller's allocas (call). */
+#define IR_FLAG_TAIL 0x4u
+/*
+ * As IR_FLAG_TAIL, and the callee has the caller's signature and the call
+ * is returned right away, so it must reuse the caller's frame (call).
+ */
+#define IR_FLAG_MUSTTAIL 0x8u
+
+/* A source position for debug info; line 0 means none. */
+typedef struct IrDebugLoc {
+  unsigned line;
+  unsigned column;
+} IrDebugLoc;
+
+typedef struct IrInstr {
+  IrValue value;
+  IrOpcode opcode;
+  unsigned flags;
+  IrPredicate predicate;
+  /* IR_OP_ALLOCA: allocated type. IR_OP_GEP: source element type. */
+  IrType *aux_type;
+  IrCallingConv calling_conv;
+  /*
+   * Value operands. IR_OP_CALL keeps the callee first, IR_OP_STORE the
+   * stored value first, IR_OP_MEMSET the destination, byte, and length,
+   * IR_OP_MEMCPY the destination, source, and length, IR_OP_PHI one value
+   * per incoming block, and IR_OP_SWITCH the condition and then one
+   * constant per case.
+   */
+  IrValue **operands;
+  size_t operand_count;
+  size_t operand_capacity;
+  /*
+   * Branch targets, or the incoming blocks of a phi. IR_OP_SWITCH has its
+   * default first and then the target of each case.
+   */
+  struct IrBlock **blocks;
+  size_t block_count;
+  size_t block_capacity;
+  /*
+   * IR_OP_CONDBR: how often each edge was taken, from a profile
+   * (ir_profile.h).
+   */
+  int has_branch_weights;
+  unsigned long long branch_weights[2];
+  IrDebugLoc loc;
+  /* Printed as %t<id>; unique within the function. */
+  int id;
+  struct IrBlock *parent;
+  struct IrInstr *prev;
+  struct IrInstr *next;
+} IrInstr;
+
+typedef struct IrBlock {
+  char *name;
+  /* Position in the function, refreshed by ir_function_build_cfg. */
+  size_t index;
+  IrInstr *first;
+  IrInstr *last;
+  struct IrFunction *parent;
+  struct IrBlock *prev;
+  struct IrBlock *next;
+  int attached;
+  /* Filled in by ir_function_build_cfg. */
+  struct IrBlock **preds;
+  size_t pred_count;
+  size_t pred_capacity;
+  int reachable;
+  /* Filled in by ir_function_compute_dominators; NULL for the entry. */
+  struct IrBlock *idom;
+  size_t rpo_index;
+  /* Filled in by ir_function_compute_loop_depth; 0 outside any loop. */
+  size_t loop_depth;
+  /* Times the block ran, from a profile; unknown for blocks made since. */
+  int has_profile_count;
+  unsigned long long profile_count;
+} IrBlock;
+
+typedef struct IrParam {
+  IrValue value;
+  char *name;
+  size_t index;
+  int noundef;
+  /* Inferred by the functionattrs pass for pointer parameters. */
+  int nocapture;
+  int readonly;
+} IrParam;
+
+/* What a function may do to memory other than its own stack frame. */
+typedef enum IrMemoryEffect {
+  IR_MEMORY_READWRITE,
+  IR_MEMORY_READONLY,
+  IR_MEMORY_READNONE
+} IrMemoryEffect;
+
+typedef struct IrFunction {
+  IrValue value;
+  char *name;
+  IrType *return_type;
+  int return_noundef;
+  IrParam **params;
+  size_t param_count;
+  size_t param_capacity;
+  IrLinkage linkage;
+  int dso_local;
+  IrUnnamedAddr unnamed_addr;
+  IrCallingConv calling_conv;
+  IrBlock *first_block;
+  IrBlock *last_block;
+  size_t block_count;
+  int next_value_id;
+  struct IrModule *module;
+  /* Times the function was called, from a profile. */
+  int has_entry_count;
+  unsigned long long entry_count;
+  /* Inferred by the functionattrs pass; all unknown until it runs. */
+  int nounwind;
+  int willreturn;
+  int norecurse;
+  IrMemoryEffect memory;
+  /* Memory it touches is only what its pointer parameters point to. */
+  int argmemonly;
+  /* The line of its definition, for debug info. */
+  unsigned line;
+} IrFunction;
+
+typedef struct IrGlobal {
+  IrValue value;
+  char *name;
+  IrType *value_type;
+  IrValue *initializer;
+  IrLinkage linkage;
+  int dso_local;
+  IrUnnamedAddr unnamed_addr;
+  int is_constant;
+  /* Function-scope statics are printed just ahead of their function. */
+  IrFunction *owner;
+} IrGlobal;
+
+typedef enum IrSymbolKind { IR_SYMBOL_GLOBAL, IR_SYMBOL_FUNCTION } IrSymbolKind;
+
+typedef struct IrSymbol {
+  IrSymbolKind kind;
+  IrGlobal *global;
+  IrFunction *function;
+} IrSymbol;
+
+typedef struct IrModule {
+  char *name;
+  IrType *types;
+  IrType **structs;
+  size_t struct_count;
+  size_t struct_capacity;
+  /* Globals and functions in definition order. */
+  IrSymbol *symbols;
+  size_t symbol_count;
+  size_t symbol_capacity;
+  struct IrAllocation *allocations;
+  int out_of_memory;
+  /*
+   * The file the instructions' debug locations refer to, and the
+   * directory it was compiled in; NULL for a module without debug info.
+   */
+  char *source_file;
+  char *source_directory;
+} IrModule;
+
+typedef struct IrBuilder {
+  IrModule *module;
+  IrFunction *function;
+  IrBlock *block;
+  /* Given to every instruction built. */
+  IrDebugLoc loc;
+} IrBuilder;
+
+IrModule *ir_module_create(const char *name);
+void ir_module_free(IrModule *module);
+/* Turns on debug info: splits path into its file and directory. */
+int ir_module_set_source(IrModule *module, const char *path);
+
+IrType *ir_type_void(IrModule *module);
+IrType *ir_type_int(IrModule *module, int bits);
+IrType *ir_type_pointer(IrModule *module, IrType *element);
+IrType *ir_type_array(IrModule *module, IrType *element, size_t length);
+IrType *ir_type_struct(IrModule *module, const char *name, size_t length);
+int ir_type_struct_set_body(IrModule *module, IrType *type, IrType **fields,
+                            size_t field_count);
+int ir_type_is_int(const IrType *type, int bits);
+size_t ir_type_size(const IrType *type);
+size_t ir_type_align(const IrType *type);
+size_t ir_type_field_offset(const IrType *type, size_t index);
+
+IrValue *ir_const_int(IrModule *module, IrType *type, long long constant);
+IrValue *ir_const_null(IrModule *module, IrType *pointer_type);
+IrValue *ir_const_zero(IrModule *module, IrType *type);
+/*
+ * An array or struct constant from one constant per element or field,
+ * copied. Folds to zeroinitializer when every element is zero.
+ */
+IrValue *ir_const_aggregate(IrModule *module, IrType *type,
+                            IrValue **elements, size_t element_count);
+/* Whether value is zero, null, or an aggregate of nothing else. */
+int ir_value_is_zero(const IrValue *value);
+int ir_value_is_const_int(const IrValue *value, long long *constant);
+
+IrGlobal *ir_module_add_global(IrModule *module, const char *name,
+                               size_t length, IrType *value_type);
+IrGlobal *ir_module_find_global(const IrModule *module, const char *name,
+                                size_t length);
+IrFunction *ir_module_add_function(IrModule *module, const char *name,
+                                   size_t length, IrType *return_type);
+IrFunction *ir_module_find_function(const IrModule *module, const char *name,
+                                    size_t length);
+IrParam *ir_function_add_param(IrFunction *function, IrType *type,
+                               const char *name, size_t length);
+int ir_function_is_declaration(const IrFunction *function);
+
+IrBlock *ir_block_create(IrFunction *function, const char *name);
+/* Attaches a new block right after another rather than at the end. */
+void ir_block_insert_after(IrBlock *block, IrBlock *after);
+/*
+ * Moves instr and everything after it into a new block right after its
+ * own, which takes over the successors' phi edges. The old block is left
+ * without a terminator.
+ */
+IrBlock *ir_block_split(IrInstr *instr, const char *name);
+void ir_block_remove(IrBlock *block);
+IrInstr *ir_block_terminator(const IrBlock *block);
+size_t ir_block_successor_count(const IrBlock *block);
+IrBlock *ir_block_successor(const IrBlock *block, size_t index);
+
+int ir_instr_has_result(const IrInstr *instr);
+int ir_instr_is_terminator(const IrInstr *instr);
+int ir_instr_has_side_effects(const IrInstr *instr);
+void ir_instr_set_operand(IrInstr *instr, size_t index, IrValue *value);
+void ir_instr_remove(IrInstr *instr);
+/* Unlinks instr and puts it ahead of before, possibly in another block. */
+void ir_instr_move_before(IrInstr *instr, IrInstr *before);
+int ir_phi_add_incoming(IrInstr *phi, IrValue *value, IrBlock *block);
+/* Drops the incoming edge of a phi that comes from the given block. */
+void ir_phi_remove_incoming(IrInstr *phi, const IrBlock *block);
+void ir_replace_all_uses(IrFunction *function, IrValue *from, IrValue *to);
+
+void ir_builder_init(IrBuilder *builder, IrFunction *function);
+void ir_builder_set_block(IrBuilder *builder, IrBlock *block);
+IrValue *ir_build_alloca(IrBuilder *builder, IrType *type);
+IrValue *ir_build_load(IrBuilder *builder, IrValue *pointer);
+IrValue *ir_build_store(IrBuilder *builder, IrValue *value, IrValue *pointer);
+IrValue *ir_build_gep(IrBuilder *builder, unsigned flags, IrType *source,
+                      IrValue *base, IrValue **indices, size_t index_count);
+IrValue *ir_build_binary(IrBuilder *builder, IrOpcode opcode, unsigned flags,
+                         IrValue *left, IrValue *right);
+IrValue *ir_build_icmp(IrBuilder *builder, IrPredicate predicate,
+                       IrValue *left, IrValue *right);
+IrValue *ir_build_cast(IrBuilder *builder, IrOpcode opcode, IrValue *value,
+                       IrType *type);
+IrValue *ir_build_call(IrBuilder *builder, IrFunction *callee, IrValue **args,
+                       size_t arg_count);
+/*
+ * Sets length bytes at an i8* to an i8 value, or copies them from another
+ * i8* they do not overlap. length is an i64.
+ */
+IrValue *ir_build_memset(IrBuilder *builder, IrValue *pointer, IrValue *value,
+                         IrValue *length);
+IrValue *ir_build_memcpy(IrBuilder *builder, IrValue *destination,
+                         IrValue *source, IrValue *length);
+/*
+ * Appends a copy of instr with the same attributes, operands, and targets.
+ * The copy takes the builder's debug location.
+ */
+IrValue *ir_build_clone(IrBuilder *builder, const IrInstr *instr);
+IrValue *ir_build_phi(IrBuilder *builder, IrType *type);
+IrValue *ir_build_br(IrBuilder *builder, IrBlock *target);
+IrValue *ir_build_condbr(IrBuilder *builder, IrValue *condition,
+                         IrBlock *true_block, IrBlock *false_block);
+/* A switch with no cases yet; ir_switch_add_case adds them. */
+IrValue *ir_build_switch(IrBuilder *builder, IrValue *condition,
+                         IrBlock *default_block);
+int ir_switch_add_case(IrInstr *instr, IrValue *constant, IrBlock *block);
+IrValue *ir_build_ret(IrBuilder *builder, IrValue *value);
+
+int ir_function_build_cfg(IrFunction *function);
+int ir_function_compute_dominators(IrFunction *function);
+int ir_block_dominates(const IrBlock *dominator, const IrBlock *block);
+int ir_function_compute_loop_depth(IrFunction *function);
+
+int ir_verify_function(IrFunction *function, const char **message);
+int ir_verify_module(IrModule *module, const char **message);
+
+const char *ir_opcode_name(IrOpcode opcode);
+const char *ir_predicate_name(IrPredicate predicate);
+void ir_dump_type(const IrType *type, FILE *out);
+void ir_dump_function_attrs(const IrFunction *function, FILE *out);
+void ir_dump_function(const IrFunction *function, FILE *out);
+void ir_dump_module(const IrModule *module, FILE *out);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BASECC_IR_ALIAS_H
+#define BASECC_IR_ALIAS_H
+
+#include "ir.h"
+
+#include <stddef.h>
+
+/*
+ * What a function's loads, stores, and calls may touch. Addresses are
+ * traced back through GEPs and bitcasts to the alloca, global, parameter,
+ * or other pointer they are based on. Distinct allocas and globals never
+ * overlap, an alloca whose address never escapes is reached only through
+ * addresses computed from it, and two accesses at constant offsets from
+ * the same base overlap only when their byte ranges do.
+ */
+
+typedef struct IrAliasInfo {
+  /*
+   * By instruction id: the allocas whose address goes anywhere but the
+   * address operands of a load, store, GEP, memset, or memcpy, a bitcast,
+   * or a compare.
+   */
+  char *escaped;
+  size_t id_count;
+} IrAliasInfo;
+
+int ir_alias_info_compute(const IrFunction *function, IrAliasInfo *info);
+void ir_alias_info_free(IrAliasInfo *info);
+
+/* The alloca, global, parameter, or other pointer address is based on. */
+const IrValue *ir_alias_root(const IrValue *address);
+/* An alloca whose address never leaves the function's loads and stores. */
+int ir_alias_is_private(const IrAliasInfo *info, const IrValue *root);
+
+/*
+ * Whether size bytes at left may overlap size bytes at right. A size of 0
+ * stands for an extent that is not known.
+ */
+int ir_alias_may_alias(const IrAliasInfo *info, const IrValue *left,
+                       size_t left_size, const IrValue *right,
+                       size_t right_size);
+/* Whether the size bytes at address lie within the bytes at cover. */
+int ir_alias_covers(const IrValue *cover, size_t cover_size,
+                    const IrValue *address, size_t size);
+
+/* What a call may do to the memory at address, by the callee's attributes. */
+int ir_alias_call_may_read(const IrAliasInfo *info, const IrInstr *call,
+                           const IrValue *address);
+int ir_alias_call_may_write(const IrAliasInfo *info, const IrInstr *call,
+                            const IrValue *address);
+
+/* Bytes a load reads or a store writes. */
+size_t ir_alias_access_size(const IrInstr *instr);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef BASECC_IR_BYTECODE_H
+#define BASECC_IR_BYTECODE_H
+
+#include "ir.h"
+#include "ir_vm.h"
+
+typedef struct IrBytecodeOptions {
+  /*
+   * Fuse the instruction sequences that dominate the integration programs'
+   * dispatch profiles into single superinstructions.
+   */
+  int superinstructions;
+} IrBytecodeOptions;
+
+void ir_bytecode_options_init(IrBytecodeOptions *options);
+
+/*
+ * Lowers a module to VM bytecode. Every parameter and result gets its own
+ * register, numbered as in ir_regalloc_slot; constants, globals, and
+ * native function addresses live in a per-function constant block, and
+ * phis become moves on the incoming edges. Refreshes the CFG of each
+ * function.
+ */
+int ir_bytecode_compile(IrModule *module, const IrBytecodeOptions *options,
+                        IrVmProgram *program, const char **message);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef BASECC_IR_CALLGRAPH_H
+#define BASECC_IR_CALLGRAPH_H
+
+#include "ir.h"
+
+#include <stddef.h>
+
+/*
+ * The module's defined functions and the strongly connected components of
+ * their direct calls, found with Tarjan's algorithm. Calls to declarations
+ * are not edges.
+ */
+typedef struct IrCallGraph {
+  IrFunction **functions;
+  size_t count;
+  /* Tarjan's visit order (0 while unvisited) and low links. */
+  size_t *order;
+  size_t *low;
+  size_t next_order;
+  size_t *stack;
+  size_t stack_count;
+  char *on_stack;
+  size_t *component;
+  size_t component_count;
+  /* Functions as their components complete, so callees come first. */
+  size_t *postorder;
+  size_t postorder_count;
+} IrCallGraph;
+
+int ir_call_graph_build(IrCallGraph *graph, IrModule *module);
+void ir_call_graph_free(IrCallGraph *graph);
+
+/* The defined function a call instruction calls, or NULL. */
+IrFunction *ir_call_graph_callee(const IrInstr *instr);
+
+/* The index of a defined function in graph->functions. */
+size_t ir_call_graph_node(const IrCallGraph *graph,
+                          const IrFunction *function);
+
+#endif
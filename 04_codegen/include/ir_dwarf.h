@@ -0,0 +1,46 @@
+#ifndef BASECC_IR_DWARF_H
+#define BASECC_IR_DWARF_H
+
+#include "ir.h"
+#include "ir_elf.h"
+
+#include <stddef.h>
+
+/*
+ * DWARF 4 line tables for objects the x86-64 backend encodes itself: one
+ * compile unit covering .text, with a .debug_line program mapping .text
+ * offsets to the source lines and columns of IrDebugLoc. No types or
+ * variables are described, which is enough for debuggers to set line
+ * breakpoints and for profilers to attribute samples to source lines.
+ */
+
+typedef struct IrDwarfRow {
+  size_t address;
+  IrDebugLoc loc;
+} IrDwarfRow;
+
+typedef struct IrDwarfLines {
+  /* In increasing address order. */
+  IrDwarfRow *rows;
+  size_t row_count;
+  size_t row_capacity;
+  int out_of_memory;
+} IrDwarfLines;
+
+void ir_dwarf_lines_init(IrDwarfLines *lines);
+void ir_dwarf_lines_free(IrDwarfLines *lines);
+/*
+ * Code from address on belongs to loc. A row at the same address as the
+ * last one replaces it, since no code was emitted in between.
+ */
+void ir_dwarf_add_row(IrDwarfLines *lines, size_t address, IrDebugLoc loc);
+
+/*
+ * Appends .debug_abbrev, .debug_info, and .debug_line for module's source
+ * file to the object, with relocations against the section symbols. Call
+ * it once all of .text is encoded.
+ */
+int ir_dwarf_write(const IrDwarfLines *lines, const IrModule *module,
+                   IrElfWriter *object);
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef BASECC_IR_ELF_H
+#define BASECC_IR_ELF_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Collects section contents, symbols, and relocations for one relocatable
+ * x86-64 ELF64 object and writes it out in one go.
+ */
+
+typedef enum IrElfSection {
+  IR_ELF_TEXT,
+  IR_ELF_DATA,
+  /* Only its size is tracked; nothing is appended. */
+  IR_ELF_BSS,
+  IR_ELF_RODATA,
+  /* DWARF sections; written only when something was appended. */
+  IR_ELF_DEBUG_INFO,
+  IR_ELF_DEBUG_ABBREV,
+  IR_ELF_DEBUG_LINE,
+  IR_ELF_SECTION_COUNT,
+  /* A symbol referenced but not defined in this object. */
+  IR_ELF_UNDEFINED = -1
+} IrElfSection;
+
+/* Relocation types from the x86-64 psABI. */
+#define IR_ELF_R_X86_64_64 1
+#define IR_ELF_R_X86_64_PC32 2
+#define IR_ELF_R_X86_64_PLT32 4
+#define IR_ELF_R_X86_64_GOTPCREL 9
+#define IR_ELF_R_X86_64_32 10
+
+typedef struct IrElfBuffer {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+} IrElfBuffer;
+
+typedef struct IrElfSymbol {
+  const char *name;
+  IrElfSection section;
+  size_t value;
+  size_t size;
+  int is_function;
+  int is_local;
+  /* The STT_SECTION symbol of `section`; name is only for lookups. */
+  int is_section;
+} IrElfSymbol;
+
+typedef struct IrElfRelocation {
+  IrElfSection section;
+  size_t offset;
+  size_t symbol;
+  unsigned type;
+  long long addend;
+} IrElfRelocation;
+
+typedef struct IrElfWriter {
+  /* Names the STT_FILE symbol. */
+  const char *file_name;
+  IrElfBuffer sections[IR_ELF_SECTION_COUNT];
+  size_t bss_size;
+  size_t alignments[IR_ELF_SECTION_COUNT];
+  /* Symbol names must outlive the writer. */
+  IrElfSymbol *symbols;
+  size_t symbol_count;
+  size_t symbol_capacity;
+  IrElfRelocation *relocations;
+  size_t relocation_count;
+  size_t relocation_capacity;
+  int out_of_memory;
+} IrElfWriter;
+
+void ir_elf_init(IrElfWriter *writer, const char *file_name);
+void ir_elf_free(IrElfWriter *writer);
+
+size_t ir_elf_section_size(const IrElfWriter *writer, IrElfSection section);
+void ir_elf_append(IrElfWriter *writer, IrElfSection section,
+                   const void *data, size_t size);
+/* Pads with `fill` bytes (zeros outside .text) and raises the alignment. */
+void ir_elf_align(IrElfWriter *writer, IrElfSection section, size_t align,
+                  unsigned char fill);
+void ir_elf_patch32(IrElfWriter *writer, IrElfSection section, size_t offset,
+                    long long value);
+
+/* Finds a symbol by name, adding it as undefined on first use. */
+size_t ir_elf_symbol(IrElfWriter *writer, const char *name);
+/* The symbol for the start of section, for relocations between sections. */
+size_t ir_elf_section_symbol(IrElfWriter *writer, IrElfSection section);
+void ir_elf_define(IrElfWriter *writer, size_t symbol, IrElfSection section,
+                   size_t value, size_t size, int is_function, int is_local);
+void ir_elf_relocate(IrElfWriter *writer, IrElfSection section,
+                     size_t offset, size_t symbol, unsigned type,
+                     long long addend);
+
+/* Returns 0 if memory ran out at any point or the write fails. */
+int ir_elf_write(IrElfWriter *writer, FILE *out);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef BASECC_IR_JIT_H
+#define BASECC_IR_JIT_H
+
+#include "ir_vm.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * A baseline JIT for the bytecode VM. Every instruction becomes a copy of
+ * the machine-code template for its opcode, with register offsets,
+ * immediates, and branch targets patched into the holes. Values stay in
+ * the VM's register window, so compiled and interpreted code share all
+ * state and can hand over at any instruction boundary. Only x86-64 System
+ * V hosts compile; elsewhere ir_jit_create returns NULL.
+ */
+
+/* Native stack compiled code may use below the outermost ir_vm_call. */
+#define IR_JIT_NATIVE_STACK ((size_t)4 << 20)
+
+/* What compiled code returns; ok is 0 after an error, left in the vm. */
+typedef struct IrJitResult {
+  IrVmWord value;
+  IrVmWord ok;
+} IrJitResult;
+
+/* Runs a function from its entry with its arguments in registers. */
+typedef IrJitResult (*IrJitEntry)(IrJit *jit, IrVmWord *registers,
+                                  unsigned char *stack);
+/* Runs a function from target, the code for one of its instructions. */
+typedef IrJitResult (*IrJitResume)(IrJit *jit, IrVmWord *registers,
+                                   unsigned char *stack, const void *target);
+
+typedef struct IrJitFunction {
+  /* Calls and loop back-edges left before the function is compiled. */
+  unsigned budget;
+  /* NULL until compiled. */
+  IrJitEntry entry;
+  IrJitResume resume;
+  unsigned char *code;
+  size_t code_size;
+  /* Offset into code of each bytecode word that starts an instruction. */
+  size_t *offsets;
+  /* rel32 fields of compiled call sites that still go through the stub. */
+  unsigned char **sites;
+  size_t site_count;
+  size_t site_capacity;
+} IrJitFunction;
+
+struct IrJit {
+  IrVm *vm;
+  /* Limits compiled code checks, found through its context register. */
+  IrVmWord *registers_end;
+  unsigned char *stack_end;
+  uintptr_t native_limit;
+  /* The innermost interpreter frame; interpreted callees stack above it. */
+  IrVmFrame *frame;
+  IrJitFunction *functions;
+  /* One per opcode, assembled once. */
+  struct IrJitAsm *templates;
+  /*
+   * Reserved in one piece so every call site reaches every function with
+   * a rel32. Pages are writable only while code is written or patched.
+   */
+  unsigned char *region;
+  size_t region_size;
+  size_t region_used;
+  size_t page_size;
+  /* Per function, a stub that enters ir_vm_jit_call. */
+  unsigned char *stubs;
+};
+
+IrJit *ir_jit_create(IrVm *vm, unsigned threshold);
+void ir_jit_free(IrJit *jit);
+/*
+ * Compiles a function and points the call sites waiting for it at the
+ * code. Returns 0 when it cannot; the function then stays interpreted.
+ */
+int ir_jit_compile(IrJit *jit, size_t function);
+
+/*
+ * Defined by the interpreter: what compiled code calls for a function it
+ * has not compiled. Counts the call, then runs the function compiled if
+ * that made it hot, or in the interpreter with its frames stacked above
+ * jit->frame.
+ */
+IrJitResult ir_vm_jit_call(IrJit *jit, IrVmWord *registers,
+                           unsigned char *stack, size_t function);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef BASECC_IR_LLVM_H
+#define BASECC_IR_LLVM_H
+
+#include "ir.h"
+
+#include <stdio.h>
+
+typedef struct IrLlvmOptions {
+  /*
+   * Tag loads and stores with !tbaa access tags for their C type (char,
+   * short, int, any pointer, or a struct field), so LLVM may assume
+   * accesses of different types do not alias.
+   */
+  int type_based_aliasing;
+} IrLlvmOptions;
+
+void ir_llvm_options_init(IrLlvmOptions *options);
+
+/* Writes the module as LLVM textual IR with typed pointers. */
+int ir_llvm_emit(const IrModule *module, const IrLlvmOptions *options,
+                 FILE *out);
+
+#endif
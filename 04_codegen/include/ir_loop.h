@@ -0,0 +1,53 @@
+#ifndef BASECC_IR_LOOP_H
+#define BASECC_IR_LOOP_H
+
+#include "ir.h"
+
+#include <stddef.h>
+
+/*
+ * Natural loops of a function. A loop is headed by a block that dominates
+ * one of its predecessors, the latch of that back edge; its blocks are the
+ * header and everything that reaches a latch without passing through the
+ * header. Loops sharing a header are one loop.
+ */
+
+typedef struct IrLoop {
+  IrBlock *header;
+  /*
+   * The one block outside the loop that enters it, ending in a branch to
+   * the header alone. Code hoisted out of the loop goes here.
+   */
+  IrBlock *preheader;
+  /* The only latch, or NULL when there are several. */
+  IrBlock *latch;
+  /* In dominator-tree (reverse postorder) order, header first. */
+  IrBlock **blocks;
+  size_t block_count;
+  /* One flag per block index: whether it is part of the loop. */
+  char *contains;
+  /* The smallest loop around this one, or NULL. */
+  struct IrLoop *parent;
+  size_t depth;
+} IrLoop;
+
+typedef struct IrLoopInfo {
+  /* Inner loops come before the loops around them. */
+  IrLoop *loops;
+  size_t count;
+} IrLoopInfo;
+
+/*
+ * Finds the loops of function, first giving every loop that lacks one a
+ * preheader: a new block "<header>.ph" that takes over the edges entering
+ * the header from outside, merging their phi values in phis of its own.
+ * The CFG and dominators are current afterwards.
+ */
+int ir_loop_info_compute(IrFunction *function, IrLoopInfo *info);
+void ir_loop_info_free(IrLoopInfo *info);
+
+int ir_loop_contains(const IrLoop *loop, const IrBlock *block);
+/* Whether value is computed outside the loop, or is not an instruction. */
+int ir_loop_is_invariant(const IrLoop *loop, const IrValue *value);
+
+#endif
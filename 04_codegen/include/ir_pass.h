@@ -0,0 +1,184 @@
+#ifndef BASECC_IR_PASS_H
+#define BASECC_IR_PASS_H
+
+#include "ir.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Cost units of one instruction in the inliner's size model. */
+#define IR_INLINE_INSTR_COST 5
+#define IR_INLINE_DEFAULT_THRESHOLD 225
+/* How many times more an instruction in a callee's loop counts, per level. */
+#define IR_INLINE_LOOP_WEIGHT 7
+
+/* Knobs of the passes that have any. */
+typedef struct IrPassOptions {
+  /*
+   * inline: a call site is inlined when the callee's cost, less what the
+   * call itself costs, is at most this. Sites in loops get half as much
+   * again, and the callee's own loops weigh more.
+   */
+  int inline_threshold;
+} IrPassOptions;
+
+/*
+ * A function pass rewrites one function in place and adds the number of
+ * rewrites it made to *changes; a module pass has run_module instead and
+ * sees the whole module at once. Either returns 0 only when it ran out of
+ * memory.
+ */
+typedef struct IrPass {
+  const char *name;
+  const char *description;
+  int (*run_function)(IrFunction *function, size_t *changes);
+  int (*run_module)(IrModule *module, const IrPassOptions *options,
+                    size_t *changes);
+} IrPass;
+
+typedef struct IrPassManager {
+  const IrPass **passes;
+  /* Rewrites made by each pass over the whole module, parallel to passes. */
+  size_t *changes;
+  size_t count;
+  size_t capacity;
+  /* Run the verifier after every pass instead of only at the end. */
+  int verify_each;
+  IrPassOptions options;
+} IrPassManager;
+
+const IrPass *ir_pass_lookup(const char *name, size_t length);
+
+void ir_pass_manager_init(IrPassManager *manager);
+void ir_pass_manager_free(IrPassManager *manager);
+int ir_pass_manager_add(IrPassManager *manager, const IrPass *pass);
+int ir_pass_manager_parse(IrPassManager *manager, const char *pipeline,
+                          const char **message);
+int ir_pass_manager_run(IrPassManager *manager, IrModule *module,
+                        const char **message);
+void ir_pass_manager_report(const IrPassManager *manager, FILE *out);
+
+/*
+ * The unreachable pass: removes blocks that cannot be reached from the
+ * entry block, dropping their phi incomings. *changes counts the blocks
+ * removed.
+ */
+int ir_unreachable_function(IrFunction *function, size_t *changes);
+
+/*
+ * The inline pass (ir_inline.c): visits the call graph bottom-up, so
+ * callees are inlined into before their callers, and inlines each call
+ * site whose callee is cheap enough. Calls within one strongly connected
+ * component, recursion included, are left alone. *changes counts the call
+ * sites inlined.
+ */
+int ir_inline_module(IrModule *module, const IrPassOptions *options,
+                     size_t *changes);
+
+/*
+ * The functionattrs pass (ir_function_attrs.c): visits the call graph
+ * bottom-up and infers, for every defined function, nounwind, norecurse,
+ * willreturn, IrMemoryEffect and argmemonly, and nocapture and readonly
+ * for its pointer parameters. A component is inferred as a whole, and a
+ * call to a declaration may do anything. Run it after mem2reg, which
+ * takes parameters out of their stack slots. *changes counts the
+ * attributes inferred.
+ */
+int ir_function_attrs_module(IrModule *module, const IrPassOptions *options,
+                             size_t *changes);
+
+/*
+ * The tailcall pass (ir_tailcall.c): a self call that is returned right
+ * away becomes a branch back to the top of the function, and other such
+ * calls get IR_FLAG_TAIL or IR_FLAG_MUSTTAIL. Functions that let the
+ * address of a local escape are left alone. *changes counts the calls
+ * rewritten or marked.
+ */
+int ir_tailcall_function(IrFunction *function, size_t *changes);
+
+/*
+ * The mem2reg pass (ir_mem2reg.c): turns int and pointer allocas that are
+ * only loaded from and stored to into SSA values, with phis where stores
+ * meet. *changes counts the allocas promoted.
+ */
+int ir_mem2reg_function(IrFunction *function, size_t *changes);
+
+/*
+ * The sccp pass (ir_sccp.c): sparse conditional constant propagation.
+ * Integer values proven constant on every path that can run are replaced
+ * by the constant, branches on them become plain branches, and blocks
+ * that can no longer run are removed. *changes counts the values
+ * replaced, branches folded, and blocks removed.
+ */
+int ir_sccp_function(IrFunction *function, size_t *changes);
+
+/*
+ * The gvn pass (ir_gvn.c): replaces a pure instruction by a dominating
+ * one that computes the same, and a load by what an earlier load or store
+ * of the same address left there when nothing in between may write it.
+ * Memory is tracked down chains of blocks with a single predecessor.
+ * *changes counts the instructions removed.
+ */
+int ir_gvn_function(IrFunction *function, size_t *changes);
+
+/*
+ * The dse pass (ir_dse.c): removes stores that a later store in the same
+ * block overwrites before anything may read them, stores of a value just
+ * loaded from the same place, and writes to allocas that are never read
+ * and do not escape. Run dce after it for the allocas left unused.
+ * *changes counts the stores removed.
+ */
+int ir_dse_function(IrFunction *function, size_t *changes);
+
+/*
+ * The licm pass (ir_licm.c): gives each loop a preheader and moves
+ * loop-invariant computations, and loads nothing in the loop may store
+ * to, into it. *changes counts the instructions moved.
+ */
+int ir_licm_function(IrFunction *function, size_t *changes);
+
+/*
+ * The ivsr pass (ir_ivsr.c): replaces GEPs whose index is an induction
+ * variable, scaled by a constant and offset by an invariant, with a
+ * pointer the loop steps along. Works on SSA values, so run it after
+ * mem2reg. *changes counts the GEPs replaced.
+ */
+int ir_ivsr_function(IrFunction *function, size_t *changes);
+
+/*
+ * The loopidiom pass (ir_loop_idiom.c): a counted loop that only stores
+ * one byte pattern to base[i] becomes a memset, and one that only copies
+ * source[i] to base[i] becomes a memcpy, behind a run-time overlap check
+ * unless the two arrays are known apart. Run it after mem2reg and licm,
+ * and before ivsr. *changes counts the loops replaced.
+ */
+int ir_loop_idiom_function(IrFunction *function, size_t *changes);
+
+/*
+ * Switch lowering (ir_switch.c). The sorted cases split into clusters:
+ * runs of at least IR_SWITCH_MIN_TABLE_CASES cases filling at least
+ * IR_SWITCH_MIN_TABLE_DENSITY percent of a range of at most
+ * IR_SWITCH_MAX_TABLE_RANGE values, which stay behind as a switch for the
+ * backend to emit as a jump table, and single cases. A balanced binary
+ * search of signed compares picks the cluster. With jump_tables off every
+ * case is its own cluster. *changes counts the switches rewritten.
+ */
+#define IR_SWITCH_MIN_TABLE_CASES 4
+#define IR_SWITCH_MIN_TABLE_DENSITY 40
+#define IR_SWITCH_MAX_TABLE_RANGE 4096
+
+int ir_switch_lower_function(IrFunction *function, int jump_tables,
+                             size_t *changes);
+
+/* The lowerswitch pass: ir_switch_lower_function with no jump tables. */
+int ir_lowerswitch_function(IrFunction *function, size_t *changes);
+
+/*
+ * The blockplace pass (ir_profile.c): for a function with a profile
+ * (ir_profile.h), chains each block to its most taken successor so the
+ * hot path falls through, and moves blocks that never ran to the end.
+ * The entry stays first. *changes counts the functions reordered.
+ */
+int ir_profile_layout_function(IrFunction *function, size_t *changes);
+
+#endif
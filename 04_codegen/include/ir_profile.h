@@ -0,0 +1,92 @@
+#ifndef BASECC_IR_PROFILE_H
+#define BASECC_IR_PROFILE_H
+
+#include "ir.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Profile-guided optimization without an outside toolchain. An
+ * instrumented module counts how often each block runs and how often each
+ * conditional branch goes to its true target, in one zeroed i64 array per
+ * function. On its first call a function hands its array to the runtime
+ * (ir_profile_runtime.c), which appends every array to the profile file
+ * at exit. A later build reads the file back and annotates the same
+ * functions with entry counts, block counts, and branch weights.
+ *
+ * Functions are matched by a hash of their name and a checksum of their
+ * CFG, both taken before any pass runs, so the instrumented and the
+ * optimized build have to lower the same source. A function whose
+ * checksum differs is left unannotated.
+ */
+
+/* The environment variable naming the file; IR_PROFILE_DEFAULT_PATH else. */
+#define IR_PROFILE_ENV "BASECC_PROFILE"
+#define IR_PROFILE_DEFAULT_PATH "basecc.profile"
+
+/*
+ * Function entry/exit instrumentation is separate: it counts calls and
+ * inclusive time per function, per thread, and appends a report sorted by
+ * time to this file at exit.
+ */
+#define IR_PROFILE_FUNCTIONS_ENV "BASECC_FUNCTION_PROFILE"
+#define IR_PROFILE_FUNCTIONS_DEFAULT_PATH "basecc.functions"
+
+/* One function's counters, summed over every run in the file. */
+typedef struct IrProfileRecord {
+  unsigned long long guid;
+  unsigned long long checksum;
+  /* The block counts in layout order, then one per conditional branch. */
+  unsigned long long *counters;
+  size_t counter_count;
+} IrProfileRecord;
+
+typedef struct IrProfile {
+  IrProfileRecord *records;
+  size_t record_count;
+  size_t record_capacity;
+} IrProfile;
+
+unsigned long long ir_profile_guid(const char *name);
+/*
+ * Counters each definition in module and calls the runtime from its entry
+ * block. Run it on the module as lowered, before any pass.
+ */
+int ir_profile_instrument_module(IrModule *module);
+/*
+ * Has each definition call __basecc_function_enter on entry and
+ * __basecc_function_exit ahead of every return.
+ */
+int ir_profile_instrument_functions(IrModule *module);
+
+void ir_profile_init(IrProfile *profile);
+void ir_profile_free(IrProfile *profile);
+/* Reads and merges the records a profile file holds. */
+int ir_profile_read(IrProfile *profile, FILE *in, const char **message);
+/*
+ * Sets entry counts, block counts, and condbr weights on every definition
+ * the profile has a matching record for, again before any pass runs.
+ * *annotated counts those functions.
+ */
+int ir_profile_annotate_module(IrModule *module, const IrProfile *profile,
+                               size_t *annotated);
+
+/*
+ * Runtime entry point called by instrumented code: registers the counters
+ * of a function on its first call, and writes them all out at exit.
+ */
+void __basecc_profile_enter(unsigned long long *counters,
+                            unsigned long long guid,
+                            unsigned long long checksum, int count);
+/*
+ * Counts a call of the function whose id *slot holds, assigning one on
+ * its first call, and returns the time stamp to pass to the exit.
+ */
+unsigned long long __basecc_function_enter(unsigned long long *slot,
+                                           const char *name);
+/* Adds the time since start unless the function is still active below. */
+void __basecc_function_exit(unsigned long long *slot,
+                            unsigned long long start);
+
+#endif
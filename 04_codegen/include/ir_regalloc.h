@@ -0,0 +1,69 @@
+#ifndef BASECC_IR_REGALLOC_H
+#define BASECC_IR_REGALLOC_H
+
+#include "ir.h"
+
+#include <stddef.h>
+
+/*
+ * Linear-scan register allocation over the BaseCC IR. Each SSA value gets
+ * one live interval spanning its definition and every use in block layout
+ * order; an interval either keeps a single register for its whole life or
+ * is spilled to the stack. Registers are small target-defined numbers.
+ */
+
+/* The value lives in a stack slot. */
+#define IR_REGALLOC_SPILLED (-1)
+/* The value is never used, or is an alloca (its address is a constant). */
+#define IR_REGALLOC_NONE (-2)
+
+typedef struct IrRegAllocTarget {
+  /* Registers a call clobbers, in order of preference. */
+  const int *caller_saved;
+  size_t caller_saved_count;
+  /* Registers a call preserves; the function saves the ones it uses. */
+  const int *callee_saved;
+  size_t callee_saved_count;
+  /* Registers the first parameters arrive in, used as coalescing hints. */
+  const int *parameter_registers;
+  size_t parameter_register_count;
+} IrRegAllocTarget;
+
+typedef struct IrLiveInterval {
+  IrValue *value;
+  size_t slot;
+  size_t start;
+  size_t end;
+  /* Sum of 10^loop_depth over the definition and every use. */
+  double spill_cost;
+  int crosses_call;
+  /* Register that would make a parameter or argument move disappear. */
+  int hint;
+  int reg;
+} IrLiveInterval;
+
+typedef struct IrRegAllocation {
+  /* Register or IR_REGALLOC_* per slot; see ir_regalloc_slot. */
+  int *registers;
+  size_t slot_count;
+  IrLiveInterval *intervals;
+  size_t interval_count;
+  /* Bit per callee-saved register the function has to preserve. */
+  unsigned long callee_saved_used;
+  size_t spill_count;
+  /* Copies (phis, no-op casts, parameters, arguments) left as no-ops. */
+  size_t coalesced_count;
+} IrRegAllocation;
+
+/* Parameters take slots [0, param_count), results follow by id. */
+size_t ir_regalloc_slot(const IrFunction *function, const IrValue *value);
+/*
+ * Allocates registers for one function definition. A target without
+ * registers spills every value, which is the baseline the allocator is
+ * measured against.
+ */
+int ir_regalloc_run(IrFunction *function, const IrRegAllocTarget *target,
+                    IrRegAllocation *allocation);
+void ir_regalloc_free(IrRegAllocation *allocation);
+
+#endif
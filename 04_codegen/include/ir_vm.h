@@ -0,0 +1,318 @@
+#ifndef BASECC_IR_VM_H
+#define BASECC_IR_VM_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * A register-based bytecode for BaseCC programs and the interpreter that
+ * runs it in-process, with no assembler or linker involved. This half has
+ * no dependency on the IR; ir_bytecode.h lowers an IrModule into it.
+ *
+ * Code is a stream of 64-bit words: an opcode followed by its operands.
+ * Every value in a register is kept sign-extended from its type's width
+ * (i1 is 0 or 1), so comparisons and address arithmetic can work on the
+ * full word and only arithmetic that may overflow has to wrap.
+ */
+
+typedef long long IrVmWord;
+
+/*
+ * Operand letters: r register, i immediate, t code offset of a branch
+ * target, f bytecode function, n native function, a argument count
+ * followed by that many registers.
+ *
+ * The superinstructions at the end stand for common runs of the others:
+ * JEQ to JUGE compare two registers and branch, ADD_MEM32 and SUB_MEM32
+ * update the i32 at an address in place, and LOAD32_INDEX and
+ * STORE32_INDEX access base + index * scale.
+ */
+#define IR_VM_OPCODES(X)                                                       \
+  X(MOV, "rr")                                                                 \
+  X(FRAME, "ri")                                                               \
+  X(ADD, "rrri")                                                               \
+  X(SUB, "rrri")                                                               \
+  X(MUL, "rrri")                                                               \
+  X(SDIV, "rrri")                                                              \
+  X(SREM, "rrri")                                                              \
+  X(SHL, "rrri")                                                               \
+  X(ASHR, "rrr")                                                               \
+  X(LSHR, "rrri")                                                              \
+  X(AND, "rrr")                                                                \
+  X(OR, "rrr")                                                                 \
+  X(XOR, "rrr")                                                                \
+  X(EQ, "rrr")                                                                 \
+  X(NE, "rrr")                                                                 \
+  X(SLT, "rrr")                                                                \
+  X(SLE, "rrr")                                                                \
+  X(SGT, "rrr")                                                                \
+  X(SGE, "rrr")                                                                \
+  X(ULT, "rrr")                                                                \
+  X(ULE, "rrr")                                                                \
+  X(UGT, "rrr")                                                                \
+  X(UGE, "rrr")                                                                \
+  X(WRAP, "rri")                                                               \
+  X(MASK, "rri")                                                               \
+  X(NEG, "rr")                                                                 \
+  X(INDEX, "rrri")                                                             \
+  X(OFFSET, "rri")                                                             \
+  X(LOAD8, "rr")                                                               \
+  X(LOAD16, "rr")                                                              \
+  X(LOAD32, "rr")                                                              \
+  X(LOAD64, "rr")                                                              \
+  X(LOADU8, "rr")                                                              \
+  X(STORE8, "rr")                                                              \
+  X(STORE16, "rr")                                                             \
+  X(STORE32, "rr")                                                             \
+  X(STORE64, "rr")                                                             \
+  X(JMP, "t")                                                                  \
+  X(JZ, "rt")                                                                  \
+  X(JNZ, "rt")                                                                 \
+  X(CALL, "rfa")                                                               \
+  X(CALL_NATIVE, "rna")                                                        \
+  X(RET, "r")                                                                  \
+  X(RET_VOID, "")                                                              \
+  /* Superinstructions. */                                                     \
+  X(JEQ, "rrt")                                                                \
+  X(JNE, "rrt")                                                                \
+  X(JSLT, "rrt")                                                               \
+  X(JSLE, "rrt")                                                               \
+  X(JSGT, "rrt")                                                               \
+  X(JSGE, "rrt")                                                               \
+  X(JULT, "rrt")                                                               \
+  X(JULE, "rrt")                                                               \
+  X(JUGT, "rrt")                                                               \
+  X(JUGE, "rrt")                                                               \
+  X(ADD_MEM32, "rr")                                                           \
+  X(SUB_MEM32, "rr")                                                           \
+  X(LOAD32_INDEX, "rrri")                                                      \
+  X(STORE32_INDEX, "rrri")
+
+/*
+ * Type-specialized forms the interpreter rewrites generic instructions
+ * into in place the first time they run, keeping their operands. They
+ * drop the wrap shift for the common widths; images never contain them.
+ */
+#define IR_VM_QUICK_OPCODES(X)                                                 \
+  X(ADD_I32, "rrri")                                                           \
+  X(ADD_I64, "rrri")                                                           \
+  X(SUB_I32, "rrri")                                                           \
+  X(SUB_I64, "rrri")                                                           \
+  X(MUL_I32, "rrri")                                                           \
+  X(MUL_I64, "rrri")                                                           \
+  X(SDIV_I32, "rrri")                                                          \
+  X(SREM_I32, "rrri")
+
+typedef enum IrVmOpcode {
+#define IR_VM_OPCODE_ENUM(name, operands) IR_VM_OP_##name,
+  IR_VM_OPCODES(IR_VM_OPCODE_ENUM)
+  IR_VM_QUICK_OPCODES(IR_VM_OPCODE_ENUM)
+#undef IR_VM_OPCODE_ENUM
+  IR_VM_OPCODE_COUNT
+} IrVmOpcode;
+
+/* Parameter, return, and native signature types. */
+typedef enum IrVmType {
+  IR_VM_TYPE_VOID,
+  IR_VM_TYPE_I1,
+  IR_VM_TYPE_I8,
+  IR_VM_TYPE_I16,
+  IR_VM_TYPE_I32,
+  IR_VM_TYPE_I64,
+  IR_VM_TYPE_PTR
+} IrVmType;
+
+typedef enum IrVmConstantKind {
+  IR_VM_CONST_INT,
+  /* The address of program->globals[value]. */
+  IR_VM_CONST_GLOBAL,
+  /* The address of the native function program->natives[value]. */
+  IR_VM_CONST_NATIVE
+} IrVmConstantKind;
+
+typedef struct IrVmConstant {
+  IrVmConstantKind kind;
+  long long value;
+} IrVmConstant;
+
+typedef struct IrVmFunction {
+  char *name;
+  int is_exported;
+  IrVmType return_type;
+  IrVmType *params;
+  size_t param_count;
+  /*
+   * Parameters arrive in registers [0, param_count); constants are copied
+   * into [constant_base, constant_base + constant_count) on every call.
+   */
+  size_t register_count;
+  size_t constant_base;
+  IrVmConstant *constants;
+  size_t constant_count;
+  /* Bytes of alloca storage, a multiple of 16. */
+  size_t frame_size;
+  IrVmWord *code;
+  size_t code_size;
+} IrVmFunction;
+
+typedef enum IrVmInitKind {
+  /* The low `size` bytes of value, little-endian. */
+  IR_VM_INIT_INT,
+  /* The address of program->globals[value], 8 bytes. */
+  IR_VM_INIT_ADDRESS
+} IrVmInitKind;
+
+/* Bytes of a global's initial value at offset; the rest are zero. */
+typedef struct IrVmInit {
+  IrVmInitKind kind;
+  size_t offset;
+  size_t size;
+  long long value;
+} IrVmInit;
+
+typedef struct IrVmGlobal {
+  char *name;
+  size_t size;
+  size_t align;
+  /* In increasing offset order. */
+  IrVmInit *inits;
+  size_t init_count;
+} IrVmGlobal;
+
+/* A function the program calls but does not define, found by name. */
+typedef struct IrVmNative {
+  char *name;
+  IrVmType return_type;
+} IrVmNative;
+
+/* Natives take at most this many arguments, all in integer registers. */
+#define IR_VM_NATIVE_ARGS 6
+
+typedef struct IrVmProgram {
+  IrVmFunction *functions;
+  size_t function_count;
+  IrVmGlobal *globals;
+  size_t global_count;
+  IrVmNative *natives;
+  size_t native_count;
+} IrVmProgram;
+
+void ir_vm_program_init(IrVmProgram *program);
+void ir_vm_program_free(IrVmProgram *program);
+const char *ir_vm_opcode_name(IrVmOpcode opcode);
+/* Operand letters of the opcode, as listed in IR_VM_OPCODES. */
+const char *ir_vm_opcode_operands(IrVmOpcode opcode);
+/* Number of words the instruction at code takes, opcode included. */
+size_t ir_vm_instr_size(const IrVmWord *code);
+int ir_vm_find_function(const IrVmProgram *program, const char *name,
+                        size_t *index);
+void ir_vm_dump_program(const IrVmProgram *program, FILE *out);
+
+/*
+ * A self-contained binary image of the program. Reading validates every
+ * instruction, so a loaded image cannot make the interpreter step outside
+ * its registers, code, or tables.
+ */
+int ir_vm_write_image(const IrVmProgram *program, FILE *out);
+int ir_vm_read_image(IrVmProgram *program, const unsigned char *data,
+                     size_t size, const char **message);
+/*
+ * Writes C source embedding the image, with one native entry point per
+ * exported function, so a C host can link the program like an object.
+ */
+int ir_vm_write_host(const IrVmProgram *program, FILE *out);
+
+/*
+ * Dynamic opcode counts, and counts of the runs of two and three opcodes
+ * executed one after the other with no branch, call, or return between
+ * them: the candidates for superinstructions.
+ */
+typedef struct IrVmProfile {
+  unsigned long long counts[IR_VM_OPCODE_COUNT];
+  unsigned long long pairs[IR_VM_OPCODE_COUNT][IR_VM_OPCODE_COUNT];
+  unsigned long long triples[IR_VM_OPCODE_COUNT][IR_VM_OPCODE_COUNT]
+                            [IR_VM_OPCODE_COUNT];
+  /* The last two opcodes of the current run, most recent first, or -1. */
+  int previous[2];
+} IrVmProfile;
+
+IrVmProfile *ir_vm_profile_create(void);
+void ir_vm_profile_free(IrVmProfile *profile);
+/* Number of instructions dispatched. */
+unsigned long long ir_vm_profile_dispatches(const IrVmProfile *profile);
+/* Writes one line per nonzero count: "count op [op [op]]". */
+int ir_vm_write_profile(const IrVmProfile *profile, FILE *out);
+
+/* Looks up a native function; returns NULL if there is none. */
+typedef void *(*IrVmResolver)(const char *name, void *data);
+
+typedef struct IrVmFrame IrVmFrame;
+/* The JIT tier, declared in ir_jit.h. */
+typedef struct IrJit IrJit;
+
+/* Calls plus loop back-edges after which a function is compiled. */
+#define IR_VM_JIT_THRESHOLD 1000
+
+typedef struct IrVm {
+  const IrVmProgram *program;
+  /* Globals, laid out back to back at their alignment. */
+  unsigned char *data;
+  void **global_addresses;
+  void **natives;
+  /* Per function, the constants with addresses filled in. */
+  IrVmWord **constants;
+  /* Per function, a copy of the code that quickening rewrites. */
+  IrVmWord **code;
+  /* Rewrite generic instructions into IR_VM_QUICK_OPCODES; on by default. */
+  int quicken;
+  /*
+   * Counts every dispatch while set. Quickening is off meanwhile, so the
+   * counts describe the bytecode as compiled.
+   */
+  IrVmProfile *profile;
+  /*
+   * Hot functions are compiled to machine code where ir_jit.h supports the
+   * host; 0 keeps everything interpreted. Not consulted while profiling.
+   */
+  unsigned jit_threshold;
+  /* Created by the first ir_vm_call that may compile. */
+  IrJit *jit;
+  IrVmWord *registers;
+  size_t register_capacity;
+  unsigned char *stack;
+  size_t stack_size;
+  IrVmFrame *frames;
+  size_t frame_capacity;
+  const char *error_message;
+} IrVm;
+
+/*
+ * Lays out the globals and resolves natives through resolver, or with
+ * dlsym in the running process when it is NULL.
+ */
+int ir_vm_init(IrVm *vm, const IrVmProgram *program, IrVmResolver resolver,
+               void *resolver_data);
+void ir_vm_free(IrVm *vm);
+/* Runs a function to completion; result may be NULL. */
+int ir_vm_call(IrVm *vm, size_t function, const IrVmWord *args,
+               size_t arg_count, IrVmWord *result);
+const char *ir_vm_error(const IrVm *vm);
+
+/* State behind the entry points ir_vm_write_host generates. */
+typedef struct IrVmHost {
+  int loaded;
+  IrVmProgram program;
+  IrVm vm;
+} IrVmHost;
+
+/*
+ * Loads the image on first use; reports any failure and aborts. With
+ * BASECC_VM_PROFILE set in the environment, every host in the process
+ * shares one profile that is appended to that file at exit;
+ * BASECC_VM_JIT_THRESHOLD overrides the VM's jit_threshold.
+ */
+IrVmWord ir_vm_host_call(IrVmHost *host, const unsigned char *image,
+                         size_t size, size_t function, const IrVmWord *args,
+                         size_t arg_count);
+
+#endif
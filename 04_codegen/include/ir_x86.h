@@ -0,0 +1,31 @@
+#ifndef BASECC_IR_X86_H
+#define BASECC_IR_X86_H
+
+#include "ir.h"
+
+#include <stdio.h>
+
+typedef struct IrX86Options {
+  /*
+   * Keep values in registers chosen by the linear-scan allocator. With 0,
+   * every value gets its own stack slot (the all-spill baseline).
+   */
+  int allocate_registers;
+} IrX86Options;
+
+void ir_x86_options_init(IrX86Options *options);
+
+/*
+ * Writes the module as x86-64 GNU assembler text (AT&T syntax) for the
+ * System V ABI, ready for `as` or `cc -c`. Register allocation refreshes
+ * the CFG and loop information of each function.
+ */
+int ir_x86_emit(IrModule *module, const IrX86Options *options, FILE *out);
+/*
+ * Encodes the same code directly into a relocatable ELF64 object for the
+ * system linker, without going through an assembler.
+ */
+int ir_x86_emit_object(IrModule *module, const IrX86Options *options,
+                       FILE *out);
+
+#endif
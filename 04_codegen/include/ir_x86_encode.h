@@ -0,0 +1,135 @@
+#ifndef BASECC_IR_X86_ENCODE_H
+#define BASECC_IR_X86_ENCODE_H
+
+#include "ir.h"
+
+#include <stddef.h>
+
+/*
+ * x86-64 machine instructions as the backend selects them. The assembly
+ * printer writes them as AT&T text; ir_x86_encode turns them into bytes
+ * for the object writer.
+ */
+
+/* Numbered as in the instruction encoding. */
+typedef enum IrX86Register {
+  IR_X86_RAX,
+  IR_X86_RCX,
+  IR_X86_RDX,
+  IR_X86_RBX,
+  IR_X86_RSP,
+  IR_X86_RBP,
+  IR_X86_RSI,
+  IR_X86_RDI,
+  IR_X86_R8,
+  IR_X86_R9,
+  IR_X86_R10,
+  IR_X86_R11,
+  IR_X86_R12,
+  IR_X86_R13,
+  IR_X86_R14,
+  IR_X86_R15,
+  IR_X86_NO_REGISTER
+} IrX86Register;
+
+/* Listed in pairs so that flipping the low bit negates a condition. */
+typedef enum IrX86Condition {
+  IR_X86_CC_E,
+  IR_X86_CC_NE,
+  IR_X86_CC_L,
+  IR_X86_CC_GE,
+  IR_X86_CC_LE,
+  IR_X86_CC_G,
+  IR_X86_CC_B,
+  IR_X86_CC_AE,
+  IR_X86_CC_BE,
+  IR_X86_CC_A
+} IrX86Condition;
+
+typedef enum IrX86Opcode {
+  IR_X86_MOV,
+  IR_X86_MOVZX,
+  IR_X86_MOVSX,
+  IR_X86_LEA,
+  IR_X86_ADD,
+  IR_X86_SUB,
+  IR_X86_IMUL,
+  IR_X86_AND,
+  IR_X86_OR,
+  IR_X86_XOR,
+  IR_X86_CMP,
+  IR_X86_TEST,
+  IR_X86_SHL,
+  IR_X86_SAR,
+  IR_X86_SHR,
+  IR_X86_NEG,
+  IR_X86_CQO,
+  IR_X86_IDIV,
+  IR_X86_SETCC,
+  IR_X86_JCC,
+  IR_X86_JMP,
+  IR_X86_CALL,
+  IR_X86_PUSH,
+  IR_X86_POP,
+  IR_X86_LEAVE,
+  IR_X86_RET,
+  /* rep stosb and rep movsb: %rcx bytes at %rdi from %al or %rsi. */
+  IR_X86_REP_STOS,
+  IR_X86_REP_MOVS
+} IrX86Opcode;
+
+typedef enum IrX86OperandKind {
+  IR_X86_OPERAND_NONE,
+  IR_X86_OPERAND_REG,
+  IR_X86_OPERAND_IMM,
+  /* value(base, index, scale) */
+  IR_X86_OPERAND_MEM,
+  /* symbol+value(%rip), or its GOT entry */
+  IR_X86_OPERAND_SYMBOL,
+  /* .Ledge<value>(%rip): a label in the current function */
+  IR_X86_OPERAND_LABEL
+} IrX86OperandKind;
+
+typedef struct IrX86Operand {
+  IrX86OperandKind kind;
+  IrX86Register reg;
+  IrX86Register index;
+  int scale;
+  long long value;
+  const char *symbol;
+  int got;
+} IrX86Operand;
+
+/* One machine instruction; one-operand forms use dst. */
+typedef struct IrX86Instr {
+  IrX86Opcode opcode;
+  /* Operand width, or the source width of movzx and movsx. */
+  int bits;
+  IrX86Condition condition;
+  IrX86Operand src;
+  IrX86Operand dst;
+  /* IR_X86_JCC and IR_X86_JMP: a block, or an edge stub when edge >= 0. */
+  const IrBlock *target;
+  int edge;
+  /*
+   * IR_X86_CALL, or an IR_X86_JMP that leaves for another function; a dst
+   * register makes either indirect instead.
+   */
+  const char *callee;
+  int plt;
+} IrX86Instr;
+
+typedef struct IrX86Encoding {
+  unsigned char bytes[16];
+  size_t length;
+  /*
+   * Offset of the 32-bit PC-relative field left as zero for the caller: a
+   * branch or call target or a RIP-relative displacement. 0 if none.
+   */
+  size_t pcrel_offset;
+} IrX86Encoding;
+
+/* Returns 0 for operand combinations the instruction does not have. */
+int ir_x86_encode(const IrX86Instr *instr, IrX86Encoding *encoding);
+
+#endif
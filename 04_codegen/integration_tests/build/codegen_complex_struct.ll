@@ -0,0 +1,49 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Data = type { i32, i32, i32 }
+%struct.Node = type { i32, %struct.Node* }
+
+@g_data = global %struct.Data zeroinitializer
+define noundef i32 @sum_data() {
+entry:
+  %t0 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 0
+  store i32 10, i32* %t0, !tbaa !4
+  %t1 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 1
+  store i32 20, i32* %t1, !tbaa !5
+  %t2 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 2
+  store i32 30, i32* %t2, !tbaa !6
+  %t3 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 0
+  %t4 = load i32, i32* %t3, !tbaa !4
+  %t5 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 1
+  %t6 = load i32, i32* %t5, !tbaa !5
+  %t7 = add nsw i32 %t4, %t6
+  %t8 = getelementptr inbounds %struct.Data, %struct.Data* @g_data, i32 0, i32 2
+  %t9 = load i32, i32* %t8, !tbaa !6
+  %t10 = add nsw i32 %t7, %t9
+  ret i32 %t10
+}
+define noundef i32 @get_second_value(%struct.Node* noundef %head) {
+entry:
+  %t0 = alloca %struct.Node*
+  %t1 = getelementptr inbounds %struct.Node, %struct.Node* %head, i32 0, i32 1
+  %t2 = load %struct.Node*, %struct.Node** %t1, !tbaa !9
+  store %struct.Node* %t2, %struct.Node** %t0, !tbaa !10
+  %t3 = load %struct.Node*, %struct.Node** %t0, !tbaa !10
+  %t4 = getelementptr inbounds %struct.Node, %struct.Node* %t3, i32 0, i32 0
+  %t5 = load i32, i32* %t4, !tbaa !11
+  ret i32 %t5
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!"Data", !2, i64 0, !2, i64 4, !2, i64 8}
+!4 = !{!3, !2, i64 0}
+!5 = !{!3, !2, i64 4}
+!6 = !{!3, !2, i64 8}
+!7 = !{!"any pointer", !1, i64 0}
+!8 = !{!"Node", !2, i64 0, !7, i64 8}
+!9 = !{!8, !7, i64 8}
+!10 = !{!7, !7, i64 0}
+!11 = !{!8, !2, i64 0}
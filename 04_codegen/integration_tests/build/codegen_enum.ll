@@ -0,0 +1,29 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+@g_color = global i32 1
+define noundef i32 @get_red() {
+entry:
+  ret i32 0
+}
+define noundef i32 @get_blue() {
+entry:
+  ret i32 10
+}
+define noundef i32 @get_yellow() {
+entry:
+  ret i32 11
+}
+define noundef i32 @test_enum_logic() {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  store i32 11, i32* %t0, !tbaa !3
+  %t1 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t1
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,135 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+@scale = global i32 0
+@table = global [16 x i32] zeroinitializer
+define noundef i32 @set_scale(i32 noundef %value) {
+entry:
+  store i32 %value, i32* @scale, !tbaa !3
+  %t0 = load i32, i32* @scale, !tbaa !3
+  ret i32 %t0
+}
+define noundef i32 @table_at(i32 noundef %index) {
+entry:
+  %t0 = getelementptr inbounds [16 x i32], [16 x i32]* @table, i32 0, i32 0
+  %t1 = getelementptr inbounds i32, i32* %t0, i32 %index
+  %t2 = load i32, i32* %t1, !tbaa !3
+  ret i32 %t2
+}
+define noundef i32 @sum_scaled(i32* noundef %values, i32 noundef %n, i32 noundef %k) {
+entry:
+  %t8 = load i32, i32* @scale, !tbaa !3
+  %t9 = mul nsw i32 %k, %t8
+  %t10 = add nsw i32 %t9, 1
+  br label %for.cond0
+for.cond0:
+  %t18 = phi i32* [%values, %entry], [%t19, %for.inc2]
+  %t17 = phi i32 [0, %entry], [%t14, %for.inc2]
+  %t16 = phi i32 [0, %entry], [%t12, %for.inc2]
+  %t3 = icmp slt i32 %t17, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t7 = load i32, i32* %t18, !tbaa !3
+  %t11 = mul nsw i32 %t7, %t10
+  %t12 = add nsw i32 %t16, %t11
+  br label %for.inc2
+for.inc2:
+  %t14 = add nsw i32 %t17, 1
+  %t19 = getelementptr i32, i32* %t18, i32 1
+  br label %for.cond0
+for.end3:
+  ret i32 %t16
+}
+define noundef i32 @fill_table(i32 noundef %base) {
+entry:
+  %t3 = getelementptr inbounds [16 x i32], [16 x i32]* @table, i32 0, i32 0
+  %t7 = load i32, i32* @scale, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t16 = phi i32* [%t3, %entry], [%t17, %for.inc2]
+  %t15 = phi i32 [0, %entry], [%t11, %for.inc2]
+  %t2 = icmp slt i32 %t15, 16
+  br i1 %t2, label %for.body1, label %for.end3
+for.body1:
+  %t8 = mul nsw i32 %t15, %t7
+  %t9 = add nsw i32 %base, %t8
+  store i32 %t9, i32* %t16, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t11 = add nsw i32 %t15, 1
+  %t17 = getelementptr i32, i32* %t16, i32 1
+  br label %for.cond0
+for.end3:
+  %t12 = getelementptr inbounds [16 x i32], [16 x i32]* @table, i32 0, i32 0
+  %t13 = getelementptr inbounds i32, i32* %t12, i32 15
+  %t14 = load i32, i32* %t13, !tbaa !3
+  ret i32 %t14
+}
+define noundef i32 @column_sum(i32* noundef %grid, i32 noundef %rows, i32 noundef %col) {
+entry:
+  %t16 = getelementptr i32, i32* %grid, i32 %col
+  br label %for.cond0
+for.cond0:
+  %t17 = phi i32* [%t16, %entry], [%t18, %for.inc2]
+  %t15 = phi i32 [0, %entry], [%t12, %for.inc2]
+  %t14 = phi i32 [0, %entry], [%t10, %for.inc2]
+  %t3 = icmp slt i32 %t15, %rows
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t9 = load i32, i32* %t17, !tbaa !3
+  %t10 = add nsw i32 %t14, %t9
+  br label %for.inc2
+for.inc2:
+  %t12 = add nsw i32 %t15, 1
+  %t18 = getelementptr i32, i32* %t17, i32 4
+  br label %for.cond0
+for.end3:
+  ret i32 %t14
+}
+define noundef i32 @count_below(i32* noundef %values, i32 noundef %n, i32 noundef %limit) {
+entry:
+  br label %while.cond0
+while.cond0:
+  %t11 = phi i32* [%values, %entry], [%t12, %if.end4]
+  %t10 = phi i32 [0, %entry], [%t8, %if.end4]
+  %t2 = icmp slt i32 %t10, %n
+  br i1 %t2, label %while.body1, label %while.end2
+while.body1:
+  %t5 = load i32, i32* %t11, !tbaa !3
+  %t6 = icmp sgt i32 %t5, %limit
+  br i1 %t6, label %if.then3, label %if.end4
+if.then3:
+  br label %while.end2
+if.end4:
+  %t8 = add nsw i32 %t10, 1
+  %t12 = getelementptr i32, i32* %t11, i32 1
+  br label %while.cond0
+while.end2:
+  ret i32 %t10
+}
+define noundef i32 @bump_scale(i32 noundef %n) {
+entry:
+  br label %for.cond0
+for.cond0:
+  %t13 = phi i32 [0, %entry], [%t10, %for.inc2]
+  %t12 = phi i32 [0, %entry], [%t6, %for.inc2]
+  %t3 = icmp slt i32 %t13, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t5 = load i32, i32* @scale, !tbaa !3
+  %t6 = add nsw i32 %t12, %t5
+  %t7 = load i32, i32* @scale, !tbaa !3
+  %t8 = add nsw i32 %t7, 1
+  store i32 %t8, i32* @scale, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t10 = add nsw i32 %t13, 1
+  br label %for.cond0
+for.end3:
+  ret i32 %t12
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,30 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.S1 = type { i32, i32 }
+
+define noundef i32 @size_int() {
+entry:
+  %t0 = getelementptr i32, i32* null, i32 1
+  %t1 = ptrtoint i32* %t0 to i32
+  ret i32 %t1
+}
+define noundef i32 @size_s1() {
+entry:
+  %t0 = getelementptr %struct.S1, %struct.S1* null, i32 1
+  %t1 = ptrtoint %struct.S1* %t0 to i32
+  ret i32 %t1
+}
+define noundef i32 @size_s1_ptr() {
+entry:
+  %t0 = getelementptr %struct.S1*, %struct.S1** null, i32 1
+  %t1 = ptrtoint %struct.S1** %t0 to i32
+  ret i32 %t1
+}
+define noundef i32 @size_val() {
+entry:
+  %t0 = alloca i32
+  %t1 = getelementptr i32, i32* null, i32 1
+  %t2 = ptrtoint i32* %t1 to i32
+  ret i32 %t2
+}
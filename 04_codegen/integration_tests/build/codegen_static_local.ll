@@ -0,0 +1,28 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+@.static.counter.0.count = internal global i32 0
+
+define noundef i32 @counter() {
+entry:
+  %t0 = load i32, i32* @.static.counter.0.count, !tbaa !3
+  %t1 = add nsw i32 %t0, 1
+  store i32 %t1, i32* @.static.counter.0.count, !tbaa !3
+  %t2 = load i32, i32* @.static.counter.0.count, !tbaa !3
+  ret i32 %t2
+}
+@.static.counter_init.0.count = internal global i32 42
+
+define noundef i32 @counter_init() {
+entry:
+  %t0 = load i32, i32* @.static.counter_init.0.count, !tbaa !3
+  %t1 = add nsw i32 %t0, 1
+  store i32 %t1, i32* @.static.counter_init.0.count, !tbaa !3
+  %t2 = load i32, i32* @.static.counter_init.0.count, !tbaa !3
+  ret i32 %t2
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,109 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @times_eight(i32 noundef %x) {
+entry:
+  %t0 = shl nsw i32 %x, 3
+  ret i32 %t0
+}
+define noundef i32 @times_minus_four(i32 noundef %x) {
+entry:
+  %t0 = shl nsw i32 %x, 2
+  %t1 = sub nsw i32 0, %t0
+  ret i32 %t1
+}
+define noundef i32 @div_four(i32 noundef %x) {
+entry:
+  %t0 = ashr i32 %x, 31
+  %t1 = lshr i32 %t0, 30
+  %t2 = add i32 %x, %t1
+  %t3 = ashr i32 %t2, 2
+  ret i32 %t3
+}
+define noundef i32 @div_minus_two(i32 noundef %x) {
+entry:
+  %t0 = ashr i32 %x, 31
+  %t1 = lshr i32 %t0, 31
+  %t2 = add i32 %x, %t1
+  %t3 = ashr i32 %t2, 1
+  %t4 = sub i32 0, %t3
+  ret i32 %t4
+}
+define noundef i32 @div_seven(i32 noundef %x) {
+entry:
+  %t0 = sext i32 %x to i64
+  %t1 = mul i64 %t0, -1840700269
+  %t2 = ashr i64 %t1, 32
+  %t3 = trunc i64 %t2 to i32
+  %t4 = add i32 %t3, %x
+  %t5 = ashr i32 %t4, 2
+  %t6 = lshr i32 %t5, 31
+  %t7 = add i32 %t5, %t6
+  ret i32 %t7
+}
+define noundef i32 @div_minus_ten(i32 noundef %x) {
+entry:
+  %t0 = sext i32 %x to i64
+  %t1 = mul i64 %t0, -1717986919
+  %t2 = ashr i64 %t1, 32
+  %t3 = trunc i64 %t2 to i32
+  %t4 = ashr i32 %t3, 2
+  %t5 = lshr i32 %t4, 31
+  %t6 = add i32 %t4, %t5
+  ret i32 %t6
+}
+define noundef i32 @div_big(i32 noundef %x) {
+entry:
+  %t0 = sext i32 %x to i64
+  %t1 = mul i64 %t0, -2043174237
+  %t2 = ashr i64 %t1, 32
+  %t3 = trunc i64 %t2 to i32
+  %t4 = add i32 %t3, %x
+  %t5 = ashr i32 %t4, 19
+  %t6 = lshr i32 %t5, 31
+  %t7 = add i32 %t5, %t6
+  ret i32 %t7
+}
+define noundef i32 @mod_sixteen(i32 noundef %x) {
+entry:
+  %t0 = ashr i32 %x, 31
+  %t1 = lshr i32 %t0, 28
+  %t2 = add i32 %x, %t1
+  %t3 = and i32 %t2, -16
+  %t4 = sub i32 %x, %t3
+  ret i32 %t4
+}
+define noundef i32 @mod_minus_eight(i32 noundef %x) {
+entry:
+  %t0 = ashr i32 %x, 31
+  %t1 = lshr i32 %t0, 29
+  %t2 = add i32 %x, %t1
+  %t3 = and i32 %t2, -8
+  %t4 = sub i32 %x, %t3
+  ret i32 %t4
+}
+define noundef i32 @mod_ten(i32 noundef %x) {
+entry:
+  %t0 = sext i32 %x to i64
+  %t1 = mul i64 %t0, 1717986919
+  %t2 = ashr i64 %t1, 32
+  %t3 = trunc i64 %t2 to i32
+  %t4 = ashr i32 %t3, 2
+  %t5 = lshr i32 %t4, 31
+  %t6 = add i32 %t4, %t5
+  %t7 = mul i32 %t6, 10
+  %t8 = sub i32 %x, %t7
+  ret i32 %t8
+}
+define noundef i32 @mod_three(i32 noundef %x) {
+entry:
+  %t0 = sext i32 %x to i64
+  %t1 = mul i64 %t0, 1431655766
+  %t2 = ashr i64 %t1, 32
+  %t3 = trunc i64 %t2 to i32
+  %t4 = lshr i32 %t3, 31
+  %t5 = add i32 %t3, %t4
+  %t6 = mul i32 %t5, 3
+  %t7 = sub i32 %x, %t6
+  ret i32 %t7
+}
@@ -0,0 +1,208 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @dense(i32 noundef %n) {
+entry:
+  switch i32 %n, label %sw.default6 [
+    i32 0, label %sw.case0
+    i32 1, label %sw.case1
+    i32 2, label %sw.case2
+    i32 3, label %sw.case3
+    i32 4, label %sw.case4
+    i32 6, label %sw.case5
+  ]
+sw.case0:
+  ret i32 10
+sw.case1:
+  ret i32 11
+sw.case2:
+  ret i32 12
+sw.case3:
+  ret i32 13
+sw.case4:
+  ret i32 14
+sw.case5:
+  ret i32 16
+sw.default6:
+  ret i32 -1
+sw.end7:
+  ret i32 0
+}
+define noundef i32 @sparse(i32 noundef %n) {
+entry:
+  switch i32 %n, label %sw.end5 [
+    i32 -1000, label %sw.case0
+    i32 7, label %sw.case1
+    i32 100, label %sw.case2
+    i32 5000, label %sw.case3
+    i32 100000, label %sw.case4
+  ]
+sw.case0:
+  br label %sw.end5
+sw.case1:
+  br label %sw.end5
+sw.case2:
+  br label %sw.end5
+sw.case3:
+  br label %sw.end5
+sw.case4:
+  br label %sw.end5
+sw.end5:
+  %t2 = phi i32 [0, %entry], [1, %sw.case0], [2, %sw.case1], [3, %sw.case2], [4, %sw.case3], [5, %sw.case4]
+  ret i32 %t2
+}
+define noundef i32 @fallthrough(i32 noundef %n) {
+entry:
+  switch i32 %n, label %sw.default4 [
+    i32 1, label %sw.case0
+    i32 2, label %sw.case1
+    i32 3, label %sw.case2
+    i32 4, label %sw.case3
+  ]
+sw.case0:
+  %t2 = add nsw i32 0, 1
+  br label %sw.case1
+sw.case1:
+  %t14 = phi i32 [0, %entry], [%t2, %sw.case0]
+  %t4 = add nsw i32 %t14, 10
+  br label %sw.case2
+sw.case2:
+  %t12 = phi i32 [0, %entry], [%t4, %sw.case1]
+  br label %sw.case3
+sw.case3:
+  %t13 = phi i32 [0, %entry], [%t12, %sw.case2]
+  %t6 = add nsw i32 %t13, 100
+  br label %sw.end5
+sw.default4:
+  %t8 = sub nsw i32 0, 0
+  %t9 = sub nsw i32 %t8, 1
+  br label %sw.end5
+sw.end5:
+  %t11 = phi i32 [%t6, %sw.case3], [%t9, %sw.default4]
+  ret i32 %t11
+}
+define noundef i32 @apply(i32 noundef %op, i32 noundef %a, i32 noundef %b) {
+entry:
+  switch i32 %op, label %sw.end5 [
+    i32 1, label %sw.case0
+    i32 2, label %sw.case1
+    i32 3, label %sw.case2
+    i32 -1, label %sw.case3
+    i32 4, label %sw.case4
+  ]
+sw.case0:
+  %t0 = add nsw i32 %a, %b
+  ret i32 %t0
+sw.case1:
+  %t1 = sub nsw i32 %a, %b
+  ret i32 %t1
+sw.case2:
+  %t2 = mul nsw i32 %a, %b
+  ret i32 %t2
+sw.case3:
+  %t3 = sub nsw i32 0, %a
+  ret i32 %t3
+sw.case4:
+  %t4 = sdiv i32 %a, %b
+  ret i32 %t4
+sw.end5:
+  ret i32 0
+}
+define noundef i32 @classify_sum(i32 noundef %n) {
+entry:
+  br label %for.cond0
+for.cond0:
+  %t26 = phi i32 [0, %entry], [%t21, %for.inc2]
+  %t24 = phi i32 [0, %entry], [%t23, %for.inc2]
+  %t3 = icmp slt i32 %t26, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t5 = ashr i32 %t26, 31
+  %t6 = lshr i32 %t5, 28
+  %t7 = add i32 %t26, %t6
+  %t8 = and i32 %t7, -16
+  %t9 = sub i32 %t26, %t8
+  switch i32 %t9, label %sw.default15 [
+    i32 0, label %sw.case4
+    i32 1, label %sw.case5
+    i32 2, label %sw.case6
+    i32 3, label %sw.case7
+    i32 5, label %sw.case8
+    i32 7, label %sw.case9
+    i32 9, label %sw.case10
+    i32 4, label %sw.case11
+    i32 6, label %sw.case12
+    i32 8, label %sw.case13
+    i32 15, label %sw.case14
+  ]
+sw.case4:
+  br label %sw.case5
+sw.case5:
+  br label %sw.case6
+sw.case6:
+  %t11 = add nsw i32 %t24, 1
+  br label %sw.end16
+sw.case7:
+  br label %sw.case8
+sw.case8:
+  br label %sw.case9
+sw.case9:
+  br label %sw.case10
+sw.case10:
+  br label %for.inc2
+sw.case11:
+  br label %sw.case12
+sw.case12:
+  br label %sw.case13
+sw.case13:
+  %t13 = add nsw i32 %t24, 2
+  br label %sw.end16
+sw.case14:
+  %t15 = add nsw i32 %t24, 1000
+  br label %sw.end16
+sw.default15:
+  %t17 = add nsw i32 %t24, 5
+  br label %sw.end16
+sw.end16:
+  %t25 = phi i32 [%t11, %sw.case6], [%t13, %sw.case13], [%t15, %sw.case14], [%t17, %sw.default15]
+  %t19 = add nsw i32 %t25, 100
+  br label %for.inc2
+for.inc2:
+  %t23 = phi i32 [%t24, %sw.case10], [%t19, %sw.end16]
+  %t21 = add nsw i32 %t26, 1
+  br label %for.cond0
+for.end3:
+  ret i32 %t24
+}
+define noundef i32 @nested(i32 noundef %n) {
+entry:
+  switch i32 %n, label %sw.default2 [
+    i32 0, label %sw.case0
+    i32 1, label %sw.case1
+  ]
+sw.case0:
+  %t2 = icmp sgt i32 5, 2
+  br i1 %t2, label %if.then4, label %if.end5
+if.then4:
+  br label %sw.case1
+sw.case1:
+  %t11 = phi i32 [0, %entry], [5, %if.then4]
+  %t4 = add nsw i32 %t11, 1
+  br label %if.end5
+if.end5:
+  %t10 = phi i32 [5, %sw.case0], [%t4, %sw.case1]
+  br label %sw.end3
+sw.default2:
+  switch i32 %n, label %sw.end7 [
+    i32 2, label %sw.case6
+  ]
+sw.case6:
+  br label %sw.end7
+sw.end7:
+  %t9 = phi i32 [0, %sw.default2], [20, %sw.case6]
+  %t6 = add nsw i32 %t9, 7
+  br label %sw.end3
+sw.end3:
+  %t8 = phi i32 [%t10, %if.end5], [%t6, %sw.end7]
+  ret i32 %t8
+}
@@ -0,0 +1,214 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Range = type { i32, i32 }
+
+@days = global [12 x i32] [i32 31, i32 28, i32 31, i32 30, i32 31, i32 30, i32 31, i32 31, i32 30, i32 31, i32 30, i32 31]
+@digits = global [4 x i8] [i8 7, i8 3, i8 9, i8 1]
+@bounds = global [3 x i32] [i32 9, i32 99, i32 999]
+@limits = global %struct.Range { i32 0, i32 999 }
+@year_length = global i32 365
+@lengths = global [2 x i32*] [i32* @year_length, i32* null]
+define noundef i32 @days_before(i32 noundef %month) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  store i32 0, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !3
+  %t3 = icmp slt i32 %t2, %month
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t0, !tbaa !3
+  %t5 = getelementptr inbounds [12 x i32], [12 x i32]* @days, i32 0, i32 0
+  %t6 = load i32, i32* %t1, !tbaa !3
+  %t7 = getelementptr inbounds i32, i32* %t5, i32 %t6
+  %t8 = load i32, i32* %t7, !tbaa !3
+  %t9 = add nsw i32 %t4, %t8
+  store i32 %t9, i32* %t0, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t10 = load i32, i32* %t1, !tbaa !3
+  %t11 = add nsw i32 %t10, 1
+  store i32 %t11, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t12 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t12
+}
+define noundef i32 @digit_at(i32 noundef %index) {
+entry:
+  %t0 = getelementptr inbounds [4 x i8], [4 x i8]* @digits, i32 0, i32 0
+  %t1 = getelementptr inbounds i8, i8* %t0, i32 %index
+  %t2 = load i8, i8* %t1, !tbaa !4
+  %t3 = sext i8 %t2 to i32
+  ret i32 %t3
+}
+define noundef i32 @range_of(i32 noundef %value) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = getelementptr inbounds %struct.Range, %struct.Range* @limits, i32 0, i32 0
+  %t2 = load i32, i32* %t1, !tbaa !6
+  %t3 = icmp slt i32 %value, %t2
+  br i1 %t3, label %if.then0, label %logic.rhs2
+logic.rhs2:
+  %t4 = getelementptr inbounds %struct.Range, %struct.Range* @limits, i32 0, i32 1
+  %t5 = load i32, i32* %t4, !tbaa !7
+  %t6 = icmp sgt i32 %value, %t5
+  br i1 %t6, label %if.then0, label %if.end1
+if.then0:
+  ret i32 -1
+if.end1:
+  store i32 0, i32* %t0, !tbaa !3
+  br label %for.cond3
+for.cond3:
+  %t7 = load i32, i32* %t0, !tbaa !3
+  %t8 = icmp slt i32 %t7, 3
+  br i1 %t8, label %for.body4, label %for.end6
+for.body4:
+  %t9 = getelementptr inbounds [3 x i32], [3 x i32]* @bounds, i32 0, i32 0
+  %t10 = load i32, i32* %t0, !tbaa !3
+  %t11 = getelementptr inbounds i32, i32* %t9, i32 %t10
+  %t12 = load i32, i32* %t11, !tbaa !3
+  %t13 = icmp sle i32 %value, %t12
+  br i1 %t13, label %if.then7, label %if.end8
+if.then7:
+  %t14 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t14
+if.end8:
+  br label %for.inc5
+for.inc5:
+  %t15 = load i32, i32* %t0, !tbaa !3
+  %t16 = add nsw i32 %t15, 1
+  store i32 %t16, i32* %t0, !tbaa !3
+  br label %for.cond3
+for.end6:
+  ret i32 -1
+}
+@.const.weighted.0.weights = internal unnamed_addr constant [5 x i32] [i32 1, i32 2, i32 4, i32 8, i32 16]
+
+define noundef i32 @weighted(i32 noundef %value) {
+entry:
+  %t0 = alloca [5 x i32]
+  %t1 = bitcast [5 x i32]* %t0 to i8*
+  %t2 = bitcast [5 x i32]* @.const.weighted.0.weights to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %t1, i8* %t2, i64 20, i1 false)
+  %t3 = alloca i32
+  store i32 0, i32* %t3, !tbaa !3
+  %t4 = alloca i32
+  store i32 0, i32* %t4, !tbaa !3
+  store i32 0, i32* %t4, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t5 = load i32, i32* %t4, !tbaa !3
+  %t6 = icmp slt i32 %t5, 5
+  br i1 %t6, label %for.body1, label %for.end3
+for.body1:
+  %t7 = load i32, i32* %t3, !tbaa !3
+  %t8 = getelementptr inbounds [5 x i32], [5 x i32]* %t0, i32 0, i32 0
+  %t9 = load i32, i32* %t4, !tbaa !3
+  %t10 = getelementptr inbounds i32, i32* %t8, i32 %t9
+  %t11 = load i32, i32* %t10, !tbaa !3
+  %t12 = mul nsw i32 %t11, %value
+  %t13 = add nsw i32 %t7, %t12
+  store i32 %t13, i32* %t3, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t14 = load i32, i32* %t4, !tbaa !3
+  %t15 = add nsw i32 %t14, 1
+  store i32 %t15, i32* %t4, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t16 = load i32, i32* %t3, !tbaa !3
+  ret i32 %t16
+}
+define noundef i32 @window(i32 noundef %value) {
+entry:
+  %t0 = alloca [4 x i32]
+  %t1 = bitcast [4 x i32]* %t0 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t1, i8 0, i64 16, i1 false)
+  %t2 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  store i32 %value, i32* %t2, !tbaa !3
+  %t3 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 2
+  %t4 = shl nsw i32 %value, 1
+  store i32 %t4, i32* %t3, !tbaa !3
+  %t5 = alloca %struct.Range
+  %t6 = bitcast %struct.Range* %t5 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t6, i8 0, i64 8, i1 false)
+  %t7 = getelementptr inbounds %struct.Range, %struct.Range* %t5, i32 0, i32 0
+  store i32 %value, i32* %t7, !tbaa !6
+  %t8 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  %t9 = getelementptr inbounds i32, i32* %t8, i32 0
+  %t10 = load i32, i32* %t9, !tbaa !3
+  %t11 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  %t12 = getelementptr inbounds i32, i32* %t11, i32 1
+  %t13 = load i32, i32* %t12, !tbaa !3
+  %t14 = add nsw i32 %t10, %t13
+  %t15 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  %t16 = getelementptr inbounds i32, i32* %t15, i32 2
+  %t17 = load i32, i32* %t16, !tbaa !3
+  %t18 = add nsw i32 %t14, %t17
+  %t19 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  %t20 = getelementptr inbounds i32, i32* %t19, i32 3
+  %t21 = load i32, i32* %t20, !tbaa !3
+  %t22 = add nsw i32 %t18, %t21
+  %t23 = getelementptr inbounds %struct.Range, %struct.Range* %t5, i32 0, i32 0
+  %t24 = load i32, i32* %t23, !tbaa !6
+  %t25 = add nsw i32 %t22, %t24
+  %t26 = getelementptr inbounds %struct.Range, %struct.Range* %t5, i32 0, i32 1
+  %t27 = load i32, i32* %t26, !tbaa !7
+  %t28 = add nsw i32 %t25, %t27
+  ret i32 %t28
+}
+@.static.counted.0.counts = internal global [2 x i32] [i32 5, i32 6]
+
+define noundef i32 @counted() {
+entry:
+  %t0 = getelementptr inbounds [2 x i32], [2 x i32]* @.static.counted.0.counts, i32 0, i32 0
+  %t1 = getelementptr inbounds i32, i32* %t0, i32 0
+  %t2 = getelementptr inbounds [2 x i32], [2 x i32]* @.static.counted.0.counts, i32 0, i32 0
+  %t3 = getelementptr inbounds i32, i32* %t2, i32 0
+  %t4 = load i32, i32* %t3, !tbaa !3
+  %t5 = getelementptr inbounds [2 x i32], [2 x i32]* @.static.counted.0.counts, i32 0, i32 0
+  %t6 = getelementptr inbounds i32, i32* %t5, i32 1
+  %t7 = load i32, i32* %t6, !tbaa !3
+  %t8 = add nsw i32 %t4, %t7
+  store i32 %t8, i32* %t1, !tbaa !3
+  %t9 = getelementptr inbounds [2 x i32], [2 x i32]* @.static.counted.0.counts, i32 0, i32 0
+  %t10 = getelementptr inbounds i32, i32* %t9, i32 0
+  %t11 = load i32, i32* %t10, !tbaa !3
+  ret i32 %t11
+}
+define noundef i32 @year_days() {
+entry:
+  %t0 = getelementptr inbounds [2 x i32*], [2 x i32*]* @lengths, i32 0, i32 0
+  %t1 = getelementptr inbounds i32*, i32** %t0, i32 1
+  %t2 = load i32*, i32** %t1, !tbaa !9
+  %t3 = icmp ne i32* %t2, null
+  br i1 %t3, label %if.then0, label %if.end1
+if.then0:
+  ret i32 0
+if.end1:
+  %t4 = getelementptr inbounds [2 x i32*], [2 x i32*]* @lengths, i32 0, i32 0
+  %t5 = getelementptr inbounds i32*, i32** %t4, i32 0
+  %t6 = load i32*, i32** %t5, !tbaa !9
+  %t7 = load i32, i32* %t6, !tbaa !3
+  ret i32 %t7
+}
+declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* noalias nocapture writeonly, i8* noalias nocapture readonly, i64, i1 immarg)
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!1, !1, i64 0}
+!5 = !{!"Range", !2, i64 0, !2, i64 4}
+!6 = !{!5, !2, i64 0}
+!7 = !{!5, !2, i64 4}
+!8 = !{!"any pointer", !1, i64 0}
+!9 = !{!8, !8, i64 0}
@@ -0,0 +1,128 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @sum_down(i32 noundef %n, i32 noundef %total) {
+entry:
+  br label %tailrecurse
+tailrecurse:
+  %t14 = phi i32 [%n, %entry], [%t1, %if.end1]
+  %t15 = phi i32 [%total, %entry], [%t12, %if.end1]
+  %t0 = icmp ne i32 %t14, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  ret i32 %t15
+if.end1:
+  %t1 = sub nsw i32 %t14, 1
+  %t2 = add nsw i32 %t15, %t14
+  %t3 = sext i32 %t2 to i64
+  %t4 = mul i64 %t3, -2043174237
+  %t5 = ashr i64 %t4, 32
+  %t6 = trunc i64 %t5 to i32
+  %t7 = add i32 %t6, %t2
+  %t8 = ashr i32 %t7, 19
+  %t9 = lshr i32 %t8, 31
+  %t10 = add i32 %t8, %t9
+  %t11 = mul i32 %t10, 1000003
+  %t12 = sub i32 %t2, %t11
+  br label %tailrecurse
+}
+define noundef i32 @walk(i32 noundef %n, i32 noundef %acc) {
+entry:
+  %t0 = alloca i32
+  %t11 = alloca i32
+  br label %tailrecurse
+tailrecurse:
+  %t29 = phi i32 [%n, %entry], [%t24, %if.end1]
+  %t30 = phi i32 [%acc, %entry], [%t27, %if.end1]
+  %t1 = sext i32 %t29 to i64
+  %t2 = mul i64 %t1, -1840700269
+  %t3 = ashr i64 %t2, 32
+  %t4 = trunc i64 %t3 to i32
+  %t5 = add i32 %t4, %t29
+  %t6 = ashr i32 %t5, 2
+  %t7 = lshr i32 %t6, 31
+  %t8 = add i32 %t6, %t7
+  %t9 = mul i32 %t8, 7
+  %t10 = sub i32 %t29, %t9
+  store i32 %t10, i32* %t0, !tbaa !3
+  %t12 = sext i32 %t30 to i64
+  %t13 = mul i64 %t12, -2043174237
+  %t14 = ashr i64 %t13, 32
+  %t15 = trunc i64 %t14 to i32
+  %t16 = add i32 %t15, %t30
+  %t17 = ashr i32 %t16, 19
+  %t18 = lshr i32 %t17, 31
+  %t19 = add i32 %t17, %t18
+  %t20 = mul i32 %t19, 1000003
+  %t21 = sub i32 %t30, %t20
+  store i32 %t21, i32* %t11, !tbaa !3
+  %t22 = icmp ne i32 %t29, 0
+  br i1 %t22, label %if.end1, label %if.then0
+if.then0:
+  %t23 = load i32, i32* %t11, !tbaa !3
+  ret i32 %t23
+if.end1:
+  %t24 = sub nsw i32 %t29, 1
+  %t25 = load i32, i32* %t11, !tbaa !3
+  %t26 = load i32, i32* %t0, !tbaa !3
+  %t27 = add nsw i32 %t25, %t26
+  br label %tailrecurse
+}
+define noundef i32 @count_steps(i32 noundef %n, i32 noundef %steps) {
+entry:
+  br label %tailrecurse
+tailrecurse:
+  %t17 = phi i32 [%n, %entry], [%t10, %if.then2], [%t14, %if.end3]
+  %t18 = phi i32 [%steps, %entry], [%t11, %if.then2], [%t15, %if.end3]
+  %t0 = icmp eq i32 %t17, 1
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 %t18
+if.end1:
+  %t1 = ashr i32 %t17, 31
+  %t2 = lshr i32 %t1, 31
+  %t3 = add i32 %t17, %t2
+  %t4 = and i32 %t3, -2
+  %t5 = sub i32 %t17, %t4
+  %t6 = icmp eq i32 %t5, 0
+  br i1 %t6, label %if.then2, label %if.end3
+if.then2:
+  %t7 = ashr i32 %t17, 31
+  %t8 = lshr i32 %t7, 31
+  %t9 = add i32 %t17, %t8
+  %t10 = ashr i32 %t9, 1
+  %t11 = add nsw i32 %t18, 1
+  br label %tailrecurse
+if.end3:
+  %t13 = mul nsw i32 3, %t17
+  %t14 = add nsw i32 %t13, 1
+  %t15 = add nsw i32 %t18, 1
+  br label %tailrecurse
+}
+define noundef i32 @is_even(i32 noundef %n) {
+entry:
+  %t0 = icmp ne i32 %n, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = musttail call i32 @is_odd(i32 %t1)
+  ret i32 %t2
+}
+define noundef i32 @is_odd(i32 noundef %n) {
+entry:
+  %t0 = icmp ne i32 %n, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  ret i32 0
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = musttail call i32 @is_even(i32 %t1)
+  ret i32 %t2
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,4 @@
+#!/bin/sh
+# Stands in for LL_CC when run_codegen already wrote an object:
+# invoked as `copy_object.sh -c <input> -o <output>`.
+cp "$2" "$4"
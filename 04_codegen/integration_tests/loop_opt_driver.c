@@ -0,0 +1,31 @@
+#include <stdio.h>
+
+int set_scale(int value);
+int table_at(int index);
+int sum_scaled(int *values, int n, int k);
+int fill_table(int base);
+int column_sum(int *grid, int rows, int col);
+int count_below(int *values, int n, int limit);
+int bump_scale(int n);
+
+int main(void) {
+  int values[8] = {3, 1, 4, 1, 5, 9, 2, 6};
+  int grid[20];
+  int index = 0;
+  int result = 0;
+
+  for (index = 0; index < 20; index++) {
+    grid[index] = index * index;
+  }
+
+  set_scale(3);
+  printf("%d %d\n", sum_scaled(values, 8, 2), sum_scaled(values, 0, 2));
+  result = fill_table(10);
+  printf("%d %d\n", result, table_at(4));
+  printf("%d %d\n", column_sum(grid, 5, 1), column_sum(grid, 5, 3));
+  printf("%d %d\n", count_below(values, 8, 4), count_below(values, 8, 10));
+  /* The loop stores to scale, so its loads have to stay in the loop. */
+  result = bump_scale(4);
+  printf("%d %d\n", result, bump_scale(1));
+  return 0;
+}
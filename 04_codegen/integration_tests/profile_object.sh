@@ -0,0 +1,8 @@
+#!/bin/sh
+# Stands in for LL_CC when run_codegen wrote instrumented assembly:
+# assembles it and bundles it with the profile runtime into one
+# relocatable object. Invoked as `profile_object.sh -c <input> -o <output>`;
+# CC picks the compiler.
+${CC:-cc} -x assembler -c "$2" -o "$4.prog.o" &&
+  ld -r "$4.prog.o" ../build/ir_profile_runtime.o -o "$4" &&
+  rm -f "$4.prog.o"
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static char *read_file(const char *path) {
   FILE *file = fopen(path, "rb");
@@ -42,19 +43,82 @@ static char *read_file(const char *path) {
   return buffer;
 }
 
+static void print_usage(const char *program) {
+  fprintf(stderr,
+          "usage: %s [--no-poison-flags] [--optimize-linkage] [--pic] "
+          "[--no-strict-aliasing] "
+          "[--target=llvm|ir|x86_64-asm|x86_64-obj|bytecode|bytecode-c] "
+          "[--no-regalloc] [--no-superinstructions] [--passes=a,b,...] "
+          "[--inline-threshold=N] [--pass-stats] [--profile-generate] "
+          "[--profile-use=FILE] [--instrument-functions] [-g] "
+          "<input.c> <output>\n",
+          program);
+}
+
 int main(int argc, char **argv) {
   const char *input_path = NULL;
   const char *output_path = NULL;
   char *source = NULL;
+  CodegenOptions options;
   Codegen codegen;
+  int arg = 1;
+
+  codegen_options_init(&options);
+
+  for (; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (strcmp(argv[arg], "-g") == 0) {
+      options.debug_info = 1;
+    } else if (strcmp(argv[arg], "--no-poison-flags") == 0) {
+      options.poison_flags = 0;
+    } else if (strcmp(argv[arg], "--optimize-linkage") == 0) {
+      options.optimize_linkage = 1;
+    } else if (strcmp(argv[arg], "--pic") == 0) {
+      options.pic = 1;
+    } else if (strcmp(argv[arg], "--no-strict-aliasing") == 0) {
+      options.strict_aliasing = 0;
+    } else if (strcmp(argv[arg], "--target=llvm") == 0) {
+      options.target = CODEGEN_TARGET_LLVM;
+    } else if (strcmp(argv[arg], "--target=ir") == 0) {
+      options.target = CODEGEN_TARGET_IR;
+    } else if (strcmp(argv[arg], "--target=x86_64-asm") == 0) {
+      options.target = CODEGEN_TARGET_X86_64_ASM;
+    } else if (strcmp(argv[arg], "--target=x86_64-obj") == 0) {
+      options.target = CODEGEN_TARGET_X86_64_OBJ;
+    } else if (strcmp(argv[arg], "--target=bytecode") == 0) {
+      options.target = CODEGEN_TARGET_BYTECODE;
+    } else if (strcmp(argv[arg], "--target=bytecode-c") == 0) {
+      options.target = CODEGEN_TARGET_BYTECODE_C;
+    } else if (strcmp(argv[arg], "--no-regalloc") == 0) {
+      options.allocate_registers = 0;
+    } else if (strcmp(argv[arg], "--no-superinstructions") == 0) {
+      options.superinstructions = 0;
+    } else if (strncmp(argv[arg], "--passes=", 9) == 0) {
+      options.passes = argv[arg] + 9;
+    } else if (strncmp(argv[arg], "--inline-threshold=", 19) == 0) {
+      options.inline_threshold = atoi(argv[arg] + 19);
+    } else if (strcmp(argv[arg], "--pass-stats") == 0) {
+      options.pass_stats = stderr;
+    } else if (strcmp(argv[arg], "--profile-generate") == 0) {
+      options.profile_generate = 1;
+    } else if (strncmp(argv[arg], "--profile-use=", 14) == 0) {
+      options.profile_use = argv[arg] + 14;
+    } else if (strcmp(argv[arg], "--instrument-functions") == 0) {
+      options.instrument_functions = 1;
+    } else {
+      fprintf(stderr, "unknown option: %s\n", argv[arg]);
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
 
-  if (argc != 3) {
-    fprintf(stderr, "usage: %s <input.c> <output.ll>\n", argv[0]);
+  if (argc - arg != 2) {
+    print_usage(argv[0]);
     return 1;
   }
 
-  input_path = argv[1];
-  output_path = argv[2];
+  input_path = argv[arg];
+  output_path = argv[arg + 1];
+  options.source_name = input_path;
 
   source = read_file(input_path);
   if (!source) {
@@ -63,6 +127,7 @@ int main(int argc, char **argv) {
   }
 
   codegen_init(&codegen, source);
+  codegen.options = options;
   if (!codegen_emit(&codegen, output_path)) {
     fprintf(stderr, "codegen error: %s\n", codegen_error(&codegen));
     free(source);
@@ -0,0 +1,211 @@
+/* clock_gettime */
+#define _POSIX_C_SOURCE 200809L
+
+#include "codegen.h"
+#include "ir_vm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double elapsed_us(const struct timespec *start) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)(now.tv_sec - start->tv_sec) * 1e6 +
+         (double)(now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static char *read_file(const char *path, size_t *size_out) {
+  FILE *file = fopen(path, "rb");
+  char *buffer = NULL;
+  long size = 0;
+  size_t read_bytes = 0;
+
+  if (!file) {
+    return NULL;
+  }
+
+  if (fseek(file, 0, SEEK_END) != 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  size = ftell(file);
+  if (size < 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  if (fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  buffer = malloc((size_t)size + 1);
+  if (!buffer) {
+    fclose(file);
+    return NULL;
+  }
+
+  read_bytes = fread(buffer, 1, (size_t)size, file);
+  buffer[read_bytes] = '\0';
+
+  fclose(file);
+  *size_out = read_bytes;
+  return buffer;
+}
+
+static void print_usage(const char *program) {
+  fprintf(stderr,
+          "usage: %s [--entry=name] [--dump] [--time] [--profile] "
+          "[--no-quicken] [--no-superinstructions] [--jit-threshold=N] "
+          "<input.c|image> [integer args...]\n",
+          program);
+}
+
+/* Compiles C source, or loads an image written with --target=bytecode. */
+static int load_program(const char *source, size_t size, int superinstructions,
+                        IrVmProgram *program) {
+  const char *message = NULL;
+  Codegen codegen;
+
+  if (size >= 8 && memcmp(source, "BASECCVM", 8) == 0) {
+    if (!ir_vm_read_image(program, (const unsigned char *)source, size,
+                          &message)) {
+      fprintf(stderr, "%s\n", message);
+      return 0;
+    }
+    return 1;
+  }
+
+  codegen_init(&codegen, source);
+  codegen.options.superinstructions = superinstructions;
+  if (!codegen_compile_bytecode(&codegen, program)) {
+    fprintf(stderr, "codegen error: %s\n", codegen_error(&codegen));
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  const char *entry = "main";
+  int dump = 0;
+  int report_time = 0;
+  int quicken = 1;
+  int superinstructions = 1;
+  unsigned jit_threshold = IR_VM_JIT_THRESHOLD;
+  IrVmProfile *profile = NULL;
+  struct timespec start;
+  char *source = NULL;
+  size_t size = 0;
+  IrVmProgram program;
+  IrVm vm;
+  IrVmWord *args = NULL;
+  IrVmWord result = 0;
+  size_t function = 0;
+  size_t arg_count = 0;
+  size_t index = 0;
+  int arg = 1;
+  int status = 1;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+    if (strncmp(argv[arg], "--entry=", 8) == 0) {
+      entry = argv[arg] + 8;
+    } else if (strcmp(argv[arg], "--dump") == 0) {
+      dump = 1;
+    } else if (strcmp(argv[arg], "--time") == 0) {
+      report_time = 1;
+    } else if (strcmp(argv[arg], "--profile") == 0) {
+      profile = ir_vm_profile_create();
+      if (!profile) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+      }
+    } else if (strncmp(argv[arg], "--jit-threshold=", 16) == 0) {
+      jit_threshold = (unsigned)strtoul(argv[arg] + 16, NULL, 0);
+    } else if (strcmp(argv[arg], "--no-quicken") == 0) {
+      quicken = 0;
+    } else if (strcmp(argv[arg], "--no-superinstructions") == 0) {
+      superinstructions = 0;
+    } else {
+      fprintf(stderr, "unknown option: %s\n", argv[arg]);
+      print_usage(argv[0]);
+      ir_vm_profile_free(profile);
+      return 1;
+    }
+  }
+
+  if (arg >= argc) {
+    print_usage(argv[0]);
+    ir_vm_profile_free(profile);
+    return 1;
+  }
+
+  source = read_file(argv[arg], &size);
+  if (!source) {
+    fprintf(stderr, "failed to read %s\n", argv[arg]);
+    ir_vm_profile_free(profile);
+    return 1;
+  }
+  if (!load_program(source, size, superinstructions, &program)) {
+    free(source);
+    ir_vm_profile_free(profile);
+    return 1;
+  }
+  free(source);
+
+  if (dump) {
+    ir_vm_dump_program(&program, stdout);
+    ir_vm_program_free(&program);
+    ir_vm_profile_free(profile);
+    return 0;
+  }
+
+  if (!ir_vm_find_function(&program, entry, &function)) {
+    fprintf(stderr, "no function named %s\n", entry);
+    ir_vm_program_free(&program);
+    ir_vm_profile_free(profile);
+    return 1;
+  }
+
+  arg_count = (size_t)(argc - arg - 1);
+  args = malloc((arg_count + 1) * sizeof(*args));
+  if (!args) {
+    ir_vm_program_free(&program);
+    ir_vm_profile_free(profile);
+    return 1;
+  }
+  for (index = 0; index < arg_count; index++) {
+    args[index] = strtoll(argv[arg + 1 + (int)index], NULL, 0);
+  }
+
+  if (ir_vm_init(&vm, &program, NULL, NULL)) {
+    vm.quicken = quicken;
+    vm.jit_threshold = jit_threshold;
+    vm.profile = profile;
+    if (report_time) {
+      fprintf(stderr, "time to first instruction: %.0f us\n",
+              elapsed_us(&start));
+    }
+    if (ir_vm_call(&vm, function, args, arg_count, &result)) {
+      status = (int)(result & 0xff);
+    }
+  }
+  if (profile) {
+    fprintf(stderr, "dispatches: %llu\n", ir_vm_profile_dispatches(profile));
+    ir_vm_write_profile(profile, stdout);
+  }
+  if (ir_vm_error(&vm)) {
+    fprintf(stderr, "%s\n", ir_vm_error(&vm));
+  }
+
+  ir_vm_free(&vm);
+  ir_vm_program_free(&program);
+  ir_vm_profile_free(profile);
+  free(args);
+  return status;
+}
@@ -0,0 +1,63 @@
+#include <limits.h>
+#include <stdio.h>
+
+int times_eight(int x);
+int times_minus_four(int x);
+int div_four(int x);
+int div_minus_two(int x);
+int div_seven(int x);
+int div_minus_ten(int x);
+int div_big(int x);
+int mod_sixteen(int x);
+int mod_minus_eight(int x);
+int mod_ten(int x);
+int mod_three(int x);
+
+static int check(const char *name, int actual, int expected, int x) {
+  if (actual != expected) {
+    printf("%s(%d)=%d expected %d\n", name, x, actual, expected);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  int mismatches = 0;
+  long i;
+
+  for (i = 0; i < 200000; i++) {
+    int x;
+
+    if (i < 4096) {
+      x = (int)(i - 2048);
+    } else if (i == 4096) {
+      x = INT_MIN;
+    } else if (i == 4097) {
+      x = INT_MAX;
+    } else {
+      x = (int)(unsigned)(i * 2654435761u);
+    }
+
+    mismatches += check("times_eight", times_eight(x),
+                        (int)((unsigned)x * 8u), x);
+    mismatches += check("times_minus_four", times_minus_four(x),
+                        (int)((unsigned)x * (unsigned)-4), x);
+    mismatches += check("div_four", div_four(x), x / 4, x);
+    if (x != INT_MIN) {
+      mismatches += check("div_minus_two", div_minus_two(x), x / -2, x);
+    }
+    mismatches += check("div_seven", div_seven(x), x / 7, x);
+    mismatches += check("div_minus_ten", div_minus_ten(x), x / -10, x);
+    mismatches += check("div_big", div_big(x), x / 1000003, x);
+    mismatches += check("mod_sixteen", mod_sixteen(x), x % 16, x);
+    mismatches += check("mod_minus_eight", mod_minus_eight(x), x % -8, x);
+    mismatches += check("mod_ten", mod_ten(x), x % 10, x);
+    mismatches += check("mod_three", mod_three(x), x % 3, x);
+  }
+
+  printf("div_seven(-15)=%d\n", div_seven(-15));
+  printf("mod_ten(-123)=%d\n", mod_ten(-123));
+  printf("mod_sixteen(-33)=%d\n", mod_sixteen(-33));
+  printf("mismatches=%d\n", mismatches);
+  return 0;
+}
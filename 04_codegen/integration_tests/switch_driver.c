@@ -0,0 +1,28 @@
+#include <stdio.h>
+
+int dense(int n);
+int sparse(int n);
+int fallthrough(int n);
+int apply(int op, int a, int b);
+int classify_sum(int n);
+int nested(int n);
+
+int main(void) {
+  int n = 0;
+
+  for (n = -1; n <= 8; n++) {
+    printf("%d ", dense(n));
+  }
+  printf("\n");
+  printf("%d %d %d %d %d %d\n", sparse(-1000), sparse(7), sparse(100),
+         sparse(5000), sparse(100000), sparse(8));
+  for (n = 0; n <= 5; n++) {
+    printf("%d ", fallthrough(n));
+  }
+  printf("\n");
+  printf("%d %d %d %d %d %d\n", apply(1, 7, 3), apply(2, 7, 3),
+         apply(3, 7, 3), apply(-1, 7, 3), apply(4, 7, 3), apply(9, 7, 3));
+  printf("%d %d\n", classify_sum(10), classify_sum(40));
+  printf("%d %d %d %d\n", nested(0), nested(1), nested(2), nested(3));
+  return 0;
+}
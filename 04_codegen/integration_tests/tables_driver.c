@@ -0,0 +1,26 @@
+#include <stdio.h>
+
+int days_before(int month);
+int digit_at(int index);
+int range_of(int value);
+int weighted(int value);
+int window(int value);
+int counted(void);
+int year_days(void);
+
+int main(void) {
+  printf("days_before(0)=%d\n", days_before(0));
+  printf("days_before(3)=%d\n", days_before(3));
+  printf("days_before(12)=%d\n", days_before(12));
+  printf("digit_at(2)=%d\n", digit_at(2));
+  printf("range_of(5)=%d\n", range_of(5));
+  printf("range_of(42)=%d\n", range_of(42));
+  printf("range_of(500)=%d\n", range_of(500));
+  printf("range_of(5000)=%d\n", range_of(5000));
+  printf("weighted(3)=%d\n", weighted(3));
+  printf("window(4)=%d\n", window(4));
+  printf("counted()=%d\n", counted());
+  printf("counted()=%d\n", counted());
+  printf("year_days()=%d\n", year_days());
+  return 0;
+}
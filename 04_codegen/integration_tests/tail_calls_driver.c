@@ -0,0 +1,18 @@
+#include <stdio.h>
+
+int sum_down(int n, int total);
+int walk(int n, int acc);
+int count_steps(int n, int steps);
+int is_even(int n);
+int is_odd(int n);
+
+int main(void) {
+  /* Ten million frames would not fit the default stack without loops. */
+  printf("%d\n", sum_down(10000000, 0));
+  /* Its locals' slots must not be taken again on every trip. */
+  printf("%d\n", walk(10000000, 0));
+  printf("%d %d\n", count_steps(27, 0), count_steps(97, 0));
+  /* The bytecode VM runs these as plain calls, so keep them shallower. */
+  printf("%d %d\n", is_even(100000), is_odd(100001));
+  return 0;
+}
@@ -1,8 +1,8 @@
 int sum_down() {
   int sum = 0;
 
-  for (int i = 5; i; i = i - 1) {
-    sum = sum + i;
+  for (int i = 5; i; i--) {
+    sum += i;
   }
 
   return sum;
@@ -0,0 +1,56 @@
+int scale;
+int table[16];
+
+int set_scale(int value) {
+  scale = value;
+  return scale;
+}
+
+int table_at(int index) { return table[index]; }
+
+int sum_scaled(int *values, int n, int k) {
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    total = total + values[i] * (k * scale + 1);
+  }
+  return total;
+}
+
+int fill_table(int base) {
+  for (int i = 0; i < 16; i = i + 1) {
+    table[i] = base + i * scale;
+  }
+  return table[15];
+}
+
+int column_sum(int *grid, int rows, int col) {
+  int total = 0;
+
+  for (int row = 0; row < rows; row = row + 1) {
+    total = total + grid[row * 4 + col];
+  }
+  return total;
+}
+
+int count_below(int *values, int n, int limit) {
+  int i = 0;
+
+  while (i < n) {
+    if (values[i] > limit) {
+      break;
+    }
+    i = i + 1;
+  }
+  return i;
+}
+
+int bump_scale(int n) {
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    total = total + scale;
+    scale = scale + 1;
+  }
+  return total;
+}
@@ -0,0 +1,43 @@
+int times_eight(int x) {
+  return x * 8;
+}
+
+int times_minus_four(int x) {
+  return -4 * x;
+}
+
+int div_four(int x) {
+  return x / 4;
+}
+
+int div_minus_two(int x) {
+  return x / -2;
+}
+
+int div_seven(int x) {
+  return x / 7;
+}
+
+int div_minus_ten(int x) {
+  return x / -10;
+}
+
+int div_big(int x) {
+  return x / 1000003;
+}
+
+int mod_sixteen(int x) {
+  return x % 16;
+}
+
+int mod_minus_eight(int x) {
+  return x % -8;
+}
+
+int mod_ten(int x) {
+  return x % 10;
+}
+
+int mod_three(int x) {
+  return x % 3;
+}
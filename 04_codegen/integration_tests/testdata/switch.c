@@ -0,0 +1,131 @@
+enum Op { OP_ADD = 1, OP_SUB, OP_MUL, OP_NEG = -1 };
+
+int dense(int n) {
+  switch (n) {
+  case 0:
+    return 10;
+  case 1:
+    return 11;
+  case 2:
+    return 12;
+  case 3:
+    return 13;
+  case 4:
+    return 14;
+  case 6:
+    return 16;
+  default:
+    return -1;
+  }
+}
+
+int sparse(int n) {
+  int result = 0;
+
+  switch (n) {
+  case -1000:
+    result = 1;
+    break;
+  case 7:
+    result = 2;
+    break;
+  case 100:
+    result = 3;
+    break;
+  case 5000:
+    result = 4;
+    break;
+  case 100000:
+    result = 5;
+    break;
+  }
+  return result;
+}
+
+int fallthrough(int n) {
+  int total = 0;
+
+  switch (n) {
+  case 1:
+    total = total + 1;
+  case 2:
+    total = total + 10;
+  case 3:
+  case 4:
+    total = total + 100;
+    break;
+  default:
+    total = -total - 1;
+  }
+  return total;
+}
+
+int apply(int op, int a, int b) {
+  switch (op) {
+  case OP_ADD:
+    return a + b;
+  case OP_SUB:
+    return a - b;
+  case OP_MUL:
+    return a * b;
+  case OP_NEG:
+    return -a;
+  case OP_MUL + 1:
+    return a / b;
+  }
+  return 0;
+}
+
+int classify_sum(int n) {
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    switch (i % 16) {
+    case 0:
+    case 1:
+    case 2:
+      total = total + 1;
+      break;
+    case 3:
+    case 5:
+    case 7:
+    case 9:
+      continue;
+    case 4:
+    case 6:
+    case 8:
+      total = total + 2;
+      break;
+    case 15:
+      total = total + 1000;
+      break;
+    default:
+      total = total + 5;
+    }
+    total = total + 100;
+  }
+  return total;
+}
+
+int nested(int n) {
+  int count = 0;
+
+  switch (n) {
+  case 0:
+    count = 5;
+    if (count > 2) {
+    case 1:
+      count = count + 1;
+    }
+    break;
+  default: {
+    switch (n) {
+    case 2:
+      count = 20;
+      break;
+    }
+    count = count + 7;
+  }
+  }
+  return count;
+}
@@ -0,0 +1,71 @@
+struct Range {
+  int low;
+  int high;
+};
+
+int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+const char digits[] = {7, 3, 9, 1};
+int bounds[3] = {9, 99, 999};
+struct Range limits = {0, 999};
+int year_length = 365;
+int *lengths[2] = {&year_length, 0};
+
+int days_before(int month) {
+  int total = 0;
+  int index = 0;
+
+  for (index = 0; index < month; index = index + 1) {
+    total = total + days[index];
+  }
+  return total;
+}
+
+int digit_at(int index) {
+  return digits[index];
+}
+
+int range_of(int value) {
+  int index = 0;
+
+  if (value < limits.low || value > limits.high) {
+    return -1;
+  }
+  for (index = 0; index < 3; index = index + 1) {
+    if (value <= bounds[index]) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+int weighted(int value) {
+  int weights[5] = {1, 2, 4, 8, 16};
+  int total = 0;
+  int index = 0;
+
+  for (index = 0; index < 5; index = index + 1) {
+    total = total + weights[index] * value;
+  }
+  return total;
+}
+
+int window(int value) {
+  int cells[4] = {value, 0, value * 2};
+  struct Range range = {value, 0};
+
+  return cells[0] + cells[1] + cells[2] + cells[3] + range.low + range.high;
+}
+
+int counted() {
+  static int counts[2] = {5, 6};
+
+  counts[0] = counts[0] + counts[1];
+  return counts[0];
+}
+
+int year_days() {
+  if (lengths[1]) {
+    return 0;
+  }
+  return *lengths[0];
+}
@@ -0,0 +1,48 @@
+extern int is_odd(int n);
+
+int sum_down(int n, int total) {
+  if (!n) {
+    return total;
+  }
+
+  return sum_down(n - 1, (total + n) % 1000003);
+}
+
+int walk(int n, int acc) {
+  int a = n % 7;
+  int b = acc % 1000003;
+
+  if (!n) {
+    return b;
+  }
+
+  return walk(n - 1, b + a);
+}
+
+int count_steps(int n, int steps) {
+  if (n == 1) {
+    return steps;
+  }
+
+  if (n % 2 == 0) {
+    return count_steps(n / 2, steps + 1);
+  }
+
+  return count_steps(3 * n + 1, steps + 1);
+}
+
+int is_even(int n) {
+  if (!n) {
+    return 1;
+  }
+
+  return is_odd(n - 1);
+}
+
+int is_odd(int n) {
+  if (!n) {
+    return 0;
+  }
+
+  return is_even(n - 1);
+}
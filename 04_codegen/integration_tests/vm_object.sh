@@ -0,0 +1,8 @@
+#!/bin/sh
+# Stands in for LL_CC when run_codegen wrote bytecode-c: compiles the host
+# source and bundles it with the VM runtime into one relocatable object.
+# Invoked as `vm_object.sh -c <input> -o <output>`; CC picks the compiler.
+${CC:-cc} -std=c11 -O2 -I../include -x c -c "$2" -o "$4.host.o" &&
+  ld -r "$4.host.o" ../build/ir_vm.o ../build/ir_jit.o \
+    ../build/ir_x86_encode.o -o "$4" &&
+  rm -f "$4.host.o"
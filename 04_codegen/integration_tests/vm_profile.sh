@@ -0,0 +1,30 @@
+#!/bin/sh
+# Runs the integration programs in the VM with profiling on and prints the
+# total dispatches and the hottest straight-line runs of two and three
+# opcodes, the candidates for superinstructions. Arguments are passed on
+# to run_codegen, e.g. --no-superinstructions to profile the plain
+# bytecode. MAKE and CC pick the tools.
+set -e
+
+profile="$(pwd)/build/vm_profile.txt"
+${MAKE:-make} clean
+mkdir -p build
+BASECC_VM_PROFILE="$profile" ${MAKE:-make} verify \
+  CODEGEN_FLAGS="--target=bytecode-c $*" LL_CC="CC=${CC:-cc} sh vm_object.sh"
+
+# Sum the counts every program appended, keyed by n and the opcodes.
+awk '{
+  key = $2
+  for (i = 3; i <= NF; i++) key = key " " $i
+  count[NF - 1 " " key] += $1
+} END {
+  for (key in count) print key, count[key]
+}' "$profile" > "$profile.sum"
+
+awk '$1 == 1 { total += $NF } END { printf "dispatches: %.0f\n", total }' \
+  "$profile.sum"
+for n in 2 3; do
+  echo "hottest runs of $n:"
+  awk -v n="$n" '$1 == n { $1 = ""; print $NF "\t" $0 }' "$profile.sum" |
+    sort -nr | head -n 12 | awk -F '\t' '{ sub(/ [0-9]+$/, "", $2); print $1 $2 }'
+done
@@ -1,5 +1,12 @@
 #include "codegen.h"
-
+#include "ir.h"
+#include "ir_bytecode.h"
+#include "ir_llvm.h"
+#include "ir_pass.h"
+#include "ir_profile.h"
+#include "ir_x86.h"
+
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,13 +18,12 @@ typedef struct EnumSymbol {
 
 typedef struct FunctionContext {
   Codegen *codegen;
-  FILE *out;
+  IrModule *module;
+  IrFunction *function;
+  IrBuilder builder;
   int next_label_id;
-  int next_temp_id;
-  char return_type[32];
-  int return_width;
-  int return_pointer_depth;
   Token return_type_token;
+  int return_pointer_depth;
   int return_is_const;
   Token function_name;
   const struct GlobalSymbol *globals;
@@ -40,14 +46,24 @@ typedef struct FunctionContext {
   struct LoopContext *loop_stack;
   size_t loop_depth;
   size_t loop_capacity;
+  /* The case and default labels of the switches being emitted. */
+  struct SwitchLabel *switch_labels;
+  size_t switch_label_count;
+  size_t switch_label_capacity;
   size_t static_local_index;
 } FunctionContext;
 
 typedef struct LoopContext {
-  char break_label[32];
-  char continue_label[32];
+  IrBlock *break_block;
+  IrBlock *continue_block;
 } LoopContext;
 
+typedef struct SwitchLabel {
+  const ParserNode *node;
+  IrBlock *block;
+  long long value;
+} SwitchLabel;
+
 typedef struct TypeInfo {
   const char *ir_name;
   int width;
@@ -73,6 +89,7 @@ typedef struct GlobalSymbol {
   int pointer_depth;
   int is_const;
   size_t array_length;
+  int address_taken;
 } GlobalSymbol;
 
 typedef struct FunctionSymbol {
@@ -83,6 +100,9 @@ typedef struct FunctionSymbol {
   int is_const;
   const ParserNode *param_list;
   size_t param_count;
+  const ParserNode *body;
+  int is_internal;
+  int referenced;
 } FunctionSymbol;
 
 typedef struct LocalSymbol {
@@ -92,7 +112,7 @@ typedef struct LocalSymbol {
   int pointer_depth;
   int is_const;
   size_t array_length;
-  char ir_name[128];
+  IrValue *address;
 } LocalSymbol;
 
 typedef struct TypedefSymbol {
@@ -104,7 +124,7 @@ typedef struct TypedefSymbol {
 
 typedef struct StaticLocalContext {
   Codegen *codegen;
-  FILE *out;
+  IrModule *module;
   Token function_name;
   const GlobalSymbol *globals;
   size_t global_count;
@@ -114,11 +134,55 @@ typedef struct StaticLocalContext {
   size_t typedef_count;
   const EnumSymbol *enums;
   size_t enum_count;
+  const ParserNode *body;
   size_t index;
 } StaticLocalContext;
 
+/* What a constant initializer can name: enumerators and global addresses. */
+typedef struct ConstantScope {
+  Codegen *codegen;
+  IrModule *module;
+  const GlobalSymbol *globals;
+  size_t global_count;
+  const StructSymbol *structs;
+  size_t struct_count;
+  const TypedefSymbol *typedefs;
+  size_t typedef_count;
+  const EnumSymbol *enums;
+  size_t enum_count;
+} ConstantScope;
+
 static int codegen_set_error(Codegen *codegen, const char *message);
 
+static unsigned codegen_nsw(const FunctionContext *ctx) {
+  return ctx->codegen->options.poison_flags ? IR_FLAG_NSW : 0;
+}
+
+static unsigned codegen_inbounds(const FunctionContext *ctx) {
+  return ctx->codegen->options.poison_flags ? IR_FLAG_INBOUNDS : 0;
+}
+
+/*
+ * Sets the linkage, address significance, and kind of a data definition,
+ * e.g. "internal unnamed_addr constant" or "global".
+ */
+static void codegen_apply_data_linkage(const Codegen *codegen,
+                                       IrGlobal *global, int is_internal,
+                                       int is_constant, int address_taken) {
+  global->linkage = is_internal ? IR_LINKAGE_INTERNAL : IR_LINKAGE_EXTERNAL;
+
+  if (!codegen->options.optimize_linkage) {
+    return;
+  }
+
+  global->dso_local = !is_internal && !codegen->options.pic;
+  if (!address_taken) {
+    global->unnamed_addr =
+      is_internal ? IR_UNNAMED_ADDR_GLOBAL : IR_UNNAMED_ADDR_LOCAL;
+  }
+  global->is_constant = is_constant;
+}
+
 static int token_is_punct(Token token, const char *text) {
   size_t length = strlen(text);
 
@@ -175,38 +239,28 @@ static TypeDesc codegen_int_type_desc(void) {
   return desc;
 }
 
-static void codegen_format_type(Token token, int pointer_depth, char *buffer,
-                                size_t buffer_size) {
-  size_t length = 0;
+static IrType *codegen_lower_type(IrModule *module, TypeDesc desc) {
+  IrType *type = NULL;
   int i = 0;
 
-  if (token.type == TOKEN_STRUCT) {
-    snprintf(buffer, buffer_size, "%%struct.%.*s", (int)token.length,
-             token.start);
+  if (desc.type_token.type == TOKEN_STRUCT) {
+    type = ir_type_struct(module, desc.type_token.start,
+                          desc.type_token.length);
   } else {
-    TypeInfo info = codegen_type_info(token);
-
-    snprintf(buffer, buffer_size, "%s", info.ir_name);
+    type = ir_type_int(module, codegen_type_info(desc.type_token).width);
   }
-  length = strlen(buffer);
 
-  for (i = 0; i < pointer_depth && length + 1 < buffer_size; i++) {
-    buffer[length++] = '*';
-    buffer[length] = '\0';
+  for (i = 0; i < desc.pointer_depth; i++) {
+    type = ir_type_pointer(module, type);
   }
-}
 
-static void codegen_format_desc_type(TypeDesc desc, char *buffer,
-                                     size_t buffer_size) {
-  codegen_format_type(desc.type_token, desc.pointer_depth, buffer, buffer_size);
+  return type;
 }
 
-static void codegen_format_array_type(TypeDesc element_type, size_t length,
-                                      char *buffer, size_t buffer_size) {
-  char element_name[32];
-
-  codegen_format_desc_type(element_type, element_name, sizeof(element_name));
-  snprintf(buffer, buffer_size, "[%zu x %s]", length, element_name);
+static IrType *codegen_lower_array_type(IrModule *module,
+                                        TypeDesc element_type, size_t length) {
+  return ir_type_array(module, codegen_lower_type(module, element_type),
+                       length);
 }
 
 static int codegen_type_is_integer(TypeDesc desc) {
@@ -225,24 +279,32 @@ static int codegen_integer_width(TypeDesc desc) {
   return info.width;
 }
 
-static int codegen_emit_condition_bool(FunctionContext *ctx,
-                                       TypeDesc condition_type,
-                                       const char *condition_value,
-                                       char *bool_value, size_t bool_size) {
-  if (codegen_type_is_integer(condition_type)) {
-    snprintf(bool_value, bool_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = icmp ne i32 %s, 0\n", bool_value,
-            condition_value);
-    return 1;
+static IrValue *codegen_i32(FunctionContext *ctx, long long constant) {
+  return ir_const_int(ctx->module, ir_type_int(ctx->module, 32), constant);
+}
+
+/* The zero of an integer or pointer value's type, for truth tests. */
+static IrValue *codegen_zero_of(FunctionContext *ctx, const IrValue *value) {
+  if (!value) {
+    return NULL;
+  }
+
+  if (value->type->kind == IR_TYPE_POINTER) {
+    return ir_const_null(ctx->module, value->type);
   }
 
-  if (condition_type.pointer_depth > 0) {
-    char type_name[32];
+  return ir_const_int(ctx->module, value->type, 0);
+}
 
-    codegen_format_desc_type(condition_type, type_name, sizeof(type_name));
-    snprintf(bool_value, bool_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = icmp ne %s %s, null\n", bool_value, type_name,
-            condition_value);
+static int codegen_emit_condition_bool(FunctionContext *ctx,
+                                       TypeDesc condition_type,
+                                       IrValue *condition_value,
+                                       IrValue **bool_value) {
+  if (codegen_type_is_integer(condition_type) ||
+      condition_type.pointer_depth > 0) {
+    *bool_value =
+      ir_build_icmp(&ctx->builder, IR_PRED_NE, condition_value,
+                    codegen_zero_of(ctx, condition_value));
     return 1;
   }
 
@@ -255,13 +317,10 @@ static int codegen_is_null_pointer_literal(const ParserNode *node) {
 }
 
 static int codegen_emit_integer_cast(FunctionContext *ctx, TypeDesc from,
-                                     TypeDesc to, char *value,
-                                     size_t value_size) {
+                                     TypeDesc to, IrValue **value) {
   int from_width = codegen_integer_width(from);
   int to_width = codegen_integer_width(to);
-  char from_type[32];
-  char to_type[32];
-  char cast_value[32];
+  IrType *to_type = NULL;
 
   if (from_width == 0 || to_width == 0) {
     return codegen_set_error(ctx->codegen, "codegen: expected integer cast");
@@ -271,19 +330,243 @@ static int codegen_emit_integer_cast(FunctionContext *ctx, TypeDesc from,
     return 1;
   }
 
-  codegen_format_desc_type(from, from_type, sizeof(from_type));
-  codegen_format_desc_type(to, to_type, sizeof(to_type));
-  snprintf(cast_value, sizeof(cast_value), "%%t%d", ctx->next_temp_id++);
+  to_type = ir_type_int(ctx->module, to_width);
+  *value = ir_build_cast(&ctx->builder,
+                         from_width > to_width ? IR_OP_TRUNC : IR_OP_SEXT,
+                         *value, to_type);
+  return 1;
+}
+
+static int codegen_constant_value(const IrValue *value, long *constant) {
+  long long parsed;
+
+  if (!ir_value_is_const_int(value, &parsed) ||
+      !ir_type_is_int(value->type, 32) || parsed < INT32_MIN ||
+      parsed > INT32_MAX) {
+    return 0;
+  }
+
+  *constant = (long)parsed;
+  return 1;
+}
+
+static int codegen_power_of_two_shift(uint32_t magnitude) {
+  int shift = 0;
+
+  if (magnitude == 0 || (magnitude & (magnitude - 1)) != 0) {
+    return -1;
+  }
+
+  while ((magnitude >> shift) != 1) {
+    shift++;
+  }
+
+  return shift;
+}
+
+/* Hacker's Delight 10-1: multiplier and shift for signed 32-bit division. */
+static void codegen_signed_magic(int32_t divisor, int32_t *multiplier,
+                                 int *shift) {
+  const uint32_t two31 = 0x80000000u;
+  uint32_t magnitude =
+      divisor < 0 ? (uint32_t)0 - (uint32_t)divisor : (uint32_t)divisor;
+  uint32_t t = two31 + ((uint32_t)divisor >> 31);
+  uint32_t anc = t - 1 - t % magnitude;
+  uint32_t q1 = two31 / anc;
+  uint32_t r1 = two31 - q1 * anc;
+  uint32_t q2 = two31 / magnitude;
+  uint32_t r2 = two31 - q2 * magnitude;
+  uint32_t delta;
+  uint32_t result;
+  int p = 31;
+
+  do {
+    p++;
+    q1 *= 2;
+    r1 *= 2;
+    if (r1 >= anc) {
+      q1++;
+      r1 -= anc;
+    }
+    q2 *= 2;
+    r2 *= 2;
+    if (r2 >= magnitude) {
+      q2++;
+      r2 -= magnitude;
+    }
+    delta = magnitude - r2;
+  } while (q1 < delta || (q1 == delta && r1 == 0));
+
+  result = q2 + 1;
+  if (divisor < 0) {
+    result = (uint32_t)0 - result;
+  }
+
+  *multiplier = (int32_t)result;
+  *shift = p - 32;
+}
+
+static IrValue *codegen_emit_i32_binary(FunctionContext *ctx, IrOpcode opcode,
+                                        unsigned flags, IrValue *left,
+                                        IrValue *right) {
+  return ir_build_binary(&ctx->builder, opcode, flags, left, right);
+}
+
+/* Signed division by +/-2^shift: bias negative dividends toward zero. */
+static IrValue *codegen_emit_sdiv_pow2(FunctionContext *ctx, IrValue *dividend,
+                                       int shift, int negate) {
+  IrValue *result = dividend;
+
+  if (shift > 0) {
+    IrValue *sign = codegen_emit_i32_binary(ctx, IR_OP_ASHR, 0, dividend,
+                                            codegen_i32(ctx, 31));
+    IrValue *bias = codegen_emit_i32_binary(ctx, IR_OP_LSHR, 0, sign,
+                                            codegen_i32(ctx, 32 - shift));
+    IrValue *biased =
+      codegen_emit_i32_binary(ctx, IR_OP_ADD, 0, dividend, bias);
+
+    result = codegen_emit_i32_binary(ctx, IR_OP_ASHR, 0, biased,
+                                     codegen_i32(ctx, shift));
+  }
+
+  if (negate) {
+    result =
+      codegen_emit_i32_binary(ctx, IR_OP_SUB, 0, codegen_i32(ctx, 0), result);
+  }
+
+  return result;
+}
+
+static IrValue *codegen_emit_sdiv_magic(FunctionContext *ctx,
+                                        IrValue *dividend, int32_t divisor) {
+  IrType *i64 = ir_type_int(ctx->module, 64);
+  int32_t multiplier;
+  int shift;
+  IrValue *wide;
+  IrValue *product;
+  IrValue *high;
+  IrValue *quotient;
+  IrValue *sign;
+
+  codegen_signed_magic(divisor, &multiplier, &shift);
+
+  wide = ir_build_cast(&ctx->builder, IR_OP_SEXT, dividend, i64);
+  product = ir_build_binary(&ctx->builder, IR_OP_MUL, 0, wide,
+                            ir_const_int(ctx->module, i64, multiplier));
+  high = ir_build_binary(&ctx->builder, IR_OP_ASHR, 0, product,
+                         ir_const_int(ctx->module, i64, 32));
+  quotient = ir_build_cast(&ctx->builder, IR_OP_TRUNC, high,
+                           ir_type_int(ctx->module, 32));
+
+  if (divisor > 0 && multiplier < 0) {
+    quotient = codegen_emit_i32_binary(ctx, IR_OP_ADD, 0, quotient, dividend);
+  } else if (divisor < 0 && multiplier > 0) {
+    quotient = codegen_emit_i32_binary(ctx, IR_OP_SUB, 0, quotient, dividend);
+  }
+
+  if (shift > 0) {
+    quotient = codegen_emit_i32_binary(ctx, IR_OP_ASHR, 0, quotient,
+                                       codegen_i32(ctx, shift));
+  }
+
+  sign = codegen_emit_i32_binary(ctx, IR_OP_LSHR, 0, quotient,
+                                 codegen_i32(ctx, 31));
+  return codegen_emit_i32_binary(ctx, IR_OP_ADD, 0, quotient, sign);
+}
 
-  if (from_width > to_width) {
-    fprintf(ctx->out, "  %s = trunc %s %s to %s\n", cast_value, from_type,
-            value, to_type);
+/*
+ * Rewrites mul/sdiv/srem with a constant operand into shifts, masks, and
+ * multiply-high sequences. Returns 0 when the operation is left untouched.
+ */
+static int codegen_emit_strength_reduced(FunctionContext *ctx,
+                                         IrOpcode opcode, IrValue *left_value,
+                                         IrValue *right_value,
+                                         IrValue **value) {
+  IrValue *operand = left_value;
+  IrValue *product;
+  long constant;
+  int32_t divisor;
+  uint32_t magnitude;
+  int shift;
+
+  if (codegen_constant_value(right_value, &constant)) {
+    if (codegen_constant_value(left_value, &constant)) {
+      return 0;
+    }
+    codegen_constant_value(right_value, &constant);
+  } else if (opcode == IR_OP_MUL &&
+             codegen_constant_value(left_value, &constant)) {
+    operand = right_value;
   } else {
-    fprintf(ctx->out, "  %s = sext %s %s to %s\n", cast_value, from_type, value,
-            to_type);
+    return 0;
+  }
+
+  divisor = (int32_t)constant;
+  magnitude = divisor < 0 ? (uint32_t)0 - (uint32_t)divisor : (uint32_t)divisor;
+  shift = codegen_power_of_two_shift(magnitude);
+
+  if (opcode == IR_OP_MUL) {
+    IrValue *scaled = operand;
+
+    if (divisor == 0) {
+      *value = codegen_i32(ctx, 0);
+      return 1;
+    }
+    if (shift < 0 || divisor == INT32_MIN) {
+      return 0;
+    }
+    if (shift > 0) {
+      scaled = codegen_emit_i32_binary(ctx, IR_OP_SHL, codegen_nsw(ctx),
+                                       operand, codegen_i32(ctx, shift));
+    }
+    if (divisor < 0) {
+      scaled = codegen_emit_i32_binary(ctx, IR_OP_SUB, codegen_nsw(ctx),
+                                       codegen_i32(ctx, 0), scaled);
+    }
+    *value = scaled;
+    return 1;
+  }
+
+  if (divisor == 0 || divisor == INT32_MIN) {
+    return 0;
+  }
+
+  if (opcode == IR_OP_SDIV) {
+    if (shift >= 0) {
+      *value = codegen_emit_sdiv_pow2(ctx, operand, shift, divisor < 0);
+    } else {
+      *value = codegen_emit_sdiv_magic(ctx, operand, divisor);
+    }
+    return 1;
+  }
+
+  if (opcode != IR_OP_SREM) {
+    return 0;
+  }
+
+  if (shift == 0) {
+    *value = codegen_i32(ctx, 0);
+    return 1;
   }
 
-  snprintf(value, value_size, "%s", cast_value);
+  /* x % d == x - (x / d) * d; the sign of d does not affect the result. */
+  if (shift > 0) {
+    IrValue *sign = codegen_emit_i32_binary(ctx, IR_OP_ASHR, 0, operand,
+                                            codegen_i32(ctx, 31));
+    IrValue *bias = codegen_emit_i32_binary(ctx, IR_OP_LSHR, 0, sign,
+                                            codegen_i32(ctx, 32 - shift));
+    IrValue *biased =
+      codegen_emit_i32_binary(ctx, IR_OP_ADD, 0, operand, bias);
+
+    product =
+      codegen_emit_i32_binary(ctx, IR_OP_AND, 0, biased,
+                              codegen_i32(ctx, -(int32_t)(1u << shift)));
+  } else {
+    IrValue *quotient = codegen_emit_sdiv_magic(ctx, operand, divisor);
+
+    product = codegen_emit_i32_binary(ctx, IR_OP_MUL, 0, quotient, right_value);
+  }
+  *value = codegen_emit_i32_binary(ctx, IR_OP_SUB, 0, operand, product);
   return 1;
 }
 
@@ -303,27 +586,26 @@ static const GlobalSymbol *codegen_find_global(const FunctionContext *ctx,
                                                Token name);
 static const LocalSymbol *codegen_find_local(const FunctionContext *ctx,
                                              Token name);
+static IrValue *codegen_global_address(FunctionContext *ctx, Token name);
 static int codegen_expression_type(FunctionContext *ctx, const ParserNode *node,
                                    TypeDesc *type_out);
 static int codegen_resolve_member_type(FunctionContext *ctx,
                                        const ParserNode *node,
                                        TypeDesc *field_type_out);
 static int codegen_emit_sizeof_type(FunctionContext *ctx, TypeDesc target_type,
-                                    char *value, size_t value_size);
+                                    IrValue **value);
 static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
-                                   char *value, size_t value_size,
-                                   TypeDesc *type_out);
+                                   IrValue **value, TypeDesc *type_out);
 static int codegen_emit_member_pointer(FunctionContext *ctx,
                                        const ParserNode *node,
-                                       char *pointer_value, size_t pointer_size,
+                                       IrValue **pointer_value,
                                        TypeDesc *field_type_out);
 static int codegen_emit_array_decay(FunctionContext *ctx, TypeDesc element_type,
-                                    size_t length, const char *base_value,
-                                    char *value, size_t value_size,
-                                    TypeDesc *type_out);
+                                    size_t length, IrValue *base_value,
+                                    IrValue **value, TypeDesc *type_out);
 static int codegen_emit_index_pointer(FunctionContext *ctx,
                                       const ParserNode *node,
-                                      char *pointer_value, size_t pointer_size,
+                                      IrValue **pointer_value,
                                       TypeDesc *element_type_out);
 
 static int codegen_emit_struct_definition(Codegen *codegen,
@@ -331,20 +613,28 @@ static int codegen_emit_struct_definition(Codegen *codegen,
                                           const StructSymbol *structs,
                                           size_t struct_count,
                                           const TypedefSymbol *typedefs,
-                                          size_t typedef_count, FILE *out) {
+                                          size_t typedef_count,
+                                          IrModule *module) {
   const ParserNode *field = NULL;
-  int first = 1;
+  IrType *type = NULL;
+  IrType **fields = NULL;
+  size_t field_count = 0;
   Token self_token;
+  int result = 0;
 
   self_token.type = TOKEN_STRUCT;
   self_token.start = symbol->name;
   self_token.length = symbol->length;
   self_token.value = 0;
 
-  fprintf(out, "%%struct.%.*s = type { ", (int)symbol->length, symbol->name);
+  if (symbol->field_count > 0) {
+    fields = malloc(symbol->field_count * sizeof(*fields));
+    if (!fields) {
+      return codegen_set_error(codegen, "codegen: out of memory");
+    }
+  }
 
   for (field = symbol->fields; field; field = field->next) {
-    char field_type[32];
     TypeDesc field_desc;
     TypeDesc resolved_desc;
 
@@ -352,27 +642,30 @@ static int codegen_emit_struct_definition(Codegen *codegen,
                                         field->is_const);
     if (!codegen_require_type(codegen, structs, struct_count, typedefs,
                               typedef_count, field_desc, &resolved_desc)) {
-      return 0;
+      goto cleanup;
     }
 
     if (resolved_desc.pointer_depth == 0 &&
         resolved_desc.type_token.type == TOKEN_STRUCT &&
         codegen_type_token_equals(resolved_desc.type_token, self_token)) {
-      return codegen_set_error(codegen,
-                               "codegen: recursive struct field not supported");
+      codegen_set_error(codegen,
+                        "codegen: recursive struct field not supported");
+      goto cleanup;
     }
 
-    codegen_format_desc_type(resolved_desc, field_type, sizeof(field_type));
+    fields[field_count++] = codegen_lower_type(module, resolved_desc);
+  }
 
-    if (!first) {
-      fprintf(out, ", ");
-    }
-    fprintf(out, "%s", field_type);
-    first = 0;
+  type = ir_type_struct(module, symbol->name, symbol->length);
+  if (!type || !ir_type_struct_set_body(module, type, fields, field_count)) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto cleanup;
   }
+  result = 1;
 
-  fprintf(out, " }\n");
-  return 1;
+cleanup:
+  free(fields);
+  return result;
 }
 
 static int codegen_name_matches(Token token, const char *name, size_t length) {
@@ -383,6 +676,24 @@ static int codegen_name_matches(Token token, const char *name, size_t length) {
   return strncmp(token.start, name, length) == 0;
 }
 
+static int codegen_address_taken(const ParserNode *node, Token name) {
+  for (; node; node = node->next) {
+    if (node->type == PARSER_NODE_UNARY && token_is_punct(node->token, "&") &&
+        node->first_child &&
+        node->first_child->type == PARSER_NODE_IDENTIFIER &&
+        codegen_name_matches(node->first_child->token, name.start,
+                             name.length)) {
+      return 1;
+    }
+
+    if (codegen_address_taken(node->first_child, name)) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
 static int codegen_type_token_equals(Token left, Token right) {
   if (left.type != right.type) {
     return 0;
@@ -506,7 +817,7 @@ static int codegen_pointer_compatible(TypeDesc target, TypeDesc value) {
 
 static int codegen_emit_member_pointer(FunctionContext *ctx,
                                        const ParserNode *node,
-                                       char *pointer_value, size_t pointer_size,
+                                       IrValue **pointer_value,
                                        TypeDesc *field_type_out) {
   const ParserNode *base = node->first_child;
   const ParserNode *field = base ? base->next : NULL;
@@ -514,8 +825,8 @@ static int codegen_emit_member_pointer(FunctionContext *ctx,
   Token struct_token;
   size_t field_index = 0;
   int found = 0;
-  char base_value[128];
-  char struct_type[32];
+  IrValue *base_value = NULL;
+  IrValue *indices[2];
   int base_is_const = 0;
 
   if (!base || !field || field->next) {
@@ -553,7 +864,7 @@ static int codegen_emit_member_pointer(FunctionContext *ctx,
         return codegen_set_error(ctx->codegen,
                                  "codegen: expected struct value");
       }
-      snprintf(base_value, sizeof(base_value), "%s", local->ir_name);
+      base_value = local->address;
       struct_token = resolved_desc.type_token;
       base_is_const = resolved_desc.is_const;
     } else {
@@ -575,8 +886,7 @@ static int codegen_emit_member_pointer(FunctionContext *ctx,
         return codegen_set_error(ctx->codegen,
                                  "codegen: expected struct value");
       }
-      snprintf(base_value, sizeof(base_value), "@%.*s", (int)base->token.length,
-               base->token.start);
+      base_value = codegen_global_address(ctx, base->token);
       struct_token = resolved_desc.type_token;
       base_is_const = resolved_desc.is_const;
     }
@@ -584,8 +894,7 @@ static int codegen_emit_member_pointer(FunctionContext *ctx,
     TypeDesc base_type;
     TypeDesc resolved_desc;
 
-    if (!codegen_emit_expression(ctx, base, base_value, sizeof(base_value),
-                                 &base_type)) {
+    if (!codegen_emit_expression(ctx, base, &base_value, &base_type)) {
       return 0;
     }
 
@@ -644,11 +953,12 @@ static int codegen_emit_member_pointer(FunctionContext *ctx,
     return codegen_set_error(ctx->codegen, "codegen: unknown struct field");
   }
 
-  codegen_format_type(struct_token, 0, struct_type, sizeof(struct_type));
-  snprintf(pointer_value, pointer_size, "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out,
-          "  %s = getelementptr inbounds %s, %s* %s, i32 0, i32 %zu\n",
-          pointer_value, struct_type, struct_type, base_value, field_index);
+  indices[0] = codegen_i32(ctx, 0);
+  indices[1] = codegen_i32(ctx, (long long)field_index);
+  *pointer_value = ir_build_gep(
+    &ctx->builder, IR_FLAG_INBOUNDS,
+    codegen_lower_type(ctx->module, codegen_make_type_desc(struct_token, 0, 0)),
+    base_value, indices, 2);
   return 1;
 }
 
@@ -788,20 +1098,16 @@ static int codegen_resolve_member_type(FunctionContext *ctx,
 }
 
 static int codegen_emit_array_decay(FunctionContext *ctx, TypeDesc element_type,
-                                    size_t length, const char *base_value,
-                                    char *value, size_t value_size,
-                                    TypeDesc *type_out) {
-  char array_type[64];
-  char array_pointer[68];
-  char gep_value[32];
-
-  codegen_format_array_type(element_type, length, array_type,
-                            sizeof(array_type));
-  snprintf(array_pointer, sizeof(array_pointer), "%s*", array_type);
-  snprintf(gep_value, sizeof(gep_value), "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out, "  %s = getelementptr %s, %s %s, i32 0, i32 0\n", gep_value,
-          array_type, array_pointer, base_value);
-  snprintf(value, value_size, "%s", gep_value);
+                                    size_t length, IrValue *base_value,
+                                    IrValue **value, TypeDesc *type_out) {
+  IrValue *indices[2];
+
+  indices[0] = codegen_i32(ctx, 0);
+  indices[1] = codegen_i32(ctx, 0);
+  *value = ir_build_gep(
+    &ctx->builder, codegen_inbounds(ctx),
+    codegen_lower_array_type(ctx->module, element_type, length), base_value,
+    indices, 2);
   element_type.pointer_depth += 1;
   *type_out = element_type;
   return 1;
@@ -809,14 +1115,12 @@ static int codegen_emit_array_decay(FunctionContext *ctx, TypeDesc element_type,
 
 static int codegen_emit_index_pointer(FunctionContext *ctx,
                                       const ParserNode *node,
-                                      char *pointer_value, size_t pointer_size,
+                                      IrValue **pointer_value,
                                       TypeDesc *element_type_out) {
   const ParserNode *base = node->first_child;
   const ParserNode *index = base ? base->next : NULL;
-  char base_value[128];
-  char index_value[32];
-  char element_type_name[32];
-  char pointer_type_name[32];
+  IrValue *base_value = NULL;
+  IrValue *index_value = NULL;
   TypeDesc base_type;
   TypeDesc index_type;
   TypeDesc element_type;
@@ -825,13 +1129,11 @@ static int codegen_emit_index_pointer(FunctionContext *ctx,
     return codegen_set_error(ctx->codegen, "codegen: expected index operands");
   }
 
-  if (!codegen_emit_expression(ctx, base, base_value, sizeof(base_value),
-                               &base_type)) {
+  if (!codegen_emit_expression(ctx, base, &base_value, &base_type)) {
     return 0;
   }
 
-  if (!codegen_emit_expression(ctx, index, index_value, sizeof(index_value),
-                               &index_type)) {
+  if (!codegen_emit_expression(ctx, index, &index_value, &index_type)) {
     return 0;
   }
 
@@ -851,23 +1153,24 @@ static int codegen_emit_index_pointer(FunctionContext *ctx,
     return 0;
   }
 
-  codegen_format_desc_type(element_type, element_type_name,
-                           sizeof(element_type_name));
-  codegen_format_desc_type(base_type, pointer_type_name,
-                           sizeof(pointer_type_name));
+  if (!codegen_emit_integer_cast(ctx, index_type, codegen_int_type_desc(),
+                                 &index_value)) {
+    return 0;
+  }
 
-  snprintf(pointer_value, pointer_size, "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out, "  %s = getelementptr %s, %s %s, i32 %s\n", pointer_value,
-          element_type_name, pointer_type_name, base_value, index_value);
+  *pointer_value =
+    ir_build_gep(&ctx->builder, codegen_inbounds(ctx),
+                 codegen_lower_type(ctx->module, element_type), base_value,
+                 &index_value, 1);
   *element_type_out = element_type;
   return 1;
 }
 
 static int codegen_emit_sizeof_type(FunctionContext *ctx, TypeDesc target_type,
-                                    char *value, size_t value_size) {
-  char element_type[32];
-  char pointer_type[32];
-  char gep_value[32];
+                                    IrValue **value) {
+  IrType *type = NULL;
+  IrValue *one = NULL;
+  IrValue *end = NULL;
   TypeDesc resolved_type;
 
   if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
@@ -876,16 +1179,15 @@ static int codegen_emit_sizeof_type(FunctionContext *ctx, TypeDesc target_type,
     return 0;
   }
 
-  codegen_format_desc_type(resolved_type, element_type, sizeof(element_type));
-  codegen_format_type(resolved_type.type_token, resolved_type.pointer_depth + 1,
-                      pointer_type, sizeof(pointer_type));
-
-  snprintf(gep_value, sizeof(gep_value), "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out, "  %s = getelementptr %s, %s null, i32 1\n", gep_value,
-          element_type, pointer_type);
-  snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out, "  %s = ptrtoint %s %s to i32\n", value, pointer_type,
-          gep_value);
+  /* The address one element past null is the allocation size. */
+  type = codegen_lower_type(ctx->module, resolved_type);
+  one = codegen_i32(ctx, 1);
+  end = ir_build_gep(&ctx->builder, 0, type,
+                     ir_const_null(ctx->module, ir_type_pointer(ctx->module,
+                                                                type)),
+                     &one, 1);
+  *value = ir_build_cast(&ctx->builder, IR_OP_PTRTOINT, end,
+                         ir_type_int(ctx->module, 32));
   return 1;
 }
 
@@ -972,8 +1274,7 @@ static LocalSymbol *codegen_add_local(FunctionContext *ctx,
   symbol->pointer_depth = node->pointer_depth;
   symbol->is_const = node->is_const;
   symbol->array_length = node->array_length;
-  snprintf(symbol->ir_name, sizeof(symbol->ir_name), "%%t%d",
-           ctx->next_temp_id++);
+  symbol->address = NULL;
   return symbol;
 }
 
@@ -1047,6 +1348,32 @@ static const ParserNode *codegen_find_param(const FunctionContext *ctx,
   return NULL;
 }
 
+static IrValue *codegen_param_value(const FunctionContext *ctx, Token name) {
+  const ParserNode *param = ctx->params;
+  size_t index = 0;
+
+  for (index = 0; index < ctx->param_count && param; index++) {
+    if (codegen_name_matches(name, param->token.start, param->token.length)) {
+      return &ctx->function->params[index]->value;
+    }
+    param = param->next;
+  }
+
+  return NULL;
+}
+
+static IrValue *codegen_global_address(FunctionContext *ctx, Token name) {
+  IrGlobal *global =
+    ir_module_find_global(ctx->module, name.start, name.length);
+
+  if (!global) {
+    codegen_set_error(ctx->codegen, "codegen: unknown global");
+    return NULL;
+  }
+
+  return &global->value;
+}
+
 static int codegen_set_error(Codegen *codegen, const char *message) {
   if (!codegen->error_message) {
     codegen->error_message = message;
@@ -1055,8 +1382,25 @@ static int codegen_set_error(Codegen *codegen, const char *message) {
   return 0;
 }
 
-static int codegen_push_loop(FunctionContext *ctx, const char *break_label,
-                             const char *continue_label) {
+/* With debug info, the instructions built next belong to token's position. */
+static int codegen_set_location(FunctionContext *ctx, Token token) {
+  Codegen *codegen = ctx->codegen;
+  IrDebugLoc *loc = &ctx->builder.loc;
+  size_t offset = 0;
+
+  if (!ctx->module->source_file || !token.start) {
+    return 1;
+  }
+
+  offset = (size_t)(token.start - codegen->input);
+  if (!line_table_lookup(&codegen->lines, offset, &loc->line, &loc->column)) {
+    return codegen_set_error(codegen, "codegen: out of memory");
+  }
+  return 1;
+}
+
+static int codegen_push_loop(FunctionContext *ctx, IrBlock *break_block,
+                             IrBlock *continue_block) {
   LoopContext *loop = NULL;
   size_t next_capacity = 0;
 
@@ -1072,9 +1416,8 @@ static int codegen_push_loop(FunctionContext *ctx, const char *break_label,
   }
 
   loop = &ctx->loop_stack[ctx->loop_depth];
-  snprintf(loop->break_label, sizeof(loop->break_label), "%s", break_label);
-  snprintf(loop->continue_label, sizeof(loop->continue_label), "%s",
-           continue_label);
+  loop->break_block = break_block;
+  loop->continue_block = continue_block;
   ctx->loop_depth += 1;
   return 1;
 }
@@ -1146,22 +1489,276 @@ static int codegen_function_parts(Codegen *codegen, const ParserNode *node,
   return 1;
 }
 
+void codegen_options_init(CodegenOptions *options) {
+  options->poison_flags = 1;
+  options->optimize_linkage = 0;
+  options->pic = 0;
+  options->strict_aliasing = 1;
+  options->target = CODEGEN_TARGET_LLVM;
+  options->passes = NULL;
+  options->inline_threshold = IR_INLINE_DEFAULT_THRESHOLD;
+  options->pass_stats = NULL;
+  options->allocate_registers = 1;
+  options->superinstructions = 1;
+  options->profile_generate = 0;
+  options->instrument_functions = 0;
+  options->profile_use = NULL;
+  options->debug_info = 0;
+  options->source_name = NULL;
+}
+
 void codegen_init(Codegen *codegen, const char *input) {
   codegen->input = input;
+  line_table_init(&codegen->lines, input);
+  codegen_options_init(&codegen->options);
   codegen->error_message = NULL;
   checker_init(&codegen->checker, input);
   parser_init(&codegen->parser, input);
 }
 
+static int codegen_is_aggregate(TypeDesc type, size_t array_length) {
+  return array_length > 0 ||
+         (type.pointer_depth == 0 && type.type_token.type == TOKEN_STRUCT);
+}
+
+/* The zero of a type: 0, null, or zeroinitializer. */
+static IrValue *codegen_zero_constant(IrModule *module, TypeDesc type,
+                                      size_t array_length) {
+  if (codegen_is_aggregate(type, array_length)) {
+    return ir_const_zero(
+      module, array_length > 0
+                ? codegen_lower_array_type(module, type, array_length)
+                : codegen_lower_type(module, type));
+  }
+  if (type.pointer_depth > 0) {
+    return ir_const_null(module, codegen_lower_type(module, type));
+  }
+  return ir_const_int(module, codegen_lower_type(module, type), 0);
+}
+
+/*
+ * Whether a braced initializer holds only numbers and enumerators, so a
+ * local it initializes can be copied from a constant.
+ */
+static int codegen_initializer_is_constant(const EnumSymbol *enums,
+                                           size_t enum_count,
+                                           const ParserNode *init) {
+  const ParserNode *element = NULL;
+
+  switch (init->type) {
+  case PARSER_NODE_NUMBER:
+    return 1;
+  case PARSER_NODE_IDENTIFIER:
+    return codegen_lookup_enum(enums, enum_count, init->token) != NULL;
+  case PARSER_NODE_INITIALIZER:
+    for (element = init->first_child; element; element = element->next) {
+      if (!codegen_initializer_is_constant(enums, enum_count, element)) {
+        return 0;
+      }
+    }
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/* A scalar constant: a number or enumerator, null, or a global's address. */
+static int codegen_constant_scalar(const ConstantScope *scope, TypeDesc type,
+                                   const ParserNode *init, IrValue **value) {
+  Codegen *codegen = scope->codegen;
+  IrModule *module = scope->module;
+  IrType *value_type = codegen_lower_type(module, type);
+
+  if (init->type == PARSER_NODE_INITIALIZER) {
+    return codegen_set_error(codegen, "codegen: unexpected initializer list");
+  }
+
+  if (type.pointer_depth == 0) {
+    if (init->type == PARSER_NODE_NUMBER) {
+      *value = ir_const_int(module, value_type, init->token.value);
+    } else if (init->type == PARSER_NODE_IDENTIFIER) {
+      const EnumSymbol *eval =
+        codegen_lookup_enum(scope->enums, scope->enum_count, init->token);
+      if (eval) {
+        *value = ir_const_int(module, value_type, eval->value);
+      } else {
+        return codegen_set_error(codegen,
+                                 "codegen: expected constant initializer");
+      }
+    } else {
+      return codegen_set_error(codegen,
+                               "codegen: expected number or enum initializer");
+    }
+  } else if (init->type == PARSER_NODE_NUMBER) {
+    if (init->token.value != 0) {
+      return codegen_set_error(codegen,
+                               "codegen: expected null pointer initializer");
+    }
+    *value = ir_const_null(module, value_type);
+  } else if (init->type == PARSER_NODE_UNARY &&
+             token_is_punct(init->token, "&")) {
+    const ParserNode *operand = init->first_child;
+    const GlobalSymbol *symbol = NULL;
+    IrGlobal *target = NULL;
+    TypeDesc symbol_desc;
+    TypeDesc resolved_symbol;
+
+    if (!operand || operand->next) {
+      return codegen_set_error(codegen, "codegen: expected address-of operand");
+    }
+
+    if (operand->type != PARSER_NODE_IDENTIFIER) {
+      return codegen_set_error(codegen, "codegen: expected identifier address");
+    }
+
+    for (size_t i = 0; i < scope->global_count; i++) {
+      if (codegen_name_matches(operand->token, scope->globals[i].name,
+                               scope->globals[i].length)) {
+        symbol = &scope->globals[i];
+        break;
+      }
+    }
+
+    target = ir_module_find_global(module, operand->token.start,
+                                   operand->token.length);
+    if (!symbol || !target) {
+      return codegen_set_error(codegen, "codegen: unknown global initializer");
+    }
+
+    symbol_desc = codegen_make_type_desc(
+      symbol->type_token, symbol->pointer_depth, symbol->is_const);
+    if (!codegen_resolve_desc(codegen, scope->typedefs, scope->typedef_count,
+                              symbol_desc, &resolved_symbol)) {
+      return 0;
+    }
+    resolved_symbol.pointer_depth += 1;
+    if (!codegen_pointer_compatible(type, resolved_symbol)) {
+      return codegen_set_error(codegen, "codegen: initializer type mismatch");
+    }
+
+    *value = &target->value;
+  } else {
+    return codegen_set_error(codegen, "codegen: unsupported initializer");
+  }
+
+  if (!*value) {
+    return codegen_set_error(codegen, "codegen: out of memory");
+  }
+  return 1;
+}
+
+/* The resolved type of the field of a struct at index, counting from 0. */
+static int codegen_struct_field_type(Codegen *codegen,
+                                     const StructSymbol *symbol,
+                                     const TypedefSymbol *typedefs,
+                                     size_t typedef_count, size_t index,
+                                     TypeDesc *field_type) {
+  const ParserNode *field = symbol->fields;
+
+  for (; field && index > 0; index--) {
+    field = field->next;
+  }
+  if (!field) {
+    return codegen_set_error(codegen, "codegen: unknown struct field");
+  }
+  return codegen_resolve_desc(
+    codegen, typedefs, typedef_count,
+    codegen_make_type_desc(field->type_token, field->pointer_depth,
+                           field->is_const),
+    field_type);
+}
+
+/*
+ * The constant init gives a value of type, an array of array_length of
+ * them when that is not 0. Arrays and structs take a braced list whose
+ * missing trailing elements are zero.
+ */
+static int codegen_constant_initializer(const ConstantScope *scope,
+                                        TypeDesc type, size_t array_length,
+                                        const ParserNode *init,
+                                        IrValue **value) {
+  Codegen *codegen = scope->codegen;
+  IrModule *module = scope->module;
+  const StructSymbol *symbol = NULL;
+  const ParserNode *element = NULL;
+  IrValue **elements = NULL;
+  IrType *aggregate_type = NULL;
+  size_t count = array_length;
+  size_t index = 0;
+  int result = 0;
+
+  if (!codegen_is_aggregate(type, array_length)) {
+    return codegen_constant_scalar(scope, type, init, value);
+  }
+
+  if (init->type != PARSER_NODE_INITIALIZER) {
+    return codegen_set_error(codegen, "codegen: expected initializer list");
+  }
+
+  if (array_length > 0) {
+    aggregate_type = codegen_lower_array_type(module, type, array_length);
+  } else {
+    symbol = codegen_find_struct(scope->structs, scope->struct_count,
+                                 type.type_token);
+    if (!symbol) {
+      return codegen_set_error(codegen, "codegen: unknown struct type");
+    }
+    aggregate_type = codegen_lower_type(module, type);
+    count = symbol->field_count;
+  }
+
+  elements = calloc(count + 1, sizeof(*elements));
+  if (!elements) {
+    return codegen_set_error(codegen, "codegen: out of memory");
+  }
+
+  element = init->first_child;
+  for (index = 0; index < count; index++) {
+    TypeDesc element_type = type;
+
+    if (symbol && !codegen_struct_field_type(codegen, symbol, scope->typedefs,
+                                             scope->typedef_count, index,
+                                             &element_type)) {
+      goto cleanup;
+    }
+    if (!element) {
+      elements[index] = codegen_zero_constant(module, element_type, 0);
+      continue;
+    }
+    if (!codegen_constant_initializer(scope, element_type, 0, element,
+                                      &elements[index])) {
+      goto cleanup;
+    }
+    element = element->next;
+  }
+
+  if (element) {
+    codegen_set_error(codegen, "codegen: too many initializers");
+    goto cleanup;
+  }
+
+  *value = ir_const_aggregate(module, aggregate_type, elements, count);
+  if (!*value) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto cleanup;
+  }
+  result = 1;
+
+cleanup:
+  free(elements);
+  return result;
+}
+
 static int codegen_emit_declaration(
   Codegen *codegen, const ParserNode *node, const GlobalSymbol *globals,
   size_t global_count, const StructSymbol *structs, size_t struct_count,
   const TypedefSymbol *typedefs, size_t typedef_count, const EnumSymbol *enums,
-  size_t enum_count, FILE *out) {
-  long value = 0;
-  char type_name[32];
-  char init_value[64];
-  const char *linkage = "";
+  size_t enum_count, IrModule *module) {
+  IrGlobal *global = NULL;
+  IrType *value_type = NULL;
+  IrValue *init_value = NULL;
+  int is_constant = 0;
+  int address_taken = 1;
   TypeDesc declared_type;
   TypeDesc resolved_type;
 
@@ -1180,136 +1777,93 @@ static int codegen_emit_declaration(
     return 0;
   }
 
-  codegen_format_desc_type(resolved_type, type_name, sizeof(type_name));
-  if (node->is_static) {
-    linkage = "internal ";
+  value_type = codegen_lower_type(module, resolved_type);
+  for (size_t i = 0; i < global_count; i++) {
+    if (codegen_name_matches(node->token, globals[i].name, globals[i].length)) {
+      address_taken = globals[i].address_taken;
+      break;
+    }
   }
+  is_constant = (node->is_const || resolved_type.is_const) &&
+                resolved_type.pointer_depth == 0 && !node->is_extern;
 
   if (node->array_length > 0) {
-    char array_type[64];
-
-    if (node->first_child) {
-      return codegen_set_error(codegen,
-                               "codegen: array initializer not supported");
-    }
-
-    codegen_format_array_type(resolved_type, node->array_length, array_type,
-                              sizeof(array_type));
-    fprintf(out, "@%.*s = %sglobal %s zeroinitializer\n",
-            (int)node->token.length, node->token.start, linkage, array_type);
-    return 1;
+    value_type =
+      codegen_lower_array_type(module, resolved_type, node->array_length);
   }
 
   if (node->first_child) {
-    const ParserNode *init = node->first_child;
+    ConstantScope scope = {.codegen = codegen,
+                           .module = module,
+                           .globals = globals,
+                           .global_count = global_count,
+                           .structs = structs,
+                           .struct_count = struct_count,
+                           .typedefs = typedefs,
+                           .typedef_count = typedef_count,
+                           .enums = enums,
+                           .enum_count = enum_count};
 
     if (node->first_child->next) {
       return codegen_set_error(codegen, "codegen: unexpected initializer list");
     }
 
-    if (resolved_type.type_token.type == TOKEN_STRUCT &&
-        resolved_type.pointer_depth == 0) {
-      return codegen_set_error(codegen,
-                               "codegen: struct initializer not supported");
-    }
-
-    if (resolved_type.pointer_depth == 0) {
-      if (init->type == PARSER_NODE_NUMBER) {
-        value = init->token.value;
-        snprintf(init_value, sizeof(init_value), "%ld", value);
-      } else if (init->type == PARSER_NODE_IDENTIFIER) {
-        const EnumSymbol *eval =
-          codegen_lookup_enum(enums, enum_count, init->token);
-        if (eval) {
-          snprintf(init_value, sizeof(init_value), "%d", eval->value);
-        } else {
-          return codegen_set_error(codegen,
-                                   "codegen: expected constant initializer");
-        }
-      } else {
-        return codegen_set_error(
-          codegen, "codegen: expected number or enum initializer");
-      }
-    } else if (init->type == PARSER_NODE_NUMBER) {
-      if (init->token.value != 0) {
-        return codegen_set_error(codegen,
-                                 "codegen: expected null pointer initializer");
-      }
-      snprintf(init_value, sizeof(init_value), "null");
-    } else if (init->type == PARSER_NODE_UNARY &&
-               token_is_punct(init->token, "&")) {
-      const ParserNode *operand = init->first_child;
-      const GlobalSymbol *symbol = NULL;
-      TypeDesc symbol_desc;
-      TypeDesc resolved_symbol;
-
-      if (!operand || operand->next) {
-        return codegen_set_error(codegen,
-                                 "codegen: expected address-of operand");
-      }
-
-      if (operand->type != PARSER_NODE_IDENTIFIER) {
-        return codegen_set_error(codegen,
-                                 "codegen: expected identifier address");
-      }
-
-      symbol = NULL;
-      for (size_t i = 0; i < global_count; i++) {
-        if (codegen_name_matches(operand->token, globals[i].name,
-                                 globals[i].length)) {
-          symbol = &globals[i];
-          break;
-        }
-      }
-
-      if (!symbol) {
-        return codegen_set_error(codegen,
-                                 "codegen: unknown global initializer");
-      }
-
-      symbol_desc = codegen_make_type_desc(
-        symbol->type_token, symbol->pointer_depth, symbol->is_const);
-      if (!codegen_resolve_desc(codegen, typedefs, typedef_count, symbol_desc,
-                                &resolved_symbol)) {
-        return 0;
-      }
-      resolved_symbol.pointer_depth += 1;
-      if (!codegen_pointer_compatible(resolved_type, resolved_symbol)) {
-        return codegen_set_error(codegen, "codegen: initializer type mismatch");
-      }
-
-      snprintf(init_value, sizeof(init_value), "@%.*s",
-               (int)operand->token.length, operand->token.start);
-    } else {
-      return codegen_set_error(codegen, "codegen: unsupported initializer");
+    if (!codegen_constant_initializer(&scope, resolved_type,
+                                      node->array_length, node->first_child,
+                                      &init_value)) {
+      return 0;
     }
-  } else if (resolved_type.pointer_depth > 0) {
-    snprintf(init_value, sizeof(init_value), "null");
-  } else if (resolved_type.type_token.type == TOKEN_STRUCT) {
-    snprintf(init_value, sizeof(init_value), "zeroinitializer");
   } else {
-    snprintf(init_value, sizeof(init_value), "0");
+    init_value =
+      codegen_zero_constant(module, resolved_type, node->array_length);
   }
 
-  fprintf(out, "@%.*s = %sglobal %s %s\n", (int)node->token.length,
-          node->token.start, linkage, type_name, init_value);
+  global = ir_module_add_global(module, node->token.start, node->token.length,
+                                value_type);
+  if (!global || !init_value) {
+    return codegen_set_error(codegen, "codegen: out of memory");
+  }
 
+  codegen_apply_data_linkage(codegen, global, node->is_static, is_constant,
+                             address_taken || node->array_length > 0);
+  global->initializer = init_value;
   return 1;
 }
 
+/*
+ * ".static.<function>.<index>.<local>" for a static local, and ".const."
+ * the same way for the constant a local aggregate is copied from.
+ */
 static void codegen_format_static_local_name(char *buffer, size_t size,
+                                             const char *kind,
                                              Token function_name, size_t index,
                                              Token local_name) {
-  snprintf(buffer, size, "@.static.%.*s.%zu.%.*s", (int)function_name.length,
+  snprintf(buffer, size, ".%s.%.*s.%zu.%.*s", kind, (int)function_name.length,
            function_name.start, index, (int)local_name.length,
            local_name.start);
 }
 
+static ConstantScope codegen_static_local_scope(const StaticLocalContext *ctx) {
+  ConstantScope scope = {.codegen = ctx->codegen,
+                         .module = ctx->module,
+                         .globals = ctx->globals,
+                         .global_count = ctx->global_count,
+                         .structs = ctx->structs,
+                         .struct_count = ctx->struct_count,
+                         .typedefs = ctx->typedefs,
+                         .typedef_count = ctx->typedef_count,
+                         .enums = ctx->enums,
+                         .enum_count = ctx->enum_count};
+
+  return scope;
+}
+
 static int codegen_emit_static_local(StaticLocalContext *ctx,
                                      const ParserNode *node, const char *name) {
-  long value = 0;
-  char type_name[32];
-  char init_value[64];
+  IrModule *module = ctx->module;
+  IrGlobal *global = NULL;
+  IrType *value_type = NULL;
+  IrValue *init_value = NULL;
   TypeDesc declared_type;
   TypeDesc resolved_type;
 
@@ -1331,120 +1885,95 @@ static int codegen_emit_static_local(StaticLocalContext *ctx,
     return 0;
   }
 
-  codegen_format_desc_type(resolved_type, type_name, sizeof(type_name));
-
+  value_type = codegen_lower_type(module, resolved_type);
   if (node->array_length > 0) {
-    char array_type[64];
-
-    if (node->first_child) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: array initializer not supported");
-    }
-
-    codegen_format_array_type(resolved_type, node->array_length, array_type,
-                              sizeof(array_type));
-    fprintf(ctx->out, "%s = internal global %s zeroinitializer\n", name,
-            array_type);
-    return 1;
+    value_type =
+      codegen_lower_array_type(module, resolved_type, node->array_length);
   }
 
   if (node->first_child) {
-    const ParserNode *init = node->first_child;
+    ConstantScope scope = codegen_static_local_scope(ctx);
 
     if (node->first_child->next) {
       return codegen_set_error(ctx->codegen,
                                "codegen: unexpected initializer list");
     }
 
-    if (resolved_type.type_token.type == TOKEN_STRUCT &&
-        resolved_type.pointer_depth == 0) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: struct initializer not supported");
-    }
-
-    if (resolved_type.pointer_depth == 0) {
-      if (init->type == PARSER_NODE_NUMBER) {
-        value = init->token.value;
-        snprintf(init_value, sizeof(init_value), "%ld", value);
-      } else if (init->type == PARSER_NODE_IDENTIFIER) {
-        const EnumSymbol *eval =
-          codegen_lookup_enum(ctx->enums, ctx->enum_count, init->token);
-        if (eval) {
-          snprintf(init_value, sizeof(init_value), "%d", eval->value);
-        } else {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected constant initializer");
-        }
-      } else {
-        return codegen_set_error(
-          ctx->codegen, "codegen: expected number or enum initializer");
-      }
-    } else if (init->type == PARSER_NODE_NUMBER) {
-      if (init->token.value != 0) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected null pointer initializer");
-      }
-      snprintf(init_value, sizeof(init_value), "null");
-    } else if (init->type == PARSER_NODE_UNARY &&
-               token_is_punct(init->token, "&")) {
-      const ParserNode *operand = init->first_child;
-      const GlobalSymbol *symbol = NULL;
-      TypeDesc symbol_desc;
-      TypeDesc resolved_symbol;
-
-      if (!operand || operand->next) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected address-of operand");
-      }
+    if (!codegen_constant_initializer(&scope, resolved_type,
+                                      node->array_length, node->first_child,
+                                      &init_value)) {
+      return 0;
+    }
+  } else {
+    init_value =
+      codegen_zero_constant(module, resolved_type, node->array_length);
+  }
 
-      if (operand->type != PARSER_NODE_IDENTIFIER) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected identifier address");
-      }
+  global = ir_module_add_global(module, name, strlen(name), value_type);
+  if (!global || !init_value) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
 
-      symbol = NULL;
-      for (size_t i = 0; i < ctx->global_count; i++) {
-        if (codegen_name_matches(operand->token, ctx->globals[i].name,
-                                 ctx->globals[i].length)) {
-          symbol = &ctx->globals[i];
-          break;
-        }
-      }
+  codegen_apply_data_linkage(
+    ctx->codegen, global, 1,
+    (node->is_const || resolved_type.is_const) &&
+      resolved_type.pointer_depth == 0,
+    node->array_length > 0 || codegen_address_taken(ctx->body, node->token));
+  global->initializer = init_value;
+  return 1;
+}
 
-      if (!symbol) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: unknown global initializer");
-      }
+/*
+ * A local array or struct whose braced initializer is all constants gets
+ * an internal constant to copy from, unless it is all zeros.
+ */
+static int codegen_emit_local_constant(StaticLocalContext *ctx,
+                                       const ParserNode *node) {
+  ConstantScope scope = codegen_static_local_scope(ctx);
+  IrGlobal *global = NULL;
+  IrValue *value = NULL;
+  TypeDesc declared_type;
+  TypeDesc resolved_type;
+  char name[128];
 
-      symbol_desc = codegen_make_type_desc(
-        symbol->type_token, symbol->pointer_depth, symbol->is_const);
-      if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
-                                symbol_desc, &resolved_symbol)) {
-        return 0;
-      }
-      resolved_symbol.pointer_depth += 1;
-      if (!codegen_pointer_compatible(resolved_type, resolved_symbol)) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: initializer type mismatch");
-      }
+  if (!node->first_child ||
+      node->first_child->type != PARSER_NODE_INITIALIZER ||
+      !codegen_initializer_is_constant(ctx->enums, ctx->enum_count,
+                                       node->first_child)) {
+    return 1;
+  }
 
-      snprintf(init_value, sizeof(init_value), "@%.*s",
-               (int)operand->token.length, operand->token.start);
-    } else {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: unsupported initializer");
-    }
-  } else if (resolved_type.pointer_depth > 0) {
-    snprintf(init_value, sizeof(init_value), "null");
-  } else if (resolved_type.type_token.type == TOKEN_STRUCT) {
-    snprintf(init_value, sizeof(init_value), "zeroinitializer");
-  } else {
-    snprintf(init_value, sizeof(init_value), "0");
+  declared_type = codegen_make_type_desc(node->type_token, node->pointer_depth,
+                                         node->is_const);
+  if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
+                            declared_type, &resolved_type)) {
+    return 0;
+  }
+  if (!codegen_is_aggregate(resolved_type, node->array_length)) {
+    return 1;
   }
 
-  fprintf(ctx->out, "%s = internal global %s %s\n", name, type_name,
-          init_value);
+  codegen_format_static_local_name(name, sizeof(name), "const",
+                                   ctx->function_name, ctx->index,
+                                   node->token);
+  ctx->index++;
+  if (!codegen_constant_initializer(&scope, resolved_type, node->array_length,
+                                    node->first_child, &value)) {
+    return 0;
+  }
+  if (ir_value_is_zero(value)) {
+    return 1;
+  }
 
+  global = ir_module_add_global(ctx->module, name, strlen(name), value->type);
+  if (!global) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
+  /* Only the copy reads it, so it is read-only whatever the options. */
+  codegen_apply_data_linkage(ctx->codegen, global, 1, 1, 0);
+  global->is_constant = 1;
+  global->unnamed_addr = IR_UNNAMED_ADDR_GLOBAL;
+  global->initializer = value;
   return 1;
 }
 
@@ -1461,12 +1990,13 @@ static int codegen_emit_static_locals_in_statement(StaticLocalContext *ctx,
     if (node->is_static) {
       char name[128];
 
-      codegen_format_static_local_name(name, sizeof(name), ctx->function_name,
-                                       ctx->index, node->token);
+      codegen_format_static_local_name(name, sizeof(name), "static",
+                                       ctx->function_name, ctx->index,
+                                       node->token);
       ctx->index++;
       return codegen_emit_static_local(ctx, node, name);
     }
-    return 1;
+    return codegen_emit_local_constant(ctx, node);
   case PARSER_NODE_BLOCK:
     for (child = node->first_child; child; child = child->next) {
       if (!codegen_emit_static_locals_in_statement(ctx, child)) {
@@ -1504,33 +2034,68 @@ static int codegen_emit_static_locals_in_statement(StaticLocalContext *ctx,
     }
     return codegen_emit_static_locals_in_statement(ctx, body);
   }
+  case PARSER_NODE_SWITCH: {
+    const ParserNode *condition = node->first_child;
+    const ParserNode *body = condition ? condition->next : NULL;
+
+    return codegen_emit_static_locals_in_statement(ctx, body);
+  }
+  case PARSER_NODE_CASE: {
+    const ParserNode *value = node->first_child;
+    const ParserNode *statement = value ? value->next : NULL;
+
+    return codegen_emit_static_locals_in_statement(ctx, statement);
+  }
+  case PARSER_NODE_DEFAULT:
+    return codegen_emit_static_locals_in_statement(ctx, node->first_child);
   default:
     return 1;
   }
 }
 
 static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
-                                   char *value, size_t value_size,
-                                   TypeDesc *type_out);
+                                   IrValue **value, TypeDesc *type_out);
 
 static void codegen_format_label(char *buffer, size_t size, const char *prefix,
                                  int id);
 
-static int codegen_emit_logical_binary(FunctionContext *ctx,
-                                       const ParserNode *node, char *value,
-                                       size_t value_size, int is_and,
-                                       TypeDesc *type_out) {
+static int codegen_comparison_predicate(Token token, int is_pointer,
+                                        IrPredicate *predicate) {
+  if (token_is_punct(token, "==")) {
+    *predicate = IR_PRED_EQ;
+  } else if (token_is_punct(token, "!=")) {
+    *predicate = IR_PRED_NE;
+  } else if (token_is_punct(token, "<")) {
+    *predicate = is_pointer ? IR_PRED_ULT : IR_PRED_SLT;
+  } else if (token_is_punct(token, ">")) {
+    *predicate = is_pointer ? IR_PRED_UGT : IR_PRED_SGT;
+  } else if (token_is_punct(token, "<=")) {
+    *predicate = is_pointer ? IR_PRED_ULE : IR_PRED_SLE;
+  } else if (token_is_punct(token, ">=")) {
+    *predicate = is_pointer ? IR_PRED_UGE : IR_PRED_SGE;
+  } else {
+    return 0;
+  }
+
+  return 1;
+}
+
+static int codegen_is_comparison(const ParserNode *node) {
+  IrPredicate predicate;
+
+  return node->type == PARSER_NODE_BINARY &&
+         codegen_comparison_predicate(node->token, 0, &predicate);
+}
+
+/* Emits a relational or equality operator as a bare i1 icmp result. */
+static int codegen_emit_comparison(FunctionContext *ctx,
+                                   const ParserNode *node,
+                                   IrValue **bool_value) {
   const ParserNode *left = node->first_child;
   const ParserNode *right = left ? left->next : NULL;
-  char left_value[32];
-  char right_value[32];
-  char left_bool[32];
-  char right_bool[32];
-  char result_bool[32];
-  char result_value[32];
-  char left_label[32];
-  char rhs_label[32];
-  char end_label[32];
+  IrValue *left_value = NULL;
+  IrValue *right_value = NULL;
+  IrPredicate predicate;
   TypeDesc left_type;
   TypeDesc right_type;
 
@@ -1538,60 +2103,189 @@ static int codegen_emit_logical_binary(FunctionContext *ctx,
     return codegen_set_error(ctx->codegen, "codegen: expected binary operands");
   }
 
-  codegen_format_label(left_label, sizeof(left_label), "logic.left",
-                       ctx->next_label_id++);
-  codegen_format_label(rhs_label, sizeof(rhs_label), "logic.rhs",
-                       ctx->next_label_id++);
-  codegen_format_label(end_label, sizeof(end_label), "logic.end",
-                       ctx->next_label_id++);
-
-  fprintf(ctx->out, "  br label %%%s\n", left_label);
-  fprintf(ctx->out, "%s:\n", left_label);
+  if (!codegen_emit_expression(ctx, left, &left_value, &left_type)) {
+    return 0;
+  }
 
-  if (!codegen_emit_expression(ctx, left, left_value, sizeof(left_value),
-                               &left_type)) {
+  if (!codegen_emit_expression(ctx, right, &right_value, &right_type)) {
     return 0;
   }
 
-  if (!codegen_emit_condition_bool(ctx, left_type, left_value, left_bool,
-                                   sizeof(left_bool))) {
+  if (codegen_type_is_integer(left_type) &&
+      codegen_type_is_integer(right_type)) {
+    if (!codegen_emit_integer_cast(ctx, left_type, codegen_int_type_desc(),
+                                   &left_value) ||
+        !codegen_emit_integer_cast(ctx, right_type, codegen_int_type_desc(),
+                                   &right_value)) {
+      return 0;
+    }
+
+    codegen_comparison_predicate(node->token, 0, &predicate);
+    *bool_value =
+      ir_build_icmp(&ctx->builder, predicate, left_value, right_value);
+    return 1;
+  }
+
+  if (left_type.pointer_depth > 0 && codegen_is_null_pointer_literal(right)) {
+    right_value = codegen_zero_of(ctx, left_value);
+    right_type = left_type;
+  } else if (right_type.pointer_depth > 0 &&
+             codegen_is_null_pointer_literal(left)) {
+    left_value = codegen_zero_of(ctx, right_value);
+    left_type = right_type;
+  }
+
+  if (left_type.pointer_depth == 0 || right_type.pointer_depth == 0) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected comparable operands");
+  }
+
+  if (codegen_lower_type(ctx->module, left_type) !=
+      codegen_lower_type(ctx->module, right_type)) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected comparable operands");
+  }
+
+  codegen_comparison_predicate(node->token, 1, &predicate);
+  *bool_value =
+    ir_build_icmp(&ctx->builder, predicate, left_value, right_value);
+  return 1;
+}
+
+/*
+ * Lowers a controlling expression to an i1. Comparisons feed the branch
+ * directly; other values are tested against zero or null.
+ */
+static int codegen_emit_branch_condition(FunctionContext *ctx,
+                                         const ParserNode *condition,
+                                         IrValue **bool_value) {
+  IrValue *value = NULL;
+  TypeDesc condition_type;
+
+  if (codegen_is_comparison(condition)) {
+    return codegen_emit_comparison(ctx, condition, bool_value);
+  }
+
+  if (!codegen_emit_expression(ctx, condition, &value, &condition_type)) {
     return 0;
   }
 
-  if (is_and) {
-    fprintf(ctx->out, "  br i1 %s, label %%%s, label %%%s\n", left_bool,
-            rhs_label, end_label);
-  } else {
-    fprintf(ctx->out, "  br i1 %s, label %%%s, label %%%s\n", left_bool,
-            end_label, rhs_label);
+  return codegen_emit_condition_bool(ctx, condition_type, value, bool_value);
+}
+
+/*
+ * Emits a controlling expression as jumps to true_block or false_block.
+ * `&&`, `||`, and `!` only route the jumps, so no value is built for them;
+ * anything else ends in one condbr on its branch condition.
+ */
+static int codegen_emit_cond(FunctionContext *ctx, const ParserNode *node,
+                             IrBlock *true_block, IrBlock *false_block) {
+  const ParserNode *left = node->first_child;
+  const ParserNode *right = left ? left->next : NULL;
+  IrValue *condition_value = NULL;
+  IrBlock *rhs_block = NULL;
+  char rhs_label[32];
+  int is_and = 0;
+
+  if (node->type == PARSER_NODE_UNARY && token_is_punct(node->token, "!")) {
+    if (!left || right) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected unary operand");
+    }
+    return codegen_emit_cond(ctx, left, false_block, true_block);
+  }
+
+  if (node->type == PARSER_NODE_BINARY &&
+      (token_is_punct(node->token, "&&") ||
+       token_is_punct(node->token, "||"))) {
+    if (!left || !right || right->next) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected binary operands");
+    }
+
+    is_and = token_is_punct(node->token, "&&");
+    codegen_format_label(rhs_label, sizeof(rhs_label), "logic.rhs",
+                         ctx->next_label_id++);
+    rhs_block = ir_block_create(ctx->function, rhs_label);
+    if (!rhs_block) {
+      return codegen_set_error(ctx->codegen, "codegen: out of memory");
+    }
+
+    if (!codegen_emit_cond(ctx, left, is_and ? rhs_block : true_block,
+                           is_and ? false_block : rhs_block)) {
+      return 0;
+    }
+    ir_builder_set_block(&ctx->builder, rhs_block);
+    return codegen_emit_cond(ctx, right, true_block, false_block);
   }
 
-  fprintf(ctx->out, "%s:\n", rhs_label);
-  if (!codegen_emit_expression(ctx, right, right_value, sizeof(right_value),
-                               &right_type)) {
+  if (!codegen_emit_branch_condition(ctx, node, &condition_value)) {
     return 0;
   }
+  ir_build_condbr(&ctx->builder, condition_value, true_block, false_block);
+  return 1;
+}
+
+/* Materializes `&&` or `||` as an int, for results that are stored. */
+static int codegen_emit_logical_binary(FunctionContext *ctx,
+                                       const ParserNode *node, IrValue **value,
+                                       int is_and, TypeDesc *type_out) {
+  const ParserNode *left = node->first_child;
+  const ParserNode *right = left ? left->next : NULL;
+  IrType *i1 = ir_type_int(ctx->module, 1);
+  IrValue *left_bool = NULL;
+  IrValue *right_bool = NULL;
+  IrValue *result_bool = NULL;
+  IrBlock *left_block = NULL;
+  IrBlock *rhs_block = NULL;
+  IrBlock *end_block = NULL;
+  char rhs_label[32];
+  char end_label[32];
+
+  if (!left || !right || right->next) {
+    return codegen_set_error(ctx->codegen, "codegen: expected binary operands");
+  }
+
+  codegen_format_label(rhs_label, sizeof(rhs_label), "logic.rhs",
+                       ctx->next_label_id++);
+  codegen_format_label(end_label, sizeof(end_label), "logic.end",
+                       ctx->next_label_id++);
+  rhs_block = ir_block_create(ctx->function, rhs_label);
+  end_block = ir_block_create(ctx->function, end_label);
+  if (!rhs_block || !end_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
 
-  if (!codegen_emit_condition_bool(ctx, right_type, right_value, right_bool,
-                                   sizeof(right_bool))) {
+  if (!codegen_emit_branch_condition(ctx, left, &left_bool)) {
     return 0;
   }
-  fprintf(ctx->out, "  br label %%%s\n", end_label);
 
-  fprintf(ctx->out, "%s:\n", end_label);
-  snprintf(result_bool, sizeof(result_bool), "%%t%d", ctx->next_temp_id++);
+  /* Nested operators move the builder, so the phi edge is the live block. */
+  left_block = ctx->builder.block;
   if (is_and) {
-    fprintf(ctx->out, "  %s = phi i1 [0, %%%s], [%s, %%%s]\n", result_bool,
-            left_label, right_bool, rhs_label);
+    ir_build_condbr(&ctx->builder, left_bool, rhs_block, end_block);
   } else {
-    fprintf(ctx->out, "  %s = phi i1 [1, %%%s], [%s, %%%s]\n", result_bool,
-            left_label, right_bool, rhs_label);
+    ir_build_condbr(&ctx->builder, left_bool, end_block, rhs_block);
+  }
+
+  ir_builder_set_block(&ctx->builder, rhs_block);
+  if (!codegen_emit_branch_condition(ctx, right, &right_bool)) {
+    return 0;
   }
+  rhs_block = ctx->builder.block;
+  ir_build_br(&ctx->builder, end_block);
 
-  snprintf(result_value, sizeof(result_value), "%%t%d", ctx->next_temp_id++);
-  fprintf(ctx->out, "  %s = zext i1 %s to i32\n", result_value, result_bool);
+  ir_builder_set_block(&ctx->builder, end_block);
+  result_bool = ir_build_phi(&ctx->builder, i1);
+  if (result_bool) {
+    ir_phi_add_incoming(result_bool->instr,
+                        ir_const_int(ctx->module, i1, is_and ? 0 : 1),
+                        left_block);
+    ir_phi_add_incoming(result_bool->instr, right_bool, rhs_block);
+  }
 
-  snprintf(value, value_size, "%s", result_value);
+  *value = ir_build_cast(&ctx->builder, IR_OP_ZEXT, result_bool,
+                         ir_type_int(ctx->module, 32));
   *type_out = codegen_int_type_desc();
   return 1;
 }
@@ -1871,6 +2565,18 @@ static int codegen_expression_type(FunctionContext *ctx, const ParserNode *node,
     return 1;
   }
 
+  if (node->type == PARSER_NODE_POSTFIX ||
+      (node->type == PARSER_NODE_UNARY &&
+       (token_is_punct(node->token, "++") ||
+        token_is_punct(node->token, "--")))) {
+    if (!node->first_child || node->first_child->next) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected increment operand");
+    }
+
+    return codegen_expression_type(ctx, node->first_child, type_out);
+  }
+
   if (node->type == PARSER_NODE_UNARY) {
     const ParserNode *operand = node->first_child;
     TypeDesc operand_type;
@@ -1999,6 +2705,11 @@ static int codegen_expression_type(FunctionContext *ctx, const ParserNode *node,
       return 0;
     }
 
+    if (codegen_is_comparison(node)) {
+      *type_out = codegen_int_type_desc();
+      return 1;
+    }
+
     if (token_is_punct(node->token, "+")) {
       if (left_type.pointer_depth > 0 && codegen_type_is_integer(right_type)) {
         *type_out = left_type;
@@ -2028,72 +2739,365 @@ static int codegen_expression_type(FunctionContext *ctx, const ParserNode *node,
   return codegen_set_error(ctx->codegen, "codegen: expected expression");
 }
 
-static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
-                                   char *value, size_t value_size,
-                                   TypeDesc *type_out) {
-  if (node->type == PARSER_NODE_NUMBER) {
-    if (node->token.type != TOKEN_NUMBER) {
-      return codegen_set_error(ctx->codegen, "codegen: expected number token");
-    }
-
-    if (node->first_child) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: unexpected expression child");
-    }
+/*
+ * Bitcasts a pointer to the exact IR type of its destination slot. Callers
+ * have already checked that an integer here is a null pointer literal.
+ */
+static IrValue *codegen_coerce_pointer(FunctionContext *ctx, IrValue *value,
+                                       IrType *type) {
+  if (!value || value->type == type) {
+    return value;
+  }
 
-    snprintf(value, value_size, "%ld", node->token.value);
-    *type_out = codegen_int_type_desc();
-    return 1;
+  if (value->kind == IR_VALUE_NULL || value->kind == IR_VALUE_CONST_INT) {
+    return ir_const_null(ctx->module, type);
   }
 
-  if (node->type == PARSER_NODE_SIZEOF) {
-    TypeDesc target_type;
+  return ir_build_cast(&ctx->builder, IR_OP_BITCAST, value, type);
+}
 
-    if (node->first_child) {
-      if (node->first_child->next) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected sizeof operand");
+/*
+ * Applies the arithmetic operator op to two values already emitted: + - *
+ * / % on integers after promotion to int, or + and - of a pointer and an
+ * integer as a GEP.
+ */
+static int codegen_emit_arithmetic(FunctionContext *ctx, Token op,
+                                   IrValue *left_value, TypeDesc left_type,
+                                   IrValue *right_value, TypeDesc right_type,
+                                   IrValue **value, TypeDesc *type_out) {
+  IrValue *pointer_value = NULL;
+  IrValue *offset_value = NULL;
+  TypeDesc pointer_type;
+  TypeDesc element_type;
+  TypeDesc offset_type;
+  IrOpcode opcode;
+
+  if (token_is_punct(op, "+")) {
+    if (left_type.pointer_depth > 0 && codegen_type_is_integer(right_type)) {
+      pointer_type = left_type;
+      pointer_value = left_value;
+      offset_type = right_type;
+      offset_value = right_value;
+    } else if (right_type.pointer_depth > 0 &&
+               codegen_type_is_integer(left_type)) {
+      pointer_type = right_type;
+      pointer_value = right_value;
+      offset_type = left_type;
+      offset_value = left_value;
+    }
+
+    if (pointer_value) {
+      element_type = pointer_type;
+      element_type.pointer_depth--;
+      if (!codegen_emit_integer_cast(ctx, offset_type, codegen_int_type_desc(),
+                                     &offset_value)) {
+        return 0;
       }
-
-      if (!codegen_expression_type(ctx, node->first_child, &target_type)) {
+      *value = ir_build_gep(&ctx->builder, codegen_inbounds(ctx),
+                            codegen_lower_type(ctx->module, element_type),
+                            pointer_value, &offset_value, 1);
+      *type_out = pointer_type;
+      return 1;
+    }
+    opcode = IR_OP_ADD;
+  } else if (token_is_punct(op, "-")) {
+    if (left_type.pointer_depth > 0 && codegen_type_is_integer(right_type)) {
+      element_type = left_type;
+      element_type.pointer_depth--;
+      if (!codegen_emit_integer_cast(ctx, right_type, codegen_int_type_desc(),
+                                     &right_value)) {
         return 0;
       }
-    } else {
-      target_type = codegen_make_type_desc(node->type_token,
-                                           node->pointer_depth, node->is_const);
+      offset_value = ir_build_binary(&ctx->builder, IR_OP_SUB, 0,
+                                     codegen_i32(ctx, 0), right_value);
+      *value = ir_build_gep(&ctx->builder, codegen_inbounds(ctx),
+                            codegen_lower_type(ctx->module, element_type),
+                            left_value, &offset_value, 1);
+      *type_out = left_type;
+      return 1;
     }
+    opcode = IR_OP_SUB;
+  } else if (token_is_punct(op, "*")) {
+    opcode = IR_OP_MUL;
+  } else if (token_is_punct(op, "/")) {
+    opcode = IR_OP_SDIV;
+  } else if (token_is_punct(op, "%")) {
+    opcode = IR_OP_SREM;
+  } else {
+    return codegen_set_error(ctx->codegen, "codegen: expected binary operator");
+  }
 
-    if (!codegen_emit_sizeof_type(ctx, target_type, value, value_size)) {
-      return 0;
-    }
+  if (!codegen_type_is_integer(left_type) ||
+      !codegen_type_is_integer(right_type)) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected integer operands");
+  }
 
-    *type_out = codegen_int_type_desc();
+  /* Integer promotion: narrower operands are widened to int. */
+  if (!codegen_emit_integer_cast(ctx, left_type, codegen_int_type_desc(),
+                                 &left_value) ||
+      !codegen_emit_integer_cast(ctx, right_type, codegen_int_type_desc(),
+                                 &right_value)) {
+    return 0;
+  }
+
+  *type_out = codegen_int_type_desc();
+  if (codegen_emit_strength_reduced(ctx, opcode, left_value, right_value,
+                                    value)) {
     return 1;
   }
 
-  if (node->type == PARSER_NODE_CAST) {
-    const ParserNode *operand = node->first_child;
-    char operand_value[32];
-    char cast_value[32];
-    char from_type[32];
-    char to_type[32];
-    TypeDesc target_type;
-    TypeDesc operand_type;
+  *value = ir_build_binary(
+    &ctx->builder, opcode,
+    opcode == IR_OP_SDIV || opcode == IR_OP_SREM ? 0 : codegen_nsw(ctx),
+    left_value, right_value);
+  return 1;
+}
+
+/*
+ * Emits the address of an assignment target and resolves its type: a
+ * local or global scalar, a dereference, a member, or an element.
+ */
+static int codegen_emit_lvalue(FunctionContext *ctx, const ParserNode *target,
+                               IrValue **address, TypeDesc *type_out) {
+  const LocalSymbol *local = NULL;
+  const GlobalSymbol *global = NULL;
+  TypeDesc target_type;
+
+  if (target->type == PARSER_NODE_UNARY &&
+      token_is_punct(target->token, "*")) {
+    const ParserNode *operand = target->first_child;
+    TypeDesc pointer_type;
 
     if (!operand || operand->next) {
-      return codegen_set_error(ctx->codegen, "codegen: expected cast operand");
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected assignment target");
     }
 
-    target_type = codegen_make_type_desc(node->type_token, node->pointer_depth,
-                                         node->is_const);
-    if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
-                              ctx->typedefs, ctx->typedef_count, target_type,
+    if (!codegen_emit_expression(ctx, operand, address, &pointer_type)) {
+      return 0;
+    }
+
+    if (pointer_type.pointer_depth <= 0) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected pointer assignment");
+    }
+
+    target_type = pointer_type;
+    target_type.pointer_depth--;
+    if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
+                              ctx->typedefs, ctx->typedef_count, target_type,
+                              &target_type)) {
+      return 0;
+    }
+    if (target_type.is_const) {
+      return codegen_set_error(ctx->codegen, "codegen: assignment to const");
+    }
+
+    *type_out = target_type;
+    return 1;
+  }
+
+  if (target->type == PARSER_NODE_MEMBER ||
+      target->type == PARSER_NODE_INDEX) {
+    if (target->type == PARSER_NODE_MEMBER) {
+      if (!codegen_emit_member_pointer(ctx, target, address, &target_type)) {
+        return 0;
+      }
+    } else if (!codegen_emit_index_pointer(ctx, target, address,
+                                           &target_type)) {
+      return 0;
+    }
+
+    if (target_type.pointer_depth == 0 &&
+        target_type.type_token.type == TOKEN_STRUCT) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: struct value not supported");
+    }
+
+    if (target_type.is_const) {
+      return codegen_set_error(ctx->codegen, "codegen: assignment to const");
+    }
+
+    *type_out = target_type;
+    return 1;
+  }
+
+  if (target->type != PARSER_NODE_IDENTIFIER) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected assignment target");
+  }
+
+  local = codegen_find_local(ctx, target->token);
+  if (local) {
+    if (local->is_const) {
+      return codegen_set_error(ctx->codegen, "codegen: assignment to const");
+    }
+
+    if (local->array_length > 0) {
+      return codegen_set_error(ctx->codegen, "codegen: assignment to array");
+    }
+
+    target_type = codegen_make_type_desc(local->type_token,
+                                         local->pointer_depth, local->is_const);
+    if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
+                              target_type, type_out)) {
+      return 0;
+    }
+
+    *address = local->address;
+    return 1;
+  }
+
+  if (codegen_find_param(ctx, target->token)) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: assignment to parameter not supported");
+  }
+
+  global = codegen_find_global(ctx, target->token);
+  if (!global) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: unknown assignment target");
+  }
+
+  if (global->is_const) {
+    return codegen_set_error(ctx->codegen, "codegen: assignment to const");
+  }
+
+  if (global->array_length > 0) {
+    return codegen_set_error(ctx->codegen, "codegen: assignment to array");
+  }
+
+  target_type = codegen_make_type_desc(global->type_token,
+                                       global->pointer_depth, global->is_const);
+  if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
+                            target_type, type_out)) {
+    return 0;
+  }
+
+  *address = codegen_global_address(ctx, target->token);
+  return *address != NULL;
+}
+
+static int codegen_is_increment(const ParserNode *node) {
+  return node->type == PARSER_NODE_POSTFIX ||
+         (node->type == PARSER_NODE_UNARY &&
+          (token_is_punct(node->token, "++") ||
+           token_is_punct(node->token, "--")));
+}
+
+/*
+ * ++x, --x, x++, or x--: loads the target once, adds or subtracts one,
+ * and stores it back through the same address. The result is the new
+ * value for the prefix forms and the old one for the postfix forms.
+ */
+static int codegen_emit_increment(FunctionContext *ctx, const ParserNode *node,
+                                  IrValue **value, TypeDesc *type_out) {
+  const ParserNode *target = node->first_child;
+  IrValue *address = NULL;
+  IrValue *old_value = NULL;
+  IrValue *new_value = NULL;
+  TypeDesc target_type;
+  TypeDesc new_type;
+  Token op = node->token;
+
+  if (!target || target->next) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected increment operand");
+  }
+
+  if (!codegen_emit_lvalue(ctx, target, &address, &target_type)) {
+    return 0;
+  }
+
+  old_value = ir_build_load(&ctx->builder, address);
+
+  /* "++" adds and "--" subtracts. */
+  op.length = 1;
+  if (!codegen_emit_arithmetic(ctx, op, old_value, target_type,
+                               codegen_i32(ctx, 1), codegen_int_type_desc(),
+                               &new_value, &new_type)) {
+    return 0;
+  }
+
+  if (target_type.pointer_depth > 0) {
+    new_value = codegen_coerce_pointer(
+      ctx, new_value, codegen_lower_type(ctx->module, target_type));
+  } else if (!codegen_emit_integer_cast(
+               ctx, new_type,
+               codegen_make_type_desc(target_type.type_token, 0, 0),
+               &new_value)) {
+    return 0;
+  }
+
+  ir_build_store(&ctx->builder, new_value, address);
+  *value = node->type == PARSER_NODE_POSTFIX ? old_value : new_value;
+  *type_out = target_type;
+  return 1;
+}
+
+static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
+                                   IrValue **value, TypeDesc *type_out) {
+  if (node->type == PARSER_NODE_NUMBER) {
+    if (node->token.type != TOKEN_NUMBER) {
+      return codegen_set_error(ctx->codegen, "codegen: expected number token");
+    }
+
+    if (node->first_child) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: unexpected expression child");
+    }
+
+    *value = codegen_i32(ctx, node->token.value);
+    *type_out = codegen_int_type_desc();
+    return 1;
+  }
+
+  if (node->type == PARSER_NODE_SIZEOF) {
+    TypeDesc target_type;
+
+    if (node->first_child) {
+      if (node->first_child->next) {
+        return codegen_set_error(ctx->codegen,
+                                 "codegen: expected sizeof operand");
+      }
+
+      if (!codegen_expression_type(ctx, node->first_child, &target_type)) {
+        return 0;
+      }
+    } else {
+      target_type = codegen_make_type_desc(node->type_token,
+                                           node->pointer_depth, node->is_const);
+    }
+
+    if (!codegen_emit_sizeof_type(ctx, target_type, value)) {
+      return 0;
+    }
+
+    *type_out = codegen_int_type_desc();
+    return 1;
+  }
+
+  if (node->type == PARSER_NODE_CAST) {
+    const ParserNode *operand = node->first_child;
+    IrValue *operand_value = NULL;
+    TypeDesc target_type;
+    TypeDesc operand_type;
+
+    if (!operand || operand->next) {
+      return codegen_set_error(ctx->codegen, "codegen: expected cast operand");
+    }
+
+    target_type = codegen_make_type_desc(node->type_token, node->pointer_depth,
+                                         node->is_const);
+    if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
+                              ctx->typedefs, ctx->typedef_count, target_type,
                               &target_type)) {
       return 0;
     }
 
-    if (!codegen_emit_expression(ctx, operand, operand_value,
-                                 sizeof(operand_value), &operand_type)) {
+    if (!codegen_emit_expression(ctx, operand, &operand_value,
+                                 &operand_type)) {
       return 0;
     }
 
@@ -2110,33 +3114,26 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     }
 
     if (target_type.pointer_depth > 0) {
+      IrType *to_type = codegen_lower_type(ctx->module, target_type);
+
       if (operand_type.pointer_depth > 0) {
-        if (!codegen_pointer_compatible(target_type, operand_type) &&
-            operand_type.type_token.type != TOKEN_VOID &&
-            target_type.type_token.type != TOKEN_VOID) {
-          /* explicit cast allows incompatible pointer types */
-        }
-        codegen_format_desc_type(operand_type, from_type, sizeof(from_type));
-        codegen_format_desc_type(target_type, to_type, sizeof(to_type));
-        if (strcmp(from_type, to_type) == 0) {
-          snprintf(value, value_size, "%s", operand_value);
-        } else {
-          snprintf(cast_value, sizeof(cast_value), "%%t%d",
-                   ctx->next_temp_id++);
-          fprintf(ctx->out, "  %s = bitcast %s %s to %s\n", cast_value,
-                  from_type, operand_value, to_type);
-          snprintf(value, value_size, "%s", cast_value);
-        }
+        /* Explicit casts allow incompatible pointer types. */
+        *value = operand_value && operand_value->type == to_type
+                   ? operand_value
+                   : ir_build_cast(&ctx->builder, IR_OP_BITCAST,
+                                   operand_value, to_type);
       } else {
         if (!codegen_type_is_integer(operand_type)) {
           return codegen_set_error(ctx->codegen,
                                    "codegen: expected integer cast source");
         }
-        codegen_format_desc_type(target_type, to_type, sizeof(to_type));
-        snprintf(cast_value, sizeof(cast_value), "%%t%d", ctx->next_temp_id++);
-        fprintf(ctx->out, "  %s = inttoptr i32 %s to %s\n", cast_value,
-                operand_value, to_type);
-        snprintf(value, value_size, "%s", cast_value);
+        if (!codegen_emit_integer_cast(ctx, operand_type,
+                                       codegen_int_type_desc(),
+                                       &operand_value)) {
+          return 0;
+        }
+        *value = ir_build_cast(&ctx->builder, IR_OP_INTTOPTR, operand_value,
+                               to_type);
       }
 
       *type_out = target_type;
@@ -2144,11 +3141,8 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     }
 
     if (operand_type.pointer_depth > 0) {
-      codegen_format_desc_type(operand_type, from_type, sizeof(from_type));
-      snprintf(cast_value, sizeof(cast_value), "%%t%d", ctx->next_temp_id++);
-      fprintf(ctx->out, "  %s = ptrtoint %s %s to i32\n", cast_value, from_type,
-              operand_value);
-      snprintf(operand_value, sizeof(operand_value), "%s", cast_value);
+      operand_value = ir_build_cast(&ctx->builder, IR_OP_PTRTOINT,
+                                    operand_value, codegen_i32(ctx, 0)->type);
       operand_type = codegen_int_type_desc();
     }
 
@@ -2158,25 +3152,23 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     }
 
     if (!codegen_emit_integer_cast(ctx, operand_type, target_type,
-                                   operand_value, sizeof(operand_value))) {
+                                   &operand_value)) {
       return 0;
     }
 
-    snprintf(value, value_size, "%s", operand_value);
+    *value = operand_value;
     *type_out = target_type;
     return 1;
   }
 
   if (node->type == PARSER_NODE_CALL) {
     const FunctionSymbol *symbol = NULL;
+    IrFunction *callee = NULL;
     const ParserNode *arg = NULL;
     const ParserNode *param = NULL;
     size_t arg_count = 0;
     size_t index = 0;
-    typedef char NameBuffer[32];
-    NameBuffer *arg_values = NULL;
-    NameBuffer *arg_types = NULL;
-    char type_name[32];
+    IrValue **arg_values = NULL;
     TypeDesc return_type;
 
     if (node->token.type != TOKEN_IDENT) {
@@ -2185,17 +3177,16 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     }
 
     symbol = codegen_find_function(ctx, node->token);
-    if (!symbol) {
+    callee = ir_module_find_function(ctx->module, node->token.start,
+                                     node->token.length);
+    if (!symbol || !callee) {
       return codegen_set_error(ctx->codegen, "codegen: unknown function");
     }
 
     arg_count = symbol->param_count;
     if (arg_count > 0) {
       arg_values = malloc(arg_count * sizeof(*arg_values));
-      arg_types = malloc(arg_count * sizeof(*arg_types));
-      if (!arg_values || !arg_types) {
-        free(arg_values);
-        free(arg_types);
+      if (!arg_values) {
         return codegen_set_error(ctx->codegen, "codegen: out of memory");
       }
     }
@@ -2208,15 +3199,12 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
 
       if (!arg || !param) {
         free(arg_values);
-        free(arg_types);
         return codegen_set_error(ctx->codegen,
                                  "codegen: argument count mismatch");
       }
 
-      if (!codegen_emit_expression(ctx, arg, arg_values[index],
-                                   sizeof(arg_values[index]), &arg_type)) {
+      if (!codegen_emit_expression(ctx, arg, &arg_values[index], &arg_type)) {
         free(arg_values);
-        free(arg_types);
         return 0;
       }
 
@@ -2226,45 +3214,36 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                 ctx->typedefs, ctx->typedef_count, param_type,
                                 &param_type)) {
         free(arg_values);
-        free(arg_types);
         return 0;
       }
 
       if (param_type.pointer_depth > 0) {
-        if (arg_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(arg)) {
-          snprintf(arg_values[index], sizeof(arg_values[index]), "null");
-        } else if (!codegen_pointer_compatible(param_type, arg_type)) {
+        if (!(arg_type.pointer_depth == 0 &&
+              codegen_is_null_pointer_literal(arg)) &&
+            !codegen_pointer_compatible(param_type, arg_type)) {
           free(arg_values);
-          free(arg_types);
           return codegen_set_error(ctx->codegen,
                                    "codegen: argument type mismatch");
         }
+        arg_values[index] = codegen_coerce_pointer(
+          ctx, arg_values[index],
+          codegen_lower_type(ctx->module, param_type));
       } else {
         if (param_type.type_token.type == TOKEN_STRUCT) {
           free(arg_values);
-          free(arg_types);
           return codegen_set_error(ctx->codegen,
                                    "codegen: struct argument not supported");
         }
 
         if (!codegen_type_is_integer(arg_type)) {
           free(arg_values);
-          free(arg_types);
           return codegen_set_error(ctx->codegen,
                                    "codegen: expected integer argument");
         }
-      }
-
-      codegen_format_desc_type(param_type, arg_types[index],
-                               sizeof(arg_types[index]));
 
-      if (param_type.pointer_depth == 0) {
         if (!codegen_emit_integer_cast(ctx, arg_type, param_type,
-                                       arg_values[index],
-                                       sizeof(arg_values[index]))) {
+                                       &arg_values[index])) {
           free(arg_values);
-          free(arg_types);
           return 0;
         }
       }
@@ -2275,7 +3254,6 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
 
     if (arg) {
       free(arg_values);
-      free(arg_types);
       return codegen_set_error(ctx->codegen,
                                "codegen: argument count mismatch");
     }
@@ -2286,24 +3264,11 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                               ctx->typedefs, ctx->typedef_count, return_type,
                               &return_type)) {
       free(arg_values);
-      free(arg_types);
       return 0;
     }
 
-    codegen_format_desc_type(return_type, type_name, sizeof(type_name));
-
-    snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = call %s @%.*s(", value, type_name,
-            (int)node->token.length, node->token.start);
-    for (index = 0; index < arg_count; index++) {
-      if (index > 0) {
-        fprintf(ctx->out, ", ");
-      }
-      fprintf(ctx->out, "%s %s", arg_types[index], arg_values[index]);
-    }
-    fprintf(ctx->out, ")\n");
+    *value = ir_build_call(&ctx->builder, callee, arg_values, arg_count);
     free(arg_values);
-    free(arg_types);
     *type_out = return_type;
     return 1;
   }
@@ -2312,8 +3277,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     const LocalSymbol *local = NULL;
     const ParserNode *param = NULL;
     const GlobalSymbol *symbol = NULL;
-    char value_type[32];
-    char pointer_type[32];
+    IrValue *address = NULL;
     TypeDesc desc;
     TypeDesc resolved;
 
@@ -2337,8 +3301,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
 
       if (local->array_length > 0) {
         return codegen_emit_array_decay(ctx, resolved, local->array_length,
-                                        local->ir_name, value, value_size,
-                                        type_out);
+                                        local->address, value, type_out);
       }
 
       if (resolved.pointer_depth == 0 &&
@@ -2347,13 +3310,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                  "codegen: struct value not supported");
       }
 
-      codegen_format_desc_type(resolved, value_type, sizeof(value_type));
-      codegen_format_type(resolved.type_token, resolved.pointer_depth + 1,
-                          pointer_type, sizeof(pointer_type));
-
-      snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-      fprintf(ctx->out, "  %s = load %s, %s %s\n", value, value_type,
-              pointer_type, local->ir_name);
+      *value = ir_build_load(&ctx->builder, local->address);
       *type_out = resolved;
       return 1;
     }
@@ -2373,8 +3330,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                  "codegen: struct value not supported");
       }
 
-      snprintf(value, value_size, "%%%.*s", (int)param->token.length,
-               param->token.start);
+      *value = codegen_param_value(ctx, node->token);
       *type_out = resolved;
       return 1;
     }
@@ -2382,7 +3338,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     {
       const EnumSymbol *enum_val = codegen_find_enum(ctx, node->token);
       if (enum_val) {
-        snprintf(value, value_size, "%d", enum_val->value);
+        *value = codegen_i32(ctx, enum_val->value);
         *type_out = codegen_int_type_desc();
         return 1;
       }
@@ -2400,13 +3356,14 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
       return 0;
     }
 
-    if (symbol->array_length > 0) {
-      char base_name[64];
+    address = codegen_global_address(ctx, node->token);
+    if (!address) {
+      return 0;
+    }
 
-      snprintf(base_name, sizeof(base_name), "@%.*s", (int)node->token.length,
-               node->token.start);
+    if (symbol->array_length > 0) {
       return codegen_emit_array_decay(ctx, resolved, symbol->array_length,
-                                      base_name, value, value_size, type_out);
+                                      address, value, type_out);
     }
 
     if (resolved.pointer_depth == 0 &&
@@ -2415,25 +3372,17 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                "codegen: struct value not supported");
     }
 
-    codegen_format_desc_type(resolved, value_type, sizeof(value_type));
-    codegen_format_type(resolved.type_token, resolved.pointer_depth + 1,
-                        pointer_type, sizeof(pointer_type));
-
-    snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = load %s, %s @%.*s\n", value, value_type,
-            pointer_type, (int)node->token.length, node->token.start);
+    *value = ir_build_load(&ctx->builder, address);
     *type_out = resolved;
     return 1;
   }
 
   if (node->type == PARSER_NODE_MEMBER) {
-    char member_pointer[32];
-    char value_type[32];
-    char pointer_type[32];
+    IrValue *member_pointer = NULL;
     TypeDesc field_type;
 
-    if (!codegen_emit_member_pointer(ctx, node, member_pointer,
-                                     sizeof(member_pointer), &field_type)) {
+    if (!codegen_emit_member_pointer(ctx, node, &member_pointer,
+                                     &field_type)) {
       return 0;
     }
 
@@ -2443,25 +3392,17 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                "codegen: struct value not supported");
     }
 
-    codegen_format_desc_type(field_type, value_type, sizeof(value_type));
-    codegen_format_type(field_type.type_token, field_type.pointer_depth + 1,
-                        pointer_type, sizeof(pointer_type));
-
-    snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = load %s, %s %s\n", value, value_type,
-            pointer_type, member_pointer);
+    *value = ir_build_load(&ctx->builder, member_pointer);
     *type_out = field_type;
     return 1;
   }
 
   if (node->type == PARSER_NODE_INDEX) {
-    char element_pointer[32];
-    char value_type[32];
-    char pointer_type[32];
+    IrValue *element_pointer = NULL;
     TypeDesc element_type;
 
-    if (!codegen_emit_index_pointer(ctx, node, element_pointer,
-                                    sizeof(element_pointer), &element_type)) {
+    if (!codegen_emit_index_pointer(ctx, node, &element_pointer,
+                                    &element_type)) {
       return 0;
     }
 
@@ -2471,22 +3412,19 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                "codegen: struct value not supported");
     }
 
-    codegen_format_desc_type(element_type, value_type, sizeof(value_type));
-    codegen_format_type(element_type.type_token, element_type.pointer_depth + 1,
-                        pointer_type, sizeof(pointer_type));
-
-    snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = load %s, %s %s\n", value, value_type,
-            pointer_type, element_pointer);
+    *value = ir_build_load(&ctx->builder, element_pointer);
     *type_out = element_type;
     return 1;
   }
 
+  if (codegen_is_increment(node)) {
+    return codegen_emit_increment(ctx, node, value, type_out);
+  }
+
   if (node->type == PARSER_NODE_UNARY) {
     const ParserNode *operand = node->first_child;
-    char operand_value[32];
-    char temp[32];
-    char result[32];
+    IrValue *operand_value = NULL;
+    IrValue *is_zero = NULL;
     TypeDesc operand_type;
 
     if (!operand || operand->next) {
@@ -2508,8 +3446,10 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
         return codegen_set_error(ctx->codegen, "codegen: unknown global");
       }
 
-      snprintf(value, value_size, "@%.*s", (int)operand->token.length,
-               operand->token.start);
+      *value = codegen_global_address(ctx, operand->token);
+      if (!*value) {
+        return 0;
+      }
       base_desc = codegen_make_type_desc(
         symbol->type_token, symbol->pointer_depth, symbol->is_const);
       if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
@@ -2521,30 +3461,27 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
       return 1;
     }
 
-    if (!codegen_emit_expression(ctx, operand, operand_value,
-                                 sizeof(operand_value), &operand_type)) {
+    if (!codegen_emit_expression(ctx, operand, &operand_value,
+                                 &operand_type)) {
       return 0;
     }
 
     if (token_is_punct(node->token, "!")) {
-      snprintf(temp, sizeof(temp), "%%t%d", ctx->next_temp_id++);
       if (codegen_type_is_integer(operand_type)) {
-        fprintf(ctx->out, "  %s = icmp eq i32 %s, 0\n", temp, operand_value);
-      } else if (operand_type.pointer_depth > 0) {
-        char type_name[32];
-
-        codegen_format_desc_type(operand_type, type_name, sizeof(type_name));
-        fprintf(ctx->out, "  %s = icmp eq %s %s, null\n", temp, type_name,
-                operand_value);
-      } else {
+        if (!codegen_emit_integer_cast(ctx, operand_type,
+                                       codegen_int_type_desc(),
+                                       &operand_value)) {
+          return 0;
+        }
+      } else if (operand_type.pointer_depth == 0) {
         return codegen_set_error(ctx->codegen,
                                  "codegen: expected condition operand");
       }
 
-      snprintf(result, sizeof(result), "%%t%d", ctx->next_temp_id++);
-      fprintf(ctx->out, "  %s = zext i1 %s to i32\n", result, temp);
-
-      snprintf(value, value_size, "%s", result);
+      is_zero = ir_build_icmp(&ctx->builder, IR_PRED_EQ, operand_value,
+                              codegen_zero_of(ctx, operand_value));
+      *value = ir_build_cast(&ctx->builder, IR_OP_ZEXT, is_zero,
+                             codegen_i32(ctx, 0)->type);
       *type_out = codegen_int_type_desc();
       return 1;
     }
@@ -2555,7 +3492,7 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                  "codegen: expected integer operand");
       }
 
-      snprintf(value, value_size, "%s", operand_value);
+      *value = operand_value;
       *type_out = operand_type;
       return 1;
     }
@@ -2566,24 +3503,22 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
                                  "codegen: expected integer operand");
       }
 
-      snprintf(result, sizeof(result), "%%t%d", ctx->next_temp_id++);
-      fprintf(ctx->out, "  %s = sub i32 0, %s\n", result, operand_value);
-      snprintf(value, value_size, "%s", result);
+      if (!codegen_emit_integer_cast(ctx, operand_type,
+                                     codegen_int_type_desc(), &operand_value)) {
+        return 0;
+      }
+      *value = ir_build_binary(&ctx->builder, IR_OP_SUB, codegen_nsw(ctx),
+                               codegen_i32(ctx, 0), operand_value);
       *type_out = codegen_int_type_desc();
       return 1;
     }
 
     if (token_is_punct(node->token, "*")) {
-      char load_type[32];
-      char pointer_type[32];
-
       if (operand_type.pointer_depth <= 0) {
         return codegen_set_error(ctx->codegen,
                                  "codegen: expected pointer operand");
       }
 
-      codegen_format_desc_type(operand_type, pointer_type,
-                               sizeof(pointer_type));
       operand_type.pointer_depth--;
       if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
                                 ctx->typedefs, ctx->typedef_count, operand_type,
@@ -2595,12 +3530,8 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
         return codegen_set_error(ctx->codegen,
                                  "codegen: struct value not supported");
       }
-      codegen_format_desc_type(operand_type, load_type, sizeof(load_type));
 
-      snprintf(result, sizeof(result), "%%t%d", ctx->next_temp_id++);
-      fprintf(ctx->out, "  %s = load %s, %s %s\n", result, load_type,
-              pointer_type, operand_value);
-      snprintf(value, value_size, "%s", result);
+      *value = ir_build_load(&ctx->builder, operand_value);
       *type_out = operand_type;
       return 1;
     }
@@ -2611,15 +3542,9 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
   if (node->type == PARSER_NODE_BINARY) {
     const ParserNode *left = node->first_child;
     const ParserNode *right = left ? left->next : NULL;
-    char left_value[32];
-    char right_value[32];
-    char pointer_value[32];
-    char offset_value[32];
-    char element_type_name[32];
-    char pointer_type_name[32];
-    TypeDesc pointer_type;
-    TypeDesc element_type;
-    const char *opcode = NULL;
+    IrValue *left_value = NULL;
+    IrValue *right_value = NULL;
+    IrValue *bool_value = NULL;
     TypeDesc left_type;
     TypeDesc right_type;
 
@@ -2629,220 +3554,276 @@ static int codegen_emit_expression(FunctionContext *ctx, const ParserNode *node,
     }
 
     if (token_is_punct(node->token, "&&")) {
-      return codegen_emit_logical_binary(ctx, node, value, value_size, 1,
-                                         type_out);
+      return codegen_emit_logical_binary(ctx, node, value, 1, type_out);
     }
 
     if (token_is_punct(node->token, "||")) {
-      return codegen_emit_logical_binary(ctx, node, value, value_size, 0,
-                                         type_out);
+      return codegen_emit_logical_binary(ctx, node, value, 0, type_out);
     }
 
-    if (!codegen_emit_expression(ctx, left, left_value, sizeof(left_value),
-                                 &left_type)) {
-      return 0;
-    }
+    if (codegen_is_comparison(node)) {
+      if (!codegen_emit_comparison(ctx, node, &bool_value)) {
+        return 0;
+      }
 
-    if (!codegen_emit_expression(ctx, right, right_value, sizeof(right_value),
-                                 &right_type)) {
-      return 0;
+      *value = ir_build_cast(&ctx->builder, IR_OP_ZEXT, bool_value,
+                             codegen_i32(ctx, 0)->type);
+      *type_out = codegen_int_type_desc();
+      return 1;
     }
 
-    if (token_is_punct(node->token, "+")) {
-      if (left_type.pointer_depth > 0 && codegen_type_is_integer(right_type)) {
-        pointer_type = left_type;
-        element_type = left_type;
-        element_type.pointer_depth--;
-        codegen_format_desc_type(element_type, element_type_name,
-                                 sizeof(element_type_name));
-        codegen_format_desc_type(pointer_type, pointer_type_name,
-                                 sizeof(pointer_type_name));
-        snprintf(pointer_value, sizeof(pointer_value), "%s", left_value);
-        snprintf(offset_value, sizeof(offset_value), "%s", right_value);
-        snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-        fprintf(ctx->out, "  %s = getelementptr %s, %s %s, i32 %s\n", value,
-                element_type_name, pointer_type_name, pointer_value,
-                offset_value);
-        *type_out = pointer_type;
-        return 1;
-      }
-      if (right_type.pointer_depth > 0 && codegen_type_is_integer(left_type)) {
-        pointer_type = right_type;
-        element_type = right_type;
-        element_type.pointer_depth--;
-        codegen_format_desc_type(element_type, element_type_name,
-                                 sizeof(element_type_name));
-        codegen_format_desc_type(pointer_type, pointer_type_name,
-                                 sizeof(pointer_type_name));
-        snprintf(pointer_value, sizeof(pointer_value), "%s", right_value);
-        snprintf(offset_value, sizeof(offset_value), "%s", left_value);
-        snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-        fprintf(ctx->out, "  %s = getelementptr %s, %s %s, i32 %s\n", value,
-                element_type_name, pointer_type_name, pointer_value,
-                offset_value);
-        *type_out = pointer_type;
-        return 1;
-      }
-      opcode = "add";
-    } else if (token_is_punct(node->token, "-")) {
-      if (left_type.pointer_depth > 0 && codegen_type_is_integer(right_type)) {
-        char neg_value[32];
-
-        pointer_type = left_type;
-        element_type = left_type;
-        element_type.pointer_depth--;
-        codegen_format_desc_type(element_type, element_type_name,
-                                 sizeof(element_type_name));
-        codegen_format_desc_type(pointer_type, pointer_type_name,
-                                 sizeof(pointer_type_name));
-        snprintf(pointer_value, sizeof(pointer_value), "%s", left_value);
-        snprintf(neg_value, sizeof(neg_value), "%%t%d", ctx->next_temp_id++);
-        fprintf(ctx->out, "  %s = sub i32 0, %s\n", neg_value, right_value);
-        snprintf(offset_value, sizeof(offset_value), "%s", neg_value);
-        snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-        fprintf(ctx->out, "  %s = getelementptr %s, %s %s, i32 %s\n", value,
-                element_type_name, pointer_type_name, pointer_value,
-                offset_value);
-        *type_out = pointer_type;
-        return 1;
-      }
-      opcode = "sub";
-    } else if (token_is_punct(node->token, "*")) {
-      opcode = "mul";
-    } else if (token_is_punct(node->token, "/")) {
-      opcode = "sdiv";
-    } else if (token_is_punct(node->token, "%")) {
-      opcode = "srem";
-    } else {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: expected binary operator");
+    if (!codegen_emit_expression(ctx, left, &left_value, &left_type)) {
+      return 0;
     }
 
-    if (!codegen_type_is_integer(left_type) ||
-        !codegen_type_is_integer(right_type)) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: expected integer operands");
+    if (!codegen_emit_expression(ctx, right, &right_value, &right_type)) {
+      return 0;
     }
 
-    snprintf(value, value_size, "%%t%d", ctx->next_temp_id++);
-    fprintf(ctx->out, "  %s = %s i32 %s, %s\n", value, opcode, left_value,
-            right_value);
-    *type_out = codegen_int_type_desc();
-    return 1;
+    return codegen_emit_arithmetic(ctx, node->token, left_value, left_type,
+                                   right_value, right_type, value, type_out);
   }
 
   return codegen_set_error(ctx->codegen, "codegen: expected expression");
 }
 
-static int codegen_emit_local_declaration(FunctionContext *ctx,
-                                          const ParserNode *node) {
-  LocalSymbol *local = NULL;
-  char type_name[32];
-  char init_value[32];
+/* Stores the value of init, converted to type, to address. */
+static int codegen_emit_initializer_store(FunctionContext *ctx, TypeDesc type,
+                                          const ParserNode *init,
+                                          IrValue *address) {
+  IrType *value_type = codegen_lower_type(ctx->module, type);
+  IrValue *init_value = NULL;
   TypeDesc init_type;
-  TypeDesc declared_type;
-  TypeDesc resolved_type;
-
-  if (node->type != PARSER_NODE_DECLARATION) {
-    return codegen_set_error(ctx->codegen, "codegen: expected declaration");
-  }
 
-  if (node->token.type != TOKEN_IDENT) {
+  if (init->type == PARSER_NODE_INITIALIZER) {
     return codegen_set_error(ctx->codegen,
-                             "codegen: expected identifier token");
+                             "codegen: unexpected initializer list");
   }
 
-  local = codegen_add_local(ctx, node);
-  if (!local) {
+  if (!codegen_emit_expression(ctx, init, &init_value, &init_type)) {
     return 0;
   }
 
-  declared_type = codegen_make_type_desc(node->type_token, node->pointer_depth,
-                                         node->is_const);
-  if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
-                            ctx->typedefs, ctx->typedef_count, declared_type,
-                            &resolved_type)) {
-    return 0;
+  if (type.pointer_depth > 0) {
+    if (!(init_type.pointer_depth == 0 &&
+          codegen_is_null_pointer_literal(init)) &&
+        !codegen_pointer_compatible(type, init_type)) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: initializer type mismatch");
+    }
+    init_value = codegen_coerce_pointer(ctx, init_value, value_type);
+  } else {
+    TypeDesc target_type;
+
+    if (!codegen_type_is_integer(init_type)) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected integer initializer");
+    }
+
+    target_type = codegen_make_type_desc(type.type_token, 0, 0);
+    if (!codegen_emit_integer_cast(ctx, init_type, target_type,
+                                   &init_value)) {
+      return 0;
+    }
   }
 
-  local->type_token = resolved_type.type_token;
-  local->pointer_depth = resolved_type.pointer_depth;
-  local->is_const = resolved_type.is_const;
+  ir_build_store(&ctx->builder, init_value, address);
+  return 1;
+}
 
-  if (node->is_static) {
-    char static_name[128];
+/*
+ * Stores each element a braced initializer gives into the array or
+ * struct at address, which is already zeroed. Zero literals are skipped.
+ */
+static int codegen_emit_initializer_stores(FunctionContext *ctx,
+                                           TypeDesc type, size_t array_length,
+                                           const ParserNode *init,
+                                           IrValue *address) {
+  const StructSymbol *symbol = NULL;
+  const ParserNode *element = NULL;
+  IrType *aggregate_type = NULL;
+  size_t count = array_length;
+  size_t index = 0;
 
-    codegen_format_static_local_name(static_name, sizeof(static_name),
-                                     ctx->function_name,
-                                     ctx->static_local_index, node->token);
-    ctx->static_local_index++;
-    snprintf(local->ir_name, sizeof(local->ir_name), "%s", static_name);
-    return 1;
+  if (!codegen_is_aggregate(type, array_length)) {
+    return codegen_emit_initializer_store(ctx, type, init, address);
   }
 
-  if (node->array_length > 0) {
-    char array_type[64];
+  if (init->type != PARSER_NODE_INITIALIZER) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected initializer list");
+  }
 
-    if (node->first_child) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: array initializer not supported");
+  if (array_length > 0) {
+    aggregate_type = codegen_lower_array_type(ctx->module, type, array_length);
+  } else {
+    symbol =
+      codegen_find_struct(ctx->structs, ctx->struct_count, type.type_token);
+    if (!symbol) {
+      return codegen_set_error(ctx->codegen, "codegen: unknown struct type");
     }
-
-    codegen_format_array_type(resolved_type, node->array_length, array_type,
-                              sizeof(array_type));
-    fprintf(ctx->out, "  %s = alloca %s\n", local->ir_name, array_type);
-    return 1;
+    aggregate_type = codegen_lower_type(ctx->module, type);
+    count = symbol->field_count;
   }
 
-  codegen_format_desc_type(resolved_type, type_name, sizeof(type_name));
-  fprintf(ctx->out, "  %s = alloca %s\n", local->ir_name, type_name);
+  for (element = init->first_child; element && index < count;
+       element = element->next, index++) {
+    TypeDesc element_type = type;
+    IrValue *indices[2];
+    IrValue *pointer = NULL;
 
-  if (!node->first_child) {
-    return 1;
+    if (symbol && !codegen_struct_field_type(ctx->codegen, symbol,
+                                             ctx->typedefs, ctx->typedef_count,
+                                             index, &element_type)) {
+      return 0;
+    }
+    if (element->type == PARSER_NODE_NUMBER && element->token.value == 0) {
+      continue;
+    }
+
+    indices[0] = codegen_i32(ctx, 0);
+    indices[1] = codegen_i32(ctx, (long long)index);
+    pointer = ir_build_gep(&ctx->builder,
+                           symbol ? IR_FLAG_INBOUNDS : codegen_inbounds(ctx),
+                           aggregate_type, address, indices, 2);
+    if (!pointer || !codegen_emit_initializer_stores(ctx, element_type, 0,
+                                                     element, pointer)) {
+      return 0;
+    }
   }
 
-  if (node->first_child->next) {
-    return codegen_set_error(ctx->codegen,
-                             "codegen: unexpected initializer list");
+  if (element) {
+    return codegen_set_error(ctx->codegen, "codegen: too many initializers");
+  }
+  return 1;
+}
+
+/*
+ * Initializes a local array or struct: with one memcpy from the constant
+ * codegen_emit_local_constant made when the initializer is all constants,
+ * and otherwise with a memset to zero and a store per element given.
+ */
+static int codegen_emit_aggregate_initializer(FunctionContext *ctx,
+                                              const ParserNode *node,
+                                              TypeDesc type,
+                                              IrValue *address) {
+  IrModule *module = ctx->module;
+  IrType *bytes = ir_type_pointer(module, ir_type_int(module, 8));
+  IrValue *length = ir_const_int(
+    module, ir_type_int(module, 64),
+    (long long)ir_type_size(address->type->element));
+  IrValue *destination =
+    ir_build_cast(&ctx->builder, IR_OP_BITCAST, address, bytes);
+  const ParserNode *init = node->first_child;
+
+  if (!destination || !length) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
+
+  if (init->type == PARSER_NODE_INITIALIZER &&
+      codegen_initializer_is_constant(ctx->enums, ctx->enum_count, init)) {
+    IrGlobal *global = NULL;
+    char name[128];
+
+    codegen_format_static_local_name(name, sizeof(name), "const",
+                                     ctx->function_name,
+                                     ctx->static_local_index, node->token);
+    ctx->static_local_index++;
+    global = ir_module_find_global(module, name, strlen(name));
+    if (global &&
+        !ir_build_memcpy(
+          &ctx->builder, destination,
+          ir_build_cast(&ctx->builder, IR_OP_BITCAST, &global->value, bytes),
+          length)) {
+      return codegen_set_error(ctx->codegen, "codegen: out of memory");
+    }
+    if (global) {
+      return 1;
+    }
+  }
+
+  if (!ir_build_memset(&ctx->builder, destination,
+                       ir_const_int(module, ir_type_int(module, 8), 0),
+                       length)) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
+  return codegen_emit_initializer_stores(ctx, type, node->array_length, init,
+                                         address);
+}
+
+static int codegen_emit_local_declaration(FunctionContext *ctx,
+                                          const ParserNode *node) {
+  LocalSymbol *local = NULL;
+  IrType *type = NULL;
+  TypeDesc declared_type;
+  TypeDesc resolved_type;
+
+  if (node->type != PARSER_NODE_DECLARATION) {
+    return codegen_set_error(ctx->codegen, "codegen: expected declaration");
   }
 
-  if (resolved_type.pointer_depth == 0 &&
-      resolved_type.type_token.type == TOKEN_STRUCT) {
+  if (node->token.type != TOKEN_IDENT) {
     return codegen_set_error(ctx->codegen,
-                             "codegen: struct initializer not supported");
+                             "codegen: expected identifier token");
   }
 
-  if (!codegen_emit_expression(ctx, node->first_child, init_value,
-                               sizeof(init_value), &init_type)) {
+  local = codegen_add_local(ctx, node);
+  if (!local) {
     return 0;
   }
 
-  if (resolved_type.pointer_depth > 0) {
-    if (init_type.pointer_depth == 0 &&
-        codegen_is_null_pointer_literal(node->first_child)) {
-      snprintf(init_value, sizeof(init_value), "null");
-    } else if (!codegen_pointer_compatible(resolved_type, init_type)) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: initializer type mismatch");
+  declared_type = codegen_make_type_desc(node->type_token, node->pointer_depth,
+                                         node->is_const);
+  if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
+                            ctx->typedefs, ctx->typedef_count, declared_type,
+                            &resolved_type)) {
+    return 0;
+  }
+
+  local->type_token = resolved_type.type_token;
+  local->pointer_depth = resolved_type.pointer_depth;
+  local->is_const = resolved_type.is_const;
+
+  if (node->is_static) {
+    char static_name[128];
+    IrGlobal *global = NULL;
+
+    codegen_format_static_local_name(static_name, sizeof(static_name),
+                                     "static", ctx->function_name,
+                                     ctx->static_local_index, node->token);
+    ctx->static_local_index++;
+    global =
+      ir_module_find_global(ctx->module, static_name, strlen(static_name));
+    if (!global) {
+      return codegen_set_error(ctx->codegen, "codegen: unknown static local");
     }
+    local->address = &global->value;
+    return 1;
+  }
+
+  if (node->array_length > 0) {
+    type = codegen_lower_array_type(ctx->module, resolved_type,
+                                    node->array_length);
   } else {
-    TypeDesc target_type;
+    type = codegen_lower_type(ctx->module, resolved_type);
+  }
+  local->address = ir_build_alloca(&ctx->builder, type);
 
-    if (!codegen_type_is_integer(init_type)) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: expected integer initializer");
-    }
+  if (!node->first_child) {
+    return 1;
+  }
 
-    target_type = codegen_make_type_desc(resolved_type.type_token, 0, 0);
-    if (!codegen_emit_integer_cast(ctx, init_type, target_type, init_value,
-                                   sizeof(init_value))) {
-      return 0;
-    }
+  if (node->first_child->next) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: unexpected initializer list");
   }
 
-  fprintf(ctx->out, "  store %s %s, %s* %s\n", type_name, init_value, type_name,
-          local->ir_name);
-  return 1;
+  if (codegen_is_aggregate(resolved_type, node->array_length)) {
+    return codegen_emit_aggregate_initializer(ctx, node, resolved_type,
+                                              local->address);
+  }
+  return codegen_emit_initializer_store(ctx, resolved_type, node->first_child,
+                                        local->address);
 }
 
 static void codegen_format_label(char *buffer, size_t size, const char *prefix,
@@ -2852,9 +3833,58 @@ static void codegen_format_label(char *buffer, size_t size, const char *prefix,
 
 static int codegen_emit_statement(FunctionContext *ctx, const ParserNode *node);
 
+/* Case labels of a nested switch belong to that switch. */
+static int codegen_contains_case_label(const ParserNode *node) {
+  const ParserNode *child = NULL;
+
+  if (node->type == PARSER_NODE_CASE || node->type == PARSER_NODE_DEFAULT) {
+    return 1;
+  }
+  if (node->type == PARSER_NODE_SWITCH) {
+    return 0;
+  }
+
+  for (child = node->first_child; child; child = child->next) {
+    if (codegen_contains_case_label(child)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Decides whether a statement after a terminator is emitted: only a case
+ * label inside it can make it reachable. Blocks skip ahead to the label
+ * themselves; other statements leading up to a label nested deeper get a
+ * block with no predecessors of their own.
+ */
+static int codegen_resume_after_terminator(FunctionContext *ctx,
+                                           const ParserNode *node,
+                                           int *resume) {
+  IrBlock *dead_block = NULL;
+  char dead_label[32];
+
+  *resume = codegen_contains_case_label(node);
+  if (!*resume || node->type == PARSER_NODE_BLOCK ||
+      node->type == PARSER_NODE_CASE || node->type == PARSER_NODE_DEFAULT) {
+    return 1;
+  }
+
+  codegen_format_label(dead_label, sizeof(dead_label), "sw.skip",
+                       ctx->next_label_id++);
+  dead_block = ir_block_create(ctx->function, dead_label);
+  if (!dead_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
+  ir_builder_set_block(&ctx->builder, dead_block);
+  return 1;
+}
+
 static int codegen_emit_block(FunctionContext *ctx, const ParserNode *node) {
   const ParserNode *child = NULL;
-  int terminated = 0;
+  const ParserNode *label = NULL;
+  int terminated = ir_block_terminator(ctx->builder.block) != NULL;
+  int resume = 0;
 
   if (node->type != PARSER_NODE_BLOCK) {
     return codegen_set_error(ctx->codegen, "codegen: expected block");
@@ -2863,7 +3893,25 @@ static int codegen_emit_block(FunctionContext *ctx, const ParserNode *node) {
   codegen_push_typedef_scope(ctx);
   for (child = node->first_child; child; child = child->next) {
     if (terminated) {
-      break;
+      for (label = child; label && !codegen_contains_case_label(label);
+           label = label->next) {
+      }
+      if (!label) {
+        break;
+      }
+      /* Its alloca would not dominate the uses after the label. */
+      if (child->type == PARSER_NODE_DECLARATION) {
+        codegen_pop_typedef_scope(ctx);
+        return codegen_set_error(ctx->codegen,
+                                 "codegen: declaration skipped by case label");
+      }
+      if (!codegen_resume_after_terminator(ctx, child, &resume)) {
+        codegen_pop_typedef_scope(ctx);
+        return 0;
+      }
+      if (!resume) {
+        continue;
+      }
     }
 
     terminated = codegen_emit_statement(ctx, child);
@@ -2881,15 +3929,15 @@ static int codegen_emit_if(FunctionContext *ctx, const ParserNode *node) {
   const ParserNode *condition = node->first_child;
   const ParserNode *then_branch = condition ? condition->next : NULL;
   const ParserNode *else_branch = then_branch ? then_branch->next : NULL;
-  char value[32];
-  char temp[32];
+  IrBlock *then_block = NULL;
+  IrBlock *else_block = NULL;
+  IrBlock *end_block = NULL;
   char then_label[32];
   char else_label[32];
   char end_label[32];
   int then_terminated = 0;
   int else_terminated = 0;
   int need_end = 1;
-  TypeDesc condition_type;
 
   if (!condition || !then_branch) {
     return codegen_set_error(ctx->codegen, "codegen: incomplete if statement");
@@ -2900,50 +3948,49 @@ static int codegen_emit_if(FunctionContext *ctx, const ParserNode *node) {
                              "codegen: unexpected else statement");
   }
 
-  if (!codegen_emit_expression(ctx, condition, value, sizeof(value),
-                               &condition_type)) {
-    return 0;
-  }
-
-  if (!codegen_emit_condition_bool(ctx, condition_type, value, temp,
-                                   sizeof(temp))) {
-    return 0;
-  }
   codegen_format_label(then_label, sizeof(then_label), "if.then",
                        ctx->next_label_id++);
+  then_block = ir_block_create(ctx->function, then_label);
 
   if (else_branch) {
     codegen_format_label(else_label, sizeof(else_label), "if.else",
                          ctx->next_label_id++);
     codegen_format_label(end_label, sizeof(end_label), "if.end",
                          ctx->next_label_id++);
+    else_block = ir_block_create(ctx->function, else_label);
+    end_block = ir_block_create(ctx->function, end_label);
   } else {
     codegen_format_label(end_label, sizeof(end_label), "if.end",
                          ctx->next_label_id++);
-    strncpy(else_label, end_label, sizeof(else_label));
-    else_label[sizeof(else_label) - 1] = '\0';
+    end_block = ir_block_create(ctx->function, end_label);
+    else_block = end_block;
+  }
+
+  if (!then_block || !else_block || !end_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
   }
 
-  fprintf(ctx->out, "  br i1 %s, label %%%s, label %%%s\n", temp, then_label,
-          else_label);
+  if (!codegen_emit_cond(ctx, condition, then_block, else_block)) {
+    return 0;
+  }
 
-  fprintf(ctx->out, "%s:\n", then_label);
+  ir_builder_set_block(&ctx->builder, then_block);
   then_terminated = codegen_emit_statement(ctx, then_branch);
   if (ctx->codegen->error_message) {
     return 0;
   }
   if (!then_terminated) {
-    fprintf(ctx->out, "  br label %%%s\n", end_label);
+    ir_build_br(&ctx->builder, end_block);
   }
 
   if (else_branch) {
-    fprintf(ctx->out, "%s:\n", else_label);
+    ir_builder_set_block(&ctx->builder, else_block);
     else_terminated = codegen_emit_statement(ctx, else_branch);
     if (ctx->codegen->error_message) {
       return 0;
     }
     if (!else_terminated) {
-      fprintf(ctx->out, "  br label %%%s\n", end_label);
+      ir_build_br(&ctx->builder, end_block);
     }
 
     if (then_terminated && else_terminated) {
@@ -2952,7 +3999,7 @@ static int codegen_emit_if(FunctionContext *ctx, const ParserNode *node) {
   }
 
   if (need_end) {
-    fprintf(ctx->out, "%s:\n", end_label);
+    ir_builder_set_block(&ctx->builder, end_block);
     return 0;
   }
 
@@ -2962,13 +4009,13 @@ static int codegen_emit_if(FunctionContext *ctx, const ParserNode *node) {
 static int codegen_emit_while(FunctionContext *ctx, const ParserNode *node) {
   const ParserNode *condition = node->first_child;
   const ParserNode *body = condition ? condition->next : NULL;
-  char value[32];
-  char temp[32];
+  IrBlock *cond_block = NULL;
+  IrBlock *body_block = NULL;
+  IrBlock *end_block = NULL;
   char cond_label[32];
   char body_label[32];
   char end_label[32];
   int body_terminated = 0;
-  TypeDesc condition_type;
 
   if (!condition || !body) {
     return codegen_set_error(ctx->codegen,
@@ -2986,24 +4033,22 @@ static int codegen_emit_while(FunctionContext *ctx, const ParserNode *node) {
                        ctx->next_label_id++);
   codegen_format_label(end_label, sizeof(end_label), "while.end",
                        ctx->next_label_id++);
-
-  fprintf(ctx->out, "  br label %%%s\n", cond_label);
-  fprintf(ctx->out, "%s:\n", cond_label);
-
-  if (!codegen_emit_expression(ctx, condition, value, sizeof(value),
-                               &condition_type)) {
-    return 0;
+  cond_block = ir_block_create(ctx->function, cond_label);
+  body_block = ir_block_create(ctx->function, body_label);
+  end_block = ir_block_create(ctx->function, end_label);
+  if (!cond_block || !body_block || !end_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
   }
 
-  if (!codegen_emit_condition_bool(ctx, condition_type, value, temp,
-                                   sizeof(temp))) {
+  ir_build_br(&ctx->builder, cond_block);
+  ir_builder_set_block(&ctx->builder, cond_block);
+
+  if (!codegen_emit_cond(ctx, condition, body_block, end_block)) {
     return 0;
   }
-  fprintf(ctx->out, "  br i1 %s, label %%%s, label %%%s\n", temp, body_label,
-          end_label);
 
-  fprintf(ctx->out, "%s:\n", body_label);
-  if (!codegen_push_loop(ctx, end_label, cond_label)) {
+  ir_builder_set_block(&ctx->builder, body_block);
+  if (!codegen_push_loop(ctx, end_block, cond_block)) {
     return 0;
   }
   body_terminated = codegen_emit_statement(ctx, body);
@@ -3012,10 +4057,10 @@ static int codegen_emit_while(FunctionContext *ctx, const ParserNode *node) {
     return 0;
   }
   if (!body_terminated) {
-    fprintf(ctx->out, "  br label %%%s\n", cond_label);
+    ir_build_br(&ctx->builder, cond_block);
   }
 
-  fprintf(ctx->out, "%s:\n", end_label);
+  ir_builder_set_block(&ctx->builder, end_block);
   return 0;
 }
 
@@ -3024,14 +4069,15 @@ static int codegen_emit_for(FunctionContext *ctx, const ParserNode *node) {
   const ParserNode *condition = init ? init->next : NULL;
   const ParserNode *increment = condition ? condition->next : NULL;
   const ParserNode *body = increment ? increment->next : NULL;
-  char value[32];
-  char temp[32];
+  IrBlock *cond_block = NULL;
+  IrBlock *body_block = NULL;
+  IrBlock *inc_block = NULL;
+  IrBlock *end_block = NULL;
   char cond_label[32];
   char body_label[32];
   char inc_label[32];
   char end_label[32];
   int body_terminated = 0;
-  TypeDesc condition_type;
 
   if (!init || !condition || !increment || !body) {
     return codegen_set_error(ctx->codegen, "codegen: incomplete for statement");
@@ -3057,28 +4103,25 @@ static int codegen_emit_for(FunctionContext *ctx, const ParserNode *node) {
                        ctx->next_label_id++);
   codegen_format_label(end_label, sizeof(end_label), "for.end",
                        ctx->next_label_id++);
+  cond_block = ir_block_create(ctx->function, cond_label);
+  body_block = ir_block_create(ctx->function, body_label);
+  inc_block = ir_block_create(ctx->function, inc_label);
+  end_block = ir_block_create(ctx->function, end_label);
+  if (!cond_block || !body_block || !inc_block || !end_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
 
-  fprintf(ctx->out, "  br label %%%s\n", cond_label);
-  fprintf(ctx->out, "%s:\n", cond_label);
+  ir_build_br(&ctx->builder, cond_block);
+  ir_builder_set_block(&ctx->builder, cond_block);
 
   if (condition->type == PARSER_NODE_EMPTY) {
-    fprintf(ctx->out, "  br label %%%s\n", body_label);
-  } else {
-    if (!codegen_emit_expression(ctx, condition, value, sizeof(value),
-                                 &condition_type)) {
-      return 0;
-    }
-
-    if (!codegen_emit_condition_bool(ctx, condition_type, value, temp,
-                                     sizeof(temp))) {
-      return 0;
-    }
-    fprintf(ctx->out, "  br i1 %s, label %%%s, label %%%s\n", temp, body_label,
-            end_label);
+    ir_build_br(&ctx->builder, body_block);
+  } else if (!codegen_emit_cond(ctx, condition, body_block, end_block)) {
+    return 0;
   }
 
-  fprintf(ctx->out, "%s:\n", body_label);
-  if (!codegen_push_loop(ctx, end_label, inc_label)) {
+  ir_builder_set_block(&ctx->builder, body_block);
+  if (!codegen_push_loop(ctx, end_block, inc_block)) {
     return 0;
   }
   body_terminated = codegen_emit_statement(ctx, body);
@@ -3087,10 +4130,10 @@ static int codegen_emit_for(FunctionContext *ctx, const ParserNode *node) {
     return 0;
   }
   if (!body_terminated) {
-    fprintf(ctx->out, "  br label %%%s\n", inc_label);
+    ir_build_br(&ctx->builder, inc_block);
   }
 
-  fprintf(ctx->out, "%s:\n", inc_label);
+  ir_builder_set_block(&ctx->builder, inc_block);
   if (increment->type != PARSER_NODE_EMPTY) {
     codegen_emit_statement(ctx, increment);
     if (ctx->codegen->error_message) {
@@ -3098,338 +4141,437 @@ static int codegen_emit_for(FunctionContext *ctx, const ParserNode *node) {
     }
   }
 
-  fprintf(ctx->out, "  br label %%%s\n", cond_label);
-  fprintf(ctx->out, "%s:\n", end_label);
+  ir_build_br(&ctx->builder, cond_block);
+  ir_builder_set_block(&ctx->builder, end_block);
   return 0;
 }
 
-static int codegen_emit_statement(FunctionContext *ctx,
-                                  const ParserNode *node) {
-  char value[32];
-  TypeDesc expr_type;
+/*
+ * Folds a case label to its value: numbers and enumerators combined with
+ * unary and binary integer arithmetic, wrapped to int.
+ */
+static int codegen_case_value(FunctionContext *ctx, const ParserNode *node,
+                              long long *value) {
+  const ParserNode *left = node->first_child;
+  const ParserNode *right = left ? left->next : NULL;
+  const EnumSymbol *enum_val = NULL;
+  long long left_value = 0;
+  long long right_value = 0;
 
   switch (node->type) {
-  case PARSER_NODE_BLOCK:
-    return codegen_emit_block(ctx, node);
-  case PARSER_NODE_DECLARATION:
-    if (!codegen_emit_local_declaration(ctx, node)) {
-      return 0;
+  case PARSER_NODE_NUMBER:
+    *value = (int32_t)node->token.value;
+    return 1;
+  case PARSER_NODE_IDENTIFIER:
+    enum_val = codegen_find_enum(ctx, node->token);
+    if (!enum_val) {
+      break;
     }
-    return 0;
-  case PARSER_NODE_TYPEDEF:
-    if (!codegen_add_typedef(ctx, node)) {
-      return 0;
+    *value = enum_val->value;
+    return 1;
+  case PARSER_NODE_UNARY:
+    if (!left || right || !codegen_case_value(ctx, left, &left_value)) {
+      break;
     }
-    return 0;
-  case PARSER_NODE_IF:
-    return codegen_emit_if(ctx, node);
-  case PARSER_NODE_ASSIGN: {
-    const LocalSymbol *local = NULL;
-    const GlobalSymbol *global = NULL;
-    const ParserNode *param = NULL;
-    const ParserNode *left = node->first_child;
-    const ParserNode *right = left ? left->next : NULL;
-    char value[32];
-    char type_name[32];
-    TypeDesc expr_type;
-
-    if (!left || !right || right->next) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: expected assignment expression");
+    if (token_is_punct(node->token, "-")) {
+      *value = (int32_t)(0 - (uint32_t)left_value);
+      return 1;
     }
-
-    if (left->type == PARSER_NODE_UNARY && token_is_punct(left->token, "*")) {
-      const ParserNode *operand = left->first_child;
-      char pointer_value[32];
-      TypeDesc pointer_type;
-      TypeDesc target_type;
-
-      if (!operand || operand->next) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected assignment target");
+    if (token_is_punct(node->token, "+")) {
+      *value = left_value;
+      return 1;
+    }
+    break;
+  case PARSER_NODE_BINARY:
+    if (!left || !right || right->next ||
+        !codegen_case_value(ctx, left, &left_value) ||
+        !codegen_case_value(ctx, right, &right_value)) {
+      break;
+    }
+    if (token_is_punct(node->token, "+")) {
+      *value = (int32_t)((uint32_t)left_value + (uint32_t)right_value);
+      return 1;
+    }
+    if (token_is_punct(node->token, "-")) {
+      *value = (int32_t)((uint32_t)left_value - (uint32_t)right_value);
+      return 1;
+    }
+    if (token_is_punct(node->token, "*")) {
+      *value = (int32_t)((uint32_t)left_value * (uint32_t)right_value);
+      return 1;
+    }
+    if (token_is_punct(node->token, "/") || token_is_punct(node->token, "%")) {
+      if (right_value == 0 || (left_value == INT32_MIN && right_value == -1)) {
+        return codegen_set_error(
+          ctx->codegen, "codegen: case label divides by zero or overflows");
       }
+      *value = token_is_punct(node->token, "/") ? left_value / right_value
+                                                 : left_value % right_value;
+      return 1;
+    }
+    break;
+  default:
+    break;
+  }
 
-      if (!codegen_emit_expression(ctx, operand, pointer_value,
-                                   sizeof(pointer_value), &pointer_type)) {
-        return 0;
-      }
+  return codegen_set_error(ctx->codegen, "codegen: expected constant case");
+}
 
-      if (pointer_type.pointer_depth <= 0) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: expected pointer assignment");
-      }
+static int codegen_add_switch_label(FunctionContext *ctx,
+                                    const ParserNode *node, long long value,
+                                    const char *prefix) {
+  SwitchLabel *label = NULL;
+  size_t next_capacity = 0;
+  char block_label[32];
+
+  if (ctx->switch_label_count == ctx->switch_label_capacity) {
+    next_capacity =
+      ctx->switch_label_capacity ? ctx->switch_label_capacity * 2 : 8;
+    label = realloc(ctx->switch_labels,
+                    next_capacity * sizeof(*ctx->switch_labels));
+    if (!label) {
+      return codegen_set_error(ctx->codegen, "codegen: out of memory");
+    }
 
-      if (!codegen_emit_expression(ctx, right, value, sizeof(value),
-                                   &expr_type)) {
-        return 0;
-      }
+    ctx->switch_labels = label;
+    ctx->switch_label_capacity = next_capacity;
+  }
 
-      target_type = pointer_type;
-      target_type.pointer_depth--;
-      if (!codegen_require_type(ctx->codegen, ctx->structs, ctx->struct_count,
-                                ctx->typedefs, ctx->typedef_count, target_type,
-                                &target_type)) {
-        return 0;
-      }
-      if (target_type.is_const) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to const");
-      }
-      codegen_format_desc_type(target_type, type_name, sizeof(type_name));
+  codegen_format_label(block_label, sizeof(block_label), prefix,
+                       ctx->next_label_id++);
+  label = &ctx->switch_labels[ctx->switch_label_count];
+  label->node = node;
+  label->block = ir_block_create(ctx->function, block_label);
+  label->value = value;
+  if (!label->block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
+  ctx->switch_label_count += 1;
+  return 1;
+}
 
-      if (target_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(right)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(target_type, expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: assignment type mismatch");
-        }
-      } else {
-        if (!codegen_type_is_integer(expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected integer assignment");
-        }
+/*
+ * Gives each case and default label of one switch body, from first_label
+ * on in ctx->switch_labels, a block of its own.
+ */
+static int codegen_collect_switch_labels(FunctionContext *ctx,
+                                         const ParserNode *node,
+                                         size_t first_label,
+                                         const ParserNode **default_node) {
+  const ParserNode *child = NULL;
+  long long value = 0;
+  size_t index = 0;
 
-        if (!codegen_emit_integer_cast(ctx, expr_type, target_type, value,
-                                       sizeof(value))) {
-          return 0;
-        }
-      }
+  if (node->type == PARSER_NODE_SWITCH) {
+    return 1;
+  }
 
-      fprintf(ctx->out, "  store %s %s, %s* %s\n", type_name, value, type_name,
-              pointer_value);
+  if (node->type == PARSER_NODE_CASE) {
+    if (!node->first_child) {
+      return codegen_set_error(ctx->codegen, "codegen: incomplete case label");
+    }
+    if (!codegen_case_value(ctx, node->first_child, &value)) {
       return 0;
     }
-
-    if (left->type == PARSER_NODE_MEMBER) {
-      char member_pointer[32];
-      TypeDesc target_type;
-
-      if (!codegen_emit_member_pointer(ctx, left, member_pointer,
-                                       sizeof(member_pointer), &target_type)) {
-        return 0;
-      }
-
-      if (target_type.pointer_depth == 0 &&
-          target_type.type_token.type == TOKEN_STRUCT) {
+    for (index = first_label; index < ctx->switch_label_count; index++) {
+      if (ctx->switch_labels[index].node != *default_node &&
+          ctx->switch_labels[index].value == value) {
         return codegen_set_error(ctx->codegen,
-                                 "codegen: struct value not supported");
+                                 "codegen: duplicate case value");
       }
+    }
+    if (!codegen_add_switch_label(ctx, node, value, "sw.case")) {
+      return 0;
+    }
+  } else if (node->type == PARSER_NODE_DEFAULT) {
+    if (*default_node) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: duplicate default label");
+    }
+    *default_node = node;
+    if (!codegen_add_switch_label(ctx, node, 0, "sw.default")) {
+      return 0;
+    }
+  }
 
-      if (target_type.is_const) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to const");
-      }
+  for (child = node->first_child; child; child = child->next) {
+    if (!codegen_collect_switch_labels(ctx, child, first_label,
+                                       default_node)) {
+      return 0;
+    }
+  }
+  return 1;
+}
 
-      if (!codegen_emit_expression(ctx, right, value, sizeof(value),
-                                   &expr_type)) {
-        return 0;
-      }
+static IrBlock *codegen_find_switch_label(const FunctionContext *ctx,
+                                          const ParserNode *node) {
+  size_t index = ctx->switch_label_count;
 
-      codegen_format_desc_type(target_type, type_name, sizeof(type_name));
+  while (index > 0) {
+    index--;
+    if (ctx->switch_labels[index].node == node) {
+      return ctx->switch_labels[index].block;
+    }
+  }
+  return NULL;
+}
 
-      if (target_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(right)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(target_type, expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: assignment type mismatch");
-        }
-      } else {
-        if (!codegen_type_is_integer(expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected integer assignment");
-        }
+/*
+ * Emits a switch as an IR switch over the case labels of its body; the
+ * passes and backends decide between jump tables and compare trees. A
+ * break leaves for sw.end and a continue still reaches the enclosing loop.
+ */
+static int codegen_emit_switch(FunctionContext *ctx, const ParserNode *node) {
+  const ParserNode *condition = node->first_child;
+  const ParserNode *body = condition ? condition->next : NULL;
+  const ParserNode *default_node = NULL;
+  const LoopContext *loop = codegen_current_loop(ctx);
+  size_t first_label = ctx->switch_label_count;
+  IrValue *condition_value = NULL;
+  IrValue *switch_value = NULL;
+  IrBlock *default_block = NULL;
+  IrBlock *end_block = NULL;
+  TypeDesc condition_type;
+  char end_label[32];
+  size_t index = 0;
+  int resume = 0;
 
-        if (!codegen_emit_integer_cast(ctx, expr_type, target_type, value,
-                                       sizeof(value))) {
-          return 0;
-        }
-      }
+  if (!condition || !body) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: incomplete switch statement");
+  }
 
-      fprintf(ctx->out, "  store %s %s, %s* %s\n", type_name, value, type_name,
-              member_pointer);
-      return 0;
-    }
+  if (body->next) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: unexpected switch statement");
+  }
 
-    if (left->type == PARSER_NODE_INDEX) {
-      char element_pointer[32];
-      TypeDesc target_type;
+  if (!codegen_emit_expression(ctx, condition, &condition_value,
+                               &condition_type)) {
+    return 0;
+  }
+  if (!codegen_type_is_integer(condition_type)) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected integer switch condition");
+  }
+  if (!codegen_emit_integer_cast(ctx, condition_type, codegen_int_type_desc(),
+                                 &condition_value)) {
+    return 0;
+  }
 
-      if (!codegen_emit_index_pointer(ctx, left, element_pointer,
-                                      sizeof(element_pointer), &target_type)) {
-        return 0;
-      }
+  if (!codegen_collect_switch_labels(ctx, body, first_label, &default_node)) {
+    return 0;
+  }
+  codegen_format_label(end_label, sizeof(end_label), "sw.end",
+                       ctx->next_label_id++);
+  end_block = ir_block_create(ctx->function, end_label);
+  if (!end_block) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
 
-      if (target_type.pointer_depth == 0 &&
-          target_type.type_token.type == TOKEN_STRUCT) {
-        return codegen_set_error(ctx->codegen,
-                                 "codegen: struct value not supported");
-      }
+  default_block =
+    default_node ? codegen_find_switch_label(ctx, default_node) : end_block;
+  switch_value =
+    ir_build_switch(&ctx->builder, condition_value, default_block);
+  for (index = first_label; switch_value && index < ctx->switch_label_count;
+       index++) {
+    const SwitchLabel *label = &ctx->switch_labels[index];
 
-      if (target_type.is_const) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to const");
-      }
+    if (label->node != default_node &&
+        !ir_switch_add_case(switch_value->instr,
+                            codegen_i32(ctx, label->value), label->block)) {
+      switch_value = NULL;
+    }
+  }
+  if (!switch_value) {
+    return codegen_set_error(ctx->codegen, "codegen: out of memory");
+  }
 
-      if (!codegen_emit_expression(ctx, right, value, sizeof(value),
-                                   &expr_type)) {
-        return 0;
-      }
+  if (!codegen_push_loop(ctx, end_block,
+                         loop ? loop->continue_block : NULL)) {
+    return 0;
+  }
+  if (codegen_resume_after_terminator(ctx, body, &resume) && resume) {
+    codegen_emit_statement(ctx, body);
+  }
+  codegen_pop_loop(ctx);
+  ctx->switch_label_count = first_label;
+  if (ctx->codegen->error_message) {
+    return 0;
+  }
 
-      codegen_format_desc_type(target_type, type_name, sizeof(type_name));
+  if (!ir_block_terminator(ctx->builder.block)) {
+    ir_build_br(&ctx->builder, end_block);
+  }
+  ir_builder_set_block(&ctx->builder, end_block);
+  return 0;
+}
 
-      if (target_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(right)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(target_type, expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: assignment type mismatch");
-        }
-      } else {
-        if (!codegen_type_is_integer(expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected integer assignment");
-        }
+/* Falls through into the label's block unless the code before it left. */
+static int codegen_emit_switch_label(FunctionContext *ctx,
+                                     const ParserNode *node) {
+  const ParserNode *statement =
+    node->type == PARSER_NODE_CASE && node->first_child
+      ? node->first_child->next
+      : node->first_child;
+  IrBlock *block = codegen_find_switch_label(ctx, node);
 
-        if (!codegen_emit_integer_cast(ctx, expr_type, target_type, value,
-                                       sizeof(value))) {
-          return 0;
-        }
-      }
+  if (!block || !statement || statement->next) {
+    return codegen_set_error(ctx->codegen, "codegen: unexpected case label");
+  }
 
-      fprintf(ctx->out, "  store %s %s, %s* %s\n", type_name, value, type_name,
-              element_pointer);
-      return 0;
-    }
+  if (!ir_block_terminator(ctx->builder.block)) {
+    ir_build_br(&ctx->builder, block);
+  }
+  ir_builder_set_block(&ctx->builder, block);
+  return codegen_emit_statement(ctx, statement);
+}
 
-    if (left->type != PARSER_NODE_IDENTIFIER) {
+/*
+ * Converts an assigned value to the target's type and stores it. Pointer
+ * targets accept compatible pointers or a null literal.
+ */
+static int codegen_emit_assign_store(FunctionContext *ctx,
+                                     TypeDesc target_type, IrValue *address,
+                                     const ParserNode *right, IrValue *value,
+                                     TypeDesc expr_type) {
+  if (target_type.pointer_depth > 0) {
+    if (!(expr_type.pointer_depth == 0 &&
+          codegen_is_null_pointer_literal(right)) &&
+        !codegen_pointer_compatible(target_type, expr_type)) {
       return codegen_set_error(ctx->codegen,
-                               "codegen: expected assignment target");
+                               "codegen: assignment type mismatch");
+    }
+    value = codegen_coerce_pointer(
+      ctx, value, codegen_lower_type(ctx->module, target_type));
+  } else {
+    if (!codegen_type_is_integer(expr_type)) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected integer assignment");
     }
 
-    if (!codegen_emit_expression(ctx, right, value, sizeof(value),
-                                 &expr_type)) {
+    if (!codegen_emit_integer_cast(
+          ctx, expr_type, codegen_make_type_desc(target_type.type_token, 0, 0),
+          &value)) {
       return 0;
     }
+  }
 
-    local = codegen_find_local(ctx, left->token);
-    if (local) {
-      TypeDesc target_type;
+  ir_build_store(&ctx->builder, value, address);
+  return 1;
+}
 
-      if (local->is_const) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to const");
-      }
+/*
+ * target op= value: the target's address is computed once, so the load
+ * and the store share it rather than repeating the GEP chain.
+ */
+static int codegen_emit_compound_assign(FunctionContext *ctx,
+                                        const ParserNode *node) {
+  const ParserNode *left = node->first_child;
+  const ParserNode *right = left ? left->next : NULL;
+  IrValue *address = NULL;
+  IrValue *current = NULL;
+  IrValue *right_value = NULL;
+  IrValue *value = NULL;
+  TypeDesc target_type;
+  TypeDesc right_type;
+  TypeDesc expr_type;
+  Token op = node->token;
 
-      if (local->array_length > 0) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to array");
-      }
+  if (!left || !right || right->next) {
+    return codegen_set_error(ctx->codegen,
+                             "codegen: expected assignment expression");
+  }
 
-      target_type = codegen_make_type_desc(
-        local->type_token, local->pointer_depth, local->is_const);
-      if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
-                                target_type, &target_type)) {
-        return 0;
-      }
+  if (!codegen_emit_lvalue(ctx, left, &address, &target_type)) {
+    return 0;
+  }
+
+  if (!codegen_emit_expression(ctx, right, &right_value, &right_type)) {
+    return 0;
+  }
 
-      codegen_format_desc_type(target_type, type_name, sizeof(type_name));
+  current = ir_build_load(&ctx->builder, address);
 
-      if (target_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(right)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(target_type, expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: assignment type mismatch");
-        }
-      } else {
-        if (!codegen_type_is_integer(expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected integer assignment");
-        }
+  /* "+=" applies "+", and so on. */
+  op.length = 1;
+  if (!codegen_emit_arithmetic(ctx, op, current, target_type, right_value,
+                               right_type, &value, &expr_type)) {
+    return 0;
+  }
 
-        {
-          TypeDesc cast_type;
+  return codegen_emit_assign_store(ctx, target_type, address, right, value,
+                                   expr_type);
+}
 
-          cast_type = codegen_make_type_desc(target_type.type_token, 0, 0);
-          if (!codegen_emit_integer_cast(ctx, expr_type, cast_type, value,
-                                         sizeof(value))) {
-            return 0;
-          }
-        }
-      }
+static int codegen_emit_statement(FunctionContext *ctx,
+                                  const ParserNode *node) {
+  IrValue *value = NULL;
+  TypeDesc expr_type;
 
-      fprintf(ctx->out, "  store %s %s, %s* %s\n", type_name, value, type_name,
-              local->ir_name);
-      return 0;
-    }
+  if (!codegen_set_location(ctx, node->token)) {
+    return 0;
+  }
 
-    param = codegen_find_param(ctx, left->token);
-    if (param) {
-      return codegen_set_error(
-        ctx->codegen, "codegen: assignment to parameter not supported");
+  switch (node->type) {
+  case PARSER_NODE_BLOCK:
+    return codegen_emit_block(ctx, node);
+  case PARSER_NODE_DECLARATION:
+    if (!codegen_emit_local_declaration(ctx, node)) {
+      return 0;
     }
-
-    global = codegen_find_global(ctx, left->token);
-    if (!global) {
-      return codegen_set_error(ctx->codegen,
-                               "codegen: unknown assignment target");
+    return 0;
+  case PARSER_NODE_TYPEDEF:
+    if (!codegen_add_typedef(ctx, node)) {
+      return 0;
     }
+    return 0;
+  case PARSER_NODE_IF:
+    return codegen_emit_if(ctx, node);
+  case PARSER_NODE_ASSIGN: {
+    const ParserNode *left = node->first_child;
+    const ParserNode *right = left ? left->next : NULL;
+    IrValue *address = NULL;
+    TypeDesc target_type;
 
-    {
-      TypeDesc target_type;
-
-      if (global->is_const) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to const");
-      }
-
-      if (global->array_length > 0) {
-        return codegen_set_error(ctx->codegen, "codegen: assignment to array");
-      }
-
-      target_type = codegen_make_type_desc(
-        global->type_token, global->pointer_depth, global->is_const);
-      if (!codegen_resolve_desc(ctx->codegen, ctx->typedefs, ctx->typedef_count,
-                                target_type, &target_type)) {
-        return 0;
-      }
-
-      codegen_format_desc_type(target_type, type_name, sizeof(type_name));
-
-      if (target_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(right)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(target_type, expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: assignment type mismatch");
-        }
-      } else {
-        if (!codegen_type_is_integer(expr_type)) {
-          return codegen_set_error(ctx->codegen,
-                                   "codegen: expected integer assignment");
-        }
-
-        {
-          TypeDesc cast_type;
+    if (!left || !right || right->next) {
+      return codegen_set_error(ctx->codegen,
+                               "codegen: expected assignment expression");
+    }
 
-          cast_type = codegen_make_type_desc(target_type.type_token, 0, 0);
-          if (!codegen_emit_integer_cast(ctx, expr_type, cast_type, value,
-                                         sizeof(value))) {
-            return 0;
-          }
-        }
-      }
+    if (!codegen_emit_lvalue(ctx, left, &address, &target_type)) {
+      return 0;
+    }
+
+    if (!codegen_emit_expression(ctx, right, &value, &expr_type)) {
+      return 0;
     }
 
-    fprintf(ctx->out, "  store %s %s, %s* @%.*s\n", type_name, value, type_name,
-            (int)left->token.length, left->token.start);
+    codegen_emit_assign_store(ctx, target_type, address, right, value,
+                              expr_type);
     return 0;
   }
+  case PARSER_NODE_COMPOUND_ASSIGN:
+    codegen_emit_compound_assign(ctx, node);
+    return 0;
+  case PARSER_NODE_POSTFIX:
+    codegen_emit_increment(ctx, node, &value, &expr_type);
+    return 0;
+  case PARSER_NODE_UNARY:
+    if (!codegen_is_increment(node)) {
+      return codegen_set_error(ctx->codegen, "codegen: expected statement");
+    }
+    codegen_emit_increment(ctx, node, &value, &expr_type);
+    return 0;
   case PARSER_NODE_WHILE:
     return codegen_emit_while(ctx, node);
   case PARSER_NODE_FOR:
     return codegen_emit_for(ctx, node);
+  case PARSER_NODE_SWITCH:
+    return codegen_emit_switch(ctx, node);
+  case PARSER_NODE_CASE:
+  case PARSER_NODE_DEFAULT:
+    return codegen_emit_switch_label(ctx, node);
   case PARSER_NODE_BREAK: {
     const LoopContext *loop = codegen_current_loop(ctx);
 
@@ -3438,18 +4580,18 @@ static int codegen_emit_statement(FunctionContext *ctx,
                                "codegen: unexpected break statement");
     }
 
-    fprintf(ctx->out, "  br label %%%s\n", loop->break_label);
+    ir_build_br(&ctx->builder, loop->break_block);
     return 1;
   }
   case PARSER_NODE_CONTINUE: {
     const LoopContext *loop = codegen_current_loop(ctx);
 
-    if (!loop || node->first_child) {
+    if (!loop || !loop->continue_block || node->first_child) {
       return codegen_set_error(ctx->codegen,
                                "codegen: unexpected continue statement");
     }
 
-    fprintf(ctx->out, "  br label %%%s\n", loop->continue_label);
+    ir_build_br(&ctx->builder, loop->continue_block);
     return 1;
   }
   case PARSER_NODE_RETURN:
@@ -3458,8 +4600,7 @@ static int codegen_emit_statement(FunctionContext *ctx,
                                "codegen: unexpected return statement");
     }
 
-    if (!codegen_emit_expression(ctx, node->first_child, value, sizeof(value),
-                                 &expr_type)) {
+    if (!codegen_emit_expression(ctx, node->first_child, &value, &expr_type)) {
       return 0;
     }
 
@@ -3470,15 +4611,16 @@ static int codegen_emit_statement(FunctionContext *ctx,
         codegen_make_type_desc(ctx->return_type_token,
                                ctx->return_pointer_depth, ctx->return_is_const);
       if (return_type.pointer_depth > 0) {
-        if (expr_type.pointer_depth == 0 &&
-            codegen_is_null_pointer_literal(node->first_child)) {
-          snprintf(value, sizeof(value), "null");
-        } else if (!codegen_pointer_compatible(return_type, expr_type)) {
+        if (!(expr_type.pointer_depth == 0 &&
+              codegen_is_null_pointer_literal(node->first_child)) &&
+            !codegen_pointer_compatible(return_type, expr_type)) {
           return codegen_set_error(ctx->codegen,
                                    "codegen: return type mismatch");
         }
 
-        fprintf(ctx->out, "  ret %s %s\n", ctx->return_type, value);
+        ir_build_ret(&ctx->builder,
+                     codegen_coerce_pointer(ctx, value,
+                                            ctx->function->return_type));
         return 1;
       }
 
@@ -3491,13 +4633,12 @@ static int codegen_emit_statement(FunctionContext *ctx,
         TypeDesc cast_type;
 
         cast_type = codegen_make_type_desc(ctx->return_type_token, 0, 0);
-        if (!codegen_emit_integer_cast(ctx, expr_type, cast_type, value,
-                                       sizeof(value))) {
+        if (!codegen_emit_integer_cast(ctx, expr_type, cast_type, &value)) {
           return 0;
         }
       }
 
-      fprintf(ctx->out, "  ret %s %s\n", ctx->return_type, value);
+      ir_build_ret(&ctx->builder, value);
       return 1;
     }
   case PARSER_NODE_EMPTY:
@@ -3512,20 +4653,17 @@ static int codegen_emit_statement(FunctionContext *ctx,
 }
 
 static int codegen_emit_function(
-  Codegen *codegen, const ParserNode *node, const GlobalSymbol *globals,
-  size_t global_count, const StructSymbol *structs, size_t struct_count,
+  Codegen *codegen, const ParserNode *node, IrFunction *function,
+  const GlobalSymbol *globals, size_t global_count,
+  const StructSymbol *structs, size_t struct_count,
   const TypedefSymbol *typedefs, size_t typedef_count, const EnumSymbol *enums,
-  size_t enum_count, const FunctionSymbol *functions, size_t function_count,
-  FILE *out) {
+  size_t enum_count, const FunctionSymbol *functions, size_t function_count) {
   FunctionContext ctx;
   int terminated = 0;
-  TypeInfo type_info;
   const ParserNode *param_list = NULL;
   const ParserNode *body = NULL;
-  const ParserNode *param = NULL;
   size_t param_count = 0;
-  size_t index = 0;
-  char param_type[32];
+  IrBlock *entry = NULL;
 
   if (node->type != PARSER_NODE_FUNCTION) {
     return codegen_set_error(codegen, "codegen: expected function");
@@ -3540,6 +4678,10 @@ static int codegen_emit_function(
     return 0;
   }
 
+  if (!body) {
+    return codegen_set_error(codegen, "codegen: expected function body");
+  }
+
   {
     TypeDesc return_desc;
     TypeDesc resolved_return;
@@ -3551,24 +4693,15 @@ static int codegen_emit_function(
       return 0;
     }
 
-    if (resolved_return.pointer_depth == 0 &&
-        resolved_return.type_token.type == TOKEN_STRUCT) {
-      return codegen_set_error(codegen, "codegen: struct return not supported");
-    }
-
     ctx.return_pointer_depth = resolved_return.pointer_depth;
     ctx.return_type_token = resolved_return.type_token;
     ctx.return_is_const = resolved_return.is_const;
-    type_info = codegen_type_info(resolved_return.type_token);
-    codegen_format_desc_type(resolved_return, ctx.return_type,
-                             sizeof(ctx.return_type));
   }
 
   ctx.codegen = codegen;
-  ctx.out = out;
+  ctx.module = function->module;
+  ctx.function = function;
   ctx.next_label_id = 0;
-  ctx.next_temp_id = 0;
-  ctx.return_width = type_info.width;
   ctx.function_name = node->token;
   ctx.globals = globals;
   ctx.global_count = global_count;
@@ -3590,6 +4723,9 @@ static int codegen_emit_function(
   ctx.loop_stack = NULL;
   ctx.loop_depth = 0;
   ctx.loop_capacity = 0;
+  ctx.switch_labels = NULL;
+  ctx.switch_label_count = 0;
+  ctx.switch_label_capacity = 0;
   ctx.static_local_index = 0;
 
   if (typedef_count > 0) {
@@ -3602,173 +4738,210 @@ static int codegen_emit_function(
     ctx.typedef_capacity = typedef_count;
   }
 
-  if (body) {
-    StaticLocalContext static_ctx = {.codegen = codegen,
-                                     .out = out,
-                                     .function_name = node->token,
-                                     .globals = globals,
-                                     .global_count = global_count,
-                                     .structs = structs,
-                                     .struct_count = struct_count,
-                                     .typedefs = typedefs,
-                                     .typedef_count = typedef_count,
-                                     .enums = enums,
-                                     .enum_count = enum_count,
-                                     .index = 0};
-
-    if (!codegen_emit_static_locals_in_statement(&static_ctx, body)) {
-      free(ctx.typedefs);
-      return 0;
-    }
-
-    if (static_ctx.index > 0) {
-      fprintf(out, "\n");
-    }
-  }
-
-  fprintf(out, "define%s %s @%.*s(", node->is_static ? " internal" : "",
-          ctx.return_type, (int)node->token.length, node->token.start);
-  param = param_list;
-  for (index = 0; index < param_count; index++) {
-    if (index > 0) {
-      fprintf(out, ", ");
-    }
-
-    if (!param) {
-      free(ctx.typedefs);
-      return codegen_set_error(codegen, "codegen: expected parameter");
-    }
-
-    {
-      TypeDesc param_desc;
-
-      param_desc = codegen_make_type_desc(
-        param->type_token, param->pointer_depth, param->is_const);
-      if (!codegen_require_type(codegen, structs, struct_count, ctx.typedefs,
-                                ctx.typedef_count, param_desc, &param_desc)) {
-        free(ctx.typedefs);
-        return 0;
-      }
-
-      if (param_desc.pointer_depth == 0 &&
-          param_desc.type_token.type == TOKEN_STRUCT) {
-        free(ctx.typedefs);
-        return codegen_set_error(codegen,
-                                 "codegen: struct parameter not supported");
-      }
-
-      codegen_format_desc_type(param_desc, param_type, sizeof(param_type));
-    }
-    fprintf(out, "%s %%%.*s", param_type, (int)param->token.length,
-            param->token.start);
-    param = param->next;
+  ir_builder_init(&ctx.builder, function);
+  entry = ir_block_create(function, "entry");
+  if (!entry) {
+    free(ctx.typedefs);
+    return codegen_set_error(codegen, "codegen: out of memory");
   }
-  fprintf(out, ") {\n");
-  fprintf(out, "entry:\n");
+  ir_builder_set_block(&ctx.builder, entry);
+  codegen_set_location(&ctx, node->token);
+  function->line = ctx.builder.loc.line;
 
   terminated = codegen_emit_block(&ctx, body);
   if (codegen->error_message) {
+    free(ctx.locals);
+    free(ctx.loop_stack);
+    free(ctx.switch_labels);
     free(ctx.typedefs);
     return 0;
   }
 
+  /* Falling off the end returns zero, as main does in C99. */
   if (!terminated) {
-    fprintf(out, "  ret %s 0\n", ctx.return_type);
+    IrValue *zero = function->return_type->kind == IR_TYPE_POINTER
+                      ? ir_const_null(ctx.module, function->return_type)
+                      : ir_const_int(ctx.module, function->return_type, 0);
+
+    ir_build_ret(&ctx.builder, zero);
   }
 
-  fprintf(out, "}\n");
   free(ctx.locals);
   free(ctx.loop_stack);
+  free(ctx.switch_labels);
   free(ctx.typedefs);
   return 1;
 }
 
-static int codegen_emit_function_declaration(Codegen *codegen,
-                                             const ParserNode *node,
-                                             const StructSymbol *structs,
-                                             size_t struct_count,
-                                             const TypedefSymbol *typedefs,
-                                             size_t typedef_count, FILE *out) {
+/*
+ * Creates the IR function for a definition or an extern declaration,
+ * including parameters and the linkage attributes selected by the options.
+ */
+static IrFunction *codegen_declare_function(Codegen *codegen,
+                                            const ParserNode *node,
+                                            const StructSymbol *structs,
+                                            size_t struct_count,
+                                            const TypedefSymbol *typedefs,
+                                            size_t typedef_count,
+                                            IrModule *module) {
   const ParserNode *param_list = NULL;
   const ParserNode *body = NULL;
   const ParserNode *param = NULL;
+  IrFunction *function = NULL;
   size_t param_count = 0;
   size_t index = 0;
-  char return_type[32];
-  char param_type[32];
   TypeDesc return_desc;
   TypeDesc resolved_return;
 
   if (node->type != PARSER_NODE_FUNCTION) {
-    return codegen_set_error(codegen, "codegen: expected function");
+    codegen_set_error(codegen, "codegen: expected function");
+    return NULL;
   }
 
   if (node->token.type != TOKEN_IDENT) {
-    return codegen_set_error(codegen, "codegen: expected identifier token");
+    codegen_set_error(codegen, "codegen: expected identifier token");
+    return NULL;
   }
 
   if (!codegen_function_parts(codegen, node, &param_list, &param_count,
                               &body)) {
-    return 0;
-  }
-
-  if (body) {
-    return codegen_set_error(codegen, "codegen: unexpected function body");
+    return NULL;
   }
 
   return_desc = codegen_make_type_desc(node->type_token, node->pointer_depth,
                                        node->is_const);
   if (!codegen_require_type(codegen, structs, struct_count, typedefs,
                             typedef_count, return_desc, &resolved_return)) {
-    return 0;
+    return NULL;
   }
 
   if (resolved_return.pointer_depth == 0 &&
       resolved_return.type_token.type == TOKEN_STRUCT) {
-    return codegen_set_error(codegen, "codegen: struct return not supported");
+    codegen_set_error(codegen, "codegen: struct return not supported");
+    return NULL;
   }
 
-  codegen_format_desc_type(resolved_return, return_type, sizeof(return_type));
+  function =
+    ir_module_add_function(module, node->token.start, node->token.length,
+                           codegen_lower_type(module, resolved_return));
+  if (!function) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    return NULL;
+  }
+  function->return_noundef = codegen->options.poison_flags;
 
-  fprintf(out, "declare %s @%.*s(", return_type, (int)node->token.length,
-          node->token.start);
+  if (body && node->is_static) {
+    function->linkage = IR_LINKAGE_INTERNAL;
+    if (codegen->options.optimize_linkage) {
+      function->calling_conv = IR_CC_FAST;
+      function->unnamed_addr = IR_UNNAMED_ADDR_GLOBAL;
+    }
+  } else if (body && codegen->options.optimize_linkage) {
+    function->dso_local = !codegen->options.pic;
+    function->unnamed_addr = IR_UNNAMED_ADDR_LOCAL;
+  }
 
   param = param_list;
   for (index = 0; index < param_count; index++) {
+    IrParam *ir_param = NULL;
     TypeDesc param_desc;
 
-    if (index > 0) {
-      fprintf(out, ", ");
-    }
-
     if (!param) {
-      return codegen_set_error(codegen, "codegen: expected parameter");
+      codegen_set_error(codegen, "codegen: expected parameter");
+      return NULL;
     }
 
     param_desc = codegen_make_type_desc(param->type_token, param->pointer_depth,
                                         param->is_const);
     if (!codegen_require_type(codegen, structs, struct_count, typedefs,
                               typedef_count, param_desc, &param_desc)) {
-      return 0;
+      return NULL;
     }
 
     if (param_desc.pointer_depth == 0 &&
         param_desc.type_token.type == TOKEN_STRUCT) {
-      return codegen_set_error(codegen,
-                               "codegen: struct parameter not supported");
+      codegen_set_error(codegen, "codegen: struct parameter not supported");
+      return NULL;
     }
 
-    codegen_format_desc_type(param_desc, param_type, sizeof(param_type));
-    fprintf(out, "%s", param_type);
+    ir_param = ir_function_add_param(
+      function, codegen_lower_type(module, param_desc), param->token.start,
+      param->token.length);
+    if (!ir_param) {
+      codegen_set_error(codegen, "codegen: out of memory");
+      return NULL;
+    }
+    ir_param->noundef = codegen->options.poison_flags;
     param = param->next;
   }
 
-  fprintf(out, ")\n");
-  return 1;
+  return function;
+}
+
+static FunctionSymbol *codegen_lookup_function(FunctionSymbol *functions,
+                                               size_t function_count,
+                                               Token name) {
+  for (size_t i = 0; i < function_count; i++) {
+    if (codegen_name_matches(name, functions[i].name, functions[i].length)) {
+      return &functions[i];
+    }
+  }
+
+  return NULL;
+}
+
+/* Marks every function reachable through calls in the given statements. */
+static void codegen_mark_referenced(FunctionSymbol *functions,
+                                    size_t function_count,
+                                    const ParserNode *node) {
+  for (; node; node = node->next) {
+    if (node->type == PARSER_NODE_CALL) {
+      FunctionSymbol *callee =
+        codegen_lookup_function(functions, function_count, node->token);
+
+      if (callee && !callee->referenced) {
+        callee->referenced = 1;
+        codegen_mark_referenced(functions, function_count, callee->body);
+      }
+    }
+
+    codegen_mark_referenced(functions, function_count, node->first_child);
+  }
+}
+
+static int codegen_function_referenced(FunctionSymbol *functions,
+                                       size_t function_count, Token name) {
+  const FunctionSymbol *symbol =
+    codegen_lookup_function(functions, function_count, name);
+
+  return !symbol || symbol->referenced;
+}
+
+/* Whether the translation unit has a body for the named function. */
+static int codegen_function_defined(const ParserNode *unit, Token name) {
+  const ParserNode *child = NULL;
+
+  for (child = unit->first_child; child; child = child->next) {
+    const ParserNode *last = child->first_child;
+
+    if (child->type != PARSER_NODE_FUNCTION ||
+        !codegen_name_matches(name, child->token.start, child->token.length)) {
+      continue;
+    }
+    while (last && last->next) {
+      last = last->next;
+    }
+    if (last && last->type == PARSER_NODE_BLOCK) {
+      return 1;
+    }
+  }
+
+  return 0;
 }
 
 static int codegen_emit_translation_unit(Codegen *codegen,
-                                         const ParserNode *node, FILE *out) {
+                                         const ParserNode *node,
+                                         IrModule *module) {
   const ParserNode *child = NULL;
   GlobalSymbol *globals = NULL;
   StructSymbol *structs = NULL;
@@ -3795,9 +4968,6 @@ static int codegen_emit_translation_unit(Codegen *codegen,
     return codegen_set_error(codegen, "codegen: expected EOF token");
   }
 
-  fprintf(out, "; ModuleID = 'basecc'\n");
-  fprintf(out, "source_filename = \"basecc\"\n\n");
-
   for (child = node->first_child; child; child = child->next) {
     if (child->type == PARSER_NODE_DECLARATION) {
       global_count++;
@@ -3882,6 +5052,8 @@ static int codegen_emit_translation_unit(Codegen *codegen,
       globals[global_index].pointer_depth = child->pointer_depth;
       globals[global_index].is_const = child->is_const;
       globals[global_index].array_length = child->array_length;
+      globals[global_index].address_taken =
+        codegen_address_taken(node->first_child, child->token);
       global_index++;
       continue;
     }
@@ -3942,6 +5114,9 @@ static int codegen_emit_translation_unit(Codegen *codegen,
       functions[function_index].is_const = child->is_const;
       functions[function_index].param_list = param_list;
       functions[function_index].param_count = param_count;
+      functions[function_index].body = body;
+      functions[function_index].is_internal = child->is_static && body;
+      functions[function_index].referenced = !child->is_static;
       function_index++;
       continue;
     }
@@ -3986,44 +5161,39 @@ static int codegen_emit_translation_unit(Codegen *codegen,
     }
   }
 
-  for (struct_index = 0; struct_index < struct_count; struct_index++) {
-    if (!codegen_emit_struct_definition(codegen, &structs[struct_index],
-                                        structs, struct_count, typedefs,
-                                        typedef_count, out)) {
-      goto cleanup;
+  for (function_index = 0; function_index < function_count; function_index++) {
+    if (functions[function_index].referenced) {
+      codegen_mark_referenced(functions, function_count,
+                              functions[function_index].body);
     }
   }
 
-  if (struct_count > 0) {
-    fprintf(out, "\n");
+  /* Struct types are created in source order before any body refers to one. */
+  for (struct_index = 0; struct_index < struct_count; struct_index++) {
+    if (!ir_type_struct(module, structs[struct_index].name,
+                        structs[struct_index].length)) {
+      codegen_set_error(codegen, "codegen: out of memory");
+      goto cleanup;
+    }
   }
 
-  for (child = node->first_child; child; child = child->next) {
-    if (child->type == PARSER_NODE_FUNCTION) {
-      const ParserNode *param_list = NULL;
-      const ParserNode *body = NULL;
-      size_t param_count = 0;
-
-      if (!codegen_function_parts(codegen, child, &param_list, &param_count,
-                                  &body)) {
-        goto cleanup;
-      }
-
-      if (child->is_extern && !body) {
-        if (!codegen_emit_function_declaration(codegen, child, structs,
-                                               struct_count, typedefs,
-                                               typedef_count, out)) {
-          goto cleanup;
-        }
-      }
+  for (struct_index = 0; struct_index < struct_count; struct_index++) {
+    if (!codegen_emit_struct_definition(codegen, &structs[struct_index],
+                                        structs, struct_count, typedefs,
+                                        typedef_count, module)) {
+      goto cleanup;
     }
   }
 
+  /*
+   * First pass: every global, static local, and function signature, so
+   * bodies can refer to symbols defined later in the file.
+   */
   for (child = node->first_child; child; child = child->next) {
     if (child->type == PARSER_NODE_DECLARATION) {
       if (!codegen_emit_declaration(codegen, child, globals, global_count,
                                     structs, struct_count, typedefs,
-                                    typedef_count, enums, enum_count, out)) {
+                                    typedef_count, enums, enum_count, module)) {
         goto cleanup;
       }
       continue;
@@ -4033,21 +5203,59 @@ static int codegen_emit_translation_unit(Codegen *codegen,
       const ParserNode *param_list = NULL;
       const ParserNode *body = NULL;
       size_t param_count = 0;
+      size_t first_static = module->symbol_count;
+      IrFunction *function = NULL;
 
       if (!codegen_function_parts(codegen, child, &param_list, &param_count,
                                   &body)) {
         goto cleanup;
       }
 
-      if (child->is_extern && !body) {
+      if (codegen->options.optimize_linkage && child->is_static && body &&
+          !codegen_function_referenced(functions, function_count,
+                                       child->token)) {
+        continue;
+      }
+
+      /* A prototype gives way to the definition, or to an earlier one. */
+      if (!body &&
+          (ir_module_find_function(module, child->token.start,
+                                   child->token.length) ||
+           codegen_function_defined(node, child->token))) {
         continue;
       }
 
-      if (!codegen_emit_function(codegen, child, globals, global_count, structs,
-                                 struct_count, typedefs, typedef_count, enums,
-                                 enum_count, functions, function_count, out)) {
+      if (body) {
+        StaticLocalContext static_ctx = {.codegen = codegen,
+                                         .module = module,
+                                         .function_name = child->token,
+                                         .globals = globals,
+                                         .global_count = global_count,
+                                         .structs = structs,
+                                         .struct_count = struct_count,
+                                         .typedefs = typedefs,
+                                         .typedef_count = typedef_count,
+                                         .enums = enums,
+                                         .enum_count = enum_count,
+                                         .body = body,
+                                         .index = 0};
+
+        if (!codegen_emit_static_locals_in_statement(&static_ctx, body)) {
+          goto cleanup;
+        }
+      }
+
+      function = codegen_declare_function(codegen, child, structs, struct_count,
+                                          typedefs, typedef_count, module);
+      if (!function) {
         goto cleanup;
       }
+
+      for (; first_static < module->symbol_count; first_static++) {
+        if (module->symbols[first_static].kind == IR_SYMBOL_GLOBAL) {
+          module->symbols[first_static].global->owner = function;
+        }
+      }
       continue;
     }
 
@@ -4060,6 +5268,35 @@ static int codegen_emit_translation_unit(Codegen *codegen,
     goto cleanup;
   }
 
+  /* Second pass: lower the bodies of the functions declared above. */
+  for (child = node->first_child; child; child = child->next) {
+    const ParserNode *param_list = NULL;
+    const ParserNode *body = NULL;
+    size_t param_count = 0;
+    IrFunction *function = NULL;
+
+    if (child->type != PARSER_NODE_FUNCTION) {
+      continue;
+    }
+
+    if (!codegen_function_parts(codegen, child, &param_list, &param_count,
+                                &body)) {
+      goto cleanup;
+    }
+
+    function = ir_module_find_function(module, child->token.start,
+                                       child->token.length);
+    if (!body || !function) {
+      continue;
+    }
+
+    if (!codegen_emit_function(codegen, child, function, globals, global_count,
+                               structs, struct_count, typedefs, typedef_count,
+                               enums, enum_count, functions, function_count)) {
+      goto cleanup;
+    }
+  }
+
   result = 1;
 
 cleanup:
@@ -4071,52 +5308,262 @@ cleanup:
   return result;
 }
 
-int codegen_emit(Codegen *codegen, const char *output_path) {
-  ParserNode *root = NULL;
+/* Runs the requested IR passes; the module is verified after each one. */
+static int codegen_run_passes(Codegen *codegen, IrModule *module) {
+  IrPassManager manager;
+  const char *message = NULL;
+  int result = 0;
+
+  ir_pass_manager_init(&manager);
+  manager.options.inline_threshold = codegen->options.inline_threshold;
+  if (ir_pass_manager_parse(&manager, codegen->options.passes, &message) &&
+      ir_pass_manager_run(&manager, module, &message)) {
+    if (codegen->options.pass_stats) {
+      ir_pass_manager_report(&manager, codegen->options.pass_stats);
+    }
+    result = 1;
+  } else {
+    codegen_set_error(codegen, message);
+  }
+
+  ir_pass_manager_free(&manager);
+  return result;
+}
+
+static int codegen_apply_profile(Codegen *codegen, IrModule *module) {
+  FILE *in = fopen(codegen->options.profile_use, "r");
+  const char *message = NULL;
+  IrProfile profile;
+  size_t annotated = 0;
+  int result = 0;
+
+  if (!in) {
+    return codegen_set_error(codegen, "codegen: failed to open profile");
+  }
+
+  ir_profile_init(&profile);
+  if (!ir_profile_read(&profile, in, &message)) {
+    codegen_set_error(codegen, message);
+  } else {
+    result = ir_profile_annotate_module(module, &profile, &annotated);
+  }
+  ir_profile_free(&profile);
+  fclose(in);
+  return result;
+}
+
+/* Lays out every profiled definition's blocks for the native targets. */
+static int codegen_layout_blocks(Codegen *codegen, IrModule *module) {
+  size_t changes = 0;
+  size_t index = 0;
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && !ir_function_is_declaration(function) &&
+        !ir_profile_layout_function(function, &changes)) {
+      return codegen_set_error(codegen, "codegen: out of memory");
+    }
+  }
+  return 1;
+}
+
+static int codegen_lower_bytecode(Codegen *codegen, IrModule *module,
+                                  IrVmProgram *program) {
+  IrBytecodeOptions options;
+  const char *message = NULL;
+
+  ir_bytecode_options_init(&options);
+  options.superinstructions = codegen->options.superinstructions;
+  return ir_bytecode_compile(module, &options, program, &message) ||
+         codegen_set_error(codegen, message);
+}
+
+static int codegen_write_bytecode(Codegen *codegen, IrModule *module,
+                                  FILE *out) {
+  IrVmProgram program;
+  int written = 0;
+
+  if (!codegen_lower_bytecode(codegen, module, &program)) {
+    return 0;
+  }
+
+  written = codegen->options.target == CODEGEN_TARGET_BYTECODE
+              ? ir_vm_write_image(&program, out)
+              : ir_vm_write_host(&program, out);
+  ir_vm_program_free(&program);
+  return written;
+}
+
+static int codegen_write_module(Codegen *codegen, IrModule *module,
+                                const char *output_path) {
+  int is_object = codegen->options.target == CODEGEN_TARGET_X86_64_OBJ ||
+                  codegen->options.target == CODEGEN_TARGET_BYTECODE;
+  FILE *out = fopen(output_path, is_object ? "wb" : "w");
+  IrX86Options x86_options;
+  IrLlvmOptions llvm_options;
+  int written = 0;
+
+  if (!out) {
+    return codegen_set_error(codegen, "codegen: failed to open output file");
+  }
+
+  if (codegen->options.target == CODEGEN_TARGET_BYTECODE ||
+      codegen->options.target == CODEGEN_TARGET_BYTECODE_C) {
+    written = codegen_write_bytecode(codegen, module, out);
+  } else if (codegen->options.target == CODEGEN_TARGET_IR) {
+    ir_dump_module(module, out);
+    written = !ferror(out);
+  } else if (codegen->options.target == CODEGEN_TARGET_X86_64_ASM ||
+             codegen->options.target == CODEGEN_TARGET_X86_64_OBJ) {
+    ir_x86_options_init(&x86_options);
+    x86_options.allocate_registers = codegen->options.allocate_registers;
+    written = is_object ? ir_x86_emit_object(module, &x86_options, out)
+                        : ir_x86_emit(module, &x86_options, out);
+  } else {
+    ir_llvm_options_init(&llvm_options);
+    llvm_options.type_based_aliasing = codegen->options.strict_aliasing;
+    written = ir_llvm_emit(module, &llvm_options, out);
+  }
+
+  if (fclose(out) != 0 || !written) {
+    return codegen_set_error(codegen, "codegen: failed to write output file");
+  }
+
+  return 1;
+}
+
+/* Checks, parses, and lowers the input; *root is left for the caller. */
+static IrModule *codegen_build_module(Codegen *codegen, ParserNode **root) {
   const char *parser_message = NULL;
-  FILE *out = NULL;
+  const char *verify_message = NULL;
+  IrModule *module = NULL;
+  int lowered = 0;
 
   codegen->error_message = NULL;
 
   checker_init(&codegen->checker, codegen->input);
   if (!checker_check(&codegen->checker)) {
-    return codegen_set_error(codegen, checker_error(&codegen->checker));
+    codegen_set_error(codegen, checker_error(&codegen->checker));
+    return NULL;
   }
 
   parser_init(&codegen->parser, codegen->input);
-  root = parser_parse(&codegen->parser);
+  *root = parser_parse(&codegen->parser);
   parser_message = parser_error(&codegen->parser);
 
-  if (!root) {
-    return codegen_set_error(codegen, "codegen: out of memory");
+  if (!*root) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    return NULL;
   }
 
   if (parser_message) {
     codegen_set_error(codegen, parser_message);
-    parser_free_node(root);
-    return 0;
+    return NULL;
   }
 
-  out = fopen(output_path, "w");
-  if (!out) {
-    codegen_set_error(codegen, "codegen: failed to open output file");
-    parser_free_node(root);
-    return 0;
+  module = ir_module_create("basecc");
+  if (!module) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    return NULL;
   }
 
-  if (!codegen_emit_translation_unit(codegen, root, out)) {
-    fclose(out);
-    parser_free_node(root);
-    return 0;
+  if (codegen->options.debug_info &&
+      !ir_module_set_source(module, codegen->options.source_name
+                                      ? codegen->options.source_name
+                                      : "<stdin>")) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto fail;
   }
 
-  if (fclose(out) != 0) {
-    parser_free_node(root);
-    return codegen_set_error(codegen, "codegen: failed to write output file");
+  lowered = codegen_emit_translation_unit(codegen, *root, module);
+  line_table_free(&codegen->lines);
+  if (!lowered) {
+    goto fail;
+  }
+
+  if (module->out_of_memory) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto fail;
+  }
+
+  /* Counters and profiles both key on the IR as lowered, before passes. */
+  if (codegen->options.profile_generate &&
+      !ir_profile_instrument_module(module)) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto fail;
+  }
+
+  if (codegen->options.profile_use && !codegen_apply_profile(codegen, module)) {
+    goto fail;
+  }
+
+  if (!ir_verify_module(module, &verify_message)) {
+    codegen_set_error(codegen, verify_message);
+    goto fail;
+  }
+
+  if (codegen->options.passes && !codegen_run_passes(codegen, module)) {
+    goto fail;
+  }
+
+  /*
+   * After the passes, so the calls block no inlining, loop conversion of
+   * tail calls, or attribute inference, and count the calls that remain.
+   */
+  if (codegen->options.instrument_functions &&
+      !ir_profile_instrument_functions(module)) {
+    codegen_set_error(codegen, "codegen: out of memory");
+    goto fail;
+  }
+
+  if (codegen->options.instrument_functions &&
+      !ir_verify_module(module, &verify_message)) {
+    codegen_set_error(codegen, verify_message);
+    goto fail;
+  }
+
+  if (codegen->options.profile_use &&
+      (codegen->options.target == CODEGEN_TARGET_X86_64_ASM ||
+       codegen->options.target == CODEGEN_TARGET_X86_64_OBJ) &&
+      !codegen_layout_blocks(codegen, module)) {
+    goto fail;
+  }
+
+  return module;
+
+fail:
+  ir_module_free(module);
+  return NULL;
+}
+
+int codegen_emit(Codegen *codegen, const char *output_path) {
+  ParserNode *root = NULL;
+  IrModule *module = codegen_build_module(codegen, &root);
+  int result = 0;
+
+  if (module) {
+    result = codegen_write_module(codegen, module, output_path);
   }
 
+  ir_module_free(module);
   parser_free_node(root);
-  return 1;
+  return result;
+}
+
+int codegen_compile_bytecode(Codegen *codegen, IrVmProgram *program) {
+  ParserNode *root = NULL;
+  IrModule *module = codegen_build_module(codegen, &root);
+  int result = 0;
+
+  ir_vm_program_init(program);
+  if (module) {
+    result = codegen_lower_bytecode(codegen, module, program);
+  }
+
+  ir_module_free(module);
+  parser_free_node(root);
+  return result;
 }
 
 const char *codegen_error(const Codegen *codegen) {
@@ -0,0 +1,1992 @@
+#include "ir.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct IrAllocation {
+  struct IrAllocation *next;
+} IrAllocation;
+
+/* Zeroed storage released by ir_module_free. */
+static void *ir_alloc(IrModule *module, size_t size) {
+  IrAllocation *allocation = calloc(1, sizeof(IrAllocation) + size);
+
+  if (!allocation) {
+    module->out_of_memory = 1;
+    return NULL;
+  }
+
+  allocation->next = module->allocations;
+  module->allocations = allocation;
+  return allocation + 1;
+}
+
+static char *ir_strndup(IrModule *module, const char *text, size_t length) {
+  char *copy = ir_alloc(module, length + 1);
+
+  if (!copy) {
+    return NULL;
+  }
+
+  memcpy(copy, text, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+/*
+ * Grows an arena-owned array to hold at least one more element. The old
+ * storage stays in the arena until the module is freed.
+ */
+static int ir_reserve(IrModule *module, void **items, size_t count,
+                      size_t *capacity, size_t item_size) {
+  size_t next_capacity = 0;
+  void *next_items = NULL;
+
+  if (count < *capacity) {
+    return 1;
+  }
+
+  next_capacity = *capacity ? *capacity * 2 : 4;
+  next_items = ir_alloc(module, next_capacity * item_size);
+  if (!next_items) {
+    return 0;
+  }
+
+  if (count > 0) {
+    memcpy(next_items, *items, count * item_size);
+  }
+  *items = next_items;
+  *capacity = next_capacity;
+  return 1;
+}
+
+static int ir_name_equals(const char *name, const char *text, size_t length) {
+  return strlen(name) == length && strncmp(name, text, length) == 0;
+}
+
+IrModule *ir_module_create(const char *name) {
+  IrModule *module = calloc(1, sizeof(*module));
+
+  if (!module) {
+    return NULL;
+  }
+
+  module->name = ir_strndup(module, name, strlen(name));
+  if (!module->name) {
+    ir_module_free(module);
+    return NULL;
+  }
+
+  return module;
+}
+
+int ir_module_set_source(IrModule *module, const char *path) {
+  const char *slash = strrchr(path, '/');
+
+  if (!slash) {
+    module->source_file = ir_strndup(module, path, strlen(path));
+    module->source_directory = ir_strndup(module, ".", 1);
+  } else {
+    module->source_file = ir_strndup(module, slash + 1, strlen(slash + 1));
+    /* "/x.c" was compiled in the root directory. */
+    module->source_directory =
+      ir_strndup(module, path, slash == path ? 1 : (size_t)(slash - path));
+  }
+  return module->source_file && module->source_directory;
+}
+
+void ir_module_free(IrModule *module) {
+  IrAllocation *allocation = NULL;
+
+  if (!module) {
+    return;
+  }
+
+  allocation = module->allocations;
+  while (allocation) {
+    IrAllocation *next = allocation->next;
+
+    free(allocation);
+    allocation = next;
+  }
+
+  free(module);
+}
+
+static IrType *ir_type_new(IrModule *module, IrTypeKind kind) {
+  IrType *type = ir_alloc(module, sizeof(*type));
+
+  if (!type) {
+    return NULL;
+  }
+
+  type->kind = kind;
+  type->next = module->types;
+  module->types = type;
+  return type;
+}
+
+IrType *ir_type_void(IrModule *module) {
+  IrType *type = NULL;
+
+  for (type = module->types; type; type = type->next) {
+    if (type->kind == IR_TYPE_VOID) {
+      return type;
+    }
+  }
+
+  return ir_type_new(module, IR_TYPE_VOID);
+}
+
+IrType *ir_type_int(IrModule *module, int bits) {
+  IrType *type = NULL;
+
+  for (type = module->types; type; type = type->next) {
+    if (type->kind == IR_TYPE_INT && type->bits == bits) {
+      return type;
+    }
+  }
+
+  type = ir_type_new(module, IR_TYPE_INT);
+  if (type) {
+    type->bits = bits;
+  }
+  return type;
+}
+
+IrType *ir_type_pointer(IrModule *module, IrType *element) {
+  if (!element) {
+    return NULL;
+  }
+
+  if (!element->pointer) {
+    IrType *type = ir_type_new(module, IR_TYPE_POINTER);
+
+    if (!type) {
+      return NULL;
+    }
+    type->element = element;
+    element->pointer = type;
+  }
+
+  return element->pointer;
+}
+
+IrType *ir_type_array(IrModule *module, IrType *element, size_t length) {
+  IrType *type = NULL;
+
+  if (!element) {
+    return NULL;
+  }
+
+  for (type = module->types; type; type = type->next) {
+    if (type->kind == IR_TYPE_ARRAY && type->element == element &&
+        type->length == length) {
+      return type;
+    }
+  }
+
+  type = ir_type_new(module, IR_TYPE_ARRAY);
+  if (type) {
+    type->element = element;
+    type->length = length;
+  }
+  return type;
+}
+
+IrType *ir_type_struct(IrModule *module, const char *name, size_t length) {
+  IrType *type = NULL;
+  size_t index = 0;
+
+  for (index = 0; index < module->struct_count; index++) {
+    if (ir_name_equals(module->structs[index]->name, name, length)) {
+      return module->structs[index];
+    }
+  }
+
+  if (!ir_reserve(module, (void **)&module->structs, module->struct_count,
+                  &module->struct_capacity, sizeof(*module->structs))) {
+    return NULL;
+  }
+
+  type = ir_type_new(module, IR_TYPE_STRUCT);
+  if (!type) {
+    return NULL;
+  }
+
+  type->name = ir_strndup(module, name, length);
+  if (!type->name) {
+    return NULL;
+  }
+
+  module->structs[module->struct_count++] = type;
+  return type;
+}
+
+int ir_type_struct_set_body(IrModule *module, IrType *type, IrType **fields,
+                            size_t field_count) {
+  if (field_count > 0) {
+    type->fields = ir_alloc(module, field_count * sizeof(*type->fields));
+    if (!type->fields) {
+      return 0;
+    }
+    memcpy(type->fields, fields, field_count * sizeof(*type->fields));
+  }
+
+  type->field_count = field_count;
+  type->has_body = 1;
+  return 1;
+}
+
+int ir_type_is_int(const IrType *type, int bits) {
+  return type && type->kind == IR_TYPE_INT && type->bits == bits;
+}
+
+size_t ir_type_align(const IrType *type) {
+  size_t align = 1;
+  size_t index = 0;
+
+  switch (type->kind) {
+  case IR_TYPE_INT:
+    return type->bits <= 8 ? 1 : (size_t)type->bits / 8;
+  case IR_TYPE_POINTER:
+    return 8;
+  case IR_TYPE_ARRAY:
+    return ir_type_align(type->element);
+  case IR_TYPE_STRUCT:
+    for (index = 0; index < type->field_count; index++) {
+      size_t field_align = ir_type_align(type->fields[index]);
+
+      if (field_align > align) {
+        align = field_align;
+      }
+    }
+    return align;
+  default:
+    return 1;
+  }
+}
+
+static size_t ir_align_to(size_t offset, size_t align) {
+  return (offset + align - 1) / align * align;
+}
+
+size_t ir_type_field_offset(const IrType *type, size_t index) {
+  size_t offset = 0;
+  size_t field = 0;
+
+  for (field = 0; field < type->field_count; field++) {
+    offset = ir_align_to(offset, ir_type_align(type->fields[field]));
+    if (field == index) {
+      return offset;
+    }
+    offset += ir_type_size(type->fields[field]);
+  }
+
+  return offset;
+}
+
+size_t ir_type_size(const IrType *type) {
+  switch (type->kind) {
+  case IR_TYPE_INT:
+    return type->bits <= 8 ? 1 : (size_t)type->bits / 8;
+  case IR_TYPE_POINTER:
+    return 8;
+  case IR_TYPE_ARRAY:
+    return type->length * ir_type_size(type->element);
+  case IR_TYPE_STRUCT:
+    return ir_align_to(ir_type_field_offset(type, type->field_count),
+                       ir_type_align(type));
+  default:
+    return 0;
+  }
+}
+
+static IrValue *ir_value_new(IrModule *module, IrValueKind kind,
+                             IrType *type) {
+  IrValue *value = NULL;
+
+  if (!type) {
+    return NULL;
+  }
+
+  value = ir_alloc(module, sizeof(*value));
+  if (!value) {
+    return NULL;
+  }
+
+  value->kind = kind;
+  value->type = type;
+  return value;
+}
+
+IrValue *ir_const_int(IrModule *module, IrType *type, long long constant) {
+  IrValue *value = ir_value_new(module, IR_VALUE_CONST_INT, type);
+
+  if (value) {
+    value->constant = constant;
+  }
+  return value;
+}
+
+IrValue *ir_const_null(IrModule *module, IrType *pointer_type) {
+  return ir_value_new(module, IR_VALUE_NULL, pointer_type);
+}
+
+IrValue *ir_const_zero(IrModule *module, IrType *type) {
+  return ir_value_new(module, IR_VALUE_ZERO, type);
+}
+
+int ir_value_is_zero(const IrValue *value) {
+  size_t index = 0;
+
+  switch (value->kind) {
+  case IR_VALUE_CONST_INT:
+    return value->constant == 0;
+  case IR_VALUE_NULL:
+  case IR_VALUE_ZERO:
+    return 1;
+  case IR_VALUE_AGGREGATE:
+    for (index = 0; index < value->element_count; index++) {
+      if (!ir_value_is_zero(value->elements[index])) {
+        return 0;
+      }
+    }
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+IrValue *ir_const_aggregate(IrModule *module, IrType *type,
+                            IrValue **elements, size_t element_count) {
+  IrValue *value = NULL;
+  size_t index = 0;
+
+  for (index = 0; index < element_count; index++) {
+    if (!elements[index]) {
+      return NULL;
+    }
+  }
+  value = ir_value_new(module, IR_VALUE_AGGREGATE, type);
+  if (!value) {
+    return NULL;
+  }
+
+  value->elements = elements;
+  value->element_count = element_count;
+  if (ir_value_is_zero(value)) {
+    value->kind = IR_VALUE_ZERO;
+    value->elements = NULL;
+    value->element_count = 0;
+    return value;
+  }
+
+  value->elements = ir_alloc(module, element_count * sizeof(*elements));
+  if (!value->elements) {
+    return NULL;
+  }
+  memcpy(value->elements, elements, element_count * sizeof(*elements));
+  return value;
+}
+
+int ir_value_is_const_int(const IrValue *value, long long *constant) {
+  if (!value || value->kind != IR_VALUE_CONST_INT) {
+    return 0;
+  }
+
+  if (constant) {
+    *constant = value->constant;
+  }
+  return 1;
+}
+
+static int ir_module_add_symbol(IrModule *module, IrSymbolKind kind,
+                                IrGlobal *global, IrFunction *function) {
+  IrSymbol *symbol = NULL;
+
+  if (!ir_reserve(module, (void **)&module->symbols, module->symbol_count,
+                  &module->symbol_capacity, sizeof(*module->symbols))) {
+    return 0;
+  }
+
+  symbol = &module->symbols[module->symbol_count++];
+  symbol->kind = kind;
+  symbol->global = global;
+  symbol->function = function;
+  return 1;
+}
+
+IrGlobal *ir_module_add_global(IrModule *module, const char *name,
+                               size_t length, IrType *value_type) {
+  IrGlobal *global = ir_alloc(module, sizeof(*global));
+  IrType *pointer_type = ir_type_pointer(module, value_type);
+
+  if (!global || !pointer_type) {
+    return NULL;
+  }
+
+  global->name = ir_strndup(module, name, length);
+  if (!global->name) {
+    return NULL;
+  }
+
+  global->value.kind = IR_VALUE_GLOBAL;
+  global->value.type = pointer_type;
+  global->value.global = global;
+  global->value_type = value_type;
+
+  if (!ir_module_add_symbol(module, IR_SYMBOL_GLOBAL, global, NULL)) {
+    return NULL;
+  }
+  return global;
+}
+
+IrGlobal *ir_module_find_global(const IrModule *module, const char *name,
+                                size_t length) {
+  size_t index = 0;
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrGlobal *global = module->symbols[index].global;
+
+    if (global && ir_name_equals(global->name, name, length)) {
+      return global;
+    }
+  }
+
+  return NULL;
+}
+
+IrFunction *ir_module_add_function(IrModule *module, const char *name,
+                                   size_t length, IrType *return_type) {
+  IrFunction *function = ir_alloc(module, sizeof(*function));
+
+  if (!function || !return_type) {
+    return NULL;
+  }
+
+  function->name = ir_strndup(module, name, length);
+  if (!function->name) {
+    return NULL;
+  }
+
+  /* Functions are only ever called directly, so the value type is unused. */
+  function->value.kind = IR_VALUE_FUNCTION;
+  function->value.type = return_type;
+  function->value.function = function;
+  function->return_type = return_type;
+  function->module = module;
+
+  if (!ir_module_add_symbol(module, IR_SYMBOL_FUNCTION, NULL, function)) {
+    return NULL;
+  }
+  return function;
+}
+
+IrFunction *ir_module_find_function(const IrModule *module, const char *name,
+                                    size_t length) {
+  size_t index = 0;
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && ir_name_equals(function->name, name, length)) {
+      return function;
+    }
+  }
+
+  return NULL;
+}
+
+IrParam *ir_function_add_param(IrFunction *function, IrType *type,
+                               const char *name, size_t length) {
+  IrModule *module = function->module;
+  IrParam *param = ir_alloc(module, sizeof(*param));
+
+  if (!param || !type) {
+    return NULL;
+  }
+
+  if (name) {
+    param->name = ir_strndup(module, name, length);
+    if (!param->name) {
+      return NULL;
+    }
+  }
+
+  if (!ir_reserve(module, (void **)&function->params, function->param_count,
+                  &function->param_capacity, sizeof(*function->params))) {
+    return NULL;
+  }
+
+  param->value.kind = IR_VALUE_PARAM;
+  param->value.type = type;
+  param->value.param = param;
+  param->index = function->param_count;
+  function->params[function->param_count++] = param;
+  return param;
+}
+
+int ir_function_is_declaration(const IrFunction *function) {
+  return function->first_block == NULL;
+}
+
+IrBlock *ir_block_create(IrFunction *function, const char *name) {
+  IrBlock *block = ir_alloc(function->module, sizeof(*block));
+
+  if (!block) {
+    return NULL;
+  }
+
+  block->name = ir_strndup(function->module, name, strlen(name));
+  if (!block->name) {
+    return NULL;
+  }
+
+  block->parent = function;
+  return block;
+}
+
+static void ir_block_attach(IrBlock *block) {
+  IrFunction *function = block->parent;
+
+  if (block->attached) {
+    return;
+  }
+
+  block->prev = function->last_block;
+  block->next = NULL;
+  if (function->last_block) {
+    function->last_block->next = block;
+  } else {
+    function->first_block = block;
+  }
+  function->last_block = block;
+  function->block_count++;
+  block->attached = 1;
+}
+
+void ir_block_insert_after(IrBlock *block, IrBlock *after) {
+  IrFunction *function = block->parent;
+
+  if (block->attached) {
+    return;
+  }
+
+  block->prev = after;
+  block->next = after->next;
+  if (after->next) {
+    after->next->prev = block;
+  } else {
+    function->last_block = block;
+  }
+  after->next = block;
+  function->block_count++;
+  block->attached = 1;
+}
+
+IrBlock *ir_block_split(IrInstr *instr, const char *name) {
+  IrBlock *block = instr->parent;
+  IrBlock *tail = ir_block_create(block->parent, name);
+  IrInstr *moved = NULL;
+  size_t index = 0;
+
+  if (!tail) {
+    return NULL;
+  }
+  ir_block_insert_after(tail, block);
+  tail->has_profile_count = block->has_profile_count;
+  tail->profile_count = block->profile_count;
+
+  tail->first = instr;
+  tail->last = block->last;
+  block->last = instr->prev;
+  if (instr->prev) {
+    instr->prev->next = NULL;
+  } else {
+    block->first = NULL;
+  }
+  instr->prev = NULL;
+  for (moved = instr; moved; moved = moved->next) {
+    moved->parent = tail;
+  }
+
+  for (index = 0; index < ir_block_successor_count(tail); index++) {
+    IrBlock *successor = ir_block_successor(tail, index);
+    IrInstr *phi = NULL;
+    size_t incoming = 0;
+
+    for (phi = successor->first; phi && phi->opcode == IR_OP_PHI;
+         phi = phi->next) {
+      for (incoming = 0; incoming < phi->block_count; incoming++) {
+        if (phi->blocks[incoming] == block) {
+          phi->blocks[incoming] = tail;
+        }
+      }
+    }
+  }
+
+  return tail;
+}
+
+void ir_block_remove(IrBlock *block) {
+  IrFunction *function = block->parent;
+
+  if (!block->attached) {
+    return;
+  }
+
+  while (block->first) {
+    ir_instr_remove(block->first);
+  }
+
+  if (block->prev) {
+    block->prev->next = block->next;
+  } else {
+    function->first_block = block->next;
+  }
+  if (block->next) {
+    block->next->prev = block->prev;
+  } else {
+    function->last_block = block->prev;
+  }
+  function->block_count--;
+  block->attached = 0;
+}
+
+IrInstr *ir_block_terminator(const IrBlock *block) {
+  if (block->last && ir_instr_is_terminator(block->last)) {
+    return block->last;
+  }
+
+  return NULL;
+}
+
+size_t ir_block_successor_count(const IrBlock *block) {
+  const IrInstr *terminator = ir_block_terminator(block);
+
+  if (!terminator || terminator->opcode == IR_OP_RET) {
+    return 0;
+  }
+
+  return terminator->block_count;
+}
+
+IrBlock *ir_block_successor(const IrBlock *block, size_t index) {
+  return ir_block_terminator(block)->blocks[index];
+}
+
+int ir_instr_has_result(const IrInstr *instr) {
+  return instr->value.type->kind != IR_TYPE_VOID;
+}
+
+int ir_instr_is_terminator(const IrInstr *instr) {
+  return instr->opcode == IR_OP_BR || instr->opcode == IR_OP_CONDBR ||
+         instr->opcode == IR_OP_SWITCH || instr->opcode == IR_OP_RET;
+}
+
+/* A call to a function known to write nothing and to return is pure. */
+int ir_instr_has_side_effects(const IrInstr *instr) {
+  if (instr->opcode == IR_OP_CALL) {
+    const IrFunction *callee = instr->operands[0]->function;
+
+    return callee->memory == IR_MEMORY_READWRITE || !callee->willreturn ||
+           !callee->nounwind;
+  }
+  return instr->opcode == IR_OP_STORE || instr->opcode == IR_OP_MEMSET ||
+         instr->opcode == IR_OP_MEMCPY || ir_instr_is_terminator(instr);
+}
+
+static int ir_instr_add_operand(IrInstr *instr, IrValue *value) {
+  IrModule *module = instr->parent->parent->module;
+
+  if (!value) {
+    return 0;
+  }
+
+  if (!ir_reserve(module, (void **)&instr->operands, instr->operand_count,
+                  &instr->operand_capacity, sizeof(*instr->operands))) {
+    return 0;
+  }
+
+  instr->operands[instr->operand_count++] = value;
+  value->use_count++;
+  return 1;
+}
+
+static int ir_instr_add_block(IrInstr *instr, IrBlock *block) {
+  IrModule *module = instr->parent->parent->module;
+
+  if (!block) {
+    return 0;
+  }
+
+  if (!ir_reserve(module, (void **)&instr->blocks, instr->block_count,
+                  &instr->block_capacity, sizeof(*instr->blocks))) {
+    return 0;
+  }
+
+  instr->blocks[instr->block_count++] = block;
+  return 1;
+}
+
+void ir_instr_set_operand(IrInstr *instr, size_t index, IrValue *value) {
+  instr->operands[index]->use_count--;
+  instr->operands[index] = value;
+  value->use_count++;
+}
+
+void ir_instr_remove(IrInstr *instr) {
+  IrBlock *block = instr->parent;
+  size_t index = 0;
+
+  for (index = 0; index < instr->operand_count; index++) {
+    instr->operands[index]->use_count--;
+  }
+  instr->operand_count = 0;
+  instr->block_count = 0;
+
+  if (instr->prev) {
+    instr->prev->next = instr->next;
+  } else {
+    block->first = instr->next;
+  }
+  if (instr->next) {
+    instr->next->prev = instr->prev;
+  } else {
+    block->last = instr->prev;
+  }
+  instr->prev = NULL;
+  instr->next = NULL;
+}
+
+void ir_instr_move_before(IrInstr *instr, IrInstr *before) {
+  IrBlock *block = instr->parent;
+
+  if (instr->prev) {
+    instr->prev->next = instr->next;
+  } else {
+    block->first = instr->next;
+  }
+  if (instr->next) {
+    instr->next->prev = instr->prev;
+  } else {
+    block->last = instr->prev;
+  }
+
+  block = before->parent;
+  instr->parent = block;
+  instr->next = before;
+  instr->prev = before->prev;
+  if (before->prev) {
+    before->prev->next = instr;
+  } else {
+    block->first = instr;
+  }
+  before->prev = instr;
+}
+
+int ir_phi_add_incoming(IrInstr *phi, IrValue *value, IrBlock *block) {
+  return ir_instr_add_operand(phi, value) && ir_instr_add_block(phi, block);
+}
+
+void ir_phi_remove_incoming(IrInstr *phi, const IrBlock *block) {
+  size_t index = 0;
+  size_t kept = 0;
+
+  for (index = 0; index < phi->operand_count; index++) {
+    if (phi->blocks[index] == block) {
+      phi->operands[index]->use_count--;
+      continue;
+    }
+
+    phi->operands[kept] = phi->operands[index];
+    phi->blocks[kept] = phi->blocks[index];
+    kept++;
+  }
+
+  phi->operand_count = kept;
+  phi->block_count = kept;
+}
+
+void ir_replace_all_uses(IrFunction *function, IrValue *from, IrValue *to) {
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t index = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        if (instr->operands[index] == from) {
+          ir_instr_set_operand(instr, index, to);
+        }
+      }
+    }
+  }
+}
+
+void ir_builder_init(IrBuilder *builder, IrFunction *function) {
+  builder->module = function->module;
+  builder->function = function;
+  builder->block = NULL;
+  builder->loc.line = 0;
+  builder->loc.column = 0;
+}
+
+void ir_builder_set_block(IrBuilder *builder, IrBlock *block) {
+  ir_block_attach(block);
+  builder->block = block;
+}
+
+static IrInstr *ir_builder_append(IrBuilder *builder, IrOpcode opcode,
+                                  IrType *type) {
+  IrBlock *block = builder->block;
+  IrInstr *instr = NULL;
+
+  if (!type || !block) {
+    return NULL;
+  }
+
+  instr = ir_alloc(builder->module, sizeof(*instr));
+  if (!instr) {
+    return NULL;
+  }
+
+  instr->value.kind = IR_VALUE_INSTR;
+  instr->value.type = type;
+  instr->value.instr = instr;
+  instr->opcode = opcode;
+  instr->parent = block;
+  instr->loc = builder->loc;
+  instr->id = -1;
+  if (type->kind != IR_TYPE_VOID) {
+    instr->id = builder->function->next_value_id++;
+  }
+
+  instr->prev = block->last;
+  if (block->last) {
+    block->last->next = instr;
+  } else {
+    block->first = instr;
+  }
+  block->last = instr;
+  return instr;
+}
+
+IrValue *ir_build_alloca(IrBuilder *builder, IrType *type) {
+  IrInstr *instr = ir_builder_append(builder, IR_OP_ALLOCA,
+                                     ir_type_pointer(builder->module, type));
+
+  if (!instr) {
+    return NULL;
+  }
+
+  instr->aux_type = type;
+  return &instr->value;
+}
+
+IrValue *ir_build_load(IrBuilder *builder, IrValue *pointer) {
+  IrInstr *instr = NULL;
+
+  if (!pointer || pointer->type->kind != IR_TYPE_POINTER) {
+    return NULL;
+  }
+
+  instr = ir_builder_append(builder, IR_OP_LOAD, pointer->type->element);
+  if (!instr || !ir_instr_add_operand(instr, pointer)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_store(IrBuilder *builder, IrValue *value, IrValue *pointer) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_STORE, ir_type_void(builder->module));
+
+  if (!instr || !ir_instr_add_operand(instr, value) ||
+      !ir_instr_add_operand(instr, pointer)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+/* Walks the indices past the first to find the addressed element type. */
+static IrType *ir_gep_result_element(IrType *source, IrValue **indices,
+                                     size_t index_count) {
+  IrType *type = source;
+  size_t index = 0;
+
+  for (index = 1; index < index_count && type; index++) {
+    long long field = 0;
+
+    if (type->kind == IR_TYPE_ARRAY) {
+      type = type->element;
+    } else if (type->kind == IR_TYPE_STRUCT &&
+               ir_value_is_const_int(indices[index], &field) && field >= 0 &&
+               (size_t)field < type->field_count) {
+      type = type->fields[field];
+    } else {
+      type = NULL;
+    }
+  }
+
+  return type;
+}
+
+IrValue *ir_build_gep(IrBuilder *builder, unsigned flags, IrType *source,
+                      IrValue *base, IrValue **indices, size_t index_count) {
+  IrType *element = ir_gep_result_element(source, indices, index_count);
+  IrInstr *instr = NULL;
+  size_t index = 0;
+
+  if (!base || !element || index_count == 0) {
+    return NULL;
+  }
+
+  instr = ir_builder_append(builder, IR_OP_GEP,
+                            ir_type_pointer(builder->module, element));
+  if (!instr || !ir_instr_add_operand(instr, base)) {
+    return NULL;
+  }
+
+  instr->flags = flags;
+  instr->aux_type = source;
+  for (index = 0; index < index_count; index++) {
+    if (!ir_instr_add_operand(instr, indices[index])) {
+      return NULL;
+    }
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_binary(IrBuilder *builder, IrOpcode opcode, unsigned flags,
+                         IrValue *left, IrValue *right) {
+  IrInstr *instr = NULL;
+
+  if (!left || !right) {
+    return NULL;
+  }
+
+  instr = ir_builder_append(builder, opcode, left->type);
+  if (!instr || !ir_instr_add_operand(instr, left) ||
+      !ir_instr_add_operand(instr, right)) {
+    return NULL;
+  }
+
+  instr->flags = flags;
+  return &instr->value;
+}
+
+IrValue *ir_build_icmp(IrBuilder *builder, IrPredicate predicate,
+                       IrValue *left, IrValue *right) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_ICMP, ir_type_int(builder->module, 1));
+
+  if (!instr || !ir_instr_add_operand(instr, left) ||
+      !ir_instr_add_operand(instr, right)) {
+    return NULL;
+  }
+
+  instr->predicate = predicate;
+  return &instr->value;
+}
+
+IrValue *ir_build_cast(IrBuilder *builder, IrOpcode opcode, IrValue *value,
+                       IrType *type) {
+  IrInstr *instr = ir_builder_append(builder, opcode, type);
+
+  if (!instr || !ir_instr_add_operand(instr, value)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_call(IrBuilder *builder, IrFunction *callee, IrValue **args,
+                       size_t arg_count) {
+  IrInstr *instr = NULL;
+  size_t index = 0;
+
+  if (!callee) {
+    return NULL;
+  }
+
+  instr = ir_builder_append(builder, IR_OP_CALL, callee->return_type);
+  if (!instr || !ir_instr_add_operand(instr, &callee->value)) {
+    return NULL;
+  }
+
+  instr->calling_conv = callee->calling_conv;
+  for (index = 0; index < arg_count; index++) {
+    if (!ir_instr_add_operand(instr, args[index])) {
+      return NULL;
+    }
+  }
+  return &instr->value;
+}
+
+/* The three operands of a memset or memcpy, in order. */
+static IrValue *ir_build_memory(IrBuilder *builder, IrOpcode opcode,
+                                IrValue *first, IrValue *second,
+                                IrValue *length) {
+  IrInstr *instr =
+    ir_builder_append(builder, opcode, ir_type_void(builder->module));
+
+  if (!instr || !ir_instr_add_operand(instr, first) ||
+      !ir_instr_add_operand(instr, second) ||
+      !ir_instr_add_operand(instr, length)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_memset(IrBuilder *builder, IrValue *pointer, IrValue *value,
+                         IrValue *length) {
+  return ir_build_memory(builder, IR_OP_MEMSET, pointer, value, length);
+}
+
+IrValue *ir_build_memcpy(IrBuilder *builder, IrValue *destination,
+                         IrValue *source, IrValue *length) {
+  return ir_build_memory(builder, IR_OP_MEMCPY, destination, source, length);
+}
+
+IrValue *ir_build_clone(IrBuilder *builder, const IrInstr *instr) {
+  IrInstr *clone = ir_builder_append(builder, instr->opcode, instr->value.type);
+  size_t index = 0;
+
+  if (!clone) {
+    return NULL;
+  }
+
+  clone->flags = instr->flags;
+  clone->predicate = instr->predicate;
+  clone->aux_type = instr->aux_type;
+  clone->calling_conv = instr->calling_conv;
+  clone->has_branch_weights = instr->has_branch_weights;
+  clone->branch_weights[0] = instr->branch_weights[0];
+  clone->branch_weights[1] = instr->branch_weights[1];
+  for (index = 0; index < instr->operand_count; index++) {
+    if (!ir_instr_add_operand(clone, instr->operands[index])) {
+      return NULL;
+    }
+  }
+  for (index = 0; index < instr->block_count; index++) {
+    if (!ir_instr_add_block(clone, instr->blocks[index])) {
+      return NULL;
+    }
+  }
+  return &clone->value;
+}
+
+IrValue *ir_build_phi(IrBuilder *builder, IrType *type) {
+  IrInstr *instr = ir_builder_append(builder, IR_OP_PHI, type);
+
+  return instr ? &instr->value : NULL;
+}
+
+IrValue *ir_build_br(IrBuilder *builder, IrBlock *target) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_BR, ir_type_void(builder->module));
+
+  if (!instr || !ir_instr_add_block(instr, target)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_condbr(IrBuilder *builder, IrValue *condition,
+                         IrBlock *true_block, IrBlock *false_block) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_CONDBR, ir_type_void(builder->module));
+
+  if (!instr || !ir_instr_add_operand(instr, condition) ||
+      !ir_instr_add_block(instr, true_block) ||
+      !ir_instr_add_block(instr, false_block)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+IrValue *ir_build_switch(IrBuilder *builder, IrValue *condition,
+                         IrBlock *default_block) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_SWITCH, ir_type_void(builder->module));
+
+  if (!instr || !ir_instr_add_operand(instr, condition) ||
+      !ir_instr_add_block(instr, default_block)) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+int ir_switch_add_case(IrInstr *instr, IrValue *constant, IrBlock *block) {
+  return ir_instr_add_operand(instr, constant) &&
+         ir_instr_add_block(instr, block);
+}
+
+IrValue *ir_build_ret(IrBuilder *builder, IrValue *value) {
+  IrInstr *instr =
+    ir_builder_append(builder, IR_OP_RET, ir_type_void(builder->module));
+
+  if (!instr || (value && !ir_instr_add_operand(instr, value))) {
+    return NULL;
+  }
+  return &instr->value;
+}
+
+static int ir_block_add_pred(IrBlock *block, IrBlock *pred) {
+  IrModule *module = block->parent->module;
+  size_t index = 0;
+
+  for (index = 0; index < block->pred_count; index++) {
+    if (block->preds[index] == pred) {
+      return 1;
+    }
+  }
+
+  if (!ir_reserve(module, (void **)&block->preds, block->pred_count,
+                  &block->pred_capacity, sizeof(*block->preds))) {
+    return 0;
+  }
+
+  block->preds[block->pred_count++] = pred;
+  return 1;
+}
+
+static void ir_mark_reachable(IrBlock *block) {
+  size_t index = 0;
+
+  if (block->reachable) {
+    return;
+  }
+
+  block->reachable = 1;
+  for (index = 0; index < ir_block_successor_count(block); index++) {
+    ir_mark_reachable(ir_block_successor(block, index));
+  }
+}
+
+int ir_function_build_cfg(IrFunction *function) {
+  IrBlock *block = NULL;
+  size_t position = 0;
+  size_t index = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    block->index = position++;
+    block->pred_count = 0;
+    block->reachable = 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (index = 0; index < ir_block_successor_count(block); index++) {
+      if (!ir_block_add_pred(ir_block_successor(block, index), block)) {
+        return 0;
+      }
+    }
+  }
+
+  if (function->first_block) {
+    ir_mark_reachable(function->first_block);
+  }
+  return 1;
+}
+
+static void ir_postorder(IrBlock *block, IrBlock **order, size_t *count,
+                         char *visited) {
+  size_t index = 0;
+
+  visited[block->index] = 1;
+  for (index = 0; index < ir_block_successor_count(block); index++) {
+    IrBlock *successor = ir_block_successor(block, index);
+
+    if (!visited[successor->index]) {
+      ir_postorder(successor, order, count, visited);
+    }
+  }
+  order[(*count)++] = block;
+}
+
+static IrBlock *ir_intersect(IrBlock *left, IrBlock *right) {
+  while (left != right) {
+    while (left->rpo_index > right->rpo_index) {
+      left = left->idom;
+    }
+    while (right->rpo_index > left->rpo_index) {
+      right = right->idom;
+    }
+  }
+
+  return left;
+}
+
+/*
+ * Cooper, Harvey, and Kennedy's iterative algorithm over reverse postorder.
+ * Unreachable blocks keep a NULL idom.
+ */
+int ir_function_compute_dominators(IrFunction *function) {
+  IrBlock **order = NULL;
+  char *visited = NULL;
+  IrBlock *block = NULL;
+  size_t count = 0;
+  size_t index = 0;
+  int changed = 1;
+
+  if (!ir_function_build_cfg(function)) {
+    return 0;
+  }
+
+  if (!function->first_block) {
+    return 1;
+  }
+
+  order = malloc(function->block_count * sizeof(*order));
+  visited = calloc(function->block_count, 1);
+  if (!order || !visited) {
+    free(order);
+    free(visited);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    block->idom = NULL;
+  }
+
+  ir_postorder(function->first_block, order, &count, visited);
+  for (index = 0; index < count; index++) {
+    order[index]->rpo_index = count - 1 - index;
+  }
+
+  function->first_block->idom = function->first_block;
+  while (changed) {
+    changed = 0;
+    for (index = count - 1; index-- > 0;) {
+      IrBlock *current = order[index];
+      IrBlock *idom = NULL;
+      size_t pred = 0;
+
+      for (pred = 0; pred < current->pred_count; pred++) {
+        IrBlock *candidate = current->preds[pred];
+
+        if (!candidate->reachable || !candidate->idom) {
+          continue;
+        }
+        idom = idom ? ir_intersect(candidate, idom) : candidate;
+      }
+
+      if (idom && current->idom != idom) {
+        current->idom = idom;
+        changed = 1;
+      }
+    }
+  }
+
+  function->first_block->idom = NULL;
+  free(order);
+  free(visited);
+  return 1;
+}
+
+int ir_block_dominates(const IrBlock *dominator, const IrBlock *block) {
+  if (!block->reachable) {
+    return 1;
+  }
+
+  for (; block; block = block->idom) {
+    if (block == dominator) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Counts the natural loops around each block. A loop is headed by a block
+ * that dominates one of its predecessors; its body is everything that
+ * reaches such a back edge without passing through the header.
+ */
+int ir_function_compute_loop_depth(IrFunction *function) {
+  IrBlock **worklist = NULL;
+  char *in_loop = NULL;
+  IrBlock *header = NULL;
+  IrBlock *block = NULL;
+  size_t pred = 0;
+
+  if (!ir_function_compute_dominators(function)) {
+    return 0;
+  }
+
+  worklist = malloc((function->block_count + 1) * sizeof(*worklist));
+  in_loop = malloc(function->block_count + 1);
+  if (!worklist || !in_loop) {
+    free(worklist);
+    free(in_loop);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    block->loop_depth = 0;
+  }
+
+  for (header = function->first_block; header; header = header->next) {
+    size_t count = 0;
+    int is_header = 0;
+
+    if (!header->reachable) {
+      continue;
+    }
+
+    memset(in_loop, 0, function->block_count);
+    in_loop[header->index] = 1;
+    for (pred = 0; pred < header->pred_count; pred++) {
+      IrBlock *latch = header->preds[pred];
+
+      /* Every back edge into the header belongs to the same loop. */
+      if (latch->reachable && ir_block_dominates(header, latch)) {
+        is_header = 1;
+        if (!in_loop[latch->index]) {
+          in_loop[latch->index] = 1;
+          worklist[count++] = latch;
+        }
+      }
+    }
+
+    while (count > 0) {
+      IrBlock *member = worklist[--count];
+
+      for (pred = 0; pred < member->pred_count; pred++) {
+        IrBlock *source = member->preds[pred];
+
+        if (source->reachable && !in_loop[source->index]) {
+          in_loop[source->index] = 1;
+          worklist[count++] = source;
+        }
+      }
+    }
+
+    if (!is_header) {
+      continue;
+    }
+
+    for (block = function->first_block; block; block = block->next) {
+      if (in_loop[block->index]) {
+        block->loop_depth++;
+      }
+    }
+  }
+
+  free(worklist);
+  free(in_loop);
+  return 1;
+}
+
+static int ir_verify_fail(const char **message, const char *text) {
+  if (message) {
+    *message = text;
+  }
+
+  return 0;
+}
+
+static int ir_instr_precedes(const IrInstr *first, const IrInstr *second) {
+  for (; first; first = first->next) {
+    if (first == second) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static int ir_verify_operand(const IrFunction *function, const IrInstr *instr,
+                             size_t index, const char **message) {
+  const IrValue *operand = instr->operands[index];
+  const IrInstr *definition = NULL;
+  const IrBlock *use_block = instr->parent;
+
+  if (operand->kind == IR_VALUE_PARAM) {
+    size_t param = operand->param->index;
+
+    if (param >= function->param_count ||
+        function->params[param] != operand->param) {
+      return ir_verify_fail(message, "ir: parameter of another function");
+    }
+    return 1;
+  }
+
+  if (operand->kind != IR_VALUE_INSTR) {
+    return 1;
+  }
+
+  definition = operand->instr;
+  if (!definition->parent || definition->parent->parent != function ||
+      !definition->parent->attached) {
+    return ir_verify_fail(message, "ir: operand defined outside function");
+  }
+
+  if (!ir_instr_has_result(definition)) {
+    return ir_verify_fail(message, "ir: operand has no result");
+  }
+
+  if (instr->opcode == IR_OP_PHI) {
+    use_block = instr->blocks[index];
+    if (definition->parent == use_block) {
+      return 1;
+    }
+  } else if (definition->parent == use_block) {
+    if (definition == instr || !ir_instr_precedes(definition, instr)) {
+      return ir_verify_fail(message, "ir: operand used before definition");
+    }
+    return 1;
+  }
+
+  if (!ir_block_dominates(definition->parent, use_block)) {
+    return ir_verify_fail(message, "ir: operand does not dominate use");
+  }
+
+  return 1;
+}
+
+static int ir_verify_types(const IrFunction *function, const IrInstr *instr,
+                           const char **message) {
+  IrValue *const *operands = instr->operands;
+  const IrType *type = instr->value.type;
+  size_t index = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_ALLOCA:
+    if (instr->operand_count != 0 || type->element != instr->aux_type) {
+      return ir_verify_fail(message, "ir: malformed alloca");
+    }
+    return 1;
+  case IR_OP_LOAD:
+    if (instr->operand_count != 1 ||
+        operands[0]->type->kind != IR_TYPE_POINTER ||
+        operands[0]->type->element != type) {
+      return ir_verify_fail(message, "ir: load type mismatch");
+    }
+    return 1;
+  case IR_OP_STORE:
+    if (instr->operand_count != 2 ||
+        operands[1]->type->kind != IR_TYPE_POINTER ||
+        operands[1]->type->element != operands[0]->type) {
+      return ir_verify_fail(message, "ir: store type mismatch");
+    }
+    return 1;
+  case IR_OP_GEP:
+    if (instr->operand_count < 2 ||
+        operands[0]->type->kind != IR_TYPE_POINTER ||
+        operands[0]->type->element != instr->aux_type) {
+      return ir_verify_fail(message, "ir: getelementptr type mismatch");
+    }
+    for (index = 1; index < instr->operand_count; index++) {
+      if (operands[index]->type->kind != IR_TYPE_INT) {
+        return ir_verify_fail(message, "ir: getelementptr index not integer");
+      }
+    }
+    return 1;
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+    if (instr->operand_count != 2 || type->kind != IR_TYPE_INT ||
+        operands[0]->type != type || operands[1]->type != type) {
+      return ir_verify_fail(message, "ir: binary operand type mismatch");
+    }
+    return 1;
+  case IR_OP_ICMP:
+    if (instr->operand_count != 2 || !ir_type_is_int(type, 1) ||
+        operands[0]->type != operands[1]->type ||
+        (operands[0]->type->kind != IR_TYPE_INT &&
+         operands[0]->type->kind != IR_TYPE_POINTER)) {
+      return ir_verify_fail(message, "ir: icmp operand type mismatch");
+    }
+    return 1;
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+    if (instr->operand_count != 1 || type->kind != IR_TYPE_INT ||
+        operands[0]->type->kind != IR_TYPE_INT ||
+        operands[0]->type->bits >= type->bits) {
+      return ir_verify_fail(message, "ir: extension must widen");
+    }
+    return 1;
+  case IR_OP_TRUNC:
+    if (instr->operand_count != 1 || type->kind != IR_TYPE_INT ||
+        operands[0]->type->kind != IR_TYPE_INT ||
+        operands[0]->type->bits <= type->bits) {
+      return ir_verify_fail(message, "ir: trunc must narrow");
+    }
+    return 1;
+  case IR_OP_PTRTOINT:
+    if (instr->operand_count != 1 || type->kind != IR_TYPE_INT ||
+        operands[0]->type->kind != IR_TYPE_POINTER) {
+      return ir_verify_fail(message, "ir: malformed ptrtoint");
+    }
+    return 1;
+  case IR_OP_INTTOPTR:
+    if (instr->operand_count != 1 || type->kind != IR_TYPE_POINTER ||
+        operands[0]->type->kind != IR_TYPE_INT) {
+      return ir_verify_fail(message, "ir: malformed inttoptr");
+    }
+    return 1;
+  case IR_OP_BITCAST:
+    if (instr->operand_count != 1 || type->kind != IR_TYPE_POINTER ||
+        operands[0]->type->kind != IR_TYPE_POINTER) {
+      return ir_verify_fail(message, "ir: malformed bitcast");
+    }
+    return 1;
+  case IR_OP_CALL: {
+    const IrFunction *callee = NULL;
+
+    if (instr->operand_count < 1 ||
+        operands[0]->kind != IR_VALUE_FUNCTION) {
+      return ir_verify_fail(message, "ir: call without callee");
+    }
+    callee = operands[0]->function;
+    if (callee->param_count != instr->operand_count - 1 ||
+        callee->return_type != type) {
+      return ir_verify_fail(message, "ir: call signature mismatch");
+    }
+    for (index = 0; index < callee->param_count; index++) {
+      if (callee->params[index]->value.type != operands[index + 1]->type) {
+        return ir_verify_fail(message, "ir: call argument type mismatch");
+      }
+    }
+    if ((instr->flags & IR_FLAG_MUSTTAIL) &&
+        (!instr->next || instr->next->opcode != IR_OP_RET ||
+         instr->next->operand_count != (ir_instr_has_result(instr) ? 1 : 0) ||
+         (instr->next->operand_count &&
+          instr->next->operands[0] != &instr->value))) {
+      return ir_verify_fail(message, "ir: musttail call is not returned");
+    }
+    return 1;
+  }
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    if (instr->operand_count != 3 ||
+        operands[0]->type->kind != IR_TYPE_POINTER ||
+        !ir_type_is_int(operands[0]->type->element, 8) ||
+        operands[1]->type != (instr->opcode == IR_OP_MEMSET
+                                ? operands[0]->type->element
+                                : operands[0]->type) ||
+        !ir_type_is_int(operands[2]->type, 64)) {
+      return ir_verify_fail(message, "ir: malformed memset or memcpy");
+    }
+    return 1;
+  case IR_OP_PHI: {
+    const IrBlock *block = instr->parent;
+
+    if (instr->operand_count != instr->block_count ||
+        instr->block_count != block->pred_count) {
+      return ir_verify_fail(message, "ir: phi does not cover predecessors");
+    }
+    for (index = 0; index < instr->operand_count; index++) {
+      size_t pred = 0;
+
+      if (operands[index]->type != type) {
+        return ir_verify_fail(message, "ir: phi incoming type mismatch");
+      }
+      for (pred = 0; pred < block->pred_count; pred++) {
+        if (block->preds[pred] == instr->blocks[index]) {
+          break;
+        }
+      }
+      if (pred == block->pred_count) {
+        return ir_verify_fail(message,
+                              "ir: phi incoming block is not a predecessor");
+      }
+    }
+    return 1;
+  }
+  case IR_OP_BR:
+  case IR_OP_CONDBR:
+  case IR_OP_SWITCH:
+    if (instr->opcode == IR_OP_CONDBR &&
+        (instr->operand_count != 1 || instr->block_count != 2 ||
+         !ir_type_is_int(operands[0]->type, 1))) {
+      return ir_verify_fail(message, "ir: branch condition must be i1");
+    }
+    if (instr->opcode == IR_OP_SWITCH) {
+      if (instr->operand_count < 1 ||
+          instr->operand_count != instr->block_count ||
+          operands[0]->type->kind != IR_TYPE_INT) {
+        return ir_verify_fail(message, "ir: malformed switch");
+      }
+      for (index = 1; index < instr->operand_count; index++) {
+        size_t other = 0;
+
+        if (operands[index]->kind != IR_VALUE_CONST_INT ||
+            operands[index]->type != operands[0]->type) {
+          return ir_verify_fail(message,
+                                "ir: switch case must be a constant");
+        }
+        for (other = 1; other < index; other++) {
+          if (operands[other]->constant == operands[index]->constant) {
+            return ir_verify_fail(message, "ir: duplicate switch case");
+          }
+        }
+      }
+    }
+    for (index = 0; index < instr->block_count; index++) {
+      if (instr->blocks[index]->parent != function ||
+          !instr->blocks[index]->attached) {
+        return ir_verify_fail(message, "ir: branch to detached block");
+      }
+    }
+    return 1;
+  case IR_OP_RET:
+    if (function->return_type->kind == IR_TYPE_VOID
+          ? instr->operand_count != 0
+          : instr->operand_count != 1 ||
+              operands[0]->type != function->return_type) {
+      return ir_verify_fail(message, "ir: return type mismatch");
+    }
+    return 1;
+  default:
+    return ir_verify_fail(message, "ir: unknown opcode");
+  }
+}
+
+int ir_verify_function(IrFunction *function, const char **message) {
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t index = 0;
+
+  if (ir_function_is_declaration(function)) {
+    return 1;
+  }
+
+  if (!ir_function_compute_dominators(function)) {
+    return ir_verify_fail(message, "ir: out of memory");
+  }
+
+  if (function->first_block->pred_count > 0) {
+    return ir_verify_fail(message, "ir: entry block has predecessors");
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    int seen_non_phi = 0;
+
+    if (!ir_block_terminator(block)) {
+      return ir_verify_fail(message, "ir: block without terminator");
+    }
+
+    for (instr = block->first; instr; instr = instr->next) {
+      if (instr->parent != block) {
+        return ir_verify_fail(message, "ir: instruction in wrong block");
+      }
+      if (ir_instr_is_terminator(instr) && instr != block->last) {
+        return ir_verify_fail(message, "ir: terminator in middle of block");
+      }
+      if (instr->opcode == IR_OP_PHI) {
+        if (seen_non_phi) {
+          return ir_verify_fail(message, "ir: phi after non-phi");
+        }
+      } else {
+        seen_non_phi = 1;
+      }
+
+      for (index = 0; index < instr->operand_count; index++) {
+        if (!ir_verify_operand(function, instr, index, message)) {
+          return 0;
+        }
+      }
+
+      if (!ir_verify_types(function, instr, message)) {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}
+
+int ir_verify_module(IrModule *module, const char **message) {
+  size_t index = 0;
+
+  if (module->out_of_memory) {
+    return ir_verify_fail(message, "ir: out of memory");
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && !ir_verify_function(function, message)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+const char *ir_opcode_name(IrOpcode opcode) {
+  static const char *const names[] = {
+    "alloca", "load",     "store",    "getelementptr", "add",    "sub",
+    "mul",    "sdiv",     "srem",     "shl",           "ashr",   "lshr",
+    "and",    "or",       "xor",      "icmp",          "sext",   "zext",
+    "trunc",  "ptrtoint", "inttoptr", "bitcast",       "call",   "memset",
+    "memcpy", "phi",      "br",       "condbr",        "switch", "ret"};
+
+  return names[opcode];
+}
+
+const char *ir_predicate_name(IrPredicate predicate) {
+  static const char *const names[] = {"eq",  "ne",  "slt", "sle", "sgt",
+                                      "sge", "ult", "ule", "ugt", "uge"};
+
+  return names[predicate];
+}
+
+void ir_dump_type(const IrType *type, FILE *out) {
+  switch (type->kind) {
+  case IR_TYPE_VOID:
+    fprintf(out, "void");
+    break;
+  case IR_TYPE_INT:
+    fprintf(out, "i%d", type->bits);
+    break;
+  case IR_TYPE_POINTER:
+    ir_dump_type(type->element, out);
+    fprintf(out, "*");
+    break;
+  case IR_TYPE_ARRAY:
+    fprintf(out, "[%zu x ", type->length);
+    ir_dump_type(type->element, out);
+    fprintf(out, "]");
+    break;
+  case IR_TYPE_STRUCT:
+    fprintf(out, "%%%s", type->name);
+    break;
+  }
+}
+
+static void ir_dump_value(const IrValue *value, FILE *out) {
+  size_t index = 0;
+
+  switch (value->kind) {
+  case IR_VALUE_CONST_INT:
+    fprintf(out, "%lld", value->constant);
+    break;
+  case IR_VALUE_NULL:
+    fprintf(out, "null");
+    break;
+  case IR_VALUE_ZERO:
+    fprintf(out, "zeroinitializer");
+    break;
+  case IR_VALUE_AGGREGATE:
+    fprintf(out, value->type->kind == IR_TYPE_ARRAY ? "[" : "{");
+    for (index = 0; index < value->element_count; index++) {
+      if (index > 0) {
+        fprintf(out, ", ");
+      }
+      ir_dump_value(value->elements[index], out);
+    }
+    fprintf(out, value->type->kind == IR_TYPE_ARRAY ? "]" : "}");
+    break;
+  case IR_VALUE_GLOBAL:
+    fprintf(out, "@%s", value->global->name);
+    break;
+  case IR_VALUE_FUNCTION:
+    fprintf(out, "@%s", value->function->name);
+    break;
+  case IR_VALUE_PARAM:
+    fprintf(out, "%%%s", value->param->name);
+    break;
+  case IR_VALUE_INSTR:
+    fprintf(out, "%%t%d", value->instr->id);
+    break;
+  }
+}
+
+static void ir_dump_instr(const IrInstr *instr, FILE *out) {
+  size_t index = 0;
+
+  fprintf(out, "  ");
+  if (ir_instr_has_result(instr)) {
+    fprintf(out, "%%t%d: ", instr->id);
+    ir_dump_type(instr->value.type, out);
+    fprintf(out, " = ");
+  }
+
+  fprintf(out, "%s", ir_opcode_name(instr->opcode));
+  if (instr->opcode == IR_OP_ICMP) {
+    fprintf(out, ".%s", ir_predicate_name(instr->predicate));
+  }
+  if (instr->flags & IR_FLAG_NSW) {
+    fprintf(out, ".nsw");
+  }
+  if (instr->flags & IR_FLAG_INBOUNDS) {
+    fprintf(out, ".inbounds");
+  }
+  if (instr->flags & IR_FLAG_TAIL) {
+    fprintf(out, ".tail");
+  }
+  if (instr->flags & IR_FLAG_MUSTTAIL) {
+    fprintf(out, ".musttail");
+  }
+  if (instr->opcode == IR_OP_CALL && instr->calling_conv == IR_CC_FAST) {
+    fprintf(out, ".fastcc");
+  }
+  if (instr->aux_type) {
+    fprintf(out, " ");
+    ir_dump_type(instr->aux_type, out);
+    if (instr->operand_count > 0) {
+      fprintf(out, ",");
+    }
+  }
+
+  if (instr->opcode == IR_OP_SWITCH) {
+    fprintf(out, " ");
+    ir_dump_value(instr->operands[0], out);
+    fprintf(out, ", %%%s", instr->blocks[0]->name);
+    for (index = 1; index < instr->operand_count; index++) {
+      fprintf(out, " [");
+      ir_dump_value(instr->operands[index], out);
+      fprintf(out, ", %%%s]", instr->blocks[index]->name);
+    }
+    fprintf(out, "\n");
+    return;
+  }
+
+  for (index = 0; index < instr->operand_count; index++) {
+    fprintf(out, index > 0 ? ", " : " ");
+    if (instr->opcode == IR_OP_PHI) {
+      fprintf(out, "[");
+      ir_dump_value(instr->operands[index], out);
+      fprintf(out, ", %%%s]", instr->blocks[index]->name);
+    } else {
+      ir_dump_value(instr->operands[index], out);
+    }
+  }
+
+  if (instr->opcode != IR_OP_PHI) {
+    for (index = 0; index < instr->block_count; index++) {
+      fprintf(out, "%s%%%s", index > 0 || instr->operand_count > 0 ? ", " : " ",
+              instr->blocks[index]->name);
+    }
+  }
+
+  fprintf(out, "\n");
+}
+
+static void ir_dump_linkage(IrLinkage linkage, int dso_local,
+                            IrUnnamedAddr unnamed_addr, FILE *out) {
+  if (linkage == IR_LINKAGE_INTERNAL) {
+    fprintf(out, " internal");
+  }
+  if (dso_local) {
+    fprintf(out, " dso_local");
+  }
+  if (unnamed_addr == IR_UNNAMED_ADDR_GLOBAL) {
+    fprintf(out, " unnamed_addr");
+  } else if (unnamed_addr == IR_UNNAMED_ADDR_LOCAL) {
+    fprintf(out, " local_unnamed_addr");
+  }
+}
+
+/* What the functionattrs pass inferred, in LLVM's spelling. */
+void ir_dump_function_attrs(const IrFunction *function, FILE *out) {
+  static const char *const memory[] = {"", " readonly", " readnone"};
+
+  fprintf(out, "%s%s%s%s%s", function->nounwind ? " nounwind" : "",
+          function->willreturn ? " willreturn" : "",
+          function->norecurse ? " norecurse" : "", memory[function->memory],
+          function->argmemonly ? " argmemonly" : "");
+}
+
+void ir_dump_function(const IrFunction *function, FILE *out) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+
+  fprintf(out, "%s @%s(",
+          ir_function_is_declaration(function) ? "declare" : "function",
+          function->name);
+  for (index = 0; index < function->param_count; index++) {
+    const IrParam *param = function->params[index];
+
+    fprintf(out, "%s", index > 0 ? ", " : "");
+    if (param->name) {
+      fprintf(out, "%%%s: ", param->name);
+    }
+    ir_dump_type(param->value.type, out);
+    fprintf(out, "%s%s", param->nocapture ? " nocapture" : "",
+            param->readonly ? " readonly" : "");
+  }
+  fprintf(out, ") -> ");
+  ir_dump_type(function->return_type, out);
+  ir_dump_linkage(function->linkage, function->dso_local,
+                  function->unnamed_addr, out);
+  if (function->calling_conv == IR_CC_FAST) {
+    fprintf(out, " fastcc");
+  }
+  ir_dump_function_attrs(function, out);
+
+  if (ir_function_is_declaration(function)) {
+    fprintf(out, "\n");
+    return;
+  }
+
+  fprintf(out, " {\n");
+  for (block = function->first_block; block; block = block->next) {
+    fprintf(out, "%s:", block->name);
+    if (block->pred_count > 0) {
+      fprintf(out, " ; preds:");
+      for (index = 0; index < block->pred_count; index++) {
+        fprintf(out, " %%%s", block->preds[index]->name);
+      }
+    }
+    fprintf(out, "\n");
+
+    for (instr = block->first; instr; instr = instr->next) {
+      ir_dump_instr(instr, out);
+    }
+  }
+  fprintf(out, "}\n");
+}
+
+void ir_dump_module(const IrModule *module, FILE *out) {
+  size_t index = 0;
+  size_t field = 0;
+
+  fprintf(out, "module '%s'\n", module->name);
+
+  for (index = 0; index < module->struct_count; index++) {
+    const IrType *type = module->structs[index];
+
+    fprintf(out, "\nstruct %%%s {", type->name);
+    for (field = 0; field < type->field_count; field++) {
+      fprintf(out, "%s", field > 0 ? ", " : " ");
+      ir_dump_type(type->fields[field], out);
+    }
+    fprintf(out, " }\n");
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    const IrSymbol *symbol = &module->symbols[index];
+
+    fprintf(out, "\n");
+    if (symbol->kind == IR_SYMBOL_FUNCTION) {
+      ir_dump_function(symbol->function, out);
+      continue;
+    }
+
+    fprintf(out, "%s @%s: ",
+            symbol->global->is_constant ? "constant" : "global",
+            symbol->global->name);
+    ir_dump_type(symbol->global->value_type, out);
+    ir_dump_linkage(symbol->global->linkage, symbol->global->dso_local,
+                    symbol->global->unnamed_addr, out);
+    if (symbol->global->initializer) {
+      fprintf(out, " = ");
+      ir_dump_value(symbol->global->initializer, out);
+    }
+    fprintf(out, "\n");
+  }
+}
@@ -0,0 +1,164 @@
+#include "ir_alias.h"
+
+#include <stdlib.h>
+
+static int ir_alias_is_alloca(const IrValue *value) {
+  return value->kind == IR_VALUE_INSTR && value->instr->opcode == IR_OP_ALLOCA;
+}
+
+const IrValue *ir_alias_root(const IrValue *address) {
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    address = address->instr->operands[0];
+  }
+  return address;
+}
+
+int ir_alias_info_compute(const IrFunction *function, IrAliasInfo *info) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+
+  info->id_count = (size_t)function->next_value_id;
+  info->escaped = calloc(info->id_count + 1, 1);
+  if (!info->escaped) {
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *root = ir_alias_root(instr->operands[index]);
+
+        if (!ir_alias_is_alloca(root) ||
+            (instr->opcode == IR_OP_LOAD && index == 0) ||
+            (instr->opcode == IR_OP_STORE && index == 1) ||
+            (instr->opcode == IR_OP_GEP && index == 0) ||
+            (instr->opcode == IR_OP_MEMSET && index == 0) ||
+            (instr->opcode == IR_OP_MEMCPY && index < 2) ||
+            instr->opcode == IR_OP_BITCAST || instr->opcode == IR_OP_ICMP) {
+          continue;
+        }
+        info->escaped[root->instr->id] = 1;
+      }
+    }
+  }
+  return 1;
+}
+
+void ir_alias_info_free(IrAliasInfo *info) {
+  free(info->escaped);
+  info->escaped = NULL;
+  info->id_count = 0;
+}
+
+int ir_alias_is_private(const IrAliasInfo *info, const IrValue *root) {
+  return ir_alias_is_alloca(root) &&
+         (size_t)root->instr->id < info->id_count &&
+         !info->escaped[root->instr->id];
+}
+
+/*
+ * Strips bitcasts and GEPs whose indices are all constants off address,
+ * adding up the bytes the GEPs step over.
+ */
+static const IrValue *ir_alias_decompose(const IrValue *address,
+                                         long long *offset) {
+  *offset = 0;
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    const IrInstr *instr = address->instr;
+    const IrType *type = instr->aux_type;
+    long long bytes = 0;
+    size_t index = 0;
+
+    for (index = 1; index < instr->operand_count; index++) {
+      long long constant = 0;
+
+      if (!ir_value_is_const_int(instr->operands[index], &constant)) {
+        return address;
+      }
+      if (index > 1 && type->kind == IR_TYPE_STRUCT) {
+        bytes += (long long)ir_type_field_offset(type, (size_t)constant);
+        type = type->fields[constant];
+        continue;
+      }
+      if (index > 1) {
+        type = type->element;
+      }
+      bytes += constant * (long long)ir_type_size(type);
+    }
+    *offset += bytes;
+    address = instr->operands[0];
+  }
+  return address;
+}
+
+int ir_alias_may_alias(const IrAliasInfo *info, const IrValue *left,
+                       size_t left_size, const IrValue *right,
+                       size_t right_size) {
+  long long left_offset = 0;
+  long long right_offset = 0;
+  const IrValue *left_base = ir_alias_decompose(left, &left_offset);
+  const IrValue *right_base = ir_alias_decompose(right, &right_offset);
+  const IrValue *left_root = ir_alias_root(left_base);
+  const IrValue *right_root = ir_alias_root(right_base);
+  int left_object =
+    ir_alias_is_alloca(left_root) || left_root->kind == IR_VALUE_GLOBAL;
+  int right_object =
+    ir_alias_is_alloca(right_root) || right_root->kind == IR_VALUE_GLOBAL;
+
+  if (left_base == right_base) {
+    if (left_size == 0 || right_size == 0) {
+      return 1;
+    }
+    return left_offset < right_offset + (long long)right_size &&
+           right_offset < left_offset + (long long)left_size;
+  }
+  if (left_root == right_root) {
+    return 1;
+  }
+  if (left_object && right_object) {
+    return 0;
+  }
+  return !ir_alias_is_private(info, left_root) &&
+         !ir_alias_is_private(info, right_root);
+}
+
+int ir_alias_covers(const IrValue *cover, size_t cover_size,
+                    const IrValue *address, size_t size) {
+  long long cover_offset = 0;
+  long long offset = 0;
+
+  if (cover_size == 0 || size == 0 ||
+      ir_alias_decompose(cover, &cover_offset) !=
+        ir_alias_decompose(address, &offset)) {
+    return 0;
+  }
+  return cover_offset <= offset &&
+         offset + (long long)size <= cover_offset + (long long)cover_size;
+}
+
+int ir_alias_call_may_read(const IrAliasInfo *info, const IrInstr *call,
+                           const IrValue *address) {
+  return call->operands[0]->function->memory != IR_MEMORY_READNONE &&
+         !ir_alias_is_private(info, ir_alias_root(address));
+}
+
+int ir_alias_call_may_write(const IrAliasInfo *info, const IrInstr *call,
+                            const IrValue *address) {
+  return call->operands[0]->function->memory == IR_MEMORY_READWRITE &&
+         !ir_alias_is_private(info, ir_alias_root(address));
+}
+
+size_t ir_alias_access_size(const IrInstr *instr) {
+  if (instr->opcode == IR_OP_LOAD) {
+    return ir_type_size(instr->value.type);
+  }
+  if (instr->opcode == IR_OP_STORE) {
+    return ir_type_size(instr->operands[0]->type);
+  }
+  return 0;
+}
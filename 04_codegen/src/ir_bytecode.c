@@ -0,0 +1,1063 @@
+#include "ir_bytecode.h"
+#include "ir_pass.h"
+#include "ir_regalloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* A branch operand patched once its target block has an offset. */
+typedef struct IrBytecodeFixup {
+  size_t word;
+  const IrBlock *block;
+} IrBytecodeFixup;
+
+typedef struct IrBytecodeCompiler {
+  IrModule *module;
+  const IrBytecodeOptions *options;
+  IrVmProgram *program;
+  /* The IR behind each program function and global. */
+  const IrFunction **functions;
+  size_t native_capacity;
+  const IrGlobal **globals;
+  /* The function being compiled. */
+  IrFunction *source;
+  IrVmWord *code;
+  size_t code_size;
+  size_t code_capacity;
+  size_t *block_offsets;
+  IrBytecodeFixup *fixups;
+  size_t fixup_count;
+  size_t fixup_capacity;
+  IrVmConstant *constants;
+  size_t constant_count;
+  size_t constant_capacity;
+  /* Receives results nobody reads, such as those of void calls. */
+  size_t scratch;
+  /* First of the registers phis are staged in on multi-phi edges. */
+  size_t phi_temps;
+  size_t frame_size;
+  const char *error_message;
+} IrBytecodeCompiler;
+
+void ir_bytecode_options_init(IrBytecodeOptions *options) {
+  options->superinstructions = 1;
+}
+
+static int ir_bytecode_fail(IrBytecodeCompiler *compiler,
+                            const char *message) {
+  if (!compiler->error_message) {
+    compiler->error_message = message;
+  }
+  return 0;
+}
+
+static int ir_bytecode_grow(IrBytecodeCompiler *compiler, void **items,
+                            size_t *capacity, size_t count, size_t size) {
+  size_t grown = *capacity ? *capacity : 16;
+  void *data = NULL;
+
+  if (count < *capacity) {
+    return 1;
+  }
+
+  while (grown <= count) {
+    grown *= 2;
+  }
+  data = realloc(*items, grown * size);
+  if (!data) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+
+  *items = data;
+  *capacity = grown;
+  return 1;
+}
+
+static char *ir_bytecode_copy_name(const char *name) {
+  size_t length = strlen(name);
+  char *copy = malloc(length + 1);
+
+  if (copy) {
+    memcpy(copy, name, length + 1);
+  }
+  return copy;
+}
+
+static int ir_bytecode_type(const IrType *type, IrVmType *out) {
+  if (type->kind == IR_TYPE_VOID) {
+    *out = IR_VM_TYPE_VOID;
+  } else if (type->kind == IR_TYPE_POINTER) {
+    *out = IR_VM_TYPE_PTR;
+  } else if (type->kind != IR_TYPE_INT) {
+    return 0;
+  } else if (type->bits == 1) {
+    *out = IR_VM_TYPE_I1;
+  } else if (type->bits == 8) {
+    *out = IR_VM_TYPE_I8;
+  } else if (type->bits == 16) {
+    *out = IR_VM_TYPE_I16;
+  } else if (type->bits == 32) {
+    *out = IR_VM_TYPE_I32;
+  } else {
+    *out = IR_VM_TYPE_I64;
+  }
+  return 1;
+}
+
+/* Width of a register value; pointers take the whole word. */
+static int ir_bytecode_bits(const IrType *type) {
+  return type->kind == IR_TYPE_INT ? type->bits : 64;
+}
+
+static void ir_bytecode_emit(IrBytecodeCompiler *compiler, IrVmWord word) {
+  if (!ir_bytecode_grow(compiler, (void **)&compiler->code,
+                        &compiler->code_capacity, compiler->code_size,
+                        sizeof(*compiler->code))) {
+    return;
+  }
+  compiler->code[compiler->code_size++] = word;
+}
+
+static void ir_bytecode_emit2(IrBytecodeCompiler *compiler, IrVmOpcode opcode,
+                              IrVmWord a, IrVmWord b) {
+  ir_bytecode_emit(compiler, opcode);
+  ir_bytecode_emit(compiler, a);
+  ir_bytecode_emit(compiler, b);
+}
+
+static void ir_bytecode_emit3(IrBytecodeCompiler *compiler, IrVmOpcode opcode,
+                              IrVmWord a, IrVmWord b, IrVmWord c) {
+  ir_bytecode_emit2(compiler, opcode, a, b);
+  ir_bytecode_emit(compiler, c);
+}
+
+static void ir_bytecode_emit4(IrBytecodeCompiler *compiler, IrVmOpcode opcode,
+                              IrVmWord a, IrVmWord b, IrVmWord c, IrVmWord d) {
+  ir_bytecode_emit3(compiler, opcode, a, b, c);
+  ir_bytecode_emit(compiler, d);
+}
+
+/* Emits a branch operand for `block`, filled in once blocks are placed. */
+static void ir_bytecode_target(IrBytecodeCompiler *compiler,
+                               const IrBlock *block) {
+  if (ir_bytecode_grow(compiler, (void **)&compiler->fixups,
+                       &compiler->fixup_capacity, compiler->fixup_count,
+                       sizeof(*compiler->fixups))) {
+    compiler->fixups[compiler->fixup_count].word = compiler->code_size;
+    compiler->fixups[compiler->fixup_count].block = block;
+    compiler->fixup_count++;
+  }
+  ir_bytecode_emit(compiler, 0);
+}
+
+/* The native function of that name, added to the program on first use. */
+static size_t ir_bytecode_native(IrBytecodeCompiler *compiler,
+                                 const char *name, const IrType *return_type) {
+  IrVmProgram *program = compiler->program;
+  IrVmNative *native = NULL;
+  size_t index = 0;
+
+  for (index = 0; index < program->native_count; index++) {
+    if (strcmp(program->natives[index].name, name) == 0) {
+      return index;
+    }
+  }
+
+  if (!ir_bytecode_grow(compiler, (void **)&program->natives,
+                        &compiler->native_capacity, program->native_count,
+                        sizeof(*program->natives))) {
+    return 0;
+  }
+  native = &program->natives[index];
+  native->name = ir_bytecode_copy_name(name);
+  if (!native->name || !ir_bytecode_type(return_type, &native->return_type)) {
+    free(native->name);
+    ir_bytecode_fail(compiler, "bytecode: unsupported native function");
+    return 0;
+  }
+
+  program->native_count++;
+  return index;
+}
+
+static size_t ir_bytecode_constant(IrBytecodeCompiler *compiler,
+                                   IrVmConstantKind kind, long long value) {
+  size_t index = 0;
+
+  for (index = 0; index < compiler->constant_count; index++) {
+    if (compiler->constants[index].kind == kind &&
+        compiler->constants[index].value == value) {
+      return index;
+    }
+  }
+
+  if (!ir_bytecode_grow(compiler, (void **)&compiler->constants,
+                        &compiler->constant_capacity, compiler->constant_count,
+                        sizeof(*compiler->constants))) {
+    return 0;
+  }
+  compiler->constants[index].kind = kind;
+  compiler->constants[index].value = value;
+  compiler->constant_count++;
+  return index;
+}
+
+/*
+ * The register holding a value. Constant registers are numbered -1, -2,
+ * ... here and moved behind the value registers once the function is done.
+ */
+static IrVmWord ir_bytecode_reg(IrBytecodeCompiler *compiler,
+                                const IrValue *value) {
+  IrVmConstantKind kind = IR_VM_CONST_INT;
+  long long constant = 0;
+  size_t index = 0;
+
+  switch (value->kind) {
+  case IR_VALUE_PARAM:
+  case IR_VALUE_INSTR:
+    return (IrVmWord)ir_regalloc_slot(compiler->source, value);
+  case IR_VALUE_CONST_INT:
+    /* i1 constants are sign-extended in the IR; registers hold 0 or 1. */
+    constant = ir_type_is_int(value->type, 1) ? value->constant & 1
+                                              : value->constant;
+    break;
+  case IR_VALUE_NULL:
+  case IR_VALUE_ZERO:
+    break;
+  case IR_VALUE_AGGREGATE:
+    ir_bytecode_fail(compiler, "bytecode: aggregate operand");
+    return (IrVmWord)compiler->scratch;
+  case IR_VALUE_GLOBAL:
+    kind = IR_VM_CONST_GLOBAL;
+    for (index = 0; compiler->globals[index] != value->global; index++) {
+    }
+    constant = (long long)index;
+    break;
+  case IR_VALUE_FUNCTION:
+    if (!ir_function_is_declaration(value->function)) {
+      ir_bytecode_fail(compiler,
+                       "bytecode: bytecode functions have no native address");
+      return (IrVmWord)compiler->scratch;
+    }
+    kind = IR_VM_CONST_NATIVE;
+    constant = (long long)ir_bytecode_native(compiler, value->function->name,
+                                             value->function->return_type);
+    break;
+  }
+
+  return -1 - (IrVmWord)ir_bytecode_constant(compiler, kind, constant);
+}
+
+static IrVmWord ir_bytecode_result(IrBytecodeCompiler *compiler,
+                                   const IrInstr *instr) {
+  return ir_bytecode_reg(compiler, &instr->value);
+}
+
+static int ir_bytecode_has_phis(const IrBlock *block) {
+  return block->first && block->first->opcode == IR_OP_PHI;
+}
+
+static const IrValue *ir_bytecode_incoming(const IrInstr *phi,
+                                           const IrBlock *from) {
+  size_t index = 0;
+
+  for (index = 0; index < phi->block_count; index++) {
+    if (phi->blocks[index] == from) {
+      return phi->operands[index];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Moves the incoming values of `to`'s phis and jumps there, unless `to`
+ * is the block laid out next. Phis read their sources all at once, so
+ * with several of them the sources are staged in temporaries first.
+ */
+static void ir_bytecode_edge(IrBytecodeCompiler *compiler,
+                             const IrBlock *from, const IrBlock *to,
+                             const IrBlock *next) {
+  const IrInstr *phi = NULL;
+  size_t count = 0;
+  size_t index = 0;
+
+  for (phi = to->first; phi && phi->opcode == IR_OP_PHI; phi = phi->next) {
+    count++;
+  }
+
+  for (phi = to->first, index = 0; phi && phi->opcode == IR_OP_PHI;
+       phi = phi->next, index++) {
+    IrVmWord source =
+      ir_bytecode_reg(compiler, ir_bytecode_incoming(phi, from));
+
+    ir_bytecode_emit2(compiler, IR_VM_OP_MOV,
+                      count > 1 ? (IrVmWord)(compiler->phi_temps + index)
+                                : ir_bytecode_result(compiler, phi),
+                      source);
+  }
+  for (phi = to->first, index = 0;
+       count > 1 && phi && phi->opcode == IR_OP_PHI;
+       phi = phi->next, index++) {
+    ir_bytecode_emit2(compiler, IR_VM_OP_MOV, ir_bytecode_result(compiler, phi),
+                      (IrVmWord)(compiler->phi_temps + index));
+  }
+
+  if (to != next) {
+    ir_bytecode_emit(compiler, IR_VM_OP_JMP);
+    ir_bytecode_target(compiler, to);
+  }
+}
+
+/*
+ * An icmp feeding only the branch right after it is not emitted; the
+ * branch compares its operands itself (JEQ to JUGE).
+ */
+static int ir_bytecode_fuses_with_branch(const IrBytecodeCompiler *compiler,
+                                         const IrInstr *instr) {
+  return compiler->options->superinstructions &&
+         instr->opcode == IR_OP_ICMP && instr->value.use_count == 1 &&
+         instr->next && instr->next->opcode == IR_OP_CONDBR &&
+         instr->next->operands[0] == &instr->value;
+}
+
+/*
+ * Emits the opcode and operands of a jump taken when the condition of
+ * `instr` is `when`; the caller emits the target.
+ */
+static void ir_bytecode_jump_if(IrBytecodeCompiler *compiler,
+                                const IrInstr *instr, int when) {
+  /* Per predicate, the jump taken when it is false and when it is true. */
+  static const IrVmOpcode jumps[][2] = {
+    {IR_VM_OP_JNE, IR_VM_OP_JEQ},   {IR_VM_OP_JEQ, IR_VM_OP_JNE},
+    {IR_VM_OP_JSGE, IR_VM_OP_JSLT}, {IR_VM_OP_JSGT, IR_VM_OP_JSLE},
+    {IR_VM_OP_JSLE, IR_VM_OP_JSGT}, {IR_VM_OP_JSLT, IR_VM_OP_JSGE},
+    {IR_VM_OP_JUGE, IR_VM_OP_JULT}, {IR_VM_OP_JUGT, IR_VM_OP_JULE},
+    {IR_VM_OP_JULE, IR_VM_OP_JUGT}, {IR_VM_OP_JULT, IR_VM_OP_JUGE},
+  };
+  const IrValue *condition = instr->operands[0];
+  const IrInstr *compare = condition->kind == IR_VALUE_INSTR
+                             ? condition->instr
+                             : NULL;
+
+  if (compare && ir_bytecode_fuses_with_branch(compiler, compare)) {
+    ir_bytecode_emit2(compiler, jumps[compare->predicate][when],
+                      ir_bytecode_reg(compiler, compare->operands[0]),
+                      ir_bytecode_reg(compiler, compare->operands[1]));
+    return;
+  }
+
+  ir_bytecode_emit(compiler, when ? IR_VM_OP_JNZ : IR_VM_OP_JZ);
+  ir_bytecode_emit(compiler, ir_bytecode_reg(compiler, condition));
+}
+
+static void ir_bytecode_condbr(IrBytecodeCompiler *compiler,
+                               const IrInstr *instr, const IrBlock *next) {
+  const IrBlock *from = instr->parent;
+  const IrBlock *on_true = instr->blocks[0];
+  const IrBlock *on_false = instr->blocks[1];
+  size_t skip = 0;
+
+  if (!ir_bytecode_has_phis(on_true) && !ir_bytecode_has_phis(on_false) &&
+      on_true == next) {
+    ir_bytecode_jump_if(compiler, instr, 0);
+    ir_bytecode_target(compiler, on_false);
+  } else if (!ir_bytecode_has_phis(on_true)) {
+    ir_bytecode_jump_if(compiler, instr, 1);
+    ir_bytecode_target(compiler, on_true);
+    ir_bytecode_edge(compiler, from, on_false, next);
+  } else if (!ir_bytecode_has_phis(on_false)) {
+    ir_bytecode_jump_if(compiler, instr, 0);
+    ir_bytecode_target(compiler, on_false);
+    ir_bytecode_edge(compiler, from, on_true, next);
+  } else {
+    /* Both edges carry moves: the false one gets its own stub. */
+    ir_bytecode_jump_if(compiler, instr, 0);
+    ir_bytecode_emit(compiler, 0);
+    skip = compiler->code_size - 1;
+    ir_bytecode_edge(compiler, from, on_true, NULL);
+    if (compiler->code) {
+      compiler->code[skip] = (IrVmWord)compiler->code_size;
+    }
+    ir_bytecode_edge(compiler, from, on_false, next);
+  }
+}
+
+static void ir_bytecode_gep(IrBytecodeCompiler *compiler,
+                            const IrInstr *instr) {
+  IrVmWord result = ir_bytecode_result(compiler, instr);
+  IrVmWord address = ir_bytecode_reg(compiler, instr->operands[0]);
+  const IrType *type = instr->aux_type;
+  long long offset = 0;
+  size_t index = 0;
+
+  for (index = 1; index < instr->operand_count; index++) {
+    const IrValue *operand = instr->operands[index];
+    long long constant = 0;
+    size_t stride = 0;
+
+    if (index > 1 && type->kind == IR_TYPE_STRUCT) {
+      /* Struct field indices are always constants. */
+      ir_value_is_const_int(operand, &constant);
+      offset += (long long)ir_type_field_offset(type, (size_t)constant);
+      type = type->fields[constant];
+      continue;
+    }
+
+    if (index > 1) {
+      type = type->element;
+    }
+    stride = ir_type_size(type);
+
+    if (ir_value_is_const_int(operand, &constant)) {
+      offset += constant * (long long)stride;
+    } else {
+      ir_bytecode_emit4(compiler, IR_VM_OP_INDEX, result, address,
+                        ir_bytecode_reg(compiler, operand), (IrVmWord)stride);
+      address = result;
+    }
+  }
+
+  if (offset != 0) {
+    ir_bytecode_emit3(compiler, IR_VM_OP_OFFSET, result, address, offset);
+  } else if (address != result) {
+    ir_bytecode_emit2(compiler, IR_VM_OP_MOV, result, address);
+  }
+}
+
+static void ir_bytecode_binary(IrBytecodeCompiler *compiler,
+                               const IrInstr *instr) {
+  IrVmWord result = ir_bytecode_result(compiler, instr);
+  IrVmWord left = ir_bytecode_reg(compiler, instr->operands[0]);
+  IrVmWord right = ir_bytecode_reg(compiler, instr->operands[1]);
+  int bits = ir_bytecode_bits(instr->value.type);
+  /* i1 results are masked instead of sign-extended. */
+  IrVmWord shift = bits == 1 ? 0 : 64 - bits;
+  IrVmOpcode opcode = IR_VM_OP_ADD;
+
+  switch (instr->opcode) {
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+  case IR_OP_ASHR:
+    /* Canonical inputs give canonical results. */
+    opcode = instr->opcode == IR_OP_AND  ? IR_VM_OP_AND
+             : instr->opcode == IR_OP_OR ? IR_VM_OP_OR
+             : instr->opcode == IR_OP_XOR ? IR_VM_OP_XOR
+                                          : IR_VM_OP_ASHR;
+    ir_bytecode_emit3(compiler, opcode, result, left, right);
+    return;
+  case IR_OP_SUB:
+    opcode = IR_VM_OP_SUB;
+    break;
+  case IR_OP_MUL:
+    opcode = IR_VM_OP_MUL;
+    break;
+  case IR_OP_SDIV:
+    opcode = IR_VM_OP_SDIV;
+    break;
+  case IR_OP_SREM:
+    opcode = IR_VM_OP_SREM;
+    break;
+  case IR_OP_SHL:
+    opcode = IR_VM_OP_SHL;
+    break;
+  case IR_OP_LSHR:
+    opcode = IR_VM_OP_LSHR;
+    break;
+  default:
+    break;
+  }
+
+  ir_bytecode_emit4(compiler, opcode, result, left, right, shift);
+  if (bits == 1) {
+    ir_bytecode_emit3(compiler, IR_VM_OP_MASK, result, result, 1);
+  }
+}
+
+static void ir_bytecode_icmp(IrBytecodeCompiler *compiler,
+                             const IrInstr *instr) {
+  static const IrVmOpcode opcodes[] = {
+    IR_VM_OP_EQ,  IR_VM_OP_NE,  IR_VM_OP_SLT, IR_VM_OP_SLE, IR_VM_OP_SGT,
+    IR_VM_OP_SGE, IR_VM_OP_ULT, IR_VM_OP_ULE, IR_VM_OP_UGT, IR_VM_OP_UGE,
+  };
+
+  ir_bytecode_emit3(compiler, opcodes[instr->predicate],
+                    ir_bytecode_result(compiler, instr),
+                    ir_bytecode_reg(compiler, instr->operands[0]),
+                    ir_bytecode_reg(compiler, instr->operands[1]));
+}
+
+static void ir_bytecode_cast(IrBytecodeCompiler *compiler,
+                             const IrInstr *instr) {
+  IrVmWord result = ir_bytecode_result(compiler, instr);
+  IrVmWord source = ir_bytecode_reg(compiler, instr->operands[0]);
+  int from = ir_bytecode_bits(instr->operands[0]->type);
+  int to = ir_bytecode_bits(instr->value.type);
+  unsigned long long mask =
+    from == 64 ? ~0ULL : (1ULL << (unsigned)from) - 1;
+
+  switch (instr->opcode) {
+  case IR_OP_SEXT:
+    if (from == 1) {
+      ir_bytecode_emit2(compiler, IR_VM_OP_NEG, result, source);
+      return;
+    }
+    break;
+  case IR_OP_ZEXT:
+  case IR_OP_INTTOPTR:
+    if (from != 1 && from < 64) {
+      ir_bytecode_emit3(compiler, IR_VM_OP_MASK, result, source,
+                        (IrVmWord)mask);
+      return;
+    }
+    break;
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+    if (to == 1) {
+      ir_bytecode_emit3(compiler, IR_VM_OP_MASK, result, source, 1);
+      return;
+    }
+    if (to < from) {
+      ir_bytecode_emit3(compiler, IR_VM_OP_WRAP, result, source, 64 - to);
+      return;
+    }
+    break;
+  default:
+    break;
+  }
+
+  ir_bytecode_emit2(compiler, IR_VM_OP_MOV, result, source);
+}
+
+static void ir_bytecode_memory(IrBytecodeCompiler *compiler,
+                               const IrInstr *instr) {
+  const IrType *type = instr->opcode == IR_OP_LOAD ? instr->value.type
+                                                   : instr->operands[0]->type;
+  int bits = ir_bytecode_bits(type);
+  IrVmOpcode opcode = IR_VM_OP_LOAD64;
+
+  if (type->kind != IR_TYPE_INT && type->kind != IR_TYPE_POINTER) {
+    ir_bytecode_fail(compiler, "bytecode: aggregate loads and stores");
+    return;
+  }
+
+  if (instr->opcode == IR_OP_LOAD) {
+    opcode = bits == 1    ? IR_VM_OP_LOADU8
+             : bits == 8  ? IR_VM_OP_LOAD8
+             : bits == 16 ? IR_VM_OP_LOAD16
+             : bits == 32 ? IR_VM_OP_LOAD32
+                          : IR_VM_OP_LOAD64;
+    ir_bytecode_emit2(compiler, opcode, ir_bytecode_result(compiler, instr),
+                      ir_bytecode_reg(compiler, instr->operands[0]));
+    return;
+  }
+
+  opcode = bits <= 8    ? IR_VM_OP_STORE8
+           : bits == 16 ? IR_VM_OP_STORE16
+           : bits == 32 ? IR_VM_OP_STORE32
+                        : IR_VM_OP_STORE64;
+  ir_bytecode_emit2(compiler, opcode,
+                    ir_bytecode_reg(compiler, instr->operands[0]),
+                    ir_bytecode_reg(compiler, instr->operands[1]));
+}
+
+static void ir_bytecode_call(IrBytecodeCompiler *compiler,
+                             const IrInstr *instr) {
+  const IrFunction *callee = instr->operands[0]->function;
+  size_t arg_count = instr->operand_count - 1;
+  IrVmWord result = ir_instr_has_result(instr)
+                      ? ir_bytecode_result(compiler, instr)
+                      : (IrVmWord)compiler->scratch;
+  size_t index = 0;
+
+  if (ir_function_is_declaration(callee)) {
+    if (arg_count > IR_VM_NATIVE_ARGS) {
+      ir_bytecode_fail(compiler,
+                       "bytecode: too many arguments to a native function");
+      return;
+    }
+    ir_bytecode_emit3(
+      compiler, IR_VM_OP_CALL_NATIVE, result,
+      (IrVmWord)ir_bytecode_native(compiler, callee->name, callee->return_type),
+      (IrVmWord)arg_count);
+  } else {
+    for (index = 0; compiler->functions[index] != callee; index++) {
+    }
+    ir_bytecode_emit3(compiler, IR_VM_OP_CALL, result, (IrVmWord)index,
+                      (IrVmWord)arg_count);
+  }
+
+  for (index = 0; index < arg_count; index++) {
+    ir_bytecode_emit(compiler,
+                     ir_bytecode_reg(compiler, instr->operands[index + 1]));
+  }
+}
+
+/*
+ * memset and memcpy go to the C library's, whose result, the destination,
+ * nobody reads.
+ */
+static void ir_bytecode_memset(IrBytecodeCompiler *compiler,
+                               const IrInstr *instr) {
+  const char *name = instr->opcode == IR_OP_MEMSET ? "memset" : "memcpy";
+  size_t index = 0;
+
+  ir_bytecode_emit3(
+    compiler, IR_VM_OP_CALL_NATIVE, (IrVmWord)compiler->scratch,
+    (IrVmWord)ir_bytecode_native(compiler, name, instr->operands[0]->type),
+    (IrVmWord)instr->operand_count);
+  for (index = 0; index < instr->operand_count; index++) {
+    ir_bytecode_emit(compiler,
+                     ir_bytecode_reg(compiler, instr->operands[index]));
+  }
+}
+
+/*
+ * A load whose i32 value only feeds an add or sub stored straight back to
+ * the same address, as in `i = i + 1`, becomes one ADD_MEM32 or
+ * SUB_MEM32. Returns the store ending the run, or NULL.
+ */
+static const IrInstr *ir_bytecode_update(IrBytecodeCompiler *compiler,
+                                         const IrInstr *load) {
+  const IrInstr *op = load->next;
+  const IrInstr *store = op ? op->next : NULL;
+
+  if (!compiler->options->superinstructions ||
+      !ir_type_is_int(load->value.type, 32) || load->value.use_count != 1 ||
+      !store || (op->opcode != IR_OP_ADD && op->opcode != IR_OP_SUB) ||
+      op->operands[0] != &load->value || op->value.use_count != 1 ||
+      store->opcode != IR_OP_STORE || store->operands[0] != &op->value ||
+      store->operands[1] != load->operands[0]) {
+    return NULL;
+  }
+
+  ir_bytecode_emit2(compiler,
+                    op->opcode == IR_OP_ADD ? IR_VM_OP_ADD_MEM32
+                                            : IR_VM_OP_SUB_MEM32,
+                    ir_bytecode_reg(compiler, load->operands[0]),
+                    ir_bytecode_reg(compiler, op->operands[1]));
+  return store;
+}
+
+/*
+ * A gep that came out as a single INDEX and only feeds the i32 load or
+ * store right after it is rewritten into LOAD32_INDEX or STORE32_INDEX.
+ * Returns the access, or NULL.
+ */
+static const IrInstr *ir_bytecode_indexed_access(IrBytecodeCompiler *compiler,
+                                                 const IrInstr *gep,
+                                                 size_t start) {
+  const IrInstr *access = gep->next;
+  IrVmWord *code = compiler->code + start;
+
+  if (!compiler->options->superinstructions || !compiler->code ||
+      compiler->code_size != start + 5 || code[0] != IR_VM_OP_INDEX ||
+      gep->value.use_count != 1 || !access) {
+    return NULL;
+  }
+
+  if (access->opcode == IR_OP_LOAD && access->operands[0] == &gep->value &&
+      ir_type_is_int(access->value.type, 32)) {
+    code[0] = IR_VM_OP_LOAD32_INDEX;
+    code[1] = ir_bytecode_result(compiler, access);
+    return access;
+  }
+  if (access->opcode == IR_OP_STORE && access->operands[1] == &gep->value &&
+      ir_type_is_int(access->operands[0]->type, 32)) {
+    code[0] = IR_VM_OP_STORE32_INDEX;
+    code[1] = ir_bytecode_reg(compiler, access->operands[0]);
+    return access;
+  }
+  return NULL;
+}
+
+/* Emits `instr`, or a superinstruction for it and the ones after it. */
+static const IrInstr *ir_bytecode_instr(IrBytecodeCompiler *compiler,
+                                        const IrInstr *instr,
+                                        const IrBlock *next) {
+  const IrInstr *last = NULL;
+  const IrType *type = NULL;
+  size_t start = compiler->code_size;
+  size_t align = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_ALLOCA:
+    type = instr->aux_type;
+    align = ir_type_align(type);
+    compiler->frame_size = (compiler->frame_size + align - 1) & ~(align - 1);
+    ir_bytecode_emit2(compiler, IR_VM_OP_FRAME,
+                      ir_bytecode_result(compiler, instr),
+                      (IrVmWord)compiler->frame_size);
+    compiler->frame_size += ir_type_size(type);
+    break;
+  case IR_OP_LOAD:
+    if ((last = ir_bytecode_update(compiler, instr))) {
+      return last;
+    }
+    ir_bytecode_memory(compiler, instr);
+    break;
+  case IR_OP_STORE:
+    ir_bytecode_memory(compiler, instr);
+    break;
+  case IR_OP_GEP:
+    ir_bytecode_gep(compiler, instr);
+    if ((last = ir_bytecode_indexed_access(compiler, instr, start))) {
+      return last;
+    }
+    break;
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+    ir_bytecode_binary(compiler, instr);
+    break;
+  case IR_OP_ICMP:
+    if (!ir_bytecode_fuses_with_branch(compiler, instr)) {
+      ir_bytecode_icmp(compiler, instr);
+    }
+    break;
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+  case IR_OP_BITCAST:
+    ir_bytecode_cast(compiler, instr);
+    break;
+  case IR_OP_CALL:
+    ir_bytecode_call(compiler, instr);
+    break;
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    ir_bytecode_memset(compiler, instr);
+    break;
+  case IR_OP_PHI:
+    /* Filled in on the incoming edges. */
+    break;
+  case IR_OP_BR:
+    ir_bytecode_edge(compiler, instr->parent, instr->blocks[0], next);
+    break;
+  case IR_OP_CONDBR:
+    ir_bytecode_condbr(compiler, instr, next);
+    break;
+  case IR_OP_SWITCH:
+    /* Expanded into compares before the function is compiled. */
+    break;
+  case IR_OP_RET:
+    if (instr->operand_count) {
+      ir_bytecode_emit(compiler, IR_VM_OP_RET);
+      ir_bytecode_emit(compiler, ir_bytecode_reg(compiler, instr->operands[0]));
+    } else {
+      ir_bytecode_emit(compiler, IR_VM_OP_RET_VOID);
+    }
+    break;
+  }
+
+  return instr;
+}
+
+static const IrBlock *ir_bytecode_next_block(const IrBlock *block) {
+  for (block = block->next; block && !block->reachable; block = block->next) {
+  }
+  return block;
+}
+
+/* Moves constant registers, numbered -1, -2, ..., behind the others. */
+static void ir_bytecode_place_constants(IrBytecodeCompiler *compiler,
+                                        size_t base) {
+  size_t offset = 0;
+  size_t word = 0;
+
+  for (offset = 0; offset < compiler->code_size;
+       offset += ir_vm_instr_size(&compiler->code[offset])) {
+    const IrVmWord *code = &compiler->code[offset];
+    const char *letter = ir_vm_opcode_operands((IrVmOpcode)code[0]);
+
+    for (word = offset + 1; *letter; letter++, word++) {
+      if (*letter == 'a') {
+        size_t count = (size_t)compiler->code[word];
+        size_t index = 0;
+
+        for (index = 1; index <= count; index++) {
+          if (compiler->code[word + index] < 0) {
+            compiler->code[word + index] =
+              (IrVmWord)base - 1 - compiler->code[word + index];
+          }
+        }
+        word += count;
+      } else if (*letter == 'r' && compiler->code[word] < 0) {
+        compiler->code[word] = (IrVmWord)base - 1 - compiler->code[word];
+      }
+    }
+  }
+}
+
+static int ir_bytecode_function(IrBytecodeCompiler *compiler,
+                                IrFunction *source, IrVmFunction *target) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t max_phis = 0;
+  size_t lowered = 0;
+  size_t index = 0;
+
+  /* The VM has no indirect branch, so switches become compare trees. */
+  if (!ir_switch_lower_function(source, 0, &lowered) ||
+      !ir_function_build_cfg(source)) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+
+  compiler->source = source;
+  compiler->code = NULL;
+  compiler->code_size = 0;
+  compiler->code_capacity = 0;
+  compiler->fixup_count = 0;
+  compiler->constants = NULL;
+  compiler->constant_count = 0;
+  compiler->constant_capacity = 0;
+  compiler->frame_size = 0;
+  compiler->scratch = source->param_count + (size_t)source->next_value_id;
+  compiler->phi_temps = compiler->scratch + 1;
+
+  for (block = source->first_block; block; block = block->next) {
+    size_t count = 0;
+
+    for (instr = block->first; instr && instr->opcode == IR_OP_PHI;
+         instr = instr->next) {
+      count++;
+    }
+    max_phis = count > 1 && count > max_phis ? count : max_phis;
+  }
+
+  free(compiler->block_offsets);
+  compiler->block_offsets =
+    malloc((source->block_count + 1) * sizeof(*compiler->block_offsets));
+  if (!compiler->block_offsets) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+
+  for (block = source->first_block; block; block = block->next) {
+    if (!block->reachable) {
+      continue;
+    }
+    compiler->block_offsets[block->index] = compiler->code_size;
+    for (instr = block->first; instr; instr = instr->next) {
+      instr = ir_bytecode_instr(compiler, instr, ir_bytecode_next_block(block));
+    }
+  }
+
+  target->code = compiler->code;
+  target->code_size = compiler->code_size;
+  target->constants = compiler->constants;
+  target->constant_count = compiler->constant_count;
+  if (compiler->error_message) {
+    return 0;
+  }
+
+  for (index = 0; index < compiler->fixup_count; index++) {
+    compiler->code[compiler->fixups[index].word] =
+      (IrVmWord)compiler->block_offsets[compiler->fixups[index].block->index];
+  }
+
+  target->constant_base = compiler->phi_temps + max_phis;
+  target->register_count = target->constant_base + compiler->constant_count;
+  target->frame_size = (compiler->frame_size + 15) & ~(size_t)15;
+  ir_bytecode_place_constants(compiler, target->constant_base);
+  return 1;
+}
+
+/*
+ * Appends the nonzero parts of value, placed at offset in its global, to
+ * target's initializer pieces.
+ */
+static int ir_bytecode_global_init(IrBytecodeCompiler *compiler,
+                                   IrVmGlobal *target, const IrValue *value,
+                                   size_t offset) {
+  IrVmInit *init = NULL;
+  size_t index = 0;
+
+  if (ir_value_is_zero(value)) {
+    return 1;
+  }
+  if (value->kind == IR_VALUE_AGGREGATE) {
+    for (index = 0; index < value->element_count; index++) {
+      size_t field = value->type->kind == IR_TYPE_STRUCT
+                       ? ir_type_field_offset(value->type, index)
+                       : index * ir_type_size(value->type->element);
+
+      if (!ir_bytecode_global_init(compiler, target, value->elements[index],
+                                   offset + field)) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+
+  init = realloc(target->inits, (target->init_count + 1) * sizeof(*init));
+  if (!init) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+  target->inits = init;
+  init = &target->inits[target->init_count++];
+  init->offset = offset;
+  init->size = ir_type_size(value->type);
+  if (value->kind == IR_VALUE_GLOBAL) {
+    /* Globals referenced before their definition are placed later. */
+    init->kind = IR_VM_INIT_ADDRESS;
+    for (index = 0; index < compiler->module->symbol_count; index++) {
+      if (compiler->module->symbols[index].global == value->global) {
+        break;
+      }
+    }
+    init->value = (long long)index;
+  } else {
+    init->kind = IR_VM_INIT_INT;
+    init->value = value->constant;
+  }
+  return 1;
+}
+
+static int ir_bytecode_declare_global(IrBytecodeCompiler *compiler,
+                                      const IrGlobal *global) {
+  IrVmProgram *program = compiler->program;
+  IrVmGlobal *target = &program->globals[program->global_count];
+
+  memset(target, 0, sizeof(*target));
+  target->name = ir_bytecode_copy_name(global->name);
+  if (!target->name) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+  target->size = ir_type_size(global->value_type);
+  target->align = ir_type_align(global->value_type);
+  compiler->globals[program->global_count++] = global;
+  return ir_bytecode_global_init(compiler, target, global->initializer, 0);
+}
+
+static int ir_bytecode_declare_function(IrBytecodeCompiler *compiler,
+                                        const IrFunction *function) {
+  IrVmProgram *program = compiler->program;
+  IrVmFunction *target = &program->functions[program->function_count];
+  size_t index = 0;
+
+  memset(target, 0, sizeof(*target));
+  compiler->functions[program->function_count++] = function;
+  target->name = ir_bytecode_copy_name(function->name);
+  target->is_exported = function->linkage == IR_LINKAGE_EXTERNAL;
+  target->param_count = function->param_count;
+  target->params =
+    malloc((function->param_count + 1) * sizeof(*target->params));
+  if (!target->name || !target->params) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+
+  if (!ir_bytecode_type(function->return_type, &target->return_type)) {
+    return ir_bytecode_fail(compiler, "bytecode: unsupported return type");
+  }
+  for (index = 0; index < function->param_count; index++) {
+    if (!ir_bytecode_type(function->params[index]->value.type,
+                          &target->params[index])) {
+      return ir_bytecode_fail(compiler,
+                              "bytecode: unsupported parameter type");
+    }
+  }
+
+  return 1;
+}
+
+/* Maps symbol positions in IR_VM_INIT_ADDRESS values to global indices. */
+static void ir_bytecode_link_globals(IrBytecodeCompiler *compiler) {
+  IrVmProgram *program = compiler->program;
+  size_t index = 0;
+  size_t item = 0;
+  size_t target = 0;
+
+  for (index = 0; index < program->global_count; index++) {
+    IrVmGlobal *global = &program->globals[index];
+
+    for (item = 0; item < global->init_count; item++) {
+      IrVmInit *init = &global->inits[item];
+      const IrGlobal *referenced = NULL;
+
+      if (init->kind != IR_VM_INIT_ADDRESS) {
+        continue;
+      }
+      referenced = compiler->module->symbols[init->value].global;
+      for (target = 0; compiler->globals[target] != referenced; target++) {
+      }
+      init->value = (long long)target;
+    }
+  }
+}
+
+static int ir_bytecode_module(IrBytecodeCompiler *compiler) {
+  IrModule *module = compiler->module;
+  IrVmProgram *program = compiler->program;
+  size_t count = module->symbol_count + 1;
+  size_t index = 0;
+
+  compiler->functions = malloc(count * sizeof(*compiler->functions));
+  compiler->globals = malloc(count * sizeof(*compiler->globals));
+  program->functions = calloc(count, sizeof(*program->functions));
+  program->globals = calloc(count, sizeof(*program->globals));
+  if (!compiler->functions || !compiler->globals || !program->functions ||
+      !program->globals) {
+    return ir_bytecode_fail(compiler, "bytecode: out of memory");
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    const IrSymbol *symbol = &module->symbols[index];
+
+    if (symbol->kind == IR_SYMBOL_GLOBAL) {
+      if (!ir_bytecode_declare_global(compiler, symbol->global)) {
+        return 0;
+      }
+    } else if (!ir_function_is_declaration(symbol->function) &&
+               !ir_bytecode_declare_function(compiler, symbol->function)) {
+      return 0;
+    }
+  }
+  ir_bytecode_link_globals(compiler);
+
+  for (index = 0; index < program->function_count; index++) {
+    IrFunction *function = (IrFunction *)compiler->functions[index];
+
+    if (!ir_bytecode_function(compiler, function,
+                              &program->functions[index])) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+int ir_bytecode_compile(IrModule *module, const IrBytecodeOptions *options,
+                        IrVmProgram *program, const char **message) {
+  IrBytecodeCompiler compiler;
+  int result = 0;
+
+  memset(&compiler, 0, sizeof(compiler));
+  compiler.module = module;
+  compiler.options = options;
+  compiler.program = program;
+  ir_vm_program_init(program);
+
+  result = ir_bytecode_module(&compiler);
+  free(compiler.functions);
+  free(compiler.globals);
+  free(compiler.block_offsets);
+  free(compiler.fixups);
+
+  if (!result) {
+    ir_vm_program_free(program);
+    if (message) {
+      *message = compiler.error_message;
+    }
+  }
+  return result;
+}
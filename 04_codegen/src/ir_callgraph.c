@@ -0,0 +1,122 @@
+#include "ir_callgraph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+IrFunction *ir_call_graph_callee(const IrInstr *instr) {
+  if (instr->opcode != IR_OP_CALL ||
+      instr->operands[0]->kind != IR_VALUE_FUNCTION ||
+      ir_function_is_declaration(instr->operands[0]->function)) {
+    return NULL;
+  }
+
+  return instr->operands[0]->function;
+}
+
+size_t ir_call_graph_node(const IrCallGraph *graph,
+                          const IrFunction *function) {
+  size_t index = 0;
+
+  while (graph->functions[index] != function) {
+    index++;
+  }
+  return index;
+}
+
+static void ir_call_graph_visit(IrCallGraph *graph, size_t node) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+
+  graph->order[node] = ++graph->next_order;
+  graph->low[node] = graph->order[node];
+  graph->stack[graph->stack_count++] = node;
+  graph->on_stack[node] = 1;
+
+  for (block = graph->functions[node]->first_block; block;
+       block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      IrFunction *callee = ir_call_graph_callee(instr);
+      size_t target = 0;
+
+      if (!callee) {
+        continue;
+      }
+
+      target = ir_call_graph_node(graph, callee);
+      if (!graph->order[target]) {
+        ir_call_graph_visit(graph, target);
+        if (graph->low[target] < graph->low[node]) {
+          graph->low[node] = graph->low[target];
+        }
+      } else if (graph->on_stack[target] &&
+                 graph->order[target] < graph->low[node]) {
+        graph->low[node] = graph->order[target];
+      }
+    }
+  }
+
+  if (graph->low[node] != graph->order[node]) {
+    return;
+  }
+
+  for (;;) {
+    size_t member = graph->stack[--graph->stack_count];
+
+    graph->on_stack[member] = 0;
+    graph->component[member] = graph->component_count;
+    graph->postorder[graph->postorder_count++] = member;
+    if (member == node) {
+      break;
+    }
+  }
+  graph->component_count++;
+}
+
+void ir_call_graph_free(IrCallGraph *graph) {
+  free(graph->functions);
+  free(graph->order);
+  free(graph->low);
+  free(graph->stack);
+  free(graph->on_stack);
+  free(graph->component);
+  free(graph->postorder);
+}
+
+int ir_call_graph_build(IrCallGraph *graph, IrModule *module) {
+  size_t index = 0;
+  size_t count = 0;
+
+  memset(graph, 0, sizeof(*graph));
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    count += function && !ir_function_is_declaration(function);
+  }
+
+  graph->functions = malloc((count + 1) * sizeof(*graph->functions));
+  graph->order = calloc(count + 1, sizeof(*graph->order));
+  graph->low = calloc(count + 1, sizeof(*graph->low));
+  graph->stack = malloc((count + 1) * sizeof(*graph->stack));
+  graph->on_stack = calloc(count + 1, 1);
+  graph->component = calloc(count + 1, sizeof(*graph->component));
+  graph->postorder = malloc((count + 1) * sizeof(*graph->postorder));
+  if (!graph->functions || !graph->order || !graph->low || !graph->stack ||
+      !graph->on_stack || !graph->component || !graph->postorder) {
+    ir_call_graph_free(graph);
+    return 0;
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && !ir_function_is_declaration(function)) {
+      graph->functions[graph->count++] = function;
+    }
+  }
+  for (index = 0; index < graph->count; index++) {
+    if (!graph->order[index]) {
+      ir_call_graph_visit(graph, index);
+    }
+  }
+  return 1;
+}
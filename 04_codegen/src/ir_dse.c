@@ -0,0 +1,226 @@
+#include "ir_alias.h"
+#include "ir_pass.h"
+
+#include <stdlib.h>
+
+/* The address a store, memset, or memcpy writes. */
+static const IrValue *ir_dse_written(const IrInstr *instr) {
+  switch (instr->opcode) {
+  case IR_OP_STORE:
+    return instr->operands[1];
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    return instr->operands[0];
+  default:
+    return NULL;
+  }
+}
+
+/* Bytes a memset or memcpy touches, 0 when the length is not constant. */
+static size_t ir_dse_length(const IrInstr *instr) {
+  long long length = 0;
+
+  if (!ir_value_is_const_int(instr->operands[2], &length) || length <= 0) {
+    return 0;
+  }
+  return (size_t)length;
+}
+
+/* Whether instr may write any of the size bytes at address. */
+static int ir_dse_may_write(const IrAliasInfo *alias, const IrInstr *instr,
+                            const IrValue *address, size_t size) {
+  switch (instr->opcode) {
+  case IR_OP_STORE:
+    return ir_alias_may_alias(alias, instr->operands[1],
+                              ir_alias_access_size(instr), address, size);
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    return ir_alias_may_alias(alias, instr->operands[0], ir_dse_length(instr),
+                              address, size);
+  case IR_OP_CALL:
+    return ir_alias_call_may_write(alias, instr, address);
+  default:
+    return 0;
+  }
+}
+
+/* Whether instr may read any of the size bytes at address. */
+static int ir_dse_may_read(const IrAliasInfo *alias, const IrInstr *instr,
+                           const IrValue *address, size_t size) {
+  switch (instr->opcode) {
+  case IR_OP_LOAD:
+    return ir_alias_may_alias(alias, instr->operands[0],
+                              ir_alias_access_size(instr), address, size);
+  case IR_OP_MEMCPY:
+    return ir_alias_may_alias(alias, instr->operands[1], ir_dse_length(instr),
+                              address, size);
+  case IR_OP_CALL:
+    return ir_alias_call_may_read(alias, instr, address);
+  default:
+    return 0;
+  }
+}
+
+/*
+ * Whether store puts back the value a load in its own block read from the
+ * same address, with nothing in between that may have changed it.
+ */
+static int ir_dse_is_identity(const IrAliasInfo *alias, const IrInstr *store) {
+  const IrValue *value = store->operands[0];
+  const IrValue *address = store->operands[1];
+  const IrInstr *instr = NULL;
+
+  if (value->kind != IR_VALUE_INSTR || value->instr->opcode != IR_OP_LOAD ||
+      value->instr->parent != store->parent ||
+      value->instr->operands[0] != address) {
+    return 0;
+  }
+  for (instr = value->instr->next; instr != store; instr = instr->next) {
+    if (ir_dse_may_write(alias, instr, address,
+                         ir_alias_access_size(store))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Flags, by instruction id, the private allocas something reads: a load
+ * or the source of a memcpy based on them.
+ */
+static char *ir_dse_find_read(const IrFunction *function,
+                              const IrAliasInfo *alias) {
+  char *read = calloc(alias->id_count + 1, 1);
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+
+  if (!read) {
+    return NULL;
+  }
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      const IrValue *root = NULL;
+
+      if (instr->opcode == IR_OP_LOAD) {
+        root = ir_alias_root(instr->operands[0]);
+      } else if (instr->opcode == IR_OP_MEMCPY) {
+        root = ir_alias_root(instr->operands[1]);
+      }
+      if (root && ir_alias_is_private(alias, root)) {
+        read[root->instr->id] = 1;
+      }
+    }
+  }
+  return read;
+}
+
+/*
+ * Walks block backwards, keeping the stores seen so far that nothing
+ * after them reads. An earlier store whose bytes one of them covers is
+ * dead.
+ */
+static int ir_dse_block(const IrAliasInfo *alias, IrBlock *block,
+                        const IrInstr ***later, size_t *capacity,
+                        size_t *changes) {
+  size_t later_count = 0;
+  IrInstr *instr = NULL;
+  IrInstr *prev = NULL;
+  size_t index = 0;
+
+  for (instr = block->last; instr; instr = prev) {
+    prev = instr->prev;
+
+    if (instr->opcode == IR_OP_STORE) {
+      size_t size = ir_alias_access_size(instr);
+
+      for (index = 0; index < later_count; index++) {
+        if (ir_alias_covers((*later)[index]->operands[1],
+                            ir_alias_access_size((*later)[index]),
+                            instr->operands[1], size)) {
+          break;
+        }
+      }
+      if (index < later_count || ir_dse_is_identity(alias, instr)) {
+        ir_instr_remove(instr);
+        (*changes)++;
+        continue;
+      }
+
+      if (later_count == *capacity) {
+        size_t grown = *capacity ? *capacity * 2 : 16;
+        const IrInstr **stores = realloc(*later, grown * sizeof(*stores));
+
+        if (!stores) {
+          return 0;
+        }
+        *later = stores;
+        *capacity = grown;
+      }
+      (*later)[later_count++] = instr;
+      continue;
+    }
+
+    /* Drop the later stores whose bytes instr may read. */
+    index = 0;
+    while (index < later_count) {
+      const IrInstr *store = (*later)[index];
+
+      if (ir_dse_may_read(alias, instr, store->operands[1],
+                          ir_alias_access_size(store))) {
+        (*later)[index] = (*later)[--later_count];
+      } else {
+        index++;
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+ * Dead-store elimination: removes stores that a later store in the same
+ * block overwrites before anything may read them, stores of a value just
+ * loaded from the same address, and every store, memset, and memcpy into
+ * an alloca that is never read and whose address does not escape.
+ */
+int ir_dse_function(IrFunction *function, size_t *changes) {
+  IrAliasInfo alias;
+  const IrInstr **later = NULL;
+  size_t capacity = 0;
+  char *read = NULL;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  int ok = 1;
+
+  if (!ir_alias_info_compute(function, &alias)) {
+    return 0;
+  }
+  read = ir_dse_find_read(function, &alias);
+  if (!read) {
+    ir_alias_info_free(&alias);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = next) {
+      const IrValue *address = ir_dse_written(instr);
+      const IrValue *root = address ? ir_alias_root(address) : NULL;
+
+      next = instr->next;
+      if (root && ir_alias_is_private(&alias, root) &&
+          !read[root->instr->id]) {
+        ir_instr_remove(instr);
+        (*changes)++;
+      }
+    }
+  }
+
+  for (block = function->first_block; block && ok; block = block->next) {
+    ok = ir_dse_block(&alias, block, &later, &capacity, changes);
+  }
+
+  free(later);
+  free(read);
+  ir_alias_info_free(&alias);
+  return ok;
+}
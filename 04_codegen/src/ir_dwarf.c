@@ -0,0 +1,278 @@
+#include "ir_dwarf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IR_DWARF_VERSION 4
+
+#define IR_DWARF_TAG_COMPILE_UNIT 0x11
+#define IR_DWARF_AT_NAME 0x03
+#define IR_DWARF_AT_STMT_LIST 0x10
+#define IR_DWARF_AT_LOW_PC 0x11
+#define IR_DWARF_AT_HIGH_PC 0x12
+#define IR_DWARF_AT_LANGUAGE 0x13
+#define IR_DWARF_AT_COMP_DIR 0x1b
+#define IR_DWARF_AT_PRODUCER 0x25
+#define IR_DWARF_FORM_ADDR 0x01
+#define IR_DWARF_FORM_DATA2 0x05
+#define IR_DWARF_FORM_DATA4 0x06
+#define IR_DWARF_FORM_STRING 0x08
+#define IR_DWARF_FORM_SEC_OFFSET 0x17
+#define IR_DWARF_LANG_C99 0x0c
+
+#define IR_DWARF_LNS_ADVANCE_PC 0x02
+#define IR_DWARF_LNS_ADVANCE_LINE 0x03
+#define IR_DWARF_LNS_SET_COLUMN 0x05
+#define IR_DWARF_LNE_END_SEQUENCE 0x01
+#define IR_DWARF_LNE_SET_ADDRESS 0x02
+
+/* The line program's special opcodes, as most producers choose them. */
+#define IR_DWARF_LINE_BASE (-5)
+#define IR_DWARF_LINE_RANGE 14
+#define IR_DWARF_OPCODE_BASE 13
+
+/* Operand counts of the standard opcodes 1 to 12. */
+static const unsigned char ir_dwarf_opcode_lengths[] = {
+  0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1,
+};
+
+void ir_dwarf_lines_init(IrDwarfLines *lines) {
+  memset(lines, 0, sizeof(*lines));
+}
+
+void ir_dwarf_lines_free(IrDwarfLines *lines) {
+  free(lines->rows);
+  ir_dwarf_lines_init(lines);
+}
+
+void ir_dwarf_add_row(IrDwarfLines *lines, size_t address, IrDebugLoc loc) {
+  IrDwarfRow *row = NULL;
+
+  if (lines->row_count > 0 &&
+      lines->rows[lines->row_count - 1].address == address) {
+    lines->rows[lines->row_count - 1].loc = loc;
+    return;
+  }
+
+  if (lines->row_count == lines->row_capacity) {
+    size_t capacity = lines->row_capacity ? lines->row_capacity * 2 : 64;
+    IrDwarfRow *rows = realloc(lines->rows, capacity * sizeof(*rows));
+
+    if (!rows) {
+      lines->out_of_memory = 1;
+      return;
+    }
+    lines->rows = rows;
+    lines->row_capacity = capacity;
+  }
+
+  row = &lines->rows[lines->row_count++];
+  row->address = address;
+  row->loc = loc;
+}
+
+static void ir_dwarf_byte(IrElfWriter *object, IrElfSection section,
+                          unsigned value) {
+  unsigned char byte = (unsigned char)value;
+
+  ir_elf_append(object, section, &byte, 1);
+}
+
+/* A little-endian integer of `bytes` bytes. */
+static void ir_dwarf_int(IrElfWriter *object, IrElfSection section,
+                         unsigned long long value, size_t bytes) {
+  size_t index = 0;
+
+  for (index = 0; index < bytes; index++) {
+    ir_dwarf_byte(object, section, (unsigned)(value >> (8 * index)) & 0xff);
+  }
+}
+
+static void ir_dwarf_uleb(IrElfWriter *object, IrElfSection section,
+                          unsigned long long value) {
+  do {
+    unsigned byte = (unsigned)(value & 0x7f);
+
+    value >>= 7;
+    ir_dwarf_byte(object, section, value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void ir_dwarf_sleb(IrElfWriter *object, IrElfSection section,
+                          long long value) {
+  for (;;) {
+    unsigned byte = (unsigned)(value & 0x7f);
+    int done = 0;
+
+    /* Arithmetic shift: the sign bit of the last byte ends the number. */
+    value = value < 0 ? ~(~value >> 7) : value >> 7;
+    done = (value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40));
+    ir_dwarf_byte(object, section, done ? byte : byte | 0x80);
+    if (done) {
+      return;
+    }
+  }
+}
+
+static void ir_dwarf_string(IrElfWriter *object, IrElfSection section,
+                            const char *string) {
+  ir_elf_append(object, section, string, strlen(string) + 1);
+}
+
+/* Four zero bytes that the linker fills with the start of target. */
+static void ir_dwarf_section_offset(IrElfWriter *object, IrElfSection section,
+                                    IrElfSection target) {
+  ir_elf_relocate(object, section, ir_elf_section_size(object, section),
+                  ir_elf_section_symbol(object, target), IR_ELF_R_X86_64_32,
+                  0);
+  ir_dwarf_int(object, section, 0, 4);
+}
+
+static void ir_dwarf_abbrev(IrElfWriter *object) {
+  static const unsigned char attributes[] = {
+    IR_DWARF_AT_PRODUCER,  IR_DWARF_FORM_STRING,
+    IR_DWARF_AT_LANGUAGE,  IR_DWARF_FORM_DATA2,
+    IR_DWARF_AT_NAME,      IR_DWARF_FORM_STRING,
+    IR_DWARF_AT_COMP_DIR,  IR_DWARF_FORM_STRING,
+    IR_DWARF_AT_STMT_LIST, IR_DWARF_FORM_SEC_OFFSET,
+    IR_DWARF_AT_LOW_PC,    IR_DWARF_FORM_ADDR,
+    IR_DWARF_AT_HIGH_PC,   IR_DWARF_FORM_DATA4,
+  };
+
+  ir_dwarf_uleb(object, IR_ELF_DEBUG_ABBREV, 1);
+  ir_dwarf_uleb(object, IR_ELF_DEBUG_ABBREV, IR_DWARF_TAG_COMPILE_UNIT);
+  ir_dwarf_byte(object, IR_ELF_DEBUG_ABBREV, 0);
+  ir_elf_append(object, IR_ELF_DEBUG_ABBREV, attributes, sizeof(attributes));
+  /* Ends the attribute list, then the table. */
+  ir_dwarf_int(object, IR_ELF_DEBUG_ABBREV, 0, 3);
+}
+
+/* A compile unit without children, as ir_dwarf_abbrev describes it. */
+static void ir_dwarf_info(IrElfWriter *object, const IrModule *module,
+                          size_t text_size) {
+  IrElfSection info = IR_ELF_DEBUG_INFO;
+  size_t start = ir_elf_section_size(object, info);
+
+  ir_dwarf_int(object, info, 0, 4);
+  ir_dwarf_int(object, info, IR_DWARF_VERSION, 2);
+  ir_dwarf_section_offset(object, info, IR_ELF_DEBUG_ABBREV);
+  ir_dwarf_byte(object, info, 8);
+
+  ir_dwarf_uleb(object, info, 1);
+  ir_dwarf_string(object, info, "basecc");
+  ir_dwarf_int(object, info, IR_DWARF_LANG_C99, 2);
+  ir_dwarf_string(object, info, module->source_file);
+  ir_dwarf_string(object, info, module->source_directory);
+  ir_dwarf_section_offset(object, info, IR_ELF_DEBUG_LINE);
+  ir_elf_relocate(object, info, ir_elf_section_size(object, info),
+                  ir_elf_section_symbol(object, IR_ELF_TEXT),
+                  IR_ELF_R_X86_64_64, 0);
+  ir_dwarf_int(object, info, 0, 8);
+  ir_dwarf_int(object, info, text_size, 4);
+
+  ir_elf_patch32(object, info, start,
+                 (long long)(ir_elf_section_size(object, info) - start - 4));
+}
+
+/* Moves the state machine to row with one special opcode where it can. */
+static void ir_dwarf_advance(IrElfWriter *object, size_t address_delta,
+                             long long line_delta) {
+  IrElfSection line = IR_ELF_DEBUG_LINE;
+  unsigned long long opcode = 0;
+
+  if (line_delta < IR_DWARF_LINE_BASE ||
+      line_delta >= IR_DWARF_LINE_BASE + IR_DWARF_LINE_RANGE) {
+    ir_dwarf_byte(object, line, IR_DWARF_LNS_ADVANCE_LINE);
+    ir_dwarf_sleb(object, line, line_delta);
+    line_delta = 0;
+  }
+
+  opcode = (unsigned long long)(line_delta - IR_DWARF_LINE_BASE) +
+           IR_DWARF_LINE_RANGE * (unsigned long long)address_delta +
+           IR_DWARF_OPCODE_BASE;
+  if (opcode > 255) {
+    ir_dwarf_byte(object, line, IR_DWARF_LNS_ADVANCE_PC);
+    ir_dwarf_uleb(object, line, address_delta);
+    opcode = (unsigned long long)(line_delta - IR_DWARF_LINE_BASE) +
+             IR_DWARF_OPCODE_BASE;
+  }
+  ir_dwarf_byte(object, line, (unsigned)opcode);
+}
+
+static void ir_dwarf_line(IrElfWriter *object, const IrDwarfLines *lines,
+                          const IrModule *module, size_t text_size) {
+  IrElfSection line = IR_ELF_DEBUG_LINE;
+  size_t start = ir_elf_section_size(object, line);
+  size_t header = 0;
+  size_t address = 0;
+  unsigned current_line = 1;
+  unsigned column = 0;
+  size_t index = 0;
+
+  ir_dwarf_int(object, line, 0, 4);
+  ir_dwarf_int(object, line, IR_DWARF_VERSION, 2);
+  ir_dwarf_int(object, line, 0, 4);
+  header = ir_elf_section_size(object, line);
+  ir_dwarf_byte(object, line, 1);
+  ir_dwarf_byte(object, line, 1);
+  ir_dwarf_byte(object, line, 1);
+  ir_dwarf_byte(object, line, (unsigned char)IR_DWARF_LINE_BASE);
+  ir_dwarf_byte(object, line, IR_DWARF_LINE_RANGE);
+  ir_dwarf_byte(object, line, IR_DWARF_OPCODE_BASE);
+  ir_elf_append(object, line, ir_dwarf_opcode_lengths,
+                sizeof(ir_dwarf_opcode_lengths));
+  /* No include directories; file 1 is in the compilation directory. */
+  ir_dwarf_byte(object, line, 0);
+  ir_dwarf_string(object, line, module->source_file);
+  ir_dwarf_int(object, line, 0, 3);
+  ir_dwarf_byte(object, line, 0);
+  ir_elf_patch32(object, line, header - 4,
+                 (long long)(ir_elf_section_size(object, line) - header));
+
+  ir_dwarf_byte(object, line, 0);
+  ir_dwarf_uleb(object, line, 9);
+  ir_dwarf_byte(object, line, IR_DWARF_LNE_SET_ADDRESS);
+  ir_elf_relocate(object, line, ir_elf_section_size(object, line),
+                  ir_elf_section_symbol(object, IR_ELF_TEXT),
+                  IR_ELF_R_X86_64_64, 0);
+  ir_dwarf_int(object, line, 0, 8);
+
+  for (index = 0; index < lines->row_count; index++) {
+    const IrDwarfRow *row = &lines->rows[index];
+
+    if (row->loc.column != column) {
+      column = row->loc.column;
+      ir_dwarf_byte(object, line, IR_DWARF_LNS_SET_COLUMN);
+      ir_dwarf_uleb(object, line, column);
+    }
+    ir_dwarf_advance(object, row->address - address,
+                     (long long)row->loc.line - (long long)current_line);
+    address = row->address;
+    current_line = row->loc.line;
+  }
+
+  if (text_size > address) {
+    ir_dwarf_byte(object, line, IR_DWARF_LNS_ADVANCE_PC);
+    ir_dwarf_uleb(object, line, text_size - address);
+  }
+  ir_dwarf_byte(object, line, 0);
+  ir_dwarf_uleb(object, line, 1);
+  ir_dwarf_byte(object, line, IR_DWARF_LNE_END_SEQUENCE);
+
+  ir_elf_patch32(object, line, start,
+                 (long long)(ir_elf_section_size(object, line) - start - 4));
+}
+
+int ir_dwarf_write(const IrDwarfLines *lines, const IrModule *module,
+                   IrElfWriter *object) {
+  size_t text_size = ir_elf_section_size(object, IR_ELF_TEXT);
+
+  if (lines->out_of_memory) {
+    return 0;
+  }
+
+  ir_dwarf_abbrev(object);
+  ir_dwarf_info(object, module, text_size);
+  ir_dwarf_line(object, lines, module, text_size);
+  return !object->out_of_memory;
+}
@@ -0,0 +1,562 @@
+#include "ir_elf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IR_ELF_HEADER_SIZE 64
+#define IR_ELF_SECTION_HEADER_SIZE 64
+#define IR_ELF_SYMBOL_SIZE 24
+#define IR_ELF_RELA_SIZE 24
+
+#define IR_ELF_SHT_PROGBITS 1
+#define IR_ELF_SHT_SYMTAB 2
+#define IR_ELF_SHT_STRTAB 3
+#define IR_ELF_SHT_RELA 4
+#define IR_ELF_SHT_NOBITS 8
+
+#define IR_ELF_SHF_WRITE 0x1
+#define IR_ELF_SHF_ALLOC 0x2
+#define IR_ELF_SHF_EXECINSTR 0x4
+#define IR_ELF_SHF_INFO_LINK 0x40
+
+#define IR_ELF_SHN_ABS 0xfff1
+
+#define IR_ELF_STB_LOCAL 0
+#define IR_ELF_STB_GLOBAL 1
+#define IR_ELF_STT_NOTYPE 0
+#define IR_ELF_STT_OBJECT 1
+#define IR_ELF_STT_FUNC 2
+#define IR_ELF_STT_SECTION 3
+#define IR_ELF_STT_FILE 4
+
+static const char *const ir_elf_section_names[] = {
+  ".text",
+  ".data",
+  ".bss",
+  ".rodata",
+  ".debug_info",
+  ".debug_abbrev",
+  ".debug_line",
+};
+
+static const char *const ir_elf_rela_names[] = {
+  ".rela.text",
+  ".rela.data",
+  "",
+  ".rela.rodata",
+  ".rela.debug_info",
+  ".rela.debug_abbrev",
+  ".rela.debug_line",
+};
+
+static int ir_elf_is_debug(IrElfSection section) {
+  return section >= IR_ELF_DEBUG_INFO;
+}
+
+/* One entry of the section header table, before it is serialized. */
+typedef struct IrElfSectionHeader {
+  size_t name;
+  unsigned type;
+  unsigned long long flags;
+  size_t offset;
+  size_t size;
+  unsigned link;
+  unsigned info;
+  size_t align;
+  size_t entry_size;
+} IrElfSectionHeader;
+
+void ir_elf_init(IrElfWriter *writer, const char *file_name) {
+  size_t index = 0;
+
+  memset(writer, 0, sizeof(*writer));
+  writer->file_name = file_name;
+  for (index = 0; index < IR_ELF_SECTION_COUNT; index++) {
+    writer->alignments[index] = 1;
+  }
+}
+
+void ir_elf_free(IrElfWriter *writer) {
+  size_t index = 0;
+
+  for (index = 0; index < IR_ELF_SECTION_COUNT; index++) {
+    free(writer->sections[index].data);
+  }
+  free(writer->symbols);
+  free(writer->relocations);
+  ir_elf_init(writer, NULL);
+}
+
+static int ir_elf_reserve(IrElfWriter *writer, IrElfBuffer *buffer,
+                          size_t size) {
+  unsigned char *data = NULL;
+  size_t capacity = buffer->capacity ? buffer->capacity : 256;
+
+  if (buffer->size + size <= buffer->capacity) {
+    return 1;
+  }
+
+  while (capacity < buffer->size + size) {
+    capacity *= 2;
+  }
+
+  data = realloc(buffer->data, capacity);
+  if (!data) {
+    writer->out_of_memory = 1;
+    return 0;
+  }
+  buffer->data = data;
+  buffer->capacity = capacity;
+  return 1;
+}
+
+static void ir_elf_buffer_append(IrElfWriter *writer, IrElfBuffer *buffer,
+                                 const void *data, size_t size) {
+  if (!ir_elf_reserve(writer, buffer, size)) {
+    return;
+  }
+
+  if (data) {
+    memcpy(buffer->data + buffer->size, data, size);
+  } else {
+    memset(buffer->data + buffer->size, 0, size);
+  }
+  buffer->size += size;
+}
+
+/* Appends a little-endian integer of `bytes` bytes. */
+static void ir_elf_buffer_int(IrElfWriter *writer, IrElfBuffer *buffer,
+                              unsigned long long value, size_t bytes) {
+  unsigned char data[8];
+  size_t index = 0;
+
+  for (index = 0; index < bytes; index++) {
+    data[index] = (unsigned char)(value >> (8 * index));
+  }
+  ir_elf_buffer_append(writer, buffer, data, bytes);
+}
+
+size_t ir_elf_section_size(const IrElfWriter *writer, IrElfSection section) {
+  if (section == IR_ELF_BSS) {
+    return writer->bss_size;
+  }
+  return writer->sections[section].size;
+}
+
+void ir_elf_append(IrElfWriter *writer, IrElfSection section,
+                   const void *data, size_t size) {
+  if (section == IR_ELF_BSS) {
+    writer->bss_size += size;
+    return;
+  }
+  ir_elf_buffer_append(writer, &writer->sections[section], data, size);
+}
+
+void ir_elf_align(IrElfWriter *writer, IrElfSection section, size_t align,
+                  unsigned char fill) {
+  size_t size = ir_elf_section_size(writer, section);
+
+  if (align > writer->alignments[section]) {
+    writer->alignments[section] = align;
+  }
+
+  while (align > 1 && size % align != 0 && !writer->out_of_memory) {
+    ir_elf_append(writer, section, section == IR_ELF_TEXT ? &fill : NULL, 1);
+    size++;
+  }
+}
+
+void ir_elf_patch32(IrElfWriter *writer, IrElfSection section, size_t offset,
+                    long long value) {
+  IrElfBuffer *buffer = &writer->sections[section];
+  size_t index = 0;
+
+  if (offset + 4 > buffer->size) {
+    return;
+  }
+
+  for (index = 0; index < 4; index++) {
+    buffer->data[offset + index] =
+      (unsigned char)((unsigned long long)value >> (8 * index));
+  }
+}
+
+/* Appends an undefined symbol. */
+static size_t ir_elf_add_symbol(IrElfWriter *writer, const char *name) {
+  IrElfSymbol *symbol = NULL;
+
+  if (writer->symbol_count == writer->symbol_capacity) {
+    size_t capacity =
+      writer->symbol_capacity ? writer->symbol_capacity * 2 : 16;
+    IrElfSymbol *symbols =
+      realloc(writer->symbols, capacity * sizeof(*symbols));
+
+    if (!symbols) {
+      writer->out_of_memory = 1;
+      return 0;
+    }
+    writer->symbols = symbols;
+    writer->symbol_capacity = capacity;
+  }
+
+  symbol = &writer->symbols[writer->symbol_count];
+  memset(symbol, 0, sizeof(*symbol));
+  symbol->name = name;
+  symbol->section = IR_ELF_UNDEFINED;
+  return writer->symbol_count++;
+}
+
+size_t ir_elf_symbol(IrElfWriter *writer, const char *name) {
+  size_t index = 0;
+
+  for (index = 0; index < writer->symbol_count; index++) {
+    if (!writer->symbols[index].is_section &&
+        strcmp(writer->symbols[index].name, name) == 0) {
+      return index;
+    }
+  }
+
+  return ir_elf_add_symbol(writer, name);
+}
+
+size_t ir_elf_section_symbol(IrElfWriter *writer, IrElfSection section) {
+  size_t symbol = 0;
+
+  for (symbol = 0; symbol < writer->symbol_count; symbol++) {
+    if (writer->symbols[symbol].is_section &&
+        writer->symbols[symbol].section == section) {
+      return symbol;
+    }
+  }
+
+  symbol = ir_elf_add_symbol(writer, ir_elf_section_names[section]);
+  if (!writer->out_of_memory) {
+    writer->symbols[symbol].section = section;
+    writer->symbols[symbol].is_local = 1;
+    writer->symbols[symbol].is_section = 1;
+  }
+  return symbol;
+}
+
+void ir_elf_define(IrElfWriter *writer, size_t symbol, IrElfSection section,
+                   size_t value, size_t size, int is_function, int is_local) {
+  IrElfSymbol *entry = NULL;
+
+  if (symbol >= writer->symbol_count) {
+    return;
+  }
+
+  entry = &writer->symbols[symbol];
+  entry->section = section;
+  entry->value = value;
+  entry->size = size;
+  entry->is_function = is_function;
+  entry->is_local = is_local;
+}
+
+void ir_elf_relocate(IrElfWriter *writer, IrElfSection section,
+                     size_t offset, size_t symbol, unsigned type,
+                     long long addend) {
+  IrElfRelocation *relocation = NULL;
+
+  if (writer->relocation_count == writer->relocation_capacity) {
+    size_t capacity =
+      writer->relocation_capacity ? writer->relocation_capacity * 2 : 16;
+    IrElfRelocation *relocations =
+      realloc(writer->relocations, capacity * sizeof(*relocations));
+
+    if (!relocations) {
+      writer->out_of_memory = 1;
+      return;
+    }
+    writer->relocations = relocations;
+    writer->relocation_capacity = capacity;
+  }
+
+  relocation = &writer->relocations[writer->relocation_count++];
+  relocation->section = section;
+  relocation->offset = offset;
+  relocation->symbol = symbol;
+  relocation->type = type;
+  relocation->addend = addend;
+}
+
+static size_t ir_elf_string(IrElfWriter *writer, IrElfBuffer *table,
+                            const char *string) {
+  size_t offset = table->size;
+
+  ir_elf_buffer_append(writer, table, string, strlen(string) + 1);
+  return offset;
+}
+
+static void ir_elf_pad(IrElfWriter *writer, IrElfBuffer *file, size_t align) {
+  while (file->size % align != 0 && !writer->out_of_memory) {
+    ir_elf_buffer_append(writer, file, NULL, 1);
+  }
+}
+
+/* Appends a section's contents to the file image and records where. */
+static void ir_elf_place(IrElfWriter *writer, IrElfBuffer *file,
+                         IrElfSectionHeader *header,
+                         const IrElfBuffer *contents) {
+  ir_elf_pad(writer, file, header->align);
+  header->offset = file->size;
+  header->size = contents->size;
+  if (contents->size > 0) {
+    ir_elf_buffer_append(writer, file, contents->data, contents->size);
+  }
+}
+
+/*
+ * Lays out the file as: ELF header, section contents, and the section
+ * header table. Local symbols precede global ones in .symtab, as the
+ * format requires, so relocations go through a symbol index map.
+ */
+int ir_elf_write(IrElfWriter *writer, FILE *out) {
+  IrElfSectionHeader headers[24];
+  size_t section_headers[IR_ELF_SECTION_COUNT];
+  size_t rela_sections[IR_ELF_SECTION_COUNT];
+  size_t *symbol_map = NULL;
+  IrElfBuffer file = {NULL, 0, 0};
+  IrElfBuffer names = {NULL, 0, 0};
+  IrElfBuffer strings = {NULL, 0, 0};
+  IrElfBuffer symtab = {NULL, 0, 0};
+  IrElfBuffer rela = {NULL, 0, 0};
+  size_t header_count = 1;
+  size_t symtab_index = 0;
+  size_t first_global = 0;
+  size_t next_symbol = 0;
+  size_t section = 0;
+  size_t index = 0;
+  int pass = 0;
+  int result = 0;
+
+  memset(headers, 0, sizeof(headers));
+  ir_elf_buffer_append(writer, &names, "", 1);
+  ir_elf_buffer_append(writer, &strings, "", 1);
+  ir_elf_buffer_append(writer, &file, NULL, IR_ELF_HEADER_SIZE);
+
+  symbol_map = calloc(writer->symbol_count + 1, sizeof(*symbol_map));
+  if (!symbol_map) {
+    writer->out_of_memory = 1;
+    goto cleanup;
+  }
+
+  for (section = 0; section < IR_ELF_SECTION_COUNT; section++) {
+    IrElfSectionHeader *header = NULL;
+
+    section_headers[section] = 0;
+    if (ir_elf_is_debug((IrElfSection)section) &&
+        writer->sections[section].size == 0) {
+      continue;
+    }
+
+    section_headers[section] = header_count;
+    header = &headers[header_count++];
+    header->name = ir_elf_string(writer, &names, ir_elf_section_names[section]);
+    header->type =
+      section == IR_ELF_BSS ? IR_ELF_SHT_NOBITS : IR_ELF_SHT_PROGBITS;
+    header->flags = IR_ELF_SHF_ALLOC;
+    if (ir_elf_is_debug((IrElfSection)section)) {
+      header->flags = 0;
+    } else if (section == IR_ELF_TEXT) {
+      header->flags |= IR_ELF_SHF_EXECINSTR;
+    } else if (section != IR_ELF_RODATA) {
+      header->flags |= IR_ELF_SHF_WRITE;
+    }
+    header->align = writer->alignments[section];
+    if (section == IR_ELF_BSS) {
+      header->offset = file.size;
+      header->size = writer->bss_size;
+    } else {
+      ir_elf_place(writer, &file, header, &writer->sections[section]);
+    }
+  }
+
+  /* Entry 0 is the null symbol, then the file name. */
+  ir_elf_buffer_append(writer, &symtab, NULL, IR_ELF_SYMBOL_SIZE);
+  ir_elf_buffer_int(writer, &symtab,
+                    ir_elf_string(writer, &strings,
+                                  writer->file_name ? writer->file_name : ""),
+                    4);
+  ir_elf_buffer_int(writer, &symtab,
+                    IR_ELF_STB_LOCAL << 4 | IR_ELF_STT_FILE, 1);
+  ir_elf_buffer_int(writer, &symtab, 0, 1);
+  ir_elf_buffer_int(writer, &symtab, IR_ELF_SHN_ABS, 2);
+  ir_elf_buffer_int(writer, &symtab, 0, 8);
+  ir_elf_buffer_int(writer, &symtab, 0, 8);
+  next_symbol = 2;
+
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 1) {
+      first_global = next_symbol;
+    }
+
+    for (index = 0; index < writer->symbol_count; index++) {
+      const IrElfSymbol *symbol = &writer->symbols[index];
+      int is_local = symbol->is_local && symbol->section != IR_ELF_UNDEFINED;
+      unsigned type = symbol->section == IR_ELF_UNDEFINED ? IR_ELF_STT_NOTYPE
+                      : symbol->is_section                ? IR_ELF_STT_SECTION
+                      : symbol->is_function               ? IR_ELF_STT_FUNC
+                                                          : IR_ELF_STT_OBJECT;
+
+      if (is_local != (pass == 0)) {
+        continue;
+      }
+
+      symbol_map[index] = next_symbol++;
+      ir_elf_buffer_int(writer, &symtab,
+                        symbol->is_section
+                          ? 0
+                          : ir_elf_string(writer, &strings, symbol->name),
+                        4);
+      ir_elf_buffer_int(writer, &symtab,
+                        (is_local ? IR_ELF_STB_LOCAL : IR_ELF_STB_GLOBAL) << 4 |
+                          type,
+                        1);
+      ir_elf_buffer_int(writer, &symtab, 0, 1);
+      ir_elf_buffer_int(writer, &symtab,
+                        symbol->section == IR_ELF_UNDEFINED
+                          ? 0
+                          : section_headers[symbol->section],
+                        2);
+      ir_elf_buffer_int(writer, &symtab, symbol->value, 8);
+      ir_elf_buffer_int(writer, &symtab, symbol->size, 8);
+    }
+  }
+
+  /* .rela sections follow the sections they patch; only non-empty ones. */
+  symtab_index = header_count + 1;
+  for (section = 0; section < IR_ELF_SECTION_COUNT; section++) {
+    rela_sections[section] = 0;
+    for (index = 0; index < writer->relocation_count; index++) {
+      if (writer->relocations[index].section == (IrElfSection)section) {
+        rela_sections[section] = 1;
+        symtab_index++;
+        break;
+      }
+    }
+  }
+
+  for (section = 0; section < IR_ELF_SECTION_COUNT; section++) {
+    IrElfSectionHeader *header = NULL;
+
+    if (!rela_sections[section]) {
+      continue;
+    }
+
+    rela.size = 0;
+    for (index = 0; index < writer->relocation_count; index++) {
+      const IrElfRelocation *relocation = &writer->relocations[index];
+
+      if (relocation->section != (IrElfSection)section) {
+        continue;
+      }
+      ir_elf_buffer_int(writer, &rela, relocation->offset, 8);
+      ir_elf_buffer_int(writer, &rela,
+                        (unsigned long long)symbol_map[relocation->symbol]
+                            << 32 |
+                          relocation->type,
+                        8);
+      ir_elf_buffer_int(writer, &rela, (unsigned long long)relocation->addend,
+                        8);
+    }
+
+    header = &headers[header_count++];
+    header->name = ir_elf_string(writer, &names, ir_elf_rela_names[section]);
+    header->type = IR_ELF_SHT_RELA;
+    header->flags = IR_ELF_SHF_INFO_LINK;
+    header->align = 8;
+    header->entry_size = IR_ELF_RELA_SIZE;
+    header->link = (unsigned)symtab_index;
+    header->info = (unsigned)section_headers[section];
+    ir_elf_place(writer, &file, header, &rela);
+  }
+
+  /* An empty .note.GNU-stack asks for a non-executable stack. */
+  headers[header_count].name =
+    ir_elf_string(writer, &names, ".note.GNU-stack");
+  headers[header_count].type = IR_ELF_SHT_PROGBITS;
+  headers[header_count].align = 1;
+  headers[header_count].offset = file.size;
+  header_count++;
+
+  headers[header_count].name = ir_elf_string(writer, &names, ".symtab");
+  headers[header_count].type = IR_ELF_SHT_SYMTAB;
+  headers[header_count].align = 8;
+  headers[header_count].entry_size = IR_ELF_SYMBOL_SIZE;
+  headers[header_count].link = (unsigned)header_count + 1;
+  headers[header_count].info = (unsigned)first_global;
+  ir_elf_place(writer, &file, &headers[header_count++], &symtab);
+
+  headers[header_count].name = ir_elf_string(writer, &names, ".strtab");
+  headers[header_count].type = IR_ELF_SHT_STRTAB;
+  headers[header_count].align = 1;
+  ir_elf_place(writer, &file, &headers[header_count++], &strings);
+
+  headers[header_count].name = ir_elf_string(writer, &names, ".shstrtab");
+  headers[header_count].type = IR_ELF_SHT_STRTAB;
+  headers[header_count].align = 1;
+  ir_elf_place(writer, &file, &headers[header_count++], &names);
+
+  ir_elf_pad(writer, &file, 8);
+  if (writer->out_of_memory) {
+    goto cleanup;
+  }
+
+  /* Fill in the ELF header now that the layout is known. */
+  {
+    static const unsigned char ident[16] = {0x7f, 'E', 'L', 'F', 2, 1, 1};
+    size_t section_headers = file.size;
+
+    for (index = 0; index < header_count; index++) {
+      const IrElfSectionHeader *header = &headers[index];
+
+      ir_elf_buffer_int(writer, &file, header->name, 4);
+      ir_elf_buffer_int(writer, &file, header->type, 4);
+      ir_elf_buffer_int(writer, &file, header->flags, 8);
+      ir_elf_buffer_int(writer, &file, 0, 8);
+      ir_elf_buffer_int(writer, &file, header->offset, 8);
+      ir_elf_buffer_int(writer, &file, header->size, 8);
+      ir_elf_buffer_int(writer, &file, header->link, 4);
+      ir_elf_buffer_int(writer, &file, header->info, 4);
+      ir_elf_buffer_int(writer, &file, header->align, 8);
+      ir_elf_buffer_int(writer, &file, header->entry_size, 8);
+    }
+    if (writer->out_of_memory) {
+      goto cleanup;
+    }
+
+    /* The header is written in place over the reserved first 64 bytes. */
+    rela.size = 0;
+    ir_elf_buffer_append(writer, &rela, ident, sizeof(ident));
+    ir_elf_buffer_int(writer, &rela, 1, 2);  /* ET_REL */
+    ir_elf_buffer_int(writer, &rela, 62, 2); /* EM_X86_64 */
+    ir_elf_buffer_int(writer, &rela, 1, 4);
+    ir_elf_buffer_int(writer, &rela, 0, 8);
+    ir_elf_buffer_int(writer, &rela, 0, 8);
+    ir_elf_buffer_int(writer, &rela, section_headers, 8);
+    ir_elf_buffer_int(writer, &rela, 0, 4);
+    ir_elf_buffer_int(writer, &rela, IR_ELF_HEADER_SIZE, 2);
+    ir_elf_buffer_int(writer, &rela, 0, 2);
+    ir_elf_buffer_int(writer, &rela, 0, 2);
+    ir_elf_buffer_int(writer, &rela, IR_ELF_SECTION_HEADER_SIZE, 2);
+    ir_elf_buffer_int(writer, &rela, header_count, 2);
+    ir_elf_buffer_int(writer, &rela, header_count - 1, 2);
+    if (writer->out_of_memory) {
+      goto cleanup;
+    }
+    memcpy(file.data, rela.data, IR_ELF_HEADER_SIZE);
+  }
+
+  result = fwrite(file.data, 1, file.size, out) == file.size;
+
+cleanup:
+  free(symbol_map);
+  free(file.data);
+  free(names.data);
+  free(strings.data);
+  free(symtab.data);
+  free(rela.data);
+  return result && !writer->out_of_memory;
+}
@@ -0,0 +1,320 @@
+#include "ir_callgraph.h"
+#include "ir_pass.h"
+
+#include <stdlib.h>
+
+/* Memory one component of the call graph touches outside its own frames. */
+typedef struct IrAttrsEffects {
+  int reads;
+  int writes;
+  /* Some of it is not reached through a pointer parameter. */
+  int other;
+} IrAttrsEffects;
+
+/* The alloca, global, parameter, or other pointer an address is based on. */
+static const IrValue *ir_attrs_root(const IrValue *address) {
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    address = address->instr->operands[0];
+  }
+  return address;
+}
+
+static int ir_attrs_is_local(const IrValue *root) {
+  return root->kind == IR_VALUE_INSTR && root->instr->opcode == IR_OP_ALLOCA;
+}
+
+static int ir_attrs_is_pointer(const IrValue *value) {
+  return value->type && value->type->kind == IR_TYPE_POINTER;
+}
+
+/* Records a read or write of address; the function's own allocas are free. */
+static void ir_attrs_access(IrAttrsEffects *effects, const IrValue *address,
+                            int writes) {
+  const IrValue *root = ir_attrs_root(address);
+
+  if (ir_attrs_is_local(root)) {
+    return;
+  }
+  effects->reads |= !writes;
+  effects->writes |= writes;
+  effects->other |= root->kind != IR_VALUE_PARAM;
+}
+
+/*
+ * What a call adds. A callee in the same component is being inferred with
+ * the caller, so only the pointers it is handed matter; any other defined
+ * callee is done, and a declaration may do anything.
+ */
+static void ir_attrs_call(IrAttrsEffects *effects, const IrInstr *call,
+                          const IrCallGraph *graph, size_t component) {
+  IrFunction *callee = ir_call_graph_callee(call);
+  int same = callee && graph->component[ir_call_graph_node(graph, callee)] ==
+                         component;
+  size_t index = 0;
+
+  if (!callee) {
+    effects->reads = effects->writes = effects->other = 1;
+    return;
+  }
+  if (!same && callee->memory == IR_MEMORY_READNONE) {
+    return;
+  }
+
+  for (index = 1; index < call->operand_count; index++) {
+    const IrValue *root = ir_attrs_root(call->operands[index]);
+
+    if (!ir_attrs_is_pointer(call->operands[index]) ||
+        ir_attrs_is_local(root)) {
+      continue;
+    }
+    if (!same) {
+      effects->reads = 1;
+      effects->writes |= callee->memory == IR_MEMORY_READWRITE;
+    }
+    effects->other |= root->kind != IR_VALUE_PARAM;
+  }
+
+  if (!same && !callee->argmemonly) {
+    effects->reads = 1;
+    effects->writes |= callee->memory == IR_MEMORY_READWRITE;
+    effects->other = 1;
+  }
+}
+
+/*
+ * Clears the nocapture and readonly flags of param that a use of a pointer
+ * based on it, as operand index of instr, rules out. Calls rely on what is
+ * known of the callee's parameters so far.
+ */
+static void ir_attrs_param_use(IrParam *param, const IrInstr *instr,
+                               size_t index) {
+  const IrParam *target = NULL;
+
+  switch (instr->opcode) {
+  case IR_OP_GEP:
+  case IR_OP_BITCAST:
+    /* Its own uses are checked as uses of param. */
+    if (index == 0) {
+      return;
+    }
+    break;
+  case IR_OP_LOAD:
+  case IR_OP_ICMP:
+    return;
+  case IR_OP_STORE:
+    if (index == 1) {
+      param->readonly = 0;
+      return;
+    }
+    break;
+  case IR_OP_MEMSET:
+    param->readonly = 0;
+    return;
+  case IR_OP_MEMCPY:
+    param->readonly &= index != 0;
+    return;
+  case IR_OP_CALL:
+    if (!ir_call_graph_callee(instr)) {
+      break;
+    }
+    target = instr->operands[0]->function->params[index - 1];
+    param->nocapture &= target->nocapture;
+    param->readonly &= target->readonly;
+    return;
+  default:
+    break;
+  }
+
+  param->nocapture = 0;
+  param->readonly = 0;
+}
+
+/*
+ * Clears nocapture and readonly from the function's pointer parameters
+ * that a use rules out. Returns whether any flag changed.
+ */
+static int ir_attrs_check_params(IrFunction *function) {
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t index = 0;
+  int changed = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *root = ir_attrs_root(instr->operands[index]);
+        IrParam *param = NULL;
+        int nocapture = 0;
+        int readonly = 0;
+
+        if (root->kind != IR_VALUE_PARAM) {
+          continue;
+        }
+
+        param = root->param;
+        nocapture = param->nocapture;
+        readonly = param->readonly;
+        ir_attrs_param_use(param, instr, index);
+        changed |= nocapture != param->nocapture;
+        changed |= readonly != param->readonly;
+      }
+    }
+  }
+  return changed;
+}
+
+/* Whether any block of the function sits in a loop. */
+static int ir_attrs_has_loop(IrFunction *function, int *has_loop) {
+  const IrBlock *block = NULL;
+
+  if (!ir_function_build_cfg(function) ||
+      !ir_function_compute_loop_depth(function)) {
+    return 0;
+  }
+
+  *has_loop = 0;
+  for (block = function->first_block; block; block = block->next) {
+    *has_loop |= block->reachable && block->loop_depth > 0;
+  }
+  return 1;
+}
+
+/* Infers every attribute for the functions of one component at once. */
+static int ir_attrs_component(const IrCallGraph *graph, const size_t *members,
+                              size_t member_count, size_t *changes) {
+  size_t component = graph->component[members[0]];
+  IrAttrsEffects effects = {0, 0, 0};
+  int terminates = 1;
+  int recursive = member_count > 1;
+  size_t member = 0;
+  size_t index = 0;
+
+  for (member = 0; member < member_count; member++) {
+    IrFunction *function = graph->functions[members[member]];
+    IrBlock *block = NULL;
+    IrInstr *instr = NULL;
+    int has_loop = 0;
+
+    if (!ir_attrs_has_loop(function, &has_loop)) {
+      return 0;
+    }
+    terminates &= !has_loop;
+
+    for (index = 0; index < function->param_count; index++) {
+      IrParam *param = function->params[index];
+
+      param->nocapture = ir_attrs_is_pointer(&param->value);
+      param->readonly = param->nocapture;
+    }
+
+    for (block = function->first_block; block; block = block->next) {
+      for (instr = block->first; instr; instr = instr->next) {
+        IrFunction *callee = ir_call_graph_callee(instr);
+
+        switch (instr->opcode) {
+        case IR_OP_LOAD:
+          ir_attrs_access(&effects, instr->operands[0], 0);
+          break;
+        case IR_OP_STORE:
+          ir_attrs_access(&effects, instr->operands[1], 1);
+          break;
+        case IR_OP_MEMSET:
+          ir_attrs_access(&effects, instr->operands[0], 1);
+          break;
+        case IR_OP_MEMCPY:
+          ir_attrs_access(&effects, instr->operands[0], 1);
+          ir_attrs_access(&effects, instr->operands[1], 0);
+          break;
+        case IR_OP_CALL:
+          ir_attrs_call(&effects, instr, graph, component);
+          if (!callee) {
+            /* A declaration may call back in, or never return. */
+            recursive = 1;
+            terminates = 0;
+          } else if (graph->component[ir_call_graph_node(graph, callee)] ==
+                     component) {
+            recursive = 1;
+          } else {
+            recursive |= !callee->norecurse;
+            terminates &= callee->willreturn;
+          }
+          break;
+        default:
+          break;
+        }
+      }
+    }
+  }
+
+  /* Parameters start out optimistic and lose flags until none changes. */
+  for (;;) {
+    int changed = 0;
+
+    for (member = 0; member < member_count; member++) {
+      changed |= ir_attrs_check_params(graph->functions[members[member]]);
+    }
+    if (!changed) {
+      break;
+    }
+  }
+
+  for (member = 0; member < member_count; member++) {
+    IrFunction *function = graph->functions[members[member]];
+
+    /* C has no exceptions, so nothing BaseCC compiles unwinds. */
+    function->nounwind = 1;
+    function->norecurse = !recursive;
+    function->willreturn = terminates && !recursive;
+    function->memory = effects.writes  ? IR_MEMORY_READWRITE
+                       : effects.reads ? IR_MEMORY_READONLY
+                                       : IR_MEMORY_READNONE;
+    function->argmemonly =
+      (effects.reads || effects.writes) && !effects.other;
+
+    *changes += 1 + (size_t)function->norecurse +
+                (size_t)function->willreturn +
+                (size_t)(function->memory != IR_MEMORY_READWRITE) +
+                (size_t)function->argmemonly;
+    for (index = 0; index < function->param_count; index++) {
+      *changes += (size_t)function->params[index]->nocapture +
+                  (size_t)function->params[index]->readonly;
+    }
+  }
+  return 1;
+}
+
+/*
+ * The functionattrs pass: visits the call graph's components callees
+ * first and infers, for each defined function, nounwind, norecurse,
+ * willreturn, what memory it reads or writes, and which pointer
+ * parameters it neither captures nor writes through.
+ */
+int ir_function_attrs_module(IrModule *module, const IrPassOptions *options,
+                             size_t *changes) {
+  IrCallGraph graph;
+  size_t start = 0;
+  size_t end = 0;
+  int result = 1;
+
+  (void)options;
+  if (!ir_call_graph_build(&graph, module)) {
+    return 0;
+  }
+
+  /* A component's members are adjacent in postorder. */
+  for (start = 0; start < graph.postorder_count && result; start = end) {
+    size_t component = graph.component[graph.postorder[start]];
+
+    for (end = start; end < graph.postorder_count &&
+                      graph.component[graph.postorder[end]] == component;
+         end++) {
+    }
+    result = ir_attrs_component(&graph, &graph.postorder[start], end - start,
+                                changes);
+  }
+
+  ir_call_graph_free(&graph);
+  return result;
+}
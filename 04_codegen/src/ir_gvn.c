@@ -0,0 +1,523 @@
+#include "ir_alias.h"
+#include "ir_pass.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* What a load of address reads, as long as nothing writes it first. */
+typedef struct IrGvnFact {
+  const IrValue *address;
+  IrValue *value;
+} IrGvnFact;
+
+/*
+ * The state of one run over a function. Blocks are numbered by
+ * ir_function_build_cfg, values by instruction id. The leaders are the
+ * expressions available at the point the walk has reached, innermost
+ * last, hashed into buckets that chain through chain[].
+ */
+typedef struct IrGvn {
+  IrFunction *function;
+  IrAliasInfo alias;
+  /* Dominator tree children, children_of[b] into children. */
+  IrBlock **children;
+  size_t *children_of;
+  size_t id_count;
+  /* By instruction id: the value a redundant instruction was folded into. */
+  IrValue **replacement;
+  /* By instruction id: see ir_gvn_address. */
+  const IrValue **same_address;
+  IrInstr **leaders;
+  /* Per leader, the one before it in its bucket, plus one; 0 ends it. */
+  size_t *chain;
+  size_t leader_count;
+  size_t *buckets;
+  size_t bucket_mask;
+  IrGvnFact *facts;
+  size_t fact_count;
+  size_t fact_capacity;
+} IrGvn;
+
+static void ir_gvn_free(IrGvn *state) {
+  ir_alias_info_free(&state->alias);
+  free(state->children);
+  free(state->children_of);
+  free(state->replacement);
+  free(state->same_address);
+  free(state->leaders);
+  free(state->chain);
+  free(state->buckets);
+  free(state->facts);
+}
+
+static int ir_gvn_build_tree(IrGvn *state) {
+  IrFunction *function = state->function;
+  size_t count = function->block_count;
+  size_t *fill = NULL;
+  IrBlock *block = NULL;
+  size_t index = 0;
+
+  state->children = malloc((count + 1) * sizeof(*state->children));
+  state->children_of = calloc(count + 1, sizeof(*state->children_of));
+  fill = calloc(count + 1, sizeof(*fill));
+  if (!state->children || !state->children_of || !fill) {
+    free(fill);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    if (block->reachable && block->idom) {
+      state->children_of[block->idom->index + 1]++;
+    }
+  }
+  for (index = 0; index < count; index++) {
+    state->children_of[index + 1] += state->children_of[index];
+  }
+  for (block = function->first_block; block; block = block->next) {
+    if (block->reachable && block->idom) {
+      size_t parent = block->idom->index;
+
+      state->children[state->children_of[parent] + fill[parent]++] = block;
+    }
+  }
+  free(fill);
+  return 1;
+}
+
+/* Instructions whose result depends on nothing but their operands. */
+static int ir_gvn_is_pure(const IrInstr *instr) {
+  switch (instr->opcode) {
+  case IR_OP_GEP:
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+  case IR_OP_ICMP:
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+  case IR_OP_BITCAST:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/*
+ * An icmp feeding only the branch right after it. The backends fuse the
+ * two into one compare and jump, which beats keeping an earlier i1 alive
+ * until the branch, so it is neither folded nor made a leader.
+ */
+static int ir_gvn_feeds_branch(const IrInstr *instr) {
+  return instr->opcode == IR_OP_ICMP && instr->value.use_count == 1 &&
+         instr->next && instr->next->opcode == IR_OP_CONDBR &&
+         instr->next->operands[0] == &instr->value;
+}
+
+/*
+ * Whether instr may be folded into leader. An address is cheap to compute
+ * again, and the backends fold it into the access, while one kept alive
+ * from another block, often across calls, ties up a register; so a GEP
+ * is only reused within its own block.
+ */
+static int ir_gvn_may_reuse(const IrInstr *leader, const IrInstr *instr) {
+  return instr->opcode != IR_OP_GEP || leader->parent == instr->parent;
+}
+
+static int ir_gvn_is_commutative(const IrInstr *instr) {
+  return instr->opcode == IR_OP_ADD || instr->opcode == IR_OP_MUL ||
+         instr->opcode == IR_OP_AND || instr->opcode == IR_OP_OR ||
+         instr->opcode == IR_OP_XOR;
+}
+
+/*
+ * The value address is known by: itself, or for a GEP left alone by
+ * ir_gvn_may_reuse, the dominating one computing the same. Expressions
+ * and facts are matched by it.
+ */
+static const IrValue *ir_gvn_address(const IrGvn *state,
+                                     const IrValue *address) {
+  if (address->kind == IR_VALUE_INSTR && address->instr->id >= 0 &&
+      (size_t)address->instr->id < state->id_count &&
+      state->same_address[address->instr->id]) {
+    return state->same_address[address->instr->id];
+  }
+  return address;
+}
+
+/* Constants are not shared, so equal ones compare by type and value. */
+static int ir_gvn_same_value(const IrGvn *state, const IrValue *left,
+                             const IrValue *right) {
+  left = ir_gvn_address(state, left);
+  right = ir_gvn_address(state, right);
+  if (left == right) {
+    return 1;
+  }
+  if (left->kind != right->kind || left->type != right->type) {
+    return 0;
+  }
+  return (left->kind == IR_VALUE_CONST_INT &&
+          left->constant == right->constant) ||
+         left->kind == IR_VALUE_NULL;
+}
+
+static size_t ir_gvn_hash_value(const IrValue *value) {
+  if (value->kind == IR_VALUE_CONST_INT) {
+    return (size_t)value->constant * 31u + (size_t)value->type;
+  }
+  if (value->kind == IR_VALUE_NULL) {
+    return (size_t)value->type;
+  }
+  return (size_t)value;
+}
+
+static size_t ir_gvn_hash(const IrGvn *state, const IrInstr *instr) {
+  size_t hash = (size_t)instr->opcode * 0x9e3779b9u;
+  size_t operands = 0;
+  size_t index = 0;
+
+  hash ^= (size_t)instr->flags << 8 ^ (size_t)instr->aux_type ^
+          (size_t)instr->value.type;
+  if (instr->opcode == IR_OP_ICMP) {
+    hash += (size_t)instr->predicate * 131u;
+  }
+  for (index = 0; index < instr->operand_count; index++) {
+    size_t operand =
+      ir_gvn_hash_value(ir_gvn_address(state, instr->operands[index]));
+
+    /* A sum does not care about the order of commutative operands. */
+    operands = ir_gvn_is_commutative(instr) ? operands + operand
+                                            : operands * 31u + operand;
+  }
+  hash ^= operands + (hash << 6) + (hash >> 2);
+  return hash ^ hash >> 17;
+}
+
+static int ir_gvn_same_operands(const IrGvn *state, const IrInstr *left,
+                                const IrInstr *right) {
+  size_t index = 0;
+
+  for (index = 0; index < left->operand_count; index++) {
+    if (!ir_gvn_same_value(state, left->operands[index],
+                           right->operands[index])) {
+      break;
+    }
+  }
+  if (index == left->operand_count) {
+    return 1;
+  }
+  return ir_gvn_is_commutative(left) && left->operand_count == 2 &&
+         ir_gvn_same_value(state, left->operands[0], right->operands[1]) &&
+         ir_gvn_same_value(state, left->operands[1], right->operands[0]);
+}
+
+static int ir_gvn_same_expression(const IrGvn *state, const IrInstr *left,
+                                   const IrInstr *right) {
+  return left->opcode == right->opcode && left->flags == right->flags &&
+         (left->opcode != IR_OP_ICMP || left->predicate == right->predicate) &&
+         left->aux_type == right->aux_type &&
+         left->value.type == right->value.type &&
+         left->operand_count == right->operand_count &&
+         ir_gvn_same_operands(state, left, right);
+}
+
+/* An available instruction computing what instr does, or NULL. */
+static IrInstr *ir_gvn_find_leader(const IrGvn *state, const IrInstr *instr) {
+  size_t link = state->buckets[ir_gvn_hash(state, instr) & state->bucket_mask];
+
+  while (link) {
+    IrInstr *leader = state->leaders[link - 1];
+
+    if (ir_gvn_same_expression(state, leader, instr)) {
+      return leader;
+    }
+    link = state->chain[link - 1];
+  }
+  return NULL;
+}
+
+static void ir_gvn_add_leader(IrGvn *state, IrInstr *instr) {
+  size_t bucket = ir_gvn_hash(state, instr) & state->bucket_mask;
+
+  state->leaders[state->leader_count] = instr;
+  state->chain[state->leader_count] = state->buckets[bucket];
+  state->buckets[bucket] = ++state->leader_count;
+}
+
+/* Forgets the leaders added since there were count of them. */
+static void ir_gvn_pop_leaders(IrGvn *state, size_t count) {
+  while (state->leader_count > count) {
+    size_t top = --state->leader_count;
+    size_t bucket =
+      ir_gvn_hash(state, state->leaders[top]) & state->bucket_mask;
+
+    state->buckets[bucket] = state->chain[top];
+  }
+}
+
+static IrValue *ir_gvn_find_fact(const IrGvn *state, const IrInstr *load) {
+  const IrValue *address = ir_gvn_address(state, load->operands[0]);
+  size_t index = 0;
+
+  for (index = 0; index < state->fact_count; index++) {
+    const IrGvnFact *fact = &state->facts[index];
+
+    if (fact->address == address &&
+        fact->value->type == load->value.type) {
+      return fact->value;
+    }
+  }
+  return NULL;
+}
+
+static int ir_gvn_add_fact(IrGvn *state, const IrValue *address,
+                           IrValue *value) {
+  if (state->fact_count == state->fact_capacity) {
+    size_t capacity = state->fact_capacity ? state->fact_capacity * 2 : 16;
+    IrGvnFact *facts = realloc(state->facts, capacity * sizeof(*facts));
+
+    if (!facts) {
+      return 0;
+    }
+    state->facts = facts;
+    state->fact_capacity = capacity;
+  }
+  state->facts[state->fact_count].address = address;
+  state->facts[state->fact_count].value = value;
+  state->fact_count++;
+  return 1;
+}
+
+/*
+ * Forgets the facts that a write of size bytes at address may change, or
+ * that call may change when it is not NULL.
+ */
+static void ir_gvn_clobber(IrGvn *state, const IrValue *address, size_t size,
+                           const IrInstr *call) {
+  size_t index = 0;
+
+  while (index < state->fact_count) {
+    const IrGvnFact *fact = &state->facts[index];
+    int clobbered =
+      call ? ir_alias_call_may_write(&state->alias, call, fact->address)
+           : ir_alias_may_alias(&state->alias, fact->address,
+                                ir_type_size(fact->value->type), address,
+                                size);
+
+    if (clobbered) {
+      state->facts[index] = state->facts[--state->fact_count];
+    } else {
+      index++;
+    }
+  }
+}
+
+static IrValue *ir_gvn_resolve(const IrGvn *state, IrValue *value) {
+  while (value->kind == IR_VALUE_INSTR && value->instr->id >= 0 &&
+         (size_t)value->instr->id < state->id_count &&
+         state->replacement[value->instr->id]) {
+    value = state->replacement[value->instr->id];
+  }
+  return value;
+}
+
+static void ir_gvn_resolve_operands(const IrGvn *state, IrInstr *instr) {
+  size_t index = 0;
+
+  for (index = 0; index < instr->operand_count; index++) {
+    IrValue *operand = ir_gvn_resolve(state, instr->operands[index]);
+
+    if (operand != instr->operands[index]) {
+      ir_instr_set_operand(instr, index, operand);
+    }
+  }
+}
+
+/* Folds instr into value: later uses are rewritten to it. */
+static void ir_gvn_replace(IrGvn *state, IrInstr *instr, IrValue *value,
+                           size_t *changes) {
+  state->replacement[instr->id] = value;
+  ir_instr_remove(instr);
+  (*changes)++;
+}
+
+/* Numbers the instructions of block, tracking what memory holds. */
+static int ir_gvn_block(IrGvn *state, IrBlock *block, size_t *changes) {
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  IrValue *value = NULL;
+  long long length = 0;
+
+  for (instr = block->first; instr; instr = next) {
+    next = instr->next;
+    if (instr->opcode == IR_OP_PHI) {
+      continue;
+    }
+    ir_gvn_resolve_operands(state, instr);
+
+    if (ir_gvn_feeds_branch(instr)) {
+      continue;
+    }
+    if (ir_gvn_is_pure(instr)) {
+      IrInstr *leader = ir_gvn_find_leader(state, instr);
+
+      if (leader && ir_gvn_may_reuse(leader, instr)) {
+        ir_gvn_replace(state, instr, &leader->value, changes);
+        continue;
+      }
+      if (leader) {
+        state->same_address[instr->id] = ir_gvn_address(state, &leader->value);
+      }
+      ir_gvn_add_leader(state, instr);
+      continue;
+    }
+
+    switch (instr->opcode) {
+    case IR_OP_LOAD:
+      value = ir_gvn_find_fact(state, instr);
+      if (value) {
+        ir_gvn_replace(state, instr, value, changes);
+      } else if (!ir_gvn_add_fact(state,
+                                  ir_gvn_address(state, instr->operands[0]),
+                                  &instr->value)) {
+        return 0;
+      }
+      break;
+    case IR_OP_STORE:
+      ir_gvn_clobber(state, instr->operands[1], ir_alias_access_size(instr),
+                     NULL);
+      if (!ir_gvn_add_fact(state, ir_gvn_address(state, instr->operands[1]),
+                           instr->operands[0])) {
+        return 0;
+      }
+      break;
+    case IR_OP_MEMSET:
+    case IR_OP_MEMCPY:
+      length = 0;
+      ir_value_is_const_int(instr->operands[2], &length);
+      ir_gvn_clobber(state, instr->operands[0],
+                     length > 0 ? (size_t)length : 0, NULL);
+      break;
+    case IR_OP_CALL:
+      ir_gvn_clobber(state, NULL, 0, instr);
+      break;
+    default:
+      break;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Walks the dominator tree from block. The leaders of a block stay
+ * available in everything it dominates; what memory holds carries over
+ * only into a block entered from its dominator alone, since a block with
+ * other predecessors may be reached after any number of writes.
+ */
+static int ir_gvn_walk(IrGvn *state, IrBlock *block, size_t *changes) {
+  size_t leader_count = state->leader_count;
+  IrGvnFact *saved = NULL;
+  size_t saved_count = 0;
+  size_t index = 0;
+  int ok = 1;
+
+  if (block->pred_count != 1 || block->preds[0] != block->idom) {
+    state->fact_count = 0;
+  }
+  if (!ir_gvn_block(state, block, changes)) {
+    return 0;
+  }
+
+  saved_count = state->fact_count;
+  if (saved_count > 0) {
+    saved = malloc(saved_count * sizeof(*saved));
+    if (!saved) {
+      return 0;
+    }
+    memcpy(saved, state->facts, saved_count * sizeof(*saved));
+  }
+
+  for (index = state->children_of[block->index];
+       index < state->children_of[block->index + 1] && ok; index++) {
+    if (saved_count > 0) {
+      memcpy(state->facts, saved, saved_count * sizeof(*saved));
+    }
+    state->fact_count = saved_count;
+    ok = ir_gvn_walk(state, state->children[index], changes);
+  }
+
+  free(saved);
+  ir_gvn_pop_leaders(state, leader_count);
+  return ok;
+}
+
+/*
+ * Global value numbering over the dominator tree: an instruction that
+ * computes what a dominating one already did, with the same operands up
+ * to the order of commutative ones, is replaced by it. Loads are folded
+ * into the value an earlier load or store of the same address left there
+ * when no write in between may alias it.
+ */
+int ir_gvn_function(IrFunction *function, size_t *changes) {
+  IrGvn state;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t instr_count = 0;
+  size_t bucket_count = 16;
+  int ok = 0;
+
+  memset(&state, 0, sizeof(state));
+  state.function = function;
+  if (!function->first_block) {
+    return 1;
+  }
+  if (!ir_function_compute_dominators(function) ||
+      !ir_alias_info_compute(function, &state.alias)) {
+    ir_gvn_free(&state);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      instr_count++;
+    }
+  }
+  while (bucket_count < instr_count * 2) {
+    bucket_count *= 2;
+  }
+
+  state.id_count = (size_t)function->next_value_id;
+  state.replacement = calloc(state.id_count + 1, sizeof(*state.replacement));
+  state.same_address =
+    calloc(state.id_count + 1, sizeof(*state.same_address));
+  state.leaders = malloc((instr_count + 1) * sizeof(*state.leaders));
+  state.chain = malloc((instr_count + 1) * sizeof(*state.chain));
+  state.buckets = calloc(bucket_count, sizeof(*state.buckets));
+  state.bucket_mask = bucket_count - 1;
+  if (!state.replacement || !state.same_address || !state.leaders ||
+      !state.chain || !state.buckets || !ir_gvn_build_tree(&state) ||
+      !ir_gvn_walk(&state, function->first_block, changes)) {
+    goto cleanup;
+  }
+
+  /* Phis, and blocks the walk never reached, still use folded values. */
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      ir_gvn_resolve_operands(&state, instr);
+    }
+  }
+  ok = 1;
+
+cleanup:
+  ir_gvn_free(&state);
+  return ok;
+}
@@ -0,0 +1,364 @@
+#include "ir_callgraph.h"
+#include "ir_pass.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A caller stops taking inlined code once it costs this much. */
+#define IR_INLINE_MAX_CALLER_COST (IR_INLINE_INSTR_COST * 4000)
+
+/* A call site considered for inlining and the loop depth it sits at. */
+typedef struct IrInlineSite {
+  IrInstr *call;
+  size_t loop_depth;
+} IrInlineSite;
+
+static long ir_inline_instr_cost(const IrInstr *instr) {
+  switch (instr->opcode) {
+  /* A frame slot, and casts that change no bits. */
+  case IR_OP_ALLOCA:
+  case IR_OP_BITCAST:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+    return 0;
+  /* The call and a move per argument. */
+  case IR_OP_CALL:
+    return IR_INLINE_INSTR_COST * (long)instr->operand_count;
+  default:
+    return IR_INLINE_INSTR_COST;
+  }
+}
+
+/* The function's size in cost units; *returns counts its ret. */
+static long ir_inline_function_cost(const IrFunction *function,
+                                    size_t *returns) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  long cost = 0;
+
+  *returns = 0;
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      cost += ir_inline_instr_cost(instr);
+      *returns += instr->opcode == IR_OP_RET;
+    }
+  }
+  return cost;
+}
+
+/*
+ * What the loops in a callee add to its cost: each instruction in a loop
+ * counts IR_INLINE_LOOP_WEIGHT times more per level of nesting. Inlining
+ * saves the call once, while the loop's copy runs many times in a caller
+ * that must now find registers for it as well.
+ */
+static int ir_inline_loop_cost(IrFunction *function, long *cost) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+
+  *cost = 0;
+  if (!ir_function_build_cfg(function) ||
+      !ir_function_compute_loop_depth(function)) {
+    return 0;
+  }
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      *cost += ir_inline_instr_cost(instr) * IR_INLINE_LOOP_WEIGHT *
+               (long)block->loop_depth;
+    }
+  }
+  return 1;
+}
+
+/* One more than the largest .i<n> suffix among the function's blocks. */
+static unsigned long ir_inline_next_suffix(const IrFunction *function) {
+  const IrBlock *block = NULL;
+  unsigned long next = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    const char *dot = strrchr(block->name, '.');
+    char *end = NULL;
+    unsigned long suffix = 0;
+
+    if (!dot || dot[1] != 'i' || !isdigit((unsigned char)dot[2])) {
+      continue;
+    }
+    suffix = strtoul(dot + 2, &end, 10);
+    if (!*end && suffix >= next) {
+      next = suffix + 1;
+    }
+  }
+  return next;
+}
+
+/* What a callee value stands for in the inlined copy. */
+static IrValue *ir_inline_map(IrValue *value, const IrInstr *call,
+                              IrValue **values) {
+  const IrFunction *callee = call->operands[0]->function;
+
+  if (value->kind == IR_VALUE_PARAM &&
+      callee->params[value->param->index] == value->param) {
+    return call->operands[1 + value->param->index];
+  }
+  if (value->kind == IR_VALUE_INSTR &&
+      value->instr->parent->parent == callee) {
+    return values[value->instr->id];
+  }
+  return value;
+}
+
+/*
+ * Replaces the call with a copy of the callee's blocks between the two
+ * halves of its block. Returns become branches to the second half, which
+ * picks the result with a phi when there is more than one. The copies'
+ * allocas move to the caller's entry so a loop does not grow the stack.
+ */
+static int ir_inline_call(IrInstr *call) {
+  IrBlock *block = call->parent;
+  IrFunction *caller = block->parent;
+  IrFunction *callee = call->operands[0]->function;
+  unsigned long suffix = ir_inline_next_suffix(caller);
+  size_t name_size = strlen(callee->name) + 64;
+  IrBlock **blocks = NULL;
+  IrValue **values = NULL;
+  IrValue **returned = NULL;
+  IrBlock **return_blocks = NULL;
+  size_t return_count = 0;
+  char *name = NULL;
+  IrBlock *source = NULL;
+  IrBlock *after = block;
+  IrBlock *tail = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  IrInstr *anchor = NULL;
+  IrBuilder builder;
+  size_t index = 0;
+  int result = 0;
+
+  if (!ir_function_build_cfg(callee)) {
+    return 0;
+  }
+  for (source = callee->first_block; source; source = source->next) {
+    if (strlen(source->name) + 64 > name_size - strlen(callee->name)) {
+      name_size = strlen(callee->name) + strlen(source->name) + 64;
+    }
+  }
+
+  blocks = calloc(callee->block_count + 1, sizeof(*blocks));
+  values = calloc((size_t)callee->next_value_id + 1, sizeof(*values));
+  returned = calloc(callee->block_count + 1, sizeof(*returned));
+  return_blocks = calloc(callee->block_count + 1, sizeof(*return_blocks));
+  name = malloc(name_size);
+  if (!blocks || !values || !returned || !return_blocks || !name) {
+    goto done;
+  }
+
+  snprintf(name, name_size, "%s.return.i%lu", callee->name, suffix);
+  tail = ir_block_split(call->next, name);
+  if (!tail) {
+    goto done;
+  }
+
+  ir_builder_init(&builder, caller);
+  /*
+   * Debug locations are scoped to the function they are in, so the copies
+   * are all placed at the call.
+   */
+  builder.loc = call->loc;
+  for (source = callee->first_block; source; source = source->next) {
+    snprintf(name, name_size, "%s.%s.i%lu", callee->name, source->name,
+             suffix);
+    blocks[source->index] = ir_block_create(caller, name);
+    if (!blocks[source->index]) {
+      goto done;
+    }
+    ir_block_insert_after(blocks[source->index], after);
+    after = blocks[source->index];
+  }
+
+  for (source = callee->first_block; source; source = source->next) {
+    ir_builder_set_block(&builder, blocks[source->index]);
+    for (instr = source->first; instr; instr = instr->next) {
+      IrValue *clone = NULL;
+
+      if (instr->opcode == IR_OP_RET) {
+        returned[return_count] =
+          instr->operand_count ? instr->operands[0] : NULL;
+        return_blocks[return_count++] = builder.block;
+        clone = ir_build_br(&builder, tail);
+      } else {
+        clone = ir_build_clone(&builder, instr);
+      }
+      if (!clone) {
+        goto done;
+      }
+      /* Whatever tail position the call had was the callee's. */
+      if (instr->opcode == IR_OP_CALL) {
+        clone->instr->flags &= ~(IR_FLAG_TAIL | IR_FLAG_MUSTTAIL);
+      }
+      if (ir_instr_has_result(instr)) {
+        values[instr->id] = clone;
+      }
+    }
+  }
+
+  /* The copies still point into the callee; point them at each other. */
+  anchor = caller->first_block->first;
+  while (anchor->opcode == IR_OP_ALLOCA) {
+    anchor = anchor->next;
+  }
+  for (source = callee->first_block; source; source = source->next) {
+    for (instr = blocks[source->index]->first; instr; instr = next) {
+      next = instr->next;
+      for (index = 0; index < instr->operand_count; index++) {
+        IrValue *mapped = ir_inline_map(instr->operands[index], call, values);
+
+        if (mapped != instr->operands[index]) {
+          ir_instr_set_operand(instr, index, mapped);
+        }
+      }
+      for (index = 0; index < instr->block_count; index++) {
+        if (instr->blocks[index]->parent == callee) {
+          instr->blocks[index] = blocks[instr->blocks[index]->index];
+        }
+      }
+      if (instr->opcode == IR_OP_ALLOCA) {
+        ir_instr_move_before(instr, anchor);
+      }
+    }
+  }
+
+  ir_builder_set_block(&builder, block);
+  if (!ir_build_br(&builder, blocks[callee->first_block->index])) {
+    goto done;
+  }
+
+  if (ir_instr_has_result(call)) {
+    IrValue *value = NULL;
+
+    if (return_count == 1) {
+      value = ir_inline_map(returned[0], call, values);
+    } else {
+      ir_builder_set_block(&builder, tail);
+      value = ir_build_phi(&builder, call->value.type);
+      if (!value) {
+        goto done;
+      }
+      ir_instr_move_before(value->instr, tail->first);
+      for (index = 0; index < return_count; index++) {
+        if (!ir_phi_add_incoming(
+              value->instr, ir_inline_map(returned[index], call, values),
+              return_blocks[index])) {
+          goto done;
+        }
+      }
+    }
+    ir_replace_all_uses(caller, &call->value, value);
+  }
+  ir_instr_remove(call);
+  result = 1;
+
+done:
+  free(blocks);
+  free(values);
+  free(returned);
+  free(return_blocks);
+  free(name);
+  return result;
+}
+
+/* Inlines the cheap calls the caller makes outside its own component. */
+static int ir_inline_function(const IrCallGraph *graph, size_t node,
+                              const IrPassOptions *options, size_t *changes) {
+  IrFunction *caller = graph->functions[node];
+  IrInlineSite *sites = NULL;
+  size_t site_count = 0;
+  size_t site_capacity = 0;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t returns = 0;
+  long caller_cost = ir_inline_function_cost(caller, &returns);
+  size_t index = 0;
+  int result = 1;
+
+  if (!ir_function_build_cfg(caller) ||
+      !ir_function_compute_loop_depth(caller)) {
+    return 0;
+  }
+
+  for (block = caller->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      IrFunction *callee = ir_call_graph_callee(instr);
+
+      if (!callee ||
+          graph->component[ir_call_graph_node(graph, callee)] ==
+            graph->component[node]) {
+        continue;
+      }
+
+      if (site_count == site_capacity) {
+        size_t capacity = site_capacity ? site_capacity * 2 : 16;
+        IrInlineSite *grown = realloc(sites, capacity * sizeof(*grown));
+
+        if (!grown) {
+          free(sites);
+          return 0;
+        }
+        sites = grown;
+        site_capacity = capacity;
+      }
+      sites[site_count].call = instr;
+      sites[site_count].loop_depth = block->loop_depth;
+      site_count++;
+    }
+  }
+
+  for (index = 0; index < site_count && result; index++) {
+    IrInstr *call = sites[index].call;
+    long threshold = options->inline_threshold;
+    long cost =
+      ir_inline_function_cost(call->operands[0]->function, &returns) -
+      ir_inline_instr_cost(call);
+    long loop_cost = 0;
+
+    if (!ir_inline_loop_cost(call->operands[0]->function, &loop_cost)) {
+      result = 0;
+      break;
+    }
+    if (sites[index].loop_depth > 0) {
+      threshold += threshold / 2;
+    }
+    if (!returns || cost + loop_cost > threshold ||
+        caller_cost + cost > IR_INLINE_MAX_CALLER_COST) {
+      continue;
+    }
+
+    result = ir_inline_call(call);
+    caller_cost += cost;
+    (*changes)++;
+  }
+
+  free(sites);
+  return result;
+}
+
+int ir_inline_module(IrModule *module, const IrPassOptions *options,
+                     size_t *changes) {
+  IrCallGraph graph;
+  size_t index = 0;
+  int result = 1;
+
+  if (!ir_call_graph_build(&graph, module)) {
+    return 0;
+  }
+
+  for (index = 0; index < graph.postorder_count && result; index++) {
+    result = ir_inline_function(&graph, graph.postorder[index], options,
+                                changes);
+  }
+
+  ir_call_graph_free(&graph);
+  return result;
+}
@@ -0,0 +1,313 @@
+#include "ir_loop.h"
+#include "ir_pass.h"
+
+#include <stdlib.h>
+
+/*
+ * A basic induction variable: a header phi that starts at init and goes
+ * up by step, without signed overflow, each time round the loop.
+ */
+typedef struct IrIvsrInduction {
+  IrInstr *phi;
+  IrValue *init;
+  IrInstr *next;
+  long long step;
+} IrIvsrInduction;
+
+/* An address base + (iv * scale + offset) elements of type source. */
+typedef struct IrIvsrAddress {
+  IrValue *base;
+  IrType *source;
+  IrInstr *iv;
+  long long scale;
+  /* Loop invariant, or NULL for none. */
+  IrValue *offset;
+  /* The pointer phi that replaces every address of this shape. */
+  IrInstr *phi;
+} IrIvsrAddress;
+
+/* phi = [init, preheader], [phi + step or phi - step, latch] with nsw. */
+static int ir_ivsr_match_induction(const IrLoop *loop, IrInstr *phi,
+                                   IrIvsrInduction *induction) {
+  IrValue *constant = NULL;
+  IrInstr *next = NULL;
+  size_t index = 0;
+
+  induction->init = NULL;
+  if (phi->operand_count != 2 || phi->value.type->kind != IR_TYPE_INT) {
+    return 0;
+  }
+  for (index = 0; index < 2; index++) {
+    if (phi->blocks[index] == loop->preheader) {
+      induction->init = phi->operands[index];
+    } else if (phi->blocks[index] == loop->latch &&
+               phi->operands[index]->kind == IR_VALUE_INSTR) {
+      next = phi->operands[index]->instr;
+    }
+  }
+  if (!next || !induction->init || !(next->flags & IR_FLAG_NSW) ||
+      (next->opcode != IR_OP_ADD && next->opcode != IR_OP_SUB)) {
+    return 0;
+  }
+
+  if (next->operands[0] == &phi->value) {
+    constant = next->operands[1];
+  } else if (next->opcode == IR_OP_ADD && next->operands[1] == &phi->value) {
+    constant = next->operands[0];
+  }
+  if (!constant || !ir_value_is_const_int(constant, &induction->step)) {
+    return 0;
+  }
+
+  induction->step =
+    next->opcode == IR_OP_SUB ? -induction->step : induction->step;
+  induction->phi = phi;
+  induction->next = next;
+  return 1;
+}
+
+static const IrIvsrInduction *ir_ivsr_find(const IrIvsrInduction *inductions,
+                                           size_t count, const IrValue *value) {
+  size_t index = 0;
+
+  for (index = 0; index < count; index++) {
+    if (&inductions[index].phi->value == value) {
+      return &inductions[index];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Splits a GEP index into iv * scale + offset, for an index that is an
+ * induction variable, one multiplied or shifted left by a constant, or
+ * either plus an invariant. Each step must be nsw, so the sum grows by the
+ * same amount every trip.
+ */
+static const IrIvsrInduction *
+ir_ivsr_split_index(const IrLoop *loop, const IrIvsrInduction *inductions,
+                    size_t count, IrValue *index, long long *scale,
+                    IrValue **offset) {
+  const IrIvsrInduction *induction = ir_ivsr_find(inductions, count, index);
+  const IrInstr *instr = index->kind == IR_VALUE_INSTR ? index->instr : NULL;
+  long long shift = 0;
+  size_t side = 0;
+
+  *scale = 1;
+  *offset = NULL;
+  if (induction) {
+    return induction;
+  }
+  if (!instr || !(instr->flags & IR_FLAG_NSW)) {
+    return NULL;
+  }
+
+  for (side = 0; side < 2; side++) {
+    IrValue *term = instr->operands[side];
+    IrValue *other = instr->operands[1 - side];
+    IrValue *inner_offset = NULL;
+
+    if (instr->opcode == IR_OP_MUL &&
+        (induction = ir_ivsr_find(inductions, count, term)) &&
+        ir_value_is_const_int(other, scale)) {
+      return induction;
+    }
+    /* Codegen writes multiplies by powers of two as shifts. */
+    if (instr->opcode == IR_OP_SHL && side == 0 &&
+        (induction = ir_ivsr_find(inductions, count, term)) &&
+        ir_value_is_const_int(other, &shift) && shift >= 0 && shift < 32) {
+      *scale = 1ll << shift;
+      return induction;
+    }
+    if (instr->opcode == IR_OP_ADD && ir_loop_is_invariant(loop, other) &&
+        (induction = ir_ivsr_split_index(loop, inductions, count, term, scale,
+                                         &inner_offset)) &&
+        !inner_offset) {
+      *offset = other;
+      return induction;
+    }
+  }
+  return NULL;
+}
+
+static IrValue *ir_ivsr_before(IrValue *value, IrInstr *position) {
+  if (value) {
+    ir_instr_move_before(value->instr, position);
+  }
+  return value;
+}
+
+/*
+ * Builds the pointer phi for an address: its first value is computed in
+ * the preheader, and it moves on by step * scale elements right where the
+ * induction variable moves on.
+ */
+static IrInstr *ir_ivsr_make_pointer(IrFunction *function, const IrLoop *loop,
+                                     const IrIvsrInduction *induction,
+                                     const IrIvsrAddress *address) {
+  IrInstr *terminator = ir_block_terminator(loop->preheader);
+  IrType *type = induction->phi->value.type;
+  IrValue *start = induction->init;
+  IrValue *phi = NULL;
+  IrValue *step = NULL;
+  long long constant = 0;
+  IrBuilder builder;
+
+  /* Fold what a constant start allows: most loops start at 0. */
+  ir_builder_init(&builder, function);
+  ir_builder_set_block(&builder, loop->preheader);
+  if (ir_value_is_const_int(start, &constant)) {
+    start = ir_const_int(function->module, type, constant * address->scale);
+  } else if (address->scale != 1) {
+    start = ir_ivsr_before(
+      ir_build_binary(&builder, IR_OP_MUL, 0, start,
+                      ir_const_int(function->module, type, address->scale)),
+      terminator);
+  }
+  if (start && address->offset) {
+    start = ir_value_is_const_int(start, &constant) && constant == 0
+              ? address->offset
+              : ir_ivsr_before(ir_build_binary(&builder, IR_OP_ADD, 0, start,
+                                               address->offset),
+                               terminator);
+  }
+  if (start && ir_value_is_const_int(start, &constant) && constant == 0) {
+    start = address->base;
+  } else if (start) {
+    start = ir_ivsr_before(
+      ir_build_gep(&builder, 0, address->source, address->base, &start, 1),
+      terminator);
+  }
+
+  ir_builder_set_block(&builder, loop->header);
+  phi = ir_ivsr_before(ir_build_phi(&builder, address->base->type),
+                       loop->header->first);
+  step = ir_const_int(function->module, type,
+                      induction->step * address->scale);
+  step = phi ? ir_build_gep(&builder, 0, address->source, phi, &step, 1)
+             : NULL;
+  if (!start || !step) {
+    return NULL;
+  }
+  ir_instr_move_before(step->instr, induction->next->next);
+
+  if (!ir_phi_add_incoming(phi->instr, start, loop->preheader) ||
+      !ir_phi_add_incoming(phi->instr, step, loop->latch)) {
+    return NULL;
+  }
+  return phi->instr;
+}
+
+/* Rewrites the addresses in one loop; *changes counts the GEPs replaced. */
+static int ir_ivsr_loop(IrFunction *function, const IrLoop *loop,
+                        size_t *changes) {
+  IrIvsrInduction *inductions = NULL;
+  IrIvsrAddress *addresses = NULL;
+  size_t induction_count = 0;
+  size_t address_count = 0;
+  size_t instr_count = 0;
+  size_t block = 0;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  int ok = 0;
+
+  if (!loop->preheader || !loop->latch) {
+    return 1;
+  }
+
+  for (block = 0; block < loop->block_count; block++) {
+    for (instr = loop->blocks[block]->first; instr; instr = instr->next) {
+      instr_count++;
+    }
+  }
+  inductions = malloc((instr_count + 1) * sizeof(*inductions));
+  addresses = malloc((instr_count + 1) * sizeof(*addresses));
+  if (!inductions || !addresses) {
+    goto cleanup;
+  }
+
+  for (instr = loop->header->first; instr && instr->opcode == IR_OP_PHI;
+       instr = instr->next) {
+    if (ir_ivsr_match_induction(loop, instr, &inductions[induction_count])) {
+      induction_count++;
+    }
+  }
+
+  for (block = 0; block < loop->block_count && induction_count > 0; block++) {
+    for (instr = loop->blocks[block]->first; instr; instr = next) {
+      const IrIvsrInduction *induction = NULL;
+      IrIvsrAddress address;
+      size_t index = 0;
+
+      next = instr->next;
+      if (instr->opcode != IR_OP_GEP || instr->operand_count != 2 ||
+          !ir_loop_is_invariant(loop, instr->operands[0])) {
+        continue;
+      }
+      induction = ir_ivsr_split_index(loop, inductions, induction_count,
+                                      instr->operands[1], &address.scale,
+                                      &address.offset);
+      if (!induction) {
+        continue;
+      }
+      address.base = instr->operands[0];
+      address.source = instr->aux_type;
+      address.iv = induction->phi;
+      address.phi = NULL;
+
+      /* Addresses of the same shape share one pointer. */
+      for (index = 0; index < address_count; index++) {
+        const IrIvsrAddress *seen = &addresses[index];
+
+        if (seen->base == address.base && seen->source == address.source &&
+            seen->iv == address.iv && seen->scale == address.scale &&
+            seen->offset == address.offset) {
+          address.phi = seen->phi;
+          break;
+        }
+      }
+      if (!address.phi) {
+        address.phi = ir_ivsr_make_pointer(function, loop, induction, &address);
+        if (!address.phi) {
+          goto cleanup;
+        }
+        addresses[address_count++] = address;
+      }
+
+      ir_replace_all_uses(function, &instr->value, &address.phi->value);
+      ir_instr_remove(instr);
+      (*changes)++;
+    }
+  }
+  ok = 1;
+
+cleanup:
+  free(inductions);
+  free(addresses);
+  return ok;
+}
+
+/*
+ * Induction-variable strength reduction: an address computed each trip
+ * round a loop as base + i * stride, for an induction variable i, becomes
+ * a pointer phi that the loop bumps by a constant, so the multiply and the
+ * add in the address go away.
+ */
+int ir_ivsr_function(IrFunction *function, size_t *changes) {
+  IrLoopInfo info;
+  size_t index = 0;
+
+  if (!ir_loop_info_compute(function, &info)) {
+    return 0;
+  }
+
+  for (index = 0; index < info.count; index++) {
+    if (!ir_ivsr_loop(function, &info.loops[index], changes)) {
+      ir_loop_info_free(&info);
+      return 0;
+    }
+  }
+
+  ir_loop_info_free(&info);
+  return 1;
+}
@@ -0,0 +1,1159 @@
+/* MAP_ANONYMOUS */
+#define _DEFAULT_SOURCE
+
+#include "ir_jit.h"
+
+#include "ir_x86_encode.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Address space reserved for compiled code. */
+#define IR_JIT_REGION_BYTES ((size_t)64 << 20)
+/* Each call stub is padded to this many bytes. */
+#define IR_JIT_STUB_BYTES 32
+
+/*
+ * Stand-ins for the operand fields of templates, wide enough to force the
+ * 32- and 64-bit encodings. Shift counts are one byte, always the last of
+ * their instruction.
+ */
+#define IR_JIT_SLOT_SENTINEL 0x7eadbeefLL
+#define IR_JIT_VALUE32_SENTINEL 0x7badf00dLL
+#define IR_JIT_VALUE64_SENTINEL 0x7badf00d7badf00dLL
+#define IR_JIT_VALUE8_SENTINEL 0x3f
+
+/* Machine registers compiled code keeps for its whole run; callee-saved. */
+#define IR_JIT_REGISTERS IR_X86_RBX
+#define IR_JIT_STACK IR_X86_R12
+#define IR_JIT_CONTEXT IR_X86_R13
+
+typedef enum IrJitHoleKind {
+  /* The 32-bit displacement of register operand n: 8 * pc[n]. */
+  IR_JIT_HOLE_SLOT,
+  /* Operand n as an 8-, 32-, or 64-bit immediate. */
+  IR_JIT_HOLE_VALUE8,
+  IR_JIT_HOLE_VALUE32,
+  IR_JIT_HOLE_VALUE64,
+  /* rel32 fields: the code for bytecode offset pc[n]. */
+  IR_JIT_HOLE_TARGET,
+  /* A label within the template, resolved when it is assembled. */
+  IR_JIT_HOLE_LABEL,
+  /* The function's traps and its exit for errors from callees. */
+  IR_JIT_HOLE_DIVIDE,
+  IR_JIT_HOLE_OVERFLOW,
+  IR_JIT_HOLE_UNWIND,
+  /* The entry of function n, or its stub until it is compiled. */
+  IR_JIT_HOLE_CALL
+} IrJitHoleKind;
+
+typedef struct IrJitHole {
+  size_t offset;
+  IrJitHoleKind kind;
+  /* An operand index in templates, a bytecode offset or function after. */
+  long long value;
+} IrJitHole;
+
+/* Machine code with holes: a template, or a function being compiled. */
+typedef struct IrJitAsm {
+  unsigned char *bytes;
+  size_t length;
+  size_t capacity;
+  IrJitHole *holes;
+  size_t hole_count;
+  size_t hole_capacity;
+  /* Holes in the operands of the next instruction, still sentinels. */
+  IrJitHole pending[2];
+  size_t pending_count;
+  size_t labels[2];
+  int failed;
+} IrJitAsm;
+
+static const IrX86Operand ir_jit_no_operand;
+
+/* Comparisons in opcode order, from EQ and from JEQ. */
+static const IrX86Condition ir_jit_conditions[] = {
+  IR_X86_CC_E, IR_X86_CC_NE, IR_X86_CC_L, IR_X86_CC_LE, IR_X86_CC_G,
+  IR_X86_CC_GE, IR_X86_CC_B, IR_X86_CC_BE, IR_X86_CC_A, IR_X86_CC_AE,
+};
+
+static const IrX86Register ir_jit_argument_registers[IR_VM_NATIVE_ARGS] = {
+  IR_X86_RDI, IR_X86_RSI, IR_X86_RDX, IR_X86_RCX, IR_X86_R8, IR_X86_R9,
+};
+
+static void ir_jit_asm_free(IrJitAsm *as) {
+  free(as->bytes);
+  free(as->holes);
+  memset(as, 0, sizeof(*as));
+}
+
+static void ir_jit_append(IrJitAsm *as, const void *data, size_t size) {
+  if (as->failed) {
+    return;
+  }
+
+  if (as->length + size > as->capacity) {
+    size_t capacity = as->capacity ? as->capacity * 2 : 256;
+    unsigned char *bytes = NULL;
+
+    while (capacity < as->length + size) {
+      capacity *= 2;
+    }
+    bytes = realloc(as->bytes, capacity);
+    if (!bytes) {
+      as->failed = 1;
+      return;
+    }
+    as->bytes = bytes;
+    as->capacity = capacity;
+  }
+
+  memcpy(as->bytes + as->length, data, size);
+  as->length += size;
+}
+
+static void ir_jit_add_hole(IrJitAsm *as, size_t offset, IrJitHoleKind kind,
+                            long long value) {
+  if (as->failed) {
+    return;
+  }
+
+  if (as->hole_count == as->hole_capacity) {
+    size_t capacity = as->hole_capacity ? as->hole_capacity * 2 : 16;
+    IrJitHole *holes = realloc(as->holes, capacity * sizeof(*holes));
+
+    if (!holes) {
+      as->failed = 1;
+      return;
+    }
+    as->holes = holes;
+    as->hole_capacity = capacity;
+  }
+
+  as->holes[as->hole_count].offset = offset;
+  as->holes[as->hole_count].kind = kind;
+  as->holes[as->hole_count].value = value;
+  as->hole_count++;
+}
+
+static void ir_jit_write32(unsigned char *at, long long value) {
+  int index = 0;
+
+  for (index = 0; index < 4; index++) {
+    at[index] = (unsigned char)((unsigned long long)value >> (8 * index));
+  }
+}
+
+static void ir_jit_write64(unsigned char *at, long long value) {
+  int index = 0;
+
+  for (index = 0; index < 8; index++) {
+    at[index] = (unsigned char)((unsigned long long)value >> (8 * index));
+  }
+}
+
+static int ir_jit_fits32(long long value) {
+  return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+static long long ir_jit_sentinel(IrJitHoleKind kind) {
+  switch (kind) {
+  case IR_JIT_HOLE_SLOT:
+    return IR_JIT_SLOT_SENTINEL;
+  case IR_JIT_HOLE_VALUE8:
+    return IR_JIT_VALUE8_SENTINEL;
+  case IR_JIT_HOLE_VALUE32:
+    return IR_JIT_VALUE32_SENTINEL;
+  default:
+    return IR_JIT_VALUE64_SENTINEL;
+  }
+}
+
+/* Returns the sentinel to encode in place of operand n of the template. */
+static long long ir_jit_hole(IrJitAsm *as, IrJitHoleKind kind, int operand) {
+  IrJitHole *hole = &as->pending[as->pending_count++];
+
+  hole->offset = 0;
+  hole->kind = kind;
+  hole->value = operand;
+  return ir_jit_sentinel(kind);
+}
+
+/* Finds the sentinels of the pending holes in the instruction at start. */
+static void ir_jit_resolve_pending(IrJitAsm *as, size_t start) {
+  size_t index = 0;
+
+  for (index = 0; index < as->pending_count; index++) {
+    const IrJitHole *hole = &as->pending[index];
+    unsigned char pattern[8];
+    size_t size = hole->kind == IR_JIT_HOLE_VALUE64 ? 8 : 4;
+    size_t offset = start;
+
+    if (hole->kind == IR_JIT_HOLE_VALUE8) {
+      ir_jit_add_hole(as, as->length - 1, hole->kind, hole->value);
+      continue;
+    }
+
+    ir_jit_write64(pattern, ir_jit_sentinel(hole->kind));
+    while (offset + size <= as->length &&
+           memcmp(as->bytes + offset, pattern, size) != 0) {
+      offset++;
+    }
+    if (offset + size > as->length) {
+      as->failed = 1;
+      break;
+    }
+    ir_jit_add_hole(as, offset, hole->kind, hole->value);
+  }
+
+  as->pending_count = 0;
+}
+
+/* Appends one machine instruction; returns the offset of its rel32. */
+static size_t ir_jit_encode(IrJitAsm *as, const IrX86Instr *instr) {
+  IrX86Encoding encoding;
+  size_t start = as->length;
+
+  if (!ir_x86_encode(instr, &encoding)) {
+    as->failed = 1;
+    return 0;
+  }
+  ir_jit_append(as, encoding.bytes, encoding.length);
+  if (as->failed) {
+    return 0;
+  }
+  ir_jit_resolve_pending(as, start);
+  return start + encoding.pcrel_offset;
+}
+
+static IrX86Operand ir_jit_reg(IrX86Register reg) {
+  IrX86Operand operand = ir_jit_no_operand;
+
+  operand.kind = IR_X86_OPERAND_REG;
+  operand.reg = reg;
+  return operand;
+}
+
+static IrX86Operand ir_jit_mem(IrX86Register base, long long displacement) {
+  IrX86Operand operand = ir_jit_no_operand;
+
+  operand.kind = IR_X86_OPERAND_MEM;
+  operand.reg = base;
+  operand.index = IR_X86_NO_REGISTER;
+  operand.scale = 1;
+  operand.value = displacement;
+  return operand;
+}
+
+static IrX86Operand ir_jit_imm(long long value) {
+  IrX86Operand operand = ir_jit_no_operand;
+
+  operand.kind = IR_X86_OPERAND_IMM;
+  operand.value = value;
+  return operand;
+}
+
+/* Register operand n of the bytecode instruction, in a template. */
+static IrX86Operand ir_jit_slot(IrJitAsm *as, int operand) {
+  return ir_jit_mem(IR_JIT_REGISTERS,
+                    ir_jit_hole(as, IR_JIT_HOLE_SLOT, operand));
+}
+
+/* A register of the VM's window at a known index. */
+static IrX86Operand ir_jit_register(long long index) {
+  return ir_jit_mem(IR_JIT_REGISTERS, 8 * index);
+}
+
+static void ir_jit_op(IrJitAsm *as, IrX86Opcode opcode, int bits,
+                      IrX86Operand dst, IrX86Operand src) {
+  IrX86Instr instr;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = opcode;
+  instr.bits = bits;
+  instr.dst = dst;
+  instr.src = src;
+  ir_jit_encode(as, &instr);
+}
+
+static void ir_jit_setcc(IrJitAsm *as, IrX86Condition condition) {
+  IrX86Instr instr;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = IR_X86_SETCC;
+  instr.bits = 8;
+  instr.condition = condition;
+  instr.dst = ir_jit_reg(IR_X86_RAX);
+  ir_jit_encode(as, &instr);
+}
+
+/* A jump, conditional jump, or call whose rel32 is the hole. */
+static void ir_jit_branch(IrJitAsm *as, IrX86Opcode opcode,
+                          IrX86Condition condition, IrJitHoleKind kind,
+                          long long value) {
+  IrX86Instr instr;
+  size_t offset = 0;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = opcode;
+  instr.condition = condition;
+  offset = ir_jit_encode(as, &instr);
+  if (!as->failed) {
+    ir_jit_add_hole(as, offset, kind, value);
+  }
+}
+
+/* Calls a C function at an absolute address, beyond rel32 reach. */
+static void ir_jit_call_absolute(IrJitAsm *as, IrX86Register scratch,
+                                 long long address) {
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(scratch), ir_jit_imm(address));
+  ir_jit_op(as, IR_X86_CALL, 64, ir_jit_reg(scratch), ir_jit_no_operand);
+}
+
+static void ir_jit_load(IrJitAsm *as, IrX86Register reg, int bits,
+                        int operand) {
+  ir_jit_op(as, IR_X86_MOV, bits, ir_jit_reg(reg), ir_jit_slot(as, operand));
+}
+
+/* Stores rax into register operand n. */
+static void ir_jit_store(IrJitAsm *as, int operand) {
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_slot(as, operand),
+            ir_jit_reg(IR_X86_RAX));
+}
+
+/* Sign-extends rax from bit 63 - pc[n], as IR_VM_WRAP does. */
+static void ir_jit_wrap(IrJitAsm *as, int operand) {
+  ir_jit_op(as, IR_X86_SHL, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE8, operand)));
+  ir_jit_op(as, IR_X86_SAR, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE8, operand)));
+}
+
+static void ir_jit_prologue(IrJitAsm *as) {
+  ir_jit_op(as, IR_X86_PUSH, 64, ir_jit_reg(IR_JIT_REGISTERS),
+            ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_PUSH, 64, ir_jit_reg(IR_JIT_STACK), ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_PUSH, 64, ir_jit_reg(IR_JIT_CONTEXT),
+            ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_JIT_CONTEXT),
+            ir_jit_reg(IR_X86_RDI));
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_JIT_REGISTERS),
+            ir_jit_reg(IR_X86_RSI));
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_JIT_STACK),
+            ir_jit_reg(IR_X86_RDX));
+}
+
+/* Returns rax and rdx, the IrJitResult, to the caller. */
+static void ir_jit_epilogue(IrJitAsm *as) {
+  ir_jit_op(as, IR_X86_POP, 64, ir_jit_reg(IR_JIT_CONTEXT), ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_POP, 64, ir_jit_reg(IR_JIT_STACK), ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_POP, 64, ir_jit_reg(IR_JIT_REGISTERS),
+            ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_RET, 64, ir_jit_no_operand, ir_jit_no_operand);
+}
+
+static IrX86Opcode ir_jit_alu(IrVmOpcode opcode) {
+  switch (opcode) {
+  case IR_VM_OP_ADD:
+  case IR_VM_OP_ADD_I32:
+  case IR_VM_OP_ADD_I64:
+  case IR_VM_OP_ADD_MEM32:
+    return IR_X86_ADD;
+  case IR_VM_OP_SUB:
+  case IR_VM_OP_SUB_I32:
+  case IR_VM_OP_SUB_I64:
+  case IR_VM_OP_SUB_MEM32:
+    return IR_X86_SUB;
+  case IR_VM_OP_AND:
+    return IR_X86_AND;
+  case IR_VM_OP_OR:
+    return IR_X86_OR;
+  case IR_VM_OP_XOR:
+    return IR_X86_XOR;
+  default:
+    return IR_X86_IMUL;
+  }
+}
+
+/* rax = pc[2] op pc[3] in the given width, sign-extended from it. */
+static void ir_jit_binary(IrJitAsm *as, IrVmOpcode opcode, int bits) {
+  ir_jit_load(as, IR_X86_RAX, bits, 2);
+  ir_jit_op(as, ir_jit_alu(opcode), bits, ir_jit_reg(IR_X86_RAX),
+            ir_jit_slot(as, 3));
+  if (bits == 32) {
+    ir_jit_op(as, IR_X86_MOVSX, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+  }
+}
+
+/* rax = pc[2] + pc[3] * pc[4], the address of an indexed access. */
+static void ir_jit_index(IrJitAsm *as) {
+  ir_jit_load(as, IR_X86_RAX, 64, 3);
+  ir_jit_op(as, IR_X86_IMUL, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE32, 4)));
+  ir_jit_op(as, IR_X86_ADD, 64, ir_jit_reg(IR_X86_RAX), ir_jit_slot(as, 2));
+}
+
+/*
+ * Division traps on a zero divisor and handles -1 apart, since idiv
+ * faults on the most negative dividend.
+ */
+static void ir_jit_divide(IrJitAsm *as, IrVmOpcode opcode) {
+  int bits = opcode == IR_VM_OP_SDIV_I32 || opcode == IR_VM_OP_SREM_I32 ? 32
+                                                                         : 64;
+  int remainder = opcode == IR_VM_OP_SREM || opcode == IR_VM_OP_SREM_I32;
+
+  ir_jit_load(as, IR_X86_RCX, bits, 3);
+  ir_jit_op(as, IR_X86_TEST, bits, ir_jit_reg(IR_X86_RCX),
+            ir_jit_reg(IR_X86_RCX));
+  ir_jit_branch(as, IR_X86_JCC, IR_X86_CC_E, IR_JIT_HOLE_DIVIDE, 0);
+  ir_jit_load(as, IR_X86_RAX, bits, 2);
+  ir_jit_op(as, IR_X86_CMP, bits, ir_jit_reg(IR_X86_RCX), ir_jit_imm(-1));
+  ir_jit_branch(as, IR_X86_JCC, IR_X86_CC_NE, IR_JIT_HOLE_LABEL, 0);
+  if (remainder) {
+    ir_jit_op(as, IR_X86_XOR, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+  } else {
+    ir_jit_op(as, IR_X86_NEG, bits, ir_jit_reg(IR_X86_RAX), ir_jit_no_operand);
+  }
+  ir_jit_branch(as, IR_X86_JMP, IR_X86_CC_E, IR_JIT_HOLE_LABEL, 1);
+
+  as->labels[0] = as->length;
+  ir_jit_op(as, IR_X86_CQO, bits, ir_jit_no_operand, ir_jit_no_operand);
+  ir_jit_op(as, IR_X86_IDIV, bits, ir_jit_reg(IR_X86_RCX), ir_jit_no_operand);
+  if (remainder) {
+    ir_jit_op(as, IR_X86_MOV, bits, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RDX));
+  }
+
+  as->labels[1] = as->length;
+  if (bits == 32) {
+    ir_jit_op(as, IR_X86_MOVSX, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+  } else if (!remainder) {
+    ir_jit_wrap(as, 4);
+  }
+  ir_jit_store(as, 1);
+}
+
+/* The machine code for one opcode; CALL and CALL_NATIVE have none. */
+static void ir_jit_template(IrJitAsm *as, IrVmOpcode opcode) {
+  switch (opcode) {
+  case IR_VM_OP_MOV:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_FRAME:
+    ir_jit_op(as, IR_X86_LEA, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_mem(IR_JIT_STACK,
+                         ir_jit_hole(as, IR_JIT_HOLE_VALUE32, 2)));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_ADD:
+  case IR_VM_OP_SUB:
+  case IR_VM_OP_MUL:
+    ir_jit_binary(as, opcode, 64);
+    ir_jit_wrap(as, 4);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_ADD_I32:
+  case IR_VM_OP_SUB_I32:
+  case IR_VM_OP_MUL_I32:
+    ir_jit_binary(as, opcode, 32);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_ADD_I64:
+  case IR_VM_OP_SUB_I64:
+  case IR_VM_OP_MUL_I64:
+  case IR_VM_OP_AND:
+  case IR_VM_OP_OR:
+  case IR_VM_OP_XOR:
+    ir_jit_binary(as, opcode, 64);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_SDIV:
+  case IR_VM_OP_SDIV_I32:
+  case IR_VM_OP_SREM:
+  case IR_VM_OP_SREM_I32:
+    ir_jit_divide(as, opcode);
+    return;
+  case IR_VM_OP_SHL:
+  case IR_VM_OP_ASHR:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_load(as, IR_X86_RCX, 64, 3);
+    ir_jit_op(as, opcode == IR_VM_OP_SHL ? IR_X86_SHL : IR_X86_SAR, 64,
+              ir_jit_reg(IR_X86_RAX), ir_jit_reg(IR_X86_RCX));
+    if (opcode == IR_VM_OP_SHL) {
+      ir_jit_wrap(as, 4);
+    }
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_LSHR:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_SHL, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE8, 4)));
+    ir_jit_op(as, IR_X86_SHR, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE8, 4)));
+    ir_jit_load(as, IR_X86_RCX, 64, 3);
+    ir_jit_op(as, IR_X86_SHR, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RCX));
+    ir_jit_wrap(as, 4);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_EQ:
+  case IR_VM_OP_NE:
+  case IR_VM_OP_SLT:
+  case IR_VM_OP_SLE:
+  case IR_VM_OP_SGT:
+  case IR_VM_OP_SGE:
+  case IR_VM_OP_ULT:
+  case IR_VM_OP_ULE:
+  case IR_VM_OP_UGT:
+  case IR_VM_OP_UGE:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_CMP, 64, ir_jit_reg(IR_X86_RAX), ir_jit_slot(as, 3));
+    ir_jit_setcc(as, ir_jit_conditions[opcode - IR_VM_OP_EQ]);
+    ir_jit_op(as, IR_X86_MOVZX, 8, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_WRAP:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_wrap(as, 3);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_MASK:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RCX),
+              ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE64, 3)));
+    ir_jit_op(as, IR_X86_AND, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RCX));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_NEG:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_NEG, 64, ir_jit_reg(IR_X86_RAX), ir_jit_no_operand);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_INDEX:
+    ir_jit_index(as);
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_OFFSET:
+    ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_imm(ir_jit_hole(as, IR_JIT_HOLE_VALUE64, 3)));
+    ir_jit_op(as, IR_X86_ADD, 64, ir_jit_reg(IR_X86_RAX), ir_jit_slot(as, 2));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_LOAD8:
+  case IR_VM_OP_LOAD16:
+  case IR_VM_OP_LOAD32:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_MOVSX,
+              opcode == IR_VM_OP_LOAD8    ? 8
+              : opcode == IR_VM_OP_LOAD16 ? 16
+                                          : 32,
+              ir_jit_reg(IR_X86_RAX), ir_jit_mem(IR_X86_RAX, 0));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_LOAD64:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_mem(IR_X86_RAX, 0));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_LOADU8:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_op(as, IR_X86_MOVZX, 8, ir_jit_reg(IR_X86_RAX),
+              ir_jit_mem(IR_X86_RAX, 0));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_STORE8:
+  case IR_VM_OP_STORE16:
+  case IR_VM_OP_STORE32:
+  case IR_VM_OP_STORE64:
+    ir_jit_load(as, IR_X86_RAX, 64, 2);
+    ir_jit_load(as, IR_X86_RCX, 64, 1);
+    ir_jit_op(as, IR_X86_MOV,
+              opcode == IR_VM_OP_STORE8    ? 8
+              : opcode == IR_VM_OP_STORE16 ? 16
+              : opcode == IR_VM_OP_STORE32 ? 32
+                                           : 64,
+              ir_jit_mem(IR_X86_RAX, 0), ir_jit_reg(IR_X86_RCX));
+    return;
+  case IR_VM_OP_JMP:
+    ir_jit_branch(as, IR_X86_JMP, IR_X86_CC_E, IR_JIT_HOLE_TARGET, 1);
+    return;
+  case IR_VM_OP_JZ:
+  case IR_VM_OP_JNZ:
+    ir_jit_op(as, IR_X86_CMP, 64, ir_jit_slot(as, 1), ir_jit_imm(0));
+    ir_jit_branch(as, IR_X86_JCC,
+                  opcode == IR_VM_OP_JZ ? IR_X86_CC_E : IR_X86_CC_NE,
+                  IR_JIT_HOLE_TARGET, 2);
+    return;
+  case IR_VM_OP_RET:
+    ir_jit_load(as, IR_X86_RAX, 64, 1);
+    ir_jit_op(as, IR_X86_MOV, 32, ir_jit_reg(IR_X86_RDX), ir_jit_imm(1));
+    ir_jit_epilogue(as);
+    return;
+  case IR_VM_OP_RET_VOID:
+    ir_jit_op(as, IR_X86_XOR, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+    ir_jit_op(as, IR_X86_MOV, 32, ir_jit_reg(IR_X86_RDX), ir_jit_imm(1));
+    ir_jit_epilogue(as);
+    return;
+  case IR_VM_OP_JEQ:
+  case IR_VM_OP_JNE:
+  case IR_VM_OP_JSLT:
+  case IR_VM_OP_JSLE:
+  case IR_VM_OP_JSGT:
+  case IR_VM_OP_JSGE:
+  case IR_VM_OP_JULT:
+  case IR_VM_OP_JULE:
+  case IR_VM_OP_JUGT:
+  case IR_VM_OP_JUGE:
+    ir_jit_load(as, IR_X86_RAX, 64, 1);
+    ir_jit_op(as, IR_X86_CMP, 64, ir_jit_reg(IR_X86_RAX), ir_jit_slot(as, 2));
+    ir_jit_branch(as, IR_X86_JCC, ir_jit_conditions[opcode - IR_VM_OP_JEQ],
+                  IR_JIT_HOLE_TARGET, 3);
+    return;
+  case IR_VM_OP_ADD_MEM32:
+  case IR_VM_OP_SUB_MEM32:
+    ir_jit_load(as, IR_X86_RAX, 64, 1);
+    ir_jit_load(as, IR_X86_RCX, 32, 2);
+    ir_jit_op(as, ir_jit_alu(opcode), 32, ir_jit_mem(IR_X86_RAX, 0),
+              ir_jit_reg(IR_X86_RCX));
+    return;
+  case IR_VM_OP_LOAD32_INDEX:
+    ir_jit_index(as);
+    ir_jit_op(as, IR_X86_MOVSX, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_mem(IR_X86_RAX, 0));
+    ir_jit_store(as, 1);
+    return;
+  case IR_VM_OP_STORE32_INDEX:
+    ir_jit_index(as);
+    ir_jit_load(as, IR_X86_RCX, 32, 1);
+    ir_jit_op(as, IR_X86_MOV, 32, ir_jit_mem(IR_X86_RAX, 0),
+              ir_jit_reg(IR_X86_RCX));
+    return;
+  default:
+    return;
+  }
+}
+
+/* Assembles a template and resolves its labels. */
+static int ir_jit_build_template(IrJitAsm *as, IrVmOpcode opcode) {
+  size_t index = 0;
+  size_t kept = 0;
+
+  ir_jit_template(as, opcode);
+  if (as->failed) {
+    return 0;
+  }
+
+  for (index = 0; index < as->hole_count; index++) {
+    const IrJitHole *hole = &as->holes[index];
+
+    if (hole->kind == IR_JIT_HOLE_LABEL) {
+      ir_jit_write32(as->bytes + hole->offset,
+                     (long long)as->labels[hole->value] -
+                       (long long)(hole->offset + 4));
+    } else {
+      as->holes[kept++] = *hole;
+    }
+  }
+  as->hole_count = kept;
+  return 1;
+}
+
+/* The template an instruction runs: generic ones get their width's form. */
+static IrVmOpcode ir_jit_specialize(const IrVmWord *pc) {
+  switch ((IrVmOpcode)pc[0]) {
+  case IR_VM_OP_ADD:
+    return pc[4] == 32  ? IR_VM_OP_ADD_I32
+           : pc[4] == 0 ? IR_VM_OP_ADD_I64
+                        : IR_VM_OP_ADD;
+  case IR_VM_OP_SUB:
+    return pc[4] == 32  ? IR_VM_OP_SUB_I32
+           : pc[4] == 0 ? IR_VM_OP_SUB_I64
+                        : IR_VM_OP_SUB;
+  case IR_VM_OP_MUL:
+    return pc[4] == 32  ? IR_VM_OP_MUL_I32
+           : pc[4] == 0 ? IR_VM_OP_MUL_I64
+                        : IR_VM_OP_MUL;
+  case IR_VM_OP_SDIV:
+    return pc[4] == 32 ? IR_VM_OP_SDIV_I32 : IR_VM_OP_SDIV;
+  case IR_VM_OP_SREM:
+    return pc[4] == 32 ? IR_VM_OP_SREM_I32 : IR_VM_OP_SREM;
+  default:
+    return (IrVmOpcode)pc[0];
+  }
+}
+
+/* Appends a copy of the template with the instruction's operands in it. */
+static void ir_jit_stitch(IrJitAsm *as, const IrJitAsm *template,
+                          const IrVmWord *pc) {
+  size_t start = as->length;
+  size_t index = 0;
+
+  ir_jit_append(as, template->bytes, template->length);
+  for (index = 0; index < template->hole_count && !as->failed; index++) {
+    const IrJitHole *hole = &template->holes[index];
+    unsigned char *at = as->bytes + start + hole->offset;
+    IrVmWord operand = pc[hole->value];
+
+    switch (hole->kind) {
+    case IR_JIT_HOLE_SLOT:
+      ir_jit_write32(at, 8 * operand);
+      break;
+    case IR_JIT_HOLE_VALUE8:
+      *at = (unsigned char)operand;
+      break;
+    case IR_JIT_HOLE_VALUE32:
+      if (!ir_jit_fits32(operand)) {
+        as->failed = 1;
+      }
+      ir_jit_write32(at, operand);
+      break;
+    case IR_JIT_HOLE_VALUE64:
+      ir_jit_write64(at, operand);
+      break;
+    case IR_JIT_HOLE_TARGET:
+      ir_jit_add_hole(as, start + hole->offset, hole->kind, operand);
+      break;
+    default:
+      ir_jit_add_hole(as, start + hole->offset, hole->kind, hole->value);
+      break;
+    }
+  }
+}
+
+/*
+ * CALL: the interpreter's overflow checks, then the arguments into the
+ * callee's window and a direct call. A compiled callee loads its own
+ * constants.
+ */
+static void ir_jit_call(IrJit *jit, IrJitAsm *as,
+                        const IrVmFunction *function, const IrVmWord *pc) {
+  const IrVmFunction *callee = &jit->vm->program->functions[pc[2]];
+  long long next = (long long)function->register_count;
+  long long frame = (long long)function->frame_size;
+  IrVmWord index = 0;
+
+  ir_jit_op(as, IR_X86_LEA, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_register(next + (long long)callee->register_count));
+  ir_jit_op(as, IR_X86_CMP, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_mem(IR_JIT_CONTEXT, offsetof(IrJit, registers_end)));
+  ir_jit_branch(as, IR_X86_JCC, IR_X86_CC_A, IR_JIT_HOLE_OVERFLOW, 0);
+  ir_jit_op(as, IR_X86_LEA, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_mem(IR_JIT_STACK, frame + (long long)callee->frame_size));
+  ir_jit_op(as, IR_X86_CMP, 64, ir_jit_reg(IR_X86_RAX),
+            ir_jit_mem(IR_JIT_CONTEXT, offsetof(IrJit, stack_end)));
+  ir_jit_branch(as, IR_X86_JCC, IR_X86_CC_A, IR_JIT_HOLE_OVERFLOW, 0);
+
+  for (index = 0; index < pc[3]; index++) {
+    ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_register(pc[4 + index]));
+    ir_jit_op(as, IR_X86_MOV, 64, ir_jit_register(next + index),
+              ir_jit_reg(IR_X86_RAX));
+  }
+
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RDI),
+            ir_jit_reg(IR_JIT_CONTEXT));
+  ir_jit_op(as, IR_X86_LEA, 64, ir_jit_reg(IR_X86_RSI),
+            ir_jit_register(next));
+  ir_jit_op(as, IR_X86_LEA, 64, ir_jit_reg(IR_X86_RDX),
+            ir_jit_mem(IR_JIT_STACK, frame));
+  ir_jit_branch(as, IR_X86_CALL, IR_X86_CC_E, IR_JIT_HOLE_CALL, pc[2]);
+  ir_jit_op(as, IR_X86_TEST, 32, ir_jit_reg(IR_X86_RDX),
+            ir_jit_reg(IR_X86_RDX));
+  ir_jit_branch(as, IR_X86_JCC, IR_X86_CC_E, IR_JIT_HOLE_UNWIND, 0);
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_register(pc[1]),
+            ir_jit_reg(IR_X86_RAX));
+}
+
+/* CALL_NATIVE, with the interpreter's zeroed surplus arguments. */
+static void ir_jit_call_native(IrJit *jit, IrJitAsm *as, const IrVmWord *pc) {
+  const IrVmNative *native = &jit->vm->program->natives[pc[2]];
+  IrVmWord index = 0;
+
+  for (index = 0; index < IR_VM_NATIVE_ARGS; index++) {
+    IrX86Register reg = ir_jit_argument_registers[index];
+
+    if (index < pc[3]) {
+      ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(reg),
+                ir_jit_register(pc[4 + index]));
+    } else {
+      ir_jit_op(as, IR_X86_XOR, 32, ir_jit_reg(reg), ir_jit_reg(reg));
+    }
+  }
+
+  /* A variadic callee reads al as its count of vector arguments. */
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_R10),
+            ir_jit_imm((long long)(intptr_t)jit->vm->natives[pc[2]]));
+  ir_jit_op(as, IR_X86_XOR, 32, ir_jit_reg(IR_X86_RAX),
+            ir_jit_reg(IR_X86_RAX));
+  ir_jit_op(as, IR_X86_CALL, 64, ir_jit_reg(IR_X86_R10), ir_jit_no_operand);
+
+  switch (native->return_type) {
+  case IR_VM_TYPE_VOID:
+    ir_jit_op(as, IR_X86_XOR, 32, ir_jit_reg(IR_X86_RAX),
+              ir_jit_reg(IR_X86_RAX));
+    break;
+  case IR_VM_TYPE_I1:
+    ir_jit_op(as, IR_X86_AND, 32, ir_jit_reg(IR_X86_RAX), ir_jit_imm(1));
+    break;
+  case IR_VM_TYPE_I8:
+  case IR_VM_TYPE_I16:
+  case IR_VM_TYPE_I32:
+    ir_jit_op(as, IR_X86_MOVSX,
+              native->return_type == IR_VM_TYPE_I8    ? 8
+              : native->return_type == IR_VM_TYPE_I16 ? 16
+                                                      : 32,
+              ir_jit_reg(IR_X86_RAX), ir_jit_reg(IR_X86_RAX));
+    break;
+  default:
+    break;
+  }
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_register(pc[1]),
+            ir_jit_reg(IR_X86_RAX));
+}
+
+static IrJitResult ir_jit_trap(IrJit *jit, const char *message) {
+  IrJitResult result = {0, 0};
+
+  if (!jit->vm->error_message) {
+    jit->vm->error_message = message;
+  }
+  return result;
+}
+
+/* Records the error the way the interpreter would, then unwinds. */
+static void ir_jit_trap_stub(IrJitAsm *as, const char *message) {
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RDI),
+            ir_jit_reg(IR_JIT_CONTEXT));
+  ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RSI),
+            ir_jit_imm((long long)(intptr_t)message));
+  ir_jit_call_absolute(as, IR_X86_RAX, (long long)(intptr_t)ir_jit_trap);
+  ir_jit_branch(as, IR_X86_JMP, IR_X86_CC_E, IR_JIT_HOLE_UNWIND, 0);
+}
+
+static void ir_jit_constants(IrJit *jit, IrJitAsm *as, size_t index) {
+  const IrVmFunction *function = &jit->vm->program->functions[index];
+  const IrVmWord *constants = jit->vm->constants[index];
+  size_t item = 0;
+
+  for (item = 0; item < function->constant_count; item++) {
+    IrX86Operand slot =
+      ir_jit_register((long long)(function->constant_base + item));
+
+    if (ir_jit_fits32(constants[item])) {
+      ir_jit_op(as, IR_X86_MOV, 64, slot, ir_jit_imm(constants[item]));
+    } else {
+      ir_jit_op(as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RAX),
+                ir_jit_imm(constants[item]));
+      ir_jit_op(as, IR_X86_MOV, 64, slot, ir_jit_reg(IR_X86_RAX));
+    }
+  }
+}
+
+static int ir_jit_protect(IrJit *jit, unsigned char *start, size_t size,
+                          int protection) {
+  uintptr_t mask = ~(uintptr_t)(jit->page_size - 1);
+  uintptr_t first = (uintptr_t)start & mask;
+  uintptr_t end = ((uintptr_t)start + size + jit->page_size - 1) & mask;
+
+  return mprotect((void *)first, end - first, protection) == 0;
+}
+
+/* Takes whole pages of the region, writable until ir_jit_seal. */
+static unsigned char *ir_jit_allocate(IrJit *jit, size_t size) {
+  size_t rounded = (size + jit->page_size - 1) & ~(jit->page_size - 1);
+  unsigned char *code = jit->region + jit->region_used;
+
+  if (rounded > jit->region_size - jit->region_used ||
+      !ir_jit_protect(jit, code, rounded, PROT_READ | PROT_WRITE)) {
+    return NULL;
+  }
+  jit->region_used += rounded;
+  return code;
+}
+
+static int ir_jit_seal(IrJit *jit, unsigned char *code, size_t size) {
+  return ir_jit_protect(jit, code, size, PROT_READ | PROT_EXEC);
+}
+
+static void ir_jit_add_site(IrJitFunction *callee, unsigned char *site) {
+  if (callee->site_count == callee->site_capacity) {
+    size_t capacity = callee->site_capacity ? callee->site_capacity * 2 : 8;
+    unsigned char **sites =
+      realloc(callee->sites, capacity * sizeof(*sites));
+
+    /* Without the record the site keeps going through the stub. */
+    if (!sites) {
+      return;
+    }
+    callee->sites = sites;
+    callee->site_capacity = capacity;
+  }
+  callee->sites[callee->site_count++] = site;
+}
+
+/* Points the call sites that went through the stub at the new code. */
+static void ir_jit_patch_sites(IrJit *jit, IrJitFunction *compiled) {
+  unsigned char *entry = (unsigned char *)compiled->entry;
+  size_t index = 0;
+
+  for (index = 0; index < compiled->site_count; index++) {
+    unsigned char *site = compiled->sites[index];
+
+    if (ir_jit_protect(jit, site, 4, PROT_READ | PROT_WRITE)) {
+      ir_jit_write32(site, entry - (site + 4));
+      ir_jit_seal(jit, site, 4);
+    }
+  }
+
+  free(compiled->sites);
+  compiled->sites = NULL;
+  compiled->site_count = 0;
+  compiled->site_capacity = 0;
+}
+
+/* Copies the function into the region and fills in its rel32 fields. */
+static unsigned char *ir_jit_place(IrJit *jit, const IrJitAsm *as,
+                                   size_t index, const size_t *offsets,
+                                   const size_t *exits) {
+  unsigned char *code = ir_jit_allocate(jit, as->length);
+  size_t hole = 0;
+
+  if (!code) {
+    return NULL;
+  }
+  memcpy(code, as->bytes, as->length);
+
+  for (hole = 0; hole < as->hole_count; hole++) {
+    const IrJitHole *fixup = &as->holes[hole];
+    unsigned char *site = code + fixup->offset;
+    unsigned char *target = NULL;
+
+    switch (fixup->kind) {
+    case IR_JIT_HOLE_TARGET:
+      target = code + offsets[fixup->value];
+      break;
+    case IR_JIT_HOLE_DIVIDE:
+    case IR_JIT_HOLE_OVERFLOW:
+    case IR_JIT_HOLE_UNWIND:
+      target = code + exits[fixup->kind - IR_JIT_HOLE_DIVIDE];
+      break;
+    default:
+      if ((size_t)fixup->value == index) {
+        target = code + exits[3];
+      } else if (jit->functions[fixup->value].entry) {
+        target = (unsigned char *)jit->functions[fixup->value].entry;
+      } else {
+        target = jit->stubs + fixup->value * IR_JIT_STUB_BYTES;
+        ir_jit_add_site(&jit->functions[fixup->value], site);
+      }
+      break;
+    }
+    ir_jit_write32(site, target - (site + 4));
+  }
+
+  return code;
+}
+
+int ir_jit_compile(IrJit *jit, size_t index) {
+  const IrVmFunction *function = &jit->vm->program->functions[index];
+  IrJitFunction *compiled = &jit->functions[index];
+  IrJitAsm as;
+  size_t *offsets = NULL;
+  /* Division trap, overflow trap, unwind, and entry. */
+  size_t exits[4];
+  size_t offset = 0;
+  unsigned char *code = NULL;
+
+  if (compiled->entry) {
+    return 1;
+  }
+  memset(&as, 0, sizeof(as));
+  offsets = calloc(function->code_size + 1, sizeof(*offsets));
+  if (!offsets) {
+    return 0;
+  }
+
+  /* Resuming jumps to the target, the fourth argument. */
+  ir_jit_prologue(&as);
+  ir_jit_op(&as, IR_X86_JMP, 64, ir_jit_reg(IR_X86_RCX), ir_jit_no_operand);
+
+  exits[3] = as.length;
+  ir_jit_prologue(&as);
+  ir_jit_op(&as, IR_X86_CMP, 64, ir_jit_reg(IR_X86_RSP),
+            ir_jit_mem(IR_JIT_CONTEXT, offsetof(IrJit, native_limit)));
+  ir_jit_branch(&as, IR_X86_JCC, IR_X86_CC_B, IR_JIT_HOLE_OVERFLOW, 0);
+  ir_jit_constants(jit, &as, index);
+
+  for (offset = 0; offset < function->code_size;
+       offset += ir_vm_instr_size(&function->code[offset])) {
+    const IrVmWord *pc = &function->code[offset];
+
+    offsets[offset] = as.length;
+    if (pc[0] == IR_VM_OP_CALL) {
+      ir_jit_call(jit, &as, function, pc);
+    } else if (pc[0] == IR_VM_OP_CALL_NATIVE) {
+      ir_jit_call_native(jit, &as, pc);
+    } else {
+      ir_jit_stitch(&as, &jit->templates[ir_jit_specialize(pc)], pc);
+    }
+  }
+
+  exits[0] = as.length;
+  ir_jit_trap_stub(&as, "vm: division by zero");
+  exits[1] = as.length;
+  ir_jit_trap_stub(&as, "vm: stack overflow");
+  exits[2] = as.length;
+  ir_jit_epilogue(&as);
+
+  if (!as.failed) {
+    code = ir_jit_place(jit, &as, index, offsets, exits);
+  }
+  if (!code || !ir_jit_seal(jit, code, as.length)) {
+    ir_jit_asm_free(&as);
+    free(offsets);
+    return 0;
+  }
+
+  compiled->resume = (IrJitResume)code;
+  compiled->entry = (IrJitEntry)(code + exits[3]);
+  compiled->code = code;
+  compiled->code_size = as.length;
+  compiled->offsets = offsets;
+  ir_jit_patch_sites(jit, compiled);
+  ir_jit_asm_free(&as);
+  return 1;
+}
+
+/* Stub n: ir_vm_jit_call(jit, registers, stack, n), as a tail call. */
+static unsigned char *ir_jit_build_stubs(IrJit *jit) {
+  const unsigned char padding[IR_JIT_STUB_BYTES] = {0};
+  size_t count = jit->vm->program->function_count;
+  size_t index = 0;
+  IrJitAsm as;
+  unsigned char *stubs = NULL;
+
+  memset(&as, 0, sizeof(as));
+  for (index = 0; index < count; index++) {
+    size_t start = as.length;
+
+    ir_jit_op(&as, IR_X86_MOV, 32, ir_jit_reg(IR_X86_RCX),
+              ir_jit_imm((long long)index));
+    ir_jit_op(&as, IR_X86_MOV, 64, ir_jit_reg(IR_X86_RAX),
+              ir_jit_imm((long long)(intptr_t)ir_vm_jit_call));
+    ir_jit_op(&as, IR_X86_JMP, 64, ir_jit_reg(IR_X86_RAX), ir_jit_no_operand);
+    ir_jit_append(&as, padding, start + IR_JIT_STUB_BYTES - as.length);
+  }
+  ir_jit_append(&as, padding, 1);
+
+  if (!as.failed) {
+    stubs = ir_jit_allocate(jit, as.length);
+  }
+  if (stubs) {
+    memcpy(stubs, as.bytes, as.length);
+    if (!ir_jit_seal(jit, stubs, as.length)) {
+      stubs = NULL;
+    }
+  }
+  ir_jit_asm_free(&as);
+  return stubs;
+}
+
+IrJit *ir_jit_create(IrVm *vm, unsigned threshold) {
+  IrJit *jit = calloc(1, sizeof(*jit));
+  void *region = MAP_FAILED;
+  size_t index = 0;
+
+  if (!jit) {
+    return NULL;
+  }
+  jit->vm = vm;
+  jit->registers_end = vm->registers + vm->register_capacity;
+  jit->stack_end = vm->stack + vm->stack_size;
+  jit->page_size = (size_t)sysconf(_SC_PAGESIZE);
+  jit->functions =
+    calloc(vm->program->function_count + 1, sizeof(*jit->functions));
+  jit->templates = calloc(IR_VM_OPCODE_COUNT, sizeof(*jit->templates));
+  region = mmap(NULL, IR_JIT_REGION_BYTES, PROT_NONE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region != MAP_FAILED) {
+    jit->region = region;
+    jit->region_size = IR_JIT_REGION_BYTES;
+  }
+  if (!jit->functions || !jit->templates || !jit->region) {
+    ir_jit_free(jit);
+    return NULL;
+  }
+
+  for (index = 0; index < vm->program->function_count; index++) {
+    jit->functions[index].budget = threshold;
+  }
+  for (index = 0; index < IR_VM_OPCODE_COUNT; index++) {
+    if (!ir_jit_build_template(&jit->templates[index], (IrVmOpcode)index)) {
+      ir_jit_free(jit);
+      return NULL;
+    }
+  }
+
+  jit->stubs = ir_jit_build_stubs(jit);
+  if (!jit->stubs) {
+    ir_jit_free(jit);
+    return NULL;
+  }
+  return jit;
+}
+
+void ir_jit_free(IrJit *jit) {
+  size_t index = 0;
+
+  if (!jit) {
+    return;
+  }
+
+  if (jit->functions) {
+    for (index = 0; index < jit->vm->program->function_count; index++) {
+      free(jit->functions[index].offsets);
+      free(jit->functions[index].sites);
+    }
+  }
+  if (jit->templates) {
+    for (index = 0; index < IR_VM_OPCODE_COUNT; index++) {
+      ir_jit_asm_free(&jit->templates[index]);
+    }
+  }
+  if (jit->region) {
+    munmap(jit->region, jit->region_size);
+  }
+  free(jit->functions);
+  free(jit->templates);
+  free(jit);
+}
+
+#else
+
+IrJit *ir_jit_create(IrVm *vm, unsigned threshold) {
+  (void)vm;
+  (void)threshold;
+  return NULL;
+}
+
+void ir_jit_free(IrJit *jit) { (void)jit; }
+
+int ir_jit_compile(IrJit *jit, size_t function) {
+  (void)jit;
+  (void)function;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "ir_loop.h"
+#include "ir_pass.h"
+
+#include <stdlib.h>
+
+/* The alloca, global, or other pointer an address is an offset from. */
+static const IrValue *ir_licm_root(const IrValue *address) {
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    address = address->instr->operands[0];
+  }
+  return address;
+}
+
+static int ir_licm_is_alloca(const IrValue *value) {
+  return value->kind == IR_VALUE_INSTR && value->instr->opcode == IR_OP_ALLOCA;
+}
+
+/*
+ * Flags, by instruction id, the allocas whose address goes anywhere but
+ * the address operand of a load, store, or GEP, a bitcast, or a compare.
+ * Nothing but the function's own loads and stores can touch the rest.
+ */
+static char *ir_licm_find_escapes(const IrFunction *function) {
+  char *escaped = calloc((size_t)function->next_value_id + 1, 1);
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+
+  if (!escaped) {
+    return NULL;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *root = ir_licm_root(instr->operands[index]);
+
+        if (!ir_licm_is_alloca(root) ||
+            (instr->opcode == IR_OP_LOAD && index == 0) ||
+            (instr->opcode == IR_OP_STORE && index == 1) ||
+            (instr->opcode == IR_OP_GEP && index == 0) ||
+            instr->opcode == IR_OP_BITCAST || instr->opcode == IR_OP_ICMP) {
+          continue;
+        }
+        escaped[root->instr->id] = 1;
+      }
+    }
+  }
+  return escaped;
+}
+
+/* An alloca whose address never leaves the function's loads and stores. */
+static int ir_licm_is_private(const IrValue *root, const char *escaped) {
+  return ir_licm_is_alloca(root) && !escaped[root->instr->id];
+}
+
+/*
+ * Whether two addresses may name overlapping memory. Distinct allocas and
+ * globals never overlap, and nothing but an address computed from it
+ * reaches an alloca that does not escape.
+ */
+static int ir_licm_may_alias(const IrValue *left, const IrValue *right,
+                             const char *escaped) {
+  const IrValue *left_root = ir_licm_root(left);
+  const IrValue *right_root = ir_licm_root(right);
+  int left_object =
+    ir_licm_is_alloca(left_root) || left_root->kind == IR_VALUE_GLOBAL;
+  int right_object =
+    ir_licm_is_alloca(right_root) || right_root->kind == IR_VALUE_GLOBAL;
+
+  if (left_root == right_root) {
+    return 1;
+  }
+  if (left_object && right_object) {
+    return 0;
+  }
+  return !ir_licm_is_private(left_root, escaped) &&
+         !ir_licm_is_private(right_root, escaped);
+}
+
+/*
+ * Whether a load from address can run where the loop did not run it: the
+ * address is an alloca or global, or a constant offset into one.
+ */
+static int ir_licm_is_dereferenceable(const IrValue *address) {
+  size_t index = 0;
+
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    const IrInstr *instr = address->instr;
+
+    if (instr->opcode == IR_OP_GEP) {
+      if (!(instr->flags & IR_FLAG_INBOUNDS)) {
+        return 0;
+      }
+      for (index = 1; index < instr->operand_count; index++) {
+        if (instr->operands[index]->kind != IR_VALUE_CONST_INT) {
+          return 0;
+        }
+      }
+    }
+    address = instr->operands[0];
+  }
+  return ir_licm_is_alloca(address) || address->kind == IR_VALUE_GLOBAL;
+}
+
+/* Whether block runs on every trip through the loop that leaves it. */
+static int ir_licm_runs_before_exit(const IrLoop *loop, const IrBlock *block) {
+  size_t exits = 0;
+  size_t index = 0;
+  size_t successor = 0;
+
+  for (index = 0; index < loop->block_count; index++) {
+    const IrBlock *member = loop->blocks[index];
+
+    for (successor = 0; successor < ir_block_successor_count(member);
+         successor++) {
+      if (ir_loop_contains(loop, ir_block_successor(member, successor))) {
+        continue;
+      }
+      if (!ir_block_dominates(block, member)) {
+        return 0;
+      }
+      exits++;
+    }
+  }
+  return exits > 0;
+}
+
+/*
+ * Whether a load can move to the preheader: nothing in the loop may write
+ * what it reads, calls included unless functionattrs found them read-only,
+ * and reading it early cannot fault.
+ */
+static int ir_licm_can_hoist_load(const IrLoop *loop, const IrInstr *load,
+                                  const char *escaped) {
+  const IrValue *address = load->operands[0];
+  size_t index = 0;
+  const IrInstr *instr = NULL;
+
+  for (index = 0; index < loop->block_count; index++) {
+    for (instr = loop->blocks[index]->first; instr; instr = instr->next) {
+      if (instr->opcode == IR_OP_STORE &&
+          ir_licm_may_alias(address, instr->operands[1], escaped)) {
+        return 0;
+      }
+      if ((instr->opcode == IR_OP_MEMSET || instr->opcode == IR_OP_MEMCPY) &&
+          ir_licm_may_alias(address, instr->operands[0], escaped)) {
+        return 0;
+      }
+      if (instr->opcode == IR_OP_CALL &&
+          instr->operands[0]->function->memory == IR_MEMORY_READWRITE &&
+          !ir_licm_is_private(ir_licm_root(address), escaped)) {
+        return 0;
+      }
+    }
+  }
+
+  return ir_licm_is_dereferenceable(address) ||
+         ir_licm_runs_before_exit(loop, load->parent);
+}
+
+/* Instructions that compute a value and nothing else, and cannot trap. */
+static int ir_licm_is_pure(const IrInstr *instr) {
+  long long divisor = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_GEP:
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+  case IR_OP_ICMP:
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+  case IR_OP_BITCAST:
+    return 1;
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+    /* Only a constant divisor rules out dividing by 0 or INT_MIN by -1. */
+    return ir_value_is_const_int(instr->operands[1], &divisor) &&
+           divisor != 0 && divisor != -1;
+  default:
+    return 0;
+  }
+}
+
+static void ir_licm_loop(IrLoop *loop, const char *escaped, size_t *changes) {
+  IrInstr *terminator = ir_block_terminator(loop->preheader);
+  size_t block = 0;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  size_t index = 0;
+
+  /* Blocks in dominance order, so operands move out before their users. */
+  for (block = 0; block < loop->block_count; block++) {
+    for (instr = loop->blocks[block]->first; instr; instr = next) {
+      int invariant = 1;
+
+      next = instr->next;
+      if (!ir_licm_is_pure(instr) && instr->opcode != IR_OP_LOAD) {
+        continue;
+      }
+      for (index = 0; index < instr->operand_count && invariant; index++) {
+        invariant = ir_loop_is_invariant(loop, instr->operands[index]);
+      }
+      if (!invariant || (instr->opcode == IR_OP_LOAD &&
+                         !ir_licm_can_hoist_load(loop, instr, escaped))) {
+        continue;
+      }
+
+      ir_instr_move_before(instr, terminator);
+      (*changes)++;
+    }
+  }
+}
+
+/*
+ * Loop-invariant code motion: moves computations whose operands do not
+ * change in a loop, and loads nothing in the loop can overwrite, to the
+ * loop's preheader. Inner loops go first, so a value can move out of a
+ * whole nest one loop at a time.
+ */
+int ir_licm_function(IrFunction *function, size_t *changes) {
+  IrLoopInfo info;
+  char *escaped = NULL;
+  size_t index = 0;
+
+  if (!ir_loop_info_compute(function, &info)) {
+    return 0;
+  }
+  escaped = ir_licm_find_escapes(function);
+  if (!escaped) {
+    ir_loop_info_free(&info);
+    return 0;
+  }
+
+  for (index = 0; index < info.count; index++) {
+    ir_licm_loop(&info.loops[index], escaped, changes);
+  }
+
+  free(escaped);
+  ir_loop_info_free(&info);
+  return 1;
+}
@@ -0,0 +1,784 @@
+#include "ir_llvm.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Metadata nodes, numbered in the order they are first needed. For TBAA,
+ * a scalar node names a C type and hangs off "omnipotent char", which
+ * hangs off the root; a struct node lists the node and offset of each
+ * field; a tag is the (base, access, offset) triple a load or store
+ * points at. Profile nodes carry branch weights or an entry count. Debug
+ * info is a line-tables-only compile unit for the source file, with a
+ * subprogram per definition that its instructions' locations are scoped
+ * to.
+ */
+typedef enum IrLlvmNodeKind {
+  IR_LLVM_TBAA_ROOT,
+  IR_LLVM_TBAA_SCALAR,
+  IR_LLVM_TBAA_STRUCT,
+  IR_LLVM_TBAA_TAG,
+  IR_LLVM_PROF_BRANCH_WEIGHTS,
+  IR_LLVM_PROF_ENTRY_COUNT,
+  IR_LLVM_DEBUG_FILE,
+  IR_LLVM_DEBUG_UNIT,
+  IR_LLVM_DEBUG_SUBPROGRAM,
+  IR_LLVM_DEBUG_LOCATION,
+  IR_LLVM_MODULE_FLAG
+} IrLlvmNodeKind;
+
+typedef struct IrLlvmNode {
+  IrLlvmNodeKind kind;
+  /* IR_LLVM_TBAA_SCALAR, a subprogram's function, or a flag's key. */
+  const char *name;
+  /* IR_LLVM_TBAA_STRUCT. */
+  const IrType *type;
+  /*
+   * The parent of a scalar, the base of a tag, the file of a unit, the
+   * unit of a subprogram, or the subprogram of a location.
+   */
+  size_t parent;
+  /* IR_LLVM_TBAA_TAG. */
+  size_t access;
+  size_t offset;
+  /*
+   * The weights, or the entry count alone; a line and column; or a module
+   * flag's behavior and value.
+   */
+  unsigned long long counts[2];
+} IrLlvmNode;
+
+#define IR_LLVM_NO_NODE ((size_t)-1)
+
+typedef struct IrLlvmWriter {
+  const IrLlvmOptions *options;
+  const IrModule *module;
+  FILE *out;
+  /* The subprogram of the function being defined, with debug info. */
+  size_t subprogram;
+  IrLlvmNode *nodes;
+  size_t node_count;
+  size_t node_capacity;
+  /* Intrinsics some instruction called, declared after the definitions. */
+  int uses_memset;
+  int uses_memcpy;
+  int out_of_memory;
+} IrLlvmWriter;
+
+void ir_llvm_options_init(IrLlvmOptions *options) {
+  options->type_based_aliasing = 1;
+}
+
+static void ir_llvm_type(const IrType *type, FILE *out) {
+  switch (type->kind) {
+  case IR_TYPE_VOID:
+    fprintf(out, "void");
+    break;
+  case IR_TYPE_INT:
+    fprintf(out, "i%d", type->bits);
+    break;
+  case IR_TYPE_POINTER:
+    ir_llvm_type(type->element, out);
+    fprintf(out, "*");
+    break;
+  case IR_TYPE_ARRAY:
+    fprintf(out, "[%zu x ", type->length);
+    ir_llvm_type(type->element, out);
+    fprintf(out, "]");
+    break;
+  case IR_TYPE_STRUCT:
+    fprintf(out, "%%struct.%s", type->name);
+    break;
+  }
+}
+
+static void ir_llvm_typed_value(const IrValue *value, FILE *out);
+
+static void ir_llvm_value(const IrValue *value, FILE *out) {
+  size_t index = 0;
+
+  switch (value->kind) {
+  case IR_VALUE_CONST_INT:
+    fprintf(out, "%lld", value->constant);
+    break;
+  case IR_VALUE_NULL:
+    fprintf(out, "null");
+    break;
+  case IR_VALUE_ZERO:
+    fprintf(out, "zeroinitializer");
+    break;
+  case IR_VALUE_AGGREGATE:
+    fprintf(out, value->type->kind == IR_TYPE_ARRAY ? "[" : "{ ");
+    for (index = 0; index < value->element_count; index++) {
+      if (index > 0) {
+        fprintf(out, ", ");
+      }
+      ir_llvm_typed_value(value->elements[index], out);
+    }
+    fprintf(out, value->type->kind == IR_TYPE_ARRAY ? "]" : " }");
+    break;
+  case IR_VALUE_GLOBAL:
+    fprintf(out, "@%s", value->global->name);
+    break;
+  case IR_VALUE_FUNCTION:
+    fprintf(out, "@%s", value->function->name);
+    break;
+  case IR_VALUE_PARAM:
+    fprintf(out, "%%%s", value->param->name);
+    break;
+  case IR_VALUE_INSTR:
+    fprintf(out, "%%t%d", value->instr->id);
+    break;
+  }
+}
+
+static void ir_llvm_typed_value(const IrValue *value, FILE *out) {
+  ir_llvm_type(value->type, out);
+  fprintf(out, " ");
+  ir_llvm_value(value, out);
+}
+
+static size_t ir_llvm_find_node(const IrLlvmWriter *writer,
+                                const IrLlvmNode *key) {
+  size_t index = 0;
+
+  for (index = 0; index < writer->node_count; index++) {
+    const IrLlvmNode *node = &writer->nodes[index];
+
+    if (node->kind == key->kind && node->type == key->type &&
+        node->parent == key->parent && node->access == key->access &&
+        node->offset == key->offset && node->counts[0] == key->counts[0] &&
+        node->counts[1] == key->counts[1] &&
+        (node->name == key->name ||
+         (node->name && key->name && strcmp(node->name, key->name) == 0))) {
+      return index;
+    }
+  }
+  return IR_LLVM_NO_NODE;
+}
+
+static size_t ir_llvm_node(IrLlvmWriter *writer, const IrLlvmNode *key) {
+  IrLlvmNode *nodes = NULL;
+  size_t found = ir_llvm_find_node(writer, key);
+
+  if (found != IR_LLVM_NO_NODE) {
+    return found;
+  }
+
+  if (writer->node_count == writer->node_capacity) {
+    size_t capacity = writer->node_capacity ? writer->node_capacity * 2 : 16;
+
+    nodes = realloc(writer->nodes, capacity * sizeof(*nodes));
+    if (!nodes) {
+      writer->out_of_memory = 1;
+      return IR_LLVM_NO_NODE;
+    }
+    writer->nodes = nodes;
+    writer->node_capacity = capacity;
+  }
+  writer->nodes[writer->node_count] = *key;
+  return writer->node_count++;
+}
+
+static size_t ir_llvm_tbaa_node(IrLlvmWriter *writer, IrLlvmNodeKind kind,
+                                const char *name, const IrType *type,
+                                size_t parent, size_t access, size_t offset) {
+  IrLlvmNode key;
+
+  memset(&key, 0, sizeof(key));
+  key.kind = kind;
+  key.name = name;
+  key.type = type;
+  key.parent = parent;
+  key.access = access;
+  key.offset = offset;
+  return ir_llvm_node(writer, &key);
+}
+
+static size_t ir_llvm_tbaa_scalar(IrLlvmWriter *writer, const char *name) {
+  size_t parent = ir_llvm_tbaa_node(writer, IR_LLVM_TBAA_ROOT, NULL, NULL,
+                                    IR_LLVM_NO_NODE, IR_LLVM_NO_NODE, 0);
+
+  if (parent != IR_LLVM_NO_NODE && strcmp(name, "omnipotent char") != 0) {
+    parent = ir_llvm_tbaa_scalar(writer, "omnipotent char");
+  }
+  if (parent == IR_LLVM_NO_NODE) {
+    return IR_LLVM_NO_NODE;
+  }
+  return ir_llvm_tbaa_node(writer, IR_LLVM_TBAA_SCALAR, name, NULL, parent,
+                           IR_LLVM_NO_NODE, 0);
+}
+
+/*
+ * The type node for objects of type, or IR_LLVM_NO_NODE for types C
+ * code cannot name here. An array is its element type, as in clang.
+ */
+static size_t ir_llvm_tbaa_type(IrLlvmWriter *writer, const IrType *type) {
+  size_t field = 0;
+
+  switch (type->kind) {
+  case IR_TYPE_INT:
+    if (type->bits == 8) {
+      return ir_llvm_tbaa_scalar(writer, "omnipotent char");
+    }
+    if (type->bits == 16) {
+      return ir_llvm_tbaa_scalar(writer, "short");
+    }
+    if (type->bits == 32) {
+      return ir_llvm_tbaa_scalar(writer, "int");
+    }
+    return IR_LLVM_NO_NODE;
+  case IR_TYPE_POINTER:
+    return ir_llvm_tbaa_scalar(writer, "any pointer");
+  case IR_TYPE_ARRAY:
+    return ir_llvm_tbaa_type(writer, type->element);
+  case IR_TYPE_STRUCT:
+    if (!type->has_body) {
+      return IR_LLVM_NO_NODE;
+    }
+    /* Field nodes first, so the struct node can refer back to them. */
+    for (field = 0; field < type->field_count; field++) {
+      if (ir_llvm_tbaa_type(writer, type->fields[field]) ==
+          IR_LLVM_NO_NODE) {
+        return IR_LLVM_NO_NODE;
+      }
+    }
+    return ir_llvm_tbaa_node(writer, IR_LLVM_TBAA_STRUCT, NULL, type,
+                             IR_LLVM_NO_NODE, IR_LLVM_NO_NODE, 0);
+  default:
+    return IR_LLVM_NO_NODE;
+  }
+}
+
+/*
+ * The access tag for a load or store of a scalar through pointer. A field
+ * reached by a constant struct GEP gets a struct-path tag, so fields of
+ * different structs do not alias even when their types match.
+ */
+static size_t ir_llvm_tbaa_tag(IrLlvmWriter *writer, const IrValue *pointer) {
+  const IrType *access_type = pointer->type->element;
+  const IrInstr *gep = pointer->kind == IR_VALUE_INSTR ? pointer->instr : NULL;
+  size_t access = 0;
+  size_t base = 0;
+  size_t offset = 0;
+  long long first = 0;
+  long long field = 0;
+
+  if (access_type->kind != IR_TYPE_INT &&
+      access_type->kind != IR_TYPE_POINTER) {
+    return IR_LLVM_NO_NODE;
+  }
+  access = ir_llvm_tbaa_type(writer, access_type);
+  base = access;
+  if (access == IR_LLVM_NO_NODE) {
+    return IR_LLVM_NO_NODE;
+  }
+
+  if (gep && gep->opcode == IR_OP_GEP &&
+      gep->aux_type->kind == IR_TYPE_STRUCT && gep->operand_count == 3 &&
+      ir_value_is_const_int(gep->operands[1], &first) && first == 0 &&
+      ir_value_is_const_int(gep->operands[2], &field) && field >= 0 &&
+      (size_t)field < gep->aux_type->field_count) {
+    base = ir_llvm_tbaa_type(writer, gep->aux_type);
+    offset = ir_type_field_offset(gep->aux_type, (size_t)field);
+    if (base == IR_LLVM_NO_NODE) {
+      return IR_LLVM_NO_NODE;
+    }
+  }
+  return ir_llvm_tbaa_node(writer, IR_LLVM_TBAA_TAG, NULL, NULL, base, access,
+                           offset);
+}
+
+static void ir_llvm_tbaa_attach(IrLlvmWriter *writer, const IrValue *pointer) {
+  size_t tag = 0;
+
+  if (!writer->options->type_based_aliasing) {
+    return;
+  }
+  tag = ir_llvm_tbaa_tag(writer, pointer);
+  if (tag != IR_LLVM_NO_NODE) {
+    fprintf(writer->out, ", !tbaa !%zu", tag);
+  }
+}
+
+/*
+ * LLVM takes branch weights as i32. Like clang, scale the counts down to
+ * fit and add 1, so an edge that never ran still has a weight.
+ */
+static void ir_llvm_prof_attach(IrLlvmWriter *writer, const IrInstr *instr) {
+  unsigned long long largest = instr->branch_weights[0];
+  unsigned long long scale = 1;
+  IrLlvmNode key;
+
+  if (!instr->has_branch_weights) {
+    return;
+  }
+  if (instr->branch_weights[1] > largest) {
+    largest = instr->branch_weights[1];
+  }
+  if (largest >= 0xffffffffULL) {
+    scale = largest / 0xffffffffULL + 1;
+  }
+
+  memset(&key, 0, sizeof(key));
+  key.kind = IR_LLVM_PROF_BRANCH_WEIGHTS;
+  key.counts[0] = instr->branch_weights[0] / scale + 1;
+  key.counts[1] = instr->branch_weights[1] / scale + 1;
+  fprintf(writer->out, ", !prof !%zu", ir_llvm_node(writer, &key));
+}
+
+static size_t ir_llvm_debug_node(IrLlvmWriter *writer, IrLlvmNodeKind kind,
+                                 const char *name, size_t parent,
+                                 unsigned long long first,
+                                 unsigned long long second) {
+  IrLlvmNode key;
+
+  memset(&key, 0, sizeof(key));
+  key.kind = kind;
+  key.name = name;
+  key.parent = parent;
+  key.counts[0] = first;
+  key.counts[1] = second;
+  return ir_llvm_node(writer, &key);
+}
+
+static size_t ir_llvm_debug_unit(IrLlvmWriter *writer) {
+  size_t file = ir_llvm_debug_node(writer, IR_LLVM_DEBUG_FILE, NULL,
+                                   IR_LLVM_NO_NODE, 0, 0);
+
+  return ir_llvm_debug_node(writer, IR_LLVM_DEBUG_UNIT, NULL, file, 0, 0);
+}
+
+static size_t ir_llvm_debug_subprogram(IrLlvmWriter *writer,
+                                       const IrFunction *function) {
+  return ir_llvm_debug_node(writer, IR_LLVM_DEBUG_SUBPROGRAM, function->name,
+                            ir_llvm_debug_unit(writer), function->line,
+                            function->linkage == IR_LINKAGE_INTERNAL);
+}
+
+static void ir_llvm_debug_attach(IrLlvmWriter *writer, const IrInstr *instr) {
+  if (!writer->module->source_file || instr->loc.line == 0) {
+    return;
+  }
+  fprintf(writer->out, ", !dbg !%zu",
+          ir_llvm_debug_node(writer, IR_LLVM_DEBUG_LOCATION, NULL,
+                             writer->subprogram, instr->loc.line,
+                             instr->loc.column));
+}
+
+/* The named metadata that makes LLVM keep and emit the debug info. */
+static void ir_llvm_emit_debug_names(IrLlvmWriter *writer) {
+  size_t unit = ir_llvm_debug_unit(writer);
+  size_t dwarf = ir_llvm_debug_node(writer, IR_LLVM_MODULE_FLAG,
+                                    "Dwarf Version", IR_LLVM_NO_NODE, 7, 4);
+  size_t version =
+    ir_llvm_debug_node(writer, IR_LLVM_MODULE_FLAG, "Debug Info Version",
+                       IR_LLVM_NO_NODE, 2, 3);
+
+  fprintf(writer->out, "\n!llvm.dbg.cu = !{!%zu}\n", unit);
+  fprintf(writer->out, "!llvm.module.flags = !{!%zu, !%zu}\n", dwarf,
+          version);
+}
+
+static void ir_llvm_emit_nodes(IrLlvmWriter *writer) {
+  const IrModule *module = writer->module;
+  FILE *out = writer->out;
+  size_t index = 0;
+  size_t field = 0;
+
+  if (module->source_file) {
+    ir_llvm_emit_debug_names(writer);
+  }
+  if (writer->node_count > 0) {
+    fprintf(out, "\n");
+  }
+  for (index = 0; index < writer->node_count; index++) {
+    const IrLlvmNode *node = &writer->nodes[index];
+
+    fprintf(out, "!%zu = ", index);
+    switch (node->kind) {
+    case IR_LLVM_TBAA_ROOT:
+      fprintf(out, "!{!\"Simple C/C++ TBAA\"}");
+      break;
+    case IR_LLVM_TBAA_SCALAR:
+      fprintf(out, "!{!\"%s\", !%zu, i64 0}", node->name, node->parent);
+      break;
+    case IR_LLVM_TBAA_STRUCT:
+      fprintf(out, "!{!\"%s\"", node->type->name);
+      for (field = 0; field < node->type->field_count; field++) {
+        fprintf(out, ", !%zu, i64 %zu",
+                ir_llvm_tbaa_type(writer, node->type->fields[field]),
+                ir_type_field_offset(node->type, field));
+      }
+      fprintf(out, "}");
+      break;
+    case IR_LLVM_TBAA_TAG:
+      fprintf(out, "!{!%zu, !%zu, i64 %zu}", node->parent, node->access,
+              node->offset);
+      break;
+    case IR_LLVM_PROF_BRANCH_WEIGHTS:
+      fprintf(out, "!{!\"branch_weights\", i32 %llu, i32 %llu}",
+              node->counts[0], node->counts[1]);
+      break;
+    case IR_LLVM_PROF_ENTRY_COUNT:
+      fprintf(out, "!{!\"function_entry_count\", i64 %llu}", node->counts[0]);
+      break;
+    case IR_LLVM_DEBUG_FILE:
+      fprintf(out, "!DIFile(filename: \"%s\", directory: \"%s\")",
+              module->source_file, module->source_directory);
+      break;
+    case IR_LLVM_DEBUG_UNIT:
+      fprintf(out,
+              "distinct !DICompileUnit(language: DW_LANG_C99, file: !%zu, "
+              "producer: \"basecc\", isOptimized: false, runtimeVersion: 0, "
+              "emissionKind: LineTablesOnly)",
+              node->parent);
+      break;
+    case IR_LLVM_DEBUG_SUBPROGRAM:
+      fprintf(out,
+              "distinct !DISubprogram(name: \"%s\", scope: !%zu, file: !%zu, "
+              "line: %llu, type: !DISubroutineType(types: !{}), "
+              "scopeLine: %llu, spFlags: DISPFlagDefinition%s, unit: !%zu)",
+              node->name, writer->nodes[node->parent].parent,
+              writer->nodes[node->parent].parent, node->counts[0],
+              node->counts[0], node->counts[1] ? " | DISPFlagLocalToUnit" : "",
+              node->parent);
+      break;
+    case IR_LLVM_DEBUG_LOCATION:
+      fprintf(out, "!DILocation(line: %llu, column: %llu, scope: !%zu)",
+              node->counts[0], node->counts[1], node->parent);
+      break;
+    case IR_LLVM_MODULE_FLAG:
+      fprintf(out, "!{i32 %llu, !\"%s\", i32 %llu}", node->counts[0],
+              node->name, node->counts[1]);
+      break;
+    }
+    fprintf(out, "\n");
+  }
+}
+
+static void ir_llvm_instr(IrLlvmWriter *writer, const IrInstr *instr) {
+  IrValue *const *operands = instr->operands;
+  FILE *out = writer->out;
+  size_t index = 0;
+
+  fprintf(out, "  ");
+  if (ir_instr_has_result(instr)) {
+    fprintf(out, "%%t%d = ", instr->id);
+  }
+
+  switch (instr->opcode) {
+  case IR_OP_ALLOCA:
+    fprintf(out, "alloca ");
+    ir_llvm_type(instr->aux_type, out);
+    break;
+  case IR_OP_LOAD:
+    fprintf(out, "load ");
+    ir_llvm_type(instr->value.type, out);
+    fprintf(out, ", ");
+    ir_llvm_typed_value(operands[0], out);
+    ir_llvm_tbaa_attach(writer, operands[0]);
+    break;
+  case IR_OP_STORE:
+    fprintf(out, "store ");
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, ", ");
+    ir_llvm_typed_value(operands[1], out);
+    ir_llvm_tbaa_attach(writer, operands[1]);
+    break;
+  case IR_OP_GEP:
+    fprintf(out, "getelementptr%s ",
+            instr->flags & IR_FLAG_INBOUNDS ? " inbounds" : "");
+    ir_llvm_type(instr->aux_type, out);
+    for (index = 0; index < instr->operand_count; index++) {
+      fprintf(out, ", ");
+      ir_llvm_typed_value(operands[index], out);
+    }
+    break;
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+    fprintf(out, "%s%s ", ir_opcode_name(instr->opcode),
+            instr->flags & IR_FLAG_NSW ? " nsw" : "");
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, ", ");
+    ir_llvm_value(operands[1], out);
+    break;
+  case IR_OP_ICMP:
+    fprintf(out, "icmp %s ", ir_predicate_name(instr->predicate));
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, ", ");
+    ir_llvm_value(operands[1], out);
+    break;
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+  case IR_OP_BITCAST:
+    fprintf(out, "%s ", ir_opcode_name(instr->opcode));
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, " to ");
+    ir_llvm_type(instr->value.type, out);
+    break;
+  case IR_OP_CALL:
+    fprintf(out, "%scall %s",
+            instr->flags & IR_FLAG_MUSTTAIL ? "musttail "
+            : instr->flags & IR_FLAG_TAIL   ? "tail "
+                                            : "",
+            instr->calling_conv == IR_CC_FAST ? "fastcc " : "");
+    ir_llvm_type(instr->value.type, out);
+    fprintf(out, " ");
+    ir_llvm_value(operands[0], out);
+    fprintf(out, "(");
+    for (index = 1; index < instr->operand_count; index++) {
+      if (index > 1) {
+        fprintf(out, ", ");
+      }
+      ir_llvm_typed_value(operands[index], out);
+    }
+    fprintf(out, ")");
+    break;
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    if (instr->opcode == IR_OP_MEMSET) {
+      fprintf(out, "call void @llvm.memset.p0i8.i64(");
+      writer->uses_memset = 1;
+    } else {
+      fprintf(out, "call void @llvm.memcpy.p0i8.p0i8.i64(");
+      writer->uses_memcpy = 1;
+    }
+    for (index = 0; index < instr->operand_count; index++) {
+      ir_llvm_typed_value(operands[index], out);
+      fprintf(out, ", ");
+    }
+    fprintf(out, "i1 false)");
+    break;
+  case IR_OP_PHI:
+    fprintf(out, "phi ");
+    ir_llvm_type(instr->value.type, out);
+    for (index = 0; index < instr->operand_count; index++) {
+      fprintf(out, "%s[", index > 0 ? ", " : " ");
+      ir_llvm_value(operands[index], out);
+      fprintf(out, ", %%%s]", instr->blocks[index]->name);
+    }
+    break;
+  case IR_OP_BR:
+    fprintf(out, "br label %%%s", instr->blocks[0]->name);
+    break;
+  case IR_OP_CONDBR:
+    fprintf(out, "br ");
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, ", label %%%s, label %%%s", instr->blocks[0]->name,
+            instr->blocks[1]->name);
+    ir_llvm_prof_attach(writer, instr);
+    break;
+  case IR_OP_SWITCH:
+    fprintf(out, "switch ");
+    ir_llvm_typed_value(operands[0], out);
+    fprintf(out, ", label %%%s [", instr->blocks[0]->name);
+    for (index = 1; index < instr->operand_count; index++) {
+      fprintf(out, "\n    ");
+      ir_llvm_typed_value(operands[index], out);
+      fprintf(out, ", label %%%s", instr->blocks[index]->name);
+    }
+    fprintf(out, "\n  ]");
+    break;
+  case IR_OP_RET:
+    if (instr->operand_count == 0) {
+      fprintf(out, "ret void");
+    } else {
+      fprintf(out, "ret ");
+      ir_llvm_typed_value(operands[0], out);
+    }
+    break;
+  }
+
+  ir_llvm_debug_attach(writer, instr);
+  fprintf(out, "\n");
+}
+
+static void ir_llvm_return_type(const IrFunction *function, FILE *out) {
+  if (function->return_noundef &&
+      function->return_type->kind != IR_TYPE_VOID) {
+    fprintf(out, "noundef ");
+  }
+  ir_llvm_type(function->return_type, out);
+}
+
+static void ir_llvm_declare(const IrFunction *function, FILE *out) {
+  size_t index = 0;
+
+  fprintf(out, "declare ");
+  ir_llvm_return_type(function, out);
+  fprintf(out, " @%s(", function->name);
+  for (index = 0; index < function->param_count; index++) {
+    const IrParam *param = function->params[index];
+
+    if (index > 0) {
+      fprintf(out, ", ");
+    }
+    ir_llvm_type(param->value.type, out);
+    if (param->noundef) {
+      fprintf(out, " noundef");
+    }
+  }
+  fprintf(out, ")\n");
+}
+
+static void ir_llvm_define(IrLlvmWriter *writer, const IrFunction *function) {
+  FILE *out = writer->out;
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+
+  fprintf(out, "define%s%s%s ",
+          function->linkage == IR_LINKAGE_INTERNAL ? " internal" : "",
+          function->calling_conv == IR_CC_FAST ? " fastcc" : "",
+          function->dso_local ? " dso_local" : "");
+  ir_llvm_return_type(function, out);
+  fprintf(out, " @%s(", function->name);
+  for (index = 0; index < function->param_count; index++) {
+    const IrParam *param = function->params[index];
+
+    if (index > 0) {
+      fprintf(out, ", ");
+    }
+    ir_llvm_type(param->value.type, out);
+    fprintf(out, "%s%s %s%%%s", param->nocapture ? " nocapture" : "",
+            param->readonly ? " readonly" : "",
+            param->noundef ? "noundef " : "", param->name);
+  }
+  fprintf(out, ")");
+  if (function->unnamed_addr == IR_UNNAMED_ADDR_GLOBAL) {
+    fprintf(out, " unnamed_addr");
+  } else if (function->unnamed_addr == IR_UNNAMED_ADDR_LOCAL) {
+    fprintf(out, " local_unnamed_addr");
+  }
+  ir_dump_function_attrs(function, out);
+  if (function->has_entry_count) {
+    IrLlvmNode key;
+
+    memset(&key, 0, sizeof(key));
+    key.kind = IR_LLVM_PROF_ENTRY_COUNT;
+    key.counts[0] = function->entry_count;
+    fprintf(out, " !prof !%zu", ir_llvm_node(writer, &key));
+  }
+  if (writer->module->source_file) {
+    writer->subprogram = ir_llvm_debug_subprogram(writer, function);
+    fprintf(out, " !dbg !%zu", writer->subprogram);
+  }
+  fprintf(out, " {\n");
+
+  for (block = function->first_block; block; block = block->next) {
+    fprintf(out, "%s:\n", block->name);
+    for (instr = block->first; instr; instr = instr->next) {
+      ir_llvm_instr(writer, instr);
+    }
+  }
+  fprintf(out, "}\n");
+}
+
+static void ir_llvm_global(const IrGlobal *global, FILE *out) {
+  fprintf(out, "@%s = %s%s", global->name,
+          global->linkage == IR_LINKAGE_INTERNAL ? "internal " : "",
+          global->dso_local ? "dso_local " : "");
+  if (global->unnamed_addr == IR_UNNAMED_ADDR_GLOBAL) {
+    fprintf(out, "unnamed_addr ");
+  } else if (global->unnamed_addr == IR_UNNAMED_ADDR_LOCAL) {
+    fprintf(out, "local_unnamed_addr ");
+  }
+  fprintf(out, "%s ", global->is_constant ? "constant" : "global");
+  ir_llvm_type(global->value_type, out);
+  fprintf(out, " ");
+  ir_llvm_value(global->initializer, out);
+  fprintf(out, "\n");
+}
+
+int ir_llvm_emit(const IrModule *module, const IrLlvmOptions *options,
+                 FILE *out) {
+  IrLlvmWriter writer;
+  const IrGlobal *previous_global = NULL;
+  size_t index = 0;
+  size_t field = 0;
+
+  memset(&writer, 0, sizeof(writer));
+  writer.options = options;
+  writer.module = module;
+  writer.out = out;
+
+  fprintf(out, "; ModuleID = '%s'\n", module->name);
+  fprintf(out, "source_filename = \"%s\"\n\n", module->name);
+
+  for (index = 0; index < module->struct_count; index++) {
+    const IrType *type = module->structs[index];
+
+    if (!type->has_body) {
+      fprintf(out, "%%struct.%s = type opaque\n", type->name);
+      continue;
+    }
+
+    fprintf(out, "%%struct.%s = type { ", type->name);
+    for (field = 0; field < type->field_count; field++) {
+      if (field > 0) {
+        fprintf(out, ", ");
+      }
+      ir_llvm_type(type->fields[field], out);
+    }
+    fprintf(out, " }\n");
+  }
+
+  if (module->struct_count > 0) {
+    fprintf(out, "\n");
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    const IrFunction *function = module->symbols[index].function;
+
+    if (function && ir_function_is_declaration(function)) {
+      ir_llvm_declare(function, out);
+    }
+  }
+
+  for (index = 0; index < module->symbol_count; index++) {
+    const IrSymbol *symbol = &module->symbols[index];
+
+    if (symbol->kind == IR_SYMBOL_GLOBAL) {
+      ir_llvm_global(symbol->global, out);
+      previous_global = symbol->global;
+      continue;
+    }
+
+    if (ir_function_is_declaration(symbol->function)) {
+      continue;
+    }
+
+    /* Function-scope statics are set off from the body they belong to. */
+    if (previous_global && previous_global->owner == symbol->function) {
+      fprintf(out, "\n");
+    }
+    previous_global = NULL;
+    ir_llvm_define(&writer, symbol->function);
+  }
+
+  if (writer.uses_memset) {
+    fprintf(out, "declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, "
+                 "i8, i64, i1 immarg)\n");
+  }
+  if (writer.uses_memcpy) {
+    fprintf(out, "declare void @llvm.memcpy.p0i8.p0i8.i64(i8* noalias "
+                 "nocapture writeonly, i8* noalias nocapture readonly, i64, "
+                 "i1 immarg)\n");
+  }
+  ir_llvm_emit_nodes(&writer);
+  free(writer.nodes);
+  return ferror(out) || writer.out_of_memory ? 0 : 1;
+}
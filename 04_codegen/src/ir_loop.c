@@ -0,0 +1,314 @@
+#include "ir_loop.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void ir_loop_info_free(IrLoopInfo *info) {
+  size_t index = 0;
+
+  for (index = 0; index < info->count; index++) {
+    free(info->loops[index].blocks);
+    free(info->loops[index].contains);
+  }
+  free(info->loops);
+  info->loops = NULL;
+  info->count = 0;
+}
+
+int ir_loop_contains(const IrLoop *loop, const IrBlock *block) {
+  return loop->contains[block->index];
+}
+
+int ir_loop_is_invariant(const IrLoop *loop, const IrValue *value) {
+  return value->kind != IR_VALUE_INSTR ||
+         !ir_loop_contains(loop, value->instr->parent);
+}
+
+static int ir_loop_is_latch(const IrBlock *header, const IrBlock *pred) {
+  return pred->reachable && ir_block_dominates(header, pred);
+}
+
+/* The single outside predecessor that branches to the header alone. */
+static IrBlock *ir_loop_find_preheader(const IrBlock *header) {
+  IrBlock *preheader = NULL;
+  size_t index = 0;
+
+  for (index = 0; index < header->pred_count; index++) {
+    IrBlock *pred = header->preds[index];
+
+    if (ir_loop_is_latch(header, pred)) {
+      continue;
+    }
+    if (preheader) {
+      return NULL;
+    }
+    preheader = pred;
+  }
+
+  if (!preheader || ir_block_successor_count(preheader) != 1) {
+    return NULL;
+  }
+  return preheader;
+}
+
+/* "<header>.ph", or with a number after it when that name is taken. */
+static void ir_loop_preheader_name(const IrBlock *header, char *name,
+                                   size_t size) {
+  const IrBlock *block = NULL;
+  unsigned long suffix = 0;
+
+  snprintf(name, size, "%s.ph", header->name);
+  for (block = header->parent->first_block; block;) {
+    if (strcmp(block->name, name) != 0) {
+      block = block->next;
+      continue;
+    }
+    snprintf(name, size, "%s.ph%lu", header->name, ++suffix);
+    block = header->parent->first_block;
+  }
+}
+
+/*
+ * Routes every edge into the header from outside the loop through a new
+ * block. Phi values from those edges move to a phi in the new block, or
+ * stay a plain value when all of them agree.
+ */
+static int ir_loop_insert_preheader(IrBlock *header) {
+  IrFunction *function = header->parent;
+  char name[256];
+  IrBlock *preheader = NULL;
+  IrInstr *phi = NULL;
+  IrBuilder builder;
+  size_t index = 0;
+
+  ir_loop_preheader_name(header, name, sizeof(name));
+  preheader = ir_block_create(function, name);
+  if (!preheader) {
+    return 0;
+  }
+  ir_block_insert_after(preheader, header->prev);
+  ir_builder_init(&builder, function);
+  ir_builder_set_block(&builder, preheader);
+
+  for (phi = header->first; phi && phi->opcode == IR_OP_PHI; phi = phi->next) {
+    IrValue *merged = NULL;
+    IrValue *shared = NULL;
+    size_t outside = 0;
+    size_t kept = 0;
+
+    for (index = 0; index < phi->operand_count; index++) {
+      if (!ir_loop_is_latch(header, phi->blocks[index])) {
+        shared = outside == 0 || shared == phi->operands[index]
+                   ? phi->operands[index]
+                   : NULL;
+        outside++;
+      }
+    }
+
+    merged = shared;
+    if (!merged) {
+      merged = ir_build_phi(&builder, phi->value.type);
+      if (!merged) {
+        return 0;
+      }
+      for (index = 0; index < phi->operand_count; index++) {
+        if (!ir_loop_is_latch(header, phi->blocks[index]) &&
+            !ir_phi_add_incoming(merged->instr, phi->operands[index],
+                                 phi->blocks[index])) {
+          return 0;
+        }
+      }
+    }
+
+    /* Hold on to merged before the incoming edges let go of it. */
+    merged->use_count++;
+    for (index = 0; index < phi->operand_count; index++) {
+      if (!ir_loop_is_latch(header, phi->blocks[index])) {
+        phi->operands[index]->use_count--;
+        continue;
+      }
+      phi->operands[kept] = phi->operands[index];
+      phi->blocks[kept] = phi->blocks[index];
+      kept++;
+    }
+    phi->operand_count = kept;
+    phi->block_count = kept;
+    if (!ir_phi_add_incoming(phi, merged, preheader)) {
+      return 0;
+    }
+    merged->use_count--;
+  }
+
+  for (index = 0; index < header->pred_count; index++) {
+    IrBlock *pred = header->preds[index];
+    IrInstr *terminator = ir_block_terminator(pred);
+    size_t target = 0;
+
+    if (ir_loop_is_latch(header, pred)) {
+      continue;
+    }
+    for (target = 0; target < terminator->block_count; target++) {
+      if (terminator->blocks[target] == header) {
+        terminator->blocks[target] = preheader;
+      }
+    }
+  }
+
+  return ir_build_br(&builder, header) != NULL;
+}
+
+/* Gives every loop header a preheader; *inserted counts the new blocks. */
+static int ir_loop_simplify(IrFunction *function, size_t *inserted) {
+  IrBlock *header = NULL;
+  IrBlock *next = NULL;
+  size_t index = 0;
+
+  for (header = function->first_block; header; header = next) {
+    int has_latch = 0;
+
+    next = header->next;
+    for (index = 0; index < header->pred_count; index++) {
+      has_latch |= ir_loop_is_latch(header, header->preds[index]);
+    }
+    if (!header->reachable || !has_latch || ir_loop_find_preheader(header)) {
+      continue;
+    }
+    if (!ir_loop_insert_preheader(header)) {
+      return 0;
+    }
+    (*inserted)++;
+  }
+  return 1;
+}
+
+static int ir_loop_compare_rpo(const void *left, const void *right) {
+  const IrBlock *first = *(const IrBlock *const *)left;
+  const IrBlock *second = *(const IrBlock *const *)right;
+
+  return (first->rpo_index > second->rpo_index) -
+         (first->rpo_index < second->rpo_index);
+}
+
+static int ir_loop_compare_size(const void *left, const void *right) {
+  const IrLoop *first = left;
+  const IrLoop *second = right;
+
+  if (first->block_count != second->block_count) {
+    return (first->block_count > second->block_count) -
+           (first->block_count < second->block_count);
+  }
+  return (first->header->index > second->header->index) -
+         (first->header->index < second->header->index);
+}
+
+/* Collects the blocks of the loop headed by header into loop. */
+static int ir_loop_build(IrBlock *header, IrBlock **worklist, IrLoop *loop) {
+  IrFunction *function = header->parent;
+  IrBlock *block = NULL;
+  size_t latches = 0;
+  size_t pending = 0;
+  size_t index = 0;
+
+  memset(loop, 0, sizeof(*loop));
+  loop->header = header;
+  loop->contains = calloc(function->block_count + 1, 1);
+  loop->blocks = malloc((function->block_count + 1) * sizeof(*loop->blocks));
+  if (!loop->contains || !loop->blocks) {
+    return 0;
+  }
+
+  loop->contains[header->index] = 1;
+  for (index = 0; index < header->pred_count; index++) {
+    IrBlock *pred = header->preds[index];
+
+    if (!ir_loop_is_latch(header, pred)) {
+      continue;
+    }
+    loop->latch = latches++ == 0 ? pred : NULL;
+    if (!loop->contains[pred->index]) {
+      loop->contains[pred->index] = 1;
+      worklist[pending++] = pred;
+    }
+  }
+  while (pending > 0) {
+    block = worklist[--pending];
+    for (index = 0; index < block->pred_count; index++) {
+      IrBlock *pred = block->preds[index];
+
+      if (pred->reachable && !loop->contains[pred->index]) {
+        loop->contains[pred->index] = 1;
+        worklist[pending++] = pred;
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    if (loop->contains[block->index]) {
+      loop->blocks[loop->block_count++] = block;
+    }
+  }
+  qsort(loop->blocks, loop->block_count, sizeof(*loop->blocks),
+        ir_loop_compare_rpo);
+  loop->preheader = ir_loop_find_preheader(header);
+  return 1;
+}
+
+int ir_loop_info_compute(IrFunction *function, IrLoopInfo *info) {
+  IrBlock **worklist = NULL;
+  IrBlock *header = NULL;
+  size_t inserted = 0;
+  size_t index = 0;
+
+  info->loops = NULL;
+  info->count = 0;
+  if (!ir_function_compute_dominators(function) ||
+      !ir_loop_simplify(function, &inserted) ||
+      (inserted > 0 && !ir_function_compute_dominators(function))) {
+    return 0;
+  }
+
+  worklist = malloc((function->block_count + 1) * sizeof(*worklist));
+  info->loops = malloc((function->block_count + 1) * sizeof(*info->loops));
+  if (!worklist || !info->loops) {
+    free(worklist);
+    return 0;
+  }
+
+  for (header = function->first_block; header; header = header->next) {
+    int has_latch = 0;
+
+    for (index = 0; index < header->pred_count; index++) {
+      has_latch |= ir_loop_is_latch(header, header->preds[index]);
+    }
+    if (!header->reachable || !has_latch) {
+      continue;
+    }
+    if (!ir_loop_build(header, worklist, &info->loops[info->count++])) {
+      free(worklist);
+      ir_loop_info_free(info);
+      return 0;
+    }
+  }
+  free(worklist);
+
+  /* Smaller first puts every loop ahead of the loops around it. */
+  qsort(info->loops, info->count, sizeof(*info->loops), ir_loop_compare_size);
+  for (index = 0; index < info->count; index++) {
+    IrLoop *loop = &info->loops[index];
+    size_t outer = 0;
+
+    for (outer = index + 1; outer < info->count; outer++) {
+      if (ir_loop_contains(&info->loops[outer], loop->header)) {
+        loop->parent = &info->loops[outer];
+        break;
+      }
+    }
+  }
+  for (index = info->count; index-- > 0;) {
+    IrLoop *loop = &info->loops[index];
+
+    loop->depth = loop->parent ? loop->parent->depth + 1 : 1;
+  }
+  return 1;
+}
@@ -0,0 +1,550 @@
+#include "ir_loop.h"
+#include "ir_pass.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * A loop that does nothing but store to base[iv] on every trip, for an
+ * induction variable iv counting up by one from init while `iv predicate
+ * bound` holds: a memset when the stored value is invariant, a memcpy
+ * when it is loaded from source[iv].
+ */
+typedef struct IrLoopIdiom {
+  const IrLoop *loop;
+  IrBlock *exit;
+  IrInstr *iv;
+  IrValue *init;
+  IrValue *bound;
+  /* IR_PRED_SLT, IR_PRED_SLE, or IR_PRED_NE. */
+  IrPredicate predicate;
+  IrInstr *store;
+  /* The element type both addresses step over. */
+  IrType *element;
+  IrValue *destination;
+  /* memcpy only: the base the stored value is loaded from. */
+  IrValue *source;
+} IrLoopIdiom;
+
+static int ir_loop_idiom_in_loop(const IrLoop *loop, const IrValue *value) {
+  return value->kind == IR_VALUE_INSTR &&
+         ir_loop_contains(loop, value->instr->parent);
+}
+
+/* The base of `gep element, base, iv` in the loop, or NULL. */
+static IrValue *ir_loop_idiom_address(const IrLoopIdiom *idiom,
+                                      const IrValue *address) {
+  const IrInstr *gep = NULL;
+
+  if (!ir_loop_idiom_in_loop(idiom->loop, address)) {
+    return NULL;
+  }
+  gep = address->instr;
+  if (gep->opcode != IR_OP_GEP || gep->operand_count != 2 ||
+      gep->operands[1] != &idiom->iv->value ||
+      gep->aux_type != gep->value.type->element ||
+      gep->value.use_count != 1 ||
+      !ir_loop_is_invariant(idiom->loop, gep->operands[0])) {
+    return NULL;
+  }
+  return gep->operands[0];
+}
+
+/*
+ * The header phi must be the only one and go init, init + 1, ... with nsw,
+ * and the header must leave the loop once `iv predicate bound` fails.
+ * Compares of bound - iv against 0, as C's `for (; n - i; )`, count too.
+ */
+static int ir_loop_idiom_match_control(IrLoopIdiom *idiom) {
+  const IrLoop *loop = idiom->loop;
+  IrInstr *branch = ir_block_terminator(loop->header);
+  IrInstr *phi = loop->header->first;
+  IrInstr *next = NULL;
+  IrInstr *compare = NULL;
+  IrValue *left = NULL;
+  IrValue *right = NULL;
+  long long constant = 0;
+  size_t index = 0;
+  int stays = 0;
+
+  if (!branch || branch->opcode != IR_OP_CONDBR || !phi ||
+      phi->opcode != IR_OP_PHI || phi->next->opcode == IR_OP_PHI ||
+      phi->operand_count != 2 || phi->value.type->kind != IR_TYPE_INT) {
+    return 0;
+  }
+  for (index = 0; index < 2; index++) {
+    if (phi->blocks[index] == loop->preheader) {
+      idiom->init = phi->operands[index];
+    } else if (phi->blocks[index] == loop->latch &&
+               ir_loop_idiom_in_loop(loop, phi->operands[index])) {
+      next = phi->operands[index]->instr;
+    }
+  }
+  if (!idiom->init || !next || next->opcode != IR_OP_ADD ||
+      !(next->flags & IR_FLAG_NSW) || next->value.use_count != 1 ||
+      !ir_value_is_const_int(
+        next->operands[next->operands[0] == &phi->value ? 1 : 0], &constant) ||
+      constant != 1 ||
+      (next->operands[0] != &phi->value && next->operands[1] != &phi->value)) {
+    return 0;
+  }
+  idiom->iv = phi;
+
+  stays = ir_loop_contains(loop, branch->blocks[0]);
+  if (stays == ir_loop_contains(loop, branch->blocks[1]) ||
+      !ir_loop_idiom_in_loop(loop, branch->operands[0])) {
+    return 0;
+  }
+  idiom->exit = branch->blocks[stays ? 1 : 0];
+  compare = branch->operands[0]->instr;
+  if (compare->opcode != IR_OP_ICMP || compare->value.use_count != 1) {
+    return 0;
+  }
+  idiom->predicate = compare->predicate;
+  left = compare->operands[0];
+  right = compare->operands[1];
+
+  if (ir_value_is_const_int(right, &constant) && constant == 0 &&
+      (idiom->predicate == IR_PRED_EQ || idiom->predicate == IR_PRED_NE) &&
+      ir_loop_idiom_in_loop(loop, left) && left->instr->opcode == IR_OP_SUB &&
+      left->use_count == 1 && left->instr->operands[1] == &phi->value) {
+    right = left->instr->operands[0];
+    left = &phi->value;
+  } else if (right == &phi->value) {
+    right = left;
+    left = &phi->value;
+    idiom->predicate = idiom->predicate == IR_PRED_SGT   ? IR_PRED_SLT
+                       : idiom->predicate == IR_PRED_SGE ? IR_PRED_SLE
+                       : idiom->predicate == IR_PRED_SLT ? IR_PRED_SGT
+                       : idiom->predicate == IR_PRED_SLE ? IR_PRED_SGE
+                                                         : idiom->predicate;
+  }
+  if (left != &phi->value || !ir_loop_is_invariant(loop, right)) {
+    return 0;
+  }
+  if (!stays) {
+    idiom->predicate = idiom->predicate == IR_PRED_SGE   ? IR_PRED_SLT
+                       : idiom->predicate == IR_PRED_SGT ? IR_PRED_SLE
+                       : idiom->predicate == IR_PRED_EQ  ? IR_PRED_NE
+                                                         : IR_PRED_EQ;
+  }
+  idiom->bound = right;
+  return idiom->predicate == IR_PRED_SLT || idiom->predicate == IR_PRED_SLE ||
+         idiom->predicate == IR_PRED_NE;
+}
+
+/*
+ * Every block past the header must end in a plain branch, so each runs
+ * once per trip, and the only other instructions may be the store, its
+ * address, and the load and address it copies from.
+ */
+static int ir_loop_idiom_match_body(IrLoopIdiom *idiom) {
+  const IrLoop *loop = idiom->loop;
+  const IrInstr *instr = NULL;
+  size_t block = 0;
+  size_t stores = 0;
+  size_t loads = 0;
+
+  for (block = 0; block < loop->block_count; block++) {
+    const IrInstr *terminator = ir_block_terminator(loop->blocks[block]);
+
+    if (block > 0 && (!terminator || terminator->opcode != IR_OP_BR)) {
+      return 0;
+    }
+    for (instr = loop->blocks[block]->first; instr; instr = instr->next) {
+      switch (instr->opcode) {
+      case IR_OP_PHI:
+      case IR_OP_ADD:
+      case IR_OP_SUB:
+      case IR_OP_ICMP:
+      case IR_OP_GEP:
+      case IR_OP_BR:
+      case IR_OP_CONDBR:
+        break;
+      case IR_OP_STORE:
+        idiom->store = (IrInstr *)instr;
+        stores++;
+        break;
+      case IR_OP_LOAD:
+        loads++;
+        break;
+      default:
+        return 0;
+      }
+    }
+  }
+  if (stores != 1 || loads > 1) {
+    return 0;
+  }
+
+  idiom->element = idiom->store->operands[0]->type;
+  idiom->destination =
+    ir_loop_idiom_address(idiom, idiom->store->operands[1]);
+  if (!idiom->destination) {
+    return 0;
+  }
+  if (loads == 0) {
+    return ir_loop_is_invariant(loop, idiom->store->operands[0]);
+  }
+  if (!ir_loop_idiom_in_loop(loop, idiom->store->operands[0]) ||
+      idiom->store->operands[0]->instr->opcode != IR_OP_LOAD ||
+      idiom->store->operands[0]->use_count != 1) {
+    return 0;
+  }
+  idiom->source = ir_loop_idiom_address(
+    idiom, idiom->store->operands[0]->instr->operands[0]);
+  return idiom->source != NULL;
+}
+
+/*
+ * The byte every byte of the stored value equals, for memset: an i8 is
+ * one already, and constants qualify when their bytes all agree.
+ */
+static IrValue *ir_loop_idiom_byte(IrFunction *function,
+                                   const IrLoopIdiom *idiom) {
+  IrValue *value = idiom->store->operands[0];
+  IrType *byte = ir_type_int(function->module, 8);
+  unsigned long long bits = 0;
+  size_t size = ir_type_size(value->type);
+  size_t index = 0;
+  long long constant = 0;
+
+  if (value->kind == IR_VALUE_NULL || value->kind == IR_VALUE_ZERO) {
+    return ir_const_int(function->module, byte, 0);
+  }
+  if (ir_type_is_int(value->type, 8)) {
+    return value;
+  }
+  if (!ir_value_is_const_int(value, &constant)) {
+    return NULL;
+  }
+  bits = (unsigned long long)constant;
+  for (index = 1; index < size; index++) {
+    if (((bits >> (index * 8)) & 0xff) != (bits & 0xff)) {
+      return NULL;
+    }
+  }
+  return ir_const_int(function->module, byte, (signed char)(bits & 0xff));
+}
+
+/* Whether no instruction outside the loop reads a value made in it. */
+static int ir_loop_idiom_is_closed(const IrFunction *function,
+                                   const IrLoop *loop) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    if (ir_loop_contains(loop, block)) {
+      continue;
+    }
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        if (ir_loop_idiom_in_loop(loop, instr->operands[index])) {
+          return 0;
+        }
+      }
+    }
+  }
+  return 1;
+}
+
+/* The alloca or global an address points into, or the address itself. */
+static const IrValue *ir_loop_idiom_root(const IrValue *address) {
+  while (address->kind == IR_VALUE_INSTR &&
+         (address->instr->opcode == IR_OP_GEP ||
+          address->instr->opcode == IR_OP_BITCAST)) {
+    address = address->instr->operands[0];
+  }
+  return address;
+}
+
+/*
+ * Whether the copy's two arrays are known apart: distinct allocas and
+ * globals never overlap, and nothing the caller passed in can point into
+ * an alloca of this call.
+ */
+static int ir_loop_idiom_disjoint(const IrLoopIdiom *idiom) {
+  const IrValue *roots[2];
+  int allocas[2];
+  int objects[2];
+  size_t index = 0;
+
+  roots[0] = ir_loop_idiom_root(idiom->destination);
+  roots[1] = ir_loop_idiom_root(idiom->source);
+  for (index = 0; index < 2; index++) {
+    allocas[index] = roots[index]->kind == IR_VALUE_INSTR &&
+                     roots[index]->instr->opcode == IR_OP_ALLOCA;
+    objects[index] = allocas[index] || roots[index]->kind == IR_VALUE_GLOBAL;
+  }
+  if (roots[0] == roots[1]) {
+    return 0;
+  }
+  return (objects[0] && objects[1]) ||
+         (allocas[0] && roots[1]->kind == IR_VALUE_PARAM) ||
+         (allocas[1] && roots[0]->kind == IR_VALUE_PARAM);
+}
+
+/* "<header>.<suffix>", or with a number after it when that name is taken. */
+static IrBlock *ir_loop_idiom_block(IrFunction *function,
+                                    const IrBlock *header, const char *suffix,
+                                    IrBlock *after) {
+  const IrBlock *block = NULL;
+  IrBlock *created = NULL;
+  unsigned long number = 0;
+  char name[256];
+
+  snprintf(name, sizeof(name), "%s.%s", header->name, suffix);
+  for (block = function->first_block; block;) {
+    if (strcmp(block->name, name) != 0) {
+      block = block->next;
+      continue;
+    }
+    snprintf(name, sizeof(name), "%s.%s%lu", header->name, suffix, ++number);
+    block = function->first_block;
+  }
+
+  created = ir_block_create(function, name);
+  if (created) {
+    ir_block_insert_after(created, after);
+  }
+  return created;
+}
+
+static IrValue *ir_loop_idiom_widen(IrBuilder *builder, IrValue *value) {
+  IrType *type = ir_type_int(builder->module, 64);
+  long long constant = 0;
+
+  if (ir_value_is_const_int(value, &constant)) {
+    return ir_const_int(builder->module, type, constant);
+  }
+  if (value->type == type) {
+    return value;
+  }
+  return ir_build_cast(builder, IR_OP_SEXT, value, type);
+}
+
+/* left opcode right in i64, folded when both are constants. */
+static IrValue *ir_loop_idiom_arith(IrBuilder *builder, IrOpcode opcode,
+                                    IrValue *left, IrValue *right) {
+  long long a = 0;
+  long long b = 0;
+
+  if (!left || !right) {
+    return NULL;
+  }
+  if (!ir_value_is_const_int(right, &b)) {
+    return ir_build_binary(builder, opcode, 0, left, right);
+  }
+  if (opcode == IR_OP_SUB && b == 0) {
+    return left;
+  }
+  if (!ir_value_is_const_int(left, &a)) {
+    return ir_build_binary(builder, opcode, 0, left, right);
+  }
+  return ir_const_int(builder->module, left->type,
+                      opcode == IR_OP_SUB   ? a - b
+                      : opcode == IR_OP_ADD ? a + b
+                                            : a * b);
+}
+
+/* &base[init] as an i8*. */
+static IrValue *ir_loop_idiom_start(IrBuilder *builder,
+                                    const IrLoopIdiom *idiom, IrValue *base) {
+  IrType *bytes =
+    ir_type_pointer(builder->module, ir_type_int(builder->module, 8));
+  IrValue *index = idiom->init;
+  long long constant = 0;
+
+  if (!ir_value_is_const_int(index, &constant) || constant != 0) {
+    base = ir_build_gep(builder, IR_FLAG_INBOUNDS, idiom->element, base,
+                        &index, 1);
+  }
+  if (base && base->type != bytes) {
+    base = ir_build_cast(builder, IR_OP_BITCAST, base, bytes);
+  }
+  return base;
+}
+
+/*
+ * Gives the exit's phis the value they take from the header on a new edge
+ * from block.
+ */
+static int ir_loop_idiom_add_exit_edge(const IrLoopIdiom *idiom,
+                                       IrBlock *block) {
+  IrInstr *phi = NULL;
+  size_t index = 0;
+
+  for (phi = idiom->exit->first; phi && phi->opcode == IR_OP_PHI;
+       phi = phi->next) {
+    for (index = 0; index < phi->operand_count; index++) {
+      if (phi->blocks[index] == idiom->loop->header) {
+        break;
+      }
+    }
+    if (index == phi->operand_count ||
+        !ir_phi_add_incoming(phi, phi->operands[index], block)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Replaces the loop: the preheader tests the header's condition for the
+ * first trip and either skips to the exit or computes the length and
+ * makes the one call. A memcpy between arrays that may overlap is guarded
+ * by a run-time check that falls back on the loop.
+ */
+static int ir_loop_idiom_rewrite(IrFunction *function,
+                                 const IrLoopIdiom *idiom, IrValue *byte) {
+  const IrLoop *loop = idiom->loop;
+  IrModule *module = function->module;
+  IrType *i64 = ir_type_int(module, 64);
+  IrBlock *setup = NULL;
+  IrBlock *call = NULL;
+  IrValue *first = NULL;
+  IrValue *length = NULL;
+  IrValue *destination = NULL;
+  IrValue *source = NULL;
+  IrValue *done = NULL;
+  IrInstr *phi = NULL;
+  IrBuilder builder;
+  long long init = 0;
+  long long bound = 0;
+  size_t index = 0;
+  int guarded = idiom->source && !ir_loop_idiom_disjoint(idiom);
+
+  setup = ir_loop_idiom_block(function, loop->header, "idiom", loop->preheader);
+  call = !guarded ? setup
+                  : ir_loop_idiom_block(function, loop->header, "copy", setup);
+  if (!setup || !call) {
+    return 0;
+  }
+
+  ir_builder_init(&builder, function);
+  ir_builder_set_block(&builder, loop->preheader);
+  ir_instr_remove(ir_block_terminator(loop->preheader));
+  if (ir_value_is_const_int(idiom->init, &init) &&
+      ir_value_is_const_int(idiom->bound, &bound) &&
+      (idiom->predicate == IR_PRED_SLT   ? init < bound
+       : idiom->predicate == IR_PRED_SLE ? init <= bound
+                                         : init != bound)) {
+    if (!ir_build_br(&builder, setup)) {
+      return 0;
+    }
+  } else {
+    first =
+      ir_build_icmp(&builder, idiom->predicate, idiom->init, idiom->bound);
+    if (!first || !ir_build_condbr(&builder, first, setup, idiom->exit) ||
+        !ir_loop_idiom_add_exit_edge(idiom, loop->preheader)) {
+      return 0;
+    }
+  }
+
+  /* bound - init trips, one more when the last test is <=. */
+  ir_builder_set_block(&builder, setup);
+  length = ir_loop_idiom_arith(&builder, IR_OP_SUB,
+                               ir_loop_idiom_widen(&builder, idiom->bound),
+                               ir_loop_idiom_widen(&builder, idiom->init));
+  if (idiom->predicate == IR_PRED_SLE) {
+    length = ir_loop_idiom_arith(&builder, IR_OP_ADD, length,
+                                 ir_const_int(module, i64, 1));
+  }
+  if (ir_type_size(idiom->element) != 1) {
+    length = ir_loop_idiom_arith(
+      &builder, IR_OP_MUL, length,
+      ir_const_int(module, i64, (long long)ir_type_size(idiom->element)));
+  }
+  destination = ir_loop_idiom_start(&builder, idiom, idiom->destination);
+  source = idiom->source ? ir_loop_idiom_start(&builder, idiom, idiom->source)
+                         : NULL;
+  if (!length || !destination || (idiom->source && !source)) {
+    return 0;
+  }
+
+  if (guarded) {
+    /* Apart when each start is at least length bytes past the other. */
+    IrValue *to = ir_build_cast(&builder, IR_OP_PTRTOINT, destination, i64);
+    IrValue *from = ir_build_cast(&builder, IR_OP_PTRTOINT, source, i64);
+    IrValue *after = ir_build_icmp(
+      &builder, IR_PRED_UGE, ir_build_binary(&builder, IR_OP_SUB, 0, to, from),
+      length);
+    IrValue *before = ir_build_icmp(
+      &builder, IR_PRED_UGE, ir_build_binary(&builder, IR_OP_SUB, 0, from, to),
+      length);
+    IrValue *apart = ir_build_binary(&builder, IR_OP_AND, 0, after, before);
+
+    if (!apart || !ir_build_condbr(&builder, apart, call, loop->header)) {
+      return 0;
+    }
+    for (phi = loop->header->first; phi && phi->opcode == IR_OP_PHI;
+         phi = phi->next) {
+      for (index = 0; index < phi->block_count; index++) {
+        if (phi->blocks[index] == loop->preheader) {
+          phi->blocks[index] = setup;
+        }
+      }
+    }
+    ir_builder_set_block(&builder, call);
+  }
+
+  done = idiom->source
+           ? ir_build_memcpy(&builder, destination, source, length)
+           : ir_build_memset(&builder, destination, byte, length);
+  return done && ir_build_br(&builder, idiom->exit) &&
+         ir_loop_idiom_add_exit_edge(idiom, call);
+}
+
+/*
+ * Loop idiom recognition: a counted loop that only fills an array with
+ * one byte pattern becomes a memset, and one that only copies an array
+ * element by element becomes a memcpy. Loops whose values are used after
+ * them are left alone; run mem2reg and licm first so the loop is bare.
+ */
+int ir_loop_idiom_function(IrFunction *function, size_t *changes) {
+  IrLoopInfo info;
+  size_t index = 0;
+  size_t other = 0;
+  size_t replaced = 0;
+  size_t removed = 0;
+
+  if (!ir_loop_info_compute(function, &info)) {
+    return 0;
+  }
+
+  /*
+   * Innermost loops never share blocks, so each rewrite leaves the others
+   * as the loop info describes them.
+   */
+  for (index = 0; index < info.count; index++) {
+    IrLoopIdiom idiom;
+    IrValue *byte = NULL;
+
+    for (other = 0; other < info.count; other++) {
+      if (info.loops[other].parent == &info.loops[index]) {
+        break;
+      }
+    }
+    memset(&idiom, 0, sizeof(idiom));
+    idiom.loop = &info.loops[index];
+    if (other < info.count || !idiom.loop->preheader || !idiom.loop->latch ||
+        !ir_loop_idiom_match_control(&idiom) ||
+        !ir_loop_idiom_match_body(&idiom) ||
+        !ir_loop_idiom_is_closed(function, idiom.loop)) {
+      continue;
+    }
+    if (!idiom.source && !(byte = ir_loop_idiom_byte(function, &idiom))) {
+      continue;
+    }
+    if (!ir_loop_idiom_rewrite(function, &idiom, byte)) {
+      ir_loop_info_free(&info);
+      return 0;
+    }
+    replaced++;
+  }
+
+  ir_loop_info_free(&info);
+  *changes += replaced;
+  return replaced == 0 || ir_unreachable_function(function, &removed);
+}
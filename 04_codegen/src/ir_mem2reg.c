@@ -0,0 +1,482 @@
+#include "ir_pass.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The state of one run over a function. Blocks are numbered by
+ * ir_function_build_cfg, values by instruction id; vars are the allocas
+ * being promoted.
+ */
+typedef struct IrMem2Reg {
+  IrFunction *function;
+  IrBlock **blocks;
+  size_t block_count;
+  /* block_count by block_count: frontier[b * block_count + f]. */
+  char *frontier;
+  /* Dominator tree children, children_of[b] into children. */
+  IrBlock **children;
+  size_t *children_of;
+  IrInstr **vars;
+  size_t var_count;
+  /* By instruction id: the var of an alloca or inserted phi, or -1. */
+  long *var_of;
+  /* By instruction id: what a load of a var reads. */
+  IrValue **replacement;
+  size_t id_count;
+  /* The value each var holds at the point the renaming has reached. */
+  IrValue **current;
+} IrMem2Reg;
+
+static void ir_mem2reg_free(IrMem2Reg *state) {
+  free(state->blocks);
+  free(state->frontier);
+  free(state->children);
+  free(state->children_of);
+  free(state->vars);
+  free(state->var_of);
+  free(state->replacement);
+  free(state->current);
+}
+
+/* The var an address names, if it is an alloca being promoted. */
+static long ir_mem2reg_var(const IrMem2Reg *state, const IrValue *address) {
+  if (address->kind != IR_VALUE_INSTR ||
+      address->instr->opcode != IR_OP_ALLOCA ||
+      (size_t)address->instr->id >= state->id_count) {
+    return -1;
+  }
+  return state->var_of[address->instr->id];
+}
+
+/*
+ * Scalar allocas whose address is only ever loaded from or stored to.
+ * Anything else, a GEP, a call argument, or the address being stored
+ * somewhere, keeps the alloca in memory.
+ */
+static int ir_mem2reg_find_vars(IrMem2Reg *state) {
+  IrFunction *function = state->function;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t index = 0;
+
+  state->id_count = (size_t)function->next_value_id;
+  state->var_of = malloc((state->id_count + 1) * sizeof(*state->var_of));
+  if (!state->var_of) {
+    return 0;
+  }
+  for (index = 0; index < state->id_count; index++) {
+    state->var_of[index] = -1;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      if (instr->opcode == IR_OP_ALLOCA &&
+          (instr->aux_type->kind == IR_TYPE_INT ||
+           instr->aux_type->kind == IR_TYPE_POINTER)) {
+        state->var_of[instr->id] = 0;
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *operand = instr->operands[index];
+
+        if (operand->kind != IR_VALUE_INSTR ||
+            operand->instr->opcode != IR_OP_ALLOCA ||
+            (instr->opcode == IR_OP_LOAD && index == 0) ||
+            (instr->opcode == IR_OP_STORE && index == 1)) {
+          continue;
+        }
+        state->var_of[operand->instr->id] = -1;
+      }
+    }
+  }
+
+  state->vars = malloc((state->id_count + 1) * sizeof(*state->vars));
+  if (!state->vars) {
+    return 0;
+  }
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      if (instr->opcode == IR_OP_ALLOCA && state->var_of[instr->id] == 0) {
+        state->var_of[instr->id] = (long)state->var_count;
+        state->vars[state->var_count++] = instr;
+      }
+    }
+  }
+  return 1;
+}
+
+/* Dominance frontiers and dominator tree children, after Cooper et al. */
+static int ir_mem2reg_build_tree(IrMem2Reg *state) {
+  IrFunction *function = state->function;
+  size_t count = function->block_count;
+  size_t *fill = NULL;
+  IrBlock *block = NULL;
+  size_t index = 0;
+
+  state->block_count = count;
+  state->blocks = malloc(count * sizeof(*state->blocks));
+  state->frontier = calloc(count * count, 1);
+  state->children = malloc(count * sizeof(*state->children));
+  state->children_of = calloc(count + 1, sizeof(*state->children_of));
+  fill = calloc(count + 1, sizeof(*fill));
+  if (!state->blocks || !state->frontier || !state->children ||
+      !state->children_of || !fill) {
+    free(fill);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    state->blocks[block->index] = block;
+    if (block->reachable && block->idom) {
+      state->children_of[block->idom->index + 1]++;
+    }
+  }
+  for (index = 0; index < count; index++) {
+    state->children_of[index + 1] += state->children_of[index];
+  }
+  for (block = function->first_block; block; block = block->next) {
+    if (block->reachable && block->idom) {
+      size_t parent = block->idom->index;
+
+      state->children[state->children_of[parent] + fill[parent]++] = block;
+    }
+  }
+  free(fill);
+
+  for (block = function->first_block; block; block = block->next) {
+    if (!block->reachable || block->pred_count < 2) {
+      continue;
+    }
+    for (index = 0; index < block->pred_count; index++) {
+      IrBlock *runner = block->preds[index];
+
+      if (!runner->reachable) {
+        continue;
+      }
+      while (runner && runner != block->idom) {
+        state->frontier[runner->index * count + block->index] = 1;
+        runner = runner->idom;
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+ * Places a phi for var at the top of every block in the iterated frontier
+ * of its stores where the var is still live, so no phi is left unused.
+ */
+static int ir_mem2reg_place_phis(IrMem2Reg *state, size_t var, char *defines,
+                                 char *live_in, char *has_phi,
+                                 IrBlock **worklist) {
+  IrInstr *alloca = state->vars[var];
+  IrFunction *function = state->function;
+  size_t count = state->block_count;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t pending = 0;
+  size_t index = 0;
+
+  memset(defines, 0, count);
+  memset(live_in, 0, count);
+  memset(has_phi, 0, count);
+
+  /* Stores define the var; a load before any store reads it live in. */
+  for (block = function->first_block; block; block = block->next) {
+    if (!block->reachable) {
+      continue;
+    }
+    for (instr = block->first; instr; instr = instr->next) {
+      if (instr->opcode == IR_OP_STORE &&
+          instr->operands[1] == &alloca->value) {
+        defines[block->index] = 1;
+      } else if (instr->opcode == IR_OP_LOAD &&
+                 instr->operands[0] == &alloca->value &&
+                 !defines[block->index] && !live_in[block->index]) {
+        live_in[block->index] = 1;
+        worklist[pending++] = block;
+      }
+    }
+  }
+  while (pending > 0) {
+    block = worklist[--pending];
+    for (index = 0; index < block->pred_count; index++) {
+      IrBlock *pred = block->preds[index];
+
+      if (pred->reachable && !defines[pred->index] && !live_in[pred->index]) {
+        live_in[pred->index] = 1;
+        worklist[pending++] = pred;
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    if (defines[block->index]) {
+      worklist[pending++] = block;
+    }
+  }
+  while (pending > 0) {
+    size_t source = worklist[--pending]->index;
+
+    for (index = 0; index < count; index++) {
+      IrBlock *target = state->blocks[index];
+      IrBuilder builder;
+      IrValue *phi = NULL;
+
+      if (!state->frontier[source * count + index] || has_phi[index] ||
+          !live_in[index]) {
+        continue;
+      }
+      has_phi[index] = 1;
+
+      ir_builder_init(&builder, function);
+      ir_builder_set_block(&builder, target);
+      phi = ir_build_phi(&builder, alloca->aux_type);
+      if (!phi) {
+        return 0;
+      }
+      ir_instr_move_before(phi->instr, target->first);
+      if (!defines[index]) {
+        defines[index] = 1;
+        worklist[pending++] = target;
+      }
+    }
+  }
+  return 1;
+}
+
+static IrValue *ir_mem2reg_zero(IrFunction *function, IrType *type) {
+  if (type->kind == IR_TYPE_POINTER) {
+    return ir_const_null(function->module, type);
+  }
+  return ir_const_int(function->module, type, 0);
+}
+
+/* The value a var holds so far, zero if nothing was stored yet. */
+static IrValue *ir_mem2reg_current(IrMem2Reg *state, size_t var) {
+  if (!state->current[var]) {
+    state->current[var] =
+      ir_mem2reg_zero(state->function, state->vars[var]->aux_type);
+  }
+  return state->current[var];
+}
+
+/*
+ * Walks the dominator tree from block, recording what each load of a var
+ * reads and giving the phis of each successor their incoming values.
+ */
+static int ir_mem2reg_rename(IrMem2Reg *state, IrBlock *block) {
+  IrValue **saved = malloc((state->var_count + 1) * sizeof(*saved));
+  IrInstr *instr = NULL;
+  size_t index = 0;
+  long var = 0;
+
+  if (!saved) {
+    return 0;
+  }
+  memcpy(saved, state->current, state->var_count * sizeof(*saved));
+
+  for (instr = block->first; instr; instr = instr->next) {
+    if (instr->opcode == IR_OP_PHI) {
+      if ((size_t)instr->id < state->id_count) {
+        continue;
+      }
+      var = state->var_of[instr->id];
+      state->current[var] = &instr->value;
+    } else if (instr->opcode == IR_OP_LOAD) {
+      var = ir_mem2reg_var(state, instr->operands[0]);
+      if (var >= 0) {
+        state->replacement[instr->id] = ir_mem2reg_current(state, (size_t)var);
+      }
+    } else if (instr->opcode == IR_OP_STORE) {
+      var = ir_mem2reg_var(state, instr->operands[1]);
+      if (var >= 0) {
+        state->current[var] = instr->operands[0];
+      }
+    }
+  }
+
+  for (index = 0; index < ir_block_successor_count(block); index++) {
+    IrBlock *successor = ir_block_successor(block, index);
+    size_t earlier = 0;
+
+    /* A block that branches to the same place twice is one incoming edge. */
+    while (earlier < index && ir_block_successor(block, earlier) != successor) {
+      earlier++;
+    }
+    if (earlier < index) {
+      continue;
+    }
+    for (instr = successor->first; instr && instr->opcode == IR_OP_PHI;
+         instr = instr->next) {
+      if ((size_t)instr->id < state->id_count) {
+        continue;
+      }
+      var = state->var_of[instr->id];
+      if (!ir_phi_add_incoming(instr, ir_mem2reg_current(state, (size_t)var),
+                               block)) {
+        free(saved);
+        return 0;
+      }
+    }
+  }
+
+  for (index = state->children_of[block->index];
+       index < state->children_of[block->index + 1]; index++) {
+    if (!ir_mem2reg_rename(state, state->children[index])) {
+      free(saved);
+      return 0;
+    }
+  }
+
+  memcpy(state->current, saved, state->var_count * sizeof(*saved));
+  free(saved);
+  return 1;
+}
+
+/* What a value stands for once the loads of vars are gone. */
+static IrValue *ir_mem2reg_resolve(const IrMem2Reg *state, IrValue *value) {
+  while (value->kind == IR_VALUE_INSTR &&
+         value->instr->opcode == IR_OP_LOAD &&
+         (size_t)value->instr->id < state->id_count &&
+         state->replacement[value->instr->id]) {
+    value = state->replacement[value->instr->id];
+  }
+  return value;
+}
+
+/* Rewrites uses of the loads, then drops the loads, stores, and allocas. */
+static int ir_mem2reg_rewrite(IrMem2Reg *state, size_t *changes) {
+  IrFunction *function = state->function;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  size_t index = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      /* Loads the renaming never reached sit in unreachable blocks. */
+      if (instr->opcode == IR_OP_LOAD &&
+          ir_mem2reg_var(state, instr->operands[0]) >= 0 &&
+          !state->replacement[instr->id]) {
+        state->replacement[instr->id] =
+          ir_mem2reg_zero(function, instr->value.type);
+      }
+      /* So do the predecessors that gave an inserted phi no value. */
+      if (instr->opcode == IR_OP_PHI &&
+          (size_t)instr->id >= state->id_count) {
+        for (index = 0; index < block->pred_count; index++) {
+          IrBlock *pred = block->preds[index];
+
+          if (!pred->reachable &&
+              !ir_phi_add_incoming(
+                instr, ir_mem2reg_zero(function, instr->value.type), pred)) {
+            return 0;
+          }
+        }
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        IrValue *operand = ir_mem2reg_resolve(state, instr->operands[index]);
+
+        if (operand != instr->operands[index]) {
+          ir_instr_set_operand(instr, index, operand);
+        }
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = next) {
+      next = instr->next;
+      if ((instr->opcode == IR_OP_LOAD &&
+           ir_mem2reg_var(state, instr->operands[0]) >= 0) ||
+          (instr->opcode == IR_OP_STORE &&
+           ir_mem2reg_var(state, instr->operands[1]) >= 0)) {
+        ir_instr_remove(instr);
+      }
+    }
+  }
+  for (index = 0; index < state->var_count; index++) {
+    ir_instr_remove(state->vars[index]);
+    (*changes)++;
+  }
+  return 1;
+}
+
+/*
+ * Promotes allocas to SSA values: phis go where stores to the same alloca
+ * meet, then a walk down the dominator tree replaces each load with the
+ * value that reaches it. A load that nothing was stored before reads 0.
+ */
+int ir_mem2reg_function(IrFunction *function, size_t *changes) {
+  IrMem2Reg state;
+  char *scratch = NULL;
+  IrBlock **worklist = NULL;
+  size_t index = 0;
+  long *var_of = NULL;
+  int ok = 0;
+
+  memset(&state, 0, sizeof(state));
+  state.function = function;
+  if (!ir_function_compute_dominators(function) ||
+      !ir_mem2reg_find_vars(&state)) {
+    ir_mem2reg_free(&state);
+    return 0;
+  }
+  if (state.var_count == 0) {
+    ir_mem2reg_free(&state);
+    return 1;
+  }
+
+  scratch = malloc(function->block_count * 3 + 1);
+  worklist = malloc((function->block_count + 1) * sizeof(*worklist));
+  if (!scratch || !worklist || !ir_mem2reg_build_tree(&state)) {
+    goto cleanup;
+  }
+
+  for (index = 0; index < state.var_count; index++) {
+    size_t before = (size_t)function->next_value_id;
+    size_t id = 0;
+
+    if (!ir_mem2reg_place_phis(&state, index, scratch,
+                               scratch + function->block_count,
+                               scratch + function->block_count * 2, worklist)) {
+      goto cleanup;
+    }
+    /* Inserted phis are numbered after every existing instruction. */
+    var_of = realloc(state.var_of,
+                     ((size_t)function->next_value_id + 1) * sizeof(*var_of));
+    if (!var_of) {
+      goto cleanup;
+    }
+    state.var_of = var_of;
+    for (id = before; id < (size_t)function->next_value_id; id++) {
+      state.var_of[id] = (long)index;
+    }
+  }
+
+  state.replacement = calloc(state.id_count + 1, sizeof(*state.replacement));
+  state.current = calloc(state.var_count + 1, sizeof(*state.current));
+  if (!state.replacement || !state.current ||
+      !ir_mem2reg_rename(&state, function->first_block) ||
+      !ir_mem2reg_rewrite(&state, changes)) {
+    goto cleanup;
+  }
+  ok = 1;
+
+cleanup:
+  free(scratch);
+  free(worklist);
+  ir_mem2reg_free(&state);
+  return ok;
+}
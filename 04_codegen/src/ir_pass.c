@@ -0,0 +1,227 @@
+#include "ir_pass.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Removes instructions whose results are unused and that have no effects. */
+static int ir_pass_dce(IrFunction *function, size_t *changes) {
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *prev = NULL;
+  int changed = 1;
+
+  while (changed) {
+    changed = 0;
+    for (block = function->first_block; block; block = block->next) {
+      /* Walk backwards so a chain of dead values goes in one sweep. */
+      for (instr = block->last; instr; instr = prev) {
+        prev = instr->prev;
+        if (ir_instr_has_result(instr) && instr->value.use_count == 0 &&
+            !ir_instr_has_side_effects(instr)) {
+          ir_instr_remove(instr);
+          (*changes)++;
+          changed = 1;
+        }
+      }
+    }
+  }
+
+  return 1;
+}
+
+int ir_unreachable_function(IrFunction *function, size_t *changes) {
+  IrBlock *block = NULL;
+  IrBlock *next = NULL;
+  size_t index = 0;
+
+  if (!ir_function_build_cfg(function)) {
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = next) {
+    next = block->next;
+    if (block->reachable) {
+      continue;
+    }
+
+    for (index = 0; index < ir_block_successor_count(block); index++) {
+      IrBlock *successor = ir_block_successor(block, index);
+      IrInstr *instr = NULL;
+
+      for (instr = successor->first; instr && instr->opcode == IR_OP_PHI;
+           instr = instr->next) {
+        ir_phi_remove_incoming(instr, block);
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = next) {
+    next = block->next;
+    if (!block->reachable) {
+      ir_block_remove(block);
+      (*changes)++;
+    }
+  }
+
+  return ir_function_build_cfg(function);
+}
+
+static const IrPass ir_builtin_passes[] = {
+  {"dce", "remove unused side-effect-free instructions", ir_pass_dce, NULL},
+  {"unreachable", "remove blocks unreachable from entry",
+   ir_unreachable_function, NULL},
+  {"inline", "inline cheap calls, callees first", NULL, ir_inline_module},
+  {"functionattrs", "infer memory, unwind, and recursion attributes", NULL,
+   ir_function_attrs_module},
+  {"tailcall", "turn self tail calls into loops, mark other tail calls",
+   ir_tailcall_function, NULL},
+  {"mem2reg", "promote scalar allocas to SSA values", ir_mem2reg_function,
+   NULL},
+  {"sccp", "propagate constants along the branches that can run",
+   ir_sccp_function, NULL},
+  {"gvn", "remove redundant computations and loads", ir_gvn_function, NULL},
+  {"dse", "remove stores nothing reads", ir_dse_function, NULL},
+  {"licm", "hoist loop-invariant code into loop preheaders", ir_licm_function,
+   NULL},
+  {"ivsr", "step pointers along induction variables in loops",
+   ir_ivsr_function, NULL},
+  {"loopidiom", "replace fill and copy loops with memset and memcpy",
+   ir_loop_idiom_function, NULL},
+  {"lowerswitch", "expand switches into binary searches of compares",
+   ir_lowerswitch_function, NULL},
+  {"blockplace", "lay out blocks along the profile's hot paths",
+   ir_profile_layout_function, NULL},
+};
+
+const IrPass *ir_pass_lookup(const char *name, size_t length) {
+  size_t index = 0;
+
+  for (index = 0;
+       index < sizeof(ir_builtin_passes) / sizeof(ir_builtin_passes[0]);
+       index++) {
+    const IrPass *pass = &ir_builtin_passes[index];
+
+    if (strlen(pass->name) == length &&
+        strncmp(pass->name, name, length) == 0) {
+      return pass;
+    }
+  }
+
+  return NULL;
+}
+
+void ir_pass_manager_init(IrPassManager *manager) {
+  manager->passes = NULL;
+  manager->changes = NULL;
+  manager->count = 0;
+  manager->capacity = 0;
+  manager->verify_each = 1;
+  manager->options.inline_threshold = IR_INLINE_DEFAULT_THRESHOLD;
+}
+
+void ir_pass_manager_free(IrPassManager *manager) {
+  free(manager->passes);
+  free(manager->changes);
+  ir_pass_manager_init(manager);
+}
+
+int ir_pass_manager_add(IrPassManager *manager, const IrPass *pass) {
+  if (manager->count == manager->capacity) {
+    size_t capacity = manager->capacity ? manager->capacity * 2 : 4;
+    const IrPass **passes =
+      realloc(manager->passes, capacity * sizeof(*passes));
+    size_t *changes = NULL;
+
+    if (!passes) {
+      return 0;
+    }
+    manager->passes = passes;
+
+    changes = realloc(manager->changes, capacity * sizeof(*changes));
+    if (!changes) {
+      return 0;
+    }
+    manager->changes = changes;
+    manager->capacity = capacity;
+  }
+
+  manager->passes[manager->count] = pass;
+  manager->changes[manager->count] = 0;
+  manager->count++;
+  return 1;
+}
+
+/* Appends the passes named in a comma-separated list such as "dce,dce". */
+int ir_pass_manager_parse(IrPassManager *manager, const char *pipeline,
+                          const char **message) {
+  const char *cursor = pipeline;
+
+  while (cursor && *cursor) {
+    const char *end = strchr(cursor, ',');
+    size_t length = end ? (size_t)(end - cursor) : strlen(cursor);
+    const IrPass *pass = ir_pass_lookup(cursor, length);
+
+    if (!pass) {
+      *message = "ir: unknown pass";
+      return 0;
+    }
+
+    if (!ir_pass_manager_add(manager, pass)) {
+      *message = "ir: out of memory";
+      return 0;
+    }
+
+    cursor = end ? end + 1 : NULL;
+  }
+
+  return 1;
+}
+
+int ir_pass_manager_run(IrPassManager *manager, IrModule *module,
+                        const char **message) {
+  size_t pass_index = 0;
+  size_t symbol_index = 0;
+
+  for (pass_index = 0; pass_index < manager->count; pass_index++) {
+    const IrPass *pass = manager->passes[pass_index];
+
+    if (pass->run_module &&
+        (!pass->run_module(module, &manager->options,
+                           &manager->changes[pass_index]) ||
+         module->out_of_memory)) {
+      *message = "ir: out of memory";
+      return 0;
+    }
+
+    for (symbol_index = 0; pass->run_function &&
+                           symbol_index < module->symbol_count;
+         symbol_index++) {
+      IrFunction *function = module->symbols[symbol_index].function;
+
+      if (!function || ir_function_is_declaration(function)) {
+        continue;
+      }
+
+      if (!pass->run_function(function, &manager->changes[pass_index]) ||
+          module->out_of_memory) {
+        *message = "ir: out of memory";
+        return 0;
+      }
+    }
+
+    if (manager->verify_each && !ir_verify_module(module, message)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+void ir_pass_manager_report(const IrPassManager *manager, FILE *out) {
+  size_t index = 0;
+
+  for (index = 0; index < manager->count; index++) {
+    fprintf(out, "%-13s %6zu  %s\n", manager->passes[index]->name,
+            manager->changes[index], manager->passes[index]->description);
+  }
+}
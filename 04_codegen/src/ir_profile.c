@@ -0,0 +1,643 @@
+#include "ir_pass.h"
+#include "ir_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IR_PROFILE_FNV_OFFSET 0xcbf29ce484222325ULL
+#define IR_PROFILE_FNV_PRIME 0x100000001b3ULL
+
+static unsigned long long ir_profile_hash(unsigned long long hash,
+                                          unsigned long long value) {
+  int byte = 0;
+
+  for (byte = 0; byte < 8; byte++) {
+    hash = (hash ^ ((value >> (byte * 8)) & 0xff)) * IR_PROFILE_FNV_PRIME;
+  }
+  return hash;
+}
+
+unsigned long long ir_profile_guid(const char *name) {
+  unsigned long long hash = IR_PROFILE_FNV_OFFSET;
+
+  for (; *name; name++) {
+    hash = (hash ^ (unsigned char)*name) * IR_PROFILE_FNV_PRIME;
+  }
+  return hash;
+}
+
+/* The blocks and branches of a function, in the order the counters use. */
+typedef struct IrProfileShape {
+  size_t block_count;
+  size_t branch_count;
+  unsigned long long checksum;
+} IrProfileShape;
+
+static IrProfileShape ir_profile_shape(const IrFunction *function) {
+  IrProfileShape shape;
+  const IrBlock *block = NULL;
+  const IrInstr *terminator = NULL;
+
+  shape.block_count = 0;
+  shape.branch_count = 0;
+  shape.checksum = IR_PROFILE_FNV_OFFSET;
+  for (block = function->first_block; block; block = block->next) {
+    terminator = ir_block_terminator(block);
+    shape.block_count++;
+    shape.checksum = ir_profile_hash(
+      shape.checksum, terminator ? (unsigned long long)terminator->opcode : 0);
+    shape.checksum =
+      ir_profile_hash(shape.checksum, ir_block_successor_count(block));
+    if (terminator && terminator->opcode == IR_OP_CONDBR) {
+      shape.branch_count++;
+    }
+  }
+  return shape;
+}
+
+static IrFunction *ir_profile_runtime(IrModule *module) {
+  static const char name[] = "__basecc_profile_enter";
+  IrFunction *function = ir_module_find_function(module, name, strlen(name));
+  IrType *i64 = ir_type_int(module, 64);
+
+  if (function) {
+    return function;
+  }
+
+  function = ir_module_add_function(module, name, strlen(name),
+                                    ir_type_void(module));
+  if (!function ||
+      !ir_function_add_param(function, ir_type_pointer(module, i64),
+                             "counters", 8) ||
+      !ir_function_add_param(function, i64, "guid", 4) ||
+      !ir_function_add_param(function, i64, "checksum", 8) ||
+      !ir_function_add_param(function, ir_type_int(module, 32), "count", 5)) {
+    return NULL;
+  }
+  return function;
+}
+
+/* A pointer to counters[index], built at the builder's position. */
+static IrValue *ir_profile_counter(IrBuilder *builder, IrGlobal *counters,
+                                   size_t index) {
+  IrModule *module = builder->module;
+  IrValue *indices[2];
+
+  indices[0] = ir_const_int(module, ir_type_int(module, 32), 0);
+  indices[1] = ir_const_int(module, ir_type_int(module, 32), (long long)index);
+  return ir_build_gep(builder, IR_FLAG_INBOUNDS, counters->value_type,
+                      &counters->value, indices, 2);
+}
+
+/* Moves what the builder appended after last to just ahead of before. */
+static void ir_profile_move_appended(IrInstr *last, IrInstr *before) {
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+
+  for (instr = last->next; instr; instr = next) {
+    next = instr->next;
+    ir_instr_move_before(instr, before);
+  }
+}
+
+/* Adds amount to counters[index] just ahead of before. */
+static int ir_profile_count(IrBuilder *builder, IrGlobal *counters,
+                            size_t index, IrValue *amount, IrInstr *before) {
+  IrInstr *last = builder->block->last;
+  IrValue *pointer = ir_profile_counter(builder, counters, index);
+  IrValue *count = ir_build_load(builder, pointer);
+  IrValue *sum = ir_build_binary(builder, IR_OP_ADD, 0, count, amount);
+
+  if (!ir_build_store(builder, sum, pointer)) {
+    return 0;
+  }
+  ir_profile_move_appended(last, before);
+  return 1;
+}
+
+/*
+ * The builder only appends, so each counter update is built after the
+ * terminator and moved up: block counts to the top of the block, behind
+ * any phis, and branch counts to just ahead of the condbr.
+ */
+static int ir_profile_instrument_function(IrFunction *function) {
+  IrModule *module = function->module;
+  IrProfileShape shape = ir_profile_shape(function);
+  IrType *i32 = ir_type_int(module, 32);
+  IrType *i64 = ir_type_int(module, 64);
+  IrFunction *runtime = ir_profile_runtime(module);
+  IrGlobal *counters = NULL;
+  IrBuilder builder;
+  IrBlock *block = NULL;
+  IrInstr *start = NULL;
+  IrInstr *last = NULL;
+  IrInstr *terminator = NULL;
+  IrValue *args[4];
+  IrValue *taken = NULL;
+  size_t counter_count = shape.block_count + shape.branch_count;
+  size_t branch = shape.block_count;
+  size_t index = 0;
+  char name[256];
+
+  snprintf(name, sizeof(name), "__basecc_prof_%s", function->name);
+  counters = runtime ? ir_module_add_global(
+                         module, name, strlen(name),
+                         ir_type_array(module, i64, counter_count))
+                     : NULL;
+  if (!counters) {
+    return 0;
+  }
+  counters->initializer = ir_const_zero(module, counters->value_type);
+  counters->linkage = IR_LINKAGE_INTERNAL;
+  counters->owner = function;
+
+  ir_builder_init(&builder, function);
+  for (block = function->first_block; block; block = block->next, index++) {
+    ir_builder_set_block(&builder, block);
+    for (start = block->first; start->opcode == IR_OP_PHI;
+         start = start->next) {
+    }
+
+    /* Ahead of the entry count, which is still 0 on the first call. */
+    if (block == function->first_block) {
+      last = block->last;
+      args[0] = ir_profile_counter(&builder, counters, 0);
+      args[1] = ir_const_int(module, i64,
+                             (long long)ir_profile_guid(function->name));
+      args[2] = ir_const_int(module, i64, (long long)shape.checksum);
+      args[3] = ir_const_int(module, i32, (long long)counter_count);
+      if (!ir_build_call(&builder, runtime, args, 4)) {
+        return 0;
+      }
+      ir_profile_move_appended(last, start);
+    }
+
+    if (!ir_profile_count(&builder, counters, index,
+                          ir_const_int(module, i64, 1), start)) {
+      return 0;
+    }
+
+    terminator = ir_block_terminator(block);
+    if (terminator->opcode != IR_OP_CONDBR) {
+      continue;
+    }
+    last = block->last;
+    taken = ir_build_cast(&builder, IR_OP_ZEXT, terminator->operands[0], i64);
+    if (!taken) {
+      return 0;
+    }
+    ir_profile_move_appended(last, terminator);
+    if (!ir_profile_count(&builder, counters, branch++, taken, terminator)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int ir_profile_instrument_module(IrModule *module) {
+  size_t count = module->symbol_count;
+  size_t index = 0;
+
+  /* Counters and the runtime declaration are added past count. */
+  for (index = 0; index < count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && !ir_function_is_declaration(function) &&
+        !ir_profile_instrument_function(function)) {
+      return 0;
+    }
+  }
+  return !module->out_of_memory;
+}
+
+/*
+ * Declares __basecc_function_enter or _exit, which take the function's id
+ * slot and then its name or the tick count enter returned.
+ */
+static IrFunction *ir_profile_function_runtime(IrModule *module,
+                                               const char *name, int enter) {
+  IrFunction *function = ir_module_find_function(module, name, strlen(name));
+  IrType *i8 = ir_type_int(module, 8);
+  IrType *i64 = ir_type_int(module, 64);
+
+  if (function) {
+    return function;
+  }
+
+  function = ir_module_add_function(
+    module, name, strlen(name), enter ? i64 : ir_type_void(module));
+  if (!function ||
+      !ir_function_add_param(function, ir_type_pointer(module, i64), "slot",
+                             4) ||
+      !(enter ? ir_function_add_param(function, ir_type_pointer(module, i8),
+                                      "name", 4)
+              : ir_function_add_param(function, i64, "start", 5))) {
+    return NULL;
+  }
+  return function;
+}
+
+/* The function's name as an internal, NUL-terminated i8 array. */
+static IrGlobal *ir_profile_function_name(IrFunction *function) {
+  IrModule *module = function->module;
+  IrType *i8 = ir_type_int(module, 8);
+  size_t length = strlen(function->name);
+  IrType *type = ir_type_array(module, i8, length + 1);
+  IrValue **elements = calloc(length + 1, sizeof(*elements));
+  IrGlobal *global = NULL;
+  size_t index = 0;
+  char name[256];
+
+  if (!elements) {
+    return NULL;
+  }
+  for (index = 0; index <= length; index++) {
+    elements[index] =
+      ir_const_int(module, i8, (unsigned char)function->name[index]);
+  }
+
+  snprintf(name, sizeof(name), "__basecc_fname_%s", function->name);
+  global = ir_module_add_global(module, name, strlen(name), type);
+  if (global) {
+    global->initializer =
+      ir_const_aggregate(module, type, elements, length + 1);
+    global->linkage = IR_LINKAGE_INTERNAL;
+    global->is_constant = 1;
+    global->unnamed_addr = IR_UNNAMED_ADDR_GLOBAL;
+    global->owner = function;
+  }
+  free(elements);
+  return global && global->initializer ? global : NULL;
+}
+
+/*
+ * Calls enter ahead of everything in the entry block and exit ahead of
+ * every ret, handing exit the ticks enter returned. Each function gets an
+ * i64 slot for the id the runtime gives it on its first call. A tail call
+ * right before a ret stops being one, since exit now runs after it.
+ */
+static int ir_profile_instrument_entry_exit(IrFunction *function) {
+  IrModule *module = function->module;
+  IrFunction *enter =
+    ir_profile_function_runtime(module, "__basecc_function_enter", 1);
+  IrFunction *leave =
+    ir_profile_function_runtime(module, "__basecc_function_exit", 0);
+  IrGlobal *name = ir_profile_function_name(function);
+  IrGlobal *slot = NULL;
+  IrBuilder builder;
+  IrBlock *block = NULL;
+  IrInstr *terminator = NULL;
+  IrInstr *last = NULL;
+  IrValue *indices[2];
+  IrValue *args[2];
+  IrValue *start = NULL;
+  char slot_name[256];
+
+  snprintf(slot_name, sizeof(slot_name), "__basecc_fslot_%s", function->name);
+  slot = enter && leave && name
+           ? ir_module_add_global(module, slot_name, strlen(slot_name),
+                                  ir_type_int(module, 64))
+           : NULL;
+  if (!slot) {
+    return 0;
+  }
+  slot->initializer = ir_const_zero(module, slot->value_type);
+  slot->linkage = IR_LINKAGE_INTERNAL;
+  slot->owner = function;
+
+  ir_builder_init(&builder, function);
+  block = function->first_block;
+  ir_builder_set_block(&builder, block);
+  last = block->last;
+  indices[0] = ir_const_int(module, ir_type_int(module, 32), 0);
+  indices[1] = indices[0];
+  args[0] = &slot->value;
+  args[1] = ir_build_gep(&builder, IR_FLAG_INBOUNDS, name->value_type,
+                         &name->value, indices, 2);
+  start = args[1] ? ir_build_call(&builder, enter, args, 2) : NULL;
+  if (!start) {
+    return 0;
+  }
+  ir_profile_move_appended(last, block->first);
+
+  args[1] = start;
+  for (block = function->first_block; block; block = block->next) {
+    terminator = ir_block_terminator(block);
+    if (terminator->opcode != IR_OP_RET) {
+      continue;
+    }
+    if (terminator->prev && terminator->prev->opcode == IR_OP_CALL) {
+      terminator->prev->flags &= ~(IR_FLAG_TAIL | IR_FLAG_MUSTTAIL);
+    }
+    ir_builder_set_block(&builder, block);
+    last = block->last;
+    if (!ir_build_call(&builder, leave, args, 2)) {
+      return 0;
+    }
+    ir_profile_move_appended(last, terminator);
+  }
+  return 1;
+}
+
+int ir_profile_instrument_functions(IrModule *module) {
+  size_t count = module->symbol_count;
+  size_t index = 0;
+
+  /* Slots, names, and the runtime declarations are added past count. */
+  for (index = 0; index < count; index++) {
+    IrFunction *function = module->symbols[index].function;
+
+    if (function && !ir_function_is_declaration(function) &&
+        !ir_profile_instrument_entry_exit(function)) {
+      return 0;
+    }
+  }
+  return !module->out_of_memory;
+}
+
+void ir_profile_init(IrProfile *profile) {
+  profile->records = NULL;
+  profile->record_count = 0;
+  profile->record_capacity = 0;
+}
+
+void ir_profile_free(IrProfile *profile) {
+  size_t index = 0;
+
+  for (index = 0; index < profile->record_count; index++) {
+    free(profile->records[index].counters);
+  }
+  free(profile->records);
+  ir_profile_init(profile);
+}
+
+static const IrProfileRecord *ir_profile_find(const IrProfile *profile,
+                                              unsigned long long guid,
+                                              unsigned long long checksum,
+                                              size_t counter_count) {
+  size_t index = 0;
+
+  for (index = 0; index < profile->record_count; index++) {
+    const IrProfileRecord *record = &profile->records[index];
+
+    if (record->guid == guid && record->checksum == checksum &&
+        record->counter_count == counter_count) {
+      return record;
+    }
+  }
+  return NULL;
+}
+
+/* The record to sum a run into, added zeroed if there is none yet. */
+static IrProfileRecord *ir_profile_merge_target(IrProfile *profile,
+                                                unsigned long long guid,
+                                                unsigned long long checksum,
+                                                size_t counter_count) {
+  IrProfileRecord *record = (IrProfileRecord *)ir_profile_find(
+    profile, guid, checksum, counter_count);
+
+  if (record) {
+    return record;
+  }
+
+  if (profile->record_count == profile->record_capacity) {
+    size_t capacity =
+      profile->record_capacity ? profile->record_capacity * 2 : 16;
+    IrProfileRecord *records =
+      realloc(profile->records, capacity * sizeof(*records));
+
+    if (!records) {
+      return NULL;
+    }
+    profile->records = records;
+    profile->record_capacity = capacity;
+  }
+
+  record = &profile->records[profile->record_count];
+  record->counters = calloc(counter_count ? counter_count : 1,
+                            sizeof(*record->counters));
+  if (!record->counters) {
+    return NULL;
+  }
+  record->guid = guid;
+  record->checksum = checksum;
+  record->counter_count = counter_count;
+  profile->record_count++;
+  return record;
+}
+
+int ir_profile_read(IrProfile *profile, FILE *in, const char **message) {
+  unsigned long long guid = 0;
+  unsigned long long checksum = 0;
+  unsigned long long value = 0;
+  size_t counter_count = 0;
+  size_t index = 0;
+  int fields = 0;
+
+  for (;;) {
+    IrProfileRecord *record = NULL;
+
+    fields = fscanf(in, "%llx %llx %zu", &guid, &checksum, &counter_count);
+    if (fields == EOF) {
+      break;
+    }
+    if (fields != 3) {
+      *message = "profile: malformed record";
+      return 0;
+    }
+
+    record = ir_profile_merge_target(profile, guid, checksum, counter_count);
+    if (!record) {
+      *message = "profile: out of memory";
+      return 0;
+    }
+    for (index = 0; index < counter_count; index++) {
+      if (fscanf(in, "%llu", &value) != 1) {
+        *message = "profile: truncated record";
+        return 0;
+      }
+      record->counters[index] += value;
+    }
+  }
+
+  if (ferror(in)) {
+    *message = "profile: failed to read";
+    return 0;
+  }
+  return 1;
+}
+
+int ir_profile_annotate_module(IrModule *module, const IrProfile *profile,
+                               size_t *annotated) {
+  size_t index = 0;
+
+  for (index = 0; index < module->symbol_count; index++) {
+    IrFunction *function = module->symbols[index].function;
+    const IrProfileRecord *record = NULL;
+    IrProfileShape shape;
+    IrBlock *block = NULL;
+    IrInstr *terminator = NULL;
+    size_t position = 0;
+    size_t branch = 0;
+
+    if (!function || ir_function_is_declaration(function)) {
+      continue;
+    }
+
+    shape = ir_profile_shape(function);
+    record = ir_profile_find(profile, ir_profile_guid(function->name),
+                             shape.checksum,
+                             shape.block_count + shape.branch_count);
+    if (!record) {
+      continue;
+    }
+
+    function->has_entry_count = 1;
+    function->entry_count = record->counters[0];
+    branch = shape.block_count;
+    for (block = function->first_block; block;
+         block = block->next, position++) {
+      block->has_profile_count = 1;
+      block->profile_count = record->counters[position];
+
+      terminator = ir_block_terminator(block);
+      if (terminator->opcode != IR_OP_CONDBR) {
+        continue;
+      }
+      terminator->has_branch_weights = 1;
+      terminator->branch_weights[0] = record->counters[branch];
+      terminator->branch_weights[1] =
+        block->profile_count > record->counters[branch]
+          ? block->profile_count - record->counters[branch]
+          : 0;
+      branch++;
+    }
+    (*annotated)++;
+  }
+  return 1;
+}
+
+/* How often the edge from block to its index-th successor was taken. */
+static int ir_profile_edge_weight(const IrBlock *block, size_t index,
+                                  unsigned long long *weight) {
+  const IrInstr *terminator = ir_block_terminator(block);
+
+  if (terminator->opcode == IR_OP_CONDBR && terminator->has_branch_weights) {
+    *weight = terminator->branch_weights[index];
+    return 1;
+  }
+  if (terminator->opcode == IR_OP_BR && block->has_profile_count) {
+    *weight = block->profile_count;
+    return 1;
+  }
+  return 0;
+}
+
+static int ir_profile_is_cold(const IrBlock *block) {
+  return block->has_profile_count && block->profile_count == 0;
+}
+
+/*
+ * From the block just placed, the successor to put right after it: the
+ * most taken edge if the profile knows the edges, else the successor
+ * that already followed it. Never an edge the profile saw untaken.
+ */
+static IrBlock *ir_profile_next(IrBlock *block, const char *placed,
+                                const IrBlock *original_next) {
+  IrBlock *best = NULL;
+  unsigned long long best_weight = 0;
+  unsigned long long weight = 0;
+  size_t index = 0;
+  int known = 1;
+
+  for (index = 0; index < ir_block_successor_count(block); index++) {
+    IrBlock *successor = ir_block_successor(block, index);
+
+    known = ir_profile_edge_weight(block, index, &weight);
+    if (placed[successor->index]) {
+      continue;
+    }
+    if (!known) {
+      if (successor == original_next && !ir_profile_is_cold(successor)) {
+        return successor;
+      }
+      continue;
+    }
+    if (weight > best_weight) {
+      best = successor;
+      best_weight = weight;
+    }
+  }
+  return best;
+}
+
+int ir_profile_layout_function(IrFunction *function, size_t *changes) {
+  IrBlock **original = NULL;
+  IrBlock **order = NULL;
+  char *placed = NULL;
+  IrBlock *block = NULL;
+  size_t count = 0;
+  size_t placed_count = 0;
+  size_t index = 0;
+  size_t moved = 0;
+  int cold = 0;
+  int ok = 0;
+
+  if (!function->has_entry_count || !ir_function_build_cfg(function)) {
+    return function->has_entry_count ? 0 : 1;
+  }
+
+  count = function->block_count;
+  original = malloc(count * sizeof(*original));
+  order = malloc(count * sizeof(*order));
+  placed = calloc(count, 1);
+  if (!original || !order || !placed) {
+    goto cleanup;
+  }
+  for (block = function->first_block; block; block = block->next) {
+    original[block->index] = block;
+  }
+
+  /*
+   * Grow a chain from the entry along the hottest edges. When it ends,
+   * start again from the first block left in the original order, cold
+   * ones only once nothing else is left.
+   */
+  block = function->first_block;
+  while (placed_count < count) {
+    placed[block->index] = 1;
+    order[placed_count++] = block;
+    block = ir_profile_next(block, placed,
+                            block->index + 1 < count
+                              ? original[block->index + 1]
+                              : NULL);
+    for (cold = 0; !block && cold < 2 && placed_count < count; cold++) {
+      for (index = 0; index < count; index++) {
+        if (!placed[index] && ir_profile_is_cold(original[index]) == cold) {
+          block = original[index];
+          break;
+        }
+      }
+    }
+  }
+
+  for (index = 0; index < count; index++) {
+    moved += order[index] != original[index];
+  }
+  if (moved > 0) {
+    for (index = 0; index < count; index++) {
+      order[index]->prev = index > 0 ? order[index - 1] : NULL;
+      order[index]->next = index + 1 < count ? order[index + 1] : NULL;
+    }
+    function->first_block = order[0];
+    function->last_block = order[count - 1];
+    (*changes)++;
+  }
+  ok = moved == 0 || ir_function_build_cfg(function);
+
+cleanup:
+  free(original);
+  free(order);
+  free(placed);
+  return ok;
+}
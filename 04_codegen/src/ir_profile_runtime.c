@@ -0,0 +1,281 @@
+#include "ir_profile.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Linked into instrumented programs. Kept apart from ir_profile.c so a
+ * program only pulls in the few functions it calls.
+ */
+
+typedef struct IrProfileRuntimeRecord {
+  const unsigned long long *counters;
+  unsigned long long guid;
+  unsigned long long checksum;
+  int count;
+  struct IrProfileRuntimeRecord *next;
+} IrProfileRuntimeRecord;
+
+static IrProfileRuntimeRecord *ir_profile_runtime_records;
+
+/* Appends one line per function that ran: guid, checksum, and counters. */
+static void ir_profile_runtime_write(void) {
+  const char *path = getenv(IR_PROFILE_ENV);
+  const IrProfileRuntimeRecord *record = NULL;
+  FILE *out = NULL;
+  int index = 0;
+
+  out = fopen(path && *path ? path : IR_PROFILE_DEFAULT_PATH, "a");
+  for (record = ir_profile_runtime_records; out && record;
+       record = record->next) {
+    fprintf(out, "%016llx %016llx %d", record->guid, record->checksum,
+            record->count);
+    for (index = 0; index < record->count; index++) {
+      fprintf(out, " %llu", record->counters[index]);
+    }
+    fprintf(out, "\n");
+  }
+  if (!out || ferror(out)) {
+    fprintf(stderr, "profile: failed to write the profile\n");
+  }
+  if (out) {
+    fclose(out);
+  }
+}
+
+void __basecc_profile_enter(unsigned long long *counters,
+                            unsigned long long guid,
+                            unsigned long long checksum, int count) {
+  IrProfileRuntimeRecord *record = NULL;
+
+  if (counters[0] != 0) {
+    return;
+  }
+
+  record = malloc(sizeof(*record));
+  if (!record || (!ir_profile_runtime_records &&
+                  atexit(ir_profile_runtime_write) != 0)) {
+    fprintf(stderr, "profile: failed to start profiling\n");
+    abort();
+  }
+  record->counters = counters;
+  record->guid = guid;
+  record->checksum = checksum;
+  record->count = count;
+  record->next = ir_profile_runtime_records;
+  ir_profile_runtime_records = record;
+}
+
+/*
+ * Function entry/exit counters. Each thread counts into its own buffer,
+ * indexed by function id, so the hot path takes no lock and shares no
+ * cache line. Ids and buffers are handed out under a spin lock, and the
+ * buffers are never freed so the report at exit still sees threads that
+ * are gone. Threads still running then may be read mid-update.
+ */
+
+typedef struct IrProfileFunctionCounts {
+  unsigned long long calls;
+  unsigned long long ticks;
+  /* Active calls; only the outermost one adds its time. */
+  unsigned long long depth;
+} IrProfileFunctionCounts;
+
+typedef struct IrProfileThread {
+  IrProfileFunctionCounts *counts;
+  size_t capacity;
+  struct IrProfileThread *next;
+} IrProfileThread;
+
+/* What the report prints for one function, summed over the threads. */
+typedef struct IrProfileFunctionTotal {
+  const char *name;
+  unsigned long long calls;
+  unsigned long long ticks;
+} IrProfileFunctionTotal;
+
+static atomic_flag ir_profile_function_lock = ATOMIC_FLAG_INIT;
+static const char **ir_profile_function_names;
+static size_t ir_profile_function_count;
+static size_t ir_profile_function_capacity;
+static IrProfileThread *ir_profile_threads;
+static _Thread_local IrProfileThread *ir_profile_thread;
+
+/* The time stamp counter where there is one; nanoseconds elsewhere. */
+static unsigned long long ir_profile_ticks(void) {
+#if defined(__GNUC__) && defined(__x86_64__)
+  return __builtin_ia32_rdtsc();
+#else
+  struct timespec now;
+
+  timespec_get(&now, TIME_UTC);
+  return (unsigned long long)now.tv_sec * 1000000000ULL +
+         (unsigned long long)now.tv_nsec;
+#endif
+}
+
+static void ir_profile_function_lock_acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&ir_profile_function_lock,
+                                           memory_order_acquire)) {
+  }
+}
+
+static void ir_profile_function_lock_release(void) {
+  atomic_flag_clear_explicit(&ir_profile_function_lock, memory_order_release);
+}
+
+static int ir_profile_function_compare(const void *left, const void *right) {
+  const IrProfileFunctionTotal *a = left;
+  const IrProfileFunctionTotal *b = right;
+
+  if (a->ticks != b->ticks) {
+    return a->ticks < b->ticks ? 1 : -1;
+  }
+  if (a->calls != b->calls) {
+    return a->calls < b->calls ? 1 : -1;
+  }
+  return strcmp(a->name, b->name);
+}
+
+/* Appends the functions that ran, most inclusive time first. */
+static void ir_profile_function_report(void) {
+  const char *path = getenv(IR_PROFILE_FUNCTIONS_ENV);
+  const IrProfileThread *thread = NULL;
+  IrProfileFunctionTotal *totals = NULL;
+  FILE *out = NULL;
+  size_t threads = 0;
+  size_t count = 0;
+  size_t index = 0;
+
+  ir_profile_function_lock_acquire();
+  totals = calloc(ir_profile_function_count + 1, sizeof(*totals));
+  for (index = 0; totals && index < ir_profile_function_count; index++) {
+    totals[index].name = ir_profile_function_names[index];
+  }
+  count = ir_profile_function_count;
+  for (thread = ir_profile_threads; totals && thread; thread = thread->next) {
+    threads++;
+    for (index = 0; index < thread->capacity && index < count; index++) {
+      totals[index].calls += thread->counts[index].calls;
+      totals[index].ticks += thread->counts[index].ticks;
+    }
+  }
+  ir_profile_function_lock_release();
+
+  out = totals ? fopen(path && *path ? path : IR_PROFILE_FUNCTIONS_DEFAULT_PATH,
+                       "a")
+               : NULL;
+  if (out) {
+    qsort(totals, count, sizeof(*totals), ir_profile_function_compare);
+    fprintf(out, "# %zu functions, %zu threads\n", count, threads);
+    fprintf(out, "%12s %16s %12s  %s\n", "calls", "ticks", "ticks/call",
+            "function");
+    for (index = 0; index < count && totals[index].calls > 0; index++) {
+      fprintf(out, "%12llu %16llu %12llu  %s\n", totals[index].calls,
+              totals[index].ticks, totals[index].ticks / totals[index].calls,
+              totals[index].name);
+    }
+  }
+  if (!out || ferror(out)) {
+    fprintf(stderr, "profile: failed to write the function profile\n");
+  }
+  if (out) {
+    fclose(out);
+  }
+  free(totals);
+}
+
+static void ir_profile_function_fail(void) {
+  fprintf(stderr, "profile: failed to start function profiling\n");
+  abort();
+}
+
+/*
+ * The first call of a function, or the first call on a thread: gives the
+ * function its id and the thread a buffer with room for it.
+ */
+static IrProfileFunctionCounts *
+ir_profile_function_register(unsigned long long *slot, const char *name) {
+  _Atomic unsigned long long *id = (_Atomic unsigned long long *)slot;
+  IrProfileThread *thread = ir_profile_thread;
+  size_t count = 0;
+
+  ir_profile_function_lock_acquire();
+  if (atomic_load_explicit(id, memory_order_relaxed) == 0) {
+    if (ir_profile_function_count == ir_profile_function_capacity) {
+      size_t capacity = ir_profile_function_capacity
+                          ? ir_profile_function_capacity * 2
+                          : 64;
+      const char **names = realloc((void *)ir_profile_function_names,
+                                   capacity * sizeof(*names));
+
+      if (!names) {
+        ir_profile_function_fail();
+      }
+      ir_profile_function_names = names;
+      ir_profile_function_capacity = capacity;
+    }
+    if (ir_profile_function_count == 0 &&
+        atexit(ir_profile_function_report) != 0) {
+      ir_profile_function_fail();
+    }
+    ir_profile_function_names[ir_profile_function_count++] = name;
+    atomic_store_explicit(id, ir_profile_function_count,
+                          memory_order_release);
+  }
+  count = ir_profile_function_capacity;
+
+  if (!thread) {
+    thread = calloc(1, sizeof(*thread));
+    if (!thread) {
+      ir_profile_function_fail();
+    }
+    thread->next = ir_profile_threads;
+    ir_profile_threads = thread;
+    ir_profile_thread = thread;
+  }
+  if (thread->capacity < count) {
+    IrProfileFunctionCounts *counts =
+      realloc(thread->counts, count * sizeof(*counts));
+
+    if (!counts) {
+      ir_profile_function_fail();
+    }
+    memset(counts + thread->capacity, 0,
+           (count - thread->capacity) * sizeof(*counts));
+    thread->counts = counts;
+    thread->capacity = count;
+  }
+  ir_profile_function_lock_release();
+  return &thread->counts[atomic_load_explicit(id, memory_order_relaxed) - 1];
+}
+
+unsigned long long __basecc_function_enter(unsigned long long *slot,
+                                           const char *name) {
+  unsigned long long id = atomic_load_explicit(
+    (_Atomic unsigned long long *)slot, memory_order_acquire);
+  IrProfileThread *thread = ir_profile_thread;
+  IrProfileFunctionCounts *counts = NULL;
+
+  if (id != 0 && thread && id <= thread->capacity) {
+    counts = &thread->counts[id - 1];
+  } else {
+    counts = ir_profile_function_register(slot, name);
+  }
+  counts->calls++;
+  counts->depth++;
+  return ir_profile_ticks();
+}
+
+void __basecc_function_exit(unsigned long long *slot,
+                            unsigned long long start) {
+  unsigned long long end = ir_profile_ticks();
+  IrProfileFunctionCounts *counts = &ir_profile_thread->counts[*slot - 1];
+
+  if (--counts->depth == 0) {
+    counts->ticks += end - start;
+  }
+}
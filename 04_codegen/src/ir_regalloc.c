@@ -0,0 +1,727 @@
+#include "ir_regalloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IR_REGALLOC_MAX_REGISTERS 64
+#define IR_REGALLOC_BITS (sizeof(unsigned long) * 8)
+
+typedef struct IrRegAllocArgHint {
+  size_t slot;
+  size_t position;
+  int reg;
+} IrRegAllocArgHint;
+
+typedef struct IrRegAllocState {
+  IrFunction *function;
+  const IrRegAllocTarget *target;
+  IrRegAllocation *allocation;
+  size_t block_count;
+  size_t words;
+  /* Per block bit sets over slots, block_count * words each. */
+  unsigned long *gen;
+  unsigned long *kill;
+  unsigned long *phi_uses;
+  unsigned long *live_in;
+  unsigned long *live_out;
+  size_t *block_starts;
+  size_t *block_ends;
+  /* Per slot. */
+  IrValue **values;
+  size_t *starts;
+  size_t *ends;
+  double *costs;
+  int *hints;
+  size_t *partners;
+  /* Positions of calls, ascending. */
+  size_t *calls;
+  size_t call_count;
+  IrRegAllocArgHint *arg_hints;
+  size_t arg_hint_count;
+  size_t arg_hint_capacity;
+} IrRegAllocState;
+
+size_t ir_regalloc_slot(const IrFunction *function, const IrValue *value) {
+  if (value->kind == IR_VALUE_PARAM) {
+    return value->param->index;
+  }
+
+  if (value->kind == IR_VALUE_INSTR && ir_instr_has_result(value->instr)) {
+    return function->param_count + (size_t)value->instr->id;
+  }
+
+  return SIZE_MAX;
+}
+
+/* Only parameters and non-alloca results compete for registers. */
+static int ir_regalloc_tracked(const IrFunction *function,
+                               const IrValue *value, size_t *slot) {
+  if (value->kind == IR_VALUE_INSTR &&
+      value->instr->opcode == IR_OP_ALLOCA) {
+    return 0;
+  }
+
+  *slot = ir_regalloc_slot(function, value);
+  return *slot != SIZE_MAX;
+}
+
+static void ir_bit_set(unsigned long *set, size_t bit) {
+  set[bit / IR_REGALLOC_BITS] |= 1UL << (bit % IR_REGALLOC_BITS);
+}
+
+static int ir_bit_test(const unsigned long *set, size_t bit) {
+  return (set[bit / IR_REGALLOC_BITS] >> (bit % IR_REGALLOC_BITS)) & 1UL;
+}
+
+static int ir_regalloc_is_copy(const IrInstr *instr) {
+  return instr->opcode == IR_OP_TRUNC || instr->opcode == IR_OP_BITCAST ||
+         instr->opcode == IR_OP_PTRTOINT || instr->opcode == IR_OP_INTTOPTR;
+}
+
+static double ir_regalloc_weight(const IrBlock *block) {
+  double weight = 1.0;
+  size_t depth = 0;
+
+  for (depth = 0; depth < block->loop_depth && depth < 8; depth++) {
+    weight *= 10.0;
+  }
+  return weight;
+}
+
+static void ir_regalloc_extend(IrRegAllocState *state, size_t slot,
+                               size_t position) {
+  if (position < state->starts[slot]) {
+    state->starts[slot] = position;
+  }
+  if (state->ends[slot] == SIZE_MAX || position > state->ends[slot]) {
+    state->ends[slot] = position;
+  }
+}
+
+static void ir_regalloc_pair(IrRegAllocState *state, size_t left,
+                             size_t right) {
+  if (state->partners[left] == SIZE_MAX) {
+    state->partners[left] = right;
+  }
+  if (state->partners[right] == SIZE_MAX) {
+    state->partners[right] = left;
+  }
+}
+
+static int ir_regalloc_init(IrRegAllocState *state) {
+  IrFunction *function = state->function;
+  size_t slot_count = function->param_count + (size_t)function->next_value_id;
+  size_t sets = 0;
+  size_t index = 0;
+  const IrBlock *block = NULL;
+
+  for (block = function->first_block; block; block = block->next) {
+    state->block_count++;
+  }
+
+  state->words = slot_count / IR_REGALLOC_BITS + 1;
+  sets = (state->block_count + 1) * state->words;
+  state->gen = calloc(sets, sizeof(unsigned long));
+  state->kill = calloc(sets, sizeof(unsigned long));
+  state->phi_uses = calloc(sets, sizeof(unsigned long));
+  state->live_in = calloc(sets, sizeof(unsigned long));
+  state->live_out = calloc(sets, sizeof(unsigned long));
+  state->block_starts = calloc(state->block_count + 1, sizeof(size_t));
+  state->block_ends = calloc(state->block_count + 1, sizeof(size_t));
+  state->values = calloc(slot_count + 1, sizeof(IrValue *));
+  state->starts = malloc((slot_count + 1) * sizeof(size_t));
+  state->ends = malloc((slot_count + 1) * sizeof(size_t));
+  state->costs = calloc(slot_count + 1, sizeof(double));
+  state->hints = malloc((slot_count + 1) * sizeof(int));
+  state->partners = malloc((slot_count + 1) * sizeof(size_t));
+  state->allocation->registers = malloc((slot_count + 1) * sizeof(int));
+  state->allocation->slot_count = slot_count;
+  if (!state->gen || !state->kill || !state->phi_uses || !state->live_in ||
+      !state->live_out || !state->block_starts || !state->block_ends ||
+      !state->values || !state->starts || !state->ends || !state->costs ||
+      !state->hints || !state->partners || !state->allocation->registers) {
+    return 0;
+  }
+
+  for (index = 0; index <= slot_count; index++) {
+    state->starts[index] = SIZE_MAX;
+    state->ends[index] = SIZE_MAX;
+    state->hints[index] = -1;
+    state->partners[index] = SIZE_MAX;
+    state->allocation->registers[index] = IR_REGALLOC_NONE;
+  }
+  return 1;
+}
+
+static void ir_regalloc_free_state(IrRegAllocState *state) {
+  free(state->gen);
+  free(state->kill);
+  free(state->phi_uses);
+  free(state->live_in);
+  free(state->live_out);
+  free(state->block_starts);
+  free(state->block_ends);
+  free(state->values);
+  free(state->starts);
+  free(state->ends);
+  free(state->costs);
+  free(state->hints);
+  free(state->partners);
+  free(state->calls);
+  free(state->arg_hints);
+}
+
+/* Numbers blocks and instructions in layout order, two positions apart. */
+static void ir_regalloc_number(IrRegAllocState *state) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t position = 2;
+
+  for (block = state->function->first_block; block; block = block->next) {
+    state->block_starts[block->index] = position;
+    position += 2;
+    for (instr = block->first; instr; instr = instr->next) {
+      position += 2;
+    }
+    state->block_ends[block->index] = position;
+    position += 2;
+  }
+}
+
+/* Local upward-exposed uses and definitions, plus phi inputs per edge. */
+static void ir_regalloc_local_sets(IrRegAllocState *state) {
+  IrFunction *function = state->function;
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+  size_t slot = 0;
+
+  for (block = function->first_block; block; block = block->next) {
+    unsigned long *gen = state->gen + block->index * state->words;
+    unsigned long *kill = state->kill + block->index * state->words;
+
+    for (instr = block->first; instr; instr = instr->next) {
+      if (instr->opcode == IR_OP_PHI) {
+        for (index = 0; index < instr->operand_count; index++) {
+          if (ir_regalloc_tracked(function, instr->operands[index], &slot)) {
+            ir_bit_set(state->phi_uses +
+                         instr->blocks[index]->index * state->words,
+                       slot);
+          }
+        }
+      } else {
+        for (index = 0; index < instr->operand_count; index++) {
+          if (ir_regalloc_tracked(function, instr->operands[index], &slot) &&
+              !ir_bit_test(kill, slot)) {
+            ir_bit_set(gen, slot);
+          }
+        }
+      }
+
+      if (ir_regalloc_tracked(function, &instr->value, &slot)) {
+        ir_bit_set(kill, slot);
+      }
+    }
+  }
+}
+
+/* Backward dataflow to a fixpoint over the whole function. */
+static void ir_regalloc_liveness(IrRegAllocState *state) {
+  IrFunction *function = state->function;
+  size_t words = state->words;
+  int changed = 1;
+
+  while (changed) {
+    const IrBlock *block = NULL;
+
+    changed = 0;
+    for (block = function->last_block; block; block = block->prev) {
+      unsigned long *in = state->live_in + block->index * words;
+      unsigned long *out = state->live_out + block->index * words;
+      const unsigned long *gen = state->gen + block->index * words;
+      const unsigned long *kill = state->kill + block->index * words;
+      const unsigned long *phi_uses = state->phi_uses + block->index * words;
+      size_t successor = 0;
+      size_t word = 0;
+
+      for (word = 0; word < words; word++) {
+        unsigned long next_out = phi_uses[word];
+        unsigned long next_in = 0;
+
+        for (successor = 0; successor < ir_block_successor_count(block);
+             successor++) {
+          const IrBlock *target = ir_block_successor(block, successor);
+
+          next_out |= state->live_in[target->index * words + word];
+        }
+
+        next_in = gen[word] | (next_out & ~kill[word]);
+        if (next_out != out[word] || next_in != in[word]) {
+          out[word] = next_out;
+          in[word] = next_in;
+          changed = 1;
+        }
+      }
+    }
+  }
+}
+
+static int ir_regalloc_add_arg_hint(IrRegAllocState *state, size_t slot,
+                                    size_t position, int reg) {
+  if (state->arg_hint_count == state->arg_hint_capacity) {
+    size_t capacity =
+      state->arg_hint_capacity ? state->arg_hint_capacity * 2 : 8;
+    IrRegAllocArgHint *hints =
+      realloc(state->arg_hints, capacity * sizeof(*hints));
+
+    if (!hints) {
+      return 0;
+    }
+    state->arg_hints = hints;
+    state->arg_hint_capacity = capacity;
+  }
+
+  state->arg_hints[state->arg_hint_count].slot = slot;
+  state->arg_hints[state->arg_hint_count].position = position;
+  state->arg_hints[state->arg_hint_count].reg = reg;
+  state->arg_hint_count++;
+  return 1;
+}
+
+/* Turns liveness and use positions into one [start, end] per slot. */
+static int ir_regalloc_build_intervals(IrRegAllocState *state) {
+  IrFunction *function = state->function;
+  const IrRegAllocTarget *target = state->target;
+  size_t slot_count = state->allocation->slot_count;
+  const IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t index = 0;
+  size_t slot = 0;
+  size_t call_capacity = 0;
+
+  for (index = 0; index < function->param_count; index++) {
+    IrParam *param = function->params[index];
+
+    state->values[index] = &param->value;
+    if (param->value.use_count > 0) {
+      ir_regalloc_extend(state, index, 0);
+    }
+    if (index < target->parameter_register_count) {
+      state->hints[index] = target->parameter_registers[index];
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    size_t position = state->block_starts[block->index] + 2;
+    double weight = ir_regalloc_weight(block);
+
+    for (instr = block->first; instr; instr = instr->next, position += 2) {
+      if (instr->opcode == IR_OP_PHI) {
+        for (index = 0; index < instr->operand_count; index++) {
+          const IrBlock *pred = instr->blocks[index];
+
+          if (ir_regalloc_tracked(function, instr->operands[index], &slot)) {
+            ir_regalloc_extend(state, slot, state->block_ends[pred->index]);
+            state->costs[slot] += ir_regalloc_weight(pred);
+            ir_regalloc_pair(
+              state, slot,
+              ir_regalloc_slot(function, &instr->value));
+          }
+        }
+      } else {
+        for (index = 0; index < instr->operand_count; index++) {
+          if (!ir_regalloc_tracked(function, instr->operands[index], &slot)) {
+            continue;
+          }
+
+          ir_regalloc_extend(state, slot, position);
+          state->costs[slot] += weight;
+          if (instr->opcode == IR_OP_CALL && index > 0 &&
+              index - 1 < target->parameter_register_count &&
+              !ir_regalloc_add_arg_hint(
+                state, slot, position,
+                target->parameter_registers[index - 1])) {
+            return 0;
+          }
+        }
+      }
+
+      /* Backends may lower memset and memcpy to calls or string ops. */
+      if (instr->opcode == IR_OP_CALL || instr->opcode == IR_OP_MEMSET ||
+          instr->opcode == IR_OP_MEMCPY) {
+        if (state->call_count == call_capacity) {
+          size_t *calls = NULL;
+
+          call_capacity = call_capacity ? call_capacity * 2 : 8;
+          calls = realloc(state->calls, call_capacity * sizeof(*calls));
+          if (!calls) {
+            return 0;
+          }
+          state->calls = calls;
+        }
+        state->calls[state->call_count++] = position;
+      }
+
+      if (!ir_regalloc_tracked(function, &instr->value, &slot)) {
+        continue;
+      }
+
+      state->values[slot] = &instr->value;
+      if (instr->value.use_count == 0) {
+        continue;
+      }
+      ir_regalloc_extend(state, slot,
+                         instr->opcode == IR_OP_PHI
+                           ? state->block_starts[block->index]
+                           : position);
+      state->costs[slot] += weight;
+      if (ir_regalloc_is_copy(instr) &&
+          ir_regalloc_tracked(function, instr->operands[0], &index)) {
+        ir_regalloc_pair(state, slot, index);
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    const unsigned long *in = state->live_in + block->index * state->words;
+    const unsigned long *out = state->live_out + block->index * state->words;
+
+    for (slot = 0; slot < slot_count; slot++) {
+      if (ir_bit_test(in, slot)) {
+        ir_regalloc_extend(state, slot, state->block_starts[block->index]);
+      }
+      if (ir_bit_test(out, slot)) {
+        ir_regalloc_extend(state, slot, state->block_ends[block->index]);
+      }
+    }
+  }
+
+  /* An argument is worth pinning only if the call is its last use. */
+  for (index = 0; index < state->arg_hint_count; index++) {
+    const IrRegAllocArgHint *hint = &state->arg_hints[index];
+
+    if (state->ends[hint->slot] == hint->position &&
+        state->hints[hint->slot] < 0) {
+      state->hints[hint->slot] = hint->reg;
+    }
+  }
+  return 1;
+}
+
+static int ir_regalloc_crosses_call(const IrRegAllocState *state,
+                                    size_t start, size_t end) {
+  size_t low = 0;
+  size_t high = state->call_count;
+
+  /* First call strictly after the start. */
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+
+    if (state->calls[middle] <= start) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low < state->call_count && state->calls[low] < end;
+}
+
+static int ir_regalloc_compare(const void *left, const void *right) {
+  const IrLiveInterval *a = left;
+  const IrLiveInterval *b = right;
+
+  if (a->start != b->start) {
+    return a->start < b->start ? -1 : 1;
+  }
+  return a->slot < b->slot ? -1 : a->slot > b->slot;
+}
+
+static int ir_regalloc_contains(const int *regs, size_t count, int reg) {
+  size_t index = 0;
+
+  for (index = 0; index < count; index++) {
+    if (regs[index] == reg) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int ir_regalloc_allowed(const IrRegAllocTarget *target,
+                               const IrLiveInterval *interval, int reg) {
+  if (reg < 0 || reg >= IR_REGALLOC_MAX_REGISTERS) {
+    return 0;
+  }
+  if (ir_regalloc_contains(target->callee_saved, target->callee_saved_count,
+                           reg)) {
+    return 1;
+  }
+  return !interval->crosses_call &&
+         ir_regalloc_contains(target->caller_saved,
+                              target->caller_saved_count, reg);
+}
+
+static int ir_regalloc_try(const IrRegAllocTarget *target,
+                           const IrLiveInterval *interval, const int *owner,
+                           int reg) {
+  return ir_regalloc_allowed(target, interval, reg) && owner[reg] < 0;
+}
+
+/* Picks a free register, preferring ones that turn copies into no-ops. */
+static int ir_regalloc_choose(const IrRegAllocState *state,
+                              const IrLiveInterval *interval,
+                              const int *owner) {
+  const IrRegAllocTarget *target = state->target;
+  const int *registers = state->allocation->registers;
+  const IrValue *value = interval->value;
+  size_t partner = state->partners[interval->slot];
+  size_t index = 0;
+  size_t slot = 0;
+
+  if (ir_regalloc_try(target, interval, owner, interval->hint)) {
+    return interval->hint;
+  }
+
+  if (value->kind == IR_VALUE_INSTR && value->instr->opcode == IR_OP_PHI) {
+    for (index = 0; index < value->instr->operand_count; index++) {
+      if (ir_regalloc_tracked(state->function, value->instr->operands[index],
+                              &slot) &&
+          ir_regalloc_try(target, interval, owner, registers[slot])) {
+        return registers[slot];
+      }
+    }
+  }
+
+  if (partner != SIZE_MAX &&
+      ir_regalloc_try(target, interval, owner, registers[partner])) {
+    return registers[partner];
+  }
+
+  if (!interval->crosses_call) {
+    for (index = 0; index < target->caller_saved_count; index++) {
+      if (owner[target->caller_saved[index]] < 0) {
+        return target->caller_saved[index];
+      }
+    }
+  }
+
+  for (index = 0; index < target->callee_saved_count; index++) {
+    if (owner[target->callee_saved[index]] < 0) {
+      return target->callee_saved[index];
+    }
+  }
+
+  return -1;
+}
+
+static int ir_regalloc_scan(IrRegAllocState *state) {
+  IrRegAllocation *allocation = state->allocation;
+  const IrRegAllocTarget *target = state->target;
+  int owner[IR_REGALLOC_MAX_REGISTERS];
+  size_t *active = NULL;
+  size_t active_count = 0;
+  size_t index = 0;
+  size_t cursor = 0;
+
+  for (index = 0; index < IR_REGALLOC_MAX_REGISTERS; index++) {
+    owner[index] = -1;
+  }
+
+  /* At most one active interval per register. */
+  active = malloc((IR_REGALLOC_MAX_REGISTERS + 1) * sizeof(*active));
+  if (!active) {
+    return 0;
+  }
+
+  for (index = 0; index < allocation->interval_count; index++) {
+    IrLiveInterval *current = &allocation->intervals[index];
+    IrLiveInterval *victim = NULL;
+    size_t victim_position = 0;
+    int reg = -1;
+
+    /*
+     * An interval ending where this one starts was last read by the
+     * defining instruction, which reads its operands before writing.
+     */
+    for (cursor = 0; cursor < active_count;) {
+      IrLiveInterval *other = &allocation->intervals[active[cursor]];
+
+      if (other->end <= current->start) {
+        owner[other->reg] = -1;
+        active[cursor] = active[--active_count];
+      } else {
+        cursor++;
+      }
+    }
+
+    reg = ir_regalloc_choose(state, current, owner);
+    if (reg < 0) {
+      for (cursor = 0; cursor < active_count; cursor++) {
+        IrLiveInterval *other = &allocation->intervals[active[cursor]];
+
+        if (!ir_regalloc_allowed(target, current, other->reg)) {
+          continue;
+        }
+        if (!victim || other->spill_cost < victim->spill_cost ||
+            (other->spill_cost == victim->spill_cost &&
+             other->end > victim->end)) {
+          victim = other;
+          victim_position = cursor;
+        }
+      }
+
+      /* Spill whichever is cheaper to keep in memory. */
+      if (!victim || current->spill_cost < victim->spill_cost ||
+          (current->spill_cost == victim->spill_cost &&
+           current->end >= victim->end)) {
+        current->reg = IR_REGALLOC_SPILLED;
+        allocation->registers[current->slot] = IR_REGALLOC_SPILLED;
+        allocation->spill_count++;
+        continue;
+      }
+
+      reg = victim->reg;
+      victim->reg = IR_REGALLOC_SPILLED;
+      allocation->registers[victim->slot] = IR_REGALLOC_SPILLED;
+      allocation->spill_count++;
+      active[victim_position] = active[--active_count];
+    }
+
+    current->reg = reg;
+    allocation->registers[current->slot] = reg;
+    owner[reg] = (int)index;
+    active[active_count++] = index;
+    if (ir_regalloc_contains(target->callee_saved, target->callee_saved_count,
+                             reg)) {
+      allocation->callee_saved_used |= 1UL << reg;
+    }
+  }
+
+  free(active);
+  return 1;
+}
+
+static int ir_regalloc_same(const IrRegAllocation *allocation, size_t slot,
+                            int reg) {
+  return reg >= 0 && allocation->registers[slot] == reg;
+}
+
+/* Counts the copies the chosen registers made unnecessary. */
+static void ir_regalloc_count_coalesced(IrRegAllocState *state) {
+  IrFunction *function = state->function;
+  IrRegAllocation *allocation = state->allocation;
+  const IrRegAllocTarget *target = state->target;
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  size_t index = 0;
+  size_t slot = 0;
+
+  for (index = 0; index < function->param_count &&
+                  index < target->parameter_register_count;
+       index++) {
+    if (ir_regalloc_same(allocation, index,
+                         target->parameter_registers[index])) {
+      allocation->coalesced_count++;
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      size_t result = ir_regalloc_slot(function, &instr->value);
+      int reg = result == SIZE_MAX ? -1 : allocation->registers[result];
+
+      if (instr->opcode == IR_OP_PHI || ir_regalloc_is_copy(instr)) {
+        for (index = 0; index < instr->operand_count; index++) {
+          if (ir_regalloc_tracked(function, instr->operands[index], &slot) &&
+              ir_regalloc_same(allocation, slot, reg)) {
+            allocation->coalesced_count++;
+          }
+        }
+      } else if (instr->opcode == IR_OP_CALL) {
+        for (index = 1; index < instr->operand_count &&
+                        index - 1 < target->parameter_register_count;
+             index++) {
+          if (ir_regalloc_tracked(function, instr->operands[index], &slot) &&
+              ir_regalloc_same(allocation, slot,
+                               target->parameter_registers[index - 1])) {
+            allocation->coalesced_count++;
+          }
+        }
+      }
+    }
+  }
+}
+
+int ir_regalloc_run(IrFunction *function, const IrRegAllocTarget *target,
+                    IrRegAllocation *allocation) {
+  IrRegAllocState state;
+  size_t slot = 0;
+  int result = 0;
+
+  memset(allocation, 0, sizeof(*allocation));
+  memset(&state, 0, sizeof(state));
+  state.function = function;
+  state.target = target;
+  state.allocation = allocation;
+
+  if (!ir_function_compute_loop_depth(function) ||
+      !ir_regalloc_init(&state)) {
+    goto cleanup;
+  }
+
+  ir_regalloc_number(&state);
+  ir_regalloc_local_sets(&state);
+  ir_regalloc_liveness(&state);
+  if (!ir_regalloc_build_intervals(&state)) {
+    goto cleanup;
+  }
+
+  allocation->intervals =
+    malloc((allocation->slot_count + 1) * sizeof(IrLiveInterval));
+  if (!allocation->intervals) {
+    goto cleanup;
+  }
+
+  for (slot = 0; slot < allocation->slot_count; slot++) {
+    IrLiveInterval *interval = NULL;
+
+    if (state.starts[slot] == SIZE_MAX || !state.values[slot] ||
+        state.values[slot]->use_count == 0) {
+      continue;
+    }
+
+    interval = &allocation->intervals[allocation->interval_count++];
+    interval->value = state.values[slot];
+    interval->slot = slot;
+    interval->start = state.starts[slot];
+    interval->end = state.ends[slot];
+    interval->spill_cost = state.costs[slot];
+    interval->crosses_call =
+      ir_regalloc_crosses_call(&state, interval->start, interval->end);
+    interval->hint = state.hints[slot];
+    interval->reg = IR_REGALLOC_SPILLED;
+  }
+
+  qsort(allocation->intervals, allocation->interval_count,
+        sizeof(IrLiveInterval), ir_regalloc_compare);
+  if (!ir_regalloc_scan(&state)) {
+    goto cleanup;
+  }
+  ir_regalloc_count_coalesced(&state);
+  result = 1;
+
+cleanup:
+  ir_regalloc_free_state(&state);
+  if (!result) {
+    ir_regalloc_free(allocation);
+  }
+  return result;
+}
+
+void ir_regalloc_free(IrRegAllocation *allocation) {
+  free(allocation->registers);
+  free(allocation->intervals);
+  memset(allocation, 0, sizeof(*allocation));
+}
@@ -0,0 +1,718 @@
+#include "ir_pass.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Where an integer value sits in the lattice; it only ever moves down. */
+typedef enum IrSccpLevel {
+  /* Nothing executable has computed it yet. */
+  IR_SCCP_UNKNOWN,
+  IR_SCCP_CONSTANT,
+  IR_SCCP_OVERDEFINED
+} IrSccpLevel;
+
+typedef struct IrSccpCell {
+  IrSccpLevel level;
+  /* IR_SCCP_CONSTANT: wrapped to the value's width by ir_sccp_wrap. */
+  long long constant;
+} IrSccpCell;
+
+/*
+ * The state of one run over a function. Blocks are numbered by
+ * ir_function_build_cfg, values by instruction id.
+ */
+typedef struct IrSccp {
+  IrFunction *function;
+  size_t block_count;
+  char *executable;
+  /* block_count by block_count: edges[from * block_count + to]. */
+  char *edges;
+  size_t id_count;
+  IrSccpCell *cells;
+  /* The instructions using each value, users_of[id] into users. */
+  IrInstr **users;
+  size_t *users_of;
+  /* Blocks found executable whose instructions are still to visit. */
+  IrBlock **blocks;
+  size_t block_pending;
+  /* Instructions to visit again because an operand moved down. */
+  IrInstr **work;
+  size_t work_count;
+  size_t work_capacity;
+} IrSccp;
+
+static void ir_sccp_free(IrSccp *state) {
+  free(state->executable);
+  free(state->edges);
+  free(state->cells);
+  free(state->users);
+  free(state->users_of);
+  free(state->blocks);
+  free(state->work);
+}
+
+/*
+ * constant cut down to bits and sign-extended back to 64 bits; an i1 is
+ * 0 or 1, as the code generator writes it.
+ */
+static long long ir_sccp_wrap(long long constant, int bits) {
+  unsigned long long mask = 0;
+  unsigned long long value = (unsigned long long)constant;
+
+  if (bits >= 64) {
+    return constant;
+  }
+  if (bits == 1) {
+    return constant & 1;
+  }
+  mask = (1ull << bits) - 1;
+  value &= mask;
+  if (value & (1ull << (bits - 1))) {
+    value |= ~mask;
+  }
+  return (long long)value;
+}
+
+/* A wrapped constant read as a signed bits-bit integer. */
+static long long ir_sccp_signed(long long constant, int bits) {
+  return bits == 1 ? -(constant & 1) : constant;
+}
+
+/* A wrapped constant read as an unsigned bits-bit integer. */
+static unsigned long long ir_sccp_unsigned(long long constant, int bits) {
+  if (bits >= 64) {
+    return (unsigned long long)constant;
+  }
+  return (unsigned long long)constant & ((1ull << bits) - 1);
+}
+
+/* Integer results are tracked; everything else is overdefined. */
+static int ir_sccp_is_tracked(const IrSccp *state, const IrInstr *instr) {
+  return instr->id >= 0 && (size_t)instr->id < state->id_count &&
+         instr->value.type->kind == IR_TYPE_INT;
+}
+
+static IrSccpCell ir_sccp_cell(const IrSccp *state, const IrValue *value) {
+  IrSccpCell cell = {IR_SCCP_OVERDEFINED, 0};
+
+  if (value->kind == IR_VALUE_CONST_INT && value->type->kind == IR_TYPE_INT) {
+    cell.level = IR_SCCP_CONSTANT;
+    cell.constant = ir_sccp_wrap(value->constant, value->type->bits);
+  } else if (value->kind == IR_VALUE_INSTR &&
+             ir_sccp_is_tracked(state, value->instr)) {
+    cell = state->cells[value->instr->id];
+  }
+  return cell;
+}
+
+static IrSccpCell ir_sccp_meet(IrSccpCell left, IrSccpCell right) {
+  if (left.level == IR_SCCP_UNKNOWN) {
+    return right;
+  }
+  if (right.level == IR_SCCP_UNKNOWN) {
+    return left;
+  }
+  if (left.level == IR_SCCP_CONSTANT && right.level == IR_SCCP_CONSTANT &&
+      left.constant == right.constant) {
+    return left;
+  }
+  left.level = IR_SCCP_OVERDEFINED;
+  return left;
+}
+
+static int ir_sccp_push(IrSccp *state, IrInstr *instr) {
+  if (state->work_count == state->work_capacity) {
+    size_t capacity = state->work_capacity ? state->work_capacity * 2 : 64;
+    IrInstr **work = realloc(state->work, capacity * sizeof(*work));
+
+    if (!work) {
+      return 0;
+    }
+    state->work = work;
+    state->work_capacity = capacity;
+  }
+  state->work[state->work_count++] = instr;
+  return 1;
+}
+
+/* Moves instr's cell down to cell, queueing its users if it moved. */
+static int ir_sccp_lower(IrSccp *state, IrInstr *instr, IrSccpCell cell) {
+  IrSccpCell *current = NULL;
+  size_t index = 0;
+
+  if (!ir_sccp_is_tracked(state, instr)) {
+    return 1;
+  }
+  current = &state->cells[instr->id];
+  cell = ir_sccp_meet(*current, cell);
+  if (cell.level == current->level &&
+      (cell.level != IR_SCCP_CONSTANT || cell.constant == current->constant)) {
+    return 1;
+  }
+
+  *current = cell;
+  for (index = state->users_of[instr->id];
+       index < state->users_of[instr->id + 1]; index++) {
+    if (!ir_sccp_push(state, state->users[index])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static int ir_sccp_visit(IrSccp *state, IrInstr *instr);
+
+/*
+ * Marks the edge from -> to executable. A block reached for the first
+ * time is queued whole; otherwise only its phis have a new input.
+ */
+static int ir_sccp_mark_edge(IrSccp *state, IrBlock *from, IrBlock *to) {
+  size_t edge = from->index * state->block_count + to->index;
+  IrInstr *instr = NULL;
+
+  if (state->edges[edge]) {
+    return 1;
+  }
+  state->edges[edge] = 1;
+
+  if (!state->executable[to->index]) {
+    state->executable[to->index] = 1;
+    state->blocks[state->block_pending++] = to;
+    return 1;
+  }
+  for (instr = to->first; instr && instr->opcode == IR_OP_PHI;
+       instr = instr->next) {
+    if (!ir_sccp_visit(state, instr)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Marks the edges a branch may take, given what its condition is. */
+static int ir_sccp_branch(IrSccp *state, IrInstr *instr) {
+  IrBlock *block = instr->parent;
+  IrSccpCell cell = {IR_SCCP_OVERDEFINED, 0};
+  size_t index = 0;
+
+  if (instr->opcode == IR_OP_BR) {
+    return ir_sccp_mark_edge(state, block, instr->blocks[0]);
+  }
+
+  cell = ir_sccp_cell(state, instr->operands[0]);
+  if (cell.level == IR_SCCP_UNKNOWN) {
+    return 1;
+  }
+  if (cell.level == IR_SCCP_OVERDEFINED) {
+    for (index = 0; index < instr->block_count; index++) {
+      if (!ir_sccp_mark_edge(state, block, instr->blocks[index])) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+
+  if (instr->opcode == IR_OP_CONDBR) {
+    return ir_sccp_mark_edge(state, block,
+                             instr->blocks[cell.constant ? 0 : 1]);
+  }
+  for (index = 1; index < instr->operand_count; index++) {
+    IrSccpCell label = ir_sccp_cell(state, instr->operands[index]);
+
+    if (label.constant == cell.constant) {
+      return ir_sccp_mark_edge(state, block, instr->blocks[index]);
+    }
+  }
+  return ir_sccp_mark_edge(state, block, instr->blocks[0]);
+}
+
+/*
+ * Folds opcode over constant operands of width bits, into *result.
+ * Returns 0 for what has no single answer: division by zero, INT_MIN by
+ * -1, and shifts by the width or more.
+ */
+static int ir_sccp_fold_binary(IrOpcode opcode, int bits, long long left,
+                               long long right, long long *result) {
+  unsigned long long a = (unsigned long long)left;
+  unsigned long long b = (unsigned long long)right;
+  long long minimum = ir_sccp_wrap((long long)(1ull << (bits - 1)), bits);
+
+  switch (opcode) {
+  case IR_OP_ADD:
+    *result = (long long)(a + b);
+    break;
+  case IR_OP_SUB:
+    *result = (long long)(a - b);
+    break;
+  case IR_OP_MUL:
+    *result = (long long)(a * b);
+    break;
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+    left = ir_sccp_signed(left, bits);
+    right = ir_sccp_signed(right, bits);
+    if (right == 0 || (right == -1 && left == ir_sccp_signed(minimum, bits))) {
+      return 0;
+    }
+    *result = opcode == IR_OP_SDIV ? left / right : left % right;
+    break;
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+    b = ir_sccp_unsigned(right, bits);
+    if (b >= (unsigned long long)bits) {
+      return 0;
+    }
+    if (opcode == IR_OP_SHL) {
+      *result = (long long)(a << b);
+    } else if (opcode == IR_OP_LSHR) {
+      *result = (long long)(ir_sccp_unsigned(left, bits) >> b);
+    } else {
+      left = ir_sccp_signed(left, bits);
+      *result = left < 0 ? ~(~left >> b) : left >> b;
+    }
+    break;
+  case IR_OP_AND:
+    *result = (long long)(a & b);
+    break;
+  case IR_OP_OR:
+    *result = (long long)(a | b);
+    break;
+  case IR_OP_XOR:
+    *result = (long long)(a ^ b);
+    break;
+  default:
+    return 0;
+  }
+  *result = ir_sccp_wrap(*result, bits);
+  return 1;
+}
+
+static int ir_sccp_compare(IrPredicate predicate, int bits, long long left,
+                           long long right) {
+  long long sl = ir_sccp_signed(left, bits);
+  long long sr = ir_sccp_signed(right, bits);
+  unsigned long long ul = ir_sccp_unsigned(left, bits);
+  unsigned long long ur = ir_sccp_unsigned(right, bits);
+
+  switch (predicate) {
+  case IR_PRED_EQ:
+    return ul == ur;
+  case IR_PRED_NE:
+    return ul != ur;
+  case IR_PRED_SLT:
+    return sl < sr;
+  case IR_PRED_SLE:
+    return sl <= sr;
+  case IR_PRED_SGT:
+    return sl > sr;
+  case IR_PRED_SGE:
+    return sl >= sr;
+  case IR_PRED_ULT:
+    return ul < ur;
+  case IR_PRED_ULE:
+    return ul <= ur;
+  case IR_PRED_UGT:
+    return ul > ur;
+  case IR_PRED_UGE:
+    return ul >= ur;
+  }
+  return 0;
+}
+
+/* What instr computes from the cells of its operands. */
+static IrSccpCell ir_sccp_evaluate(const IrSccp *state, const IrInstr *instr) {
+  IrSccpCell result = {IR_SCCP_OVERDEFINED, 0};
+  IrSccpCell left = {IR_SCCP_OVERDEFINED, 0};
+  IrSccpCell right = {IR_SCCP_OVERDEFINED, 0};
+  int bits = instr->value.type->bits;
+  int from = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+  case IR_OP_ICMP:
+    left = ir_sccp_cell(state, instr->operands[0]);
+    right = ir_sccp_cell(state, instr->operands[1]);
+    break;
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+    left = ir_sccp_cell(state, instr->operands[0]);
+    right = left;
+    break;
+  default:
+    return result;
+  }
+
+  if (left.level == IR_SCCP_OVERDEFINED || right.level == IR_SCCP_OVERDEFINED) {
+    return result;
+  }
+  if (left.level == IR_SCCP_UNKNOWN || right.level == IR_SCCP_UNKNOWN) {
+    result.level = IR_SCCP_UNKNOWN;
+    return result;
+  }
+
+  from = instr->operands[0]->type->bits;
+  switch (instr->opcode) {
+  case IR_OP_ICMP:
+    result.constant =
+      ir_sccp_compare(instr->predicate, from, left.constant, right.constant);
+    break;
+  case IR_OP_SEXT:
+    result.constant = ir_sccp_wrap(ir_sccp_signed(left.constant, from), bits);
+    break;
+  case IR_OP_ZEXT:
+    result.constant =
+      ir_sccp_wrap((long long)ir_sccp_unsigned(left.constant, from), bits);
+    break;
+  case IR_OP_TRUNC:
+    result.constant = ir_sccp_wrap(left.constant, bits);
+    break;
+  default:
+    if (!ir_sccp_fold_binary(instr->opcode, bits, left.constant,
+                             right.constant, &result.constant)) {
+      return result;
+    }
+    break;
+  }
+  result.level = IR_SCCP_CONSTANT;
+  return result;
+}
+
+static int ir_sccp_visit(IrSccp *state, IrInstr *instr) {
+  IrBlock *block = instr->parent;
+  IrSccpCell cell = {IR_SCCP_UNKNOWN, 0};
+  size_t index = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_PHI:
+    for (index = 0; index < instr->operand_count; index++) {
+      size_t edge =
+        instr->blocks[index]->index * state->block_count + block->index;
+
+      if (state->edges[edge]) {
+        cell = ir_sccp_meet(cell, ir_sccp_cell(state, instr->operands[index]));
+      }
+    }
+    return ir_sccp_lower(state, instr, cell);
+  case IR_OP_BR:
+  case IR_OP_CONDBR:
+  case IR_OP_SWITCH:
+    return ir_sccp_branch(state, instr);
+  default:
+    if (!ir_sccp_is_tracked(state, instr)) {
+      return 1;
+    }
+    return ir_sccp_lower(state, instr, ir_sccp_evaluate(state, instr));
+  }
+}
+
+/* Visits queued instructions and newly executable blocks until both run out. */
+static int ir_sccp_solve(IrSccp *state) {
+  while (state->work_count > 0 || state->block_pending > 0) {
+    IrInstr *instr = NULL;
+
+    while (state->work_count > 0) {
+      instr = state->work[--state->work_count];
+      if (state->executable[instr->parent->index] &&
+          !ir_sccp_visit(state, instr)) {
+        return 0;
+      }
+    }
+    if (state->block_pending > 0) {
+      IrBlock *block = state->blocks[--state->block_pending];
+
+      for (instr = block->first; instr; instr = instr->next) {
+        if (!ir_sccp_visit(state, instr)) {
+          return 0;
+        }
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+ * A branch whose condition nothing executable ever computed has to be
+ * assumed to go anywhere. Sets *changed when that added an edge, so the
+ * solver can go on from there.
+ */
+static int ir_sccp_resolve_branches(IrSccp *state, int *changed) {
+  IrBlock *block = NULL;
+  size_t index = 0;
+
+  *changed = 0;
+  for (block = state->function->first_block; block; block = block->next) {
+    IrInstr *terminator = ir_block_terminator(block);
+
+    if (!state->executable[block->index] || !terminator ||
+        (terminator->opcode != IR_OP_CONDBR &&
+         terminator->opcode != IR_OP_SWITCH) ||
+        ir_sccp_cell(state, terminator->operands[0]).level !=
+          IR_SCCP_UNKNOWN) {
+      continue;
+    }
+    for (index = 0; index < terminator->block_count; index++) {
+      size_t edge = block->index * state->block_count +
+                    terminator->blocks[index]->index;
+
+      *changed |= !state->edges[edge];
+      if (!ir_sccp_mark_edge(state, block, terminator->blocks[index])) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static int ir_sccp_find_users(IrSccp *state) {
+  IrFunction *function = state->function;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  size_t *fill = NULL;
+  size_t index = 0;
+
+  state->users_of = calloc(state->id_count + 2, sizeof(*state->users_of));
+  fill = calloc(state->id_count + 1, sizeof(*fill));
+  if (!state->users_of || !fill) {
+    free(fill);
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *operand = instr->operands[index];
+
+        if (operand->kind == IR_VALUE_INSTR &&
+            ir_sccp_is_tracked(state, operand->instr)) {
+          state->users_of[operand->instr->id + 1]++;
+        }
+      }
+    }
+  }
+  for (index = 0; index < state->id_count; index++) {
+    state->users_of[index + 1] += state->users_of[index];
+  }
+
+  state->users =
+    malloc((state->users_of[state->id_count] + 1) * sizeof(*state->users));
+  if (!state->users) {
+    free(fill);
+    return 0;
+  }
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *operand = instr->operands[index];
+        size_t id = 0;
+
+        if (operand->kind != IR_VALUE_INSTR ||
+            !ir_sccp_is_tracked(state, operand->instr)) {
+          continue;
+        }
+        id = (size_t)operand->instr->id;
+        state->users[state->users_of[id] + fill[id]++] = instr;
+      }
+    }
+  }
+  free(fill);
+  return 1;
+}
+
+/* Drops block's phi incomings in every target of terminator but taken. */
+static void ir_sccp_drop_edges(const IrInstr *terminator,
+                               const IrBlock *taken) {
+  size_t index = 0;
+
+  for (index = 0; index < terminator->block_count; index++) {
+    IrInstr *phi = NULL;
+
+    if (terminator->blocks[index] == taken) {
+      continue;
+    }
+    for (phi = terminator->blocks[index]->first;
+         phi && phi->opcode == IR_OP_PHI; phi = phi->next) {
+      ir_phi_remove_incoming(phi, terminator->parent);
+    }
+  }
+}
+
+/* Turns a conditional branch or switch on a constant into a plain branch. */
+static int ir_sccp_fold_branch(IrSccp *state, IrBlock *block,
+                               size_t *changes) {
+  IrInstr *terminator = ir_block_terminator(block);
+  IrBlock *taken = NULL;
+  IrBuilder builder;
+  long long condition = 0;
+  long long label = 0;
+  size_t index = 0;
+
+  if (!terminator ||
+      (terminator->opcode != IR_OP_CONDBR &&
+       terminator->opcode != IR_OP_SWITCH) ||
+      !ir_value_is_const_int(terminator->operands[0], &condition)) {
+    return 1;
+  }
+
+  condition = ir_sccp_wrap(condition, terminator->operands[0]->type->bits);
+  if (terminator->opcode == IR_OP_CONDBR) {
+    taken = terminator->blocks[condition ? 0 : 1];
+  } else {
+    taken = terminator->blocks[0];
+    for (index = 1; index < terminator->operand_count; index++) {
+      ir_value_is_const_int(terminator->operands[index], &label);
+      if (ir_sccp_wrap(label, terminator->operands[0]->type->bits) ==
+          condition) {
+        taken = terminator->blocks[index];
+        break;
+      }
+    }
+  }
+
+  ir_sccp_drop_edges(terminator, taken);
+  ir_builder_init(&builder, state->function);
+  ir_builder_set_block(&builder, block);
+  builder.loc = terminator->loc;
+  ir_instr_remove(terminator);
+  if (!ir_build_br(&builder, taken)) {
+    return 0;
+  }
+  (*changes)++;
+  return 1;
+}
+
+/*
+ * Replaces every value proven constant with the constant, drops the
+ * instructions that computed them, folds the branches on constants, and
+ * removes the blocks that can no longer run.
+ */
+static int ir_sccp_rewrite(IrSccp *state, size_t *changes) {
+  IrFunction *function = state->function;
+  IrValue **replacement = NULL;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  size_t index = 0;
+
+  replacement = calloc(state->id_count + 1, sizeof(*replacement));
+  if (!replacement) {
+    return 0;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    if (!state->executable[block->index]) {
+      continue;
+    }
+    for (instr = block->first; instr; instr = instr->next) {
+      IrSccpCell cell = {IR_SCCP_OVERDEFINED, 0};
+
+      if (!ir_sccp_is_tracked(state, instr) ||
+          ir_instr_has_side_effects(instr)) {
+        continue;
+      }
+      cell = state->cells[instr->id];
+      if (cell.level != IR_SCCP_CONSTANT) {
+        continue;
+      }
+      replacement[instr->id] =
+        ir_const_int(function->module, instr->value.type, cell.constant);
+      if (!replacement[instr->id]) {
+        free(replacement);
+        return 0;
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *operand = instr->operands[index];
+
+        if (operand->kind == IR_VALUE_INSTR && operand->instr->id >= 0 &&
+            (size_t)operand->instr->id < state->id_count &&
+            replacement[operand->instr->id]) {
+          ir_instr_set_operand(instr, index, replacement[operand->instr->id]);
+        }
+      }
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = next) {
+      next = instr->next;
+      if (instr->id >= 0 && (size_t)instr->id < state->id_count &&
+          replacement[instr->id]) {
+        ir_instr_remove(instr);
+        (*changes)++;
+      }
+    }
+    if (state->executable[block->index] &&
+        !ir_sccp_fold_branch(state, block, changes)) {
+      free(replacement);
+      return 0;
+    }
+  }
+
+  free(replacement);
+  return ir_unreachable_function(function, changes);
+}
+
+/*
+ * Sparse conditional constant propagation, after Wegman and Zadeck: an
+ * optimistic walk that only follows the CFG edges a branch can take given
+ * what is known so far, and only revisits an instruction when one of its
+ * operands moves down the lattice. A phi ignores its inputs from edges
+ * that never run, so constants survive loops and branches that do.
+ */
+int ir_sccp_function(IrFunction *function, size_t *changes) {
+  IrSccp state;
+  size_t count = 0;
+  int changed = 1;
+  int ok = 0;
+
+  memset(&state, 0, sizeof(state));
+  state.function = function;
+  if (!function->first_block) {
+    return 1;
+  }
+  if (!ir_function_build_cfg(function)) {
+    return 0;
+  }
+
+  count = function->block_count;
+  state.block_count = count;
+  state.id_count = (size_t)function->next_value_id;
+  state.executable = calloc(count + 1, 1);
+  state.edges = calloc(count * count + 1, 1);
+  state.cells = calloc(state.id_count + 1, sizeof(*state.cells));
+  state.blocks = malloc((count + 1) * sizeof(*state.blocks));
+  if (!state.executable || !state.edges || !state.cells || !state.blocks ||
+      !ir_sccp_find_users(&state)) {
+    goto cleanup;
+  }
+
+  state.executable[function->first_block->index] = 1;
+  state.blocks[state.block_pending++] = function->first_block;
+  while (changed) {
+    if (!ir_sccp_solve(&state) ||
+        !ir_sccp_resolve_branches(&state, &changed)) {
+      goto cleanup;
+    }
+  }
+  ok = ir_sccp_rewrite(&state, changes);
+
+cleanup:
+  ir_sccp_free(&state);
+  return ok;
+}
@@ -0,0 +1,356 @@
+#include "ir_pass.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct IrSwitchCase {
+  long long value;
+  IrBlock *target;
+} IrSwitchCase;
+
+/* A run of sorted cases handled by one compare, or by one jump table. */
+typedef struct IrSwitchCluster {
+  size_t first;
+  size_t count;
+  int is_table;
+} IrSwitchCluster;
+
+typedef struct IrSwitchLowering {
+  IrFunction *function;
+  IrBlock *block;
+  IrValue *condition;
+  IrBlock *default_block;
+  IrSwitchCase *cases;
+  IrSwitchCluster *clusters;
+  size_t cluster_count;
+  /* The blocks the lowered switch spans, its own block first. */
+  IrBlock **blocks;
+  size_t block_count;
+  unsigned long suffix;
+} IrSwitchLowering;
+
+static int ir_switch_compare_cases(const void *left, const void *right) {
+  const IrSwitchCase *first = left;
+  const IrSwitchCase *second = right;
+
+  return (first->value > second->value) - (first->value < second->value);
+}
+
+/*
+ * Splits the sorted cases into clusters, greedily taking the longest run
+ * from each case on that is dense enough for a table, when tables are
+ * wanted at all.
+ */
+static void ir_switch_cluster(IrSwitchLowering *lowering, size_t count,
+                              int jump_tables) {
+  const IrSwitchCase *cases = lowering->cases;
+  size_t first = 0;
+  size_t last = 0;
+
+  lowering->cluster_count = 0;
+  while (first < count) {
+    IrSwitchCluster *cluster = &lowering->clusters[lowering->cluster_count++];
+    size_t best = first;
+
+    for (last = first + 1; jump_tables && last < count; last++) {
+      unsigned long long range = (unsigned long long)cases[last].value -
+                                 (unsigned long long)cases[first].value + 1;
+
+      if (range > IR_SWITCH_MAX_TABLE_RANGE) {
+        break;
+      }
+      if ((last - first + 1) * 100 >= range * IR_SWITCH_MIN_TABLE_DENSITY) {
+        best = last;
+      }
+    }
+
+    cluster->first = first;
+    cluster->count = 1;
+    cluster->is_table = 0;
+    if (best - first + 1 >= IR_SWITCH_MIN_TABLE_CASES) {
+      cluster->count = best - first + 1;
+      cluster->is_table = 1;
+    }
+    first += cluster->count;
+  }
+}
+
+static IrBlock *ir_switch_new_block(IrSwitchLowering *lowering) {
+  IrFunction *function = lowering->function;
+  IrBlock *after = lowering->blocks[lowering->block_count - 1];
+  const IrBlock *block = NULL;
+  IrBlock *created = NULL;
+  char name[256];
+
+  snprintf(name, sizeof(name), "%s.sw%lu", lowering->block->name,
+           ++lowering->suffix);
+  for (block = function->first_block; block;) {
+    if (strcmp(block->name, name) != 0) {
+      block = block->next;
+      continue;
+    }
+    snprintf(name, sizeof(name), "%s.sw%lu", lowering->block->name,
+             ++lowering->suffix);
+    block = function->first_block;
+  }
+
+  created = ir_block_create(function, name);
+  if (!created) {
+    return NULL;
+  }
+  ir_block_insert_after(created, after);
+  lowering->blocks[lowering->block_count++] = created;
+  return created;
+}
+
+static IrValue *ir_switch_constant(const IrSwitchLowering *lowering,
+                                   long long value) {
+  return ir_const_int(lowering->function->module, lowering->condition->type,
+                      value);
+}
+
+/*
+ * Emits the search over clusters [first, last) into block: a table
+ * cluster alone stays a switch, up to three single cases are compared in
+ * turn, and anything else splits at the middle cluster.
+ */
+static int ir_switch_emit(IrSwitchLowering *lowering, size_t first,
+                          size_t last, IrBlock *block) {
+  const IrSwitchCluster *clusters = lowering->clusters;
+  const IrSwitchCase *cases = lowering->cases;
+  IrBuilder builder;
+  IrBlock *left = NULL;
+  IrBlock *right = NULL;
+  IrValue *compare = NULL;
+  size_t index = 0;
+  int all_single = 1;
+
+  ir_builder_init(&builder, lowering->function);
+  ir_builder_set_block(&builder, block);
+
+  if (last - first == 1 && clusters[first].is_table) {
+    const IrSwitchCluster *cluster = &clusters[first];
+    IrValue *table = ir_build_switch(&builder, lowering->condition,
+                                     lowering->default_block);
+
+    for (index = cluster->first;
+         table && index < cluster->first + cluster->count; index++) {
+      if (!ir_switch_add_case(table->instr,
+                              ir_switch_constant(lowering, cases[index].value),
+                              cases[index].target)) {
+        return 0;
+      }
+    }
+    return table != NULL;
+  }
+
+  for (index = first; index < last; index++) {
+    all_single &= !clusters[index].is_table;
+  }
+
+  if (all_single && last - first <= 3) {
+    for (index = first; index < last; index++) {
+      const IrSwitchCase *single = &cases[clusters[index].first];
+      IrBlock *next = index + 1 < last ? ir_switch_new_block(lowering)
+                                       : lowering->default_block;
+
+      compare = ir_build_icmp(&builder, IR_PRED_EQ, lowering->condition,
+                              ir_switch_constant(lowering, single->value));
+      if (!next || !compare ||
+          !ir_build_condbr(&builder, compare, single->target, next)) {
+        return 0;
+      }
+      ir_builder_set_block(&builder, next);
+    }
+    return 1;
+  }
+
+  index = first + (last - first) / 2;
+  left = ir_switch_new_block(lowering);
+  right = left ? ir_switch_new_block(lowering) : NULL;
+  if (!right) {
+    return 0;
+  }
+  compare = ir_build_icmp(
+    &builder, IR_PRED_SLT, lowering->condition,
+    ir_switch_constant(lowering, cases[clusters[index].first].value));
+  if (!compare || !ir_build_condbr(&builder, compare, left, right)) {
+    return 0;
+  }
+  return ir_switch_emit(lowering, first, index, left) &&
+         ir_switch_emit(lowering, index, last, right);
+}
+
+/*
+ * Gives the phis of a former successor one incoming edge per block of the
+ * lowered switch that now branches to it, all with the value the switch's
+ * own edge carried.
+ */
+static int ir_switch_fix_phis(IrSwitchLowering *lowering, IrBlock *successor) {
+  IrInstr *phi = NULL;
+  size_t index = 0;
+  size_t block = 0;
+
+  for (phi = successor->first; phi && phi->opcode == IR_OP_PHI;
+       phi = phi->next) {
+    IrValue *incoming = NULL;
+    size_t kept = 0;
+
+    for (index = 0; index < phi->operand_count; index++) {
+      if (phi->blocks[index] == lowering->block) {
+        incoming = phi->operands[index];
+        phi->operands[index]->use_count--;
+        continue;
+      }
+      phi->operands[kept] = phi->operands[index];
+      phi->blocks[kept] = phi->blocks[index];
+      kept++;
+    }
+    phi->operand_count = kept;
+    phi->block_count = kept;
+    if (!incoming) {
+      continue;
+    }
+
+    for (block = 0; block < lowering->block_count; block++) {
+      const IrInstr *terminator =
+        ir_block_terminator(lowering->blocks[block]);
+
+      for (index = 0; index < terminator->block_count; index++) {
+        if (terminator->blocks[index] == successor) {
+          break;
+        }
+      }
+      if (index < terminator->block_count &&
+          !ir_phi_add_incoming(phi, incoming, lowering->blocks[block])) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static int ir_switch_lower(IrInstr *instr, int jump_tables, size_t *changes) {
+  IrSwitchLowering lowering;
+  IrBlock **successors = NULL;
+  size_t case_count = instr->operand_count - 1;
+  size_t successor_count = 0;
+  size_t index = 0;
+  size_t other = 0;
+  long long constant = 0;
+  int ok = 0;
+
+  memset(&lowering, 0, sizeof(lowering));
+  lowering.function = instr->parent->parent;
+  lowering.block = instr->parent;
+  lowering.condition = instr->operands[0];
+  lowering.default_block = instr->blocks[0];
+  lowering.cases = malloc((case_count + 1) * sizeof(*lowering.cases));
+  lowering.clusters = malloc((case_count + 1) * sizeof(*lowering.clusters));
+  /* A search splits into two blocks per cluster at most. */
+  lowering.blocks = malloc((2 * case_count + 2) * sizeof(*lowering.blocks));
+  successors = malloc(instr->block_count * sizeof(*successors));
+  if (!lowering.cases || !lowering.clusters || !lowering.blocks ||
+      !successors) {
+    goto cleanup;
+  }
+
+  for (index = 0; index < case_count; index++) {
+    lowering.cases[index].value = instr->operands[index + 1]->constant;
+    lowering.cases[index].target = instr->blocks[index + 1];
+  }
+  qsort(lowering.cases, case_count, sizeof(*lowering.cases),
+        ir_switch_compare_cases);
+  ir_switch_cluster(&lowering, case_count, jump_tables);
+  if (!ir_value_is_const_int(lowering.condition, &constant) &&
+      lowering.cluster_count == 1 && lowering.clusters[0].is_table) {
+    ok = 1;
+    goto cleanup;
+  }
+
+  for (index = 0; index < instr->block_count; index++) {
+    for (other = 0; other < successor_count; other++) {
+      if (successors[other] == instr->blocks[index]) {
+        break;
+      }
+    }
+    if (other == successor_count) {
+      successors[successor_count++] = instr->blocks[index];
+    }
+  }
+
+  lowering.blocks[lowering.block_count++] = lowering.block;
+  ir_instr_remove(instr);
+  if (ir_value_is_const_int(lowering.condition, &constant)) {
+    IrBlock *target = lowering.default_block;
+    IrBuilder builder;
+
+    for (index = 0; index < case_count; index++) {
+      if (lowering.cases[index].value == constant) {
+        target = lowering.cases[index].target;
+      }
+    }
+    ir_builder_init(&builder, lowering.function);
+    ir_builder_set_block(&builder, lowering.block);
+    if (!ir_build_br(&builder, target)) {
+      goto cleanup;
+    }
+  } else if (lowering.cluster_count == 0) {
+    IrBuilder builder;
+
+    ir_builder_init(&builder, lowering.function);
+    ir_builder_set_block(&builder, lowering.block);
+    if (!ir_build_br(&builder, lowering.default_block)) {
+      goto cleanup;
+    }
+  } else if (!ir_switch_emit(&lowering, 0, lowering.cluster_count,
+                             lowering.block)) {
+    goto cleanup;
+  }
+
+  for (index = 0; index < successor_count; index++) {
+    if (!ir_switch_fix_phis(&lowering, successors[index])) {
+      goto cleanup;
+    }
+  }
+  (*changes)++;
+  ok = 1;
+
+cleanup:
+  free(lowering.cases);
+  free(lowering.clusters);
+  free(lowering.blocks);
+  free(successors);
+  return ok;
+}
+
+int ir_switch_lower_function(IrFunction *function, int jump_tables,
+                             size_t *changes) {
+  IrBlock *block = NULL;
+  IrBlock *next = NULL;
+  IrInstr *terminator = NULL;
+  size_t lowered = 0;
+
+  /*
+   * The blocks a switch lowers into go in right after it and are skipped:
+   * the only switches in them are tables meant to stay.
+   */
+  for (block = function->first_block; block; block = next) {
+    next = block->next;
+    terminator = ir_block_terminator(block);
+    if (!terminator || terminator->opcode != IR_OP_SWITCH) {
+      continue;
+    }
+    if (!ir_switch_lower(terminator, jump_tables, &lowered)) {
+      return 0;
+    }
+  }
+
+  *changes += lowered;
+  return lowered == 0 || ir_function_build_cfg(function);
+}
+
+int ir_lowerswitch_function(IrFunction *function, size_t *changes) {
+  return ir_switch_lower_function(function, 0, changes);
+}
@@ -0,0 +1,327 @@
+#include "ir_pass.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Whether the address of some alloca can outlive an instruction that only
+ * reads or writes through it. A callee that could see the caller's frame
+ * rules out both reusing that frame and turning self calls into a loop.
+ */
+static int ir_tailcall_frame_escapes(const IrFunction *function,
+                                     int *escapes) {
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  char *derived = calloc((size_t)function->next_value_id + 1, 1);
+  int changed = 1;
+
+  if (!derived) {
+    return 0;
+  }
+
+  /* Allocas and the addresses computed from them, to a fixed point. */
+  while (changed) {
+    changed = 0;
+    for (block = function->first_block; block; block = block->next) {
+      for (instr = block->first; instr; instr = instr->next) {
+        const IrValue *base =
+          instr->operand_count > 0 ? instr->operands[0] : NULL;
+        int is_derived =
+          instr->opcode == IR_OP_ALLOCA ||
+          ((instr->opcode == IR_OP_GEP || instr->opcode == IR_OP_BITCAST) &&
+           base->kind == IR_VALUE_INSTR && derived[base->instr->id]);
+
+        if (is_derived && !derived[instr->id]) {
+          derived[instr->id] = 1;
+          changed = 1;
+        }
+      }
+    }
+  }
+
+  *escapes = 0;
+  for (block = function->first_block; block && !*escapes;
+       block = block->next) {
+    for (instr = block->first; instr && !*escapes; instr = instr->next) {
+      size_t index = 0;
+
+      for (index = 0; index < instr->operand_count; index++) {
+        const IrValue *operand = instr->operands[index];
+
+        if (operand->kind != IR_VALUE_INSTR || !derived[operand->instr->id]) {
+          continue;
+        }
+        /* Loads and stores through it, addresses, and comparisons. */
+        if ((instr->opcode == IR_OP_LOAD && index == 0) ||
+            (instr->opcode == IR_OP_STORE && index == 1) ||
+            (instr->opcode == IR_OP_GEP && index == 0) ||
+            instr->opcode == IR_OP_BITCAST || instr->opcode == IR_OP_ICMP) {
+          continue;
+        }
+        *escapes = 1;
+        break;
+      }
+    }
+  }
+
+  free(derived);
+  return 1;
+}
+
+/* The call whose result, if any, the ret right after it returns. */
+static int ir_tailcall_in_tail_position(const IrInstr *call) {
+  const IrInstr *ret = call->next;
+
+  if (call->opcode != IR_OP_CALL ||
+      call->operands[0]->kind != IR_VALUE_FUNCTION || !ret ||
+      ret->opcode != IR_OP_RET) {
+    return 0;
+  }
+  if (!ir_instr_has_result(call)) {
+    return ret->operand_count == 0;
+  }
+  return ret->operand_count == 1 && ret->operands[0] == &call->value;
+}
+
+/* Same return, parameter types, and calling convention: no ABI change. */
+static int ir_tailcall_signatures_match(const IrFunction *caller,
+                                        const IrFunction *callee) {
+  size_t index = 0;
+
+  if (ir_function_is_declaration(callee) ||
+      caller->return_type != callee->return_type ||
+      caller->param_count != callee->param_count ||
+      caller->calling_conv != callee->calling_conv) {
+    return 0;
+  }
+  for (index = 0; index < caller->param_count; index++) {
+    if (caller->params[index]->value.type !=
+        callee->params[index]->value.type) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Undoes a half-built header: the phis built so far give their uses back
+ * to the parameters, the header's instructions go back to the end of the
+ * entry block, and the header is detached and left to the module's arena.
+ */
+static void ir_tailcall_drop_header(IrFunction *function, IrBlock *header,
+                                    IrInstr **phis) {
+  IrBlock *entry = function->first_block;
+  IrInstr *moved = NULL;
+  size_t index = 0;
+
+  if (entry->last && entry->last->opcode == IR_OP_BR) {
+    ir_instr_remove(entry->last);
+  }
+  for (index = 0; index < function->param_count && phis[index]; index++) {
+    ir_replace_all_uses(function, &phis[index]->value,
+                        &function->params[index]->value);
+    ir_instr_remove(phis[index]);
+  }
+
+  for (moved = header->first; moved; moved = moved->next) {
+    moved->parent = entry;
+  }
+  if (header->first) {
+    header->first->prev = entry->last;
+    if (entry->last) {
+      entry->last->next = header->first;
+    } else {
+      entry->first = header->first;
+    }
+    entry->last = header->last;
+  }
+  header->first = NULL;
+  header->last = NULL;
+
+  for (index = 0; index < ir_block_successor_count(entry); index++) {
+    IrBlock *successor = ir_block_successor(entry, index);
+    IrInstr *phi = NULL;
+    size_t incoming = 0;
+
+    for (phi = successor->first; phi && phi->opcode == IR_OP_PHI;
+         phi = phi->next) {
+      for (incoming = 0; incoming < phi->block_count; incoming++) {
+        if (phi->blocks[incoming] == header) {
+          phi->blocks[incoming] = entry;
+        }
+      }
+    }
+  }
+  ir_block_remove(header);
+  free(phis);
+}
+
+/*
+ * Moves every alloca of the function to the start of the entry block, so
+ * none ends up inside the loop, where it would take a new slot on every
+ * trip. Returns the entry block's first other instruction.
+ */
+static IrInstr *ir_tailcall_gather_allocas(IrFunction *function) {
+  IrBlock *entry = function->first_block;
+  IrInstr *first = entry->first;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+
+  while (first->opcode == IR_OP_ALLOCA) {
+    first = first->next;
+  }
+  for (block = entry; block; block = block->next) {
+    for (instr = block == entry ? first : block->first; instr; instr = next) {
+      next = instr->next;
+      if (instr->opcode == IR_OP_ALLOCA) {
+        ir_instr_move_before(instr, first);
+      }
+    }
+  }
+  return first;
+}
+
+/*
+ * Moves everything after the entry block's allocas into a new loop header
+ * with one phi per parameter, which then stands in for the parameter.
+ */
+static IrBlock *ir_tailcall_make_header(IrFunction *function,
+                                        IrInstr ***phis_out) {
+  IrBlock *entry = function->first_block;
+  IrInstr *first = NULL;
+  IrInstr **phis = calloc(function->param_count + 1, sizeof(*phis));
+  char name[32] = "tailrecurse";
+  unsigned long suffix = 0;
+  IrBlock *header = NULL;
+  IrBlock *block = NULL;
+  IrBuilder builder;
+  size_t index = 0;
+
+  if (!phis) {
+    return NULL;
+  }
+
+  for (block = function->first_block; block;) {
+    if (strcmp(block->name, name) != 0) {
+      block = block->next;
+      continue;
+    }
+    snprintf(name, sizeof(name), "tailrecurse%lu", ++suffix);
+    block = function->first_block;
+  }
+
+  first = ir_tailcall_gather_allocas(function);
+  header = ir_block_split(first, name);
+  if (!header) {
+    free(phis);
+    return NULL;
+  }
+
+  ir_builder_init(&builder, function);
+  ir_builder_set_block(&builder, entry);
+  if (!ir_build_br(&builder, header)) {
+    ir_tailcall_drop_header(function, header, phis);
+    return NULL;
+  }
+
+  ir_builder_set_block(&builder, header);
+  for (index = 0; index < function->param_count; index++) {
+    IrValue *param = &function->params[index]->value;
+    IrValue *phi = ir_build_phi(&builder, param->type);
+
+    if (!phi) {
+      ir_tailcall_drop_header(function, header, phis);
+      return NULL;
+    }
+    ir_instr_move_before(phi->instr, first);
+    ir_replace_all_uses(function, param, phi);
+    phis[index] = phi->instr;
+    if (!ir_phi_add_incoming(phi->instr, param, entry)) {
+      ir_tailcall_drop_header(function, header, phis);
+      return NULL;
+    }
+  }
+
+  *phis_out = phis;
+  return header;
+}
+
+/*
+ * A self call in tail position becomes a branch back to the header that
+ * feeds the arguments to the parameter phis. Other calls in tail position
+ * are marked tail, and musttail when the callee has the caller's exact
+ * signature, so the backends can hand the frame over to the callee.
+ */
+int ir_tailcall_function(IrFunction *function, size_t *changes) {
+  IrBlock *header = NULL;
+  IrInstr **phis = NULL;
+  IrBlock *block = NULL;
+  IrInstr *instr = NULL;
+  IrInstr *next = NULL;
+  int escapes = 0;
+
+  if (!ir_tailcall_frame_escapes(function, &escapes)) {
+    return 0;
+  }
+  if (escapes) {
+    return 1;
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = next) {
+      const IrFunction *callee = NULL;
+      IrInstr *ret = NULL;
+      IrBuilder builder;
+      size_t index = 0;
+
+      next = instr->next;
+      if (!ir_tailcall_in_tail_position(instr)) {
+        continue;
+      }
+
+      callee = instr->operands[0]->function;
+      if (callee != function) {
+        if (!(instr->flags & (IR_FLAG_TAIL | IR_FLAG_MUSTTAIL))) {
+          instr->flags |= ir_tailcall_signatures_match(function, callee)
+                            ? IR_FLAG_MUSTTAIL
+                            : IR_FLAG_TAIL;
+          (*changes)++;
+        }
+        continue;
+      }
+
+      if (!header) {
+        header = ir_tailcall_make_header(function, &phis);
+        if (!header) {
+          return 0;
+        }
+      }
+
+      /* The call sits in whatever block it sat in; only the ret goes. */
+      block = instr->parent;
+      for (index = 0; index < function->param_count; index++) {
+        if (!ir_phi_add_incoming(phis[index], instr->operands[index + 1],
+                                 block)) {
+          free(phis);
+          return 0;
+        }
+      }
+      ret = instr->next;
+      ir_instr_remove(ret);
+      ir_instr_remove(instr);
+      ir_builder_init(&builder, function);
+      ir_builder_set_block(&builder, block);
+      if (!ir_build_br(&builder, header)) {
+        free(phis);
+        return 0;
+      }
+      (*changes)++;
+      next = NULL;
+    }
+  }
+
+  free(phis);
+  return 1;
+}
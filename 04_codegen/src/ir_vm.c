@@ -0,0 +1,1726 @@
+/* RTLD_DEFAULT */
+#define _GNU_SOURCE
+
+#include "ir_vm.h"
+
+#include "ir_jit.h"
+
+#include <ctype.h>
+#include <dlfcn.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Sizes of the interpreter stacks, reserved once per IrVm. */
+#define IR_VM_REGISTER_WORDS ((size_t)1 << 22)
+#define IR_VM_STACK_BYTES ((size_t)16 << 20)
+#define IR_VM_FRAMES ((size_t)1 << 20)
+
+/* Limits a loaded image has to respect. */
+#define IR_VM_MAX_REGISTERS ((size_t)1 << 20)
+#define IR_VM_MAX_ALIGN 16
+
+static const char ir_vm_magic[8] = {'B', 'A', 'S', 'E', 'C', 'C', 'V', 'M'};
+#define IR_VM_IMAGE_VERSION 3
+
+/* Opcodes an image may use: all but the quickened ones. */
+enum {
+#define IR_VM_OPCODE_ONE(name, operands) +1
+  IR_VM_IMAGE_OPCODE_COUNT = 0 IR_VM_OPCODES(IR_VM_OPCODE_ONE)
+#undef IR_VM_OPCODE_ONE
+};
+
+static const char *const ir_vm_opcode_names[] = {
+#define IR_VM_OPCODE_NAME(name, operands) #name,
+  IR_VM_OPCODES(IR_VM_OPCODE_NAME) IR_VM_QUICK_OPCODES(IR_VM_OPCODE_NAME)
+#undef IR_VM_OPCODE_NAME
+};
+
+static const char *const ir_vm_opcode_operand_letters[] = {
+#define IR_VM_OPCODE_LETTERS(name, operands) operands,
+  IR_VM_OPCODES(IR_VM_OPCODE_LETTERS) IR_VM_QUICK_OPCODES(IR_VM_OPCODE_LETTERS)
+#undef IR_VM_OPCODE_LETTERS
+};
+
+static const char *const ir_vm_type_names[] = {
+  "void", "i1", "i8", "i16", "i32", "i64", "ptr",
+};
+
+/* The C spelling of each type in generated host entry points. */
+static const char *const ir_vm_type_c_names[] = {
+  "void", "_Bool", "signed char", "short", "int", "long long", "void *",
+};
+
+/* The caller state a call saves. */
+struct IrVmFrame {
+  const IrVmFunction *function;
+  IrVmWord *code;
+  IrVmWord *pc;
+  IrVmWord *registers;
+  unsigned char *stack;
+  /* Caller register receiving the return value. */
+  IrVmWord result;
+};
+
+typedef struct IrVmBuffer {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+  int out_of_memory;
+} IrVmBuffer;
+
+typedef struct IrVmReader {
+  const unsigned char *data;
+  size_t size;
+  size_t offset;
+} IrVmReader;
+
+void ir_vm_program_init(IrVmProgram *program) {
+  memset(program, 0, sizeof(*program));
+}
+
+void ir_vm_program_free(IrVmProgram *program) {
+  size_t index = 0;
+
+  for (index = 0; index < program->function_count; index++) {
+    IrVmFunction *function = &program->functions[index];
+
+    free(function->name);
+    free(function->params);
+    free(function->constants);
+    free(function->code);
+  }
+  for (index = 0; index < program->global_count; index++) {
+    free(program->globals[index].name);
+    free(program->globals[index].inits);
+  }
+  for (index = 0; index < program->native_count; index++) {
+    free(program->natives[index].name);
+  }
+
+  free(program->functions);
+  free(program->globals);
+  free(program->natives);
+  ir_vm_program_init(program);
+}
+
+const char *ir_vm_opcode_name(IrVmOpcode opcode) {
+  return ir_vm_opcode_names[opcode];
+}
+
+const char *ir_vm_opcode_operands(IrVmOpcode opcode) {
+  return ir_vm_opcode_operand_letters[opcode];
+}
+
+size_t ir_vm_instr_size(const IrVmWord *code) {
+  const char *letter = ir_vm_opcode_operands((IrVmOpcode)code[0]);
+  size_t size = 1;
+
+  for (; *letter; letter++) {
+    size += *letter == 'a' ? 1 + (size_t)code[size] : 1;
+  }
+
+  return size;
+}
+
+int ir_vm_find_function(const IrVmProgram *program, const char *name,
+                        size_t *index) {
+  size_t candidate = 0;
+
+  for (candidate = 0; candidate < program->function_count; candidate++) {
+    if (strcmp(program->functions[candidate].name, name) == 0) {
+      *index = candidate;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static void ir_vm_dump_instr(const IrVmProgram *program, const IrVmWord *code,
+                             FILE *out) {
+  const char *name = ir_vm_opcode_name((IrVmOpcode)code[0]);
+  const char *letter = ir_vm_opcode_operands((IrVmOpcode)code[0]);
+  size_t word = 1;
+  size_t index = 0;
+
+  for (; *name; name++) {
+    fputc(tolower((unsigned char)*name), out);
+  }
+
+  for (; *letter; letter++, word++) {
+    fputs(word == 1 ? " " : ", ", out);
+    switch (*letter) {
+    case 'r':
+      fprintf(out, "r%lld", code[word]);
+      break;
+    case 'i':
+      fprintf(out, "%lld", code[word]);
+      break;
+    case 't':
+      fprintf(out, "@%lld", code[word]);
+      break;
+    case 'f':
+      fprintf(out, "%s", program->functions[code[word]].name);
+      break;
+    case 'n':
+      fprintf(out, "%s", program->natives[code[word]].name);
+      break;
+    default:
+      fputc('(', out);
+      for (index = 0; index < (size_t)code[word]; index++) {
+        fprintf(out, "%sr%lld", index ? ", " : "", code[word + 1 + index]);
+      }
+      fputc(')', out);
+      word += (size_t)code[word];
+      break;
+    }
+  }
+  fputc('\n', out);
+}
+
+static void ir_vm_dump_function(const IrVmProgram *program,
+                                const IrVmFunction *function, FILE *out) {
+  size_t index = 0;
+
+  fprintf(out, "\nfunction %s%s(", function->is_exported ? "" : "static ",
+          function->name);
+  for (index = 0; index < function->param_count; index++) {
+    fprintf(out, "%s%s", index ? ", " : "",
+            ir_vm_type_names[function->params[index]]);
+  }
+  fprintf(out, ") -> %s\n", ir_vm_type_names[function->return_type]);
+  fprintf(out, "  registers %zu, frame %zu\n", function->register_count,
+          function->frame_size);
+
+  for (index = 0; index < function->constant_count; index++) {
+    const IrVmConstant *constant = &function->constants[index];
+
+    fprintf(out, "  r%zu = ", function->constant_base + index);
+    if (constant->kind == IR_VM_CONST_GLOBAL) {
+      fprintf(out, "&%s\n", program->globals[constant->value].name);
+    } else if (constant->kind == IR_VM_CONST_NATIVE) {
+      fprintf(out, "&%s\n", program->natives[constant->value].name);
+    } else {
+      fprintf(out, "%lld\n", constant->value);
+    }
+  }
+
+  for (index = 0; index < function->code_size;
+       index += ir_vm_instr_size(&function->code[index])) {
+    fprintf(out, "  %4zu  ", index);
+    ir_vm_dump_instr(program, &function->code[index], out);
+  }
+}
+
+void ir_vm_dump_program(const IrVmProgram *program, FILE *out) {
+  size_t index = 0;
+  size_t item = 0;
+
+  for (index = 0; index < program->native_count; index++) {
+    fprintf(out, "native %s -> %s\n", program->natives[index].name,
+            ir_vm_type_names[program->natives[index].return_type]);
+  }
+  for (index = 0; index < program->global_count; index++) {
+    const IrVmGlobal *global = &program->globals[index];
+
+    fprintf(out, "global %s, size %zu, align %zu", global->name, global->size,
+            global->align);
+    for (item = 0; item < global->init_count; item++) {
+      const IrVmInit *init = &global->inits[item];
+
+      fprintf(out, item == 0 ? " =" : ",");
+      if (init->offset != 0 || global->init_count > 1) {
+        fprintf(out, " +%zu", init->offset);
+      }
+      if (init->kind == IR_VM_INIT_INT) {
+        fprintf(out, " %lld", init->value);
+      } else {
+        fprintf(out, " &%s", program->globals[init->value].name);
+      }
+    }
+    fputc('\n', out);
+  }
+  for (index = 0; index < program->function_count; index++) {
+    ir_vm_dump_function(program, &program->functions[index], out);
+  }
+}
+
+static void ir_vm_buffer_append(IrVmBuffer *buffer, const void *data,
+                                size_t size) {
+  unsigned char *grown = NULL;
+  size_t capacity = buffer->capacity ? buffer->capacity : 256;
+
+  if (buffer->out_of_memory) {
+    return;
+  }
+
+  while (capacity - buffer->size < size) {
+    capacity *= 2;
+  }
+  if (capacity != buffer->capacity) {
+    grown = realloc(buffer->data, capacity);
+    if (!grown) {
+      buffer->out_of_memory = 1;
+      return;
+    }
+    buffer->data = grown;
+    buffer->capacity = capacity;
+  }
+
+  memcpy(buffer->data + buffer->size, data, size);
+  buffer->size += size;
+}
+
+static void ir_vm_buffer_word(IrVmBuffer *buffer, long long value) {
+  unsigned char bytes[8];
+  size_t index = 0;
+
+  for (index = 0; index < sizeof(bytes); index++) {
+    bytes[index] = (unsigned char)((unsigned long long)value >> (8 * index));
+  }
+  ir_vm_buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void ir_vm_buffer_string(IrVmBuffer *buffer, const char *text) {
+  size_t length = strlen(text);
+
+  ir_vm_buffer_word(buffer, (long long)length);
+  ir_vm_buffer_append(buffer, text, length);
+}
+
+static int ir_vm_encode_image(const IrVmProgram *program, IrVmBuffer *buffer) {
+  size_t index = 0;
+  size_t item = 0;
+
+  memset(buffer, 0, sizeof(*buffer));
+  ir_vm_buffer_append(buffer, ir_vm_magic, sizeof(ir_vm_magic));
+  ir_vm_buffer_word(buffer, IR_VM_IMAGE_VERSION);
+
+  ir_vm_buffer_word(buffer, (long long)program->native_count);
+  for (index = 0; index < program->native_count; index++) {
+    ir_vm_buffer_string(buffer, program->natives[index].name);
+    ir_vm_buffer_word(buffer, program->natives[index].return_type);
+  }
+
+  ir_vm_buffer_word(buffer, (long long)program->global_count);
+  for (index = 0; index < program->global_count; index++) {
+    const IrVmGlobal *global = &program->globals[index];
+
+    ir_vm_buffer_string(buffer, global->name);
+    ir_vm_buffer_word(buffer, (long long)global->size);
+    ir_vm_buffer_word(buffer, (long long)global->align);
+    ir_vm_buffer_word(buffer, (long long)global->init_count);
+    for (item = 0; item < global->init_count; item++) {
+      ir_vm_buffer_word(buffer, global->inits[item].kind);
+      ir_vm_buffer_word(buffer, (long long)global->inits[item].offset);
+      ir_vm_buffer_word(buffer, (long long)global->inits[item].size);
+      ir_vm_buffer_word(buffer, global->inits[item].value);
+    }
+  }
+
+  ir_vm_buffer_word(buffer, (long long)program->function_count);
+  for (index = 0; index < program->function_count; index++) {
+    const IrVmFunction *function = &program->functions[index];
+
+    ir_vm_buffer_string(buffer, function->name);
+    ir_vm_buffer_word(buffer, function->is_exported);
+    ir_vm_buffer_word(buffer, function->return_type);
+    ir_vm_buffer_word(buffer, (long long)function->param_count);
+    for (item = 0; item < function->param_count; item++) {
+      ir_vm_buffer_word(buffer, function->params[item]);
+    }
+    ir_vm_buffer_word(buffer, (long long)function->register_count);
+    ir_vm_buffer_word(buffer, (long long)function->constant_base);
+    ir_vm_buffer_word(buffer, (long long)function->constant_count);
+    for (item = 0; item < function->constant_count; item++) {
+      ir_vm_buffer_word(buffer, function->constants[item].kind);
+      ir_vm_buffer_word(buffer, function->constants[item].value);
+    }
+    ir_vm_buffer_word(buffer, (long long)function->frame_size);
+    ir_vm_buffer_word(buffer, (long long)function->code_size);
+    for (item = 0; item < function->code_size; item++) {
+      ir_vm_buffer_word(buffer, function->code[item]);
+    }
+  }
+
+  if (buffer->out_of_memory) {
+    free(buffer->data);
+    return 0;
+  }
+  return 1;
+}
+
+int ir_vm_write_image(const IrVmProgram *program, FILE *out) {
+  IrVmBuffer buffer;
+  int result = 0;
+
+  if (!ir_vm_encode_image(program, &buffer)) {
+    return 0;
+  }
+
+  result = fwrite(buffer.data, 1, buffer.size, out) == buffer.size;
+  free(buffer.data);
+  return result && !ferror(out);
+}
+
+static int ir_vm_read_word(IrVmReader *reader, long long *value) {
+  unsigned long long bits = 0;
+  size_t index = 0;
+
+  if (reader->size - reader->offset < 8) {
+    return 0;
+  }
+
+  for (index = 0; index < 8; index++) {
+    bits |= (unsigned long long)reader->data[reader->offset + index]
+            << (8 * index);
+  }
+  reader->offset += 8;
+  *value = (long long)bits;
+  return 1;
+}
+
+/* Reads a count of items at least `item_size` bytes each. */
+static int ir_vm_read_count(IrVmReader *reader, size_t item_size,
+                            size_t *count) {
+  long long value = 0;
+
+  if (!ir_vm_read_word(reader, &value) || value < 0 ||
+      (unsigned long long)value > (reader->size - reader->offset) / item_size) {
+    return 0;
+  }
+
+  *count = (size_t)value;
+  return 1;
+}
+
+static int ir_vm_read_size(IrVmReader *reader, size_t limit, size_t *size) {
+  long long value = 0;
+
+  if (!ir_vm_read_word(reader, &value) || value < 0 ||
+      (unsigned long long)value > limit) {
+    return 0;
+  }
+
+  *size = (size_t)value;
+  return 1;
+}
+
+static int ir_vm_read_type(IrVmReader *reader, IrVmType *type) {
+  size_t value = 0;
+
+  if (!ir_vm_read_size(reader, IR_VM_TYPE_PTR, &value)) {
+    return 0;
+  }
+
+  *type = (IrVmType)value;
+  return 1;
+}
+
+static int ir_vm_read_string(IrVmReader *reader, char **text) {
+  size_t length = 0;
+
+  if (!ir_vm_read_count(reader, 1, &length)) {
+    return 0;
+  }
+
+  *text = malloc(length + 1);
+  if (!*text) {
+    return 0;
+  }
+  memcpy(*text, reader->data + reader->offset, length);
+  (*text)[length] = '\0';
+  reader->offset += length;
+  return 1;
+}
+
+static int ir_vm_is_terminator(IrVmWord opcode) {
+  return opcode == IR_VM_OP_JMP || opcode == IR_VM_OP_RET ||
+         opcode == IR_VM_OP_RET_VOID;
+}
+
+/*
+ * Checks every operand of every instruction against the tables and the
+ * function's registers, and that control cannot fall off the end.
+ */
+static int ir_vm_validate_function(const IrVmProgram *program,
+                                   const IrVmFunction *function) {
+  unsigned char *starts = NULL;
+  size_t offset = 0;
+  size_t last = 0;
+  int valid = 1;
+
+  if (function->code_size == 0) {
+    return 0;
+  }
+
+  starts = calloc(function->code_size, 1);
+  if (!starts) {
+    return 0;
+  }
+
+  for (offset = 0; offset < function->code_size && valid;) {
+    const IrVmWord *code = &function->code[offset];
+    size_t available = function->code_size - offset;
+    const char *letter = NULL;
+    const IrVmFunction *callee = NULL;
+    size_t word = 1;
+
+    if (code[0] < 0 || code[0] >= IR_VM_IMAGE_OPCODE_COUNT) {
+      valid = 0;
+      break;
+    }
+
+    starts[offset] = 1;
+    for (letter = ir_vm_opcode_operands((IrVmOpcode)code[0]);
+         *letter && valid; letter++, word++) {
+      IrVmWord operand = word < available ? code[word] : -1;
+      size_t index = 0;
+
+      if (word >= available) {
+        valid = 0;
+      } else if (*letter == 'r') {
+        valid = operand >= 0 && (size_t)operand < function->register_count;
+      } else if (*letter == 't') {
+        valid = operand >= 0 && (size_t)operand < function->code_size;
+      } else if (*letter == 'f') {
+        valid = operand >= 0 && (size_t)operand < program->function_count;
+        callee = valid ? &program->functions[operand] : NULL;
+      } else if (*letter == 'n') {
+        valid = operand >= 0 && (size_t)operand < program->native_count;
+      } else if (*letter == 'a') {
+        valid = operand >= 0 && (size_t)operand < available - word &&
+                (callee ? (size_t)operand == callee->param_count
+                        : operand <= IR_VM_NATIVE_ARGS);
+        for (index = 0; valid && index < (size_t)operand; index++) {
+          IrVmWord reg = code[word + 1 + index];
+
+          valid = reg >= 0 && (size_t)reg < function->register_count;
+        }
+        word += valid ? (size_t)operand : 0;
+      }
+    }
+
+    if (valid && code[0] == IR_VM_OP_FRAME) {
+      valid = code[2] >= 0 && (size_t)code[2] <= function->frame_size;
+    } else if (valid && (code[0] == IR_VM_OP_WRAP || code[0] == IR_VM_OP_ADD ||
+                         code[0] == IR_VM_OP_SUB || code[0] == IR_VM_OP_MUL ||
+                         code[0] == IR_VM_OP_SDIV ||
+                         code[0] == IR_VM_OP_SREM || code[0] == IR_VM_OP_SHL ||
+                         code[0] == IR_VM_OP_LSHR)) {
+      /* The wrap shift is always the last operand. */
+      valid = code[word - 1] >= 0 && code[word - 1] < 64;
+    }
+
+    last = offset;
+    offset += word;
+  }
+
+  valid = valid && offset == function->code_size &&
+          ir_vm_is_terminator(function->code[last]);
+
+  /* Branches have to land on an instruction. */
+  for (offset = 0; offset < function->code_size && valid;
+       offset += ir_vm_instr_size(&function->code[offset])) {
+    const IrVmWord *code = &function->code[offset];
+    const char *letter = ir_vm_opcode_operands((IrVmOpcode)code[0]);
+    size_t word = 1;
+
+    for (; *letter; letter++, word++) {
+      if (*letter == 't' && !starts[code[word]]) {
+        valid = 0;
+      }
+    }
+  }
+
+  free(starts);
+  return valid;
+}
+
+/*
+ * A global and its initializer pieces, which must lie inside it in
+ * increasing order and refer only to globals of the program.
+ */
+static int ir_vm_read_global(IrVmReader *reader, IrVmGlobal *global,
+                             size_t global_count) {
+  size_t end = 0;
+  size_t item = 0;
+  size_t value = 0;
+
+  if (!ir_vm_read_string(reader, &global->name) ||
+      !ir_vm_read_size(reader, IR_VM_STACK_BYTES, &global->size) ||
+      !ir_vm_read_size(reader, IR_VM_MAX_ALIGN, &global->align) ||
+      global->align == 0 || (global->align & (global->align - 1)) != 0 ||
+      !ir_vm_read_count(reader, 32, &global->init_count)) {
+    return 0;
+  }
+
+  global->inits =
+    calloc(global->init_count ? global->init_count : 1, sizeof(IrVmInit));
+  if (!global->inits) {
+    return 0;
+  }
+  for (item = 0; item < global->init_count; item++) {
+    IrVmInit *init = &global->inits[item];
+
+    if (!ir_vm_read_size(reader, IR_VM_INIT_ADDRESS, &value) ||
+        !ir_vm_read_size(reader, global->size, &init->offset) ||
+        !ir_vm_read_size(reader, 8, &init->size) ||
+        !ir_vm_read_word(reader, &init->value)) {
+      return 0;
+    }
+    init->kind = (IrVmInitKind)value;
+    if (init->offset < end || init->size == 0 ||
+        init->size > global->size - init->offset ||
+        (init->kind == IR_VM_INIT_ADDRESS &&
+         (init->size != 8 || init->value < 0 ||
+          (unsigned long long)init->value >= global_count))) {
+      return 0;
+    }
+    end = init->offset + init->size;
+  }
+  return 1;
+}
+
+static int ir_vm_read_function(IrVmReader *reader, IrVmFunction *function,
+                               const IrVmProgram *program) {
+  size_t item = 0;
+  size_t value = 0;
+
+  if (!ir_vm_read_string(reader, &function->name) ||
+      !ir_vm_read_size(reader, 1, &value) ||
+      !ir_vm_read_type(reader, &function->return_type) ||
+      !ir_vm_read_count(reader, 8, &function->param_count)) {
+    return 0;
+  }
+  function->is_exported = (int)value;
+
+  function->params =
+    malloc((function->param_count ? function->param_count : 1) *
+           sizeof(*function->params));
+  if (!function->params) {
+    return 0;
+  }
+  for (item = 0; item < function->param_count; item++) {
+    if (!ir_vm_read_type(reader, &function->params[item]) ||
+        function->params[item] == IR_VM_TYPE_VOID) {
+      return 0;
+    }
+  }
+
+  if (!ir_vm_read_size(reader, IR_VM_MAX_REGISTERS,
+                       &function->register_count) ||
+      !ir_vm_read_size(reader, function->register_count,
+                       &function->constant_base) ||
+      !ir_vm_read_count(reader, 16, &function->constant_count) ||
+      function->param_count > function->register_count ||
+      function->constant_count >
+        function->register_count - function->constant_base) {
+    return 0;
+  }
+
+  function->constants =
+    malloc((function->constant_count ? function->constant_count : 1) *
+           sizeof(*function->constants));
+  if (!function->constants) {
+    return 0;
+  }
+  for (item = 0; item < function->constant_count; item++) {
+    IrVmConstant *constant = &function->constants[item];
+    size_t limit = 0;
+
+    if (!ir_vm_read_size(reader, IR_VM_CONST_NATIVE, &value) ||
+        !ir_vm_read_word(reader, &constant->value)) {
+      return 0;
+    }
+    constant->kind = (IrVmConstantKind)value;
+    limit = constant->kind == IR_VM_CONST_GLOBAL ? program->global_count
+                                                 : program->native_count;
+    if (constant->kind != IR_VM_CONST_INT &&
+        (constant->value < 0 || (size_t)constant->value >= limit)) {
+      return 0;
+    }
+  }
+
+  if (!ir_vm_read_size(reader, IR_VM_STACK_BYTES, &function->frame_size) ||
+      function->frame_size % 16 != 0 ||
+      !ir_vm_read_count(reader, 8, &function->code_size)) {
+    return 0;
+  }
+
+  function->code = malloc((function->code_size ? function->code_size : 1) *
+                          sizeof(*function->code));
+  if (!function->code) {
+    return 0;
+  }
+  for (item = 0; item < function->code_size; item++) {
+    ir_vm_read_word(reader, &function->code[item]);
+  }
+
+  return 1;
+}
+
+static int ir_vm_read_program(IrVmReader *reader, IrVmProgram *program) {
+  long long version = 0;
+  size_t count = 0;
+  size_t index = 0;
+
+  if (reader->size < sizeof(ir_vm_magic) ||
+      memcmp(reader->data, ir_vm_magic, sizeof(ir_vm_magic)) != 0) {
+    return 0;
+  }
+  reader->offset = sizeof(ir_vm_magic);
+  if (!ir_vm_read_word(reader, &version) || version != IR_VM_IMAGE_VERSION) {
+    return 0;
+  }
+
+  if (!ir_vm_read_count(reader, 16, &count)) {
+    return 0;
+  }
+  program->natives = calloc(count + 1, sizeof(IrVmNative));
+  if (!program->natives) {
+    return 0;
+  }
+  program->native_count = count;
+  for (index = 0; index < program->native_count; index++) {
+    if (!ir_vm_read_string(reader, &program->natives[index].name) ||
+        !ir_vm_read_type(reader, &program->natives[index].return_type)) {
+      return 0;
+    }
+  }
+
+  if (!ir_vm_read_count(reader, 32, &count)) {
+    return 0;
+  }
+  program->globals = calloc(count + 1, sizeof(IrVmGlobal));
+  if (!program->globals) {
+    return 0;
+  }
+  program->global_count = count;
+  for (index = 0; index < program->global_count; index++) {
+    if (!ir_vm_read_global(reader, &program->globals[index], count)) {
+      return 0;
+    }
+  }
+
+  if (!ir_vm_read_count(reader, 64, &count)) {
+    return 0;
+  }
+  program->functions = calloc(count + 1, sizeof(IrVmFunction));
+  if (!program->functions) {
+    return 0;
+  }
+  program->function_count = count;
+  for (index = 0; index < program->function_count; index++) {
+    if (!ir_vm_read_function(reader, &program->functions[index], program)) {
+      return 0;
+    }
+  }
+  for (index = 0; index < program->function_count; index++) {
+    if (!ir_vm_validate_function(program, &program->functions[index])) {
+      return 0;
+    }
+  }
+
+  return reader->offset == reader->size;
+}
+
+int ir_vm_read_image(IrVmProgram *program, const unsigned char *data,
+                     size_t size, const char **message) {
+  IrVmReader reader;
+
+  ir_vm_program_init(program);
+  reader.data = data;
+  reader.size = size;
+  reader.offset = 0;
+
+  if (!ir_vm_read_program(&reader, program)) {
+    ir_vm_program_free(program);
+    if (message) {
+      *message = "vm: malformed bytecode image";
+    }
+    return 0;
+  }
+
+  return 1;
+}
+
+/* Writes a C declaration of name with the type, as in "void *p0". */
+static void ir_vm_write_c_decl(IrVmType type, const char *name, FILE *out) {
+  fprintf(out, "%s%s%s", ir_vm_type_c_names[type],
+          type == IR_VM_TYPE_PTR ? "" : " ", name);
+}
+
+static void ir_vm_write_entry(const IrVmFunction *function, size_t index,
+                              FILE *out) {
+  IrVmType type = function->return_type;
+  size_t param = 0;
+  char name[32];
+
+  fprintf(out, "\n");
+  ir_vm_write_c_decl(type, function->name, out);
+  fprintf(out, "(");
+  for (param = 0; param < function->param_count; param++) {
+    snprintf(name, sizeof(name), "p%zu", param);
+    fprintf(out, "%s", param ? ", " : "");
+    ir_vm_write_c_decl(function->params[param], name, out);
+  }
+  fprintf(out, "%s) {\n", function->param_count ? "" : "void");
+
+  if (function->param_count) {
+    fprintf(out, "  IrVmWord args[%zu];\n\n", function->param_count);
+  }
+  for (param = 0; param < function->param_count; param++) {
+    if (function->params[param] == IR_VM_TYPE_PTR) {
+      fprintf(out, "  args[%zu] = (IrVmWord)(intptr_t)p%zu;\n", param, param);
+    } else {
+      fprintf(out, "  args[%zu] = p%zu;\n", param, param);
+    }
+  }
+
+  if (type == IR_VM_TYPE_VOID) {
+    fprintf(out, "  ir_vm_host_call(");
+  } else if (type == IR_VM_TYPE_PTR) {
+    fprintf(out, "  return (void *)(intptr_t)ir_vm_host_call(");
+  } else {
+    fprintf(out, "  return (%s)ir_vm_host_call(", ir_vm_type_c_names[type]);
+  }
+  fprintf(out, "&ir_vm_host, ir_vm_image,\n");
+  fprintf(out, "      sizeof(ir_vm_image), %zu, %s, %zu);\n",
+          index, function->param_count ? "args" : "NULL",
+          function->param_count);
+  fprintf(out, "}\n");
+}
+
+int ir_vm_write_host(const IrVmProgram *program, FILE *out) {
+  IrVmBuffer buffer;
+  size_t index = 0;
+
+  if (!ir_vm_encode_image(program, &buffer)) {
+    return 0;
+  }
+
+  fprintf(out, "/* BaseCC bytecode with native entry points. */\n");
+  fprintf(out, "#include \"ir_vm.h\"\n\n#include <stdint.h>\n\n");
+  fprintf(out, "static const unsigned char ir_vm_image[] = {");
+  for (index = 0; index < buffer.size; index++) {
+    fprintf(out, "%s0x%02x,", index % 12 == 0 ? "\n  " : " ",
+            buffer.data[index]);
+  }
+  fprintf(out, "\n};\n\nstatic IrVmHost ir_vm_host;\n");
+  free(buffer.data);
+
+  for (index = 0; index < program->function_count; index++) {
+    if (program->functions[index].is_exported) {
+      ir_vm_write_entry(&program->functions[index], index, out);
+    }
+  }
+
+  return !ferror(out);
+}
+
+static void *ir_vm_resolve_default(const char *name, void *data) {
+  (void)data;
+  return dlsym(RTLD_DEFAULT, name);
+}
+
+static int ir_vm_fail(IrVm *vm, const char *message) {
+  if (!vm->error_message) {
+    vm->error_message = message;
+  }
+  return 0;
+}
+
+static void ir_vm_store_bytes(unsigned char *target, unsigned long long value,
+                              size_t size) {
+  size_t index = 0;
+
+  for (index = 0; index < size && index < 8; index++) {
+    target[index] = (unsigned char)(value >> (8 * index));
+  }
+}
+
+static int ir_vm_layout_globals(IrVm *vm) {
+  const IrVmProgram *program = vm->program;
+  size_t *offsets = NULL;
+  size_t size = 0;
+  size_t index = 0;
+  size_t item = 0;
+
+  offsets = malloc((program->global_count + 1) * sizeof(*offsets));
+  vm->global_addresses =
+    malloc((program->global_count + 1) * sizeof(*vm->global_addresses));
+  if (!offsets || !vm->global_addresses) {
+    free(offsets);
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+
+  for (index = 0; index < program->global_count; index++) {
+    const IrVmGlobal *global = &program->globals[index];
+
+    size = (size + global->align - 1) & ~(global->align - 1);
+    offsets[index] = size;
+    size += global->size;
+  }
+
+  /* calloc memory is aligned for any of the global types. */
+  vm->data = calloc(size ? size : 1, 1);
+  if (!vm->data) {
+    free(offsets);
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+
+  for (index = 0; index < program->global_count; index++) {
+    vm->global_addresses[index] = vm->data + offsets[index];
+  }
+  for (index = 0; index < program->global_count; index++) {
+    const IrVmGlobal *global = &program->globals[index];
+
+    for (item = 0; item < global->init_count; item++) {
+      const IrVmInit *init = &global->inits[item];
+      unsigned long long value = (unsigned long long)init->value;
+
+      if (init->kind == IR_VM_INIT_ADDRESS) {
+        value = (unsigned long long)(uintptr_t)vm->global_addresses[value];
+      }
+      ir_vm_store_bytes(vm->global_addresses[index] + init->offset, value,
+                        init->size);
+    }
+  }
+
+  free(offsets);
+  return 1;
+}
+
+static int ir_vm_resolve_constants(IrVm *vm) {
+  const IrVmProgram *program = vm->program;
+  size_t index = 0;
+  size_t item = 0;
+
+  vm->constants = calloc(program->function_count + 1, sizeof(*vm->constants));
+  if (!vm->constants) {
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+
+  for (index = 0; index < program->function_count; index++) {
+    const IrVmFunction *function = &program->functions[index];
+    IrVmWord *constants =
+      malloc((function->constant_count + 1) * sizeof(*constants));
+
+    if (!constants) {
+      return ir_vm_fail(vm, "vm: out of memory");
+    }
+    vm->constants[index] = constants;
+
+    for (item = 0; item < function->constant_count; item++) {
+      const IrVmConstant *constant = &function->constants[item];
+
+      if (constant->kind == IR_VM_CONST_GLOBAL) {
+        constants[item] =
+          (IrVmWord)(intptr_t)vm->global_addresses[constant->value];
+      } else if (constant->kind == IR_VM_CONST_NATIVE) {
+        constants[item] = (IrVmWord)(intptr_t)vm->natives[constant->value];
+      } else {
+        constants[item] = constant->value;
+      }
+    }
+  }
+
+  return 1;
+}
+
+static int ir_vm_copy_code(IrVm *vm) {
+  const IrVmProgram *program = vm->program;
+  size_t index = 0;
+
+  vm->code = calloc(program->function_count + 1, sizeof(*vm->code));
+  if (!vm->code) {
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+
+  for (index = 0; index < program->function_count; index++) {
+    const IrVmFunction *function = &program->functions[index];
+
+    vm->code[index] = malloc(function->code_size * sizeof(*function->code));
+    if (!vm->code[index]) {
+      return ir_vm_fail(vm, "vm: out of memory");
+    }
+    memcpy(vm->code[index], function->code,
+           function->code_size * sizeof(*function->code));
+  }
+
+  return 1;
+}
+
+int ir_vm_init(IrVm *vm, const IrVmProgram *program, IrVmResolver resolver,
+               void *resolver_data) {
+  size_t index = 0;
+
+  memset(vm, 0, sizeof(*vm));
+  vm->program = program;
+  vm->quicken = 1;
+  vm->jit_threshold = IR_VM_JIT_THRESHOLD;
+  if (!resolver) {
+    resolver = ir_vm_resolve_default;
+  }
+
+  vm->natives = malloc((program->native_count + 1) * sizeof(*vm->natives));
+  if (!vm->natives) {
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+  for (index = 0; index < program->native_count; index++) {
+    vm->natives[index] = resolver(program->natives[index].name, resolver_data);
+    if (!vm->natives[index]) {
+      return ir_vm_fail(vm, "vm: unresolved native function");
+    }
+  }
+
+  if (!ir_vm_layout_globals(vm) || !ir_vm_resolve_constants(vm) ||
+      !ir_vm_copy_code(vm)) {
+    return 0;
+  }
+
+  /* Pages are only touched as deeper calls reach them. */
+  vm->register_capacity = IR_VM_REGISTER_WORDS;
+  vm->registers = malloc(vm->register_capacity * sizeof(*vm->registers));
+  vm->stack_size = IR_VM_STACK_BYTES;
+  vm->stack = malloc(vm->stack_size);
+  vm->frame_capacity = IR_VM_FRAMES;
+  vm->frames = malloc(vm->frame_capacity * sizeof(*vm->frames));
+  if (!vm->registers || !vm->stack || !vm->frames) {
+    return ir_vm_fail(vm, "vm: out of memory");
+  }
+
+  return 1;
+}
+
+void ir_vm_free(IrVm *vm) {
+  size_t index = 0;
+
+  ir_jit_free(vm->jit);
+  if (vm->constants) {
+    for (index = 0; index < vm->program->function_count; index++) {
+      free(vm->constants[index]);
+    }
+  }
+  if (vm->code) {
+    for (index = 0; index < vm->program->function_count; index++) {
+      free(vm->code[index]);
+    }
+  }
+  free(vm->constants);
+  free(vm->code);
+  free(vm->natives);
+  free(vm->global_addresses);
+  free(vm->data);
+  free(vm->registers);
+  free(vm->stack);
+  free(vm->frames);
+  memset(vm, 0, sizeof(*vm));
+}
+
+const char *ir_vm_error(const IrVm *vm) {
+  return vm->error_message;
+}
+
+IrVmProfile *ir_vm_profile_create(void) {
+  IrVmProfile *profile = calloc(1, sizeof(*profile));
+
+  if (profile) {
+    profile->previous[0] = -1;
+    profile->previous[1] = -1;
+  }
+  return profile;
+}
+
+void ir_vm_profile_free(IrVmProfile *profile) {
+  free(profile);
+}
+
+unsigned long long ir_vm_profile_dispatches(const IrVmProfile *profile) {
+  unsigned long long total = 0;
+  size_t opcode = 0;
+
+  for (opcode = 0; opcode < IR_VM_OPCODE_COUNT; opcode++) {
+    total += profile->counts[opcode];
+  }
+  return total;
+}
+
+static void ir_vm_write_opcode_names(FILE *out, const size_t *opcodes,
+                                     size_t count) {
+  const char *name = NULL;
+  size_t index = 0;
+
+  for (index = 0; index < count; index++) {
+    fputc(' ', out);
+    for (name = ir_vm_opcode_name((IrVmOpcode)opcodes[index]); *name;
+         name++) {
+      fputc(tolower((unsigned char)*name), out);
+    }
+  }
+  fputc('\n', out);
+}
+
+int ir_vm_write_profile(const IrVmProfile *profile, FILE *out) {
+  size_t ops[3];
+
+  for (ops[0] = 0; ops[0] < IR_VM_OPCODE_COUNT; ops[0]++) {
+    if (profile->counts[ops[0]]) {
+      fprintf(out, "%llu", profile->counts[ops[0]]);
+      ir_vm_write_opcode_names(out, ops, 1);
+    }
+  }
+  for (ops[0] = 0; ops[0] < IR_VM_OPCODE_COUNT; ops[0]++) {
+    for (ops[1] = 0; ops[1] < IR_VM_OPCODE_COUNT; ops[1]++) {
+      if (profile->pairs[ops[0]][ops[1]]) {
+        fprintf(out, "%llu", profile->pairs[ops[0]][ops[1]]);
+        ir_vm_write_opcode_names(out, ops, 2);
+      }
+      for (ops[2] = 0; ops[2] < IR_VM_OPCODE_COUNT; ops[2]++) {
+        if (profile->triples[ops[0]][ops[1]][ops[2]]) {
+          fprintf(out, "%llu", profile->triples[ops[0]][ops[1]][ops[2]]);
+          ir_vm_write_opcode_names(out, ops, 3);
+        }
+      }
+    }
+  }
+
+  return !ferror(out);
+}
+
+/* Whether control may leave the straight line after this opcode. */
+static int ir_vm_ends_run(IrVmWord opcode) {
+  return ir_vm_is_terminator(opcode) ||
+         strpbrk(ir_vm_opcode_operands((IrVmOpcode)opcode), "tfn") != NULL;
+}
+
+static void ir_vm_profile_record(IrVmProfile *profile, IrVmWord opcode) {
+  int *previous = profile->previous;
+
+  profile->counts[opcode]++;
+  if (previous[0] >= 0) {
+    profile->pairs[previous[0]][opcode]++;
+    if (previous[1] >= 0) {
+      profile->triples[previous[1]][previous[0]][opcode]++;
+    }
+  }
+
+  if (ir_vm_ends_run(opcode)) {
+    previous[0] = -1;
+    previous[1] = -1;
+  } else {
+    previous[1] = previous[0];
+    previous[0] = (int)opcode;
+  }
+}
+
+/* Brings a native return value to the canonical form of its type. */
+static IrVmWord ir_vm_normalize(IrVmType type, IrVmWord value) {
+  switch (type) {
+  case IR_VM_TYPE_VOID:
+    return 0;
+  case IR_VM_TYPE_I1:
+    return value & 1;
+  case IR_VM_TYPE_I8:
+    return (signed char)value;
+  case IR_VM_TYPE_I16:
+    return (short)value;
+  case IR_VM_TYPE_I32:
+    return (int)value;
+  default:
+    return value;
+  }
+}
+
+typedef IrVmWord (*IrVmNativeCall)(IrVmWord, ...);
+
+#define IR_VM_U(value) ((unsigned long long)(value))
+/* Sign-extends from bit 63 - shift. */
+#define IR_VM_WRAP(value, shift)                                               \
+  ((IrVmWord)(IR_VM_U(value) << (shift)) >> (shift))
+
+/*
+ * GCC and clang dispatch through a table of label addresses, with the
+ * indirect jump replicated at the end of every handler; other compilers
+ * get a switch in a loop. Profiling swaps in a table that sends every
+ * opcode through the counter first.
+ */
+#if defined(__GNUC__) && !defined(IR_VM_NO_COMPUTED_GOTO)
+#define IR_VM_THREADED 1
+#define IR_VM_CASE(name) ir_vm_op_##name:
+#define IR_VM_DISPATCH() goto *labels[*pc]
+#else
+#define IR_VM_CASE(name) case IR_VM_OP_##name:
+#define IR_VM_DISPATCH() goto ir_vm_dispatch
+#endif
+
+#define IR_VM_NEXT(size)                                                       \
+  do {                                                                         \
+    pc += (size);                                                              \
+    IR_VM_DISPATCH();                                                          \
+  } while (0)
+
+/*
+ * A backward jump counts towards compiling the function; once it has
+ * code, the loop carries on there.
+ */
+#define IR_VM_JUMP(target)                                                     \
+  do {                                                                         \
+    IrVmWord *jump_target = (target);                                          \
+                                                                               \
+    if (jit && jump_target <= pc &&                                            \
+        ir_vm_jit_hot(jit, (size_t)(function - program->functions))) {        \
+      pc = jump_target;                                                        \
+      goto ir_vm_resume;                                                       \
+    }                                                                          \
+    pc = jump_target;                                                          \
+    IR_VM_DISPATCH();                                                          \
+  } while (0)
+
+/* Hands value back to the caller, or out of ir_vm_run from its base. */
+#define IR_VM_RETURN(value)                                                    \
+  do {                                                                         \
+    IrVmWord returned = (value);                                               \
+                                                                               \
+    if (frame == base) {                                                       \
+      if (result) {                                                            \
+        *result = returned;                                                    \
+      }                                                                        \
+      return 1;                                                                \
+    }                                                                          \
+                                                                               \
+    function = frame->function;                                                \
+    code = frame->code;                                                        \
+    pc = frame->pc;                                                            \
+    r = frame->registers;                                                      \
+    stack = frame->stack;                                                      \
+    r[frame->result] = returned;                                               \
+    frame--;                                                                   \
+    IR_VM_DISPATCH();                                                          \
+  } while (0)
+
+#define IR_VM_BINARY(name, expression)                                         \
+  IR_VM_CASE(name) {                                                           \
+    IrVmWord x = r[pc[2]];                                                     \
+    IrVmWord y = r[pc[3]];                                                     \
+                                                                               \
+    r[pc[1]] = (expression);                                                   \
+    IR_VM_NEXT(4);                                                             \
+  }
+
+#define IR_VM_WRAPPED(name, expression)                                        \
+  IR_VM_CASE(name) {                                                           \
+    IrVmWord x = r[pc[2]];                                                     \
+    IrVmWord y = r[pc[3]];                                                     \
+                                                                               \
+    r[pc[1]] = IR_VM_WRAP((expression), pc[4]);                                \
+    IR_VM_NEXT(5);                                                             \
+  }
+
+/* A generic wrapped operation and its forms for 32- and 64-bit values. */
+#define IR_VM_QUICKENED(name, expression)                                      \
+  IR_VM_CASE(name) {                                                           \
+    IrVmWord x = r[pc[2]];                                                     \
+    IrVmWord y = r[pc[3]];                                                     \
+                                                                               \
+    if (quicken && (pc[4] == 32 || pc[4] == 0)) {                              \
+      *pc = pc[4] ? IR_VM_OP_##name##_I32 : IR_VM_OP_##name##_I64;             \
+      IR_VM_DISPATCH();                                                        \
+    }                                                                          \
+    r[pc[1]] = IR_VM_WRAP((expression), pc[4]);                                \
+    IR_VM_NEXT(5);                                                             \
+  }                                                                            \
+  IR_VM_CASE(name##_I32) {                                                     \
+    IrVmWord x = r[pc[2]];                                                     \
+    IrVmWord y = r[pc[3]];                                                     \
+                                                                               \
+    r[pc[1]] = (int32_t)(uint32_t)(expression);                                \
+    IR_VM_NEXT(5);                                                             \
+  }                                                                            \
+  IR_VM_CASE(name##_I64) {                                                     \
+    IrVmWord x = r[pc[2]];                                                     \
+    IrVmWord y = r[pc[3]];                                                     \
+                                                                               \
+    r[pc[1]] = (IrVmWord)(expression);                                         \
+    IR_VM_NEXT(5);                                                             \
+  }
+
+#define IR_VM_COMPARE_JUMP(name, expression)                                   \
+  IR_VM_CASE(name) {                                                           \
+    IrVmWord x = r[pc[1]];                                                     \
+    IrVmWord y = r[pc[2]];                                                     \
+                                                                               \
+    IR_VM_JUMP((expression) ? code + pc[3] : pc + 4);                          \
+  }
+
+#define IR_VM_UPDATE32(name, expression)                                       \
+  IR_VM_CASE(name) {                                                           \
+    void *address = (void *)(intptr_t)r[pc[1]];                               \
+    uint32_t y = (uint32_t)r[pc[2]];                                           \
+    uint32_t x;                                                                \
+                                                                               \
+    memcpy(&x, address, sizeof(x));                                           \
+    x = (expression);                                                          \
+    memcpy(address, &x, sizeof(x));                                           \
+    IR_VM_NEXT(3);                                                             \
+  }
+
+#define IR_VM_LOAD(name, type)                                                 \
+  IR_VM_CASE(name) {                                                           \
+    type loaded;                                                               \
+                                                                               \
+    memcpy(&loaded, (const void *)(intptr_t)r[pc[2]], sizeof(loaded));        \
+    r[pc[1]] = loaded;                                                         \
+    IR_VM_NEXT(3);                                                             \
+  }
+
+#define IR_VM_STORE(name, type)                                                \
+  IR_VM_CASE(name) {                                                           \
+    type stored = (type)r[pc[1]];                                              \
+                                                                               \
+    memcpy((void *)(intptr_t)r[pc[2]], &stored, sizeof(stored));              \
+    IR_VM_NEXT(3);                                                             \
+  }
+
+/*
+ * Counts a call or back-edge of the function, compiling it when that uses
+ * up its budget; returns whether it has machine code to run.
+ */
+static int ir_vm_jit_hot(IrJit *jit, size_t function) {
+  IrJitFunction *compiled = &jit->functions[function];
+
+  if (compiled->entry) {
+    return 1;
+  }
+  /* A budget already at 0 means compiling failed. */
+  if (!compiled->budget || --compiled->budget) {
+    return 0;
+  }
+  return ir_jit_compile(jit, function);
+}
+
+/*
+ * Runs from the entry of `function`, whose arguments and constants are
+ * already in registers, until it returns. Its frame is base; callees stack
+ * their frames above it.
+ */
+static int ir_vm_run(IrVm *vm, const IrVmFunction *function,
+                     IrVmWord *registers, unsigned char *stack,
+                     IrVmFrame *base, IrVmWord *result) {
+#ifdef IR_VM_THREADED
+  static const void *const ir_vm_labels[] = {
+#define IR_VM_LABEL(name, operands) &&ir_vm_op_##name,
+    IR_VM_OPCODES(IR_VM_LABEL) IR_VM_QUICK_OPCODES(IR_VM_LABEL)
+#undef IR_VM_LABEL
+  };
+  static const void *const ir_vm_profile_labels[] = {
+#define IR_VM_LABEL(name, operands) &&ir_vm_profile,
+    IR_VM_OPCODES(IR_VM_LABEL) IR_VM_QUICK_OPCODES(IR_VM_LABEL)
+#undef IR_VM_LABEL
+  };
+  const void *const *labels = vm->profile ? ir_vm_profile_labels : ir_vm_labels;
+#endif
+  const IrVmProgram *program = vm->program;
+  IrVmWord *code = vm->code[function - program->functions];
+  IrVmWord *pc = code;
+  int quicken = vm->quicken && !vm->profile;
+  IrJit *jit = vm->profile ? NULL : vm->jit;
+  IrVmWord *r = registers;
+  IrVmWord *registers_end = vm->registers + vm->register_capacity;
+  unsigned char *stack_end = vm->stack + vm->stack_size;
+  IrVmFrame *frame = base;
+  IrVmFrame *frames_end = vm->frames + vm->frame_capacity;
+
+#ifdef IR_VM_THREADED
+  IR_VM_DISPATCH();
+ir_vm_profile:
+  ir_vm_profile_record(vm->profile, *pc);
+  goto *ir_vm_labels[*pc];
+#else
+ir_vm_dispatch:
+  if (vm->profile) {
+    ir_vm_profile_record(vm->profile, *pc);
+  }
+  switch ((IrVmOpcode)*pc) {
+#endif
+
+  IR_VM_CASE(MOV) {
+    r[pc[1]] = r[pc[2]];
+    IR_VM_NEXT(3);
+  }
+  IR_VM_CASE(FRAME) {
+    r[pc[1]] = (IrVmWord)(intptr_t)(stack + pc[2]);
+    IR_VM_NEXT(3);
+  }
+  IR_VM_QUICKENED(ADD, IR_VM_U(x) + IR_VM_U(y))
+  IR_VM_QUICKENED(SUB, IR_VM_U(x) - IR_VM_U(y))
+  IR_VM_QUICKENED(MUL, IR_VM_U(x) * IR_VM_U(y))
+  IR_VM_CASE(SDIV) {
+    IrVmWord x = r[pc[2]];
+    IrVmWord y = r[pc[3]];
+
+    if (quicken && pc[4] == 32) {
+      *pc = IR_VM_OP_SDIV_I32;
+      IR_VM_DISPATCH();
+    }
+    if (y == 0) {
+      return ir_vm_fail(vm, "vm: division by zero");
+    }
+    r[pc[1]] = IR_VM_WRAP(y == -1 ? 0 - IR_VM_U(x) : IR_VM_U(x / y), pc[4]);
+    IR_VM_NEXT(5);
+  }
+  /* 32-bit division is much cheaper than 64-bit division on x86-64. */
+  IR_VM_CASE(SDIV_I32) {
+    int32_t x = (int32_t)r[pc[2]];
+    int32_t y = (int32_t)r[pc[3]];
+
+    if (y == 0) {
+      return ir_vm_fail(vm, "vm: division by zero");
+    }
+    r[pc[1]] = y == -1 ? (int32_t)(0 - (uint32_t)x) : x / y;
+    IR_VM_NEXT(5);
+  }
+  IR_VM_CASE(SREM) {
+    IrVmWord x = r[pc[2]];
+    IrVmWord y = r[pc[3]];
+
+    if (quicken && pc[4] == 32) {
+      *pc = IR_VM_OP_SREM_I32;
+      IR_VM_DISPATCH();
+    }
+    if (y == 0) {
+      return ir_vm_fail(vm, "vm: division by zero");
+    }
+    r[pc[1]] = y == -1 ? 0 : x % y;
+    IR_VM_NEXT(5);
+  }
+  IR_VM_CASE(SREM_I32) {
+    int32_t x = (int32_t)r[pc[2]];
+    int32_t y = (int32_t)r[pc[3]];
+
+    if (y == 0) {
+      return ir_vm_fail(vm, "vm: division by zero");
+    }
+    r[pc[1]] = y == -1 ? 0 : x % y;
+    IR_VM_NEXT(5);
+  }
+  IR_VM_WRAPPED(SHL, IR_VM_U(x) << (y & 63))
+  IR_VM_BINARY(ASHR, x >> (y & 63))
+  /* Zero-extends first: the shift brings in zeros above the type. */
+  IR_VM_WRAPPED(LSHR, (IR_VM_U(x) << pc[4] >> pc[4]) >> (y & 63))
+  IR_VM_BINARY(AND, x & y)
+  IR_VM_BINARY(OR, x | y)
+  IR_VM_BINARY(XOR, x ^ y)
+  IR_VM_BINARY(EQ, x == y)
+  IR_VM_BINARY(NE, x != y)
+  IR_VM_BINARY(SLT, x < y)
+  IR_VM_BINARY(SLE, x <= y)
+  IR_VM_BINARY(SGT, x > y)
+  IR_VM_BINARY(SGE, x >= y)
+  /* Sign extension preserves unsigned order. */
+  IR_VM_BINARY(ULT, IR_VM_U(x) < IR_VM_U(y))
+  IR_VM_BINARY(ULE, IR_VM_U(x) <= IR_VM_U(y))
+  IR_VM_BINARY(UGT, IR_VM_U(x) > IR_VM_U(y))
+  IR_VM_BINARY(UGE, IR_VM_U(x) >= IR_VM_U(y))
+  IR_VM_CASE(WRAP) {
+    r[pc[1]] = IR_VM_WRAP(r[pc[2]], pc[3]);
+    IR_VM_NEXT(4);
+  }
+  IR_VM_CASE(MASK) {
+    r[pc[1]] = r[pc[2]] & pc[3];
+    IR_VM_NEXT(4);
+  }
+  IR_VM_CASE(NEG) {
+    r[pc[1]] = (IrVmWord)(0 - IR_VM_U(r[pc[2]]));
+    IR_VM_NEXT(3);
+  }
+  IR_VM_CASE(INDEX) {
+    r[pc[1]] =
+      (IrVmWord)(IR_VM_U(r[pc[2]]) + IR_VM_U(r[pc[3]]) * IR_VM_U(pc[4]));
+    IR_VM_NEXT(5);
+  }
+  IR_VM_CASE(OFFSET) {
+    r[pc[1]] = (IrVmWord)(IR_VM_U(r[pc[2]]) + IR_VM_U(pc[3]));
+    IR_VM_NEXT(4);
+  }
+  IR_VM_LOAD(LOAD8, int8_t)
+  IR_VM_LOAD(LOAD16, int16_t)
+  IR_VM_LOAD(LOAD32, int32_t)
+  IR_VM_LOAD(LOAD64, int64_t)
+  IR_VM_LOAD(LOADU8, uint8_t)
+  IR_VM_STORE(STORE8, int8_t)
+  IR_VM_STORE(STORE16, int16_t)
+  IR_VM_STORE(STORE32, int32_t)
+  IR_VM_STORE(STORE64, int64_t)
+  IR_VM_CASE(JMP) {
+    IR_VM_JUMP(code + pc[1]);
+  }
+  IR_VM_CASE(JZ) {
+    IR_VM_JUMP(r[pc[1]] ? pc + 3 : code + pc[2]);
+  }
+  IR_VM_CASE(JNZ) {
+    IR_VM_JUMP(r[pc[1]] ? code + pc[2] : pc + 3);
+  }
+  IR_VM_CASE(CALL) {
+    const IrVmFunction *callee = &program->functions[pc[2]];
+    IrVmWord *next = r + function->register_count;
+    size_t count = (size_t)pc[3];
+    size_t index = 0;
+
+    if (frame + 1 == frames_end ||
+        (size_t)(registers_end - next) < callee->register_count ||
+        (size_t)(stack_end - stack) <
+          function->frame_size + callee->frame_size) {
+      return ir_vm_fail(vm, "vm: stack overflow");
+    }
+
+    for (index = 0; index < count; index++) {
+      next[index] = r[pc[4 + index]];
+    }
+    /* Compiled code loads its own constants. */
+    if (jit && ir_vm_jit_hot(jit, (size_t)pc[2])) {
+      IrJitResult called;
+
+      jit->frame = frame;
+      called = jit->functions[pc[2]].entry(jit, next,
+                                           stack + function->frame_size);
+      if (!called.ok) {
+        return 0;
+      }
+      r[pc[1]] = called.value;
+      IR_VM_NEXT(4 + count);
+    }
+    memcpy(next + callee->constant_base, vm->constants[pc[2]],
+           callee->constant_count * sizeof(*next));
+
+    frame++;
+    frame->function = function;
+    frame->code = code;
+    frame->pc = pc + 4 + count;
+    frame->registers = r;
+    frame->stack = stack;
+    frame->result = pc[1];
+
+    stack += function->frame_size;
+    function = callee;
+    code = vm->code[pc[2]];
+    r = next;
+    pc = code;
+    IR_VM_DISPATCH();
+  }
+  IR_VM_CASE(CALL_NATIVE) {
+    IrVmWord args[IR_VM_NATIVE_ARGS] = {0};
+    const IrVmNative *native = &program->natives[pc[2]];
+    IrVmNativeCall call = (IrVmNativeCall)vm->natives[pc[2]];
+    size_t count = (size_t)pc[3];
+    size_t index = 0;
+
+    for (index = 0; index < count; index++) {
+      args[index] = r[pc[4 + index]];
+    }
+    /* Integer arguments only; surplus ones are ignored by the callee. */
+    r[pc[1]] = ir_vm_normalize(native->return_type,
+                               call(args[0], args[1], args[2], args[3],
+                                    args[4], args[5]));
+    IR_VM_NEXT(4 + count);
+  }
+  IR_VM_CASE(RET) {
+    IR_VM_RETURN(r[pc[1]]);
+  }
+  /* Void calls name a scratch register for the result. */
+  IR_VM_CASE(RET_VOID) {
+    IR_VM_RETURN(0);
+  }
+
+  IR_VM_COMPARE_JUMP(JEQ, x == y)
+  IR_VM_COMPARE_JUMP(JNE, x != y)
+  IR_VM_COMPARE_JUMP(JSLT, x < y)
+  IR_VM_COMPARE_JUMP(JSLE, x <= y)
+  IR_VM_COMPARE_JUMP(JSGT, x > y)
+  IR_VM_COMPARE_JUMP(JSGE, x >= y)
+  IR_VM_COMPARE_JUMP(JULT, IR_VM_U(x) < IR_VM_U(y))
+  IR_VM_COMPARE_JUMP(JULE, IR_VM_U(x) <= IR_VM_U(y))
+  IR_VM_COMPARE_JUMP(JUGT, IR_VM_U(x) > IR_VM_U(y))
+  IR_VM_COMPARE_JUMP(JUGE, IR_VM_U(x) >= IR_VM_U(y))
+  IR_VM_UPDATE32(ADD_MEM32, x + y)
+  IR_VM_UPDATE32(SUB_MEM32, x - y)
+  IR_VM_CASE(LOAD32_INDEX) {
+    int32_t loaded;
+
+    memcpy(&loaded,
+           (const void *)(intptr_t)(IR_VM_U(r[pc[2]]) +
+                                    IR_VM_U(r[pc[3]]) * IR_VM_U(pc[4])),
+           sizeof(loaded));
+    r[pc[1]] = loaded;
+    IR_VM_NEXT(5);
+  }
+  IR_VM_CASE(STORE32_INDEX) {
+    int32_t stored = (int32_t)r[pc[1]];
+
+    memcpy((void *)(intptr_t)(IR_VM_U(r[pc[2]]) +
+                              IR_VM_U(r[pc[3]]) * IR_VM_U(pc[4])),
+           &stored, sizeof(stored));
+    IR_VM_NEXT(5);
+  }
+
+#ifndef IR_VM_THREADED
+  default:
+    return ir_vm_fail(vm, "vm: invalid opcode");
+  }
+#endif
+
+  /* Continues the current activation in machine code from pc. */
+ir_vm_resume: {
+  const IrJitFunction *compiled =
+    &jit->functions[function - program->functions];
+  IrJitResult resumed;
+
+  jit->frame = frame;
+  resumed = compiled->resume(jit, r, stack,
+                             compiled->code + compiled->offsets[pc - code]);
+  if (!resumed.ok) {
+    return 0;
+  }
+  IR_VM_RETURN(resumed.value);
+}
+}
+
+int ir_vm_call(IrVm *vm, size_t function, const IrVmWord *args,
+               size_t arg_count, IrVmWord *result) {
+  const IrVmFunction *callee = NULL;
+
+  vm->error_message = NULL;
+  if (function >= vm->program->function_count) {
+    return ir_vm_fail(vm, "vm: no such function");
+  }
+
+  callee = &vm->program->functions[function];
+  if (arg_count != callee->param_count) {
+    return ir_vm_fail(vm, "vm: wrong number of arguments");
+  }
+  if (callee->register_count > vm->register_capacity ||
+      callee->frame_size > vm->stack_size) {
+    return ir_vm_fail(vm, "vm: stack overflow");
+  }
+
+  if (arg_count) {
+    memcpy(vm->registers, args, arg_count * sizeof(*args));
+  }
+  if (vm->profile) {
+    vm->profile->previous[0] = -1;
+    vm->profile->previous[1] = -1;
+  } else if (vm->jit_threshold && !vm->jit) {
+    vm->jit = ir_jit_create(vm, vm->jit_threshold);
+    if (!vm->jit) {
+      vm->jit_threshold = 0;
+    }
+  }
+
+  if (vm->jit && !vm->profile) {
+    IrJitResult called;
+
+    /* Compiled code may go this deep below the caller's stack frame. */
+    vm->jit->native_limit = (uintptr_t)&called - IR_JIT_NATIVE_STACK;
+    vm->jit->frame = vm->frames;
+    if (ir_vm_jit_hot(vm->jit, function)) {
+      called = vm->jit->functions[function].entry(vm->jit, vm->registers,
+                                                  vm->stack);
+      if (called.ok && result) {
+        *result = called.value;
+      }
+      return (int)called.ok;
+    }
+  }
+
+  memcpy(vm->registers + callee->constant_base, vm->constants[function],
+         callee->constant_count * sizeof(*vm->registers));
+  return ir_vm_run(vm, callee, vm->registers, vm->stack, vm->frames, result);
+}
+
+IrJitResult ir_vm_jit_call(IrJit *jit, IrVmWord *registers,
+                           unsigned char *stack, size_t function) {
+  IrVm *vm = jit->vm;
+  const IrVmFunction *callee = &vm->program->functions[function];
+  IrVmFrame *frame = jit->frame;
+  IrJitResult called = {0, 0};
+
+  if (ir_vm_jit_hot(jit, function)) {
+    return jit->functions[function].entry(jit, registers, stack);
+  }
+  if (frame + 1 == vm->frames + vm->frame_capacity) {
+    ir_vm_fail(vm, "vm: stack overflow");
+    return called;
+  }
+
+  memcpy(registers + callee->constant_base, vm->constants[function],
+         callee->constant_count * sizeof(*registers));
+  called.ok = ir_vm_run(vm, callee, registers, stack, frame + 1,
+                        &called.value);
+  jit->frame = frame;
+  return called;
+}
+
+/* Shared by every host in the process while BASECC_VM_PROFILE is set. */
+static IrVmProfile *ir_vm_host_profile;
+
+static void ir_vm_host_write_profile(void) {
+  FILE *out = fopen(getenv("BASECC_VM_PROFILE"), "a");
+
+  if (!out || !ir_vm_write_profile(ir_vm_host_profile, out)) {
+    fprintf(stderr, "vm: failed to write the profile\n");
+  }
+  if (out) {
+    fclose(out);
+  }
+  ir_vm_profile_free(ir_vm_host_profile);
+}
+
+static void ir_vm_host_start_profile(IrVm *vm) {
+  const char *path = getenv("BASECC_VM_PROFILE");
+
+  if (!path || !*path) {
+    return;
+  }
+  if (!ir_vm_host_profile) {
+    ir_vm_host_profile = ir_vm_profile_create();
+    if (!ir_vm_host_profile || atexit(ir_vm_host_write_profile) != 0) {
+      fprintf(stderr, "vm: failed to start profiling\n");
+      abort();
+    }
+  }
+  vm->profile = ir_vm_host_profile;
+}
+
+IrVmWord ir_vm_host_call(IrVmHost *host, const unsigned char *image,
+                         size_t size, size_t function, const IrVmWord *args,
+                         size_t arg_count) {
+  const char *message = NULL;
+  const char *threshold = NULL;
+  IrVmWord result = 0;
+
+  if (!host->loaded) {
+    if (!ir_vm_read_image(&host->program, image, size, &message)) {
+      fprintf(stderr, "%s\n", message);
+      abort();
+    }
+    if (!ir_vm_init(&host->vm, &host->program, NULL, NULL)) {
+      fprintf(stderr, "%s\n", ir_vm_error(&host->vm));
+      abort();
+    }
+    ir_vm_host_start_profile(&host->vm);
+    threshold = getenv("BASECC_VM_JIT_THRESHOLD");
+    if (threshold && *threshold) {
+      host->vm.jit_threshold = (unsigned)strtoul(threshold, NULL, 0);
+    }
+    host->loaded = 1;
+  }
+
+  if (!ir_vm_call(&host->vm, function, args, arg_count, &result)) {
+    fprintf(stderr, "%s\n", ir_vm_error(&host->vm));
+    abort();
+  }
+
+  return result;
+}
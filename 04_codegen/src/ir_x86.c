@@ -0,0 +1,2032 @@
+#include "ir_x86.h"
+#include "ir_dwarf.h"
+#include "ir_elf.h"
+#include "ir_pass.h"
+#include "ir_regalloc.h"
+#include "ir_x86_encode.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Instruction selection runs one IR instruction at a time over the
+ * locations the register allocator chose. %rax, %rcx, %rdx, and %r11 are
+ * never allocated and serve as scratch. Only the low bits of a location
+ * that belong to the value's type are meaningful, so width-sensitive
+ * instructions work at the type's width or extend their operands first.
+ */
+
+/* 64-, 32-, 16-, and 8-bit names of each register. */
+static const char *const ir_x86_register_names[][4] = {
+  {"rax", "eax", "ax", "al"},     {"rcx", "ecx", "cx", "cl"},
+  {"rdx", "edx", "dx", "dl"},     {"rbx", "ebx", "bx", "bl"},
+  {"rsp", "esp", "sp", "spl"},    {"rbp", "ebp", "bp", "bpl"},
+  {"rsi", "esi", "si", "sil"},    {"rdi", "edi", "di", "dil"},
+  {"r8", "r8d", "r8w", "r8b"},    {"r9", "r9d", "r9w", "r9b"},
+  {"r10", "r10d", "r10w", "r10b"}, {"r11", "r11d", "r11w", "r11b"},
+  {"r12", "r12d", "r12w", "r12b"}, {"r13", "r13d", "r13w", "r13b"},
+  {"r14", "r14d", "r14w", "r14b"}, {"r15", "r15d", "r15w", "r15b"},
+};
+
+static const int ir_x86_argument_registers[] = {
+  IR_X86_RDI, IR_X86_RSI, IR_X86_RDX, IR_X86_RCX, IR_X86_R8, IR_X86_R9,
+};
+
+#define IR_X86_REGISTER_ARGS                                                   \
+  (sizeof(ir_x86_argument_registers) / sizeof(ir_x86_argument_registers[0]))
+
+/* Allocatable registers; argument registers double as coalescing hints. */
+static const int ir_x86_caller_saved[] = {
+  IR_X86_RSI, IR_X86_RDI, IR_X86_R8, IR_X86_R9, IR_X86_R10,
+};
+
+static const int ir_x86_callee_saved[] = {
+  IR_X86_RBX, IR_X86_R12, IR_X86_R13, IR_X86_R14, IR_X86_R15,
+};
+
+static const char *const ir_x86_condition_names[] = {
+  "e", "ne", "l", "ge", "le", "g", "b", "ae", "be", "a",
+};
+
+static const char *const ir_x86_opcode_names[] = {
+  "mov", "movz", "movs", "lea",  "add", "sub", "imul", "and", "or",
+  "xor", "cmp",  "test", "shl",  "sar", "shr", "neg",  "",    "idiv",
+  "set", "j",    "jmp",  "call", "push", "pop", "leave", "ret",
+  "rep stos", "rep movs",
+};
+
+typedef enum IrX86LocationKind {
+  IR_X86_LOCATION_NONE,
+  IR_X86_LOCATION_REG,
+  IR_X86_LOCATION_STACK,
+  /* An alloca: the value is the address offset(%rbp). */
+  IR_X86_LOCATION_FRAME
+} IrX86LocationKind;
+
+typedef struct IrX86Location {
+  IrX86LocationKind kind;
+  IrX86Register reg;
+  long long offset;
+} IrX86Location;
+
+typedef struct IrX86Move {
+  IrX86Location dst;
+  /* The register or slot the move reads, or NONE to materialize value. */
+  IrX86Location src;
+  const IrValue *value;
+  int done;
+} IrX86Move;
+
+/* A branch whose rel32 is patched once its label's offset is known. */
+typedef struct IrX86Fixup {
+  size_t field;
+  size_t end;
+  const IrBlock *target;
+  int edge;
+} IrX86Fixup;
+
+typedef struct IrX86Emitter {
+  FILE *out;
+  /* Encodes into an ELF object instead of printing assembler text. */
+  IrElfWriter *object;
+  const IrX86Options *options;
+  IrFunction *function;
+  IrRegAllocation allocation;
+  /* Per allocator slot. */
+  IrX86Location *locations;
+  long long callee_saved_offsets[IR_X86_NO_REGISTER];
+  long long frame_size;
+  IrX86Move *moves;
+  size_t move_capacity;
+  /* Numbers the .Ledge labels of split edges across the module. */
+  int edge_count;
+  /* Object output: .text offsets of the current blocks and edge stubs. */
+  size_t *block_offsets;
+  size_t *edge_offsets;
+  size_t edge_capacity;
+  IrX86Fixup *fixups;
+  size_t fixup_count;
+  size_t fixup_capacity;
+  /* With a source file: the location of the code emitted last. */
+  int debug_info;
+  IrDebugLoc loc;
+  IrDwarfLines lines;
+  int failed;
+} IrX86Emitter;
+
+void ir_x86_options_init(IrX86Options *options) {
+  options->allocate_registers = 1;
+}
+
+static int ir_x86_bits(const IrType *type) {
+  return type->kind == IR_TYPE_INT ? type->bits : 64;
+}
+
+static const char *ir_x86_name(IrX86Register reg, int bits) {
+  int column = bits > 32 ? 0 : bits > 16 ? 1 : bits > 8 ? 2 : 3;
+
+  return ir_x86_register_names[reg][column];
+}
+
+static char ir_x86_suffix(int bits) {
+  return bits > 32 ? 'q' : bits > 16 ? 'l' : bits > 8 ? 'w' : 'b';
+}
+
+static long long ir_x86_align(long long size, long long align) {
+  return align > 1 ? (size + align - 1) / align * align : size;
+}
+
+static int ir_x86_fits_imm32(long long value) {
+  return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+static IrX86Operand ir_x86_reg(IrX86Register reg) {
+  IrX86Operand operand = {IR_X86_OPERAND_REG, reg, IR_X86_NO_REGISTER,
+                          0, 0, NULL, 0};
+  return operand;
+}
+
+static IrX86Operand ir_x86_imm(long long value) {
+  IrX86Operand operand = {IR_X86_OPERAND_IMM, IR_X86_NO_REGISTER,
+                          IR_X86_NO_REGISTER, 0, value, NULL, 0};
+  return operand;
+}
+
+static IrX86Operand ir_x86_mem(IrX86Register base, long long offset) {
+  IrX86Operand operand = {IR_X86_OPERAND_MEM, base, IR_X86_NO_REGISTER,
+                          1, offset, NULL, 0};
+  return operand;
+}
+
+static IrX86Operand ir_x86_symbol(const char *symbol, long long offset) {
+  IrX86Operand operand = {IR_X86_OPERAND_SYMBOL, IR_X86_NO_REGISTER,
+                          IR_X86_NO_REGISTER, 0, offset, symbol, 0};
+  return operand;
+}
+
+static IrX86Operand ir_x86_edge_label(int edge) {
+  IrX86Operand operand = {IR_X86_OPERAND_LABEL, IR_X86_NO_REGISTER,
+                          IR_X86_NO_REGISTER, 0, edge, NULL, 0};
+  return operand;
+}
+
+static void ir_x86_print_operand(FILE *out, const IrX86Operand *operand,
+                                 int bits) {
+  switch (operand->kind) {
+  case IR_X86_OPERAND_NONE:
+    break;
+  case IR_X86_OPERAND_REG:
+    fprintf(out, "%%%s", ir_x86_name(operand->reg, bits));
+    break;
+  case IR_X86_OPERAND_IMM:
+    fprintf(out, "$%lld", operand->value);
+    break;
+  case IR_X86_OPERAND_MEM:
+    if (operand->value != 0) {
+      fprintf(out, "%lld", operand->value);
+    }
+    fprintf(out, "(%%%s", ir_x86_register_names[operand->reg][0]);
+    if (operand->index != IR_X86_NO_REGISTER) {
+      fprintf(out, ",%%%s,%d", ir_x86_register_names[operand->index][0],
+              operand->scale);
+    }
+    fprintf(out, ")");
+    break;
+  case IR_X86_OPERAND_SYMBOL:
+    fprintf(out, "%s", operand->symbol);
+    if (operand->value != 0) {
+      fprintf(out, "%+lld", operand->value);
+    }
+    fprintf(out, "%s(%%rip)", operand->got ? "@GOTPCREL" : "");
+    break;
+  case IR_X86_OPERAND_LABEL:
+    fprintf(out, ".Ledge%lld(%%rip)", operand->value);
+    break;
+  }
+}
+
+static void ir_x86_print_target(const IrX86Emitter *emitter,
+                                const IrBlock *block, int edge) {
+  if (edge >= 0) {
+    fprintf(emitter->out, ".Ledge%d", edge);
+  } else {
+    fprintf(emitter->out, ".L%s.%s", emitter->function->name, block->name);
+  }
+}
+
+static int ir_x86_reserve_edges(IrX86Emitter *emitter, int edge) {
+  size_t *offsets = NULL;
+  size_t capacity = emitter->edge_capacity ? emitter->edge_capacity : 16;
+
+  while (capacity <= (size_t)edge) {
+    capacity *= 2;
+  }
+  if (capacity == emitter->edge_capacity) {
+    return 1;
+  }
+
+  offsets = realloc(emitter->edge_offsets, capacity * sizeof(*offsets));
+  if (!offsets) {
+    emitter->failed = 1;
+    return 0;
+  }
+  emitter->edge_offsets = offsets;
+  emitter->edge_capacity = capacity;
+  return 1;
+}
+
+static void ir_x86_add_fixup(IrX86Emitter *emitter, const IrBlock *target,
+                             int edge, size_t field, size_t end) {
+  IrX86Fixup *fixup = NULL;
+
+  if (emitter->fixup_count == emitter->fixup_capacity) {
+    size_t capacity =
+      emitter->fixup_capacity ? emitter->fixup_capacity * 2 : 64;
+    IrX86Fixup *fixups =
+      realloc(emitter->fixups, capacity * sizeof(*fixups));
+
+    if (!fixups) {
+      emitter->failed = 1;
+      return;
+    }
+    emitter->fixups = fixups;
+    emitter->fixup_capacity = capacity;
+  }
+
+  fixup = &emitter->fixups[emitter->fixup_count++];
+  fixup->field = field;
+  fixup->end = end;
+  fixup->target = target;
+  fixup->edge = edge;
+}
+
+/*
+ * Appends the encoded instruction to .text. Branches and references to
+ * edge labels are patched when the function ends; calls and RIP-relative
+ * operands become relocations, whose addend accounts for any immediate
+ * after the displacement field.
+ */
+static void ir_x86_put_object(IrX86Emitter *emitter,
+                              const IrX86Instr *instr) {
+  IrElfWriter *object = emitter->object;
+  size_t start = ir_elf_section_size(object, IR_ELF_TEXT);
+  const IrX86Operand *symbol = NULL;
+  IrX86Encoding encoding;
+  size_t field = 0;
+  size_t end = 0;
+
+  if (!ir_x86_encode(instr, &encoding)) {
+    emitter->failed = 1;
+    return;
+  }
+  ir_elf_append(object, IR_ELF_TEXT, encoding.bytes, encoding.length);
+  field = start + encoding.pcrel_offset;
+  end = start + encoding.length;
+
+  if (instr->opcode == IR_X86_JMP && instr->dst.kind == IR_X86_OPERAND_REG) {
+    return;
+  }
+
+  if (instr->opcode == IR_X86_JCC ||
+      (instr->opcode == IR_X86_JMP && !instr->callee)) {
+    ir_x86_add_fixup(emitter, instr->target, instr->edge, field, end);
+    return;
+  }
+
+  if (instr->opcode == IR_X86_CALL || instr->opcode == IR_X86_JMP) {
+    ir_elf_relocate(object, IR_ELF_TEXT, field,
+                    ir_elf_symbol(object, instr->callee),
+                    IR_ELF_R_X86_64_PLT32, -4);
+    return;
+  }
+
+  if (instr->src.kind == IR_X86_OPERAND_SYMBOL) {
+    symbol = &instr->src;
+  } else if (instr->dst.kind == IR_X86_OPERAND_SYMBOL) {
+    symbol = &instr->dst;
+  }
+  if (instr->src.kind == IR_X86_OPERAND_LABEL) {
+    ir_x86_add_fixup(emitter, NULL, (int)instr->src.value, field, end);
+  } else if (symbol) {
+    ir_elf_relocate(object, IR_ELF_TEXT, field,
+                    ir_elf_symbol(object, symbol->symbol),
+                    symbol->got ? IR_ELF_R_X86_64_GOTPCREL
+                                : IR_ELF_R_X86_64_PC32,
+                    symbol->value - (long long)(end - field));
+  }
+}
+
+static void ir_x86_put(IrX86Emitter *emitter, const IrX86Instr *instr) {
+  FILE *out = emitter->out;
+  const char *name = ir_x86_opcode_names[instr->opcode];
+  int src_bits = instr->bits;
+  int dst_bits = instr->bits;
+
+  if (emitter->object) {
+    ir_x86_put_object(emitter, instr);
+    return;
+  }
+
+  switch (instr->opcode) {
+  case IR_X86_MOV:
+    if (instr->src.kind == IR_X86_OPERAND_IMM && instr->bits == 64 &&
+        !ir_x86_fits_imm32(instr->src.value)) {
+      fprintf(out, "\tmovabsq\t");
+    } else {
+      fprintf(out, "\tmov%c\t", ir_x86_suffix(instr->bits));
+    }
+    break;
+  case IR_X86_MOVZX:
+  case IR_X86_MOVSX:
+    dst_bits = instr->opcode == IR_X86_MOVZX ? 32 : 64;
+    fprintf(out, "\t%s%c%c\t", name, ir_x86_suffix(src_bits),
+            ir_x86_suffix(dst_bits));
+    break;
+  case IR_X86_SHL:
+  case IR_X86_SAR:
+  case IR_X86_SHR:
+    src_bits = 8;
+    fprintf(out, "\t%s%c\t", name, ir_x86_suffix(instr->bits));
+    break;
+  case IR_X86_CQO:
+    fprintf(out, "\t%s\n", instr->bits == 64 ? "cqto" : "cltd");
+    return;
+  case IR_X86_SETCC:
+    dst_bits = 8;
+    fprintf(out, "\t%s%s\t", name, ir_x86_condition_names[instr->condition]);
+    break;
+  case IR_X86_JCC:
+  case IR_X86_JMP:
+    if (instr->dst.kind == IR_X86_OPERAND_REG) {
+      fprintf(out, "\t%s\t*%%%s\n", name,
+              ir_x86_register_names[instr->dst.reg][0]);
+      return;
+    }
+    if (instr->callee) {
+      fprintf(out, "\tjmp\t%s%s\n", instr->callee, instr->plt ? "@PLT" : "");
+      return;
+    }
+    if (instr->opcode == IR_X86_JCC) {
+      fprintf(out, "\t%s%s\t", name, ir_x86_condition_names[instr->condition]);
+    } else {
+      fprintf(out, "\t%s\t", name);
+    }
+    ir_x86_print_target(emitter, instr->target, instr->edge);
+    fprintf(out, "\n");
+    return;
+  case IR_X86_CALL:
+    fprintf(out, "\tcall\t%s%s\n", instr->callee, instr->plt ? "@PLT" : "");
+    return;
+  case IR_X86_LEAVE:
+  case IR_X86_RET:
+    fprintf(out, "\t%s\n", name);
+    return;
+  case IR_X86_REP_STOS:
+  case IR_X86_REP_MOVS:
+    fprintf(out, "\t%sb\n", name);
+    return;
+  default:
+    fprintf(out, "\t%s%c\t", name, ir_x86_suffix(instr->bits));
+    break;
+  }
+
+  if (instr->src.kind != IR_X86_OPERAND_NONE) {
+    ir_x86_print_operand(out, &instr->src, src_bits);
+    fprintf(out, ", ");
+  }
+  ir_x86_print_operand(out, &instr->dst, dst_bits);
+  fprintf(out, "\n");
+}
+
+static void ir_x86_op(IrX86Emitter *emitter, IrX86Opcode opcode, int bits,
+                      IrX86Operand src, IrX86Operand dst) {
+  IrX86Instr instr;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = opcode;
+  instr.bits = bits;
+  instr.src = src;
+  instr.dst = dst;
+  instr.edge = -1;
+  ir_x86_put(emitter, &instr);
+}
+
+static void ir_x86_op1(IrX86Emitter *emitter, IrX86Opcode opcode, int bits,
+                       IrX86Operand dst) {
+  IrX86Operand none = {IR_X86_OPERAND_NONE, IR_X86_NO_REGISTER,
+                       IR_X86_NO_REGISTER, 0, 0, NULL, 0};
+
+  ir_x86_op(emitter, opcode, bits, none, dst);
+}
+
+static void ir_x86_setcc(IrX86Emitter *emitter, IrX86Condition condition,
+                         IrX86Register reg) {
+  IrX86Instr instr;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = IR_X86_SETCC;
+  instr.bits = 8;
+  instr.condition = condition;
+  instr.dst = ir_x86_reg(reg);
+  instr.edge = -1;
+  ir_x86_put(emitter, &instr);
+}
+
+static void ir_x86_branch(IrX86Emitter *emitter, IrX86Opcode opcode,
+                          IrX86Condition condition, const IrBlock *target,
+                          int edge) {
+  IrX86Instr instr;
+
+  memset(&instr, 0, sizeof(instr));
+  instr.opcode = opcode;
+  instr.condition = condition;
+  instr.target = target;
+  instr.edge = edge;
+  ir_x86_put(emitter, &instr);
+}
+
+static void ir_x86_label(IrX86Emitter *emitter, const IrBlock *block,
+                         int edge) {
+  if (emitter->object) {
+    size_t offset = ir_elf_section_size(emitter->object, IR_ELF_TEXT);
+
+    if (edge < 0) {
+      emitter->block_offsets[block->index] = offset;
+    } else if (ir_x86_reserve_edges(emitter, edge)) {
+      emitter->edge_offsets[edge] = offset;
+    }
+    return;
+  }
+
+  ir_x86_print_target(emitter, block, edge);
+  fprintf(emitter->out, ":\n");
+}
+
+static IrX86Location ir_x86_location(const IrX86Emitter *emitter,
+                                     const IrValue *value) {
+  IrX86Location none = {IR_X86_LOCATION_NONE, IR_X86_NO_REGISTER, 0};
+  size_t slot = 0;
+
+  if (value->kind != IR_VALUE_PARAM && value->kind != IR_VALUE_INSTR) {
+    return none;
+  }
+
+  slot = ir_regalloc_slot(emitter->function, value);
+  return slot == SIZE_MAX ? none : emitter->locations[slot];
+}
+
+static int ir_x86_same_location(const IrX86Location *left,
+                                const IrX86Location *right) {
+  if (left->kind != right->kind) {
+    return 0;
+  }
+  if (left->kind == IR_X86_LOCATION_REG) {
+    return left->reg == right->reg;
+  }
+  return left->offset == right->offset;
+}
+
+static IrX86Operand ir_x86_location_operand(const IrX86Location *location) {
+  if (location->kind == IR_X86_LOCATION_REG) {
+    return ir_x86_reg(location->reg);
+  }
+  return ir_x86_mem(IR_X86_RBP, location->offset);
+}
+
+/* A value usable as an instruction operand as is: a register, slot, or
+ * 32-bit immediate. */
+static int ir_x86_direct(const IrX86Emitter *emitter, const IrValue *value,
+                         IrX86Operand *operand) {
+  IrX86Location location;
+  long long constant = 0;
+
+  if (ir_value_is_const_int(value, &constant)) {
+    *operand = ir_x86_imm(constant);
+    return ir_x86_fits_imm32(constant);
+  }
+
+  if (value->kind == IR_VALUE_NULL) {
+    *operand = ir_x86_imm(0);
+    return 1;
+  }
+
+  location = ir_x86_location(emitter, value);
+  if (location.kind != IR_X86_LOCATION_REG &&
+      location.kind != IR_X86_LOCATION_STACK) {
+    return 0;
+  }
+
+  *operand = ir_x86_location_operand(&location);
+  return 1;
+}
+
+/* Materializes a value in the full 64-bit register. */
+static void ir_x86_load(IrX86Emitter *emitter, const IrValue *value,
+                        IrX86Register reg) {
+  IrX86Location location;
+  IrX86Operand symbol;
+
+  switch (value->kind) {
+  case IR_VALUE_CONST_INT:
+    if (value->constant == 0) {
+      ir_x86_op(emitter, IR_X86_XOR, 32, ir_x86_reg(reg), ir_x86_reg(reg));
+    } else if (value->constant > 0 && value->constant <= INT32_MAX) {
+      /* Writing the low half zeroes the rest. */
+      ir_x86_op(emitter, IR_X86_MOV, 32, ir_x86_imm(value->constant),
+                ir_x86_reg(reg));
+    } else {
+      ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_imm(value->constant),
+                ir_x86_reg(reg));
+    }
+    break;
+  case IR_VALUE_NULL:
+  case IR_VALUE_ZERO:
+  /* Aggregates only initialize globals and never reach here. */
+  case IR_VALUE_AGGREGATE:
+    ir_x86_op(emitter, IR_X86_XOR, 32, ir_x86_reg(reg), ir_x86_reg(reg));
+    break;
+  case IR_VALUE_GLOBAL:
+    ir_x86_op(emitter, IR_X86_LEA, 64, ir_x86_symbol(value->global->name, 0),
+              ir_x86_reg(reg));
+    break;
+  case IR_VALUE_FUNCTION:
+    symbol = ir_x86_symbol(value->function->name, 0);
+    if (ir_function_is_declaration(value->function)) {
+      symbol.got = 1;
+      ir_x86_op(emitter, IR_X86_MOV, 64, symbol, ir_x86_reg(reg));
+    } else {
+      ir_x86_op(emitter, IR_X86_LEA, 64, symbol, ir_x86_reg(reg));
+    }
+    break;
+  case IR_VALUE_PARAM:
+  case IR_VALUE_INSTR:
+    location = ir_x86_location(emitter, value);
+    if (location.kind == IR_X86_LOCATION_FRAME) {
+      ir_x86_op(emitter, IR_X86_LEA, 64,
+                ir_x86_mem(IR_X86_RBP, location.offset), ir_x86_reg(reg));
+    } else if (location.kind == IR_X86_LOCATION_STACK ||
+               (location.kind == IR_X86_LOCATION_REG && location.reg != reg)) {
+      ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_location_operand(&location),
+                ir_x86_reg(reg));
+    }
+    break;
+  }
+}
+
+/* Returns the value as an operand, loading it into scratch if needed. */
+static IrX86Operand ir_x86_source(IrX86Emitter *emitter, const IrValue *value,
+                                  IrX86Register scratch) {
+  IrX86Operand operand;
+
+  if (ir_x86_direct(emitter, value, &operand)) {
+    return operand;
+  }
+
+  ir_x86_load(emitter, value, scratch);
+  return ir_x86_reg(scratch);
+}
+
+/* Writes a computed result from reg to the instruction's location. */
+static void ir_x86_define(IrX86Emitter *emitter, const IrInstr *instr,
+                          IrX86Register reg) {
+  IrX86Location location = ir_x86_location(emitter, &instr->value);
+
+  if (location.kind == IR_X86_LOCATION_STACK ||
+      (location.kind == IR_X86_LOCATION_REG && location.reg != reg)) {
+    ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_reg(reg),
+              ir_x86_location_operand(&location));
+  }
+}
+
+/*
+ * Computes directly in the result register unless an operand read after
+ * the first write lives there; otherwise in %rax.
+ */
+static IrX86Register ir_x86_work(const IrX86Emitter *emitter,
+                                 const IrInstr *instr, size_t read_late) {
+  IrX86Location result = ir_x86_location(emitter, &instr->value);
+  size_t index = 0;
+
+  if (result.kind != IR_X86_LOCATION_REG) {
+    return IR_X86_RAX;
+  }
+
+  for (index = read_late; index < instr->operand_count; index++) {
+    IrX86Location operand = ir_x86_location(emitter, instr->operands[index]);
+
+    if (operand.kind == IR_X86_LOCATION_REG && operand.reg == result.reg) {
+      return IR_X86_RAX;
+    }
+  }
+
+  return result.reg;
+}
+
+/* Extends the low bits of a register to all 64. */
+static void ir_x86_extend(IrX86Emitter *emitter, IrX86Register reg, int bits,
+                          int is_signed) {
+  IrX86Operand operand = ir_x86_reg(reg);
+
+  switch (bits) {
+  case 1:
+    ir_x86_op(emitter, IR_X86_AND, 32, ir_x86_imm(1), operand);
+    if (is_signed) {
+      ir_x86_op1(emitter, IR_X86_NEG, 64, operand);
+    }
+    break;
+  case 8:
+  case 16:
+    ir_x86_op(emitter, is_signed ? IR_X86_MOVSX : IR_X86_MOVZX, bits, operand,
+              operand);
+    break;
+  case 32:
+    ir_x86_op(emitter, is_signed ? IR_X86_MOVSX : IR_X86_MOV, 32, operand,
+              operand);
+    break;
+  default:
+    break;
+  }
+}
+
+static IrX86Operand ir_x86_address(IrX86Emitter *emitter,
+                                   const IrValue *pointer,
+                                   IrX86Register scratch) {
+  IrX86Location location = ir_x86_location(emitter, pointer);
+
+  if (pointer->kind == IR_VALUE_GLOBAL) {
+    return ir_x86_symbol(pointer->global->name, 0);
+  }
+  if (location.kind == IR_X86_LOCATION_FRAME) {
+    return ir_x86_mem(IR_X86_RBP, location.offset);
+  }
+  if (location.kind == IR_X86_LOCATION_REG) {
+    return ir_x86_mem(location.reg, 0);
+  }
+
+  ir_x86_load(emitter, pointer, scratch);
+  return ir_x86_mem(scratch, 0);
+}
+
+static int ir_x86_reserve_moves(IrX86Emitter *emitter, size_t count) {
+  IrX86Move *moves = NULL;
+
+  if (count <= emitter->move_capacity) {
+    return 1;
+  }
+
+  moves = realloc(emitter->moves, count * sizeof(*moves));
+  if (!moves) {
+    emitter->failed = 1;
+    return 0;
+  }
+  emitter->moves = moves;
+  emitter->move_capacity = count;
+  return 1;
+}
+
+static void ir_x86_set_move(IrX86Emitter *emitter, IrX86Move *move,
+                            IrX86Location dst, const IrValue *value) {
+  IrX86Location location = ir_x86_location(emitter, value);
+
+  move->dst = dst;
+  move->value = value;
+  move->done = 0;
+  move->src = location;
+  if (location.kind != IR_X86_LOCATION_REG &&
+      location.kind != IR_X86_LOCATION_STACK) {
+    move->src.kind = IR_X86_LOCATION_NONE;
+  }
+}
+
+static void ir_x86_move_one(IrX86Emitter *emitter, const IrX86Move *move) {
+  IrX86Operand dst = ir_x86_location_operand(&move->dst);
+  IrX86Operand operand;
+
+  if (move->src.kind != IR_X86_LOCATION_NONE) {
+    IrX86Operand src = ir_x86_location_operand(&move->src);
+
+    if (move->dst.kind == IR_X86_LOCATION_STACK &&
+        move->src.kind == IR_X86_LOCATION_STACK) {
+      ir_x86_op(emitter, IR_X86_MOV, 64, src, ir_x86_reg(IR_X86_RAX));
+      src = ir_x86_reg(IR_X86_RAX);
+    }
+    ir_x86_op(emitter, IR_X86_MOV, 64, src, dst);
+    return;
+  }
+
+  if (move->dst.kind == IR_X86_LOCATION_REG) {
+    ir_x86_load(emitter, move->value, move->dst.reg);
+  } else if (ir_x86_direct(emitter, move->value, &operand)) {
+    ir_x86_op(emitter, IR_X86_MOV, 64, operand, dst);
+  } else {
+    ir_x86_load(emitter, move->value, IR_X86_RAX);
+    ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_reg(IR_X86_RAX), dst);
+  }
+}
+
+/*
+ * Performs a set of moves as if simultaneously. A move waits while another
+ * pending move still reads its destination; a cycle is broken by parking
+ * one destination's old contents in %r11.
+ */
+static void ir_x86_parallel_move(IrX86Emitter *emitter, IrX86Move *moves,
+                                 size_t count) {
+  size_t pending = 0;
+  size_t index = 0;
+  size_t other = 0;
+
+  for (index = 0; index < count; index++) {
+    if (moves[index].dst.kind == IR_X86_LOCATION_NONE ||
+        (moves[index].src.kind != IR_X86_LOCATION_NONE &&
+         ir_x86_same_location(&moves[index].src, &moves[index].dst))) {
+      moves[index].done = 1;
+    } else {
+      pending++;
+    }
+  }
+
+  while (pending > 0) {
+    int progress = 0;
+
+    for (index = 0; index < count; index++) {
+      int blocked = 0;
+
+      if (moves[index].done) {
+        continue;
+      }
+
+      for (other = 0; other < count && !blocked; other++) {
+        blocked = other != index && !moves[other].done &&
+                  moves[other].src.kind != IR_X86_LOCATION_NONE &&
+                  ir_x86_same_location(&moves[other].src, &moves[index].dst);
+      }
+
+      if (!blocked) {
+        ir_x86_move_one(emitter, &moves[index]);
+        moves[index].done = 1;
+        pending--;
+        progress = 1;
+      }
+    }
+
+    if (progress) {
+      continue;
+    }
+
+    for (index = 0; moves[index].done; index++) {
+    }
+    ir_x86_op(emitter, IR_X86_MOV, 64,
+              ir_x86_location_operand(&moves[index].dst),
+              ir_x86_reg(IR_X86_R11));
+    for (other = 0; other < count; other++) {
+      if (!moves[other].done &&
+          moves[other].src.kind != IR_X86_LOCATION_NONE &&
+          ir_x86_same_location(&moves[other].src, &moves[index].dst)) {
+        moves[other].src.kind = IR_X86_LOCATION_REG;
+        moves[other].src.reg = IR_X86_R11;
+      }
+    }
+  }
+}
+
+static int ir_x86_has_phis(const IrBlock *block) {
+  return block->first && block->first->opcode == IR_OP_PHI;
+}
+
+/* Copies the incoming values of the phis in `to` for the edge from `from`. */
+static void ir_x86_phi_copies(IrX86Emitter *emitter, const IrBlock *from,
+                              const IrBlock *to) {
+  const IrInstr *instr = NULL;
+  size_t count = 0;
+  size_t index = 0;
+
+  for (instr = to->first; instr && instr->opcode == IR_OP_PHI;
+       instr = instr->next) {
+    count++;
+  }
+  if (count == 0 || !ir_x86_reserve_moves(emitter, count)) {
+    return;
+  }
+
+  count = 0;
+  for (instr = to->first; instr && instr->opcode == IR_OP_PHI;
+       instr = instr->next) {
+    for (index = 0; index < instr->block_count; index++) {
+      if (instr->blocks[index] == from) {
+        ir_x86_set_move(emitter, &emitter->moves[count++],
+                        ir_x86_location(emitter, &instr->value),
+                        instr->operands[index]);
+        break;
+      }
+    }
+  }
+
+  ir_x86_parallel_move(emitter, emitter->moves, count);
+}
+
+static void ir_x86_jump(IrX86Emitter *emitter, const IrBlock *from,
+                        const IrBlock *to, int may_fall_through) {
+  ir_x86_phi_copies(emitter, from, to);
+  if (may_fall_through && from->next == to) {
+    return;
+  }
+
+  ir_x86_branch(emitter, IR_X86_JMP, IR_X86_CC_E, to, -1);
+}
+
+static IrX86Condition ir_x86_condition(IrPredicate predicate) {
+  switch (predicate) {
+  case IR_PRED_EQ:
+    return IR_X86_CC_E;
+  case IR_PRED_NE:
+    return IR_X86_CC_NE;
+  case IR_PRED_SLT:
+    return IR_X86_CC_L;
+  case IR_PRED_SLE:
+    return IR_X86_CC_LE;
+  case IR_PRED_SGT:
+    return IR_X86_CC_G;
+  case IR_PRED_SGE:
+    return IR_X86_CC_GE;
+  case IR_PRED_ULT:
+    return IR_X86_CC_B;
+  case IR_PRED_ULE:
+    return IR_X86_CC_BE;
+  case IR_PRED_UGT:
+    return IR_X86_CC_A;
+  case IR_PRED_UGE:
+    return IR_X86_CC_AE;
+  }
+  return IR_X86_CC_E;
+}
+
+/* An icmp feeding only the branch right after it sets the flags for it. */
+static int ir_x86_fuses_with_branch(const IrInstr *instr) {
+  return instr->opcode == IR_OP_ICMP && instr->value.use_count == 1 &&
+         instr->next && instr->next->opcode == IR_OP_CONDBR &&
+         instr->next->operands[0] == &instr->value;
+}
+
+/* Compares at the operand width, so no extension is needed. */
+static void ir_x86_compare(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrValue *left = instr->operands[0];
+  const IrValue *right = instr->operands[1];
+  int bits = ir_x86_bits(left->type);
+  IrX86Location location = ir_x86_location(emitter, left);
+  IrX86Operand left_operand;
+  IrX86Operand right_operand;
+  int right_direct = ir_x86_direct(emitter, right, &right_operand);
+
+  if (location.kind == IR_X86_LOCATION_REG ||
+      (location.kind == IR_X86_LOCATION_STACK && right_direct &&
+       right_operand.kind != IR_X86_OPERAND_MEM)) {
+    left_operand = ir_x86_location_operand(&location);
+  } else {
+    ir_x86_load(emitter, left, IR_X86_RAX);
+    left_operand = ir_x86_reg(IR_X86_RAX);
+  }
+
+  if (!right_direct || (left_operand.kind == IR_X86_OPERAND_MEM &&
+                        right_operand.kind == IR_X86_OPERAND_MEM)) {
+    ir_x86_load(emitter, right, IR_X86_RCX);
+    right_operand = ir_x86_reg(IR_X86_RCX);
+  }
+
+  if (right_operand.kind == IR_X86_OPERAND_IMM && right_operand.value == 0 &&
+      left_operand.kind == IR_X86_OPERAND_REG) {
+    ir_x86_op(emitter, IR_X86_TEST, bits == 1 ? 8 : bits, left_operand,
+              left_operand);
+    return;
+  }
+
+  ir_x86_op(emitter, IR_X86_CMP, bits == 1 ? 8 : bits, right_operand,
+            left_operand);
+}
+
+static void ir_x86_icmp(IrX86Emitter *emitter, const IrInstr *instr) {
+  IrX86Register work = ir_x86_work(emitter, instr, instr->operand_count);
+
+  if (ir_x86_fuses_with_branch(instr)) {
+    return;
+  }
+
+  ir_x86_compare(emitter, instr);
+  ir_x86_setcc(emitter, ir_x86_condition(instr->predicate), work);
+  ir_x86_op(emitter, IR_X86_MOVZX, 8, ir_x86_reg(work), ir_x86_reg(work));
+  ir_x86_define(emitter, instr, work);
+}
+
+static void ir_x86_condbr(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrBlock *from = instr->parent;
+  const IrBlock *on_true = instr->blocks[0];
+  const IrBlock *on_false = instr->blocks[1];
+  const IrValue *condition = instr->operands[0];
+  IrX86Condition taken = IR_X86_CC_NE;
+  IrX86Operand operand;
+  long long constant = 0;
+  int edge = 0;
+
+  if (ir_value_is_const_int(condition, &constant)) {
+    ir_x86_jump(emitter, from, constant & 1 ? on_true : on_false, 1);
+    return;
+  }
+
+  if (condition->kind == IR_VALUE_INSTR &&
+      ir_x86_fuses_with_branch(condition->instr)) {
+    ir_x86_compare(emitter, condition->instr);
+    taken = ir_x86_condition(condition->instr->predicate);
+  } else {
+    if (!ir_x86_direct(emitter, condition, &operand)) {
+      ir_x86_load(emitter, condition, IR_X86_RAX);
+      operand = ir_x86_reg(IR_X86_RAX);
+    }
+    ir_x86_op(emitter, IR_X86_TEST, 8, ir_x86_imm(1), operand);
+  }
+
+  /* Branch on whichever edge lets the other one fall through. */
+  if (!ir_x86_has_phis(on_false) &&
+      (ir_x86_has_phis(on_true) || from->next == on_true)) {
+    ir_x86_branch(emitter, IR_X86_JCC, taken ^ 1, on_false, -1);
+    ir_x86_jump(emitter, from, on_true, 1);
+    return;
+  }
+
+  if (!ir_x86_has_phis(on_true)) {
+    ir_x86_branch(emitter, IR_X86_JCC, taken, on_true, -1);
+    ir_x86_jump(emitter, from, on_false, 1);
+    return;
+  }
+
+  /* Both edges carry phi copies: split the false edge into its own stub. */
+  edge = emitter->edge_count++;
+  ir_x86_branch(emitter, IR_X86_JCC, taken ^ 1, NULL, edge);
+  ir_x86_jump(emitter, from, on_true, 0);
+  ir_x86_label(emitter, NULL, edge);
+  ir_x86_jump(emitter, from, on_false, 1);
+}
+
+/* Writes one jump table entry: the target's offset from the table. */
+static void ir_x86_table_entry(IrX86Emitter *emitter, int table,
+                               const IrBlock *target, int edge) {
+  static const unsigned char zero[4] = {0, 0, 0, 0};
+  size_t field = 0;
+
+  if (emitter->object) {
+    field = ir_elf_section_size(emitter->object, IR_ELF_TEXT);
+    ir_elf_append(emitter->object, IR_ELF_TEXT, zero, sizeof(zero));
+    ir_x86_add_fixup(emitter, target, edge, field,
+                     emitter->edge_offsets[table]);
+    return;
+  }
+
+  fprintf(emitter->out, "\t.long\t");
+  ir_x86_print_target(emitter, target, edge);
+  fprintf(emitter->out, "-.Ledge%d\n", table);
+}
+
+/*
+ * A switch that ir_switch_lower_function left in place is dense: it
+ * becomes a bounds check and an indirect jump through a table of 32-bit
+ * offsets placed right after it. Targets with phis are reached through
+ * edge stubs after the table.
+ */
+static void ir_x86_switch(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrBlock *from = instr->parent;
+  size_t case_count = instr->operand_count - 1;
+  unsigned long long range = 0;
+  unsigned long long value = 0;
+  IrX86Operand entry = ir_x86_mem(IR_X86_RCX, 0);
+  size_t *slots = NULL;
+  int *edges = NULL;
+  long long low = instr->operands[1]->constant;
+  long long high = low;
+  size_t index = 0;
+  size_t other = 0;
+  int table = 0;
+
+  for (index = 1; index <= case_count; index++) {
+    low = instr->operands[index]->constant < low
+            ? instr->operands[index]->constant
+            : low;
+    high = instr->operands[index]->constant > high
+             ? instr->operands[index]->constant
+             : high;
+  }
+  range = (unsigned long long)high - (unsigned long long)low + 1;
+  slots = calloc(range, sizeof(*slots));
+  edges = malloc(instr->block_count * sizeof(*edges));
+  if (!slots || !edges ||
+      (emitter->object &&
+       !ir_x86_reserve_edges(emitter, emitter->edge_count))) {
+    emitter->failed = 1;
+    goto cleanup;
+  }
+
+  /* Slots left at 0 go to the default block. */
+  for (index = 1; index <= case_count; index++) {
+    slots[instr->operands[index]->constant - low] = index;
+  }
+  table = emitter->edge_count++;
+  for (index = 0; index < instr->block_count; index++) {
+    edges[index] = -1;
+    if (!ir_x86_has_phis(instr->blocks[index])) {
+      continue;
+    }
+    for (other = 0; other < index; other++) {
+      if (instr->blocks[other] == instr->blocks[index]) {
+        break;
+      }
+    }
+    edges[index] = other < index ? edges[other] : emitter->edge_count++;
+  }
+
+  ir_x86_load(emitter, instr->operands[0], IR_X86_RAX);
+  ir_x86_extend(emitter, IR_X86_RAX, ir_x86_bits(instr->operands[0]->type),
+                1);
+  if (!ir_x86_fits_imm32(low)) {
+    ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_imm(low),
+              ir_x86_reg(IR_X86_RCX));
+    ir_x86_op(emitter, IR_X86_SUB, 64, ir_x86_reg(IR_X86_RCX),
+              ir_x86_reg(IR_X86_RAX));
+  } else if (low != 0) {
+    ir_x86_op(emitter, IR_X86_SUB, 64, ir_x86_imm(low),
+              ir_x86_reg(IR_X86_RAX));
+  }
+  ir_x86_op(emitter, IR_X86_CMP, 64, ir_x86_imm((long long)range - 1),
+            ir_x86_reg(IR_X86_RAX));
+  ir_x86_branch(emitter, IR_X86_JCC, IR_X86_CC_A,
+                edges[0] < 0 ? instr->blocks[0] : NULL, edges[0]);
+  entry.index = IR_X86_RAX;
+  entry.scale = 4;
+  ir_x86_op(emitter, IR_X86_LEA, 64, ir_x86_edge_label(table),
+            ir_x86_reg(IR_X86_RCX));
+  ir_x86_op(emitter, IR_X86_MOVSX, 32, entry, ir_x86_reg(IR_X86_RAX));
+  ir_x86_op(emitter, IR_X86_ADD, 64, ir_x86_reg(IR_X86_RCX),
+            ir_x86_reg(IR_X86_RAX));
+  ir_x86_op1(emitter, IR_X86_JMP, 64, ir_x86_reg(IR_X86_RAX));
+
+  if (emitter->object) {
+    ir_elf_align(emitter->object, IR_ELF_TEXT, 4, 0x90);
+  } else {
+    fprintf(emitter->out, "\t.p2align\t2\n");
+  }
+  ir_x86_label(emitter, NULL, table);
+  for (value = 0; value < range; value++) {
+    index = slots[value];
+    ir_x86_table_entry(emitter, table,
+                       edges[index] < 0 ? instr->blocks[index] : NULL,
+                       edges[index]);
+  }
+
+  for (index = 0; index < instr->block_count; index++) {
+    for (other = 0; other < index; other++) {
+      if (edges[other] == edges[index]) {
+        break;
+      }
+    }
+    if (edges[index] >= 0 && other == index) {
+      ir_x86_label(emitter, NULL, edges[index]);
+      ir_x86_jump(emitter, from, instr->blocks[index], 0);
+    }
+  }
+
+cleanup:
+  free(slots);
+  free(edges);
+}
+
+static int ir_x86_is_scale(size_t stride) {
+  return stride == 1 || stride == 2 || stride == 4 || stride == 8;
+}
+
+/* Loads a GEP index sign-extended to 64 bits, preferring its register. */
+static IrX86Register ir_x86_index(IrX86Emitter *emitter,
+                                  const IrValue *index) {
+  IrX86Location location = ir_x86_location(emitter, index);
+  int bits = ir_x86_bits(index->type);
+  IrX86Operand operand;
+
+  if (bits == 64 && location.kind == IR_X86_LOCATION_REG) {
+    return location.reg;
+  }
+
+  if (bits > 1 && bits < 64 && ir_x86_direct(emitter, index, &operand) &&
+      operand.kind != IR_X86_OPERAND_IMM) {
+    ir_x86_op(emitter, IR_X86_MOVSX, bits, operand, ir_x86_reg(IR_X86_RCX));
+    return IR_X86_RCX;
+  }
+
+  ir_x86_load(emitter, index, IR_X86_RCX);
+  ir_x86_extend(emitter, IR_X86_RCX, bits, 1);
+  return IR_X86_RCX;
+}
+
+static void ir_x86_gep(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrValue *base = instr->operands[0];
+  IrX86Location location = ir_x86_location(emitter, base);
+  IrX86Register work = ir_x86_work(emitter, instr, 1);
+  const IrType *type = instr->aux_type;
+  const IrValue *variable = NULL;
+  size_t variable_stride = 0;
+  size_t variable_count = 0;
+  long long offset = 0;
+  size_t index = 0;
+  int pass = 0;
+
+  /* Pass 0 folds constants and counts variable indices; pass 1 adds them. */
+  for (pass = 0; pass < 2; pass++) {
+    type = instr->aux_type;
+    for (index = 1; index < instr->operand_count; index++) {
+      const IrValue *operand = instr->operands[index];
+      long long constant = 0;
+      size_t stride = 0;
+
+      if (index > 1 && type->kind == IR_TYPE_STRUCT) {
+        /* Struct field indices are always constants. */
+        ir_value_is_const_int(operand, &constant);
+        if (pass == 0) {
+          offset += (long long)ir_type_field_offset(type, (size_t)constant);
+        }
+        type = type->fields[constant];
+        continue;
+      }
+
+      if (index > 1) {
+        type = type->element;
+      }
+      stride = ir_type_size(type);
+
+      if (ir_value_is_const_int(operand, &constant)) {
+        offset += pass == 0 ? constant * (long long)stride : 0;
+      } else if (pass == 0) {
+        variable = operand;
+        variable_stride = stride;
+        variable_count++;
+      } else {
+        IrX86Register reg = ir_x86_index(emitter, operand);
+
+        if (stride != 1) {
+          ir_x86_op(emitter, IR_X86_IMUL, 64, ir_x86_imm((long long)stride),
+                    ir_x86_reg(reg));
+        }
+        ir_x86_op(emitter, IR_X86_ADD, 64, ir_x86_reg(reg),
+                  ir_x86_reg(IR_X86_RAX));
+      }
+    }
+
+    if (pass == 0 && variable_count == 0) {
+      if (base->kind == IR_VALUE_GLOBAL) {
+        ir_x86_op(emitter, IR_X86_LEA, 64,
+                  ir_x86_symbol(base->global->name, offset),
+                  ir_x86_reg(work));
+      } else if (location.kind == IR_X86_LOCATION_FRAME) {
+        ir_x86_op(emitter, IR_X86_LEA, 64,
+                  ir_x86_mem(IR_X86_RBP, location.offset + offset),
+                  ir_x86_reg(work));
+      } else if (location.kind == IR_X86_LOCATION_REG && offset != 0) {
+        ir_x86_op(emitter, IR_X86_LEA, 64, ir_x86_mem(location.reg, offset),
+                  ir_x86_reg(work));
+      } else {
+        ir_x86_load(emitter, base, work);
+        if (offset != 0) {
+          ir_x86_op(emitter, IR_X86_LEA, 64, ir_x86_mem(work, offset),
+                    ir_x86_reg(work));
+        }
+      }
+      ir_x86_define(emitter, instr, work);
+      return;
+    }
+
+    if (pass == 0 && variable_count == 1 && ir_x86_is_scale(variable_stride)) {
+      IrX86Location result = ir_x86_location(emitter, &instr->value);
+      IrX86Operand address;
+      IrX86Register reg = ir_x86_index(emitter, variable);
+
+      /* The lea reads everything before it writes. */
+      if (result.kind == IR_X86_LOCATION_REG) {
+        work = result.reg;
+      }
+
+      if (location.kind == IR_X86_LOCATION_FRAME) {
+        address = ir_x86_mem(IR_X86_RBP, location.offset + offset);
+      } else if (location.kind == IR_X86_LOCATION_REG) {
+        address = ir_x86_mem(location.reg, offset);
+      } else {
+        ir_x86_load(emitter, base, IR_X86_RAX);
+        address = ir_x86_mem(IR_X86_RAX, offset);
+      }
+      address.index = reg;
+      address.scale = (int)variable_stride;
+      ir_x86_op(emitter, IR_X86_LEA, 64, address, ir_x86_reg(work));
+      ir_x86_define(emitter, instr, work);
+      return;
+    }
+
+    if (pass == 0) {
+      ir_x86_load(emitter, base, IR_X86_RAX);
+    }
+  }
+
+  if (offset != 0) {
+    ir_x86_op(emitter, IR_X86_LEA, 64, ir_x86_mem(IR_X86_RAX, offset),
+              ir_x86_reg(IR_X86_RAX));
+  }
+  ir_x86_define(emitter, instr, IR_X86_RAX);
+}
+
+static void ir_x86_divide(IrX86Emitter *emitter, const IrInstr *instr) {
+  int bits = ir_x86_bits(instr->value.type);
+  int width = bits == 64 ? 64 : 32;
+  IrX86Operand divisor;
+
+  ir_x86_load(emitter, instr->operands[0], IR_X86_RAX);
+  if (bits < 32) {
+    ir_x86_extend(emitter, IR_X86_RAX, bits, 1);
+  }
+
+  if (bits < 32 || !ir_x86_direct(emitter, instr->operands[1], &divisor) ||
+      divisor.kind == IR_X86_OPERAND_IMM) {
+    ir_x86_load(emitter, instr->operands[1], IR_X86_RCX);
+    ir_x86_extend(emitter, IR_X86_RCX, bits < 32 ? bits : 64, 1);
+    divisor = ir_x86_reg(IR_X86_RCX);
+  }
+
+  ir_x86_op1(emitter, IR_X86_CQO, width, ir_x86_reg(IR_X86_RAX));
+  ir_x86_op1(emitter, IR_X86_IDIV, width, divisor);
+  ir_x86_define(emitter, instr,
+                instr->opcode == IR_OP_SREM ? IR_X86_RDX : IR_X86_RAX);
+}
+
+static void ir_x86_binary(IrX86Emitter *emitter, const IrInstr *instr) {
+  int bits = ir_x86_bits(instr->value.type);
+  int width = bits > 32 ? 64 : 32;
+  IrX86Register work = ir_x86_work(emitter, instr, 1);
+  IrX86Operand operand;
+  long long constant = 0;
+  IrX86Opcode opcode = IR_X86_ADD;
+  size_t first = 0;
+
+  switch (instr->opcode) {
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+    ir_x86_divide(emitter, instr);
+    return;
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+    if (ir_value_is_const_int(instr->operands[1], &constant)) {
+      operand = ir_x86_imm(constant & (width - 1));
+    } else {
+      ir_x86_load(emitter, instr->operands[1], IR_X86_RCX);
+      operand = ir_x86_reg(IR_X86_RCX);
+    }
+    ir_x86_load(emitter, instr->operands[0], work);
+    if (instr->opcode != IR_OP_SHL && bits < 32) {
+      ir_x86_extend(emitter, work, bits, instr->opcode == IR_OP_ASHR);
+    }
+    opcode = instr->opcode == IR_OP_SHL    ? IR_X86_SHL
+             : instr->opcode == IR_OP_ASHR ? IR_X86_SAR
+                                           : IR_X86_SHR;
+    ir_x86_op(emitter, opcode, width, operand, ir_x86_reg(work));
+    ir_x86_define(emitter, instr, work);
+    return;
+  case IR_OP_SUB:
+    opcode = IR_X86_SUB;
+    break;
+  case IR_OP_MUL:
+    opcode = IR_X86_IMUL;
+    break;
+  case IR_OP_AND:
+    opcode = IR_X86_AND;
+    break;
+  case IR_OP_OR:
+    opcode = IR_X86_OR;
+    break;
+  case IR_OP_XOR:
+    opcode = IR_X86_XOR;
+    break;
+  default:
+    break;
+  }
+
+  /* Commutative operations can start from whichever operand is in place. */
+  if (opcode != IR_X86_SUB && work == IR_X86_RAX) {
+    IrX86Location result = ir_x86_location(emitter, &instr->value);
+    IrX86Location right = ir_x86_location(emitter, instr->operands[1]);
+
+    if (result.kind == IR_X86_LOCATION_REG && right.kind == result.kind &&
+        right.reg == result.reg) {
+      work = result.reg;
+      first = 1;
+    }
+  }
+
+  ir_x86_load(emitter, instr->operands[first], work);
+  operand = ir_x86_source(emitter, instr->operands[1 - first], IR_X86_RCX);
+  ir_x86_op(emitter, opcode, width, operand, ir_x86_reg(work));
+  ir_x86_define(emitter, instr, work);
+}
+
+static void ir_x86_cast(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrValue *operand = instr->operands[0];
+  int from_bits = ir_x86_bits(operand->type);
+  IrX86Register work = ir_x86_work(emitter, instr, 1);
+  int is_signed = instr->opcode == IR_OP_SEXT;
+  IrX86Operand source;
+
+  if (instr->opcode == IR_OP_SEXT || instr->opcode == IR_OP_ZEXT ||
+      instr->opcode == IR_OP_INTTOPTR) {
+    if (from_bits > 1 && from_bits < 64 &&
+        ir_x86_direct(emitter, operand, &source) &&
+        source.kind != IR_X86_OPERAND_IMM) {
+      ir_x86_op(emitter,
+                is_signed      ? IR_X86_MOVSX
+                : from_bits == 32 ? IR_X86_MOV
+                                  : IR_X86_MOVZX,
+                from_bits, source, ir_x86_reg(work));
+    } else {
+      ir_x86_load(emitter, operand, work);
+      ir_x86_extend(emitter, work, from_bits, is_signed);
+    }
+  } else {
+    ir_x86_load(emitter, operand, work);
+  }
+
+  ir_x86_define(emitter, instr, work);
+}
+
+static void ir_x86_load_instr(IrX86Emitter *emitter, const IrInstr *instr) {
+  int bits = ir_x86_bits(instr->value.type);
+  IrX86Register work = ir_x86_work(emitter, instr, 1);
+  IrX86Operand address =
+    ir_x86_address(emitter, instr->operands[0], IR_X86_RAX);
+
+  if (bits <= 16) {
+    ir_x86_op(emitter, IR_X86_MOVZX, bits <= 8 ? 8 : 16, address,
+              ir_x86_reg(work));
+  } else {
+    ir_x86_op(emitter, IR_X86_MOV, bits, address, ir_x86_reg(work));
+  }
+  ir_x86_define(emitter, instr, work);
+}
+
+static void ir_x86_store(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrValue *value = instr->operands[0];
+  int bits = ir_x86_bits(value->type);
+  IrX86Operand address =
+    ir_x86_address(emitter, instr->operands[1], IR_X86_RAX);
+  IrX86Operand operand;
+
+  if (!ir_x86_direct(emitter, value, &operand) ||
+      operand.kind == IR_X86_OPERAND_MEM) {
+    ir_x86_load(emitter, value, IR_X86_RCX);
+    operand = ir_x86_reg(IR_X86_RCX);
+  }
+  ir_x86_op(emitter, IR_X86_MOV, bits == 1 ? 8 : bits, operand, address);
+}
+
+/*
+ * A tail call whose arguments all go in registers: the frame is torn down
+ * first and the callee returns straight to our caller. The ret after it
+ * is then never reached.
+ */
+static int ir_x86_is_sibling_call(const IrInstr *instr) {
+  return instr->opcode == IR_OP_CALL &&
+         (instr->flags & (IR_FLAG_TAIL | IR_FLAG_MUSTTAIL)) &&
+         instr->operand_count - 1 <= IR_X86_REGISTER_ARGS && instr->next &&
+         instr->next->opcode == IR_OP_RET &&
+         (instr->next->operand_count == 0 ||
+          instr->next->operands[0] == &instr->value);
+}
+
+/* Restores the callee-saved registers and pops the frame. */
+static void ir_x86_epilogue(IrX86Emitter *emitter) {
+  size_t index = 0;
+
+  for (index = 0; index < sizeof(ir_x86_callee_saved) / sizeof(int);
+       index++) {
+    int reg = ir_x86_callee_saved[index];
+
+    if (emitter->allocation.callee_saved_used & (1UL << reg)) {
+      ir_x86_op(emitter, IR_X86_MOV, 64,
+                ir_x86_mem(IR_X86_RBP, emitter->callee_saved_offsets[reg]),
+                ir_x86_reg((IrX86Register)reg));
+    }
+  }
+
+  ir_x86_op1(emitter, IR_X86_LEAVE, 64, ir_x86_reg(IR_X86_RBP));
+}
+
+static void ir_x86_call(IrX86Emitter *emitter, const IrInstr *instr) {
+  const IrFunction *callee = instr->operands[0]->function;
+  size_t arg_count = instr->operand_count - 1;
+  size_t register_args =
+    arg_count < IR_X86_REGISTER_ARGS ? arg_count : IR_X86_REGISTER_ARGS;
+  size_t stack_args = arg_count - register_args;
+  long long stack_bytes = ir_x86_align((long long)stack_args * 8, 16);
+  IrX86Instr call;
+  size_t index = 0;
+
+  /* Keep %rsp 16-byte aligned at the call. */
+  if (stack_bytes > (long long)stack_args * 8) {
+    ir_x86_op(emitter, IR_X86_SUB, 64, ir_x86_imm(8), ir_x86_reg(IR_X86_RSP));
+  }
+
+  for (index = arg_count; index > IR_X86_REGISTER_ARGS; index--) {
+    ir_x86_op1(emitter, IR_X86_PUSH, 64,
+               ir_x86_source(emitter, instr->operands[index], IR_X86_RAX));
+  }
+
+  if (register_args > 0 && ir_x86_reserve_moves(emitter, register_args)) {
+    for (index = 0; index < register_args; index++) {
+      IrX86Location dst = {IR_X86_LOCATION_REG,
+                           ir_x86_argument_registers[index], 0};
+
+      ir_x86_set_move(emitter, &emitter->moves[index], dst,
+                      instr->operands[index + 1]);
+    }
+    ir_x86_parallel_move(emitter, emitter->moves, register_args);
+  }
+
+  for (index = 0; index < register_args; index++) {
+    int bits = ir_x86_bits(instr->operands[index + 1]->type);
+
+    /* Callers widen narrow arguments to 32 bits, as clang and gcc do. */
+    if (bits < 32) {
+      ir_x86_extend(emitter, ir_x86_argument_registers[index], bits,
+                    bits != 1);
+    }
+  }
+
+  memset(&call, 0, sizeof(call));
+  call.opcode = IR_X86_CALL;
+  call.callee = callee->name;
+  call.edge = -1;
+  if (ir_function_is_declaration(callee)) {
+    /* The callee may be variadic: no vector registers are used. */
+    ir_x86_op(emitter, IR_X86_XOR, 32, ir_x86_reg(IR_X86_RAX),
+              ir_x86_reg(IR_X86_RAX));
+    call.plt = 1;
+  }
+  if (ir_x86_is_sibling_call(instr)) {
+    ir_x86_epilogue(emitter);
+    call.opcode = IR_X86_JMP;
+    ir_x86_put(emitter, &call);
+    return;
+  }
+  ir_x86_put(emitter, &call);
+
+  if (stack_bytes > 0) {
+    ir_x86_op(emitter, IR_X86_ADD, 64, ir_x86_imm(stack_bytes),
+              ir_x86_reg(IR_X86_RSP));
+  }
+  if (ir_instr_has_result(instr)) {
+    ir_x86_define(emitter, instr, IR_X86_RAX);
+  }
+}
+
+/*
+ * memset as rep stosb and memcpy as rep movsb, which take the destination
+ * in %rdi, the byte in %al or the source in %rsi, and the length in %rcx.
+ * The allocator keeps values live across them out of those registers.
+ */
+static void ir_x86_memory(IrX86Emitter *emitter, const IrInstr *instr) {
+  IrX86Register registers[3] = {IR_X86_RDI, IR_X86_RAX, IR_X86_RCX};
+  size_t index = 0;
+
+  if (instr->opcode == IR_OP_MEMCPY) {
+    registers[1] = IR_X86_RSI;
+  }
+  if (!ir_x86_reserve_moves(emitter, 3)) {
+    return;
+  }
+  for (index = 0; index < 3; index++) {
+    IrX86Location dst = {IR_X86_LOCATION_REG, registers[index], 0};
+
+    ir_x86_set_move(emitter, &emitter->moves[index], dst,
+                    instr->operands[index]);
+  }
+  ir_x86_parallel_move(emitter, emitter->moves, 3);
+  ir_x86_op1(emitter,
+             instr->opcode == IR_OP_MEMSET ? IR_X86_REP_STOS : IR_X86_REP_MOVS,
+             8, ir_x86_reg(IR_X86_RDI));
+}
+
+static void ir_x86_return(IrX86Emitter *emitter, const IrInstr *instr) {
+  if (instr->prev && ir_x86_is_sibling_call(instr->prev)) {
+    return;
+  }
+
+  if (instr->operand_count > 0) {
+    ir_x86_load(emitter, instr->operands[0], IR_X86_RAX);
+  }
+
+  ir_x86_epilogue(emitter);
+  ir_x86_op1(emitter, IR_X86_RET, 64, ir_x86_reg(IR_X86_RSP));
+}
+
+/*
+ * Code from here on belongs to loc: a .loc directive, or a row of the
+ * object's line table.
+ */
+static void ir_x86_set_loc(IrX86Emitter *emitter, IrDebugLoc loc) {
+  if (!emitter->debug_info || loc.line == 0 ||
+      (loc.line == emitter->loc.line && loc.column == emitter->loc.column)) {
+    return;
+  }
+
+  emitter->loc = loc;
+  if (emitter->object) {
+    ir_dwarf_add_row(&emitter->lines,
+                     ir_elf_section_size(emitter->object, IR_ELF_TEXT), loc);
+  } else {
+    fprintf(emitter->out, "\t.loc\t1 %u %u\n", loc.line, loc.column);
+  }
+}
+
+static void ir_x86_instr(IrX86Emitter *emitter, const IrInstr *instr) {
+  /* Nothing reads a dead pure result. */
+  if (ir_instr_has_result(instr) && !ir_instr_has_side_effects(instr) &&
+      ir_x86_location(emitter, &instr->value).kind == IR_X86_LOCATION_NONE) {
+    return;
+  }
+  ir_x86_set_loc(emitter, instr->loc);
+
+  switch (instr->opcode) {
+  case IR_OP_ALLOCA:
+  case IR_OP_PHI:
+    break;
+  case IR_OP_LOAD:
+    ir_x86_load_instr(emitter, instr);
+    break;
+  case IR_OP_STORE:
+    ir_x86_store(emitter, instr);
+    break;
+  case IR_OP_GEP:
+    ir_x86_gep(emitter, instr);
+    break;
+  case IR_OP_ADD:
+  case IR_OP_SUB:
+  case IR_OP_MUL:
+  case IR_OP_SDIV:
+  case IR_OP_SREM:
+  case IR_OP_SHL:
+  case IR_OP_ASHR:
+  case IR_OP_LSHR:
+  case IR_OP_AND:
+  case IR_OP_OR:
+  case IR_OP_XOR:
+    ir_x86_binary(emitter, instr);
+    break;
+  case IR_OP_ICMP:
+    ir_x86_icmp(emitter, instr);
+    break;
+  case IR_OP_SEXT:
+  case IR_OP_ZEXT:
+  case IR_OP_TRUNC:
+  case IR_OP_PTRTOINT:
+  case IR_OP_INTTOPTR:
+  case IR_OP_BITCAST:
+    ir_x86_cast(emitter, instr);
+    break;
+  case IR_OP_CALL:
+    ir_x86_call(emitter, instr);
+    break;
+  case IR_OP_MEMSET:
+  case IR_OP_MEMCPY:
+    ir_x86_memory(emitter, instr);
+    break;
+  case IR_OP_BR:
+    ir_x86_jump(emitter, instr->parent, instr->blocks[0], 1);
+    break;
+  case IR_OP_CONDBR:
+    ir_x86_condbr(emitter, instr);
+    break;
+  case IR_OP_SWITCH:
+    ir_x86_switch(emitter, instr);
+    break;
+  case IR_OP_RET:
+    ir_x86_return(emitter, instr);
+    break;
+  }
+}
+
+/*
+ * Runs the allocator and gives every value its home: a register, a spill
+ * slot below %rbp, or for allocas the object itself.
+ */
+static int ir_x86_layout_frame(IrX86Emitter *emitter) {
+  IrFunction *function = emitter->function;
+  IrRegAllocTarget target;
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  long long size = 0;
+  size_t index = 0;
+
+  memset(&target, 0, sizeof(target));
+  target.parameter_registers = ir_x86_argument_registers;
+  target.parameter_register_count = IR_X86_REGISTER_ARGS;
+  if (emitter->options->allocate_registers) {
+    target.caller_saved = ir_x86_caller_saved;
+    target.caller_saved_count =
+      sizeof(ir_x86_caller_saved) / sizeof(ir_x86_caller_saved[0]);
+    target.callee_saved = ir_x86_callee_saved;
+    target.callee_saved_count =
+      sizeof(ir_x86_callee_saved) / sizeof(ir_x86_callee_saved[0]);
+  }
+
+  if (!ir_regalloc_run(function, &target, &emitter->allocation)) {
+    return 0;
+  }
+
+  emitter->locations = calloc(emitter->allocation.slot_count + 1,
+                              sizeof(*emitter->locations));
+  if (!emitter->locations) {
+    return 0;
+  }
+
+  for (index = 0; index < target.callee_saved_count; index++) {
+    int reg = target.callee_saved[index];
+
+    if (emitter->allocation.callee_saved_used & (1UL << reg)) {
+      size += 8;
+      emitter->callee_saved_offsets[reg] = -size;
+    }
+  }
+
+  for (index = 0; index < emitter->allocation.slot_count; index++) {
+    IrX86Location *location = &emitter->locations[index];
+    int reg = emitter->allocation.registers[index];
+
+    location->reg = IR_X86_NO_REGISTER;
+    if (reg >= 0) {
+      location->kind = IR_X86_LOCATION_REG;
+      location->reg = (IrX86Register)reg;
+    } else if (reg == IR_REGALLOC_SPILLED) {
+      location->kind = IR_X86_LOCATION_STACK;
+      if (index >= IR_X86_REGISTER_ARGS && index < function->param_count) {
+        /* Past the saved %rbp and the return address. */
+        location->offset =
+          16 + 8 * (long long)(index - IR_X86_REGISTER_ARGS);
+        continue;
+      }
+      size += 8;
+      location->offset = -size;
+    }
+  }
+
+  for (block = function->first_block; block; block = block->next) {
+    for (instr = block->first; instr; instr = instr->next) {
+      IrX86Location *location = NULL;
+
+      if (instr->opcode != IR_OP_ALLOCA) {
+        continue;
+      }
+
+      location =
+        &emitter->locations[ir_regalloc_slot(function, &instr->value)];
+      size = ir_x86_align(size + (long long)ir_type_size(instr->aux_type),
+                          (long long)ir_type_align(instr->aux_type));
+      location->kind = IR_X86_LOCATION_FRAME;
+      location->offset = -size;
+    }
+  }
+
+  emitter->frame_size = ir_x86_align(size, 16);
+  return 1;
+}
+
+static void ir_x86_prologue(IrX86Emitter *emitter) {
+  IrFunction *function = emitter->function;
+  size_t count = 0;
+  size_t index = 0;
+
+  ir_x86_op1(emitter, IR_X86_PUSH, 64, ir_x86_reg(IR_X86_RBP));
+  ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_reg(IR_X86_RSP),
+            ir_x86_reg(IR_X86_RBP));
+  if (emitter->frame_size > 0) {
+    ir_x86_op(emitter, IR_X86_SUB, 64, ir_x86_imm(emitter->frame_size),
+              ir_x86_reg(IR_X86_RSP));
+  }
+
+  for (index = 0; index < sizeof(ir_x86_callee_saved) / sizeof(int);
+       index++) {
+    int reg = ir_x86_callee_saved[index];
+
+    if (emitter->allocation.callee_saved_used & (1UL << reg)) {
+      ir_x86_op(emitter, IR_X86_MOV, 64, ir_x86_reg((IrX86Register)reg),
+                ir_x86_mem(IR_X86_RBP, emitter->callee_saved_offsets[reg]));
+    }
+  }
+
+  if (!ir_x86_reserve_moves(emitter, function->param_count + 1)) {
+    return;
+  }
+
+  /* Parameters move from where the ABI put them to their homes. */
+  for (index = 0; index < function->param_count; index++) {
+    IrX86Move *move = &emitter->moves[count];
+
+    move->dst = emitter->locations[index];
+    move->value = &function->params[index]->value;
+    move->done = 0;
+    if (index < IR_X86_REGISTER_ARGS) {
+      move->src.kind = IR_X86_LOCATION_REG;
+      move->src.reg = ir_x86_argument_registers[index];
+    } else if (move->dst.kind == IR_X86_LOCATION_REG) {
+      move->src.kind = IR_X86_LOCATION_STACK;
+      move->src.offset = 16 + 8 * (long long)(index - IR_X86_REGISTER_ARGS);
+    } else {
+      continue;
+    }
+    count++;
+  }
+  ir_x86_parallel_move(emitter, emitter->moves, count);
+}
+
+static void ir_x86_function_header(IrX86Emitter *emitter) {
+  FILE *out = emitter->out;
+  const IrFunction *function = emitter->function;
+
+  fprintf(out, "\n\t.text\n");
+  if (function->linkage != IR_LINKAGE_INTERNAL) {
+    fprintf(out, "\t.globl\t%s\n", function->name);
+  }
+  fprintf(out, "\t.p2align\t4\n");
+  fprintf(out, "\t.type\t%s, @function\n", function->name);
+  fprintf(out, "%s:\n", function->name);
+  if (emitter->options->allocate_registers) {
+    fprintf(out, "\t# regalloc: %zu intervals, %zu spilled, %zu copies "
+                 "coalesced\n",
+            emitter->allocation.interval_count,
+            emitter->allocation.spill_count,
+            emitter->allocation.coalesced_count);
+  }
+}
+
+/* Patches branch displacements and defines the function's symbol. */
+static void ir_x86_finish_object_function(IrX86Emitter *emitter,
+                                          size_t start) {
+  IrElfWriter *object = emitter->object;
+  const IrFunction *function = emitter->function;
+  size_t end = ir_elf_section_size(object, IR_ELF_TEXT);
+  size_t index = 0;
+
+  for (index = 0; index < emitter->fixup_count; index++) {
+    const IrX86Fixup *fixup = &emitter->fixups[index];
+    size_t target = fixup->edge >= 0 ? emitter->edge_offsets[fixup->edge]
+                                     : emitter->block_offsets[fixup->target
+                                                                ->index];
+
+    ir_elf_patch32(object, IR_ELF_TEXT, fixup->field,
+                   (long long)target - (long long)fixup->end);
+  }
+  emitter->fixup_count = 0;
+
+  ir_elf_define(object, ir_elf_symbol(object, function->name), IR_ELF_TEXT,
+                start, end - start, 1,
+                function->linkage == IR_LINKAGE_INTERNAL);
+}
+
+static int ir_x86_function(IrX86Emitter *emitter, IrFunction *function) {
+  FILE *out = emitter->out;
+  const IrBlock *block = NULL;
+  const IrInstr *instr = NULL;
+  IrDebugLoc loc = {0, 0};
+  size_t start = 0;
+  size_t lowered = 0;
+  int result = 0;
+
+  emitter->function = function;
+  emitter->failed = 0;
+  /* Only switches dense enough for a jump table are left. */
+  if (!ir_switch_lower_function(function, 1, &lowered) ||
+      !ir_x86_layout_frame(emitter)) {
+    goto cleanup;
+  }
+
+  if (emitter->object) {
+    emitter->block_offsets =
+      calloc(function->block_count + 1, sizeof(*emitter->block_offsets));
+    if (!emitter->block_offsets) {
+      goto cleanup;
+    }
+    ir_elf_align(emitter->object, IR_ELF_TEXT, 16, 0x90);
+    start = ir_elf_section_size(emitter->object, IR_ELF_TEXT);
+  } else {
+    ir_x86_function_header(emitter);
+  }
+  /* The prologue belongs to the line the function is defined on. */
+  emitter->loc.line = 0;
+  loc.line = function->line;
+  ir_x86_set_loc(emitter, loc);
+  ir_x86_prologue(emitter);
+
+  for (block = function->first_block; block; block = block->next) {
+    ir_x86_label(emitter, block, -1);
+    for (instr = block->first; instr; instr = instr->next) {
+      ir_x86_instr(emitter, instr);
+    }
+  }
+
+  if (emitter->object) {
+    if (!emitter->failed) {
+      ir_x86_finish_object_function(emitter, start);
+    }
+  } else {
+    fprintf(out, "\t.size\t%s, .-%s\n", function->name, function->name);
+  }
+  result = !emitter->failed;
+
+cleanup:
+  ir_regalloc_free(&emitter->allocation);
+  free(emitter->locations);
+  emitter->locations = NULL;
+  free(emitter->block_offsets);
+  emitter->block_offsets = NULL;
+  return result;
+}
+
+/*
+ * Writes value's bytes at the current position: zero runs as .zero,
+ * scalars by size, and the fields of a struct at their offsets.
+ */
+static void ir_x86_data(const IrValue *value, FILE *out) {
+  size_t size = ir_type_size(value->type);
+  size_t offset = 0;
+  size_t index = 0;
+
+  if (ir_value_is_zero(value)) {
+    fprintf(out, "\t.zero\t%zu\n", size);
+  } else if (value->kind == IR_VALUE_AGGREGATE) {
+    for (index = 0; index < value->element_count; index++) {
+      size_t field = value->type->kind == IR_TYPE_STRUCT
+                       ? ir_type_field_offset(value->type, index)
+                       : index * ir_type_size(value->type->element);
+
+      if (field > offset) {
+        fprintf(out, "\t.zero\t%zu\n", field - offset);
+      }
+      ir_x86_data(value->elements[index], out);
+      offset = field + ir_type_size(value->elements[index]->type);
+    }
+    if (size > offset) {
+      fprintf(out, "\t.zero\t%zu\n", size - offset);
+    }
+  } else if (value->kind == IR_VALUE_GLOBAL) {
+    fprintf(out, "\t.quad\t%s\n", value->global->name);
+  } else if (size == 1) {
+    fprintf(out, "\t.byte\t%lld\n", value->constant);
+  } else if (size == 2) {
+    fprintf(out, "\t.short\t%lld\n", value->constant);
+  } else if (size == 4) {
+    fprintf(out, "\t.long\t%lld\n", value->constant);
+  } else {
+    fprintf(out, "\t.quad\t%lld\n", value->constant);
+  }
+}
+
+static void ir_x86_global(const IrGlobal *global, FILE *out) {
+  const IrValue *initializer = global->initializer;
+  size_t size = ir_type_size(global->value_type);
+
+  if (global->is_constant) {
+    fprintf(out, "\n\t.section\t.rodata\n");
+  } else {
+    fprintf(out, "\n\t.%s\n", ir_value_is_zero(initializer) ? "bss" : "data");
+  }
+  if (global->linkage != IR_LINKAGE_INTERNAL) {
+    fprintf(out, "\t.globl\t%s\n", global->name);
+  }
+  fprintf(out, "\t.balign\t%zu\n", ir_type_align(global->value_type));
+  fprintf(out, "\t.type\t%s, @object\n", global->name);
+  fprintf(out, "\t.size\t%s, %zu\n", global->name, size);
+  fprintf(out, "%s:\n", global->name);
+  ir_x86_data(initializer, out);
+}
+
+/* As ir_x86_data, appending to section with relocations for addresses. */
+static void ir_x86_data_object(IrElfWriter *object, IrElfSection section,
+                               const IrValue *value) {
+  size_t size = ir_type_size(value->type);
+  size_t start = ir_elf_section_size(object, section);
+  size_t index = 0;
+  unsigned char bytes[8];
+
+  if (ir_value_is_zero(value)) {
+    ir_elf_append(object, section, NULL, size);
+  } else if (value->kind == IR_VALUE_AGGREGATE) {
+    for (index = 0; index < value->element_count; index++) {
+      size_t field = value->type->kind == IR_TYPE_STRUCT
+                       ? ir_type_field_offset(value->type, index)
+                       : index * ir_type_size(value->type->element);
+      size_t offset = ir_elf_section_size(object, section) - start;
+
+      if (field > offset) {
+        ir_elf_append(object, section, NULL, field - offset);
+      }
+      ir_x86_data_object(object, section, value->elements[index]);
+    }
+    if (start + size > ir_elf_section_size(object, section)) {
+      ir_elf_append(object, section, NULL,
+                    start + size - ir_elf_section_size(object, section));
+    }
+  } else if (value->kind == IR_VALUE_GLOBAL) {
+    ir_elf_append(object, section, NULL, 8);
+    ir_elf_relocate(object, section, start,
+                    ir_elf_symbol(object, value->global->name),
+                    IR_ELF_R_X86_64_64, 0);
+  } else {
+    for (index = 0; index < size && index < sizeof(bytes); index++) {
+      bytes[index] =
+        (unsigned char)((unsigned long long)value->constant >> (8 * index));
+    }
+    ir_elf_append(object, section, bytes, index);
+  }
+}
+
+static void ir_x86_global_object(IrElfWriter *object,
+                                 const IrGlobal *global) {
+  size_t size = ir_type_size(global->value_type);
+  IrElfSection section = IR_ELF_DATA;
+  size_t start = 0;
+
+  if (global->is_constant) {
+    section = IR_ELF_RODATA;
+  } else if (ir_value_is_zero(global->initializer)) {
+    section = IR_ELF_BSS;
+  }
+
+  ir_elf_align(object, section, ir_type_align(global->value_type), 0);
+  start = ir_elf_section_size(object, section);
+  ir_elf_define(object, ir_elf_symbol(object, global->name), section, start,
+                size, 0, global->linkage == IR_LINKAGE_INTERNAL);
+  ir_x86_data_object(object, section, global->initializer);
+}
+
+static int ir_x86_emit_module(IrX86Emitter *emitter, IrModule *module) {
+  size_t index = 0;
+  int result = 1;
+
+  for (index = 0; index < module->symbol_count && result; index++) {
+    const IrSymbol *symbol = &module->symbols[index];
+
+    if (symbol->kind == IR_SYMBOL_GLOBAL && emitter->object) {
+      ir_x86_global_object(emitter->object, symbol->global);
+    } else if (symbol->kind == IR_SYMBOL_GLOBAL) {
+      ir_x86_global(symbol->global, emitter->out);
+    } else if (!ir_function_is_declaration(symbol->function)) {
+      result = ir_x86_function(emitter, symbol->function);
+    }
+  }
+
+  free(emitter->moves);
+  free(emitter->edge_offsets);
+  free(emitter->fixups);
+  return result;
+}
+
+int ir_x86_emit(IrModule *module, const IrX86Options *options, FILE *out) {
+  IrX86Emitter emitter;
+
+  memset(&emitter, 0, sizeof(emitter));
+  emitter.out = out;
+  emitter.options = options;
+  emitter.debug_info = module->source_file != NULL;
+  fprintf(out, "\t.file\t\"%s\"\n", module->name);
+  if (emitter.debug_info) {
+    fprintf(out, "\t.file\t1 \"%s/%s\"\n", module->source_directory,
+            module->source_file);
+  }
+
+  if (!ir_x86_emit_module(&emitter, module)) {
+    return 0;
+  }
+
+  fprintf(out, "\n\t.section\t.note.GNU-stack,\"\",@progbits\n");
+  return ferror(out) ? 0 : 1;
+}
+
+int ir_x86_emit_object(IrModule *module, const IrX86Options *options,
+                       FILE *out) {
+  IrX86Emitter emitter;
+  IrElfWriter object;
+  int result = 0;
+
+  memset(&emitter, 0, sizeof(emitter));
+  ir_elf_init(&object, module->name);
+  emitter.out = out;
+  emitter.options = options;
+  emitter.object = &object;
+  emitter.debug_info = module->source_file != NULL;
+  ir_dwarf_lines_init(&emitter.lines);
+
+  result = ir_x86_emit_module(&emitter, module) &&
+           (!emitter.debug_info ||
+            ir_dwarf_write(&emitter.lines, module, &object)) &&
+           ir_elf_write(&object, out);
+  ir_dwarf_lines_free(&emitter.lines);
+  ir_elf_free(&object);
+  return result && !ferror(out);
+}
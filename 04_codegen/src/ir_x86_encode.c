@@ -0,0 +1,478 @@
+#include "ir_x86_encode.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Hardware condition codes in IrX86Condition order. */
+static const unsigned char ir_x86_condition_codes[] = {
+  0x4, 0x5, 0xc, 0xd, 0xe, 0xf, 0x2, 0x3, 0x6, 0x7,
+};
+
+/* The /digit of the group-1 ALU opcodes; the r/m,reg form is digit * 8. */
+static int ir_x86_alu_digit(IrX86Opcode opcode) {
+  switch (opcode) {
+  case IR_X86_ADD:
+    return 0;
+  case IR_X86_OR:
+    return 1;
+  case IR_X86_AND:
+    return 4;
+  case IR_X86_SUB:
+    return 5;
+  case IR_X86_XOR:
+    return 6;
+  default:
+    return 7;
+  }
+}
+
+static int ir_x86_fits_imm8(long long value) {
+  return value >= -128 && value <= 127;
+}
+
+static void ir_x86_byte(IrX86Encoding *encoding, unsigned value) {
+  encoding->bytes[encoding->length++] = (unsigned char)value;
+}
+
+static void ir_x86_immediate(IrX86Encoding *encoding, long long value,
+                             int bytes) {
+  int index = 0;
+
+  for (index = 0; index < bytes; index++) {
+    ir_x86_byte(encoding, (unsigned)((unsigned long long)value >> (8 * index)));
+  }
+}
+
+/* Byte registers 4-7 name spl-dil only with a REX prefix, ah-bh without. */
+static int ir_x86_needs_rex(IrX86Register reg, int is_byte) {
+  return is_byte && reg >= IR_X86_RSP && reg <= IR_X86_RDI;
+}
+
+/*
+ * Writes prefixes, opcode, ModRM, SIB, and displacement for an instruction
+ * whose ModRM reg field holds `reg` (a register or a /digit) and whose r/m
+ * operand is `rm`. Immediates follow from the caller.
+ */
+static void ir_x86_modrm(IrX86Encoding *encoding, int bits,
+                         const unsigned char *opcode, size_t opcode_length,
+                         int reg, int reg_is_byte, const IrX86Operand *rm,
+                         int rm_is_byte) {
+  unsigned rex = bits == 64 ? 0x48 : 0;
+  unsigned base = 0;
+  int mod = 0;
+  long long disp = rm->value;
+  size_t index = 0;
+
+  if (bits == 16) {
+    ir_x86_byte(encoding, 0x66);
+  }
+
+  if (reg >= 8) {
+    rex |= 0x44;
+  }
+  if (ir_x86_needs_rex((IrX86Register)reg, reg_is_byte)) {
+    rex |= 0x40;
+  }
+  if (rm->kind == IR_X86_OPERAND_REG) {
+    if (rm->reg >= 8) {
+      rex |= 0x41;
+    }
+    if (ir_x86_needs_rex(rm->reg, rm_is_byte)) {
+      rex |= 0x40;
+    }
+  } else if (rm->kind == IR_X86_OPERAND_MEM) {
+    if (rm->reg >= 8) {
+      rex |= 0x41;
+    }
+    if (rm->index != IR_X86_NO_REGISTER && rm->index >= 8) {
+      rex |= 0x42;
+    }
+  }
+  if (rex) {
+    ir_x86_byte(encoding, rex);
+  }
+
+  for (index = 0; index < opcode_length; index++) {
+    ir_x86_byte(encoding, opcode[index]);
+  }
+
+  if (rm->kind == IR_X86_OPERAND_REG) {
+    ir_x86_byte(encoding, 0xc0 | (reg & 7) << 3 | (rm->reg & 7));
+    return;
+  }
+
+  if (rm->kind == IR_X86_OPERAND_SYMBOL ||
+      rm->kind == IR_X86_OPERAND_LABEL) {
+    ir_x86_byte(encoding, (reg & 7) << 3 | 5);
+    encoding->pcrel_offset = encoding->length;
+    ir_x86_immediate(encoding, 0, 4);
+    return;
+  }
+
+  /* A base of rbp or r13 has no disp-less form; rsp and r12 need a SIB. */
+  base = rm->reg & 7;
+  if (disp == 0 && base != 5) {
+    mod = 0;
+  } else if (ir_x86_fits_imm8(disp)) {
+    mod = 1;
+  } else {
+    mod = 2;
+  }
+
+  if (rm->index != IR_X86_NO_REGISTER || base == 4) {
+    unsigned scale = rm->scale == 8 ? 3 : rm->scale == 4 ? 2
+                                        : rm->scale == 2 ? 1
+                                                         : 0;
+    unsigned sib_index =
+      rm->index != IR_X86_NO_REGISTER ? (unsigned)(rm->index & 7) : 4;
+
+    ir_x86_byte(encoding, (unsigned)mod << 6 | (reg & 7) << 3 | 4);
+    ir_x86_byte(encoding, scale << 6 | sib_index << 3 | base);
+  } else {
+    ir_x86_byte(encoding, (unsigned)mod << 6 | (reg & 7) << 3 | base);
+  }
+
+  if (mod == 1) {
+    ir_x86_immediate(encoding, disp, 1);
+  } else if (mod == 2) {
+    ir_x86_immediate(encoding, disp, 4);
+  }
+}
+
+static void ir_x86_modrm1(IrX86Encoding *encoding, int bits, unsigned opcode,
+                          int reg, int reg_is_byte, const IrX86Operand *rm) {
+  unsigned char byte = (unsigned char)opcode;
+
+  ir_x86_modrm(encoding, bits, &byte, 1, reg, reg_is_byte, rm, bits == 8);
+}
+
+static void ir_x86_modrm2(IrX86Encoding *encoding, int bits, unsigned opcode,
+                          int reg, const IrX86Operand *rm) {
+  unsigned char bytes[2] = {0x0f, (unsigned char)opcode};
+
+  ir_x86_modrm(encoding, bits, bytes, 2, reg, 0, rm, bits == 8);
+}
+
+/* Opcode for a register encoded in its low three bits, as in push %r12. */
+static void ir_x86_short_form(IrX86Encoding *encoding, int bits,
+                              unsigned opcode, IrX86Register reg) {
+  unsigned rex = bits == 64 ? 0x48 : 0;
+
+  if (bits == 16) {
+    ir_x86_byte(encoding, 0x66);
+  }
+  if (reg >= 8) {
+    rex |= 0x41;
+  }
+  if (ir_x86_needs_rex(reg, bits == 8)) {
+    rex |= 0x40;
+  }
+  if (rex) {
+    ir_x86_byte(encoding, rex);
+  }
+  ir_x86_byte(encoding, opcode + (reg & 7));
+}
+
+static int ir_x86_immediate_size(int bits) {
+  return bits == 8 ? 1 : bits == 16 ? 2 : 4;
+}
+
+static int ir_x86_encode_mov(const IrX86Instr *instr, IrX86Encoding *encoding) {
+  const IrX86Operand *src = &instr->src;
+  const IrX86Operand *dst = &instr->dst;
+  int bits = instr->bits;
+  int is_byte = bits == 8;
+
+  if (src->kind == IR_X86_OPERAND_IMM && dst->kind == IR_X86_OPERAND_REG) {
+    if (bits == 64 && (src->value < INT32_MIN || src->value > INT32_MAX)) {
+      ir_x86_short_form(encoding, 64, 0xb8, dst->reg);
+      ir_x86_immediate(encoding, src->value, 8);
+    } else if (bits == 64) {
+      ir_x86_modrm1(encoding, 64, 0xc7, 0, 0, dst);
+      ir_x86_immediate(encoding, src->value, 4);
+    } else {
+      ir_x86_short_form(encoding, bits, is_byte ? 0xb0 : 0xb8, dst->reg);
+      ir_x86_immediate(encoding, src->value, ir_x86_immediate_size(bits));
+    }
+    return 1;
+  }
+
+  if (src->kind == IR_X86_OPERAND_IMM) {
+    ir_x86_modrm1(encoding, bits, is_byte ? 0xc6 : 0xc7, 0, 0, dst);
+    ir_x86_immediate(encoding, src->value, ir_x86_immediate_size(bits));
+    return 1;
+  }
+
+  if (src->kind == IR_X86_OPERAND_REG) {
+    ir_x86_modrm1(encoding, bits, is_byte ? 0x88 : 0x89, src->reg, is_byte,
+                  dst);
+    return 1;
+  }
+
+  if (dst->kind != IR_X86_OPERAND_REG) {
+    return 0;
+  }
+  ir_x86_modrm1(encoding, bits, is_byte ? 0x8a : 0x8b, dst->reg, is_byte, src);
+  return 1;
+}
+
+static int ir_x86_encode_alu(const IrX86Instr *instr, IrX86Encoding *encoding) {
+  const IrX86Operand *src = &instr->src;
+  const IrX86Operand *dst = &instr->dst;
+  int bits = instr->bits;
+  int is_byte = bits == 8;
+  int digit = ir_x86_alu_digit(instr->opcode);
+
+  if (src->kind == IR_X86_OPERAND_IMM) {
+    if (is_byte) {
+      ir_x86_modrm1(encoding, bits, 0x80, digit, 0, dst);
+      ir_x86_immediate(encoding, src->value, 1);
+    } else if (ir_x86_fits_imm8(src->value)) {
+      ir_x86_modrm1(encoding, bits, 0x83, digit, 0, dst);
+      ir_x86_immediate(encoding, src->value, 1);
+    } else {
+      ir_x86_modrm1(encoding, bits, 0x81, digit, 0, dst);
+      ir_x86_immediate(encoding, src->value, ir_x86_immediate_size(bits));
+    }
+    return 1;
+  }
+
+  if (src->kind == IR_X86_OPERAND_REG) {
+    ir_x86_modrm1(encoding, bits, (unsigned)digit * 8 + (is_byte ? 0 : 1),
+                  src->reg, is_byte, dst);
+    return 1;
+  }
+
+  if (dst->kind != IR_X86_OPERAND_REG) {
+    return 0;
+  }
+  ir_x86_modrm1(encoding, bits, (unsigned)digit * 8 + (is_byte ? 2 : 3),
+                dst->reg, is_byte, src);
+  return 1;
+}
+
+static int ir_x86_encode_test(const IrX86Instr *instr,
+                              IrX86Encoding *encoding) {
+  int bits = instr->bits;
+  int is_byte = bits == 8;
+
+  if (instr->src.kind == IR_X86_OPERAND_IMM) {
+    ir_x86_modrm1(encoding, bits, is_byte ? 0xf6 : 0xf7, 0, 0, &instr->dst);
+    ir_x86_immediate(encoding, instr->src.value, ir_x86_immediate_size(bits));
+    return 1;
+  }
+
+  if (instr->src.kind != IR_X86_OPERAND_REG) {
+    return 0;
+  }
+  ir_x86_modrm1(encoding, bits, is_byte ? 0x84 : 0x85, instr->src.reg,
+                is_byte, &instr->dst);
+  return 1;
+}
+
+static int ir_x86_encode_imul(const IrX86Instr *instr,
+                              IrX86Encoding *encoding) {
+  const IrX86Operand *src = &instr->src;
+  const IrX86Operand *dst = &instr->dst;
+  int bits = instr->bits;
+
+  if (dst->kind != IR_X86_OPERAND_REG || bits == 8) {
+    return 0;
+  }
+
+  if (src->kind == IR_X86_OPERAND_IMM) {
+    int short_form = ir_x86_fits_imm8(src->value);
+
+    ir_x86_modrm1(encoding, bits, short_form ? 0x6b : 0x69, dst->reg, 0, dst);
+    ir_x86_immediate(encoding, src->value,
+                     short_form ? 1 : ir_x86_immediate_size(bits));
+    return 1;
+  }
+
+  ir_x86_modrm2(encoding, bits, 0xaf, dst->reg, src);
+  return 1;
+}
+
+static int ir_x86_encode_shift(const IrX86Instr *instr,
+                               IrX86Encoding *encoding) {
+  int bits = instr->bits;
+  int is_byte = bits == 8;
+  int digit = instr->opcode == IR_X86_SHL   ? 4
+              : instr->opcode == IR_X86_SHR ? 5
+                                            : 7;
+
+  if (instr->src.kind == IR_X86_OPERAND_IMM && instr->src.value == 1) {
+    ir_x86_modrm1(encoding, bits, is_byte ? 0xd0 : 0xd1, digit, 0,
+                  &instr->dst);
+    return 1;
+  }
+
+  if (instr->src.kind == IR_X86_OPERAND_IMM) {
+    ir_x86_modrm1(encoding, bits, is_byte ? 0xc0 : 0xc1, digit, 0,
+                  &instr->dst);
+    ir_x86_immediate(encoding, instr->src.value, 1);
+    return 1;
+  }
+
+  /* The count register is always %cl. */
+  if (instr->src.kind != IR_X86_OPERAND_REG || instr->src.reg != IR_X86_RCX) {
+    return 0;
+  }
+  ir_x86_modrm1(encoding, bits, is_byte ? 0xd2 : 0xd3, digit, 0, &instr->dst);
+  return 1;
+}
+
+static int ir_x86_encode_push(const IrX86Instr *instr,
+                              IrX86Encoding *encoding) {
+  const IrX86Operand *operand = &instr->dst;
+
+  switch (operand->kind) {
+  case IR_X86_OPERAND_REG:
+    ir_x86_short_form(encoding, 32, 0x50, operand->reg);
+    return 1;
+  case IR_X86_OPERAND_IMM:
+    if (ir_x86_fits_imm8(operand->value)) {
+      ir_x86_byte(encoding, 0x6a);
+      ir_x86_immediate(encoding, operand->value, 1);
+    } else {
+      ir_x86_byte(encoding, 0x68);
+      ir_x86_immediate(encoding, operand->value, 4);
+    }
+    return 1;
+  default:
+    /* push defaults to 64 bits; no REX.W. */
+    ir_x86_modrm1(encoding, 32, 0xff, 6, 0, operand);
+    return 1;
+  }
+}
+
+/* Writes an opcode followed by a zero rel32 for the caller to fill in. */
+static void ir_x86_relative(IrX86Encoding *encoding,
+                            const unsigned char *opcode,
+                            size_t opcode_length) {
+  size_t index = 0;
+
+  for (index = 0; index < opcode_length; index++) {
+    ir_x86_byte(encoding, opcode[index]);
+  }
+  encoding->pcrel_offset = encoding->length;
+  ir_x86_immediate(encoding, 0, 4);
+}
+
+int ir_x86_encode(const IrX86Instr *instr, IrX86Encoding *encoding) {
+  unsigned char opcode[2];
+  int bits = instr->bits == 1 ? 8 : instr->bits;
+  IrX86Instr normalized = *instr;
+
+  memset(encoding, 0, sizeof(*encoding));
+  normalized.bits = bits;
+
+  switch (instr->opcode) {
+  case IR_X86_MOV:
+    return ir_x86_encode_mov(&normalized, encoding);
+  case IR_X86_MOVZX:
+    /* movzbl and movzwl: the destination is always 32 bits. */
+    if (instr->dst.kind != IR_X86_OPERAND_REG) {
+      return 0;
+    }
+    opcode[0] = 0x0f;
+    opcode[1] = bits == 8 ? 0xb6 : 0xb7;
+    ir_x86_modrm(encoding, 32, opcode, 2, instr->dst.reg, 0, &instr->src,
+                 bits == 8);
+    return 1;
+  case IR_X86_MOVSX:
+    /* movsbq, movswq, and movslq: the destination is always 64 bits. */
+    if (instr->dst.kind != IR_X86_OPERAND_REG) {
+      return 0;
+    }
+    if (bits == 32) {
+      ir_x86_modrm1(encoding, 64, 0x63, instr->dst.reg, 0, &instr->src);
+    } else {
+      opcode[0] = 0x0f;
+      opcode[1] = bits == 8 ? 0xbe : 0xbf;
+      ir_x86_modrm(encoding, 64, opcode, 2, instr->dst.reg, 0, &instr->src,
+                   bits == 8);
+    }
+    return 1;
+  case IR_X86_LEA:
+    if (instr->dst.kind != IR_X86_OPERAND_REG) {
+      return 0;
+    }
+    ir_x86_modrm1(encoding, 64, 0x8d, instr->dst.reg, 0, &instr->src);
+    return 1;
+  case IR_X86_ADD:
+  case IR_X86_SUB:
+  case IR_X86_AND:
+  case IR_X86_OR:
+  case IR_X86_XOR:
+  case IR_X86_CMP:
+    return ir_x86_encode_alu(&normalized, encoding);
+  case IR_X86_TEST:
+    return ir_x86_encode_test(&normalized, encoding);
+  case IR_X86_IMUL:
+    return ir_x86_encode_imul(&normalized, encoding);
+  case IR_X86_SHL:
+  case IR_X86_SAR:
+  case IR_X86_SHR:
+    return ir_x86_encode_shift(&normalized, encoding);
+  case IR_X86_NEG:
+    ir_x86_modrm1(encoding, bits, bits == 8 ? 0xf6 : 0xf7, 3, 0, &instr->dst);
+    return 1;
+  case IR_X86_CQO:
+    if (bits == 64) {
+      ir_x86_byte(encoding, 0x48);
+    }
+    ir_x86_byte(encoding, 0x99);
+    return 1;
+  case IR_X86_IDIV:
+    ir_x86_modrm1(encoding, bits, bits == 8 ? 0xf6 : 0xf7, 7, 0, &instr->dst);
+    return 1;
+  case IR_X86_SETCC:
+    ir_x86_modrm2(encoding, 8, 0x90 + ir_x86_condition_codes[instr->condition],
+                  0, &instr->dst);
+    return 1;
+  case IR_X86_JCC:
+    opcode[0] = 0x0f;
+    opcode[1] = (unsigned char)(0x80 +
+                                ir_x86_condition_codes[instr->condition]);
+    ir_x86_relative(encoding, opcode, 2);
+    return 1;
+  case IR_X86_JMP:
+    if (instr->dst.kind == IR_X86_OPERAND_REG) {
+      ir_x86_modrm1(encoding, 32, 0xff, 4, 0, &instr->dst);
+      return 1;
+    }
+    opcode[0] = 0xe9;
+    ir_x86_relative(encoding, opcode, 1);
+    return 1;
+  case IR_X86_CALL:
+    if (instr->dst.kind == IR_X86_OPERAND_REG) {
+      ir_x86_modrm1(encoding, 32, 0xff, 2, 0, &instr->dst);
+      return 1;
+    }
+    opcode[0] = 0xe8;
+    ir_x86_relative(encoding, opcode, 1);
+    return 1;
+  case IR_X86_PUSH:
+    return ir_x86_encode_push(instr, encoding);
+  case IR_X86_POP:
+    if (instr->dst.kind != IR_X86_OPERAND_REG) {
+      return 0;
+    }
+    ir_x86_short_form(encoding, 32, 0x58, instr->dst.reg);
+    return 1;
+  case IR_X86_LEAVE:
+    ir_x86_byte(encoding, 0xc9);
+    return 1;
+  case IR_X86_RET:
+    ir_x86_byte(encoding, 0xc3);
+    return 1;
+  case IR_X86_REP_STOS:
+  case IR_X86_REP_MOVS:
+    ir_x86_byte(encoding, 0xf3);
+    ir_x86_byte(encoding, instr->opcode == IR_X86_REP_STOS ? 0xaa : 0xa4);
+    return 1;
+  }
+
+  return 0;
+}
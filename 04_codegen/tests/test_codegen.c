@@ -1,4 +1,6 @@
 #include "codegen.h"
+#include "ir.h"
+#include "ir_jit.h"
 #include "test_util.h"
 
 #include <stdio.h>
@@ -13,22 +15,54 @@
   X(generate_defaults, "generate default initializers")                        \
   X(generate_static_storage, "generate static storage")                        \
   X(generate_pointer_globals, "generate pointer globals")                      \
+  X(generate_initializers, "generate brace initializers")                      \
   X(generate_array_ops, "generate array operations")                           \
+  X(generate_compound_assign, "generate compound assignment")                  \
   X(generate_pointer_return, "generate pointer return")                        \
   X(generate_typedef_casts, "generate typedef casts")                          \
   X(generate_struct_definitions, "generate struct definitions")                \
+  X(generate_tbaa, "generate type-based alias metadata")                       \
+  X(generate_debug_info, "generate DWARF line locations")                      \
   X(generate_control_flow_function, "generate control flow function")          \
   X(generate_loop_control, "generate loop control")                            \
   X(generate_function_call, "generate function call")                          \
   X(generate_extern_calls, "generate extern calls")                            \
   X(generate_arithmetic_function, "generate arithmetic function")              \
+  X(generate_strength_reduction, "generate strength-reduced arithmetic")       \
   X(generate_logical_function, "generate logical operators")                   \
+  X(generate_comparisons, "generate comparison operators")                     \
+  X(generate_poison_flags, "generate poison flags")                            \
+  X(generate_without_poison_flags, "generate without poison flags")            \
+  X(generate_optimized_linkage, "generate optimized linkage")                  \
+  X(generate_pic_linkage, "keep external definitions preemptible for PIC")     \
   X(generate_sizeof, "generate sizeof expressions")                            \
   X(generate_sizeof_struct_custom, "generate sizeof for custom struct")        \
   X(check_invalid_syntax, "reject invalid syntax")                             \
   X(check_const_assignment, "reject const assignment")                         \
   X(check_const_field_assignment, "reject const field assignment")             \
-  X(generate_enum_definitions, "generate enum definitions")
+  X(generate_enum_definitions, "generate enum definitions")                    \
+  X(generate_ir_dump, "generate IR dump after passes")                         \
+  X(generate_inline, "inline cheap calls bottom-up")                           \
+  X(generate_function_attrs, "infer function attributes bottom-up")            \
+  X(generate_prototypes, "merge prototypes into their definitions")           \
+  X(generate_tail_calls, "generate loops and tail calls")                      \
+  X(generate_loop_opt, "hoist invariants and step pointers in loops")          \
+  X(generate_loop_idiom, "replace fill and copy loops with memset and memcpy") \
+  X(generate_scalar_opt, "fold constants, redundant loads, and dead stores")   \
+  X(generate_switch, "lower switches into compare trees")                      \
+  X(generate_profile_counters, "instrument blocks and branches for profiling") \
+  X(generate_profile_use, "annotate branch weights from a profile")            \
+  X(generate_instrument_functions, "call the runtime on entry and return")     \
+  X(generate_instrument_tail_calls, "instrumented returns end tail calls")     \
+  X(generate_x86_asm, "generate x86-64 assembly")                              \
+  X(generate_x86_asm_spill, "generate x86-64 assembly without regalloc")       \
+  X(generate_x86_object, "generate x86-64 ELF object")                         \
+  X(run_bytecode, "run bytecode in the VM")                                    \
+  X(run_bytecode_superinstructions, "fuse and quicken bytecode")               \
+  X(run_bytecode_jit, "run hot bytecode through the JIT")                      \
+  X(check_unknown_pass, "reject unknown IR pass")                              \
+  X(check_case_division, "reject case labels that divide by zero")             \
+  X(verify_missing_terminator, "verifier rejects block without terminator")
 
 static char *read_file(const char *path, size_t *size_out) {
   FILE *file = fopen(path, "rb");
@@ -109,7 +143,8 @@ static char *build_output_path(const char *name) {
   return path;
 }
 
-static int run_codegen_fixture(const CodegenFixture *fixture) {
+static int run_codegen_fixture_with_options(const CodegenFixture *fixture,
+                                            const CodegenOptions *options) {
   Codegen codegen;
   char *source = NULL;
   char *expected = NULL;
@@ -138,6 +173,9 @@ static int run_codegen_fixture(const CodegenFixture *fixture) {
   }
 
   codegen_init(&codegen, source);
+  if (options) {
+    codegen.options = *options;
+  }
 
   if (!codegen_emit(&codegen, output_path)) {
     failf("expected codegen success");
@@ -173,6 +211,10 @@ cleanup:
   return passed;
 }
 
+static int run_codegen_fixture(const CodegenFixture *fixture) {
+  return run_codegen_fixture_with_options(fixture, NULL);
+}
+
 TEST(generate_simple_module, "generate simple module") {
   CodegenFixture fixture = {"codegen_simple", "tests/testdata/simple_module.c",
                             "tests/testdata/simple_module.ll"};
@@ -210,6 +252,14 @@ TEST(generate_pointer_globals, "generate pointer globals") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_initializers, "generate brace initializers") {
+  CodegenFixture fixture = {"codegen_initializers",
+                            "tests/testdata/initializers.c",
+                            "tests/testdata/initializers.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
 TEST(generate_array_ops, "generate array operations") {
   CodegenFixture fixture = {"codegen_array_ops", "tests/testdata/array_ops.c",
                             "tests/testdata/array_ops.ll"};
@@ -217,6 +267,14 @@ TEST(generate_array_ops, "generate array operations") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_compound_assign, "generate compound assignment") {
+  CodegenFixture fixture = {"codegen_compound_assign",
+                            "tests/testdata/compound_assign.c",
+                            "tests/testdata/compound_assign.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
 TEST(generate_pointer_return, "generate pointer return") {
   CodegenFixture fixture = {"codegen_pointer_return",
                             "tests/testdata/pointer_return.c",
@@ -240,6 +298,36 @@ TEST(generate_struct_definitions, "generate struct definitions") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_tbaa, "generate type-based alias metadata") {
+  CodegenFixture fixture = {"codegen_tbaa", "tests/testdata/tbaa.c",
+                            "tests/testdata/tbaa.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
+TEST(generate_debug_info, "generate DWARF line locations") {
+  CodegenFixture fixture = {"codegen_debug_info", "tests/testdata/debug_info.c",
+                            "tests/testdata/debug_info.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.debug_info = 1;
+  options.source_name = fixture.input_path;
+  if (!run_codegen_fixture_with_options(&fixture, &options)) {
+    return 0;
+  }
+
+  /* Inlining moves square's locations into sum; llc must still take them. */
+  if (system("opt -O2 build/codegen_debug_info.ll"
+             " -o build/codegen_debug_info.bc &&"
+             " llc -O2 build/codegen_debug_info.bc"
+             " -o build/codegen_debug_info.s") != 0) {
+    failf("expected opt -O2 and llc -O2 to accept the debug info");
+    return 0;
+  }
+  return 1;
+}
+
 TEST(generate_control_flow_function, "generate control flow function") {
   CodegenFixture fixture = {"codegen_control_flow",
                             "tests/testdata/control_flow.c",
@@ -280,6 +368,14 @@ TEST(generate_arithmetic_function, "generate arithmetic function") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_strength_reduction, "generate strength-reduced arithmetic") {
+  CodegenFixture fixture = {"codegen_strength_reduction",
+                            "tests/testdata/strength_reduction.c",
+                            "tests/testdata/strength_reduction.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
 TEST(generate_logical_function, "generate logical operators") {
   CodegenFixture fixture = {"codegen_logical", "tests/testdata/logical_ops.c",
                             "tests/testdata/logical_ops.ll"};
@@ -287,6 +383,51 @@ TEST(generate_logical_function, "generate logical operators") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_comparisons, "generate comparison operators") {
+  CodegenFixture fixture = {"codegen_comparisons", "tests/testdata/comparisons.c",
+                            "tests/testdata/comparisons.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
+TEST(generate_poison_flags, "generate poison flags") {
+  CodegenFixture fixture = {"codegen_poison_flags",
+                            "tests/testdata/poison_flags.c",
+                            "tests/testdata/poison_flags.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
+TEST(generate_without_poison_flags, "generate without poison flags") {
+  CodegenFixture fixture = {"codegen_no_poison_flags",
+                            "tests/testdata/poison_flags.c",
+                            "tests/testdata/poison_flags_disabled.ll"};
+  CodegenOptions options = {0};
+
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_optimized_linkage, "generate optimized linkage") {
+  CodegenFixture fixture = {"codegen_linkage", "tests/testdata/linkage.c",
+                            "tests/testdata/linkage.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.optimize_linkage = 1;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_pic_linkage, "keep external definitions preemptible for PIC") {
+  CodegenFixture fixture = {"codegen_linkage_pic", "tests/testdata/linkage.c",
+                            "tests/testdata/linkage_pic.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.optimize_linkage = 1;
+  options.pic = 1;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
 TEST(generate_sizeof, "generate sizeof expressions") {
   CodegenFixture fixture = {"codegen_sizeof", "tests/testdata/sizeof_ops.c",
                             "tests/testdata/sizeof_ops.ll"};
@@ -369,6 +510,478 @@ TEST(generate_enum_definitions, "generate enum definitions") {
   return run_codegen_fixture(&fixture);
 }
 
+TEST(generate_ir_dump, "generate IR dump after passes") {
+  CodegenFixture fixture = {"codegen_ir_dump", "tests/testdata/ir_dump.c",
+                            "tests/testdata/ir_dump.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "unreachable,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_inline, "inline cheap calls bottom-up") {
+  CodegenFixture fixture = {"codegen_inline", "tests/testdata/inline.c",
+                            "tests/testdata/inline.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "inline,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_function_attrs, "infer function attributes bottom-up") {
+  CodegenFixture fixture = {"codegen_function_attrs",
+                            "tests/testdata/function_attrs.c",
+                            "tests/testdata/function_attrs.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.passes = "mem2reg,functionattrs,licm,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_prototypes, "merge prototypes into their definitions") {
+  CodegenFixture fixture = {"codegen_prototypes", "tests/testdata/prototypes.c",
+                            "tests/testdata/prototypes.ll"};
+
+  return run_codegen_fixture(&fixture);
+}
+
+TEST(generate_tail_calls, "generate loops and tail calls") {
+  CodegenFixture fixture = {"codegen_tail_calls", "tests/testdata/tail_calls.c",
+                            "tests/testdata/tail_calls.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.passes = "tailcall";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_loop_opt, "hoist invariants and step pointers in loops") {
+  CodegenFixture fixture = {"codegen_loop_opt", "tests/testdata/loop_opt.c",
+                            "tests/testdata/loop_opt.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "mem2reg,licm,ivsr,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_loop_idiom,
+     "replace fill and copy loops with memset and memcpy") {
+  CodegenFixture fixture = {"codegen_loop_idiom", "tests/testdata/loop_idiom.c",
+                            "tests/testdata/loop_idiom.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "mem2reg,licm,loopidiom,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_scalar_opt,
+     "fold constants, redundant loads, and dead stores") {
+  CodegenFixture fixture = {"codegen_scalar_opt", "tests/testdata/scalar_opt.c",
+                            "tests/testdata/scalar_opt.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "mem2reg,gvn,sccp,dse,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_switch, "lower switches into compare trees") {
+  CodegenFixture fixture = {"codegen_switch", "tests/testdata/switch.c",
+                            "tests/testdata/switch.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.passes = "mem2reg,lowerswitch,dce";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_profile_counters,
+     "instrument blocks and branches for profiling") {
+  CodegenFixture fixture = {"codegen_profile_counters",
+                            "tests/testdata/profile.c",
+                            "tests/testdata/profile_generate.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.profile_generate = 1;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_profile_use, "annotate branch weights from a profile") {
+  CodegenFixture fixture = {"codegen_profile_use", "tests/testdata/profile.c",
+                            "tests/testdata/profile_use.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.profile_use = "tests/testdata/profile.profile";
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_instrument_functions, "call the runtime on entry and return") {
+  CodegenFixture fixture = {"codegen_instrument_functions",
+                            "tests/testdata/instrument_functions.c",
+                            "tests/testdata/instrument_functions.ir"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_IR;
+  options.instrument_functions = 1;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_instrument_tail_calls, "instrumented returns end tail calls") {
+  CodegenFixture fixture = {"codegen_instrument_tail_calls",
+                            "tests/testdata/tail_calls.c",
+                            "tests/testdata/instrument_tail_calls.ll"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.passes = "tailcall";
+  options.instrument_functions = 1;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_x86_asm, "generate x86-64 assembly") {
+  CodegenFixture fixture = {"codegen_x86_asm", "tests/testdata/x86_asm.c",
+                            "tests/testdata/x86_asm.s"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_X86_64_ASM;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_x86_asm_spill, "generate x86-64 assembly without regalloc") {
+  CodegenFixture fixture = {"codegen_x86_asm_spill",
+                            "tests/testdata/x86_asm.c",
+                            "tests/testdata/x86_asm_spill.s"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_X86_64_ASM;
+  options.allocate_registers = 0;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+TEST(generate_x86_object, "generate x86-64 ELF object") {
+  CodegenFixture fixture = {"codegen_x86_object", "tests/testdata/x86_asm.c",
+                            "tests/testdata/x86_asm.o"};
+  CodegenOptions options;
+
+  codegen_options_init(&options);
+  options.target = CODEGEN_TARGET_X86_64_OBJ;
+  return run_codegen_fixture_with_options(&fixture, &options);
+}
+
+static int call_bytecode(IrVm *vm, const char *name, IrVmWord a, IrVmWord b,
+                         IrVmWord *result) {
+  IrVmWord args[2];
+  size_t function = 0;
+
+  args[0] = a;
+  args[1] = b;
+  return ir_vm_find_function(vm->program, name, &function) &&
+         ir_vm_call(vm, function, args,
+                    vm->program->functions[function].param_count, result);
+}
+
+TEST(run_bytecode, "run bytecode in the VM") {
+  const char *source =
+    "int total = 3;\n"
+    "int *total_ptr = &total;\n"
+    "int fact(int n) { if (n < 2) { return 1; } return n * fact(n - 1); }\n"
+    "int sum_to(int n) {\n"
+    "  int s = 0;\n"
+    "  for (int i = 1; i <= n; i = i + 1) { s = s + i; }\n"
+    "  *total_ptr = s;\n"
+    "  return total;\n"
+    "}\n"
+    "int both(int a, int b) { return a > 0 && b > 0; }\n";
+  const char *path = "build/test_codegen_bytecode.bcvm";
+  Codegen codegen;
+  IrVmProgram program;
+  IrVm vm;
+  IrVmWord result = 0;
+  char *image = NULL;
+  size_t size = 0;
+  int passed = 0;
+
+  codegen_init(&codegen, source);
+  codegen.options.target = CODEGEN_TARGET_BYTECODE;
+  ASSERT_TRUE(codegen_emit(&codegen, path), "expected bytecode image");
+
+  /* Run what was read back from the image, not the compiler's output. */
+  image = read_file(path, &size);
+  ASSERT_TRUE(image != NULL, "expected image content");
+  if (!ir_vm_read_image(&program, (const unsigned char *)image, size, NULL)) {
+    free(image);
+    failf("expected image to load");
+    return 0;
+  }
+  free(image);
+
+  if (!ir_vm_init(&vm, &program, NULL, NULL)) {
+    failf("expected VM init: %s", ir_vm_error(&vm));
+  } else if (!call_bytecode(&vm, "fact", 10, 0, &result) ||
+             result != 3628800) {
+    failf("expected fact(10) = 3628800, got %lld", result);
+  } else if (!call_bytecode(&vm, "fact", 13, 0, &result) ||
+             result != 1932053504) {
+    failf("expected fact(13) to wrap to 1932053504, got %lld", result);
+  } else if (!call_bytecode(&vm, "sum_to", 100, 0, &result) ||
+             result != 5050) {
+    failf("expected sum_to(100) = 5050, got %lld", result);
+  } else if (!call_bytecode(&vm, "both", 1, 0, &result) || result != 0 ||
+             !call_bytecode(&vm, "both", 1, 2, &result) || result != 1) {
+    failf("expected both(1, 0) = 0 and both(1, 2) = 1");
+  } else {
+    passed = 1;
+  }
+
+  ir_vm_free(&vm);
+  ir_vm_program_free(&program);
+  return passed;
+}
+
+static const char *const count_multiples_source =
+  "int count_multiples(int n, int k) {\n"
+  "  int flags[64];\n"
+  "  int count = 0;\n"
+  "  for (int i = 0; i < n; i = i + 1) { flags[i] = i % k; }\n"
+  "  for (int j = 0; j < n; j = j + 1) {\n"
+  "    if (!flags[j]) { count = count + 1; }\n"
+  "  }\n"
+  "  return count;\n"
+  "}\n";
+
+/* Runs count_multiples(60, 7); returns the dispatch count, or 0. */
+static unsigned long long profile_count_multiples(int superinstructions,
+                                                  int *quickened) {
+  Codegen codegen;
+  IrVmProgram program;
+  IrVm vm;
+  IrVmWord result = 0;
+  unsigned long long dispatches = 0;
+  size_t offset = 0;
+
+  codegen_init(&codegen, count_multiples_source);
+  codegen.options.superinstructions = superinstructions;
+  if (!codegen_compile_bytecode(&codegen, &program)) {
+    return 0;
+  }
+
+  if (ir_vm_init(&vm, &program, NULL, NULL)) {
+    vm.profile = ir_vm_profile_create();
+    if (vm.profile && call_bytecode(&vm, "count_multiples", 60, 7, &result) &&
+        result == 9) {
+      dispatches = ir_vm_profile_dispatches(vm.profile);
+    }
+    ir_vm_profile_free(vm.profile);
+
+    /* Without the profile the generic instructions get quickened. */
+    vm.profile = NULL;
+    if (!call_bytecode(&vm, "count_multiples", 60, 7, &result) ||
+        result != 9) {
+      dispatches = 0;
+    }
+    for (offset = 0; offset < program.functions[0].code_size;
+         offset += ir_vm_instr_size(&vm.code[0][offset])) {
+      *quickened |= vm.code[0][offset] == IR_VM_OP_SREM_I32;
+    }
+  }
+
+  ir_vm_free(&vm);
+  ir_vm_program_free(&program);
+  return dispatches;
+}
+
+TEST(run_bytecode_superinstructions, "fuse and quicken bytecode") {
+  int quickened = 0;
+  unsigned long long plain = profile_count_multiples(0, &quickened);
+  unsigned long long fused = profile_count_multiples(1, &quickened);
+
+  ASSERT_TRUE(plain != 0 && fused != 0, "expected count_multiples = 9");
+  ASSERT_TRUEF(fused * 4 < plain * 3,
+               "expected a quarter fewer dispatches, got %llu for %llu",
+               fused, plain);
+  ASSERT_TRUE(quickened, "expected srem to be quickened");
+  return 1;
+}
+
+static const char *const jit_source =
+  "int fact(int n) { if (n < 2) { return 1; } return n * fact(n - 1); }\n"
+  "int mix(int n, int k) {\n"
+  "  int s = 0;\n"
+  "  for (int i = 0; i < n; i = i + 1) {\n"
+  "    s = s + (i * k) / (i % 5 + 1) - (i * 8) % 11 + fact(i % 6);\n"
+  "  }\n"
+  "  return s;\n"
+  "}\n"
+  "int ratio(int a, int b) { return a / b; }\n"
+  "int deep(int n) { return deep(n + 1) + 1; }\n";
+
+static const struct {
+  const char *name;
+  IrVmWord a;
+  IrVmWord b;
+} jit_calls[] = {
+  {"fact", 13, 0},
+  {"mix", 5000, 3},
+  {"mix", 5000, -70001},
+  {"ratio", -7, 2},
+  {"ratio", -2147483647 - 1, -1},
+};
+
+#define JIT_CALL_COUNT (sizeof(jit_calls) / sizeof(jit_calls[0]))
+
+/*
+ * Runs jit_calls and the two failing calls with the JIT at threshold;
+ * returns 1 if the errors matched the interpreter's.
+ */
+static int run_jit_calls(const IrVmProgram *program, unsigned threshold,
+                         IrVmWord *results, int *compiled) {
+  IrVm vm;
+  size_t index = 0;
+  int passed = 1;
+
+  if (!ir_vm_init(&vm, program, NULL, NULL)) {
+    ir_vm_free(&vm);
+    return 0;
+  }
+  vm.jit_threshold = threshold;
+
+  for (index = 0; index < JIT_CALL_COUNT && passed; index++) {
+    passed = call_bytecode(&vm, jit_calls[index].name, jit_calls[index].a,
+                           jit_calls[index].b, &results[index]);
+  }
+  passed = passed && !call_bytecode(&vm, "ratio", 1, 0, &results[index]) &&
+           test_error_contains(ir_vm_error(&vm), "division by zero") &&
+           !call_bytecode(&vm, "deep", 0, 0, &results[index]) &&
+           test_error_contains(ir_vm_error(&vm), "stack overflow");
+
+  *compiled = vm.jit && ir_vm_find_function(program, "mix", &index) &&
+              vm.jit->functions[index].entry;
+  ir_vm_free(&vm);
+  return passed;
+}
+
+TEST(run_bytecode_jit, "run hot bytecode through the JIT") {
+  IrVmWord expected[JIT_CALL_COUNT];
+  IrVmWord results[JIT_CALL_COUNT];
+  /* 1 compiles on the first call; 50 inside mix's first loop. */
+  static const unsigned thresholds[] = {1, 50};
+  Codegen codegen;
+  IrVmProgram program;
+  size_t index = 0;
+  size_t call = 0;
+  int compiled = 0;
+  int passed = 1;
+
+  codegen_init(&codegen, jit_source);
+  ASSERT_TRUE(codegen_compile_bytecode(&codegen, &program),
+              "expected bytecode");
+
+  if (!run_jit_calls(&program, 0, expected, &compiled)) {
+    failf("expected the interpreter to run the calls");
+    passed = 0;
+  }
+  for (index = 0; index < 2 && passed; index++) {
+    if (!run_jit_calls(&program, thresholds[index], results, &compiled)) {
+      failf("expected the same errors at threshold %u", thresholds[index]);
+      passed = 0;
+    }
+    for (call = 0; call < JIT_CALL_COUNT && passed; call++) {
+      if (results[call] != expected[call]) {
+        failf("expected %s = %lld at threshold %u, got %lld",
+              jit_calls[call].name, expected[call], thresholds[index],
+              results[call]);
+        passed = 0;
+      }
+    }
+#if defined(__x86_64__) && defined(__unix__)
+    if (passed && !compiled) {
+      failf("expected mix to be compiled at threshold %u", thresholds[index]);
+      passed = 0;
+    }
+#endif
+  }
+
+  ir_vm_program_free(&program);
+  return passed;
+}
+
+TEST(check_unknown_pass, "reject unknown IR pass") {
+  Codegen codegen;
+
+  codegen_init(&codegen, "int main() { return 0; }");
+  codegen.options.passes = "dce,nope";
+
+  ASSERT_TRUE(!codegen_emit(&codegen, "build/test_codegen_unknown_pass.ll"),
+              "expected codegen failure for unknown pass");
+  ASSERT_TRUE(test_error_contains(codegen_error(&codegen), "unknown pass"),
+              "expected 'unknown pass' error message");
+  return 1;
+}
+
+TEST(check_case_division, "reject case labels that divide by zero") {
+  Codegen codegen;
+
+  codegen_init(&codegen, "int f(int n) {\n"
+                         "  switch (n) {\n"
+                         "  case 4 / (2 - 2):\n"
+                         "    return 1;\n"
+                         "  }\n"
+                         "  return 0;\n"
+                         "}\n");
+
+  ASSERT_TRUE(!codegen_emit(&codegen, "build/test_codegen_case_division.ll"),
+              "expected codegen failure for division by zero");
+  ASSERT_TRUE(test_error_contains(codegen_error(&codegen), "divides by zero"),
+              "expected 'divides by zero' error message");
+  return 1;
+}
+
+TEST(verify_missing_terminator, "verifier rejects block without terminator") {
+  IrModule *module = ir_module_create("basecc");
+  IrFunction *function = NULL;
+  IrBuilder builder;
+  const char *message = NULL;
+  int passed = 0;
+
+  if (!module) {
+    failf("expected module");
+    return 0;
+  }
+
+  function = ir_module_add_function(module, "f", 1, ir_type_int(module, 32));
+  ir_builder_init(&builder, function);
+  ir_builder_set_block(&builder, ir_block_create(function, "entry"));
+  ir_build_alloca(&builder, ir_type_int(module, 32));
+
+  if (ir_verify_module(module, &message)) {
+    failf("expected verifier failure");
+  } else if (!test_error_contains(message, "without terminator")) {
+    failf("expected 'without terminator' message, got '%s'", message);
+  } else {
+    passed = 1;
+  }
+
+  ir_module_free(module);
+  return passed;
+}
+
 #define TEST_ENTRY(name, description) {description, test_##name},
 
 static const TestCase tests[] = {TEST_LIST(TEST_ENTRY)};
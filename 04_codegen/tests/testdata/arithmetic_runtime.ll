@@ -1,62 +1,69 @@
 ; ModuleID = 'basecc'
 source_filename = "basecc"
 
-define i32 @add() {
+define noundef i32 @add() {
 entry:
-  %t0 = add i32 3, 4
+  %t0 = add nsw i32 3, 4
   ret i32 %t0
 }
-define i32 @sub() {
+define noundef i32 @sub() {
 entry:
-  %t0 = sub i32 10, 2
+  %t0 = sub nsw i32 10, 2
   ret i32 %t0
 }
-define i32 @mul() {
+define noundef i32 @mul() {
 entry:
-  %t0 = mul i32 6, 7
+  %t0 = mul nsw i32 6, 7
   ret i32 %t0
 }
-define i32 @divide() {
+define noundef i32 @divide() {
 entry:
   %t0 = sdiv i32 20, 4
   ret i32 %t0
 }
-define i32 @mod() {
+define noundef i32 @mod() {
 entry:
   %t0 = srem i32 20, 6
   ret i32 %t0
 }
-define i32 @mixed() {
+define noundef i32 @mixed() {
 entry:
-  %t0 = add i32 1, 2
-  %t1 = mul i32 %t0, 3
+  %t0 = add nsw i32 1, 2
+  %t1 = mul nsw i32 %t0, 3
   %t2 = sdiv i32 4, 2
-  %t3 = srem i32 %t2, 3
-  %t4 = sub i32 %t1, %t3
-  ret i32 %t4
+  %t3 = sext i32 %t2 to i64
+  %t4 = mul i64 %t3, 1431655766
+  %t5 = ashr i64 %t4, 32
+  %t6 = trunc i64 %t5 to i32
+  %t7 = lshr i32 %t6, 31
+  %t8 = add i32 %t6, %t7
+  %t9 = mul i32 %t8, 3
+  %t10 = sub i32 %t2, %t9
+  %t11 = sub nsw i32 %t1, %t10
+  ret i32 %t11
 }
-define i32 @unary() {
+define noundef i32 @unary() {
 entry:
-  %t0 = add i32 1, 2
-  %t1 = sub i32 0, %t0
-  %t2 = add i32 %t1, 3
+  %t0 = add nsw i32 1, 2
+  %t1 = sub nsw i32 0, %t0
+  %t2 = add nsw i32 %t1, 3
   ret i32 %t2
 }
-define i32 @nested_parens() {
+define noundef i32 @nested_parens() {
 entry:
-  %t0 = add i32 1, 2
-  %t1 = sub i32 3, 4
-  %t2 = mul i32 %t0, %t1
-  %t3 = add i32 5, 6
+  %t0 = add nsw i32 1, 2
+  %t1 = sub nsw i32 3, 4
+  %t2 = mul nsw i32 %t0, %t1
+  %t3 = add nsw i32 5, 6
   %t4 = sdiv i32 %t2, %t3
   ret i32 %t4
 }
-define i32 @triple_nested() {
+define noundef i32 @triple_nested() {
 entry:
-  %t0 = add i32 1, 2
-  %t1 = add i32 %t0, 3
-  %t2 = sub i32 5, 6
-  %t3 = add i32 4, %t2
-  %t4 = mul i32 %t1, %t3
+  %t0 = add nsw i32 1, 2
+  %t1 = add nsw i32 %t0, 3
+  %t2 = sub nsw i32 5, 6
+  %t3 = add nsw i32 4, %t2
+  %t4 = mul nsw i32 %t1, %t3
   ret i32 %t4
 }
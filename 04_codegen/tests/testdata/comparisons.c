@@ -0,0 +1,40 @@
+int less(int a, int b) {
+  return a < b;
+}
+
+int ordered(int a, int b, int c) {
+  return a <= b == b >= c;
+}
+
+int differs(char a, int b) {
+  return a != b;
+}
+
+int is_null(int *p) {
+  return p == 0;
+}
+
+int before(int *p, int *q) {
+  if (p < q) {
+    return 1;
+  }
+  return 0;
+}
+
+int count_up(int n) {
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    total = total + i;
+  }
+
+  while (total > 100) {
+    total = total - 100;
+  }
+
+  return total;
+}
+
+int in_range(int x) {
+  return x >= 0 && x < 10;
+}
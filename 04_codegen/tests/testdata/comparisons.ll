@@ -0,0 +1,95 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @less(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = icmp slt i32 %a, %b
+  %t1 = zext i1 %t0 to i32
+  ret i32 %t1
+}
+define noundef i32 @ordered(i32 noundef %a, i32 noundef %b, i32 noundef %c) {
+entry:
+  %t0 = icmp sle i32 %a, %b
+  %t1 = zext i1 %t0 to i32
+  %t2 = icmp sge i32 %b, %c
+  %t3 = zext i1 %t2 to i32
+  %t4 = icmp eq i32 %t1, %t3
+  %t5 = zext i1 %t4 to i32
+  ret i32 %t5
+}
+define noundef i32 @differs(i8 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = sext i8 %a to i32
+  %t1 = icmp ne i32 %t0, %b
+  %t2 = zext i1 %t1 to i32
+  ret i32 %t2
+}
+define noundef i32 @is_null(i32* noundef %p) {
+entry:
+  %t0 = icmp eq i32* %p, null
+  %t1 = zext i1 %t0 to i32
+  ret i32 %t1
+}
+define noundef i32 @before(i32* noundef %p, i32* noundef %q) {
+entry:
+  %t0 = icmp ult i32* %p, %q
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  ret i32 0
+}
+define noundef i32 @count_up(i32 noundef %n) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !3
+  %t3 = icmp slt i32 %t2, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t0, !tbaa !3
+  %t5 = load i32, i32* %t1, !tbaa !3
+  %t6 = add nsw i32 %t4, %t5
+  store i32 %t6, i32* %t0, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t7 = load i32, i32* %t1, !tbaa !3
+  %t8 = add nsw i32 %t7, 1
+  store i32 %t8, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  br label %while.cond4
+while.cond4:
+  %t9 = load i32, i32* %t0, !tbaa !3
+  %t10 = icmp sgt i32 %t9, 100
+  br i1 %t10, label %while.body5, label %while.end6
+while.body5:
+  %t11 = load i32, i32* %t0, !tbaa !3
+  %t12 = sub nsw i32 %t11, 100
+  store i32 %t12, i32* %t0, !tbaa !3
+  br label %while.cond4
+while.end6:
+  %t13 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t13
+}
+define noundef i32 @in_range(i32 noundef %x) {
+entry:
+  %t0 = icmp sge i32 %x, 0
+  br i1 %t0, label %logic.rhs0, label %logic.end1
+logic.rhs0:
+  %t1 = icmp slt i32 %x, 10
+  br label %logic.end1
+logic.end1:
+  %t2 = phi i1 [0, %entry], [%t1, %logic.rhs0]
+  %t3 = zext i1 %t2 to i32
+  ret i32 %t3
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
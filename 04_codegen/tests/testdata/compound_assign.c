@@ -0,0 +1,14 @@
+int totals[4];
+char *cursor;
+
+int accumulate(int row, int value) {
+  int count = 0;
+  short scale = 3;
+  totals[row + 1] += value;
+  totals[row] *= 2;
+  scale -= value;
+  count++;
+  ++count;
+  cursor++;
+  return count-- + --scale;
+}
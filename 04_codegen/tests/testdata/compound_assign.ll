@@ -0,0 +1,58 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+@totals = global [4 x i32] zeroinitializer
+@cursor = global i8* null
+define noundef i32 @accumulate(i32 noundef %row, i32 noundef %value) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i16
+  %t2 = trunc i32 3 to i16
+  store i16 %t2, i16* %t1, !tbaa !5
+  %t3 = getelementptr inbounds [4 x i32], [4 x i32]* @totals, i32 0, i32 0
+  %t4 = add nsw i32 %row, 1
+  %t5 = getelementptr inbounds i32, i32* %t3, i32 %t4
+  %t6 = load i32, i32* %t5, !tbaa !3
+  %t7 = add nsw i32 %t6, %value
+  store i32 %t7, i32* %t5, !tbaa !3
+  %t8 = getelementptr inbounds [4 x i32], [4 x i32]* @totals, i32 0, i32 0
+  %t9 = getelementptr inbounds i32, i32* %t8, i32 %row
+  %t10 = load i32, i32* %t9, !tbaa !3
+  %t11 = shl nsw i32 %t10, 1
+  store i32 %t11, i32* %t9, !tbaa !3
+  %t12 = load i16, i16* %t1, !tbaa !5
+  %t13 = sext i16 %t12 to i32
+  %t14 = sub nsw i32 %t13, %value
+  %t15 = trunc i32 %t14 to i16
+  store i16 %t15, i16* %t1, !tbaa !5
+  %t16 = load i32, i32* %t0, !tbaa !3
+  %t17 = add nsw i32 %t16, 1
+  store i32 %t17, i32* %t0, !tbaa !3
+  %t18 = load i32, i32* %t0, !tbaa !3
+  %t19 = add nsw i32 %t18, 1
+  store i32 %t19, i32* %t0, !tbaa !3
+  %t20 = load i8*, i8** @cursor, !tbaa !7
+  %t21 = getelementptr inbounds i8, i8* %t20, i32 1
+  store i8* %t21, i8** @cursor, !tbaa !7
+  %t22 = load i32, i32* %t0, !tbaa !3
+  %t23 = sub nsw i32 %t22, 1
+  store i32 %t23, i32* %t0, !tbaa !3
+  %t24 = load i16, i16* %t1, !tbaa !5
+  %t25 = sext i16 %t24 to i32
+  %t26 = sub nsw i32 %t25, 1
+  %t27 = trunc i32 %t26 to i16
+  store i16 %t27, i16* %t1, !tbaa !5
+  %t28 = sext i16 %t27 to i32
+  %t29 = add nsw i32 %t22, %t28
+  ret i32 %t29
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"short", !1, i64 0}
+!5 = !{!4, !4, i64 0}
+!6 = !{!"any pointer", !1, i64 0}
+!7 = !{!6, !6, i64 0}
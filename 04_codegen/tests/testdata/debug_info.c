@@ -0,0 +1,20 @@
+static int square(int x) {
+  return x * x;
+}
+
+int sum(int n) {
+  int total = 0;
+  int i = 0;
+  for (i = 0; i < n; i++) {
+    total += square(i);
+  }
+  return total;
+}
+
+static int twice(int x) {
+  return x * 2;
+}
+
+int call_twice(int x) {
+  return twice(x);
+}
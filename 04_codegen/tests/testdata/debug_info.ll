@@ -0,0 +1,71 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define internal noundef i32 @square(i32 noundef %x) !dbg !2 {
+entry:
+  %t0 = mul nsw i32 %x, %x, !dbg !3
+  ret i32 %t0, !dbg !3
+}
+define noundef i32 @sum(i32 noundef %n) !dbg !4 {
+entry:
+  %t0 = alloca i32, !dbg !5
+  store i32 0, i32* %t0, !tbaa !9, !dbg !5
+  %t1 = alloca i32, !dbg !10
+  store i32 0, i32* %t1, !tbaa !9, !dbg !10
+  store i32 0, i32* %t1, !tbaa !9, !dbg !11
+  br label %for.cond0, !dbg !11
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !9, !dbg !11
+  %t3 = icmp slt i32 %t2, %n, !dbg !11
+  br i1 %t3, label %for.body1, label %for.end3, !dbg !11
+for.body1:
+  %t4 = load i32, i32* %t1, !tbaa !9, !dbg !12
+  %t5 = call i32 @square(i32 %t4), !dbg !12
+  %t6 = load i32, i32* %t0, !tbaa !9, !dbg !12
+  %t7 = add nsw i32 %t6, %t5, !dbg !12
+  store i32 %t7, i32* %t0, !tbaa !9, !dbg !12
+  br label %for.inc2, !dbg !12
+for.inc2:
+  %t8 = load i32, i32* %t1, !tbaa !9, !dbg !13
+  %t9 = add nsw i32 %t8, 1, !dbg !13
+  store i32 %t9, i32* %t1, !tbaa !9, !dbg !13
+  br label %for.cond0, !dbg !13
+for.end3:
+  %t10 = load i32, i32* %t0, !tbaa !9, !dbg !14
+  ret i32 %t10, !dbg !14
+}
+define internal noundef i32 @twice(i32 noundef %x) !dbg !15 {
+entry:
+  %t0 = shl nsw i32 %x, 1, !dbg !16
+  ret i32 %t0, !dbg !16
+}
+define noundef i32 @call_twice(i32 noundef %x) !dbg !17 {
+entry:
+  %t0 = call i32 @twice(i32 %x), !dbg !18
+  ret i32 %t0, !dbg !18
+}
+
+!llvm.dbg.cu = !{!1}
+!llvm.module.flags = !{!19, !20}
+
+!0 = !DIFile(filename: "debug_info.c", directory: "tests/testdata")
+!1 = distinct !DICompileUnit(language: DW_LANG_C99, file: !0, producer: "basecc", isOptimized: false, runtimeVersion: 0, emissionKind: LineTablesOnly)
+!2 = distinct !DISubprogram(name: "square", scope: !0, file: !0, line: 1, type: !DISubroutineType(types: !{}), scopeLine: 1, spFlags: DISPFlagDefinition | DISPFlagLocalToUnit, unit: !1)
+!3 = !DILocation(line: 2, column: 3, scope: !2)
+!4 = distinct !DISubprogram(name: "sum", scope: !0, file: !0, line: 5, type: !DISubroutineType(types: !{}), scopeLine: 5, spFlags: DISPFlagDefinition, unit: !1)
+!5 = !DILocation(line: 6, column: 7, scope: !4)
+!6 = !{!"Simple C/C++ TBAA"}
+!7 = !{!"omnipotent char", !6, i64 0}
+!8 = !{!"int", !7, i64 0}
+!9 = !{!8, !8, i64 0}
+!10 = !DILocation(line: 7, column: 7, scope: !4)
+!11 = !DILocation(line: 8, column: 8, scope: !4)
+!12 = !DILocation(line: 9, column: 11, scope: !4)
+!13 = !DILocation(line: 8, column: 23, scope: !4)
+!14 = !DILocation(line: 11, column: 3, scope: !4)
+!15 = distinct !DISubprogram(name: "twice", scope: !0, file: !0, line: 14, type: !DISubroutineType(types: !{}), scopeLine: 14, spFlags: DISPFlagDefinition | DISPFlagLocalToUnit, unit: !1)
+!16 = !DILocation(line: 15, column: 3, scope: !15)
+!17 = distinct !DISubprogram(name: "call_twice", scope: !0, file: !0, line: 18, type: !DISubroutineType(types: !{}), scopeLine: 18, spFlags: DISPFlagDefinition, unit: !1)
+!18 = !DILocation(line: 19, column: 3, scope: !17)
+!19 = !{i32 7, !"Dwarf Version", i32 4}
+!20 = !{i32 2, !"Debug Info Version", i32 3}
@@ -0,0 +1,88 @@
+extern int extern_value();
+
+int total = 0;
+int limit = 10;
+
+int square(int x) {
+  return x * x;
+}
+
+int sum_squares(int n) {
+  int result = 0;
+  int index = 0;
+
+  for (index = 0; index < n; index = index + 1) {
+    result = result + square(index);
+  }
+  return result;
+}
+
+int read_limit() {
+  return limit;
+}
+
+int first(int *values) {
+  return values[0];
+}
+
+int clear(int *values, int count) {
+  int index = 0;
+
+  for (index = 0; index < count; index = index + 1) {
+    values[index] = 0;
+  }
+  return count;
+}
+
+int *identity(int *pointer) {
+  return pointer;
+}
+
+int bump() {
+  total = total + 1;
+  return total;
+}
+
+int factorial(int n) {
+  if (n <= 1) {
+    return 1;
+  }
+  return n * factorial(n - 1);
+}
+
+extern int is_even(int n);
+
+int is_odd(int n) {
+  if (n == 0) {
+    return 0;
+  }
+  return is_even(n - 1);
+}
+
+int is_even(int n) {
+  if (n == 0) {
+    return 1;
+  }
+  return is_odd(n - 1);
+}
+
+int calls_out() {
+  return extern_value();
+}
+
+int unused_pure(int x) {
+  int copy[1] = {x};
+  int unused = square(x) + read_limit();
+
+  return first(copy);
+}
+
+int hoisted(int n) {
+  int result = 0;
+  int index = 0;
+
+  for (index = 0; index < n; index = index + 1) {
+    result = result + limit + square(index);
+  }
+  return result;
+}
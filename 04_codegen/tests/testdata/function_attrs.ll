@@ -0,0 +1,145 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+declare noundef i32 @extern_value()
+@total = global i32 0
+@limit = global i32 10
+define noundef i32 @square(i32 noundef %x) nounwind willreturn norecurse readnone {
+entry:
+  %t0 = mul nsw i32 %x, %x
+  ret i32 %t0
+}
+define noundef i32 @sum_squares(i32 noundef %n) nounwind norecurse readnone {
+entry:
+  br label %for.cond0
+for.cond0:
+  %t12 = phi i32 [0, %entry], [%t9, %for.inc2]
+  %t11 = phi i32 [0, %entry], [%t7, %for.inc2]
+  %t3 = icmp slt i32 %t12, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t6 = call i32 @square(i32 %t12)
+  %t7 = add nsw i32 %t11, %t6
+  br label %for.inc2
+for.inc2:
+  %t9 = add nsw i32 %t12, 1
+  br label %for.cond0
+for.end3:
+  ret i32 %t11
+}
+define noundef i32 @read_limit() nounwind willreturn norecurse readonly {
+entry:
+  %t0 = load i32, i32* @limit, !tbaa !3
+  ret i32 %t0
+}
+define noundef i32 @first(i32* nocapture readonly noundef %values) nounwind willreturn norecurse readonly argmemonly {
+entry:
+  %t0 = getelementptr inbounds i32, i32* %values, i32 0
+  %t1 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t1
+}
+define noundef i32 @clear(i32* nocapture noundef %values, i32 noundef %count) nounwind norecurse argmemonly {
+entry:
+  br label %for.cond0
+for.cond0:
+  %t7 = phi i32 [0, %entry], [%t6, %for.inc2]
+  %t2 = icmp slt i32 %t7, %count
+  br i1 %t2, label %for.body1, label %for.end3
+for.body1:
+  %t4 = getelementptr inbounds i32, i32* %values, i32 %t7
+  store i32 0, i32* %t4, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t6 = add nsw i32 %t7, 1
+  br label %for.cond0
+for.end3:
+  ret i32 %count
+}
+define noundef i32* @identity(i32* noundef %pointer) nounwind willreturn norecurse readnone {
+entry:
+  ret i32* %pointer
+}
+define noundef i32 @bump() nounwind willreturn norecurse {
+entry:
+  %t0 = load i32, i32* @total, !tbaa !3
+  %t1 = add nsw i32 %t0, 1
+  store i32 %t1, i32* @total, !tbaa !3
+  %t2 = load i32, i32* @total, !tbaa !3
+  ret i32 %t2
+}
+define noundef i32 @factorial(i32 noundef %n) nounwind readnone {
+entry:
+  %t0 = icmp sle i32 %n, 1
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = call i32 @factorial(i32 %t1)
+  %t3 = mul nsw i32 %n, %t2
+  ret i32 %t3
+}
+define noundef i32 @is_odd(i32 noundef %n) nounwind readnone {
+entry:
+  %t0 = icmp eq i32 %n, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 0
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = call i32 @is_even(i32 %t1)
+  ret i32 %t2
+}
+define noundef i32 @is_even(i32 noundef %n) nounwind readnone {
+entry:
+  %t0 = icmp eq i32 %n, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = call i32 @is_odd(i32 %t1)
+  ret i32 %t2
+}
+define noundef i32 @calls_out() nounwind {
+entry:
+  %t0 = call i32 @extern_value()
+  ret i32 %t0
+}
+define noundef i32 @unused_pure(i32 noundef %x) nounwind willreturn norecurse readonly {
+entry:
+  %t0 = alloca [1 x i32]
+  %t1 = bitcast [1 x i32]* %t0 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t1, i8 0, i64 4, i1 false)
+  %t2 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  store i32 %x, i32* %t2, !tbaa !3
+  %t7 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  %t8 = call i32 @first(i32* %t7)
+  ret i32 %t8
+}
+define noundef i32 @hoisted(i32 noundef %n) nounwind norecurse readonly {
+entry:
+  %t5 = load i32, i32* @limit, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t14 = phi i32 [0, %entry], [%t11, %for.inc2]
+  %t13 = phi i32 [0, %entry], [%t9, %for.inc2]
+  %t3 = icmp slt i32 %t14, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t6 = add nsw i32 %t13, %t5
+  %t8 = call i32 @square(i32 %t14)
+  %t9 = add nsw i32 %t6, %t8
+  br label %for.inc2
+for.inc2:
+  %t11 = add nsw i32 %t14, 1
+  br label %for.cond0
+for.end3:
+  ret i32 %t13
+}
+declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,27 @@
+struct Point {
+  int x;
+  int y;
+};
+
+enum Color { RED, GREEN = 4, BLUE };
+
+int global_value = 5;
+int squares[4] = {0, 1, 4, 9};
+const short primes[] = {2, 3, 5, 7, 11};
+char padded[4] = {1, 2};
+int zeros[3] = {0, 0};
+int *pointers[2] = {&global_value, 0};
+struct Point origin = {3, -4};
+struct Point corners[2] = {{1, 2}, {3, 4},};
+int colors[3] = {BLUE, RED, GREEN};
+
+int lookup(int index) {
+  static const int table[4] = {10, 20, 30, 40};
+  int local[4] = {1, 2, 3, 4};
+  int cleared[8] = {0};
+  struct Point point = {index, 7};
+  int mixed[3] = {index, 0, index + 1};
+
+  return table[index] + local[index] + cleared[index] + point.y +
+         mixed[2];
+}
@@ -0,0 +1,71 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Point = type { i32, i32 }
+
+@global_value = global i32 5
+@squares = global [4 x i32] [i32 0, i32 1, i32 4, i32 9]
+@primes = global [5 x i16] [i16 2, i16 3, i16 5, i16 7, i16 11]
+@padded = global [4 x i8] [i8 1, i8 2, i8 0, i8 0]
+@zeros = global [3 x i32] zeroinitializer
+@pointers = global [2 x i32*] [i32* @global_value, i32* null]
+@origin = global %struct.Point { i32 3, i32 -4 }
+@corners = global [2 x %struct.Point] [%struct.Point { i32 1, i32 2 }, %struct.Point { i32 3, i32 4 }]
+@colors = global [3 x i32] [i32 5, i32 0, i32 4]
+@.static.lookup.0.table = internal global [4 x i32] [i32 10, i32 20, i32 30, i32 40]
+@.const.lookup.1.local = internal unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4]
+
+define noundef i32 @lookup(i32 noundef %index) {
+entry:
+  %t0 = alloca [4 x i32]
+  %t1 = bitcast [4 x i32]* %t0 to i8*
+  %t2 = bitcast [4 x i32]* @.const.lookup.1.local to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %t1, i8* %t2, i64 16, i1 false)
+  %t3 = alloca [8 x i32]
+  %t4 = bitcast [8 x i32]* %t3 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t4, i8 0, i64 32, i1 false)
+  %t5 = alloca %struct.Point
+  %t6 = bitcast %struct.Point* %t5 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t6, i8 0, i64 8, i1 false)
+  %t7 = getelementptr inbounds %struct.Point, %struct.Point* %t5, i32 0, i32 0
+  store i32 %index, i32* %t7, !tbaa !4
+  %t8 = getelementptr inbounds %struct.Point, %struct.Point* %t5, i32 0, i32 1
+  store i32 7, i32* %t8, !tbaa !5
+  %t9 = alloca [3 x i32]
+  %t10 = bitcast [3 x i32]* %t9 to i8*
+  call void @llvm.memset.p0i8.i64(i8* %t10, i8 0, i64 12, i1 false)
+  %t11 = getelementptr inbounds [3 x i32], [3 x i32]* %t9, i32 0, i32 0
+  store i32 %index, i32* %t11, !tbaa !6
+  %t12 = getelementptr inbounds [3 x i32], [3 x i32]* %t9, i32 0, i32 2
+  %t13 = add nsw i32 %index, 1
+  store i32 %t13, i32* %t12, !tbaa !6
+  %t14 = getelementptr inbounds [4 x i32], [4 x i32]* @.static.lookup.0.table, i32 0, i32 0
+  %t15 = getelementptr inbounds i32, i32* %t14, i32 %index
+  %t16 = load i32, i32* %t15, !tbaa !6
+  %t17 = getelementptr inbounds [4 x i32], [4 x i32]* %t0, i32 0, i32 0
+  %t18 = getelementptr inbounds i32, i32* %t17, i32 %index
+  %t19 = load i32, i32* %t18, !tbaa !6
+  %t20 = add nsw i32 %t16, %t19
+  %t21 = getelementptr inbounds [8 x i32], [8 x i32]* %t3, i32 0, i32 0
+  %t22 = getelementptr inbounds i32, i32* %t21, i32 %index
+  %t23 = load i32, i32* %t22, !tbaa !6
+  %t24 = add nsw i32 %t20, %t23
+  %t25 = getelementptr inbounds %struct.Point, %struct.Point* %t5, i32 0, i32 1
+  %t26 = load i32, i32* %t25, !tbaa !5
+  %t27 = add nsw i32 %t24, %t26
+  %t28 = getelementptr inbounds [3 x i32], [3 x i32]* %t9, i32 0, i32 0
+  %t29 = getelementptr inbounds i32, i32* %t28, i32 2
+  %t30 = load i32, i32* %t29, !tbaa !6
+  %t31 = add nsw i32 %t27, %t30
+  ret i32 %t31
+}
+declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* noalias nocapture writeonly, i8* noalias nocapture readonly, i64, i1 immarg)
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!"Point", !2, i64 0, !2, i64 4}
+!4 = !{!3, !2, i64 0}
+!5 = !{!3, !2, i64 4}
+!6 = !{!2, !2, i64 0}
@@ -0,0 +1,31 @@
+int clamp(int value, int limit) {
+  if (value > limit) {
+    return limit;
+  }
+  return value;
+}
+
+int countdown(int n) {
+  if (n <= 0) {
+    return 0;
+  }
+  return countdown(n - 1);
+}
+
+int steps(int n) {
+  int left = n;
+  int count = 0;
+  while (left > 0) {
+    left = left - 1;
+    count = count + 1;
+  }
+  return count;
+}
+
+int sum_clamped(int n) {
+  int total = 0;
+  for (int i = 0; i < n; i = i + 1) {
+    total = total + clamp(i, 10);
+  }
+  return total + countdown(n) + steps(n);
+}
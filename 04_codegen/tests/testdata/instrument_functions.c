@@ -0,0 +1,10 @@
+int clamp(int value, int limit) {
+  if (value > limit) {
+    return limit;
+  }
+  return value;
+}
+
+int scale(int value) {
+  return clamp(value * 2, 100);
+}
@@ -0,0 +1,121 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+declare noundef i32 @report(i32 noundef)
+declare i64 @__basecc_function_enter(i64*, i8*)
+declare void @__basecc_function_exit(i64*, i64)
+define noundef i32 @gcd(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t5 = getelementptr inbounds [4 x i8], [4 x i8]* @__basecc_fname_gcd, i32 0, i32 0
+  %t6 = call i64 @__basecc_function_enter(i64* @__basecc_fslot_gcd, i8* %t5)
+  br label %tailrecurse
+tailrecurse:
+  %t3 = phi i32 [%a, %entry], [%t4, %if.end1]
+  %t4 = phi i32 [%b, %entry], [%t1, %if.end1]
+  %t0 = icmp ne i32 %t4, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  call void @__basecc_function_exit(i64* @__basecc_fslot_gcd, i64 %t6)
+  ret i32 %t3
+if.end1:
+  %t1 = srem i32 %t3, %t4
+  br label %tailrecurse
+}
+define noundef i32 @gcd_reported(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t2 = getelementptr inbounds [13 x i8], [13 x i8]* @__basecc_fname_gcd_reported, i32 0, i32 0
+  %t3 = call i64 @__basecc_function_enter(i64* @__basecc_fslot_gcd_reported, i8* %t2)
+  %t0 = call i32 @gcd(i32 %a, i32 %b)
+  %t1 = call i32 @report(i32 %t0)
+  call void @__basecc_function_exit(i64* @__basecc_fslot_gcd_reported, i64 %t3)
+  ret i32 %t1
+}
+define noundef i32 @gcd_swapped(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t1 = getelementptr inbounds [12 x i8], [12 x i8]* @__basecc_fname_gcd_swapped, i32 0, i32 0
+  %t2 = call i64 @__basecc_function_enter(i64* @__basecc_fslot_gcd_swapped, i8* %t1)
+  %t0 = call i32 @gcd(i32 %b, i32 %a)
+  call void @__basecc_function_exit(i64* @__basecc_fslot_gcd_swapped, i64 %t2)
+  ret i32 %t0
+}
+define noundef i32 @fill(i32* noundef %slot, i32 noundef %depth) {
+entry:
+  %t8 = getelementptr inbounds [5 x i8], [5 x i8]* @__basecc_fname_fill, i32 0, i32 0
+  %t9 = call i64 @__basecc_function_enter(i64* @__basecc_fslot_fill, i8* %t8)
+  %t0 = alloca [1 x i32]
+  %t1 = icmp ne i32 %depth, 0
+  br i1 %t1, label %if.end1, label %if.then0
+if.then0:
+  %t2 = load i32, i32* %slot, !tbaa !3
+  call void @__basecc_function_exit(i64* @__basecc_fslot_fill, i64 %t9)
+  ret i32 %t2
+if.end1:
+  %t3 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  %t4 = getelementptr inbounds i32, i32* %t3, i32 0
+  store i32 %depth, i32* %t4, !tbaa !3
+  %t5 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  %t6 = sub nsw i32 %depth, 1
+  %t7 = call i32 @fill(i32* %t5, i32 %t6)
+  call void @__basecc_function_exit(i64* @__basecc_fslot_fill, i64 %t9)
+  ret i32 %t7
+}
+define noundef i32 @walk(i32 noundef %n, i32 noundef %acc) {
+entry:
+  %t31 = getelementptr inbounds [5 x i8], [5 x i8]* @__basecc_fname_walk, i32 0, i32 0
+  %t32 = call i64 @__basecc_function_enter(i64* @__basecc_fslot_walk, i8* %t31)
+  %t0 = alloca i32
+  %t11 = alloca i32
+  br label %tailrecurse
+tailrecurse:
+  %t29 = phi i32 [%n, %entry], [%t24, %if.end1]
+  %t30 = phi i32 [%acc, %entry], [%t27, %if.end1]
+  %t1 = sext i32 %t29 to i64
+  %t2 = mul i64 %t1, -1840700269
+  %t3 = ashr i64 %t2, 32
+  %t4 = trunc i64 %t3 to i32
+  %t5 = add i32 %t4, %t29
+  %t6 = ashr i32 %t5, 2
+  %t7 = lshr i32 %t6, 31
+  %t8 = add i32 %t6, %t7
+  %t9 = mul i32 %t8, 7
+  %t10 = sub i32 %t29, %t9
+  store i32 %t10, i32* %t0, !tbaa !3
+  %t12 = sext i32 %t30 to i64
+  %t13 = mul i64 %t12, -2043174237
+  %t14 = ashr i64 %t13, 32
+  %t15 = trunc i64 %t14 to i32
+  %t16 = add i32 %t15, %t30
+  %t17 = ashr i32 %t16, 19
+  %t18 = lshr i32 %t17, 31
+  %t19 = add i32 %t17, %t18
+  %t20 = mul i32 %t19, 1000003
+  %t21 = sub i32 %t30, %t20
+  store i32 %t21, i32* %t11, !tbaa !3
+  %t22 = icmp ne i32 %t29, 0
+  br i1 %t22, label %if.end1, label %if.then0
+if.then0:
+  %t23 = load i32, i32* %t11, !tbaa !3
+  call void @__basecc_function_exit(i64* @__basecc_fslot_walk, i64 %t32)
+  ret i32 %t23
+if.end1:
+  %t24 = sub nsw i32 %t29, 1
+  %t25 = load i32, i32* %t11, !tbaa !3
+  %t26 = load i32, i32* %t0, !tbaa !3
+  %t27 = add nsw i32 %t25, %t26
+  br label %tailrecurse
+}
+@__basecc_fname_gcd = internal unnamed_addr constant [4 x i8] [i8 103, i8 99, i8 100, i8 0]
+@__basecc_fslot_gcd = internal global i64 zeroinitializer
+@__basecc_fname_gcd_reported = internal unnamed_addr constant [13 x i8] [i8 103, i8 99, i8 100, i8 95, i8 114, i8 101, i8 112, i8 111, i8 114, i8 116, i8 101, i8 100, i8 0]
+@__basecc_fslot_gcd_reported = internal global i64 zeroinitializer
+@__basecc_fname_gcd_swapped = internal unnamed_addr constant [12 x i8] [i8 103, i8 99, i8 100, i8 95, i8 115, i8 119, i8 97, i8 112, i8 112, i8 101, i8 100, i8 0]
+@__basecc_fslot_gcd_swapped = internal global i64 zeroinitializer
+@__basecc_fname_fill = internal unnamed_addr constant [5 x i8] [i8 102, i8 105, i8 108, i8 108, i8 0]
+@__basecc_fslot_fill = internal global i64 zeroinitializer
+@__basecc_fname_walk = internal unnamed_addr constant [5 x i8] [i8 119, i8 97, i8 108, i8 107, i8 0]
+@__basecc_fslot_walk = internal global i64 zeroinitializer
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,10 @@
+int first_even(int limit) {
+  int i = 0;
+  for (i = 0; i < limit; i = i + 1) {
+    if (i % 2 == 0) {
+      return i;
+    }
+    break;
+  }
+  return -1;
+}
@@ -0,0 +1,31 @@
+const int limit = 10;
+const int table[4];
+const short primes[] = {2, 3, 5, 7};
+static int counter = 0;
+int shared = 5;
+int *shared_ptr = &shared;
+static const int scale = 3;
+
+static int unused_leaf(int x) {
+  return x + 1;
+}
+
+static int unused_root(int x) {
+  return unused_leaf(x) * 2;
+}
+
+static int clamp(int x) {
+  if (x > limit) {
+    return limit;
+  }
+  return x;
+}
+
+int step(int x) {
+  static const int bias = 7;
+  static int calls = 0;
+
+  calls = calls + 1;
+  counter = counter + calls;
+  return clamp(x * scale + bias + table[0] + primes[x]);
+}
@@ -0,0 +1,56 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+@limit = local_unnamed_addr constant i32 10
+@table = constant [4 x i32] zeroinitializer
+@primes = constant [4 x i16] [i16 2, i16 3, i16 5, i16 7]
+@counter = internal unnamed_addr global i32 0
+@shared = global i32 5
+@shared_ptr = local_unnamed_addr global i32* @shared
+@scale = internal unnamed_addr constant i32 3
+define internal fastcc noundef i32 @clamp(i32 noundef %x) unnamed_addr {
+entry:
+  %t0 = load i32, i32* @limit, !tbaa !3
+  %t1 = icmp sgt i32 %x, %t0
+  br i1 %t1, label %if.then0, label %if.end1
+if.then0:
+  %t2 = load i32, i32* @limit, !tbaa !3
+  ret i32 %t2
+if.end1:
+  ret i32 %x
+}
+@.static.step.0.bias = internal unnamed_addr constant i32 7
+@.static.step.1.calls = internal unnamed_addr global i32 0
+
+define noundef i32 @step(i32 noundef %x) local_unnamed_addr {
+entry:
+  %t0 = load i32, i32* @.static.step.1.calls, !tbaa !3
+  %t1 = add nsw i32 %t0, 1
+  store i32 %t1, i32* @.static.step.1.calls, !tbaa !3
+  %t2 = load i32, i32* @counter, !tbaa !3
+  %t3 = load i32, i32* @.static.step.1.calls, !tbaa !3
+  %t4 = add nsw i32 %t2, %t3
+  store i32 %t4, i32* @counter, !tbaa !3
+  %t5 = load i32, i32* @scale, !tbaa !3
+  %t6 = mul nsw i32 %x, %t5
+  %t7 = load i32, i32* @.static.step.0.bias, !tbaa !3
+  %t8 = add nsw i32 %t6, %t7
+  %t9 = getelementptr inbounds [4 x i32], [4 x i32]* @table, i32 0, i32 0
+  %t10 = getelementptr inbounds i32, i32* %t9, i32 0
+  %t11 = load i32, i32* %t10, !tbaa !3
+  %t12 = add nsw i32 %t8, %t11
+  %t13 = getelementptr inbounds [4 x i16], [4 x i16]* @primes, i32 0, i32 0
+  %t14 = getelementptr inbounds i16, i16* %t13, i32 %x
+  %t15 = load i16, i16* %t14, !tbaa !5
+  %t16 = sext i16 %t15 to i32
+  %t17 = add nsw i32 %t12, %t16
+  %t18 = call fastcc i32 @clamp(i32 %t17)
+  ret i32 %t18
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"short", !1, i64 0}
+!5 = !{!4, !4, i64 0}
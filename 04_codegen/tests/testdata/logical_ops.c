@@ -17,3 +17,15 @@ int short_circuit_and_div0() {
 int short_circuit_or_div0() {
   return 1 || (1 / 0);
 }
+
+int branch_logic(int a, int b, int *p) {
+  int i = a;
+
+  if (a > 0 && !(b == 0) || !p) {
+    return 1;
+  }
+  while (!(i >= b) && p) {
+    i = i + 1;
+  }
+  return i;
+}
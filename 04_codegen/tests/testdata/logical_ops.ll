@@ -1,67 +1,96 @@
 ; ModuleID = 'basecc'
 source_filename = "basecc"
 
-define i32 @not_zero() {
+define noundef i32 @not_zero() {
 entry:
   %t0 = icmp eq i32 0, 0
   %t1 = zext i1 %t0 to i32
   ret i32 %t1
 }
-define i32 @logical_and() {
+define noundef i32 @logical_and() {
 entry:
-  br label %logic.left0
-logic.left0:
   %t0 = icmp ne i32 1, 0
-  br i1 %t0, label %logic.rhs1, label %logic.end2
-logic.rhs1:
+  br i1 %t0, label %logic.rhs0, label %logic.end1
+logic.rhs0:
   %t1 = icmp ne i32 0, 0
-  br label %logic.end2
-logic.end2:
-  %t2 = phi i1 [0, %logic.left0], [%t1, %logic.rhs1]
+  br label %logic.end1
+logic.end1:
+  %t2 = phi i1 [0, %entry], [%t1, %logic.rhs0]
   %t3 = zext i1 %t2 to i32
   ret i32 %t3
 }
-define i32 @logical_or() {
+define noundef i32 @logical_or() {
 entry:
-  br label %logic.left0
-logic.left0:
   %t0 = icmp ne i32 0, 0
-  br i1 %t0, label %logic.end2, label %logic.rhs1
-logic.rhs1:
+  br i1 %t0, label %logic.end1, label %logic.rhs0
+logic.rhs0:
   %t1 = icmp ne i32 1, 0
-  br label %logic.end2
-logic.end2:
-  %t2 = phi i1 [1, %logic.left0], [%t1, %logic.rhs1]
+  br label %logic.end1
+logic.end1:
+  %t2 = phi i1 [1, %entry], [%t1, %logic.rhs0]
   %t3 = zext i1 %t2 to i32
   ret i32 %t3
 }
-define i32 @short_circuit_and_div0() {
+define noundef i32 @short_circuit_and_div0() {
 entry:
-  br label %logic.left0
-logic.left0:
   %t0 = icmp ne i32 0, 0
-  br i1 %t0, label %logic.rhs1, label %logic.end2
-logic.rhs1:
+  br i1 %t0, label %logic.rhs0, label %logic.end1
+logic.rhs0:
   %t1 = sdiv i32 1, 0
   %t2 = icmp ne i32 %t1, 0
-  br label %logic.end2
-logic.end2:
-  %t3 = phi i1 [0, %logic.left0], [%t2, %logic.rhs1]
+  br label %logic.end1
+logic.end1:
+  %t3 = phi i1 [0, %entry], [%t2, %logic.rhs0]
   %t4 = zext i1 %t3 to i32
   ret i32 %t4
 }
-define i32 @short_circuit_or_div0() {
+define noundef i32 @short_circuit_or_div0() {
 entry:
-  br label %logic.left0
-logic.left0:
   %t0 = icmp ne i32 1, 0
-  br i1 %t0, label %logic.end2, label %logic.rhs1
-logic.rhs1:
+  br i1 %t0, label %logic.end1, label %logic.rhs0
+logic.rhs0:
   %t1 = sdiv i32 1, 0
   %t2 = icmp ne i32 %t1, 0
-  br label %logic.end2
-logic.end2:
-  %t3 = phi i1 [1, %logic.left0], [%t2, %logic.rhs1]
+  br label %logic.end1
+logic.end1:
+  %t3 = phi i1 [1, %entry], [%t2, %logic.rhs0]
   %t4 = zext i1 %t3 to i32
   ret i32 %t4
 }
+define noundef i32 @branch_logic(i32 noundef %a, i32 noundef %b, i32* noundef %p) {
+entry:
+  %t0 = alloca i32
+  store i32 %a, i32* %t0, !tbaa !3
+  %t1 = icmp sgt i32 %a, 0
+  br i1 %t1, label %logic.rhs3, label %logic.rhs2
+logic.rhs3:
+  %t2 = icmp eq i32 %b, 0
+  br i1 %t2, label %logic.rhs2, label %if.then0
+logic.rhs2:
+  %t3 = icmp ne i32* %p, null
+  br i1 %t3, label %if.end1, label %if.then0
+if.then0:
+  ret i32 1
+if.end1:
+  br label %while.cond4
+while.cond4:
+  %t4 = load i32, i32* %t0, !tbaa !3
+  %t5 = icmp sge i32 %t4, %b
+  br i1 %t5, label %while.end6, label %logic.rhs7
+logic.rhs7:
+  %t6 = icmp ne i32* %p, null
+  br i1 %t6, label %while.body5, label %while.end6
+while.body5:
+  %t7 = load i32, i32* %t0, !tbaa !3
+  %t8 = add nsw i32 %t7, 1
+  store i32 %t8, i32* %t0, !tbaa !3
+  br label %while.cond4
+while.end6:
+  %t9 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t9
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
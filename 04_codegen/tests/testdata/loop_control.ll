@@ -1,7 +1,7 @@
 ; ModuleID = 'basecc'
 source_filename = "basecc"
 
-define i32 @main() {
+define noundef i32 @main() {
 entry:
   br label %while.cond0
 while.cond0:
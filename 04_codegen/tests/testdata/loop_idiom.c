@@ -0,0 +1,37 @@
+int table[64];
+int backup[64];
+
+int clear_table() {
+  for (int i = 0; i < 64; i = i + 1) {
+    table[i] = 0;
+  }
+  return table[0];
+}
+
+int fill_bytes(char *bytes, int first, int last, char value) {
+  for (int i = first; i <= last; i = i + 1) {
+    bytes[i] = value;
+  }
+  return last - first;
+}
+
+int save_table() {
+  for (int i = 0; i < 64; i = i + 1) {
+    backup[i] = table[i];
+  }
+  return backup[63];
+}
+
+int copy_values(int *to, int *from, int n) {
+  for (int i = 0; n - i; i = i + 1) {
+    to[i] = from[i];
+  }
+  return n;
+}
+
+int fill_ones(int *values, int n) {
+  for (int i = 0; i < n; i = i + 1) {
+    values[i] = 1;
+  }
+  return n;
+}
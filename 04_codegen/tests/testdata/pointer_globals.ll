@@ -3,9 +3,16 @@ source_filename = "basecc"
 
 @value = global i32 7
 @ptr = global i32* @value
-define i32 @main() {
+define noundef i32 @main() {
 entry:
-  %t0 = load i32*, i32** @ptr
-  %t1 = load i32, i32* %t0
+  %t0 = load i32*, i32** @ptr, !tbaa !3
+  %t1 = load i32, i32* %t0, !tbaa !5
   ret i32 %t1
 }
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"any pointer", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"int", !1, i64 0}
+!5 = !{!4, !4, i64 0}
@@ -0,0 +1,9 @@
+int scale(int *values, int count, int factor) {
+  int total = 0;
+
+  for (int i = 0; i < count; i = i + 1) {
+    total = total + values[i] * factor - -i;
+  }
+
+  return total + *(values + 1) * 4;
+}
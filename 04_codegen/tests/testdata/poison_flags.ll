@@ -0,0 +1,44 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @scale(i32* noundef %values, i32 noundef %count, i32 noundef %factor) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !3
+  %t3 = icmp slt i32 %t2, %count
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t0, !tbaa !3
+  %t5 = load i32, i32* %t1, !tbaa !3
+  %t6 = getelementptr inbounds i32, i32* %values, i32 %t5
+  %t7 = load i32, i32* %t6, !tbaa !3
+  %t8 = mul nsw i32 %t7, %factor
+  %t9 = add nsw i32 %t4, %t8
+  %t10 = load i32, i32* %t1, !tbaa !3
+  %t11 = sub nsw i32 0, %t10
+  %t12 = sub nsw i32 %t9, %t11
+  store i32 %t12, i32* %t0, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t13 = load i32, i32* %t1, !tbaa !3
+  %t14 = add nsw i32 %t13, 1
+  store i32 %t14, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t15 = load i32, i32* %t0, !tbaa !3
+  %t16 = getelementptr inbounds i32, i32* %values, i32 1
+  %t17 = load i32, i32* %t16, !tbaa !3
+  %t18 = shl nsw i32 %t17, 2
+  %t19 = add nsw i32 %t15, %t18
+  ret i32 %t19
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,39 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define i32 @scale(i32* %values, i32 %count, i32 %factor) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0
+  %t1 = alloca i32
+  store i32 0, i32* %t1
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1
+  %t3 = icmp slt i32 %t2, %count
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t0
+  %t5 = load i32, i32* %t1
+  %t6 = getelementptr i32, i32* %values, i32 %t5
+  %t7 = load i32, i32* %t6
+  %t8 = mul i32 %t7, %factor
+  %t9 = add i32 %t4, %t8
+  %t10 = load i32, i32* %t1
+  %t11 = sub i32 0, %t10
+  %t12 = sub i32 %t9, %t11
+  store i32 %t12, i32* %t0
+  br label %for.inc2
+for.inc2:
+  %t13 = load i32, i32* %t1
+  %t14 = add i32 %t13, 1
+  store i32 %t14, i32* %t1
+  br label %for.cond0
+for.end3:
+  %t15 = load i32, i32* %t0
+  %t16 = getelementptr i32, i32* %values, i32 1
+  %t17 = load i32, i32* %t16
+  %t18 = shl i32 %t17, 2
+  %t19 = add i32 %t15, %t18
+  ret i32 %t19
+}
@@ -0,0 +1,10 @@
+int count_big(int *values, int n, int limit) {
+  int count = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    if (*(values + i) > limit) {
+      count = count + 1;
+    }
+  }
+  return count;
+}
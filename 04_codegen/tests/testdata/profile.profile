@@ -0,0 +1 @@
+874772e100846f05 3457220dd92b4b78 9 2 152 150 10 150 150 2 150 10
@@ -0,0 +1,44 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+define noundef i32 @count_big(i32* noundef %values, i32 noundef %n, i32 noundef %limit) !prof !0 {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !4
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !4
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !4
+  %t3 = icmp slt i32 %t2, %n
+  br i1 %t3, label %for.body1, label %for.end3, !prof !5
+for.body1:
+  %t4 = load i32, i32* %t1, !tbaa !4
+  %t5 = getelementptr inbounds i32, i32* %values, i32 %t4
+  %t6 = load i32, i32* %t5, !tbaa !4
+  %t7 = icmp sgt i32 %t6, %limit
+  br i1 %t7, label %if.then4, label %if.end5, !prof !6
+if.then4:
+  %t8 = load i32, i32* %t0, !tbaa !4
+  %t9 = add nsw i32 %t8, 1
+  store i32 %t9, i32* %t0, !tbaa !4
+  br label %if.end5
+if.end5:
+  br label %for.inc2
+for.inc2:
+  %t10 = load i32, i32* %t1, !tbaa !4
+  %t11 = add nsw i32 %t10, 1
+  store i32 %t11, i32* %t1, !tbaa !4
+  br label %for.cond0
+for.end3:
+  %t12 = load i32, i32* %t0, !tbaa !4
+  ret i32 %t12
+}
+
+!0 = !{!"function_entry_count", i64 2}
+!1 = !{!"Simple C/C++ TBAA"}
+!2 = !{!"omnipotent char", !1, i64 0}
+!3 = !{!"int", !2, i64 0}
+!4 = !{!3, !3, i64 0}
+!5 = !{!"branch_weights", i32 151, i32 3}
+!6 = !{!"branch_weights", i32 11, i32 141}
@@ -0,0 +1,23 @@
+extern int is_even(int n);
+extern int is_odd(int n);
+extern int outside(int n);
+
+int is_even(int n) {
+  if (n == 0) {
+    return 1;
+  }
+  return is_odd(n - 1);
+}
+
+int is_odd(int n) {
+  if (n == 0) {
+    return 0;
+  }
+  return is_even(n - 1);
+}
+
+extern int is_even(int n);
+
+int parity(int n) {
+  return is_even(n) + outside(n);
+}
@@ -0,0 +1,33 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+declare noundef i32 @outside(i32 noundef)
+define noundef i32 @is_even(i32 noundef %n) {
+entry:
+  %t0 = icmp eq i32 %n, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 1
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = call i32 @is_odd(i32 %t1)
+  ret i32 %t2
+}
+define noundef i32 @is_odd(i32 noundef %n) {
+entry:
+  %t0 = icmp eq i32 %n, 0
+  br i1 %t0, label %if.then0, label %if.end1
+if.then0:
+  ret i32 0
+if.end1:
+  %t1 = sub nsw i32 %n, 1
+  %t2 = call i32 @is_even(i32 %t1)
+  ret i32 %t2
+}
+define noundef i32 @parity(i32 noundef %n) {
+entry:
+  %t0 = call i32 @is_even(i32 %n)
+  %t1 = call i32 @outside(i32 %n)
+  %t2 = add nsw i32 %t0, %t1
+  ret i32 %t2
+}
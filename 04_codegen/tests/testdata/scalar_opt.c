@@ -0,0 +1,66 @@
+struct point {
+  int x;
+  int y;
+};
+
+int limit;
+int counts[8];
+
+int folded_branch(int value) {
+  int size = 4;
+  int mask = size * 2 - 1;
+
+  if (mask == 7) {
+    return value % (mask + 1);
+  }
+  return value + limit;
+}
+
+int constant_loop(int n) {
+  int step = 1;
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    if (step != 1) {
+      step = step + 1;
+    }
+    total = total + step;
+  }
+  return total;
+}
+
+int common_address(int *values, int i) {
+  values[i + 1] = values[i + 1] + values[i];
+  return values[i + 1] * 2;
+}
+
+int reload_fields(struct point *p) {
+  p->x = 3;
+  p->y = 4;
+  return p->x * p->x + p->y;
+}
+
+int reload_global(int n) {
+  int first = limit + n;
+
+  counts[1] = first;
+  if (n > 0) {
+    return limit + counts[1];
+  }
+  return limit;
+}
+
+int overwritten(int *slot, int value) {
+  *slot = 0;
+  *slot = value;
+  counts[0] = counts[0];
+  return value;
+}
+
+int scratch_only(int value) {
+  int scratch[4];
+
+  scratch[0] = value;
+  scratch[1] = value + 1;
+  return value * 3;
+}
@@ -6,9 +6,9 @@ source_filename = "basecc"
 @static_flag = internal global i8 1
 @static_numbers = internal global [2 x i16] zeroinitializer
 @static_ptr = internal global i32* @global_value
-define internal i32 @add(i32 %left, i32 %right) {
+define internal noundef i32 @add(i32 noundef %left, i32 noundef %right) {
 entry:
-  %t0 = add i32 %left, %right
+  %t0 = add nsw i32 %left, %right
   ret i32 %t0
 }
 @.static.main.0.local_total = internal global i32 3
@@ -17,16 +17,23 @@ entry:
 @.static.main.3.local_ptr = internal global i32* @global_value
 @.static.main.4.local_array = internal global [2 x i32] zeroinitializer
 
-define i32 @main() {
+define noundef i32 @main() {
 entry:
-  %t5 = alloca i32
-  %t6 = load i32, i32* @.static.main.0.local_total
-  %t7 = load i16, i16* @.static.main.2.local_const
-  %t8 = sext i16 %t7 to i32
-  %t9 = call i32 @add(i32 %t6, i32 %t8)
-  store i32 %t9, i32* %t5
-  %t10 = load i32, i32* %t5
-  store i32 %t10, i32* @.static.main.0.local_total
-  %t11 = load i32, i32* @.static.main.0.local_total
-  ret i32 %t11
+  %t0 = alloca i32
+  %t1 = load i32, i32* @.static.main.0.local_total, !tbaa !3
+  %t2 = load i16, i16* @.static.main.2.local_const, !tbaa !5
+  %t3 = sext i16 %t2 to i32
+  %t4 = call i32 @add(i32 %t1, i32 %t3)
+  store i32 %t4, i32* %t0, !tbaa !3
+  %t5 = load i32, i32* %t0, !tbaa !3
+  store i32 %t5, i32* @.static.main.0.local_total, !tbaa !3
+  %t6 = load i32, i32* @.static.main.0.local_total, !tbaa !3
+  ret i32 %t6
 }
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"short", !1, i64 0}
+!5 = !{!4, !4, i64 0}
@@ -0,0 +1,36 @@
+enum Kind { KIND_A = 1, KIND_B, KIND_C };
+
+int classify(int n) {
+  int result = 0;
+
+  switch (n) {
+  case -5:
+    result = 1;
+    break;
+  case 0:
+  case KIND_B:
+    result = 2;
+  case 40:
+    result = result + 3;
+    break;
+  case 900:
+    return 9;
+  default:
+    result = -1;
+  }
+  return result;
+}
+
+int pick(int n) {
+  switch (n) {
+  case KIND_A:
+    return 10;
+  case KIND_C:
+    return 30;
+  case (10 - 2) / 2:
+    return 40;
+  case 17 % 5 * 3:
+    return 60;
+  }
+  return 0;
+}
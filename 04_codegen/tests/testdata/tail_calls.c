@@ -0,0 +1,37 @@
+extern int report(int value);
+
+int gcd(int a, int b) {
+  if (!b) {
+    return a;
+  }
+  return gcd(b, a % b);
+}
+
+int gcd_reported(int a, int b) {
+  return report(gcd(a, b));
+}
+
+int gcd_swapped(int a, int b) {
+  return gcd(b, a);
+}
+
+int fill(int *slot, int depth) {
+  int cells[1];
+
+  if (!depth) {
+    return *slot;
+  }
+  cells[0] = depth;
+  return fill(cells, depth - 1);
+}
+
+int walk(int n, int acc) {
+  int a = n % 7;
+  int b = acc % 1000003;
+
+  if (!n) {
+    return b;
+  }
+
+  return walk(n - 1, b + a);
+}
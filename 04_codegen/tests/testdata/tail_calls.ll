@@ -0,0 +1,93 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+declare noundef i32 @report(i32 noundef)
+define noundef i32 @gcd(i32 noundef %a, i32 noundef %b) {
+entry:
+  br label %tailrecurse
+tailrecurse:
+  %t3 = phi i32 [%a, %entry], [%t4, %if.end1]
+  %t4 = phi i32 [%b, %entry], [%t1, %if.end1]
+  %t0 = icmp ne i32 %t4, 0
+  br i1 %t0, label %if.end1, label %if.then0
+if.then0:
+  ret i32 %t3
+if.end1:
+  %t1 = srem i32 %t3, %t4
+  br label %tailrecurse
+}
+define noundef i32 @gcd_reported(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = call i32 @gcd(i32 %a, i32 %b)
+  %t1 = tail call i32 @report(i32 %t0)
+  ret i32 %t1
+}
+define noundef i32 @gcd_swapped(i32 noundef %a, i32 noundef %b) {
+entry:
+  %t0 = musttail call i32 @gcd(i32 %b, i32 %a)
+  ret i32 %t0
+}
+define noundef i32 @fill(i32* noundef %slot, i32 noundef %depth) {
+entry:
+  %t0 = alloca [1 x i32]
+  %t1 = icmp ne i32 %depth, 0
+  br i1 %t1, label %if.end1, label %if.then0
+if.then0:
+  %t2 = load i32, i32* %slot, !tbaa !3
+  ret i32 %t2
+if.end1:
+  %t3 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  %t4 = getelementptr inbounds i32, i32* %t3, i32 0
+  store i32 %depth, i32* %t4, !tbaa !3
+  %t5 = getelementptr inbounds [1 x i32], [1 x i32]* %t0, i32 0, i32 0
+  %t6 = sub nsw i32 %depth, 1
+  %t7 = call i32 @fill(i32* %t5, i32 %t6)
+  ret i32 %t7
+}
+define noundef i32 @walk(i32 noundef %n, i32 noundef %acc) {
+entry:
+  %t0 = alloca i32
+  %t11 = alloca i32
+  br label %tailrecurse
+tailrecurse:
+  %t29 = phi i32 [%n, %entry], [%t24, %if.end1]
+  %t30 = phi i32 [%acc, %entry], [%t27, %if.end1]
+  %t1 = sext i32 %t29 to i64
+  %t2 = mul i64 %t1, -1840700269
+  %t3 = ashr i64 %t2, 32
+  %t4 = trunc i64 %t3 to i32
+  %t5 = add i32 %t4, %t29
+  %t6 = ashr i32 %t5, 2
+  %t7 = lshr i32 %t6, 31
+  %t8 = add i32 %t6, %t7
+  %t9 = mul i32 %t8, 7
+  %t10 = sub i32 %t29, %t9
+  store i32 %t10, i32* %t0, !tbaa !3
+  %t12 = sext i32 %t30 to i64
+  %t13 = mul i64 %t12, -2043174237
+  %t14 = ashr i64 %t13, 32
+  %t15 = trunc i64 %t14 to i32
+  %t16 = add i32 %t15, %t30
+  %t17 = ashr i32 %t16, 19
+  %t18 = lshr i32 %t17, 31
+  %t19 = add i32 %t17, %t18
+  %t20 = mul i32 %t19, 1000003
+  %t21 = sub i32 %t30, %t20
+  store i32 %t21, i32* %t11, !tbaa !3
+  %t22 = icmp ne i32 %t29, 0
+  br i1 %t22, label %if.end1, label %if.then0
+if.then0:
+  %t23 = load i32, i32* %t11, !tbaa !3
+  ret i32 %t23
+if.end1:
+  %t24 = sub nsw i32 %t29, 1
+  %t25 = load i32, i32* %t11, !tbaa !3
+  %t26 = load i32, i32* %t0, !tbaa !3
+  %t27 = add nsw i32 %t25, %t26
+  br label %tailrecurse
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
@@ -0,0 +1,35 @@
+struct Point {
+  int x;
+  short tag;
+  char *name;
+};
+
+struct Segment {
+  struct Point from;
+  int length;
+  struct Segment *next;
+};
+
+int scale(struct Point *point, int *factors, short *weights, char *mask,
+          int n) {
+  int total = 0;
+
+  for (int i = 0; i < n; i = i + 1) {
+    *(factors + i) = point->x;
+    *(weights + i) = point->tag;
+    *(mask + i) = 1;
+    total = total + *(factors + i);
+  }
+  return total;
+}
+
+int chain(struct Segment *first) {
+  struct Segment *segment = first;
+  int total = 0;
+
+  while (segment) {
+    total = total + segment->length;
+    segment = segment->next;
+  }
+  return total;
+}
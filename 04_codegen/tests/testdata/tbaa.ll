@@ -0,0 +1,91 @@
+; ModuleID = 'basecc'
+source_filename = "basecc"
+
+%struct.Point = type { i32, i16, i8* }
+%struct.Segment = type { %struct.Point, i32, %struct.Segment* }
+
+define noundef i32 @scale(%struct.Point* noundef %point, i32* noundef %factors, i16* noundef %weights, i8* noundef %mask, i32 noundef %n) {
+entry:
+  %t0 = alloca i32
+  store i32 0, i32* %t0, !tbaa !3
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.cond0:
+  %t2 = load i32, i32* %t1, !tbaa !3
+  %t3 = icmp slt i32 %t2, %n
+  br i1 %t3, label %for.body1, label %for.end3
+for.body1:
+  %t4 = load i32, i32* %t1, !tbaa !3
+  %t5 = getelementptr inbounds i32, i32* %factors, i32 %t4
+  %t6 = getelementptr inbounds %struct.Point, %struct.Point* %point, i32 0, i32 0
+  %t7 = load i32, i32* %t6, !tbaa !7
+  store i32 %t7, i32* %t5, !tbaa !3
+  %t8 = load i32, i32* %t1, !tbaa !3
+  %t9 = getelementptr inbounds i16, i16* %weights, i32 %t8
+  %t10 = getelementptr inbounds %struct.Point, %struct.Point* %point, i32 0, i32 1
+  %t11 = load i16, i16* %t10, !tbaa !8
+  store i16 %t11, i16* %t9, !tbaa !9
+  %t12 = load i32, i32* %t1, !tbaa !3
+  %t13 = getelementptr inbounds i8, i8* %mask, i32 %t12
+  %t14 = trunc i32 1 to i8
+  store i8 %t14, i8* %t13, !tbaa !10
+  %t15 = load i32, i32* %t0, !tbaa !3
+  %t16 = load i32, i32* %t1, !tbaa !3
+  %t17 = getelementptr inbounds i32, i32* %factors, i32 %t16
+  %t18 = load i32, i32* %t17, !tbaa !3
+  %t19 = add nsw i32 %t15, %t18
+  store i32 %t19, i32* %t0, !tbaa !3
+  br label %for.inc2
+for.inc2:
+  %t20 = load i32, i32* %t1, !tbaa !3
+  %t21 = add nsw i32 %t20, 1
+  store i32 %t21, i32* %t1, !tbaa !3
+  br label %for.cond0
+for.end3:
+  %t22 = load i32, i32* %t0, !tbaa !3
+  ret i32 %t22
+}
+define noundef i32 @chain(%struct.Segment* noundef %first) {
+entry:
+  %t0 = alloca %struct.Segment*
+  store %struct.Segment* %first, %struct.Segment** %t0, !tbaa !11
+  %t1 = alloca i32
+  store i32 0, i32* %t1, !tbaa !3
+  br label %while.cond0
+while.cond0:
+  %t2 = load %struct.Segment*, %struct.Segment** %t0, !tbaa !11
+  %t3 = icmp ne %struct.Segment* %t2, null
+  br i1 %t3, label %while.body1, label %while.end2
+while.body1:
+  %t4 = load i32, i32* %t1, !tbaa !3
+  %t5 = load %struct.Segment*, %struct.Segment** %t0, !tbaa !11
+  %t6 = getelementptr inbounds %struct.Segment, %struct.Segment* %t5, i32 0, i32 1
+  %t7 = load i32, i32* %t6, !tbaa !13
+  %t8 = add nsw i32 %t4, %t7
+  store i32 %t8, i32* %t1, !tbaa !3
+  %t9 = load %struct.Segment*, %struct.Segment** %t0, !tbaa !11
+  %t10 = getelementptr inbounds %struct.Segment, %struct.Segment* %t9, i32 0, i32 2
+  %t11 = load %struct.Segment*, %struct.Segment** %t10, !tbaa !14
+  store %struct.Segment* %t11, %struct.Segment** %t0, !tbaa !11
+  br label %while.cond0
+while.end2:
+  %t12 = load i32, i32* %t1, !tbaa !3
+  ret i32 %t12
+}
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"int", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"short", !1, i64 0}
+!5 = !{!"any pointer", !1, i64 0}
+!6 = !{!"Point", !2, i64 0, !4, i64 4, !5, i64 8}
+!7 = !{!6, !2, i64 0}
+!8 = !{!6, !4, i64 4}
+!9 = !{!4, !4, i64 0}
+!10 = !{!1, !1, i64 0}
+!11 = !{!5, !5, i64 0}
+!12 = !{!"Segment", !6, i64 0, !2, i64 16, !5, i64 24}
+!13 = !{!12, !2, i64 16}
+!14 = !{!12, !5, i64 24}
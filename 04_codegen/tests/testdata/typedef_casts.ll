@@ -2,16 +2,23 @@
 source_filename = "basecc"
 
 @value = global i32 5
-define i32 @main() {
+define noundef i32 @main() {
 entry:
   %t0 = alloca i8*
   %t1 = bitcast i32* @value to i8*
-  store i8* %t1, i8** %t0
+  store i8* %t1, i8** %t0, !tbaa !3
   %t2 = alloca i32*
-  %t3 = load i8*, i8** %t0
+  %t3 = load i8*, i8** %t0, !tbaa !3
   %t4 = bitcast i8* %t3 to i32*
-  store i32* %t4, i32** %t2
-  %t5 = load i32*, i32** %t2
-  %t6 = load i32, i32* %t5
+  store i32* %t4, i32** %t2, !tbaa !3
+  %t5 = load i32*, i32** %t2, !tbaa !3
+  %t6 = load i32, i32* %t5, !tbaa !5
   ret i32 %t6
 }
+
+!0 = !{!"Simple C/C++ TBAA"}
+!1 = !{!"omnipotent char", !0, i64 0}
+!2 = !{!"any pointer", !1, i64 0}
+!3 = !{!2, !2, i64 0}
+!4 = !{!"int", !1, i64 0}
+!5 = !{!4, !4, i64 0}
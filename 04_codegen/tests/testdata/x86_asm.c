@@ -0,0 +1,28 @@
+extern int putchar(int c);
+
+struct Pair {
+  char tag;
+  int value;
+};
+
+int total = 3;
+
+int in_range(struct Pair *pair, int low, int high) {
+  static int calls = 0;
+  calls = calls + 1;
+  if (pair->value >= low && pair->value < high) {
+    total = total + putchar(pair->tag);
+    return total / calls;
+  }
+  return 0;
+}
+
+int sum_scaled(int *values, int count, int scale) {
+  int sum = 0;
+  int i = 0;
+  while (i < count) {
+    sum = sum + values[i] * scale;
+    i = i + 1;
+  }
+  return sum;
+}
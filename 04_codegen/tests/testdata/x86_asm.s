@@ -0,0 +1,106 @@
+	.file	"basecc"
+
+	.data
+	.globl	total
+	.balign	4
+	.type	total, @object
+	.size	total, 4
+total:
+	.long	3
+
+	.bss
+	.balign	4
+	.type	.static.in_range.0.calls, @object
+	.size	.static.in_range.0.calls, 4
+.static.in_range.0.calls:
+	.zero	4
+
+	.text
+	.globl	in_range
+	.p2align	4
+	.type	in_range, @function
+in_range:
+	# regalloc: 20 intervals, 0 spilled, 3 copies coalesced
+	pushq	%rbp
+	movq	%rsp, %rbp
+	subq	$16, %rsp
+	movq	%rbx, -8(%rbp)
+	movq	%rdx, %r8
+.Lin_range.entry:
+	movl	.static.in_range.0.calls(%rip), %r9d
+	addl	$1, %r9d
+	movl	%r9d, .static.in_range.0.calls(%rip)
+	leaq	4(%rdi), %r9
+	movl	(%r9), %r9d
+	cmpl	%esi, %r9d
+	jl	.Lin_range.if.end1
+.Lin_range.logic.rhs2:
+	leaq	4(%rdi), %rsi
+	movl	(%rsi), %esi
+	cmpl	%r8d, %esi
+	jge	.Lin_range.if.end1
+.Lin_range.if.then0:
+	movl	total(%rip), %ebx
+	movq	%rdi, %rsi
+	movzbl	(%rsi), %esi
+	movsbq	%sil, %rdi
+	xorl	%eax, %eax
+	call	putchar@PLT
+	movq	%rax, %rsi
+	addl	%ebx, %esi
+	movl	%esi, total(%rip)
+	movl	total(%rip), %esi
+	movl	.static.in_range.0.calls(%rip), %edi
+	movq	%rsi, %rax
+	cltd
+	idivl	%edi
+	movq	%rax, %rsi
+	movq	%rsi, %rax
+	movq	-8(%rbp), %rbx
+	leave
+	ret
+.Lin_range.if.end1:
+	xorl	%eax, %eax
+	movq	-8(%rbp), %rbx
+	leave
+	ret
+	.size	in_range, .-in_range
+
+	.text
+	.globl	sum_scaled
+	.p2align	4
+	.type	sum_scaled, @function
+sum_scaled:
+	# regalloc: 14 intervals, 0 spilled, 2 copies coalesced
+	pushq	%rbp
+	movq	%rsp, %rbp
+	subq	$16, %rsp
+	movq	%rdx, %r8
+.Lsum_scaled.entry:
+	movl	$0, -4(%rbp)
+	movl	$0, -8(%rbp)
+.Lsum_scaled.while.cond0:
+	movl	-8(%rbp), %r9d
+	cmpl	%esi, %r9d
+	jge	.Lsum_scaled.while.end2
+.Lsum_scaled.while.body1:
+	movl	-4(%rbp), %r9d
+	movl	-8(%rbp), %r10d
+	movslq	%r10d, %rcx
+	leaq	(%rdi,%rcx,4), %r10
+	movl	(%r10), %r10d
+	imull	%r8d, %r10d
+	addl	%r10d, %r9d
+	movl	%r9d, -4(%rbp)
+	movl	-8(%rbp), %r9d
+	addl	$1, %r9d
+	movl	%r9d, -8(%rbp)
+	jmp	.Lsum_scaled.while.cond0
+.Lsum_scaled.while.end2:
+	movl	-4(%rbp), %esi
+	movq	%rsi, %rax
+	leave
+	ret
+	.size	sum_scaled, .-sum_scaled
+
+	.section	.note.GNU-stack,"",@progbits
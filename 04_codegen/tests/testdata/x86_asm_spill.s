@@ -0,0 +1,148 @@
+	.file	"basecc"
+
+	.data
+	.globl	total
+	.balign	4
+	.type	total, @object
+	.size	total, 4
+total:
+	.long	3
+
+	.bss
+	.balign	4
+	.type	.static.in_range.0.calls, @object
+	.size	.static.in_range.0.calls, 4
+.static.in_range.0.calls:
+	.zero	4
+
+	.text
+	.globl	in_range
+	.p2align	4
+	.type	in_range, @function
+in_range:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	subq	$160, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+	movq	%rdx, -24(%rbp)
+.Lin_range.entry:
+	movl	.static.in_range.0.calls(%rip), %eax
+	movq	%rax, -32(%rbp)
+	movq	-32(%rbp), %rax
+	addl	$1, %eax
+	movq	%rax, -40(%rbp)
+	movq	-40(%rbp), %rcx
+	movl	%ecx, .static.in_range.0.calls(%rip)
+	movq	-8(%rbp), %rax
+	leaq	4(%rax), %rax
+	movq	%rax, -48(%rbp)
+	movq	-48(%rbp), %rax
+	movl	(%rax), %eax
+	movq	%rax, -56(%rbp)
+	movq	-56(%rbp), %rax
+	cmpl	-16(%rbp), %eax
+	jl	.Lin_range.if.end1
+.Lin_range.logic.rhs2:
+	movq	-8(%rbp), %rax
+	leaq	4(%rax), %rax
+	movq	%rax, -72(%rbp)
+	movq	-72(%rbp), %rax
+	movl	(%rax), %eax
+	movq	%rax, -80(%rbp)
+	movq	-80(%rbp), %rax
+	cmpl	-24(%rbp), %eax
+	jge	.Lin_range.if.end1
+.Lin_range.if.then0:
+	movl	total(%rip), %eax
+	movq	%rax, -96(%rbp)
+	movq	-8(%rbp), %rax
+	movq	%rax, -104(%rbp)
+	movq	-104(%rbp), %rax
+	movzbl	(%rax), %eax
+	movq	%rax, -112(%rbp)
+	movsbq	-112(%rbp), %rax
+	movq	%rax, -120(%rbp)
+	movq	-120(%rbp), %rdi
+	xorl	%eax, %eax
+	call	putchar@PLT
+	movq	%rax, -128(%rbp)
+	movq	-96(%rbp), %rax
+	addl	-128(%rbp), %eax
+	movq	%rax, -136(%rbp)
+	movq	-136(%rbp), %rcx
+	movl	%ecx, total(%rip)
+	movl	total(%rip), %eax
+	movq	%rax, -144(%rbp)
+	movl	.static.in_range.0.calls(%rip), %eax
+	movq	%rax, -152(%rbp)
+	movq	-144(%rbp), %rax
+	cltd
+	idivl	-152(%rbp)
+	movq	%rax, -160(%rbp)
+	movq	-160(%rbp), %rax
+	leave
+	ret
+.Lin_range.if.end1:
+	xorl	%eax, %eax
+	leave
+	ret
+	.size	in_range, .-in_range
+
+	.text
+	.globl	sum_scaled
+	.p2align	4
+	.type	sum_scaled, @function
+sum_scaled:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	subq	$128, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+	movq	%rdx, -24(%rbp)
+.Lsum_scaled.entry:
+	movl	$0, -116(%rbp)
+	movl	$0, -120(%rbp)
+.Lsum_scaled.while.cond0:
+	movl	-120(%rbp), %eax
+	movq	%rax, -32(%rbp)
+	movq	-32(%rbp), %rax
+	cmpl	-16(%rbp), %eax
+	jge	.Lsum_scaled.while.end2
+.Lsum_scaled.while.body1:
+	movl	-116(%rbp), %eax
+	movq	%rax, -48(%rbp)
+	movl	-120(%rbp), %eax
+	movq	%rax, -56(%rbp)
+	movslq	-56(%rbp), %rcx
+	movq	-8(%rbp), %rax
+	leaq	(%rax,%rcx,4), %rax
+	movq	%rax, -64(%rbp)
+	movq	-64(%rbp), %rax
+	movl	(%rax), %eax
+	movq	%rax, -72(%rbp)
+	movq	-72(%rbp), %rax
+	imull	-24(%rbp), %eax
+	movq	%rax, -80(%rbp)
+	movq	-48(%rbp), %rax
+	addl	-80(%rbp), %eax
+	movq	%rax, -88(%rbp)
+	movq	-88(%rbp), %rcx
+	movl	%ecx, -116(%rbp)
+	movl	-120(%rbp), %eax
+	movq	%rax, -96(%rbp)
+	movq	-96(%rbp), %rax
+	addl	$1, %eax
+	movq	%rax, -104(%rbp)
+	movq	-104(%rbp), %rcx
+	movl	%ecx, -120(%rbp)
+	jmp	.Lsum_scaled.while.cond0
+.Lsum_scaled.while.end2:
+	movl	-116(%rbp), %eax
+	movq	%rax, -112(%rbp)
+	movq	-112(%rbp), %rax
+	leave
+	ret
+	.size	sum_scaled, .-sum_scaled
+
+	.section	.note.GNU-stack,"",@progbits